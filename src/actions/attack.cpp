@@ -143,6 +143,9 @@ battle_context_unit_stats::battle_context_unit_stats(nonempty_unit_const_ptr up,
 		opp_ctx.emplace(opp_weapon->specials_context(oppp, up, opp_loc, u_loc, !attacking, weapon));
 	}
 
+	// Nothing changes while the stats are computed.
+	ctx.cache_specials_and_abilities();
+
 	slows = weapon->has_special_or_ability("slow") && !opp.get_state("unslowable") ;
 	drains = !opp.get_state("undrainable") && weapon->has_special_or_ability("drains");
 	petrifies = !opp.get_state("unpetrifiable") && weapon->has_special_or_ability("petrifies");
@@ -1604,8 +1607,8 @@ int combat_modifier(const unit_map& units,
 		bool is_fearless)
 {
 	const tod_manager& tod_m = *resources::tod_manager;
-	const time_of_day& effective_tod = tod_m.get_illuminated_time_of_day(units, map, loc);
-	return combat_modifier(effective_tod, alignment, is_fearless);
+	const int lawful_bonus = tod_m.get_illuminated_lawful_bonus(units, map, loc);
+	return generic_combat_modifier(lawful_bonus, alignment, is_fearless, tod_m.get_max_liminal_bonus());
 }
 
 int combat_modifier(const time_of_day& effective_tod,
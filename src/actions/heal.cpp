@@ -291,6 +291,9 @@ void calculate_healing(int side, bool update_display)
 {
 	DBG_NG << "beginning of healing calculations";
 
+	// First find out what happens to every unit, then apply it, so that no
+	// ability filter sees a unit that was already healed this turn. (This
+	// also makes the result the same whether or not healing is animated.)
 	std::list<heal_unit> unit_list;
 
 	// We look for all allied units, then we see if our healer is near them.
@@ -341,18 +344,17 @@ void calculate_healing(int side, bool update_display)
 			DBG_NG << "Just before healing animations, unit has " << healers.size() << " potential healers.";
 		}
 
-		if (!resources::controller->is_skipping_replay() && update_display)
-		{
-			unit_list.emplace_front(patient, healers, healing, curing == POISON_CURE);
-		}
-		else
-		{
-			// Do the healing now since it will not be animated.
-			do_heal(patient, healing, curing == POISON_CURE);
-		}
+		unit_list.emplace_front(patient, healers, healing, curing == POISON_CURE);
 	}
 
-	animate_heals(unit_list);
+	if (!resources::controller->is_skipping_replay() && update_display) {
+		animate_heals(unit_list);
+	} else {
+		// The order does not matter, the healings are independent.
+		for (const heal_unit& heal : unit_list) {
+			do_heal(heal.healed, heal.amount, heal.cure_poison);
+		}
+	}
 
 	DBG_NG << "end of healing calculations";
 }
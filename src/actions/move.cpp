@@ -422,6 +422,11 @@ namespace { // Private helpers for move_unit()
 	 */
 	inline void unit_mover::check_for_ambushers(const map_location & hex)
 	{
+		// Most hexes of a route have no unit next to them at all.
+		if ( !resources::gameboard->may_be_in_zoc(hex) ) {
+			return;
+		}
+
 		const unit_map &units = resources::gameboard->units();
 
 		// Need to check each adjacent hex for hidden enemies.
@@ -740,8 +745,10 @@ namespace { // Private helpers for move_unit()
 
 		if ( start != begin_ ) {
 			// Check for being unable to leave the current hex.
-			if ( !move_it_->get_ability_bool("skirmisher", *start) &&
-			      pathfind::enemy_zoc(*current_team_, *start, *current_team_) )
+			// The ZOC check is the cheaper one, the skirmisher ability can
+			// depend on the location and on adjacent units.
+			if ( pathfind::enemy_zoc(*current_team_, *start, *current_team_) &&
+			     !move_it_->get_ability_bool("skirmisher", *start) )
 				zoc_stop_ = *start;
 		}
 
@@ -763,8 +770,8 @@ namespace { // Private helpers for move_unit()
 			moves_left_.push_back(remaining_moves);
 
 			// Check for being unable to leave this hex.
-			if (!move_it_->get_ability_bool("skirmisher", *end) &&
-				pathfind::enemy_zoc(*current_team_, *end, *current_team_))
+			if (pathfind::enemy_zoc(*current_team_, *end, *current_team_) &&
+				!move_it_->get_ability_bool("skirmisher", *end))
 			{
 				zoc_stop_ = *end;
 			}
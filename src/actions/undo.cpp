@@ -198,6 +198,25 @@ void undo_list::add_recruit(const unit_const_ptr u, const map_location& loc,
 	add(new undo::recruit_action(u, loc, from, orig_village_owner, time_bonus));
 }
 
+/**
+ * Adds an action to the undo stack.
+ * Its undo events share their WML with the previous undoable action's where
+ * possible.
+ */
+void undo_list::add(undo_action_base * action)
+{
+	if(undo_action* undoable = dynamic_cast<undo_action*>(action)) {
+		auto prev = std::find_if(undos_.rbegin(), undos_.rend(),
+			[](const action_ptr_t& a) { return dynamic_cast<const undo_action*>(a.get()) != nullptr; });
+		if(prev != undos_.rend()) {
+			undoable->share_event_data(static_cast<const undo_action&>(**prev));
+		}
+	}
+
+	undos_.emplace_back(action);
+	redos_.clear();
+}
+
 /**
  * Adds a shroud update to the undo stack.
  * This is called from within commit_vision(), so there should be no need
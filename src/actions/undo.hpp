@@ -103,8 +103,7 @@ public:
 
 private: // functions
 	/** Adds an action to the undo stack. */
-	void add(undo_action_base * action)
-	{ undos_.emplace_back(action);  redos_.clear(); }
+	void add(undo_action_base * action);
 	/** Applies the pending fog/shroud changes from the undo stack. */
 	bool apply_shroud_changes() const;
 
@@ -29,9 +29,9 @@
 namespace actions
 {
 
-undo_event::undo_event(const config& cmds, const game_events::queued_event& ctx)
-	: commands(cmds)
-	, data(ctx.data)
+undo_event::undo_event(config cmds, const game_events::queued_event& ctx)
+	: commands(std::make_shared<const config>(std::move(cmds)))
+	, data(std::make_shared<const config>(ctx.data))
 	, loc1(ctx.loc1)
 	, loc2(ctx.loc2)
 	, filter_loc1(ctx.loc1.filter_loc())
@@ -50,8 +50,8 @@ undo_event::undo_event(const config& cmds, const game_events::queued_event& ctx)
 }
 
 undo_event::undo_event(const config& first, const config& second, const config& weapons, const config& cmds)
-	: commands(cmds)
-	, data(weapons)
+	: commands(std::make_shared<const config>(cmds))
+	, data(std::make_shared<const config>(weapons))
 	, loc1(first["x"], first["y"], wml_loc())
 	, loc2(second["x"], second["y"], wml_loc())
 	, filter_loc1(first["filter_x"], first["filter_y"], wml_loc())
@@ -68,8 +68,9 @@ undo_action::undo_action()
 	, unit_id_diff(synced_context::get_unit_id_diff())
 {
 	auto& undo = synced_context::get_undo_commands();
-	auto command_transformer = [](const std::pair<config, game_events::queued_event>& p) {
-		return undo_event(p.first, p.second);
+	// The list is cleared below, so the commands can be moved out of it.
+	auto command_transformer = [](std::pair<config, game_events::queued_event>& p) {
+		return undo_event(std::move(p.first), p.second);
 	};
 	std::transform(undo.begin(), undo.end(), std::back_inserter(umc_commands_undo), command_transformer);
 	undo.clear();
@@ -111,11 +112,11 @@ namespace {
 			u2.reset(new scoped_xy_unit("unit", who->get_location(), resources::gameboard->units()));
 		}
 
-		scoped_weapon_info w1("weapon", e.data.child("first"));
-		scoped_weapon_info w2("second_weapon", e.data.child("second"));
+		scoped_weapon_info w1("weapon", e.data->child("first"));
+		scoped_weapon_info w2("second_weapon", e.data->child("second"));
 
-		game_events::queued_event q(tag, "", map_location(x1, y1, wml_loc()), map_location(x2, y2, wml_loc()), e.data);
-		resources::lua_kernel->run_wml_action("command", vconfig(e.commands), q);
+		game_events::queued_event q(tag, "", map_location(x1, y1, wml_loc()), map_location(x2, y2, wml_loc()), *e.data);
+		resources::lua_kernel->run_wml_action("command", vconfig(*e.commands), q);
 		sound::commit_music_changes();
 
 		x1 = oldx1; y1 = oldy1;
@@ -131,6 +132,19 @@ void undo_action::execute_undo_umc_wml()
 	}
 }
 
+void undo_action::share_event_data(const undo_action& other)
+{
+	for(undo_event& e : umc_commands_undo) {
+		for(const undo_event& o : other.umc_commands_undo) {
+			if(e.commands != o.commands && *e.commands == *o.commands) {
+				e.commands = o.commands;
+			}
+			if(e.data != o.data && *e.data == *o.data) {
+				e.data = o.data;
+			}
+		}
+	}
+}
 
 void undo_action::write(config & cfg) const
 {
@@ -153,8 +167,8 @@ void undo_action::write_event_vector(const event_vector& vec, config& cfg, const
 		config& entry = cfg.add_child(tag);
 		config& first = entry.add_child("filter");
 		config& second = entry.add_child("filter_second");
-		entry.add_child("filter_weapons", evt.data);
-		entry.add_child("command", evt.commands);
+		entry.add_child("filter_weapons", *evt.data);
+		entry.add_child("command", *evt.commands);
 		// First location
 		first["filter_x"] = evt.filter_loc1.wml_x();
 		first["filter_y"] = evt.filter_loc1.wml_y();
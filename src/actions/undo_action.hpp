@@ -22,15 +22,22 @@
 #include "game_events/pump.hpp" // for queued_event
 #include "config.hpp"
 
+#include <memory>
+
 namespace actions {
 	class undo_list;
 
 	struct undo_event {
-		config commands, data;
+		/**
+		 * The commands to run and the event data (weapons).
+		 * These are never modified once recorded, so entries with equal
+		 * contents share a single copy (see undo_action::share_event_data).
+		 */
+		std::shared_ptr<const config> commands, data;
 		map_location loc1, loc2, filter_loc1, filter_loc2;
 		std::size_t uid1, uid2;
 		std::string id1, id2;
-		undo_event(const config& cmds, const game_events::queued_event& ctx);
+		undo_event(config cmds, const game_events::queued_event& ctx);
 		undo_event(const config& first, const config& second, const config& weapons, const config& cmds);
 	};
 
@@ -92,6 +99,12 @@ namespace actions {
 		typedef std::vector<undo_event> event_vector;
 		event_vector umc_commands_undo;
 		void execute_undo_umc_wml();
+		/**
+		 * Makes our undo events reuse the commands and data of @a other where
+		 * they are equal, so that an [on_undo] firing on every move of a turn
+		 * is only stored once.
+		 */
+		void share_event_data(const undo_action& other);
 
 		static void read_event_vector(event_vector& vec, const config& cfg, const std::string& tag);
 		static void write_event_vector(const event_vector& vec, config& cfg, const std::string& tag);
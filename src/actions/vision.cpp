@@ -29,11 +29,13 @@
 #include "map/label.hpp"
 #include "map/location.hpp"
 #include "pathfind/pathfind.hpp"
+#include "pathfind/teleport.hpp"
 #include "play_controller.hpp"
 #include "resources.hpp"
 #include "team.hpp"
 #include "units/unit.hpp"
 
+#include <algorithm>
 #include <boost/dynamic_bitset.hpp>
 
 class unit_animation;
@@ -91,6 +93,112 @@ static bool can_see(const unit & viewer, const map_location & loc,
 }
 
 
+namespace {
+
+/**
+ * The hexes a unit could see the last time it cleared fog.
+ * The vision search only depends on the cost of entering each hex it looks at
+ * (vision cost plus jamming), so the result can be reused as long as these
+ * costs are unchanged, which is much cheaper to check than searching again.
+ */
+struct vision_footprint
+{
+	map_location loc;
+	int sight_range;
+	bool slowed;
+	int map_w, map_h;
+	/** False if teleports could be involved, since they depend on much more. */
+	bool reusable;
+	/** The costs of the on-board hexes looked at by the search. */
+	std::vector<std::pair<map_location, int>> costs;
+	pathfind::paths::dest_vect destinations;
+	std::set<map_location> edges;
+};
+
+/** Footprints by underlying id of the unit doing the sighting. */
+std::map<std::size_t, vision_footprint> vision_footprints;
+
+int vision_cost(const movetype::terrain_costs & costs, bool slowed,
+                const map_location & loc, const std::map<map_location, int> & jamming)
+{
+	int cost = costs.cost(resources::gameboard->map().get_terrain(loc), slowed);
+	const std::map<map_location, int>::const_iterator jam_it = jamming.find(loc);
+	if ( jam_it != jamming.end() )
+		cost += jam_it->second;
+	return cost;
+}
+
+/**
+ * Whether a vision search from @a view_loc might go through teleports.
+ * The search uses the unit at @a view_loc (if any) for that.
+ */
+bool may_teleport(const map_location & view_loc)
+{
+	if ( !resources::tunnels->get().empty() )
+		return true;
+
+	const unit_map::const_iterator u = resources::gameboard->units().find(view_loc);
+	return u.valid()  &&  u->abilities().has_child("teleport");
+}
+
+/**
+ * Returns what pathfind::vision_path would find for these parameters,
+ * reusing the previous result for @a viewer_id if possible.
+ */
+const vision_footprint & get_vision_footprint(std::size_t viewer_id,
+		const movetype::terrain_costs & costs, bool slowed, int sight_range,
+		const map_location & view_loc, const std::map<map_location, int> & jamming)
+{
+	const gamemap & map = resources::gameboard->map();
+	const bool reusable = !may_teleport(view_loc);
+
+	const auto found = vision_footprints.find(viewer_id);
+	if ( found != vision_footprints.end() ) {
+		const vision_footprint & fp = found->second;
+		if ( reusable  &&  fp.reusable  &&  fp.loc == view_loc  &&  fp.sight_range == sight_range
+		     &&  fp.slowed == slowed  &&  fp.map_w == map.w()  &&  fp.map_h == map.h()
+		     &&  std::all_of(fp.costs.begin(), fp.costs.end(), [&](const std::pair<map_location, int> & c) {
+		             return vision_cost(costs, slowed, c.first, jamming) == c.second;
+		         }) )
+		{
+			return fp;
+		}
+	}
+
+	// The footprints of units that are gone are only dropped when there are
+	// too many of them.
+	if ( found == vision_footprints.end()  &&
+	     vision_footprints.size() > 2 * resources::gameboard->units().size() + 64 )
+		vision_footprints.clear();
+
+	vision_footprint & fp = vision_footprints[viewer_id];
+	pathfind::vision_path sight(costs, slowed, sight_range, view_loc, jamming);
+	fp.reusable = reusable;
+	fp.loc = view_loc;
+	fp.sight_range = sight_range;
+	fp.slowed = slowed;
+	fp.map_w = map.w();
+	fp.map_h = map.h();
+	fp.costs.clear();
+	if ( fp.reusable ) {
+		for (const pathfind::paths::step & dest : sight.destinations) {
+			if ( dest.curr != view_loc )
+				fp.costs.emplace_back(dest.curr, vision_cost(costs, slowed, dest.curr, jamming));
+		}
+		for (const map_location & edge : sight.edges) {
+			if ( map.on_board(edge) )
+				fp.costs.emplace_back(edge, vision_cost(costs, slowed, edge, jamming));
+		}
+	}
+	fp.destinations = std::move(sight.destinations);
+	fp.edges = std::move(sight.edges);
+
+	return fp;
+}
+
+} // end anon namespace
+
+
 namespace actions {
 
 
@@ -351,7 +459,8 @@ bool shroud_clearer::clear_unit(const map_location &view_loc, team &view_team,
 	}
 
 	// Determine the hexes to clear.
-	pathfind::vision_path sight(costs, slowed, sight_range, view_loc, jamming_);
+	const vision_footprint & sight =
+		get_vision_footprint(viewer_id, costs, slowed, sight_range, view_loc, jamming_);
 
 	// Clear the fog.
 	for (const pathfind::paths::step &dest : sight.destinations) {
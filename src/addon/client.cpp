@@ -19,6 +19,7 @@
 #include "addon/state.hpp"
 #include "addon/validation.hpp"
 #include "cursor.hpp"
+#include "filesystem.hpp"
 #include "font/pango/escape.hpp"
 #include "formula/string_utils.hpp"
 #include "game_config.hpp"
@@ -36,7 +37,18 @@
 #include "serialization/string_utils.hpp"
 #include "serialization/utf8_exception.hpp"
 #include "utils/parse_network_address.hpp"
-
+#include "utils/scope_exit.hpp"
+
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/stream.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <list>
+#include <optional>
 #include <stdexcept>
 
 #include "addon/client.hpp"
@@ -49,6 +61,33 @@ static lg::log_domain log_addons_client("addons-client");
 
 using gui2::dialogs::network_transmission;
 
+namespace
+{
+/**
+ * The last add-ons list received from each server, keyed by address.
+ *
+ * Servers that send a @a catalog_hash with the list reply with just
+ * @a not_modified when asked for it again if nothing changed in between.
+ */
+std::map<std::string, config> addons_list_cache;
+
+/** How many add-ons addons_client::download_addons() fetches at once. */
+const std::size_t max_parallel_downloads = 4;
+
+/** How many times addons_client::download_addons() tries each add-on. */
+const unsigned max_download_attempts = 3;
+
+void make_download_request(config& request_buf, const std::string& id, const version_info& version, bool increase_downloads)
+{
+	config& request_body = request_buf.add_child("request_campaign");
+
+	request_body["name"] = id;
+	request_body["increase_downloads"] = increase_downloads;
+	request_body["version"] = version.str();
+	request_body["from_version"] = get_addon_version_info(id);
+}
+}
+
 addons_client::addons_client(const std::string& address)
 	: addr_(address)
 	, host_()
@@ -124,10 +163,29 @@ bool addons_client::request_addons_list(config& cfg)
 	/** @todo FIXME: get rid of this legacy "campaign"/"campaigns" silliness
 	 */
 
-	send_simple_request("request_campaign_list", response_buf);
+	config request;
+	config& list_request = request.add_child("request_campaign_list");
+
+	auto cached = addons_list_cache.find(addr_);
+	if(cached != addons_list_cache.end()) {
+		list_request["catalog_hash"] = cached->second["catalog_hash"];
+	}
+
+	send_request(request, response_buf);
 	wait_for_transfer_done(_("Downloading list of add-ons..."));
 
-	std::swap(cfg, response_buf.child("campaigns"));
+	config& campaigns = response_buf.child("campaigns");
+
+	if(campaigns && campaigns["not_modified"].to_bool() && cached != addons_list_cache.end()) {
+		LOG_ADDONS << "Add-ons list unchanged since the last download";
+		cfg = cached->second;
+	} else {
+		std::swap(cfg, campaigns);
+
+		if(!cfg["catalog_hash"].empty()) {
+			addons_list_cache[addr_] = cfg;
+		}
+	}
 
 	return !update_last_error(response_buf);
 }
@@ -214,18 +272,24 @@ bool addons_client::upload_addon(const std::string& id, std::string& response_me
 
 	if(!local_only) {
 		// Try to make an upload pack if it's avaible on the server
+		// Every file is hashed once here rather than on each comparison below
+		config local_index;
+		write_hashlist(local_index, addon_data);
+
 		config hashlist, hash_request;
 		config& request_body = hash_request.add_child("request_campaign_hash");
 		// We're requesting the latest version of an addon, so we may not specify it
 		// #TODO: Make a selection of the base version for the update ?
 		request_body["name"] = cfg["name"];
+		// Lets the server skip sending its index if it's the same as ours
+		request_body["index_checksum"] = hashlist_checksum(local_index);
 		// request_body["from"] = ???
 		send_request(hash_request, hashlist);
 		wait_for_transfer_done(_("Requesting file index..."));
 
 		// A silent error check
-		if(!hashlist.child("error")) {
-			if(!contains_hashlist(addon_data, hashlist) || !contains_hashlist(hashlist, addon_data)) {
+		if(!hashlist.child("error") && !hashlist["not_modified"].to_bool()) {
+			if(!contains_hashlist(local_index, hashlist) || !contains_hashlist(hashlist, local_index)) {
 				LOG_ADDONS << "making an update pack for the add-on " << id;
 				config updatepack;
 				// The client shouldn't send the pack if the server is old due to the previous check,
@@ -315,30 +379,46 @@ bool addons_client::delete_remote_addon(const std::string& id, std::string& resp
 	return !update_last_error(response_buf);
 }
 
-bool addons_client::download_addon(config& archive_cfg, const std::string& id, const std::string& title, const version_info& version, bool increase_downloads)
+bool addons_client::download_addon(std::string& archive_data, const std::string& id, const std::string& title, const version_info& version, bool increase_downloads)
 {
-	archive_cfg.clear();
+	archive_data.clear();
 
 	config request_buf;
-	config& request_body = request_buf.add_child("request_campaign");
-
-	request_body["name"] = id;
-	request_body["increase_downloads"] = increase_downloads;
-	request_body["version"] = version.str();
-	request_body["from_version"] = get_addon_version_info(id);
+	make_download_request(request_buf, id, version, increase_downloads);
 
 	utils::string_map i18n_symbols;
 	i18n_symbols["addon_title"] = font::escape_text(title);
 
 	LOG_ADDONS << "downloading " << id;
 
-	send_request(request_buf, archive_cfg);
+	check_connected();
+	conn_->transfer(request_buf, archive_data);
 	wait_for_transfer_done(VGETTEXT("Downloading add-on <i>$addon_title</i>...", i18n_symbols));
 
-	return !update_last_error(archive_cfg);
+	return !archive_data.empty();
+}
+
+namespace
+{
+/**
+ * Runs @a f on a worker thread, keeping @a dlg updated until it is done.
+ *
+ * @return The result of @a f. Any exception it throws is rethrown here.
+ */
+template<typename F>
+auto run_with_progress(gui2::dialogs::file_progress& dlg, const std::atomic<unsigned>& progress, F&& f)
+{
+	auto result = std::async(std::launch::async, std::forward<F>(f));
+
+	while(result.wait_for(std::chrono::milliseconds(10)) != std::future_status::ready) {
+		dlg.update_progress(progress.load());
+	}
+
+	return result.get();
+}
 }
 
-bool addons_client::install_addon(config& archive_cfg, const addon_info& info)
+bool addons_client::install_addon(const std::string& archive_data, const addon_info& info)
 {
 	const cursor::setter cursor_setter(cursor::WAIT);
 
@@ -346,35 +426,88 @@ bool addons_client::install_addon(config& archive_cfg, const addon_info& info)
 	i18n_symbols["addon_title"] = font::escape_text(info.title);
 
 	auto progress_dlg = gui2::dialogs::file_progress::display(_("Add-ons Manager"), VGETTEXT("Installing add-on <i>$addon_title</i>...", i18n_symbols));
-	auto progress_cb = [&progress_dlg](unsigned value) {
-		progress_dlg->update_progress(value);
+	std::atomic<unsigned> progress{0};
+	auto progress_cb = [&progress](unsigned value) {
+		progress.store(value);
 	};
 
-	if(archive_cfg.has_child("removelist") || archive_cfg.has_child("addlist")) {
-		LOG_ADDONS << "Received an updatepack for the addon '" << info.id << "'";
+	// Decoding, unpacking and writing files all happen on a worker thread,
+	// with only the archive structure kept in memory. Half of the progress
+	// bar goes to reading the archive, the other half to moving files into
+	// place.
 
-		// A consistency check
-		for(const config::any_child entry : archive_cfg.all_children_range()) {
-			if(entry.key == "removelist" || entry.key == "addlist") {
-				if(!check_names_legal(entry.cfg)) {
-					gui2::show_error_message(VGETTEXT("The add-on <i>$addon_title</i> has an invalid file or directory "
-									"name and cannot be installed.", i18n_symbols));
-					return false;
-				}
-				if(!check_case_insensitive_duplicates(entry.cfg)) {
-					gui2::show_error_message(VGETTEXT("The add-on <i>$addon_title</i> has file or directory names "
-									"with case conflicts. This may cause problems.", i18n_symbols));
+	const std::string staging_dir = filesystem::get_user_data_dir() + "/addon_staging/" + info.id;
+	filesystem::delete_directory(staging_dir);
+	ON_SCOPE_EXIT(&staging_dir) { filesystem::delete_directory(staging_dir); };
+
+	struct unpacked_archive
+	{
+		config cfg;
+		bool names_legal;
+		bool no_case_conflicts;
+	};
+
+	unpacked_archive archive = run_with_progress(*progress_dlg, progress, [&]() {
+		unpacked_archive res { config(), true, true };
+
+		boost::iostreams::stream<boost::iostreams::array_source> in(archive_data.data(), archive_data.size());
+		read_staged_addon_archive(in, res.cfg, staging_dir, [&]() {
+			const auto pos = static_cast<std::size_t>(std::max<std::streamoff>(in.tellg(), 0));
+			progress.store(static_cast<unsigned>(50 * pos / std::max<std::size_t>(archive_data.size(), 1)));
+		});
+
+		if(res.cfg.has_child("error")) {
+			return res;
+		}
+
+		if(res.cfg.has_child("removelist") || res.cfg.has_child("addlist")) {
+			for(const config::any_child entry : res.cfg.all_children_range()) {
+				if(entry.key == "removelist" || entry.key == "addlist") {
+					res.names_legal = res.names_legal && check_names_legal(entry.cfg);
+					res.no_case_conflicts = res.no_case_conflicts && check_case_insensitive_duplicates(entry.cfg);
 				}
 			}
+		} else {
+			res.names_legal = check_names_legal(res.cfg);
+			res.no_case_conflicts = check_case_insensitive_duplicates(res.cfg);
 		}
 
-		for(const config::any_child entry : archive_cfg.all_children_range()) {
-			if(entry.key == "removelist") {
-				purge_addon(entry.cfg);
-			} else if(entry.key == "addlist") {
-				unarchive_addon(entry.cfg, progress_cb);
+		return res;
+	});
+
+	if(update_last_error(archive.cfg)) {
+		return false;
+	}
+
+	if(!archive.names_legal) {
+		gui2::show_error_message(VGETTEXT("The add-on <i>$addon_title</i> has an invalid file or directory "
+						"name and cannot be installed.", i18n_symbols));
+		return false;
+	}
+
+	if(!archive.no_case_conflicts) {
+		gui2::show_error_message(VGETTEXT("The add-on <i>$addon_title</i> has file or directory names "
+						"with case conflicts. This may cause problems.", i18n_symbols));
+	}
+
+	auto unpack_progress_cb = [&progress](unsigned value) {
+		progress.store(50 + value / 2);
+	};
+
+	const config& archive_cfg = archive.cfg;
+
+	if(archive_cfg.has_child("removelist") || archive_cfg.has_child("addlist")) {
+		LOG_ADDONS << "Received an updatepack for the addon '" << info.id << "'";
+
+		run_with_progress(*progress_dlg, progress, [&]() {
+			for(const config::any_child entry : archive_cfg.all_children_range()) {
+				if(entry.key == "removelist") {
+					purge_addon(entry.cfg);
+				} else if(entry.key == "addlist") {
+					unarchive_addon(entry.cfg, unpack_progress_cb, staging_dir);
+				}
 			}
-		}
+		});
 
 		LOG_ADDONS << "Update completed.";
 
@@ -382,27 +515,22 @@ bool addons_client::install_addon(config& archive_cfg, const addon_info& info)
 	} else {
 		LOG_ADDONS << "Received a full pack for the addon '" << info.id << "'";
 
-		if(!check_names_legal(archive_cfg)) {
-			gui2::show_error_message(VGETTEXT("The add-on <i>$addon_title</i> has an invalid file or directory "
-							"name and cannot be installed.", i18n_symbols));
-			return false;
-		}
-		if(!check_case_insensitive_duplicates(archive_cfg)) {
-			gui2::show_error_message(VGETTEXT("The add-on <i>$addon_title</i> has file or directory names "
-							"with case conflicts. This may cause problems.", i18n_symbols));
-		}
-
 		LOG_ADDONS << "unpacking " << info.id;
 
-		// Remove any previously installed versions
-		if(!remove_local_addon(info.id)) {
-			WRN_ADDONS << "failed to uninstall previous version of " << info.id << "; the add-on may not work properly!";
-		}
+		run_with_progress(*progress_dlg, progress, [&]() {
+			// Remove any previously installed versions
+			if(!remove_local_addon(info.id)) {
+				WRN_ADDONS << "failed to uninstall previous version of " << info.id << "; the add-on may not work properly!";
+			}
+
+			unarchive_addon(archive_cfg, unpack_progress_cb, staging_dir);
+		});
 
-		unarchive_addon(archive_cfg, progress_cb);
 		LOG_ADDONS << "unpacking finished";
 	}
 
+	progress_cb(100);
+
 	config info_cfg;
 	info.write_minimal(info_cfg);
 	write_addon_install_info(info.id, info_cfg);
@@ -412,7 +540,7 @@ bool addons_client::install_addon(config& archive_cfg, const addon_info& info)
 
 bool addons_client::try_fetch_addon(const addon_info & addon)
 {
-	config archive;
+	std::string archive;
 
 	if(!(
 		download_addon(archive, addon.id, addon.display_title_full(), addon.current_version, !is_addon_installed(addon.id)) &&
@@ -429,6 +557,39 @@ bool addons_client::try_fetch_addon(const addon_info & addon)
 	}
 }
 
+std::vector<std::string> addons_client::try_fetch_addons(const std::vector<const addon_info*>& targets)
+{
+	std::map<std::string, std::string> archives;
+
+	download_addons(targets, archives);
+
+	std::vector<std::string> failed_titles;
+	std::vector<std::string> error_lines;
+
+	for(const addon_info* addon : targets) {
+		auto archive = archives.find(addon->id);
+		if(archive == archives.end() || !install_addon(archive->second, *addon)) {
+			failed_titles.push_back(addon->display_title_full());
+
+			if(archive != archives.end() && !get_last_server_error().empty()) {
+				error_lines.push_back(addon->display_title_full() + ": " + get_last_server_error());
+			}
+		}
+
+		// Don't keep the archive around once it's been installed
+		if(archive != archives.end()) {
+			archives.erase(archive);
+		}
+	}
+
+	if(!error_lines.empty()) {
+		gui2::show_error_message(
+			_("The server responded with an error:") + "\n" + utils::bullet_list(error_lines));
+	}
+
+	return failed_titles;
+}
+
 addons_client::install_result addons_client::do_resolve_addon_dependencies(const addons_list& addons, const addon_info& addon)
 {
 	install_result result;
@@ -511,16 +672,15 @@ addons_client::install_result addons_client::do_resolve_addon_dependencies(const
 	// Install dependencies now.
 	//
 
-	std::vector<std::string> failed_titles;
-
+	std::vector<const addon_info*> targets;
 	for(const std::string& dep : missing_deps) {
-		const addon_info& missing_addon = addons.at(dep);
+		targets.push_back(&addons.at(dep));
+	}
 
-		if(!try_fetch_addon(missing_addon)) {
-			failed_titles.push_back(missing_addon.title);
-		} else {
-			result.wml_changed = true;
-		}
+	const std::vector<std::string>& failed_titles = try_fetch_addons(targets);
+
+	if(failed_titles.size() < targets.size()) {
+		result.wml_changed = true;
 	}
 
 	if(!failed_titles.empty()) {
@@ -595,6 +755,49 @@ addons_client::install_result addons_client::install_addon_with_checks(const add
 	}
 }
 
+addons_client::install_result addons_client::install_addons_with_checks(const addons_list& addons, const std::vector<const addon_info*>& targets)
+{
+	install_result res;
+	res.outcome = install_outcome::success;
+	res.wml_changed = false;
+
+	std::vector<const addon_info*> fetch_targets;
+
+	for(const addon_info* addon : targets) {
+		if(!do_check_before_overwriting_addon(*addon)) {
+			// Leave this one alone but carry on with the rest.
+			res.outcome = install_outcome::abort;
+			continue;
+		}
+
+		install_result dep_res = do_resolve_addon_dependencies(addons, *addon);
+		res.wml_changed |= dep_res.wml_changed;
+
+		if(dep_res.outcome != install_outcome::success) {
+			res.outcome = dep_res.outcome;
+			return res; // user aborted
+		}
+
+		fetch_targets.push_back(addon);
+	}
+
+	if(fetch_targets.empty()) {
+		return res;
+	}
+
+	const std::vector<std::string>& failed_titles = try_fetch_addons(fetch_targets);
+
+	if(failed_titles.size() < fetch_targets.size()) {
+		res.wml_changed = true;
+	}
+
+	if(!failed_titles.empty()) {
+		res.outcome = install_outcome::failure;
+	}
+
+	return res;
+}
+
 bool addons_client::update_last_error(config& response_cfg)
 {
 	if(const config& error = response_cfg.child("error")) {
@@ -688,6 +891,183 @@ struct write_addon_connection_data : public network_transmission::connection_dat
 	network_asio::connection& conn_;
 	addons_client& client_;
 };
+/** Drives several download connections at once, see addons_client::download_addons(). */
+struct parallel_download_data : public network_transmission::connection_data
+{
+	struct job
+	{
+		std::string id;
+		config request;
+		unsigned attempts;
+	};
+
+	struct slot
+	{
+		std::unique_ptr<network_asio::connection> conn;
+		std::optional<std::size_t> job;
+		/** Last known size of the transfer in progress. */
+		std::size_t expected = 0;
+		std::string response;
+	};
+
+	parallel_download_data(const std::string& host, const std::string& port, std::vector<job> jobs,
+		std::map<std::string, std::string>& archives)
+		: host_(host)
+		, port_(port)
+		, jobs_(std::move(jobs))
+		, queue_()
+		, slots_(std::min(max_parallel_downloads, jobs_.size()))
+		, archives_(archives)
+		, bytes_finished_(0)
+	{
+		for(std::size_t i = 0; i < jobs_.size(); ++i) {
+			queue_.push_back(i);
+		}
+
+		for(slot& s : slots_) {
+			s.conn.reset(new network_asio::connection(host_, port_));
+		}
+	}
+
+	std::size_t total() override
+	{
+		std::size_t bytes = bytes_finished_;
+		for(const slot& s : slots_) {
+			bytes += s.conn->bytes_to_read();
+		}
+		return bytes;
+	}
+
+	std::size_t current() override
+	{
+		std::size_t bytes = bytes_finished_;
+		for(const slot& s : slots_) {
+			bytes += s.conn->bytes_read();
+		}
+		return bytes;
+	}
+
+	bool finished() override
+	{
+		return slots_.empty() || (queue_.empty() && std::none_of(slots_.begin(), slots_.end(), [](const slot& s) { return s.job.has_value(); }));
+	}
+
+	void cancel() override
+	{
+		slots_.clear();
+		queue_.clear();
+	}
+
+	void poll() override
+	{
+		for(auto iter = slots_.begin(); iter != slots_.end();) {
+			slot& s = *iter;
+
+			try {
+				if(s.job) {
+					s.expected = std::max(s.expected, s.conn->bytes_to_read());
+				}
+
+				s.conn->poll();
+
+				if(s.conn->done()) {
+					if(s.job) {
+						finish(s);
+					}
+
+					start_next(s);
+				}
+			} catch(const std::exception& e) {
+				if(!s.job) {
+					// Couldn't even connect, leave the rest to the other connections.
+					ERR_ADDONS << "add-on download connection failed: " << e.what();
+					iter = slots_.erase(iter);
+					continue;
+				}
+
+				job& j = jobs_[*s.job];
+				ERR_ADDONS << "downloading " << j.id << " failed: " << e.what();
+
+				if(++j.attempts < max_download_attempts) {
+					queue_.push_back(*s.job);
+				}
+
+				s.job.reset();
+				s.conn.reset(new network_asio::connection(host_, port_));
+			}
+
+			++iter;
+		}
+	}
+
+private:
+	void finish(slot& s)
+	{
+		const job& j = jobs_[*s.job];
+		s.job.reset();
+		bytes_finished_ += s.expected;
+
+		LOG_ADDONS << "downloaded " << j.id;
+		archives_[j.id] = std::move(s.response);
+		s.response.clear();
+	}
+
+	void start_next(slot& s)
+	{
+		if(queue_.empty()) {
+			return;
+		}
+
+		s.job = queue_.front();
+		s.expected = 0;
+		queue_.pop_front();
+
+		LOG_ADDONS << "downloading " << jobs_[*s.job].id;
+		s.conn->transfer(jobs_[*s.job].request, s.response);
+	}
+
+	const std::string& host_;
+	const std::string& port_;
+	std::vector<job> jobs_;
+	std::deque<std::size_t> queue_;
+	std::list<slot> slots_;
+	std::map<std::string, std::string>& archives_;
+	std::size_t bytes_finished_;
+};
+
+void addons_client::download_addons(const std::vector<const addon_info*>& targets, std::map<std::string, std::string>& archives)
+{
+	if(targets.size() == 1) {
+		// Nothing to gain from extra connections
+		const addon_info& addon = *targets.front();
+		std::string archive;
+		if(download_addon(archive, addon.id, addon.display_title_full(), addon.current_version, !is_addon_installed(addon.id))) {
+			archives[addon.id] = std::move(archive);
+		}
+		return;
+	}
+
+	std::vector<parallel_download_data::job> jobs;
+
+	for(const addon_info* addon : targets) {
+		parallel_download_data::job j { addon->id, config(), 0 };
+		make_download_request(j.request, addon->id, addon->current_version, !is_addon_installed(addon->id));
+		jobs.push_back(std::move(j));
+	}
+
+	parallel_download_data cd{host_, port_, std::move(jobs), archives};
+
+	utils::string_map i18n_symbols;
+	i18n_symbols["count"] = std::to_string(targets.size());
+
+	gui2::dialogs::network_transmission stat(cd, _("Add-ons Manager"),
+		VNGETTEXT("Downloading $count add-on...", "Downloading $count add-ons...", targets.size(), i18n_symbols));
+
+	if(!stat.show()) {
+		throw user_exit();
+	}
+}
+
 void addons_client::wait_for_transfer_done(const std::string& status_message, transfer_mode mode)
 {
 	check_connected();
@@ -28,7 +28,9 @@
 #include "gui/dialogs/network_transmission.hpp"
 #include "network_asio.hpp"
 
+#include <map>
 #include <set>
+#include <vector>
 
 /**
  * Add-ons (campaignd) client class.
@@ -154,6 +156,20 @@ public:
 	 */
 	install_result install_addon_with_checks(const addons_list& addons, const addon_info& addon);
 
+	/**
+	 * Performs a download and install cycle for several add-ons at once.
+	 *
+	 * The same checks as install_addon_with_checks() are done for each
+	 * add-on first, then all of them are downloaded in parallel.
+	 *
+	 * @param addons             Add-ons list used for resolving dependencies.
+	 * @param targets            The add-ons that will be downloaded.
+	 *
+	 * @return An install_result with the overall outcome of the operation,
+	 *         which is a failure if any of the add-ons failed to install.
+	 */
+	install_result install_addons_with_checks(const addons_list& addons, const std::vector<const addon_info*>& targets);
+
 	/**
 	 * Uploads an add-on to the server.
 	 *
@@ -239,26 +255,52 @@ private:
 	*
 	* @return @a true on success, @a false on failure. Retrieve the error message with @a get_last_server_error.
 	*
-	* @param archive_cfg         Config object to hold the downloaded add-on archive data.
+	* Server errors are only detected once the archive is installed.
+	*
+	* @param archive_data        Receives the gzipped add-on archive as sent by the server.
 	* @param id                  Add-on id.
 	* @param title               Add-on title, used for status display.
 	* @param version             Specifies an add-on version to download.
 	* @param increase_downloads  Whether to request the server to increase the add-on's
 	*                            download count or not (e.g. when upgrading).
 	*/
-	bool download_addon(config& archive_cfg, const std::string& id, const std::string& title, const version_info& version, bool increase_downloads = true);
+	bool download_addon(std::string& archive_data, const std::string& id, const std::string& title, const version_info& version, bool increase_downloads = true);
 
 	/**
 	* Installs the specified add-on using an archive received from the server.
 	*
 	* An _info.cfg file will be added to the local directory for the add-on
 	* to keep track of version and dependency information.
+	*
+	* The archive is decoded, checked and written to disk on a worker thread.
+	* File contents are staged on disk as they are decoded, so only the
+	* archive structure is ever held in memory.
+	*
+	* @return @a true on success, @a false on failure. Retrieve the server error message, if any, with @a get_last_server_error.
 	*/
-	bool install_addon(config& archive_cfg, const addon_info& info);
+	bool install_addon(const std::string& archive_data, const addon_info& info);
 
 	// Asks the client to download and install an addon, reporting errors in a gui dialog. Returns true if new content was installed, false otherwise.
 	bool try_fetch_addon(const addon_info& addon);
 
+	/**
+	 * Downloads several add-ons at once over extra connections to the server.
+	 *
+	 * Transfers that fail because of a network error are retried on a new
+	 * connection a couple of times before giving up.
+	 *
+	 * @param targets             The add-ons to download.
+	 * @param archives            Receives the gzipped archives, keyed by add-on id.
+	 */
+	void download_addons(const std::vector<const addon_info*>& targets, std::map<std::string, std::string>& archives);
+
+	/**
+	 * Downloads and installs several add-ons at once, reporting errors in a gui dialog.
+	 *
+	 * @return The titles of the add-ons that could not be installed.
+	 */
+	std::vector<std::string> try_fetch_addons(const std::vector<const addon_info*>& targets);
+
 	/**
 	* Warns the user about unresolved dependencies and installs them if they choose to do so.
 	* Returns: outcome: abort in case the user chose to abort because of an issue
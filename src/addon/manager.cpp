@@ -23,6 +23,8 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <algorithm>
+
 static lg::log_domain log_config("config");
 #define ERR_CFG LOG_STREAM(err , log_config)
 #define LOG_CFG LOG_STREAM(info, log_config)
@@ -288,12 +290,26 @@ void archive_addon(const std::string& addon_name, config& cfg)
 	archive_dir(parentd, addon_name, cfg.add_child("dir"), ignore_patterns);
 }
 
-static void unarchive_file(const std::string& path, const config& cfg)
+static void unarchive_file(const std::string& path, const config& cfg, const std::string& staging_dir)
 {
-	filesystem::write_file(path + '/' + cfg["name"].str(), unencode_binary(cfg["contents"]));
+	const std::string& dest = path + '/' + cfg["name"].str();
+	const std::string& staged = cfg["staged"].str();
+
+	// Staged files are only ever named by read_staged_addon_archive(), so
+	// don't let the archive point anywhere else.
+	if(staging_dir.empty() || staged.empty() || !std::all_of(staged.begin(), staged.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+		filesystem::write_file(dest, unencode_binary(cfg["contents"]));
+		return;
+	}
+
+	const std::string& src = staging_dir + '/' + staged;
+	if(!filesystem::rename_file(src, dest)) {
+		filesystem::copy_file(src, dest);
+		filesystem::delete_file(src);
+	}
 }
 
-static void unarchive_dir(const std::string& path, const config& cfg, std::function<void()> file_callback = {})
+static void unarchive_dir(const std::string& path, const config& cfg, const std::string& staging_dir, std::function<void()> file_callback = {})
 {
 	std::string dir;
 	if (cfg["name"].empty())
@@ -304,11 +320,11 @@ static void unarchive_dir(const std::string& path, const config& cfg, std::funct
 	filesystem::make_directory(dir);
 
 	for(const config &d : cfg.child_range("dir")) {
-		unarchive_dir(dir, d, file_callback);
+		unarchive_dir(dir, d, staging_dir, file_callback);
 	}
 
 	for(const config &f : cfg.child_range("file")) {
-		unarchive_file(dir, f);
+		unarchive_file(dir, f, staging_dir);
 		if(file_callback) {
 			file_callback();
 		}
@@ -326,14 +342,44 @@ static unsigned count_pack_files(const config& cfg)
 	return count + cfg.child_count("file");
 }
 
-void unarchive_addon(const config& cfg, std::function<void(unsigned)> progress_callback)
+void read_staged_addon_archive(std::istream& in, config& cfg, const std::string& staging_dir, std::function<void()> file_callback)
+{
+	filesystem::make_directory(staging_dir);
+
+	unsigned staged_count = 0;
+
+	read_gz(cfg, in, [&](const std::string& tag, config& file) {
+		if(tag != "file") {
+			return;
+		}
+
+		file.remove_attribute("staged");
+
+		if(!file.has_attribute("contents")) {
+			// Update pack removelists only list names
+			return;
+		}
+
+		const std::string& staged = std::to_string(staged_count++);
+		filesystem::write_file(staging_dir + '/' + staged, unencode_binary(file["contents"]));
+
+		file.remove_attribute("contents");
+		file["staged"] = staged;
+
+		if(file_callback) {
+			file_callback();
+		}
+	});
+}
+
+void unarchive_addon(const config& cfg, std::function<void(unsigned)> progress_callback, const std::string& staging_dir)
 {
 	const std::string parentd = filesystem::get_addons_dir();
 	unsigned file_count = progress_callback ? count_pack_files(cfg) : 0, done = 0;
 	auto file_callback = progress_callback
 		? [&]() { progress_callback(++done * 100.0 / file_count); }
 		: std::function<void()>{};
-	unarchive_dir(parentd, cfg, file_callback);
+	unarchive_dir(parentd, cfg, staging_dir, file_callback);
 }
 
 static void purge_dir(const std::string& path, const config& removelist)
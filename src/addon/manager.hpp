@@ -34,6 +34,7 @@ class version_info;
 #include "addon/validation.hpp"
 
 #include <functional>
+#include <iosfwd>
 #include <string>
 #include <vector>
 #include <utility>
@@ -153,8 +154,28 @@ bool is_addon_installed(const std::string& addon_name);
 /** Archives an add-on into a config object for campaignd transactions. */
 void archive_addon(const std::string& addon_name, class config& cfg);
 
-/** Unarchives an add-on from campaignd's retrieved config object. */
-void unarchive_addon(const class config& cfg, std::function<void(unsigned)> progress_callback = {});
+/**
+ * Reads an add-on archive received from campaignd, writing out file contents as they are decoded.
+ *
+ * Only the archive structure is kept in @a cfg. The contents of each file are
+ * written to @a staging_dir instead and replaced by a @a staged attribute,
+ * which unarchive_addon() uses to move the file into place. This way only one
+ * file is held in memory at a time regardless of the size of the archive.
+ *
+ * @param in                 The gzipped archive WML.
+ * @param cfg                Receives the archive structure.
+ * @param staging_dir        Where to write file contents.
+ * @param file_callback      Called after each file is written.
+ */
+void read_staged_addon_archive(std::istream& in, class config& cfg, const std::string& staging_dir, std::function<void()> file_callback = {});
+
+/**
+ * Unarchives an add-on from campaignd's retrieved config object.
+ *
+ * @param staging_dir        Where the files of an archive read with
+ *                           read_staged_addon_archive() were written.
+ */
+void unarchive_addon(const class config& cfg, std::function<void(unsigned)> progress_callback = {}, const std::string& staging_dir = {});
 
 /** Removes the listed files from the addon. */
 void purge_addon(const config& removelist);
@@ -275,6 +275,7 @@ bool ad_hoc_addon_fetch_session(const std::vector<std::string>& addon_ids)
 
 		bool return_value = true;
 		std::ostringstream os;
+		std::vector<const addon_info*> targets;
 		for(const std::string& addon_id : addon_ids) {
 			addons_list::const_iterator it = addons.find(addon_id);
 			if(it != addons.end()) {
@@ -302,8 +303,7 @@ bool ad_hoc_addon_fetch_session(const std::vector<std::string>& addon_ids)
 				}
 
 				// if the add-on exists locally and needs to be updated, or it doesn't exist and needs to be downloaded
-				addons_client::install_result res = client.install_addon_with_checks(addons, addon);
-				return_value = return_value && (res.outcome == addons_client::install_outcome::success);
+				targets.push_back(&addon);
 			} else {
 				if(!return_value) {
 					os << ", ";
@@ -313,7 +313,14 @@ bool ad_hoc_addon_fetch_session(const std::vector<std::string>& addon_ids)
 			}
 		}
 
-		if(!return_value) {
+		const bool found_all = return_value;
+
+		if(!targets.empty()) {
+			addons_client::install_result res = client.install_addons_with_checks(addons, targets);
+			return_value = return_value && (res.outcome == addons_client::install_outcome::success);
+		}
+
+		if(!found_all) {
 			utils::string_map symbols;
 			symbols["addon_ids"] = os.str();
 			gui2::show_error_message(VGETTEXT("Could not find add-ons matching the ids $addon_ids on the add-on server.", symbols));
@@ -22,6 +22,8 @@
 
 #include <algorithm>
 #include <array>
+#include <iomanip>
+#include <sstream>
 #include <boost/algorithm/string.hpp>
 
 const unsigned short default_campaignd_port = 15017;
@@ -318,6 +320,34 @@ bool contains_hashlist(const config& from, const config& to)
 	return true;
 }
 
+/** FNV-1a of every file's path and hash, summed so that the order doesn't matter. */
+static void add_hashlist_checksum(uint64_t& sum, const config& dir, const std::string& prefix)
+{
+	for(const config& f : dir.child_range("file")) {
+		uint64_t h = 14695981039346656037ULL;
+		for(const std::string& part : {prefix, f["name"].str(), std::string(1, '\0'), file_hash(f)}) {
+			for(unsigned char c : part) {
+				h = (h ^ c) * 1099511628211ULL;
+			}
+		}
+		sum += h;
+	}
+
+	for(const config& d : dir.child_range("dir")) {
+		add_hashlist_checksum(sum, d, prefix + d["name"].str() + '/');
+	}
+}
+
+std::string hashlist_checksum(const config& hashlist)
+{
+	uint64_t sum = 0;
+	add_hashlist_checksum(sum, hashlist, "");
+
+	std::ostringstream out;
+	out << std::hex << std::setw(16) << std::setfill('0') << sum;
+	return out.str();
+}
+
 /** Surround with [dir][/dir] */
 static bool write_difference(config& pack, const config& from, const config& to, bool with_content)
 {
@@ -162,4 +162,14 @@ std::string file_hash(const config& file);
 bool comp_file_hash(const config& file_a, const config& file_b);
 void write_hashlist(config& hashlist, const config& data);
 bool contains_hashlist(const config& from, const config& to);
+
+/**
+ * Cheap checksum of a hash list, for telling whether two add-on versions differ.
+ *
+ * It is not cryptographic and doesn't depend on the order of the entries,
+ * only on the path and hash of every file.
+ *
+ * @return 16 hex digits.
+ */
+std::string hashlist_checksum(const config& hashlist);
 void make_updatepack(config& pack, const config& from, const config& to);
@@ -32,9 +32,7 @@ static lg::log_domain log_ai_aspect("ai/aspect");
 aspect::aspect(readonly_context &context, const config &cfg, const std::string &id):
 	time_of_day_(cfg["time_of_day"]),turns_(cfg["turns"]),
 	valid_(false), valid_variant_(false), valid_lua_(false), cfg_(cfg),
-	invalidate_on_turn_start_(cfg["invalidate_on_turn_start"].to_bool(true)),
-	invalidate_on_tod_change_(cfg["invalidate_on_tod_change"].to_bool(true)),
-	invalidate_on_gamestate_change_(cfg["invalidate_on_gamestate_change"].to_bool()),
+	invalidate_on_(0), observed_(0),
 	engine_(cfg["engine"]), name_(cfg["name"]), id_(id)
 	{
 		DBG_AI_ASPECT << "creating new aspect: engine=["<<engine_<<"], name=["<<name_<<"], id=["<<id_<<"]";
@@ -45,16 +43,7 @@ aspect::aspect(readonly_context &context, const config &cfg, const std::string &
 
 aspect::~aspect()
 	{
-		manager& manager = manager::get_singleton();
-		if (invalidate_on_turn_start_) {
-			manager.remove_turn_started_observer(this);
-		}
-		if (invalidate_on_tod_change_) {
-			manager.remove_tod_changed_observer(this);
-		}
-		if (invalidate_on_gamestate_change_) {
-			manager.remove_gamestate_observer(this);
-		}
+		observe(0);
 	}
 
 lg::log_domain& aspect::log()
@@ -66,49 +55,100 @@ void aspect::on_create()
 {
 }
 
-bool aspect::redeploy(const config &cfg, const std::string& /*id*/)
+namespace {
+
+/** The config keys declaring the aspect dependencies, with their defaults. */
+struct dependency_key
 {
+	aspect::dependency dep;
+	const char* key;
+	bool def;
+};
+
+const dependency_key dependency_keys[] {
+	{ aspect::TURN_STARTED, "invalidate_on_turn_start", true },
+	{ aspect::TOD_CHANGED, "invalidate_on_tod_change", true },
+	{ aspect::GAMESTATE_CHANGED, "invalidate_on_gamestate_change", false },
+	{ aspect::MAP_CHANGED, "invalidate_on_map_change", false },
+	{ aspect::RECRUIT_LIST_CHANGED, "invalidate_on_recruit_list_change", false },
+};
+
+} // end anon namespace
+
+void aspect::observe(unsigned deps)
+{
+	const unsigned added = deps & ~observed_;
+	const unsigned removed = observed_ & ~deps;
+	if (added == 0 && removed == 0) {
+		return;
+	}
+
 	manager& manager = manager::get_singleton();
 
-	if (invalidate_on_turn_start_) {
+	if (removed & TURN_STARTED) {
 		manager.remove_turn_started_observer(this);
 	}
-	if (invalidate_on_tod_change_) {
+	if (removed & TOD_CHANGED) {
 		manager.remove_tod_changed_observer(this);
 	}
-	if (invalidate_on_gamestate_change_) {
+	if (removed & GAMESTATE_CHANGED) {
 		manager.remove_gamestate_observer(this);
 	}
+	if (removed & MAP_CHANGED) {
+		manager.remove_map_changed_observer(this);
+	}
+	if (removed & RECRUIT_LIST_CHANGED) {
+		manager.remove_recruit_list_changed_observer(this);
+	}
 
+	if (added & TURN_STARTED) {
+		manager.add_turn_started_observer(this);
+	}
+	if (added & TOD_CHANGED) {
+		manager.add_tod_changed_observer(this);
+	}
+	if (added & GAMESTATE_CHANGED) {
+		manager.add_gamestate_observer(this);
+	}
+	if (added & MAP_CHANGED) {
+		manager.add_map_changed_observer(this);
+	}
+	if (added & RECRUIT_LIST_CHANGED) {
+		manager.add_recruit_list_changed_observer(this);
+	}
+
+	observed_ = deps;
+
+	// Whatever was missed while not observing it is gone now.
+	invalidate();
+}
+
+bool aspect::redeploy(const config &cfg, const std::string& /*id*/)
+{
 	valid_ = false;
 	valid_variant_ =false;
 	valid_lua_ = false;
 	cfg_ = cfg;
-	invalidate_on_turn_start_ = cfg["invalidate_on_turn_start"].to_bool(true);
-	invalidate_on_tod_change_ = cfg["invalidate_on_tod_change"].to_bool(true);
-	invalidate_on_gamestate_change_ = cfg["invalidate_on_gamestate_change"].to_bool();
+	invalidate_on_ = 0;
+	for (const dependency_key& d : dependency_keys) {
+		if (cfg[d.key].to_bool(d.def)) {
+			invalidate_on_ |= d.dep;
+		}
+	}
 	engine_ = cfg["engine"].str();
 	name_ = cfg["name"].str();
 	id_ = cfg["id"].str();
 	DBG_AI_ASPECT << "redeploying aspect: engine=["<<engine_<<"], name=["<<name_<<"], id=["<<id_<<"]";
-	if (invalidate_on_turn_start_) {
-		manager.add_turn_started_observer(this);
-	}
-	if (invalidate_on_tod_change_) {
-		manager.add_tod_changed_observer(this);
-	}
-	if (invalidate_on_gamestate_change_) {
-		manager.add_gamestate_observer(this);
-	}
+	observe(dependencies());
 	return true;
 }
 
 config aspect::to_config() const
 {
 	config cfg;
-	cfg["invalidate_on_turn_start"] = invalidate_on_turn_start_;
-	cfg["invalidate_on_tod_change"] = invalidate_on_tod_change_;
-	cfg["invalidate_on_gamestate_change"] = invalidate_on_gamestate_change_;
+	for (const dependency_key& d : dependency_keys) {
+		cfg[d.key] = (invalidate_on_ & d.dep) != 0;
+	}
 	if (!time_of_day_.empty()) {
 		cfg["time_of_day"] = time_of_day_;
 	}
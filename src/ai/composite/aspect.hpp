@@ -66,6 +66,25 @@ public:
 		invalidate();
 	}
 
+	/**
+	 * The changes in the game an aspect's value can depend on. Each one is
+	 * declared by an invalidate_on_* key, and the aspect is only
+	 * recalculated after one of the changes it depends on.
+	 */
+	enum dependency : unsigned {
+		TURN_STARTED = 1 << 0,
+		TOD_CHANGED = 1 << 1,
+		GAMESTATE_CHANGED = 1 << 2,
+		MAP_CHANGED = 1 << 3,
+		RECRUIT_LIST_CHANGED = 1 << 4,
+	};
+
+	/** The changes this aspect depends on, including those of its facets. */
+	virtual unsigned dependencies() const
+	{
+		return invalidate_on_;
+	}
+
 	virtual bool active() const;
 
 	virtual std::string get_name() const
@@ -80,6 +99,9 @@ public:
 	static lg::log_domain& log();
 
 protected:
+	/** Makes the aspect get invalidated by exactly the changes in @a deps. */
+	void observe(unsigned deps);
+
 	std::string time_of_day_;
 	std::string turns_;
 
@@ -88,9 +110,10 @@ protected:
 	mutable bool valid_lua_;
 
 	config cfg_;
-	bool invalidate_on_turn_start_;
-	bool invalidate_on_tod_change_;
-	bool invalidate_on_gamestate_change_;
+	/** The dependencies declared in the config. */
+	unsigned invalidate_on_;
+	/** The dependencies the aspect currently observes. */
+	unsigned observed_;
 	std::string engine_;
 	std::string name_;
 	std::string id_;
@@ -269,6 +292,23 @@ public:
 
 		register_facets_property(this->property_handlers(),"facet",facets_,default_, factory_facets);
 
+		this->observe(dependencies());
+	}
+
+	/**
+	 * The composite keeps the value of its active facet, so it has to be
+	 * recalculated whenever any of its facets would be.
+	 */
+	virtual unsigned dependencies() const
+	{
+		unsigned res = aspect::dependencies();
+		for(const auto& f : facets_) {
+			res |= f->dependencies();
+		}
+		if(default_) {
+			res |= default_->dependencies();
+		}
+		return res;
 	}
 
 	void create_facet(typesafe_aspect_vector<T>& facets, const config &cfg)
@@ -328,6 +368,7 @@ public:
 			facets_.insert(facets_.begin()+pos+j,b);
 			j++;
 		}
+		this->observe(dependencies());
 		return (j>0);
 	}
 
@@ -335,6 +376,7 @@ public:
 	{
 		bool b = !facets_.empty();
 		facets_.clear();
+		this->observe(dependencies());
 		return b;
 	}
 
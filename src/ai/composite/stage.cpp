@@ -25,6 +25,7 @@
 #include "log.hpp"
 #include "resources.hpp"
 #include "tod_manager.hpp"
+#include "utils/perf_counter.hpp"
 #include <map>
 #include <string>
 
@@ -56,6 +57,7 @@ stage::~stage()
 
 bool stage::play_stage()
 {
+	PERF_TIMER("ai::stage::play_stage");
 	return do_play_stage();
 }
 
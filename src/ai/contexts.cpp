@@ -175,6 +175,7 @@ readonly_context_impl::readonly_context_impl(side_context &context, const config
 	defensive_position_cache_(),
 	dstsrc_(),enemy_dstsrc_(),
 	enemy_possible_moves_(),
+	enemy_power_projections_(),
 	enemy_srcdst_(),
 	grouping_(),
 	goals_(),
@@ -192,6 +193,8 @@ readonly_context_impl::readonly_context_impl(side_context &context, const config
 	passive_leader_(),
 	passive_leader_shares_keep_(),
 	possible_moves_(),
+	power_projections_(),
+	power_projections_generation_(0),
 	recruitment_diversity_(),
 	recruitment_instructions_(),
 	recruitment_more_(),
@@ -201,6 +204,7 @@ readonly_context_impl::readonly_context_impl(side_context &context, const config
 	recursion_counter_(context.get_recursion_count()),
 	retreat_enemy_weight_(),
 	retreat_factor_(),
+	routes_(),
 	scout_village_targeting_(),
 	simple_targeting_(),
 	srcdst_(),
@@ -874,6 +878,9 @@ void readonly_context_impl::invalidate_move_maps() const
 	move_maps_valid_ = false;
 	move_maps_enemy_valid_ = false;
 
+	enemy_power_projections_.clear();
+	power_projections_.clear();
+
 	dst_src_valid_lua_ = false;
 	dst_src_enemy_valid_lua_ = false;
 
@@ -886,6 +893,31 @@ const std::set<map_location>& readonly_context_impl::keeps() const
 	return keeps_.get();
 }
 
+pathfind::route_cache& readonly_context_impl::get_route_cache() const
+{
+	return routes_;
+}
+
+route_cache::route_cache()
+	: pathfind::route_cache()
+{
+	ai::manager::get_singleton().add_gamestate_observer(this);
+	ai::manager::get_singleton().add_turn_started_observer(this);
+	ai::manager::get_singleton().add_map_changed_observer(this);
+}
+
+route_cache::~route_cache()
+{
+	ai::manager::get_singleton().remove_gamestate_observer(this);
+	ai::manager::get_singleton().remove_turn_started_observer(this);
+	ai::manager::get_singleton().remove_map_changed_observer(this);
+}
+
+void route_cache::handle_generic_event(const std::string& /*event_name*/)
+{
+	clear();
+}
+
 keeps_cache::keeps_cache()
 	: map_(nullptr)
 	, keeps_()
@@ -985,6 +1017,37 @@ const map_location& readonly_context_impl::nearest_keep(const map_location& loc)
 }
 
 double readonly_context_impl::power_projection(const map_location& loc, const move_map& dstsrc) const
+{
+	// The threat and support maps of our own move maps are asked for by several
+	// candidate actions and aspects, so remember them until the move maps or any
+	// unit position change. Move maps owned by callers are not cached.
+	std::map<map_location, double>* cache = nullptr;
+	if(&dstsrc == &enemy_dstsrc_) {
+		cache = &enemy_power_projections_;
+	} else if(&dstsrc == &dstsrc_) {
+		cache = &power_projections_;
+	}
+
+	if(!cache) {
+		return calculate_power_projection(loc, dstsrc);
+	}
+
+	const std::size_t generation = resources::gameboard->units().generation();
+	if(generation != power_projections_generation_) {
+		enemy_power_projections_.clear();
+		power_projections_.clear();
+		power_projections_generation_ = generation;
+	}
+
+	auto i = cache->find(loc);
+	if(i == cache->end()) {
+		i = cache->emplace(loc, calculate_power_projection(loc, dstsrc)).first;
+	}
+
+	return i->second;
+}
+
+double readonly_context_impl::calculate_power_projection(const map_location& loc, const move_map& dstsrc) const
 {
 	map_location used_locs[6];
 	int ratings[6];
@@ -1104,6 +1167,9 @@ void readonly_context_impl::recalculate_move_maps() const
 	dstsrc_ = move_map();
 	possible_moves_ = moves_map();
 	srcdst_ = move_map();
+	// This also runs at the start of each turn, when the ToD used by the threat map changes.
+	enemy_power_projections_.clear();
+	power_projections_.clear();
 	calculate_possible_moves(possible_moves_,srcdst_,dstsrc_,false,false,&get_avoid());
 	if (is_passive_leader("") && !is_passive_keep_sharing_leader("")) {
 		unit_map::iterator i = resources::gameboard->units().find_leader(get_side());
@@ -1131,6 +1197,7 @@ void readonly_context_impl::recalculate_move_maps_enemy() const
 	enemy_dstsrc_ = move_map();
 	enemy_srcdst_ = move_map();
 	enemy_possible_moves_ = moves_map();
+	enemy_power_projections_.clear();
 	calculate_possible_moves(enemy_possible_moves_,enemy_srcdst_,enemy_dstsrc_,true);
 	move_maps_enemy_valid_ = true;
 
@@ -28,6 +28,7 @@
 #include "generic_event.hpp"         // for observer
 #include "units/ptr.hpp"              // for unit_ptr
 #include "map/location.hpp"       // for map_location
+#include "pathfind/pathfind.hpp"     // for route_cache
 #include "utils/variant.hpp"
 
 #include <map>                          // for map, map<>::value_compare
@@ -118,6 +119,15 @@ private:
 	std::set<map_location> keeps_;
 };
 
+// route cache
+class route_cache : public events::observer, public pathfind::route_cache
+{
+public:
+	route_cache();
+	~route_cache();
+	void handle_generic_event(const std::string& event_name);
+};
+
 // side context
 
 class side_context;
@@ -307,6 +317,12 @@ public:
 
 	virtual const std::set<map_location>& keeps() const= 0;
 
+	/**
+	 * Routes found by a_star_search() since the game state last changed.
+	 * Keyed by the underlying id of the unit moving.
+	 */
+	virtual pathfind::route_cache& get_route_cache() const = 0;
+
 	virtual bool leader_can_reach_keep() const = 0;
 
 	virtual const map_location& nearest_keep(const map_location& loc) const = 0;
@@ -820,6 +836,11 @@ public:
 		return target_->keeps();
 	}
 
+	virtual pathfind::route_cache& get_route_cache() const override
+	{
+		return target_->get_route_cache();
+	}
+
 	virtual bool leader_can_reach_keep() const override
 	{
 		return target_->leader_can_reach_keep();
@@ -1244,6 +1265,8 @@ public:
 
 	virtual const std::set<map_location>& keeps() const override;
 
+	virtual pathfind::route_cache& get_route_cache() const override;
+
 	virtual bool leader_can_reach_keep() const override;
 
 	virtual const map_location& nearest_keep(const map_location& loc) const override;
@@ -1280,6 +1303,9 @@ private:
 
 	bool applies_to_leader(const utils::variant<bool, std::vector<std::string>> &aspect_value, const std::string &id) const;
 
+	/** Uncached power_projection(). */
+	double calculate_power_projection(const map_location& loc, const move_map& dstsrc) const;
+
 	const config cfg_;
 
 	/**
@@ -1300,6 +1326,8 @@ private:
 	mutable move_map dstsrc_;
 	mutable move_map enemy_dstsrc_;
 	mutable moves_map enemy_possible_moves_;
+	/** power_projection() results for enemy_dstsrc_, i.e. the threat to each hex. */
+	mutable std::map<map_location, double> enemy_power_projections_;
 	mutable move_map enemy_srcdst_;
 	typesafe_aspect_ptr<std::string> grouping_;
 	std::vector< goal_ptr > goals_;
@@ -1317,6 +1345,10 @@ private:
 	typesafe_aspect_ptr<utils::variant<bool, std::vector<std::string>>> passive_leader_;
 	typesafe_aspect_ptr<utils::variant<bool, std::vector<std::string>>> passive_leader_shares_keep_;
 	mutable moves_map possible_moves_;
+	/** power_projection() results for dstsrc_, i.e. our support on each hex. */
+	mutable std::map<map_location, double> power_projections_;
+	/** The unit_map::generation() the cached power projections were calculated for. */
+	mutable std::size_t power_projections_generation_;
 	typesafe_aspect_ptr<double> recruitment_diversity_;
 	typesafe_aspect_ptr<config> recruitment_instructions_;
 	typesafe_aspect_ptr<std::vector<std::string>> recruitment_more_;
@@ -1326,6 +1358,7 @@ private:
 	recursion_counter recursion_counter_;
 	typesafe_aspect_ptr<double> retreat_enemy_weight_;
 	typesafe_aspect_ptr<double> retreat_factor_;
+	mutable route_cache routes_;
 	typesafe_aspect_ptr<double> scout_village_targeting_;
 	typesafe_aspect_ptr<bool> simple_targeting_;
 	mutable move_map srcdst_;
@@ -116,8 +116,9 @@ std::shared_ptr<attacks_vector> aspect_attacks_base::analyze_targets() const
 			analysis.vulnerability = 0.0;
 			analysis.support = 0.0;
 
+			attacker_positions_map positions;
 			do_attack_analysis(u.get_location(), srcdst, dstsrc, fullmove_srcdst, fullmove_dstsrc, enemy_srcdst,
-				enemy_dstsrc, adjacent, used_locations, unit_locs, *res, analysis, current_team());
+				enemy_dstsrc, adjacent, used_locations, unit_locs, *res, analysis, current_team(), positions);
 		}
 	}
 	return res;
@@ -135,7 +136,8 @@ void aspect_attacks_base::do_attack_analysis(const map_location& loc,
 	std::vector<map_location>& units,
 	std::vector<attack_analysis>& result,
 	attack_analysis& cur_analysis,
-	const team& current_team) const
+	const team& current_team,
+	attacker_positions_map& positions) const
 {
 	// This function is called fairly frequently, so interact with the user here.
 
@@ -147,7 +149,6 @@ void aspect_attacks_base::do_attack_analysis(const map_location& loc,
 
 	const gamemap& map_ = resources::gameboard->map();
 	unit_map& units_ = resources::gameboard->units();
-	const std::vector<team>& teams_ = resources::gameboard->teams();
 
 	const std::size_t max_positions = 1000;
 	if(result.size() > max_positions && !cur_analysis.movements.empty()) {
@@ -161,64 +162,15 @@ void aspect_attacks_base::do_attack_analysis(const map_location& loc,
 		unit_map::iterator unit_itor = units_.find(current_unit);
 		assert(unit_itor != units_.end());
 
-		// See if the unit has the backstab ability.
-		// Units with backstab will want to try to have a
-		// friendly unit opposite the position they move to.
-		//
-		// See if the unit has the slow ability -- units with slow only attack first.
-		bool backstab = false, slow = false;
-		for(const attack_type& a : unit_itor->attacks()) {
-			// For speed, just assume these specials will be active if they are present.
-			if(a.has_special("backstab", true)) {
-				backstab = true;
-			}
-
-			if(a.has_special("slow", true)) {
-				slow = true;
-			}
+		auto cached = positions.find(current_unit);
+		if(cached == positions.end()) {
+			cached = positions.emplace(current_unit, evaluate_attacker(*unit_itor, loc, dstsrc, tiles, current_team)).first;
 		}
 
-		if(slow && cur_analysis.movements.empty() == false) {
-			continue;
-		}
-
-		// Check if the friendly unit is surrounded,
-		// A unit is surrounded if it is flanked by enemy units
-		// and at least one other enemy unit is nearby
-		// or if the unit is totally surrounded by enemies
-		// with max. one tile to escape.
-		bool is_surrounded = false;
-		bool is_flanked = false;
-		int enemy_units_around = 0;
-		int accessible_tiles = 0;
-		const auto adj = get_adjacent_tiles(current_unit);
-
-		for(std::size_t tile = 0; tile != 3; ++tile) {
-			const unit_map::const_iterator tmp_unit = units_.find(adj[tile]);
-			bool possible_flanked = false;
-
-			if(map_.on_board(adj[tile])) {
-				++accessible_tiles;
-				if(tmp_unit != units_.end() && current_team.is_enemy(tmp_unit->side())) {
-					++enemy_units_around;
-					possible_flanked = true;
-				}
-			}
-
-			const unit_map::const_iterator tmp_opposite_unit = units_.find(adj[tile + 3]);
-			if(map_.on_board(adj[tile + 3])) {
-				++accessible_tiles;
-				if(tmp_opposite_unit != units_.end() && current_team.is_enemy(tmp_opposite_unit->side())) {
-					++enemy_units_around;
-					if(possible_flanked) {
-						is_flanked = true;
-					}
-				}
-			}
-		}
+		attacker_positions& attacker = cached->second;
 
-		if((is_flanked && enemy_units_around > 2) || enemy_units_around >= accessible_tiles - 1) {
-			is_surrounded = true;
+		if(attacker.slow && cur_analysis.movements.empty() == false) {
+			continue;
 		}
 
 		double best_vulnerability = 0.0, best_support = 0.0;
@@ -232,67 +184,33 @@ void aspect_attacks_base::do_attack_analysis(const map_location& loc,
 				continue;
 			}
 
-			// See if the current unit can reach that position.
-			if(tiles[j] != current_unit) {
-				auto its = dstsrc.equal_range(tiles[j]);
-				while(its.first != its.second) {
-					if(its.first->second == current_unit) {
-						break;
-					}
-
-					++its.first;
-				}
-
-				// If the unit can't move to this location.
-				if(its.first == its.second || units_.find(tiles[j]) != units_.end()) {
-					continue;
-				}
-			}
-
-			int best_leadership_bonus = under_leadership(*unit_itor, tiles[j]);
-			double leadership_bonus = static_cast<double>(best_leadership_bonus + 100) / 100.0;
-			if(leadership_bonus > 1.1) {
-				LOG_AI << unit_itor->name() << " is getting leadership " << leadership_bonus;
-			}
+			attack_position& position = attacker.tiles[j];
 
-			// Check to see whether this move would be a backstab.
-			int backstab_bonus = 1;
-			double surround_bonus = 1.0;
-
-			if(tiles[(j + 3) % 6] != current_unit) {
-				const unit_map::const_iterator itor = units_.find(tiles[(j + 3) % 6]);
-
-				// Note that we *could* also check if a unit plans to move there
-				// before we're at this stage, but we don't because, since the
-				// attack calculations don't actually take backstab into account (too complicated),
-				// this could actually make our analysis look *worse* instead of better.
-				// So we only check for 'concrete' backstab opportunities.
-				// That would also break backstab_check, since it assumes
-				// the defender is in place.
-				if(itor != units_.end() && backstab_check(tiles[j], loc, units_, teams_)) {
-					if(backstab) {
-						backstab_bonus = 2;
-					}
-
-					// No surround bonus if target is skirmisher
-					if(!itor->get_ability_bool("skirmisher")) {
-						surround_bonus = 1.2;
-					}
-				}
+			// If the unit can't move to this location.
+			if(!position.reachable) {
+				continue;
 			}
 
 			// See if this position is the best rated we've seen so far.
-			int rating = static_cast<int>(rate_terrain(*unit_itor, tiles[j]) * backstab_bonus * leadership_bonus);
+			const int rating = position.rating;
 			if(cur_position >= 0 && rating < best_rating) {
 				continue;
 			}
 
-			// Find out how vulnerable we are to attack from enemy units in this hex.
-			// FIXME: suokko's r29531 multiplied this by a constant 1.5. ?
-			const double vulnerability = power_projection(tiles[j], enemy_dstsrc); //?
+			if(!position.projected) {
+				// Find out how vulnerable we are to attack from enemy units in this hex.
+				// FIXME: suokko's r29531 multiplied this by a constant 1.5. ?
+				position.vulnerability = power_projection(tiles[j], enemy_dstsrc); //?
+
+				// Calculate how much support we have on this hex from allies.
+				position.support = power_projection(tiles[j], fullmove_dstsrc); //?
+
+				position.projected = true;
+			}
 
-			// Calculate how much support we have on this hex from allies.
-			const double support = power_projection(tiles[j], fullmove_dstsrc); //?
+			const double vulnerability = position.vulnerability;
+			const double support = position.support;
+			const double surround_bonus = position.surround_bonus;
 
 			// If this is a position with equal defense to another position,
 			// but more vulnerability then we don't want to use it.
@@ -313,14 +231,14 @@ void aspect_attacks_base::do_attack_analysis(const map_location& loc,
 			cur_analysis.movements.emplace_back(current_unit, tiles[cur_position]);
 			cur_analysis.vulnerability += best_vulnerability;
 			cur_analysis.support += best_support;
-			cur_analysis.is_surrounded = is_surrounded;
+			cur_analysis.is_surrounded = attacker.is_surrounded;
 			cur_analysis.analyze(map_, units_, *this, dstsrc, srcdst, enemy_dstsrc, get_aggression());
 			result.push_back(cur_analysis);
 
 			used_locations[cur_position] = true;
 
 			do_attack_analysis(loc, srcdst, dstsrc, fullmove_srcdst, fullmove_dstsrc, enemy_srcdst, enemy_dstsrc, tiles,
-				used_locations, units, result, cur_analysis, current_team);
+				used_locations, units, result, cur_analysis, current_team, positions);
 
 			used_locations[cur_position] = false;
 
@@ -333,6 +251,133 @@ void aspect_attacks_base::do_attack_analysis(const map_location& loc,
 	}
 }
 
+aspect_attacks_base::attacker_positions aspect_attacks_base::evaluate_attacker(const unit& u,
+	const map_location& target,
+	const move_map& dstsrc,
+	const std::array<map_location, 6>& tiles,
+	const team& current_team) const
+{
+	const gamemap& map_ = resources::gameboard->map();
+	const unit_map& units_ = resources::gameboard->units();
+	const std::vector<team>& teams_ = resources::gameboard->teams();
+	const map_location& current_unit = u.get_location();
+
+	attacker_positions res;
+
+	// See if the unit has the backstab ability.
+	// Units with backstab will want to try to have a
+	// friendly unit opposite the position they move to.
+	//
+	// See if the unit has the slow ability -- units with slow only attack first.
+	bool backstab = false;
+	for(const attack_type& a : u.attacks()) {
+		// For speed, just assume these specials will be active if they are present.
+		if(a.has_special("backstab", true)) {
+			backstab = true;
+		}
+
+		if(a.has_special("slow", true)) {
+			res.slow = true;
+		}
+	}
+
+	// Check if the friendly unit is surrounded,
+	// A unit is surrounded if it is flanked by enemy units
+	// and at least one other enemy unit is nearby
+	// or if the unit is totally surrounded by enemies
+	// with max. one tile to escape.
+	bool is_flanked = false;
+	int enemy_units_around = 0;
+	int accessible_tiles = 0;
+	const auto adj = get_adjacent_tiles(current_unit);
+
+	for(std::size_t tile = 0; tile != 3; ++tile) {
+		const unit_map::const_iterator tmp_unit = units_.find(adj[tile]);
+		bool possible_flanked = false;
+
+		if(map_.on_board(adj[tile])) {
+			++accessible_tiles;
+			if(tmp_unit != units_.end() && current_team.is_enemy(tmp_unit->side())) {
+				++enemy_units_around;
+				possible_flanked = true;
+			}
+		}
+
+		const unit_map::const_iterator tmp_opposite_unit = units_.find(adj[tile + 3]);
+		if(map_.on_board(adj[tile + 3])) {
+			++accessible_tiles;
+			if(tmp_opposite_unit != units_.end() && current_team.is_enemy(tmp_opposite_unit->side())) {
+				++enemy_units_around;
+				if(possible_flanked) {
+					is_flanked = true;
+				}
+			}
+		}
+	}
+
+	if((is_flanked && enemy_units_around > 2) || enemy_units_around >= accessible_tiles - 1) {
+		res.is_surrounded = true;
+	}
+
+	for(unsigned j = 0; j < tiles.size(); ++j) {
+		attack_position& position = res.tiles[j];
+
+		// See if the current unit can reach that position.
+		if(tiles[j] != current_unit) {
+			auto its = dstsrc.equal_range(tiles[j]);
+			while(its.first != its.second) {
+				if(its.first->second == current_unit) {
+					break;
+				}
+
+				++its.first;
+			}
+
+			// If the unit can't move to this location.
+			if(its.first == its.second || units_.find(tiles[j]) != units_.end()) {
+				continue;
+			}
+		}
+
+		position.reachable = true;
+
+		int best_leadership_bonus = under_leadership(u, tiles[j]);
+		double leadership_bonus = static_cast<double>(best_leadership_bonus + 100) / 100.0;
+		if(leadership_bonus > 1.1) {
+			LOG_AI << u.name() << " is getting leadership " << leadership_bonus;
+		}
+
+		// Check to see whether this move would be a backstab.
+		int backstab_bonus = 1;
+
+		if(tiles[(j + 3) % 6] != current_unit) {
+			const unit_map::const_iterator itor = units_.find(tiles[(j + 3) % 6]);
+
+			// Note that we *could* also check if a unit plans to move there
+			// before we're at this stage, but we don't because, since the
+			// attack calculations don't actually take backstab into account (too complicated),
+			// this could actually make our analysis look *worse* instead of better.
+			// So we only check for 'concrete' backstab opportunities.
+			// That would also break backstab_check, since it assumes
+			// the defender is in place.
+			if(itor != units_.end() && backstab_check(tiles[j], target, units_, teams_)) {
+				if(backstab) {
+					backstab_bonus = 2;
+				}
+
+				// No surround bonus if target is skirmisher
+				if(!itor->get_ability_bool("skirmisher")) {
+					position.surround_bonus = 1.2;
+				}
+			}
+		}
+
+		position.rating = static_cast<int>(rate_terrain(u, tiles[j]) * backstab_bonus * leadership_bonus);
+	}
+
+	return res;
+}
+
 int aspect_attacks_base::rate_terrain(const unit& u, const map_location& loc)
 {
 	const gamemap& map_ = resources::gameboard->map();
@@ -23,6 +23,9 @@
 #include "ai/composite/aspect.hpp"
 #include "units/filter.hpp"
 
+#include <array>
+#include <map>
+
 namespace ai {
 
 namespace ai_default_rca {
@@ -39,6 +42,33 @@ public:
 	virtual bool is_allowed_enemy(const unit& u) const = 0;
 
 protected:
+	/** How well one hex adjacent to the target suits one attacker. */
+	struct attack_position
+	{
+		bool reachable = false;
+		int rating = 0;
+		double surround_bonus = 1.0;
+
+		/** Whether vulnerability and support have been calculated yet. */
+		bool projected = false;
+		double vulnerability = 0.0;
+		double support = 0.0;
+	};
+
+	/**
+	 * What do_attack_analysis() knows about one attacker. None of this changes
+	 * while a single target is being analysed, so it is only worked out once
+	 * rather than at every level of the recursion.
+	 */
+	struct attacker_positions
+	{
+		bool slow = false;
+		bool is_surrounded = false;
+		std::array<attack_position, 6> tiles;
+	};
+
+	using attacker_positions_map = std::map<map_location, attacker_positions>;
+
 	std::shared_ptr<attacks_vector> analyze_targets() const;
 
 	void do_attack_analysis(const map_location& loc,
@@ -53,6 +83,14 @@ protected:
 		std::vector<map_location>& units,
 		std::vector<attack_analysis>& result,
 		attack_analysis& cur_analysis,
+		const team& current_team,
+		attacker_positions_map& positions) const;
+
+	/** Fills in the data do_attack_analysis() caches for one attacker. */
+	attacker_positions evaluate_attacker(const unit& u,
+		const map_location& target,
+		const move_map& dstsrc,
+		const std::array<map_location, 6>& tiles,
 		const team& current_team) const;
 
 	static int rate_terrain(const unit& u, const map_location& loc);
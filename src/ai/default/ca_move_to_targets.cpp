@@ -331,7 +331,7 @@ std::pair<map_location,map_location> move_to_targets_phase::choose_move(std::vec
 		// as it can cause the AI to give up on searches and just do nothing.
 		const double locStopValue = 500.0;
 		const pathfind::teleport_map allowed_teleports = pathfind::get_teleport_locations(*u, current_team());
-		pathfind::plain_route real_route = a_star_search(u->get_location(), tg.loc, locStopValue, cost_calc, map_.w(), map_.h(), &allowed_teleports);
+		pathfind::plain_route real_route = get_route_cache().search(u->underlying_id(), u->get_location(), tg.loc, locStopValue, cost_calc, map_.w(), map_.h(), &allowed_teleports);
 
 		if(real_route.steps.empty()) {
 			LOG_AI << "Can't reach target: " << locStopValue << " = " << tg.value << "/" << best_rating;
@@ -395,7 +395,7 @@ std::pair<map_location,map_location> move_to_targets_phase::choose_move(std::vec
 			// as it can cause the AI to give up on searches and just do nothing.
 			const double locStopValue = 500.0;
 			const pathfind::teleport_map allowed_teleports = pathfind::get_teleport_locations(*u, current_team());
-			pathfind::plain_route cur_route = pathfind::a_star_search(u->get_location(), best_target->loc, locStopValue, calc, map_.w(), map_.h(), &allowed_teleports);
+			pathfind::plain_route cur_route = get_route_cache().search(u->underlying_id(), u->get_location(), best_target->loc, locStopValue, calc, map_.w(), map_.h(), &allowed_teleports);
 
 			if(cur_route.steps.empty()) {
 				continue;
@@ -629,7 +629,7 @@ void move_to_targets_phase::access_points(const move_map& srcdst, const map_loca
 		if (static_cast<int>(distance_between(loc,dst)) <= u_it->total_movement()) {
 			pathfind::shortest_path_calculator calc(*u_it, current_team(), resources::gameboard->teams(), map_);
 			const pathfind::teleport_map allowed_teleports = pathfind::get_teleport_locations(*u_it, current_team());
-			pathfind::plain_route rt = a_star_search(loc, dst, u_it->total_movement(), calc, map_.w(), map_.h(), &allowed_teleports);
+			pathfind::plain_route rt = get_route_cache().search(u_it->underlying_id(), loc, dst, u_it->total_movement(), calc, map_.w(), map_.h(), &allowed_teleports);
 			if(rt.steps.empty() == false) {
 				out.push_back(loc);
 			}
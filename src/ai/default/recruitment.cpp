@@ -157,9 +157,17 @@ double recruitment::evaluate() {
 	// Then cheapest_unit_costs_ is not valid anymore.
 	if (recruit_situation_change_observer_.recruit_list_changed()) {
 		cheapest_unit_costs_.clear();
+		average_local_cost_.clear();
 		recruit_situation_change_observer_.set_recruit_list_changed(false);
 	}
 
+	// The terrain-dependent caches are kept across turns until the map changes.
+	if (recruit_situation_change_observer_.map_changed()) {
+		average_local_cost_.clear();
+		combat_cache_.clear();
+		recruit_situation_change_observer_.set_map_changed(false);
+	}
+
 	// When evaluate() is called the first time this turn,
 	// we'll retrieve the recruitment-instruction aspect.
 	if (resources::tod_manager->turn() != recruitment_instructions_turn_) {
@@ -774,7 +782,12 @@ void recruitment::update_average_lawful_bonus() {
 		++counter;
 	}
 	if (counter > 0) {
-		average_lawful_bonus_ = std::round(static_cast<double>(sum) / counter);
+		const int average_lawful_bonus = std::round(static_cast<double>(sum) / counter);
+		if (average_lawful_bonus != average_lawful_bonus_) {
+			// The cached combat values were simulated with the old bonus.
+			combat_cache_.clear();
+			average_lawful_bonus_ = average_lawful_bonus;
+		}
 	}
 }
 
@@ -817,7 +830,9 @@ void recruitment::update_important_hexes() {
 	important_terrain_.clear();
 	own_units_in_combat_counter_ = 0;
 
-	update_average_local_cost();
+	if (average_local_cost_.empty()) {
+		update_average_local_cost();
+	}
 	const gamemap& map = resources::gameboard->map();
 	const unit_map& units = resources::gameboard->units();
 
@@ -933,11 +948,11 @@ double recruitment::compare_unit_types(const std::string& a, const std::string&
 		double value_of_b = damage_to_a / (a_max_hp * b_cost);
 
 		if (value_of_a > value_of_b) {
-			return value_of_a / value_of_b;
+			retval = value_of_a / value_of_b;
 		} else if (value_of_a < value_of_b) {
-			return -value_of_b / value_of_a;
+			retval = -value_of_b / value_of_a;
 		} else {
-			return 0.;
+			retval = 0.;
 		}
 	}
 
@@ -1778,8 +1793,9 @@ void recruitment::update_scouts_wanted() {
  * Observer Code
  */
 recruitment::recruit_situation_change_observer::recruit_situation_change_observer()
-	: recruit_list_changed_(false), gamestate_changed_(0) {
+	: recruit_list_changed_(false), map_changed_(false), gamestate_changed_(0) {
 	manager::get_singleton().add_recruit_list_changed_observer(this);
+	manager::get_singleton().add_map_changed_observer(this);
 	manager::get_singleton().add_gamestate_observer(this);
 }
 
@@ -1788,6 +1804,9 @@ void recruitment::recruit_situation_change_observer::handle_generic_event(
 	if (event == "ai_recruit_list_changed") {
 		LOG_AI_RECRUITMENT << "Recruitment List is not valid anymore.";
 		set_recruit_list_changed(true);
+	} else if (event == "ai_map_changed") {
+		LOG_AI_RECRUITMENT << "Map analysis is not valid anymore.";
+		set_map_changed(true);
 	} else {
 		++gamestate_changed_;
 	}
@@ -1795,6 +1814,7 @@ void recruitment::recruit_situation_change_observer::handle_generic_event(
 
 recruitment::recruit_situation_change_observer::~recruit_situation_change_observer() {
 	manager::get_singleton().remove_recruit_list_changed_observer(this);
+	manager::get_singleton().remove_map_changed_observer(this);
 	manager::get_singleton().remove_gamestate_observer(this);
 }
 
@@ -1806,6 +1826,14 @@ void recruitment::recruit_situation_change_observer::set_recruit_list_changed(bo
 	recruit_list_changed_ = changed;
 }
 
+bool recruitment::recruit_situation_change_observer::map_changed() {
+	return map_changed_;
+}
+
+void recruitment::recruit_situation_change_observer::set_map_changed(bool changed) {
+	map_changed_ = changed;
+}
+
 int recruitment::recruit_situation_change_observer::gamestate_changed() {
 	return gamestate_changed_;
 }
@@ -243,11 +243,14 @@ private:
 
 		bool recruit_list_changed();
 		void set_recruit_list_changed(bool changed);
+		bool map_changed();
+		void set_map_changed(bool changed);
 		int gamestate_changed();
 		void reset_gamestate_changed();
 
 	private:
 		bool recruit_list_changed_;
+		bool map_changed_;
 		int gamestate_changed_;
 
 	};
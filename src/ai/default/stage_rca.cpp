@@ -26,9 +26,13 @@
 #include "ai/composite/property_handler.hpp"
 #include "ai/composite/rca.hpp"
 #include "ai/gamestate_observer.hpp"
+#include "ai/testing.hpp"
 #include "log.hpp"
+#include "utils/perf_counter.hpp"
 
+#include <chrono>
 #include <functional>
+#include <map>
 
 namespace ai {
 
@@ -43,6 +47,7 @@ candidate_action_evaluation_loop::candidate_action_evaluation_loop( ai_context &
 	: stage(context,cfg)
 	, candidate_actions_()
 	, cfg_(cfg)
+	, time_budget_(cfg["time_budget"].to_int(0))
 {
 }
 
@@ -64,6 +69,9 @@ void candidate_action_evaluation_loop::on_create()
 config candidate_action_evaluation_loop::to_config() const
 {
 	config cfg = stage::to_config();
+	if (time_budget_ > 0) {
+		cfg["time_budget"] = time_budget_;
+	}
 	for (candidate_action_ptr ca : candidate_actions_) {
 		cfg.add_child("candidate_action",ca->to_config());
 	}
@@ -90,8 +98,22 @@ bool candidate_action_evaluation_loop::do_play_stage()
 	//sort candidate actions by max_score DESC
 	std::sort(candidate_actions_.begin(),candidate_actions_.end(),desc_sorter_of_candidate_actions());
 
+	using clock = std::chrono::steady_clock;
+	const clock::time_point start_time = clock::now();
+	const auto budget_exhausted = [this, start_time]() {
+		return time_budget_ > 0 && clock::now() - start_time >= std::chrono::milliseconds(time_budget_);
+	};
+
+	// Time spent in each candidate action, reported when the loop ends.
+	std::map<std::string, clock::duration> evaluation_times;
+	std::map<std::string, clock::duration> execution_times;
+	// Totals over all turns, for the :perf command.
+	static util::perf_counter evaluation_counter("ai::candidate_action::evaluate");
+	static util::perf_counter execution_counter("ai::candidate_action::execute");
+
 	bool executed = false;
 	bool gamestate_changed = false;
+	bool out_of_time = false;
 	do {
 		executed = false;
 		double best_score = candidate_action::BAD_SCORE;
@@ -109,8 +131,19 @@ bool candidate_action_evaluation_loop::do_play_stage()
 				break;
 			}
 
+			if (budget_exhausted()) {
+				// Go with the best candidate action found so far.
+				LOG_AI_TESTING_RCA_DEFAULT << "Time budget of " << time_budget_ << " ms used up, not evaluating the remaining candidate actions";
+				out_of_time = true;
+				break;
+			}
+
 			DBG_AI_TESTING_RCA_DEFAULT << "Evaluating candidate action: "<< *ca_ptr;
+			const clock::time_point evaluation_start = clock::now();
 			double score = ca_ptr->evaluate();
+			const clock::duration evaluation_time = clock::now() - evaluation_start;
+			evaluation_times[ca_ptr->get_name()] += evaluation_time;
+			evaluation_counter.add(evaluation_time);
 			DBG_AI_TESTING_RCA_DEFAULT << "Evaluated candidate action to score "<< score << " : " << *ca_ptr;
 
 			if (score>best_score) {
@@ -123,7 +156,11 @@ bool candidate_action_evaluation_loop::do_play_stage()
 		if (best_score>candidate_action::BAD_SCORE) {
 			DBG_AI_TESTING_RCA_DEFAULT << "Executing best candidate action: "<< *best_ptr;
 			gamestate_observer gs_o;
+			const clock::time_point execution_start = clock::now();
 			best_ptr->execute();
+			const clock::duration execution_time = clock::now() - execution_start;
+			execution_times[best_ptr->get_name()] += execution_time;
+			execution_counter.add(execution_time);
 			executed = true;
 			if (!gs_o.is_gamestate_changed()) {
 				//this means that this CA has lied to us in evaluate()
@@ -137,7 +174,20 @@ bool candidate_action_evaluation_loop::do_play_stage()
 		} else {
 			LOG_AI_TESTING_RCA_DEFAULT << "Ending candidate action evaluation loop due to best score "<< best_score<<"<="<< candidate_action::BAD_SCORE;
 		}
-	} while (executed);
+
+		if (!out_of_time && budget_exhausted()) {
+			LOG_AI_TESTING_RCA_DEFAULT << "Time budget of " << time_budget_ << " ms used up";
+			out_of_time = true;
+		}
+	} while (executed && !out_of_time);
+
+	for (const auto& [name, time] : evaluation_times) {
+		const clock::duration execution_time = execution_times[name];
+		LOG_AI_TESTING_RCA_DEFAULT << "Candidate action " << name << " took "
+			<< std::chrono::duration_cast<std::chrono::milliseconds>(time).count() << " ms to evaluate and "
+			<< std::chrono::duration_cast<std::chrono::milliseconds>(execution_time).count() << " ms to execute";
+		ai_testing::add_candidate_action_time(get_side(), name, time + execution_time);
+	}
 	LOG_AI_TESTING_RCA_DEFAULT << "Ended candidate action evaluation loop for side "<< get_side();
 	remove_completed_cas();
 	return gamestate_changed;
@@ -47,6 +47,13 @@ private:
 	std::vector<candidate_action_ptr> candidate_actions_;
 
 	const config &cfg_;
+
+	/**
+	 * Wall-clock time in milliseconds one play of this stage may take, 0 for no limit.
+	 * When it runs out, the best candidate action evaluated so far is executed
+	 * and the loop ends.
+	 */
+	int time_budget_;
 };
 
 } // of namespace testing_ai_default
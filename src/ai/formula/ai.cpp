@@ -105,6 +105,8 @@ formula_ai::formula_ai(readonly_context &context, const config &cfg)
 	cfg_(cfg),
 	recursion_counter_(context.get_recursion_count()),
 	keeps_cache_(),
+	gamestate_cache_(),
+	gamestate_observer_(),
 	attacks_callable(*this, resources::gameboard->units()),
 //	infinite_loop_guardian_(),
 	vars_(),
@@ -298,6 +300,32 @@ variant visit_helper(const utils::variant<bool, std::vector<std::string>>& input
 } // namespace
 
 variant formula_ai::get_value(const std::string& key) const
+{
+	static const std::set<std::string> gamestate_keys {
+		"units", "units_of_side", "my_units", "enemy_units", "my_leader", "recall_list",
+		"map", "villages", "villages_of_side", "my_villages", "enemy_and_unowned_villages"
+	};
+
+	if(gamestate_keys.count(key) == 0) {
+		return make_value(key);
+	}
+
+	if(gamestate_observer_.is_gamestate_changed()) {
+		gamestate_cache_.clear();
+		gamestate_observer_.reset();
+	}
+
+	const auto cached = gamestate_cache_.find(key);
+	if(cached != gamestate_cache_.end()) {
+		return cached->second;
+	}
+
+	variant res = make_value(key);
+	gamestate_cache_.emplace(key, res);
+	return res;
+}
+
+variant formula_ai::make_value(const std::string& key) const
 {
 	const unit_map& units = resources::gameboard->units();
 
@@ -426,8 +454,6 @@ variant formula_ai::get_value(const std::string& key) const
 	{
 		std::vector<variant> vars;
 
-		unit_types.build_all(unit_type::FULL);
-
 		const std::set<std::string>& recruits = current_team().recruits();
 		if(recruits.empty()) {
 			return variant(vars);
@@ -447,8 +473,6 @@ variant formula_ai::get_value(const std::string& key) const
 		std::vector<variant> vars;
 		std::vector< std::vector< variant>> tmp;
 
-		unit_types.build_all(unit_type::FULL);
-
 		for( std::size_t i = 0; i<resources::gameboard->teams().size(); ++i)
 		{
 			std::vector<variant> v;
@@ -24,12 +24,14 @@
 #include "ai/formula/function_table.hpp"           // for ai_function_symbol_table
 #include "ai/formula/callable_objects.hpp"         // for position_callable, etc
 #include "ai/formula/candidates.hpp"               // for candidate_action_ptr, etc
+#include "ai/gamestate_observer.hpp"    // for gamestate_observer
 #include "config.hpp"                   // for config
 #include "formula/callable.hpp"         // for formula_callable, etc
 #include "formula/formula_fwd.hpp"              // for const_formula_ptr, etc
 #include "generic_event.hpp"  // for observer
 #include "pathfind/teleport.hpp"  // for teleport_map
 #include "units/map.hpp"
+#include <map>                          // for map
 #include <set>                          // for multiset
 #include <string>                       // for string
 #include <utility>                      // for pair
@@ -155,10 +157,18 @@ private:
 	recursion_counter recursion_counter_;
 	void display_message(const std::string& msg) const;
 	virtual wfl::variant get_value(const std::string& key) const override;
+	wfl::variant make_value(const std::string& key) const;
 	void set_value(const std::string& key, const wfl::variant& value) override;
 	virtual void get_inputs(wfl::formula_input_vector& inputs) const override;
 
 	mutable wfl::variant keeps_cache_;
+
+	/**
+	 * The unit and village lists and the map, wrapped in callables once and kept until
+	 * the game state changes rather than on every access.
+	 */
+	mutable std::map<std::string, wfl::variant> gamestate_cache_;
+	mutable gamestate_observer gamestate_observer_;
 	wfl::attack_map_callable attacks_callable;
 
 //	gamestate_change_observer infinite_loop_guardian_;
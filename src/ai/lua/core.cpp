@@ -319,7 +319,7 @@ static int cfun_ai_fallback_human(lua_State*)
 
 static int cfun_ai_get_targets(lua_State *L)
 {
-	move_map enemy_dst_src = get_readonly_context(L).get_enemy_dstsrc();
+	const move_map& enemy_dst_src = get_readonly_context(L).get_enemy_dstsrc();
 	std::vector<target> targets = get_engine(L).get_ai_context()->find_targets(enemy_dst_src);
 	int i = 1;
 
@@ -675,7 +675,7 @@ static void push_move_map(lua_State *L, const move_map& m)
 
 static int cfun_ai_get_dstsrc(lua_State *L)
 {
-	move_map dst_src = get_readonly_context(L).get_dstsrc();
+	const move_map& dst_src = get_readonly_context(L).get_dstsrc();
 	get_readonly_context(L).set_dst_src_valid_lua();
 	push_move_map(L, dst_src);
 	return 1;
@@ -683,7 +683,7 @@ static int cfun_ai_get_dstsrc(lua_State *L)
 
 static int cfun_ai_get_srcdst(lua_State *L)
 {
-	move_map src_dst = get_readonly_context(L).get_srcdst();
+	const move_map& src_dst = get_readonly_context(L).get_srcdst();
 	get_readonly_context(L).set_src_dst_valid_lua();
 	push_move_map(L, src_dst);
 	return 1;
@@ -691,7 +691,7 @@ static int cfun_ai_get_srcdst(lua_State *L)
 
 static int cfun_ai_get_enemy_dstsrc(lua_State *L)
 {
-	move_map enemy_dst_src = get_readonly_context(L).get_enemy_dstsrc();
+	const move_map& enemy_dst_src = get_readonly_context(L).get_enemy_dstsrc();
 	get_readonly_context(L).set_dst_src_enemy_valid_lua();
 	push_move_map(L, enemy_dst_src);
 	return 1;
@@ -699,12 +699,107 @@ static int cfun_ai_get_enemy_dstsrc(lua_State *L)
 
 static int cfun_ai_get_enemy_srcdst(lua_State *L)
 {
-	move_map enemy_src_dst = get_readonly_context(L).get_enemy_srcdst();
+	const move_map& enemy_src_dst = get_readonly_context(L).get_enemy_srcdst();
 	get_readonly_context(L).set_src_dst_enemy_valid_lua();
 	push_move_map(L, enemy_src_dst);
 	return 1;
 }
 
+enum class move_map_kind { dst_src, src_dst, enemy_dst_src, enemy_src_dst };
+
+static const move_map& get_move_map(ai::readonly_context& context, move_map_kind kind)
+{
+	switch(kind) {
+	case move_map_kind::src_dst:
+		return context.get_srcdst();
+	case move_map_kind::enemy_dst_src:
+		return context.get_enemy_dstsrc();
+	case move_map_kind::enemy_src_dst:
+		return context.get_enemy_srcdst();
+	default:
+		return context.get_dstsrc();
+	}
+}
+
+/**
+ * Looks up a single location of a move map view.
+ * The map is read from the context on every access, so the view never goes
+ * stale and only the requested entries are converted to Lua values.
+ */
+static int impl_ai_move_map_view_get(lua_State* L)
+{
+	map_location loc;
+	if(!luaW_tolocation(L, 2, loc)) {
+		return 0;
+	}
+
+	const auto kind = static_cast<move_map_kind>(lua_tointeger(L, lua_upvalueindex(2)));
+	const move_map& m = get_move_map(get_readonly_context(L), kind);
+	const auto range = m.equal_range(loc);
+	if(range.first == range.second) {
+		return 0;
+	}
+
+	lua_createtable(L, std::distance(range.first, range.second), 0);
+	int index = 1;
+	for(auto it = range.first; it != range.second; ++it, ++index) {
+		luaW_pushlocation(L, it->second);
+		lua_rawseti(L, -2, index);
+	}
+	return 1;
+}
+
+static int impl_ai_move_map_view_len(lua_State* L)
+{
+	const auto kind = static_cast<move_map_kind>(lua_tointeger(L, lua_upvalueindex(2)));
+	lua_pushinteger(L, get_move_map(get_readonly_context(L), kind).size());
+	return 1;
+}
+
+static int impl_ai_move_map_view_set(lua_State* L)
+{
+	lua_pushstring(L, "attempted to write to a move map view, which is read-only");
+	return lua_error(L);
+}
+
+static int push_move_map_view(lua_State* L, move_map_kind kind)
+{
+	lua_newtable(L); // [-1: view]
+	lua_newtable(L); // [-1: metatable  -2: view]
+	lua_pushvalue(L, lua_upvalueindex(1)); // [-1: engine  -2: metatable  -3: view]
+	lua_pushinteger(L, static_cast<int>(kind)); // [-1: kind  -2: engine  -3: metatable  -4: view]
+	lua_pushcclosure(L, &impl_ai_move_map_view_get, 2); // [-1: metafunction  -2: metatable  -3: view]
+	lua_setfield(L, -2, "__index"); // [-1: metatable  -2: view]
+	lua_pushvalue(L, lua_upvalueindex(1));
+	lua_pushinteger(L, static_cast<int>(kind));
+	lua_pushcclosure(L, &impl_ai_move_map_view_len, 2);
+	lua_setfield(L, -2, "__len");
+	lua_pushcfunction(L, &impl_ai_move_map_view_set);
+	lua_setfield(L, -2, "__newindex");
+	lua_setmetatable(L, -2); // [-1: view]
+	return 1;
+}
+
+static int cfun_ai_get_dstsrc_view(lua_State *L)
+{
+	return push_move_map_view(L, move_map_kind::dst_src);
+}
+
+static int cfun_ai_get_srcdst_view(lua_State *L)
+{
+	return push_move_map_view(L, move_map_kind::src_dst);
+}
+
+static int cfun_ai_get_enemy_dstsrc_view(lua_State *L)
+{
+	return push_move_map_view(L, move_map_kind::enemy_dst_src);
+}
+
+static int cfun_ai_get_enemy_srcdst_view(lua_State *L)
+{
+	return push_move_map_view(L, move_map_kind::enemy_src_dst);
+}
+
 static int cfun_ai_is_dst_src_valid(lua_State *L)
 {
 	bool valid = get_readonly_context(L).is_dst_src_valid_lua();
@@ -733,6 +828,22 @@ static int cfun_ai_is_src_dst_enemy_valid(lua_State *L)
 	return 1;
 }
 
+static int cfun_ai_get_support(lua_State *L)
+{
+	map_location loc = luaW_checklocation(L, 1);
+	ai::readonly_context& context = get_readonly_context(L);
+	lua_pushnumber(L, context.power_projection(loc, context.get_dstsrc()));
+	return 1;
+}
+
+static int cfun_ai_get_threat(lua_State *L)
+{
+	map_location loc = luaW_checklocation(L, 1);
+	ai::readonly_context& context = get_readonly_context(L);
+	lua_pushnumber(L, context.power_projection(loc, context.get_enemy_dstsrc()));
+	return 1;
+}
+
 static int cfun_ai_recalculate_move_maps(lua_State *L)
 {
 	get_readonly_context(L).recalculate_move_maps();
@@ -906,6 +1017,10 @@ static void generate_and_push_ai_table(lua_State* L, ai::engine_lua* engine) {
 		{ "get_new_src_dst", &cfun_ai_get_srcdst },
 		{ "get_new_enemy_dst_src", &cfun_ai_get_enemy_dstsrc },
 		{ "get_new_enemy_src_dst", &cfun_ai_get_enemy_srcdst },
+		{ "get_dst_src_view", &cfun_ai_get_dstsrc_view },
+		{ "get_src_dst_view", &cfun_ai_get_srcdst_view },
+		{ "get_enemy_dst_src_view", &cfun_ai_get_enemy_dstsrc_view },
+		{ "get_enemy_src_dst_view", &cfun_ai_get_enemy_srcdst_view },
 		{ "recalculate_move_maps", &cfun_ai_recalculate_move_maps },
 		{ "recalculate_enemy_move_maps", &cfun_ai_recalculate_move_maps_enemy },
 		// Validation/cache functions
@@ -913,6 +1028,9 @@ static void generate_and_push_ai_table(lua_State* L, ai::engine_lua* engine) {
 		{ "is_enemy_dst_src_valid", &cfun_ai_is_dst_src_enemy_valid },
 		{ "is_src_dst_valid", &cfun_ai_is_src_dst_valid },
 		{ "is_enemy_src_dst_valid", &cfun_ai_is_src_dst_enemy_valid },
+		// Power projection of the move maps above
+		{ "get_support", &cfun_ai_get_support },
+		{ "get_threat", &cfun_ai_get_threat },
 		// End of move maps
 		// Goals and targets
 		{ "get_targets", &cfun_ai_get_targets },
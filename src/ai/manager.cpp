@@ -24,6 +24,7 @@
 #include "game_events/pump.hpp"
 #include "log.hpp"
 #include "map/location.hpp"       // for map_location
+#include "pathfind/teleport.hpp"   // for manager
 #include "resources.hpp"
 #include "serialization/string_utils.hpp"
 #include "tod_manager.hpp"
@@ -441,14 +442,17 @@ void manager::raise_sync_network() {
 }
 
 void manager::raise_gamestate_changed() {
+	clear_teleport_cache();
 	gamestate_changed_.notify_observers();
 }
 
 void manager::raise_tod_changed() {
+	clear_teleport_cache();
 	tod_changed_.notify_observers();
 }
 
 void manager::raise_turn_started() {
+	clear_teleport_cache();
 	turn_started_.notify_observers();
 }
 
@@ -456,7 +460,16 @@ void manager::raise_recruit_list_changed() {
 	recruit_list_changed_.notify_observers();
 }
 
+void manager::clear_teleport_cache() {
+	// The teleport pairs are computed by filters which can depend on about
+	// anything, so all cached ones go whenever the game state changes.
+	if(resources::tunnels) {
+		resources::tunnels->clear_cache();
+	}
+}
+
 void manager::raise_map_changed() {
+	clear_teleport_cache();
 	map_changed_.notify_observers();
 }
 
@@ -735,7 +748,10 @@ void manager::play_turn( side_number side ){
 		raise_tod_changed();
 	}
 	ai_obj.new_turn();
-	ai_obj.play_turn();
+	{
+		const pathfind::manager::cache_scope teleport_cache(*resources::tunnels);
+		ai_obj.play_turn();
+	}
 	const int turn_end_time= SDL_GetTicks();
 	DBG_AI_MANAGER << "side " << side << ": number of user interactions: "<<num_interact_;
 	DBG_AI_MANAGER << "side " << side << ": total turn time: "<<turn_end_time - turn_start_time << " ms ";
@@ -441,6 +441,9 @@ private:
 
 	static manager* singleton_;
 
+	/** Forgets the teleport pairs cached during the AI turn, see play_turn(). */
+	void clear_teleport_cache();
+
 	// =======================================================================
 	// EVALUATION
 	// =======================================================================
@@ -19,20 +19,38 @@
  */
 #include "ai/manager.hpp"
 #include "ai/testing.hpp"
+#include "config.hpp"
 #include "log.hpp"
 #include "game_board.hpp"
 #include "replay.hpp"
 #include "resources.hpp"
+#include "serialization/string_utils.hpp"
 #include "team.hpp"
 #include "units/unit.hpp"
 #include "tod_manager.hpp"
 #include "game_version.hpp"
 
+#include <map>
+
 static lg::log_domain log_ai_testing("ai/testing");
 #define DBG_AI_TESTING LOG_STREAM(debug, log_ai_testing)
 #define LOG_AI_TESTING LOG_STREAM(info, log_ai_testing)
 #define ERR_AI_TESTING LOG_STREAM(err, log_ai_testing)
 
+namespace
+{
+/** What game_results() reports, filled in alongside the replay's ai_log. */
+config results;
+std::map<unsigned int, std::chrono::steady_clock::duration> ai_times;
+std::map<unsigned int, std::map<std::string, std::chrono::steady_clock::duration>> candidate_action_times;
+std::chrono::steady_clock::duration event_time{0};
+
+double to_seconds(std::chrono::steady_clock::duration time)
+{
+	return std::chrono::duration<double>(time).count();
+}
+}
+
 void ai_testing::log_turn_start(unsigned int side)
 {
 	log_turn("TURN_START",side);
@@ -77,15 +95,20 @@ void ai_testing::log_draw()
 {
 	LOG_AI_TESTING << "DRAW:";
 	resources::recorder->add_log_data("ai_log","result","draw");
+	results["result"] = "draw";
 }
 
 void ai_testing::log_victory(std::set<unsigned int> winners)
 {
 	resources::recorder->add_log_data("ai_log","result","victory");
+	results["result"] = "victory";
+	std::vector<std::string> winner_list;
 	for(std::set<unsigned int>::const_iterator w = winners.begin(); w != winners.end(); ++w) {
 		LOG_AI_TESTING << "WINNER: "<< *w;
 		resources::recorder->add_log_data("ai_log","winner",std::to_string(*w));
+		winner_list.push_back(std::to_string(*w));
 	}
+	results["winners"] = utils::join(winner_list);
 }
 
 void ai_testing::log_game_start()
@@ -95,6 +118,7 @@ void ai_testing::log_game_start()
 		LOG_AI_TESTING << "AI_IDENTIFIER " << side << ": " << ai::manager::get_singleton().get_active_ai_identifier_for_side(side);
 		LOG_AI_TESTING << "TEAM " << side << ": " << tm->side();
 		resources::recorder->add_log_data("ai_log", "ai_id" + std::to_string(side), ai::manager::get_singleton().get_active_ai_identifier_for_side(side));
+		results["ai_id" + std::to_string(side)] = ai::manager::get_singleton().get_active_ai_identifier_for_side(side);
 	}
 	LOG_AI_TESTING << "VERSION: " << game_config::revision;
 	resources::recorder->add_log_data("ai_log","version",game_config::revision);
@@ -109,5 +133,51 @@ void ai_testing::log_game_end()
 		int side = tm-resources::gameboard->teams().begin()+1;
 		resources::recorder->add_log_data("ai_log","end_gold"+std::to_string(side),std::to_string(tm->gold()));
 		resources::recorder->add_log_data("ai_log","end_units"+std::to_string(side),std::to_string(resources::gameboard->side_units(side)));
+		results["end_gold" + std::to_string(side)] = tm->gold();
+		results["end_units" + std::to_string(side)] = resources::gameboard->side_units(side);
+	}
+	results["end_turn"] = resources::tod_manager->turn();
+}
+
+void ai_testing::add_ai_time(unsigned int side, std::chrono::steady_clock::duration time)
+{
+	ai_times[side] += time;
+}
+
+void ai_testing::add_candidate_action_time(unsigned int side, const std::string& name, std::chrono::steady_clock::duration time)
+{
+	candidate_action_times[side][name] += time;
+}
+
+void ai_testing::add_event_time(std::chrono::steady_clock::duration time)
+{
+	event_time += time;
+}
+
+void ai_testing::reset_game_results()
+{
+	results.clear();
+	ai_times.clear();
+	candidate_action_times.clear();
+	event_time = std::chrono::steady_clock::duration{0};
+}
+
+config ai_testing::game_results()
+{
+	config res = results;
+	res["event_time"] = to_seconds(event_time);
+	for(const auto& [side, time] : ai_times) {
+		config& side_cfg = res.add_child("side", config {
+			"side", side,
+			"ai_time", to_seconds(time),
+		});
+
+		for(const auto& [name, ca_time] : candidate_action_times[side]) {
+			side_cfg.add_child("candidate_action", config {
+				"name", name,
+				"time", to_seconds(ca_time),
+			});
+		}
 	}
+	return res;
 }
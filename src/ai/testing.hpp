@@ -20,8 +20,13 @@
 
 #pragma once
 
+#include <chrono>
+#include <set>
+#include <string>
 #include <vector>
 
+class config;
+
 class ai_testing{
 public:
 	/*
@@ -55,6 +60,31 @@ public:
 	 */
 	static void log_game_end();
 
+	/*
+	 * Add time spent by the AI of that side on its turn
+	 */
+	static void add_ai_time( unsigned int side, std::chrono::steady_clock::duration time );
+
+	/*
+	 * Add time spent evaluating and executing a candidate action of that side
+	 */
+	static void add_candidate_action_time( unsigned int side, const std::string& name, std::chrono::steady_clock::duration time );
+
+	/*
+	 * Add time spent processing WML events
+	 */
+	static void add_event_time( std::chrono::steady_clock::duration time );
+
+	/*
+	 * Forget the results and timings of the previous game
+	 */
+	static void reset_game_results();
+
+	/*
+	 * Results and timings collected since the last reset_game_results()
+	 */
+	static config game_results();
+
 protected:
 
 	static void log_turn( const char *msg, unsigned int side );
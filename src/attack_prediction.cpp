@@ -37,13 +37,21 @@
 #include "random.hpp"
 #include "serialization/string_utils.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cfloat>
+#include <cstdint>
 #include <cmath>
+#include <list>
+#include <map>
 #include <memory>
 #include <numeric>
 #include <sstream>
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 #if defined(BENCHMARK) || defined(CHECK)
 #include <chrono>
 #include <cstdio>
@@ -221,6 +229,144 @@ std::vector<combat_slice> split_summary(
 	return result;
 }
 
+/** Returns the index of the lowest set bit of @a x, which must not be 0. */
+inline unsigned lowest_bit(uint64_t x)
+{
+#if defined(__GNUC__)
+	return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanForward64(&index, x);
+	return index;
+#else
+	unsigned index = 0;
+	for(; (x & 1) == 0; x >>= 1) {
+		++index;
+	}
+	return index;
+#endif
+}
+
+/**
+ * The rows or columns of a prob_matrix plane holding data.
+ *
+ * These get added to on almost every transfer, so they are kept as a bitmap
+ * rather than a tree. Iteration is in increasing order, and indices added
+ * during an iteration are visited if they come after the current one, just
+ * as with std::set.
+ */
+class index_set
+{
+public:
+	class const_iterator
+	{
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef unsigned value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const unsigned* pointer;
+		typedef const unsigned& reference;
+
+		const_iterator()
+			: words_(nullptr)
+			, pos_(0)
+		{
+		}
+
+		const_iterator(const std::vector<uint64_t>& words, unsigned pos)
+			: words_(&words)
+			, pos_(pos)
+		{
+			seek();
+		}
+
+		reference operator*() const
+		{
+			return pos_;
+		}
+
+		const_iterator& operator++()
+		{
+			++pos_;
+			seek();
+			return *this;
+		}
+
+		const_iterator operator++(int)
+		{
+			const_iterator res = *this;
+			++*this;
+			return res;
+		}
+
+		bool operator==(const const_iterator& o) const
+		{
+			return pos_ == o.pos_;
+		}
+
+		bool operator!=(const const_iterator& o) const
+		{
+			return pos_ != o.pos_;
+		}
+
+	private:
+		/** Moves to the first index in the set at or after pos_. */
+		void seek()
+		{
+			const unsigned end = words_->size() * 64;
+			while(pos_ < end) {
+				const uint64_t word = (*words_)[pos_ / 64] >> (pos_ % 64);
+				if(word != 0) {
+					pos_ += lowest_bit(word);
+					return;
+				}
+
+				pos_ = (pos_ / 64 + 1) * 64;
+			}
+
+			pos_ = end;
+		}
+
+		const std::vector<uint64_t>* words_;
+		unsigned pos_;
+	};
+
+	typedef const_iterator iterator;
+
+	explicit index_set(unsigned size = 0)
+		: words_((size + 63) / 64, 0)
+	{
+	}
+
+	void insert(unsigned i)
+	{
+		words_[i / 64] |= uint64_t(1) << (i % 64);
+	}
+
+	void clear()
+	{
+		std::fill(words_.begin(), words_.end(), 0);
+	}
+
+	bool empty() const
+	{
+		return std::all_of(words_.begin(), words_.end(), [](uint64_t word) { return word == 0; });
+	}
+
+	const_iterator begin() const
+	{
+		return const_iterator(words_, 0);
+	}
+
+	const_iterator end() const
+	{
+		return const_iterator(words_, words_.size() * 64);
+	}
+
+private:
+	std::vector<uint64_t> words_;
+};
+
 /**
  * A matrix of A's hitpoints vs B's hitpoints vs. their slowed states.
  * This class is concerned only with the matrix implementation and
@@ -362,7 +508,7 @@ private: // data
 
 	// For optimization, we keep track of the rows and columns with data.
 	// (The matrices are likely going to be rather sparse, with data on a grid.)
-	std::array<std::set<unsigned>, NUM_PLANES> used_rows_, used_cols_;
+	std::array<index_set, NUM_PLANES> used_rows_, used_cols_;
 };
 
 /**
@@ -398,6 +544,8 @@ prob_matrix::prob_matrix(unsigned int a_max,
 
 	// It will be convenient to always consider row/col 0 to be used.
 	for(unsigned plane = 0; plane != NUM_PLANES; ++plane) {
+		used_rows_[plane] = index_set(rows_);
+		used_cols_[plane] = index_set(cols_);
 		used_rows_[plane].insert(0u);
 		used_cols_[plane].insert(0u);
 	}
@@ -1412,7 +1560,16 @@ public:
 	double get_b_hit_probability() const;
 
 private:
-	static const unsigned int NUM_ITERATIONS = 5000u;
+	/**
+	 * The simulation runs in batches of BATCH_ITERATIONS fights until the standard error of
+	 * both kill chances is below MAX_STANDARD_ERROR, or MAX_ITERATIONS fights were simulated.
+	 * Lopsided fights, whose kill chances are close to 0 or 1, stop early; an even fight takes
+	 * all of the iterations.
+	 */
+	static const unsigned int BATCH_ITERATIONS = 500u;
+	static const unsigned int MIN_ITERATIONS = 1000u;
+	static const unsigned int MAX_ITERATIONS = 5000u;
+	static constexpr double MAX_STANDARD_ERROR = 0.007;
 
 	std::vector<double> a_initial_;
 	std::vector<double> b_initial_;
@@ -1425,8 +1582,14 @@ private:
 	double b_hit_chance_;
 	double a_initially_slowed_chance_;
 	double b_initially_slowed_chance_;
+	unsigned int iterations_ = 0u;
 	unsigned int iterations_a_hit_ = 0u;
 	unsigned int iterations_b_hit_ = 0u;
+	unsigned int iterations_a_killed_ = 0u;
+	unsigned int iterations_b_killed_ = 0u;
+
+	/** Whether the kill chances are known precisely enough to stop simulating. */
+	bool converged() const;
 
 	unsigned int calc_blows_a(unsigned int a_hp) const;
 	unsigned int calc_blows_b(unsigned int b_hp) const;
@@ -1494,69 +1657,87 @@ void monte_carlo_combat_matrix::simulate()
 {
 	randomness::rng& rng = randomness::rng::default_instance();
 
-	for(unsigned int i = 0u; i < NUM_ITERATIONS; ++i) {
-		bool a_hit = false;
-		bool b_hit = false;
-		bool a_slowed = rng.get_random_bool(a_initially_slowed_chance_);
-		bool b_slowed = rng.get_random_bool(b_initially_slowed_chance_);
-		const std::vector<double>& a_initial = a_slowed ? a_initial_slowed_ : a_initial_;
-		const std::vector<double>& b_initial = b_slowed ? b_initial_slowed_ : b_initial_;
-		unsigned int a_hp = rng.get_random_element(a_initial.begin(), a_initial.end());
-		unsigned int b_hp = rng.get_random_element(b_initial.begin(), b_initial.end());
-		unsigned int a_strikes = calc_blows_a(a_hp);
-		unsigned int b_strikes = calc_blows_b(b_hp);
-
-		for(unsigned int j = 0u; j < rounds_ && a_hp > 0u && b_hp > 0u; ++j) {
-			for(unsigned int k = 0u; k < std::max(a_strikes, b_strikes); ++k) {
-				if(k < a_strikes) {
-					if(rng.get_random_bool(a_hit_chance_)) {
-						// A hits B
-						unsigned int damage = a_slowed ? a_slow_damage_ : a_damage_;
-						damage = std::min(damage, b_hp);
-						b_hit = true;
-						b_slowed |= a_slows_;
-
-						int drain_amount = (a_drain_percent_ * static_cast<signed>(damage) / 100 + a_drain_constant_);
-						a_hp = std::clamp(a_hp + drain_amount, 1u, a_max_hp_);
-
-						b_hp -= damage;
-
-						if(b_hp == 0u) {
-							// A killed B
-							break;
+	while(iterations_ < MIN_ITERATIONS || (iterations_ < MAX_ITERATIONS && !converged())) {
+		for(unsigned int i = 0u; i < BATCH_ITERATIONS; ++i) {
+			bool a_hit = false;
+			bool b_hit = false;
+			bool a_slowed = rng.get_random_bool(a_initially_slowed_chance_);
+			bool b_slowed = rng.get_random_bool(b_initially_slowed_chance_);
+			const std::vector<double>& a_initial = a_slowed ? a_initial_slowed_ : a_initial_;
+			const std::vector<double>& b_initial = b_slowed ? b_initial_slowed_ : b_initial_;
+			unsigned int a_hp = rng.get_random_element(a_initial.begin(), a_initial.end());
+			unsigned int b_hp = rng.get_random_element(b_initial.begin(), b_initial.end());
+			unsigned int a_strikes = calc_blows_a(a_hp);
+			unsigned int b_strikes = calc_blows_b(b_hp);
+
+			for(unsigned int j = 0u; j < rounds_ && a_hp > 0u && b_hp > 0u; ++j) {
+				for(unsigned int k = 0u; k < std::max(a_strikes, b_strikes); ++k) {
+					if(k < a_strikes) {
+						if(rng.get_random_bool(a_hit_chance_)) {
+							// A hits B
+							unsigned int damage = a_slowed ? a_slow_damage_ : a_damage_;
+							damage = std::min(damage, b_hp);
+							b_hit = true;
+							b_slowed |= a_slows_;
+
+							int drain_amount = (a_drain_percent_ * static_cast<signed>(damage) / 100 + a_drain_constant_);
+							a_hp = std::clamp(a_hp + drain_amount, 1u, a_max_hp_);
+
+							b_hp -= damage;
+
+							if(b_hp == 0u) {
+								// A killed B
+								break;
+							}
 						}
 					}
-				}
 
-				if(k < b_strikes) {
-					if(rng.get_random_bool(b_hit_chance_)) {
-						// B hits A
-						unsigned int damage = b_slowed ? b_slow_damage_ : b_damage_;
-						damage = std::min(damage, a_hp);
-						a_hit = true;
-						a_slowed |= b_slows_;
+					if(k < b_strikes) {
+						if(rng.get_random_bool(b_hit_chance_)) {
+							// B hits A
+							unsigned int damage = b_slowed ? b_slow_damage_ : b_damage_;
+							damage = std::min(damage, a_hp);
+							a_hit = true;
+							a_slowed |= b_slows_;
 
-						int drain_amount = (b_drain_percent_ * static_cast<signed>(damage) / 100 + b_drain_constant_);
-						b_hp = std::clamp(b_hp + drain_amount, 1u, b_max_hp_);
+							int drain_amount = (b_drain_percent_ * static_cast<signed>(damage) / 100 + b_drain_constant_);
+							b_hp = std::clamp(b_hp + drain_amount, 1u, b_max_hp_);
 
-						a_hp -= damage;
+							a_hp -= damage;
 
-						if(a_hp == 0u) {
-							// B killed A
-							break;
+							if(a_hp == 0u) {
+								// B killed A
+								break;
+							}
 						}
 					}
 				}
 			}
-		}
 
-		iterations_a_hit_ += a_hit ? 1 : 0;
-		iterations_b_hit_ += b_hit ? 1 : 0;
+			iterations_a_hit_ += a_hit ? 1 : 0;
+			iterations_b_hit_ += b_hit ? 1 : 0;
+			iterations_a_killed_ += a_hp == 0u ? 1 : 0;
+			iterations_b_killed_ += b_hp == 0u ? 1 : 0;
 
-		record_monte_carlo_result(a_hp, b_hp, a_slowed, b_slowed);
+			record_monte_carlo_result(a_hp, b_hp, a_slowed, b_slowed);
+		}
+
+		iterations_ += BATCH_ITERATIONS;
 	}
 }
 
+bool monte_carlo_combat_matrix::converged() const
+{
+	const double n = static_cast<double>(iterations_);
+	const auto standard_error = [n](unsigned int count) {
+		const double p = static_cast<double>(count) / n;
+		return std::sqrt(p * (1.0 - p) / n);
+	};
+
+	return standard_error(iterations_a_killed_) < MAX_STANDARD_ERROR
+		&& standard_error(iterations_b_killed_) < MAX_STANDARD_ERROR;
+}
+
 /**
  * Otherwise the same as in probability_combat_matrix, but this needs to divide the values
  * by the number of iterations.
@@ -1588,26 +1769,26 @@ void monte_carlo_combat_matrix::extract_results(
 		sum(p, summary_a[dst_a], summary_b[dst_b]);
 	}
 
-	divide_all_elements(summary_a[0], static_cast<double>(NUM_ITERATIONS));
-	divide_all_elements(summary_b[0], static_cast<double>(NUM_ITERATIONS));
+	divide_all_elements(summary_a[0], static_cast<double>(iterations_));
+	divide_all_elements(summary_b[0], static_cast<double>(iterations_));
 
 	if(plane_used(A_SLOWED)) {
-		divide_all_elements(summary_a[1], static_cast<double>(NUM_ITERATIONS));
+		divide_all_elements(summary_a[1], static_cast<double>(iterations_));
 	}
 
 	if(plane_used(B_SLOWED)) {
-		divide_all_elements(summary_b[1], static_cast<double>(NUM_ITERATIONS));
+		divide_all_elements(summary_b[1], static_cast<double>(iterations_));
 	}
 }
 
 double monte_carlo_combat_matrix::get_a_hit_probability() const
 {
-	return static_cast<double>(iterations_a_hit_) / static_cast<double>(NUM_ITERATIONS);
+	return static_cast<double>(iterations_a_hit_) / static_cast<double>(iterations_);
 }
 
 double monte_carlo_combat_matrix::get_b_hit_probability() const
 {
-	return static_cast<double>(iterations_b_hit_) / static_cast<double>(NUM_ITERATIONS);
+	return static_cast<double>(iterations_b_hit_) / static_cast<double>(iterations_);
 }
 
 unsigned int monte_carlo_combat_matrix::calc_blows_a(unsigned int a_hp) const
@@ -1673,6 +1854,7 @@ combatant::combatant(const battle_context_unit_stats& u, const combatant* prev)
 	, poisoned(0.0)
 	, slowed(0.0)
 	, u_(u)
+	, fresh_(prev == nullptr)
 {
 	// We inherit current state from previous combatant.
 	if(prev) {
@@ -1704,6 +1886,7 @@ combatant::combatant(const combatant& that, const battle_context_unit_stats& u)
 	, poisoned(that.poisoned)
 	, slowed(that.slowed)
 	, u_(u)
+	, fresh_(false)
 {
 	summary[0] = that.summary[0];
 	summary[1] = that.summary[1];
@@ -2288,6 +2471,117 @@ void merge_slice_summary(std::vector<double>& dst, const std::vector<double>& sr
 
 } // end anon namespace
 
+/** The state one combatant is left in after a fight. */
+struct fight_result
+{
+	std::vector<double> hp_dist;
+	std::array<std::vector<double>, 2> summary;
+	double untouched;
+	double poisoned;
+	double slowed;
+};
+
+namespace
+{
+/**
+ * Everything about a pair of combatants that the outcome of a fight between
+ * two fresh combatants depends on.
+ */
+class fight_key
+{
+public:
+	fight_key(const battle_context_unit_stats& a, const battle_context_unit_stats& b, bool levelup_considered)
+		: fields_()
+	{
+		auto i = fields_.begin();
+		add(i, a);
+		add(i, b);
+		*i = levelup_considered;
+	}
+
+	bool operator<(const fight_key& other) const
+	{
+		return fields_ < other.fields_;
+	}
+
+private:
+	static const std::size_t FIELDS_PER_UNIT = 25;
+
+	using fields_t = std::array<int, 2 * FIELDS_PER_UNIT + 1>;
+
+	static void add(fields_t::iterator& i, const battle_context_unit_stats& u)
+	{
+		for(int field : {
+			int(u.is_attacker), int(u.is_poisoned), int(u.is_slowed), int(u.slows), int(u.drains),
+			int(u.petrifies), int(u.plagues), int(u.poisons), int(u.swarm), int(u.firststrike), int(u.disable),
+			int(u.experience), int(u.max_experience), int(u.level), int(u.rounds), int(u.hp), int(u.max_hp),
+			int(u.chance_to_hit), u.damage, u.slow_damage, u.drain_percent, u.drain_constant,
+			int(u.num_blows), int(u.swarm_min), int(u.swarm_max)
+		}) {
+			*i++ = field;
+		}
+	}
+
+	fields_t fields_;
+};
+
+/**
+ * A bounded, least-recently-used cache of fight outcomes.
+ *
+ * Only fights between combatants that have not fought before are cached,
+ * because only then is the outcome fully determined by the two stat blocks.
+ * Attack analysis tends to evaluate the same matchups over and over, so this
+ * saves recomputing the probability matrix for each of them.
+ */
+class fight_cache
+{
+public:
+	using value_type = std::pair<fight_result, fight_result>;
+
+	const value_type* find(const fight_key& key)
+	{
+		auto i = index_.find(key);
+		if(i == index_.end()) {
+			return nullptr;
+		}
+
+		// Move the entry to the front of the usage list.
+		entries_.splice(entries_.begin(), entries_, i->second);
+		return &i->second->second;
+	}
+
+	void insert(const fight_key& key, value_type&& value)
+	{
+		if(index_.count(key) != 0) {
+			return;
+		}
+
+		if(entries_.size() >= MAX_ENTRIES) {
+			index_.erase(entries_.back().first);
+			entries_.pop_back();
+		}
+
+		entries_.emplace_front(key, std::move(value));
+		index_.emplace(key, entries_.begin());
+	}
+
+private:
+	static const std::size_t MAX_ENTRIES = 256;
+
+	using entry_list = std::list<std::pair<fight_key, value_type>>;
+
+	entry_list entries_;
+	std::map<fight_key, entry_list::iterator> index_;
+};
+
+fight_cache& get_fight_cache()
+{
+	static fight_cache cache;
+	return cache;
+}
+
+} // end anon namespace
+
 // Two man enter.  One man leave!
 // ... Or maybe two.  But definitely not three.
 // Of course, one could be a woman.  Or both.
@@ -2308,6 +2602,21 @@ void combatant::fight(combatant& opponent, bool levelup_considered)
 	dump(opponent.u_);
 #endif
 
+#if !defined(BENCHMARK) && !defined(CHECK)
+	const bool cacheable = fresh_ && opponent.fresh_;
+	fresh_ = false;
+	opponent.fresh_ = false;
+
+	const fight_key key(u_, opponent.u_, levelup_considered);
+	if(cacheable) {
+		if(const fight_cache::value_type* cached = get_fight_cache().find(key)) {
+			restore(cached->first);
+			opponent.restore(cached->second);
+			return;
+		}
+	}
+#endif
+
 #if 0
 	std::vector<double> prev = summary[0], opp_prev = opponent.summary[0];
 	complex_fight(opponent, 1);
@@ -2457,6 +2766,26 @@ void combatant::fight(combatant& opponent, bool levelup_considered)
 
 	untouched *= self_not_hit;
 	opponent.untouched *= opp_not_hit;
+
+#if !defined(BENCHMARK) && !defined(CHECK)
+	// Monte Carlo results are only an approximation, so do not let one
+	// simulation stand in for all later ones.
+	if(cacheable && !use_monte_carlo_simulation) {
+		get_fight_cache().insert(key, {
+			{hp_dist, summary, untouched, poisoned, slowed},
+			{opponent.hp_dist, opponent.summary, opponent.untouched, opponent.poisoned, opponent.slowed}
+		});
+	}
+#endif
+}
+
+void combatant::restore(const fight_result& result)
+{
+	hp_dist = result.hp_dist;
+	summary = result.summary;
+	untouched = result.untouched;
+	poisoned = result.poisoned;
+	slowed = result.slowed;
 }
 
 double combatant::average_hp(unsigned int healing) const
@@ -2622,6 +2951,7 @@ void combatant::reset()
 	slowed = u_.is_slowed ? 1.0 : 0.0;
 	summary[0] = std::vector<double>();
 	summary[1] = std::vector<double>();
+	fresh_ = true;
 }
 
 static void run(unsigned specific_battle)
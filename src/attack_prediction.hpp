@@ -20,6 +20,7 @@
 #include <cstring>
 
 struct battle_context_unit_stats;
+struct fight_result;
 
 // This encapsulates all we need to know for this combat.
 /** All combat-related info. */
@@ -61,8 +62,14 @@ struct combatant
 private:
 	static const unsigned int MONTE_CARLO_SIMULATION_THRESHOLD = 50000u;
 
+	/** Replace our state with the outcome of an earlier, identical fight. */
+	void restore(const fight_result &result);
+
 	const battle_context_unit_stats &u_;
 
+	/** True until we have fought, i.e. while our state follows from u_ alone. */
+	bool fresh_;
+
 	/** Summary of matrix used to calculate last battle (unslowed & slowed).
 	 *  Invariant: summary[1].size() == summary[0].size() or summary[1].empty() */
 	std::array<std::vector<double>, 2> summary;
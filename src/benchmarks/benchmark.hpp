@@ -0,0 +1,109 @@
+/*
+	Copyright (C) 2022
+	Part of the Battle for Wesnoth Project https://www.wesnoth.org/
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY.
+
+	See the COPYING file for more details.
+*/
+
+/**
+ * @file
+ * Minimal harness for the wesnoth_benchmarks program.
+ *
+ * A benchmark is a function taking a benchmarks::state. It does its setup,
+ * then runs the code being measured in a `while(state.keep_running())` loop.
+ * Only the time spent in that loop is measured.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace benchmarks
+{
+class state
+{
+public:
+	explicit state(std::chrono::nanoseconds min_time)
+		: min_time_(min_time)
+		, iterations_(0)
+		, start_()
+		, elapsed_(0)
+	{
+	}
+
+	/**
+	 * Whether the benchmark should run another iteration.
+	 *
+	 * The clock starts with the first call, and stops once enough time has
+	 * passed for the average to be meaningful. The last call doesn't start
+	 * an iteration, so iterations() is the number of times the loop body ran.
+	 */
+	bool keep_running()
+	{
+		const auto now = std::chrono::steady_clock::now();
+		if(iterations_ == 0) {
+			start_ = now;
+			++iterations_;
+			return true;
+		}
+
+		elapsed_ = now - start_;
+		if(elapsed_ < min_time_) {
+			++iterations_;
+			return true;
+		}
+
+		return false;
+	}
+
+	std::size_t iterations() const
+	{
+		return iterations_;
+	}
+
+	std::chrono::nanoseconds elapsed() const
+	{
+		return elapsed_;
+	}
+
+private:
+	std::chrono::nanoseconds min_time_;
+	std::size_t iterations_;
+	std::chrono::steady_clock::time_point start_;
+	std::chrono::nanoseconds elapsed_;
+};
+
+/**
+ * Keeps the compiler from optimizing away a result that is otherwise unused.
+ */
+void consume(std::size_t value);
+
+using benchmark_function = std::function<void(state&)>;
+
+void register_benchmark(const std::string& name, benchmark_function function);
+
+struct registrar
+{
+	registrar(const std::string& name, benchmark_function function)
+	{
+		register_benchmark(name, std::move(function));
+	}
+};
+
+} // namespace benchmarks
+
+/** Defines a benchmark and registers it under @a name. */
+#define WESNOTH_BENCHMARK(name) \
+	static void benchmark_##name(benchmarks::state& state); \
+	static const benchmarks::registrar benchmark_registrar_##name(#name, &benchmark_##name); \
+	static void benchmark_##name(benchmarks::state& state)
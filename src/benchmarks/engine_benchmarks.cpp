@@ -0,0 +1,167 @@
+/*
+	Copyright (C) 2022
+	Part of the Battle for Wesnoth Project https://www.wesnoth.org/
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY.
+
+	See the COPYING file for more details.
+*/
+
+/**
+ * @file
+ * Benchmarks of engine code that can run without game data or a display.
+ */
+
+#include "benchmarks/benchmark.hpp"
+
+#include "config.hpp"
+#include "formula/formula.hpp"
+#include "map/location.hpp"
+#include "pathfind/pathfind.hpp"
+#include "serialization/parser.hpp"
+#include "server/common/simple_wml.hpp"
+
+#include <sstream>
+
+namespace
+{
+/** A config shaped like a saved game: many children with a handful of keys each. */
+config make_save_like_config()
+{
+	config cfg;
+	for(int side = 1; side <= 4; ++side) {
+		config& side_cfg = cfg.add_child("side");
+		side_cfg["side"] = side;
+		side_cfg["gold"] = 100 * side;
+		side_cfg["controller"] = "human";
+
+		for(int i = 0; i < 250; ++i) {
+			config& unit = side_cfg.add_child("unit");
+			unit["id"] = "Unit-" + std::to_string(side) + "-" + std::to_string(i);
+			unit["type"] = "Elvish Fighter";
+			unit["x"] = i % 40 + 1;
+			unit["y"] = i / 40 + 1;
+			unit["hitpoints"] = 33;
+			unit["experience"] = i % 40;
+			unit["moves"] = 5;
+			unit["canrecruit"] = i == 0;
+			unit["name"] = "Galdren";
+
+			config& attack = unit.add_child("attack");
+			attack["name"] = "sword";
+			attack["damage"] = 5;
+			attack["number"] = 4;
+			attack["range"] = "melee";
+		}
+	}
+
+	return cfg;
+}
+
+const std::string& save_like_text()
+{
+	static const std::string text = [] {
+		std::ostringstream out;
+		write(out, make_save_like_config());
+		return out.str();
+	}();
+
+	return text;
+}
+
+/** Every hex costs one move, except for a wall with a single gap. */
+struct wall_cost_calculator : public pathfind::cost_calculator
+{
+	virtual double cost(const map_location& loc, const double) const override
+	{
+		return loc.x == 40 && loc.y != 75 ? getNoPathValue() : 1.0;
+	}
+};
+
+} // end anon namespace
+
+WESNOTH_BENCHMARK(config_read)
+{
+	const std::string& text = save_like_text();
+	while(state.keep_running()) {
+		config cfg;
+		read(cfg, text);
+		benchmarks::consume(cfg.child_count("side"));
+	}
+}
+
+WESNOTH_BENCHMARK(config_write)
+{
+	const config cfg = make_save_like_config();
+	while(state.keep_running()) {
+		std::ostringstream out;
+		write(out, cfg);
+		benchmarks::consume(out.tellp());
+	}
+}
+
+WESNOTH_BENCHMARK(config_copy)
+{
+	const config cfg = make_save_like_config();
+	while(state.keep_running()) {
+		config copy = cfg;
+		benchmarks::consume(copy.child_count("side"));
+	}
+}
+
+WESNOTH_BENCHMARK(simple_wml_parse)
+{
+	const std::string& text = save_like_text();
+	while(state.keep_running()) {
+		simple_wml::document doc(text.c_str(), simple_wml::INIT_STATIC);
+		benchmarks::consume(doc.root().children("side").size());
+	}
+}
+
+WESNOTH_BENCHMARK(a_star_search)
+{
+	const wall_cost_calculator calc;
+	pathfind::astar_workspace workspace;
+	const map_location src(0, 0);
+	const map_location dst(79, 0);
+
+	while(state.keep_running()) {
+		const pathfind::plain_route route = pathfind::a_star_search(src, dst, 10000.0, calc, 80, 80, workspace);
+		benchmarks::consume(route.steps.size());
+	}
+}
+
+WESNOTH_BENCHMARK(formula_parse)
+{
+	while(state.keep_running()) {
+		const wfl::formula f("sum(map([1, 2, 3, 4, 5, 6, 7, 8, 9, 10], x * x)) + if(3 > 2, 1, 0)");
+		benchmarks::consume(f.str().size());
+	}
+}
+
+WESNOTH_BENCHMARK(formula_evaluate)
+{
+	const wfl::formula f("sum(map([1, 2, 3, 4, 5, 6, 7, 8, 9, 10], x * x)) + if(3 > 2, 1, 0)");
+	while(state.keep_running()) {
+		benchmarks::consume(f.evaluate().as_int());
+	}
+}
+
+WESNOTH_BENCHMARK(location_matches_range)
+{
+	const std::string xs = "1-5,7,9-12,15,20-30,33,35-40";
+	const std::string ys = "1-3,5,6-10,12,14-20,22,25-30";
+
+	while(state.keep_running()) {
+		std::size_t matches = 0;
+		for(int x = 0; x < 40; ++x) {
+			matches += map_location(x, x % 30).matches_range(xs, ys);
+		}
+		benchmarks::consume(matches);
+	}
+}
@@ -0,0 +1,139 @@
+/*
+	Copyright (C) 2022
+	Part of the Battle for Wesnoth Project https://www.wesnoth.org/
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY.
+
+	See the COPYING file for more details.
+*/
+
+/**
+ * @file
+ * Runs the benchmarks registered with WESNOTH_BENCHMARK.
+ *
+ * Usage: wesnoth_benchmarks [--filter <substring>] [--min-time <milliseconds>] [--json <file>]
+ *
+ * Results are printed as a table, and also written as JSON to the given file
+ * so that runs can be compared by scripts.
+ */
+
+#include "benchmarks/benchmark.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <vector>
+
+namespace benchmarks
+{
+namespace
+{
+std::map<std::string, benchmark_function>& registry()
+{
+	static std::map<std::string, benchmark_function> benchmarks;
+	return benchmarks;
+}
+
+volatile std::size_t sink = 0;
+
+struct result
+{
+	std::string name;
+	std::size_t iterations;
+	double ns_per_iteration;
+};
+
+void write_json(std::ostream& out, const std::vector<result>& results)
+{
+	out << "{\n\t\"benchmarks\": [";
+	for(std::size_t i = 0; i < results.size(); ++i) {
+		// Benchmark names are C++ identifiers, so they need no escaping.
+		out << (i == 0 ? "\n" : ",\n")
+			<< "\t\t{\"name\": \"" << results[i].name << "\""
+			<< ", \"iterations\": " << results[i].iterations
+			<< ", \"ns_per_iteration\": " << std::fixed << std::setprecision(1) << results[i].ns_per_iteration << "}";
+	}
+	out << "\n\t]\n}\n";
+}
+
+void usage(const char* program)
+{
+	std::cerr << "Usage: " << program << " [--filter <substring>] [--min-time <milliseconds>] [--json <file>]\n";
+}
+
+} // end anon namespace
+
+void consume(std::size_t value)
+{
+	sink = sink + value;
+}
+
+void register_benchmark(const std::string& name, benchmark_function function)
+{
+	registry().emplace(name, std::move(function));
+}
+
+} // namespace benchmarks
+
+int main(int argc, char** argv)
+{
+	std::string filter;
+	std::string json_file;
+	std::chrono::milliseconds min_time(500);
+
+	for(int i = 1; i < argc; ++i) {
+		const std::string arg = argv[i];
+		if(i + 1 >= argc) {
+			benchmarks::usage(argv[0]);
+			return 1;
+		}
+
+		if(arg == "--filter") {
+			filter = argv[++i];
+		} else if(arg == "--json") {
+			json_file = argv[++i];
+		} else if(arg == "--min-time") {
+			min_time = std::chrono::milliseconds(std::atoi(argv[++i]));
+		} else {
+			benchmarks::usage(argv[0]);
+			return 1;
+		}
+	}
+
+	std::vector<benchmarks::result> results;
+
+	for(const auto& [name, function] : benchmarks::registry()) {
+		if(name.find(filter) == std::string::npos) {
+			continue;
+		}
+
+		benchmarks::state state(min_time);
+		function(state);
+
+		const double ns = state.iterations() == 0 ? 0.0
+			: static_cast<double>(state.elapsed().count()) / state.iterations();
+		results.push_back({name, state.iterations(), ns});
+
+		std::cout << std::left << std::setw(32) << name
+			<< std::right << std::setw(12) << state.iterations()
+			<< std::setw(16) << std::fixed << std::setprecision(1) << ns << " ns" << std::endl;
+	}
+
+	if(!json_file.empty()) {
+		std::ofstream out(json_file);
+		if(!out) {
+			std::cerr << "Could not open " << json_file << " for writing\n";
+			return 1;
+		}
+		benchmarks::write_json(out, results);
+	}
+
+	return 0;
+}
@@ -22,6 +22,7 @@
 
 #include <cstdio>
 #include <sstream>
+#include <string_view>
 
 /**
  * Helper class for buffering a @c std::istream.
@@ -34,8 +35,8 @@
  * buffer. Then the next request can deliver data from this buffer.
  *
  * Since the class is only designed for small reads it only offers the @ref
- * get() and the @ref peek() to get data and @ref eof() to signal the end of
- * data. The original stream should not be used from, while being owned by this
+ * get() and the @ref peek() to get data, @ref peek_buffer() to scan what is
+ * already buffered, and @ref eof() to signal the end of data. The original stream should not be used from, while being owned by this
  * class.
  */
 class buffered_istream
@@ -96,6 +97,37 @@ public:
 		}
 	}
 
+	/**
+	 * Gets the characters buffered but not consumed yet.
+	 *
+	 * This lets callers scan a run of characters without a call per
+	 * character; use @ref skip() to consume what they used.
+	 *
+	 * @returns                   The available data, empty only when the end
+	 *                            of input has been read.
+	 */
+	std::string_view peek_buffer()
+	{
+		fill_buffer();
+
+		if(eof_) {
+			return {};
+		} else {
+			return {buffer_ + buffer_offset_, buffer_size_ - buffer_offset_};
+		}
+	}
+
+	/**
+	 * Consumes characters returned by @ref peek_buffer().
+	 *
+	 * @param count               The number of characters, at most the size
+	 *                            of the last @ref peek_buffer() result.
+	 */
+	void skip(std::size_t count)
+	{
+		buffer_offset_ += count;
+	}
+
 	/** Is the end of input reached? */
 	bool eof() const
 	{
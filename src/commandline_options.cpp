@@ -89,6 +89,7 @@ commandline_options::commandline_options(const std::vector<std::string>& args)
 #endif
 	, editor()
 	, fps(false)
+	, frame_trace()
 	, fullscreen(false)
 	, gunzip()
 	, gzip()
@@ -98,6 +99,7 @@ commandline_options::commandline_options(const std::vector<std::string>& args)
 	, load()
 	, logdomains()
 	, log_precise_timestamps(false)
+	, lua_profile()
 	, multiplayer(false)
 	, multiplayer_ai_config()
 	, multiplayer_algorithm()
@@ -108,6 +110,7 @@ commandline_options::commandline_options(const std::vector<std::string>& args)
 	, multiplayer_label()
 	, multiplayer_parm()
 	, multiplayer_repeat()
+	, multiplayer_results()
 	, multiplayer_scenario()
 	, multiplayer_side()
 	, multiplayer_turns()
@@ -143,8 +146,11 @@ commandline_options::commandline_options(const std::vector<std::string>& args)
 	, test()
 	, unit_test()
 	, headless_unit_test(false)
+	, unit_test_report()
 	, noreplaycheck(false)
+	, verify_replay()
 	, mptest(false)
+	, uncompressed_cache(false)
 	, usercache_path(false)
 	, usercache_dir()
 	, userconfig_path(false)
@@ -189,6 +195,7 @@ commandline_options::commandline_options(const std::vector<std::string>& args)
 		("debug,d", "enables additional command mode options in-game.")
 		("debug-lua", "enables some Lua debugging mechanisms")
 		("strict-lua", "disallow deprecated Lua API calls")
+		("lua-profile", po::value<std::string>(), "samples the Lua code being run, attributing its time to the functions, source lines and WML events involved. The samples are written to <arg> in the folded stack format read by flame graph tools when each Lua state is closed.")
 		("allow-insecure", "Allows sending a plaintext password over an unencrypted connection. Should only ever be used for local testing.")
 #ifdef DEBUG_WINDOW_LAYOUT_GRAPHS
 		("debug-dot-level", po::value<std::string>(), "sets the level of the debug dot files. <arg> should be a comma separated list of levels. These files are used for debugging the widgets especially the for the layout engine. When enabled the engine will produce dot files which can be converted to images with the dot tool. Available levels: size (generate the size info of the widget), state (generate the state info of the widget).")
@@ -215,6 +222,7 @@ commandline_options::commandline_options(const std::vector<std::string>& args)
 		("server,s", po::value<std::string>()->implicit_value(std::string()), "connects to the host <arg> if specified or to the first host in your preferences.")
 		("strict-validation", "makes validation errors fatal")
 		("translations-over", po::value<unsigned int>(), "Specify the standard for determining whether a translation is complete.")
+		("uncompressed-cache", "stores the game data cache without compression. Loading a cached game config gets faster at the cost of more disk space.")
 		("unsafe-scripts", "makes the \'package\' package available to Lua scripts, so that they can load arbitrary packages. Do not do this with untrusted scripts! This action gives ua the same permissions as the Wesnoth executable.")
 		("usercache-dir", po::value<std::string>(), "sets the path of the cache directory to $HOME/<arg> or My Documents\\My Games\\<arg> for Windows. You can specify also an absolute path outside the $HOME or My Documents\\My Games directory. Defaults to $HOME/.cache/wesnoth on X11 and to the userdata-dir on other systems.")
 		("usercache-path", "prints the path of the cache directory and exits.")
@@ -245,6 +253,7 @@ commandline_options::commandline_options(const std::vector<std::string>& args)
 	po::options_description display_opts("Display options");
 	display_opts.add_options()
 		("fps", "displays the number of frames per second the game is currently running at, in a corner of the screen. Min/avg/max don't take the FPS limiter into account, act does.")
+		("frame-trace", po::value<std::string>(), "records how long each frame of the render loop and its main steps take. Shows a frame time graph over the game map and writes the recorded timings to <arg> in the Chrome trace format on exit.")
 		("fullscreen,f", "runs the game in full screen mode.")
 		("max-fps", po::value<int>(), "the maximum fps the game tries to run at. Values should be between 1 and 1000, the default is the display's refresh rate.")
 		("new-widgets", "there is a new WIP widget toolkit this switch enables the new toolkit (VERY EXPERIMENTAL don't file bug reports since most are known). Parts of the library are deemed stable and will work without this switch.")
@@ -275,6 +284,7 @@ commandline_options::commandline_options(const std::vector<std::string>& args)
 		("ignore-map-settings", "do not use map settings.")
 		("label", po::value<std::string>(), "sets the label for AIs.") // TODO: is the description precise? this option was undocumented before.
 		("multiplayer-repeat",  po::value<unsigned int>(), "repeats a multiplayer game after it is finished <arg> times.")
+		("multiplayer-results", po::value<std::string>(), "writes the result and timings of each game to the WML file <arg>.")
 		("nogui", "runs the game without the GUI.")
 		("parm", po::value<std::vector<std::string>>()->composing(), "sets additional parameters for this side. <arg> should have format side:name:value.")
 		("scenario", po::value<std::string>(), "selects a multiplayer scenario. The default scenario is \"multiplayer_The_Freelands\".")
@@ -286,10 +296,12 @@ commandline_options::commandline_options(const std::vector<std::string>& args)
 	testing_opts.add_options()
 		("test,t", po::value<std::string>()->implicit_value(std::string()), "runs the game in a small test scenario. If specified, scenario <arg> will be used instead.")
 		("unit,u", po::value<std::vector<std::string>>(), "runs a unit test scenario. The GUI is not shown and the exit code of the program reflects the victory / defeat conditions of the scenario.\n\t0 - PASS\n\t1 - FAIL\n\t3 - FAIL (INVALID REPLAY)\n\t4 - FAIL (ERRORED REPLAY)\n\t5 - FAIL (BROKE STRICT)\n\t6 - FAIL (WML EXCEPTION)\n\tMultiple tests can be run by giving this option multiple times, in this case the test run will stop immediately after any test which doesn't PASS and the return code will be the status of the test that caused the stop.")
+		("unit-report", po::value<std::string>(), "runs all the --unit tests even if some of them don't PASS, and writes their results to file <arg>, one line per test: the status code listed for --unit, a space and the name of the test. The exit code is the status of the first test that didn't PASS.")
 		("showgui", "don't run headlessly (for debugging a failing test)")
 		("log-strict", po::value<std::string>(), "sets the strict level of the logger. any messages sent to log domains of this level or more severe will cause the unit test to fail regardless of the victory result.")
 		("nobanner", "suppress startup banner.")
 		("noreplaycheck", "don't try to validate replay of unit test.")
+		("verify-replay", po::value<std::vector<std::string>>()->composing(), "plays the replay in save file <arg> without the GUI and without delays, and reports whether it could be played without errors, such as going out of sync. <arg> is relative to the saves directory unless it contains a directory. Multiple replays can be verified by giving this option multiple times; the exit code is 0 if all of them pass and 1 otherwise.")
 		("mp-test", "load the test mp scenarios.")
 		;
 
@@ -377,6 +389,8 @@ commandline_options::commandline_options(const std::vector<std::string>& args)
 		multiplayer_exit_at_end = true;
 	if(vm.count("fps"))
 		fps = true;
+	if(vm.count("frame-trace"))
+		frame_trace = vm["frame-trace"].as<std::string>();
 	if(vm.count("fullscreen"))
 		fullscreen = true;
 	if(vm.count("gunzip"))
@@ -409,6 +423,8 @@ commandline_options::commandline_options(const std::vector<std::string>& args)
 		log_precise_timestamps = true;
 	if(vm.count("log-strict"))
 		parse_log_strictness(vm["log-strict"].as<std::string>());
+	if(vm.count("lua-profile"))
+		lua_profile = vm["lua-profile"].as<std::string>();
 	if(vm.count("max-fps"))
 		max_fps = vm["max-fps"].as<int>();
 	if(vm.count("mp-test"))
@@ -417,6 +433,8 @@ commandline_options::commandline_options(const std::vector<std::string>& args)
 		multiplayer = true;
 	if(vm.count("multiplayer-repeat"))
 		multiplayer_repeat = vm["multiplayer-repeat"].as<unsigned int>();
+	if(vm.count("multiplayer-results"))
+		multiplayer_results = vm["multiplayer-results"].as<std::string>();
 	if(vm.count("new-widgets"))
 		new_widgets = true;
 	if(vm.count("noaddons"))
@@ -429,6 +447,8 @@ commandline_options::commandline_options(const std::vector<std::string>& args)
 		nomusic = true;
 	if(vm.count("noreplaycheck"))
 		noreplaycheck = true;
+	if(vm.count("verify-replay"))
+		verify_replay = vm["verify-replay"].as<std::vector<std::string>>();
 	if(vm.count("nosound"))
 		nosound = true;
 	if(vm.count("nogui"))
@@ -505,6 +525,8 @@ commandline_options::commandline_options(const std::vector<std::string>& args)
 		unit_test = vm["unit"].as<std::vector<std::string>>();
 		headless_unit_test = true;
 	}
+	if(vm.count("unit-report"))
+		unit_test_report = vm["unit-report"].as<std::string>();
 	if(vm.count("showgui"))
 		headless_unit_test = false;
 	if(vm.count("noreplaycheck"))
@@ -513,6 +535,8 @@ commandline_options::commandline_options(const std::vector<std::string>& args)
 		multiplayer_turns = vm["turns"].as<std::string>();
 	if(vm.count("strict-validation"))
 		strict_validation = true;
+	if(vm.count("uncompressed-cache"))
+		uncompressed_cache = true;
 	if(vm.count("usercache-dir"))
 		usercache_dir = vm["usercache-dir"].as<std::string>();
 	if(vm.count("usercache-path"))
@@ -93,6 +93,8 @@ public:
 	std::optional<std::string> editor;
 	/** True if --fps was given on the command line. Shows number of fps. */
 	bool fps;
+	/** Non-empty if --frame-trace was given on the command line. Enables the frame profiler, writing its trace to this file. */
+	std::optional<std::string> frame_trace;
 	/** True if --fullscreen was given on the command line. Starts Wesnoth in fullscreen mode. */
 	bool fullscreen;
 	/** Non-empty if --gunzip was given on the command line. Uncompresses a .gz file and exits. */
@@ -116,6 +118,8 @@ public:
 	std::optional<std::string> logdomains;
 	/** True if --log-precise was given on the command line. Shows timestamps in log with more precision. */
 	bool log_precise_timestamps;
+	/** Non-empty if --lua-profile was given on the command line. Enables the Lua sampling profiler, writing its samples to this file. */
+	std::optional<std::string> lua_profile;
 	/** True if --multiplayer was given on the command line. Goes directly into multiplayer mode. */
 	bool multiplayer;
 	/** Non-empty if --ai-config was given on the command line. Vector of pairs (side number, value). Dependent on --multiplayer. */
@@ -136,6 +140,8 @@ public:
 	std::optional<std::vector<std::tuple<unsigned int, std::string, std::string>>> multiplayer_parm;
 	/** Repeats specified by --multiplayer-repeat option. Repeats a multiplayer game after it is finished. Dependent on --multiplayer. */
 	std::optional<unsigned int> multiplayer_repeat;
+	/** Non-empty if --multiplayer-results was given on the command line. File to write per-game results and timings to. Dependent on --multiplayer. */
+	std::optional<std::string> multiplayer_results;
 	/** Non-empty if --scenario was given on the command line. Dependent on --multiplayer. */
 	std::optional<std::string> multiplayer_scenario;
 	/** Non-empty if --side was given on the command line. Vector of pairs (side number, faction id). Dependent on --multiplayer. */
@@ -206,10 +212,16 @@ public:
 	std::vector<std::string> unit_test;
 	/** True if --unit is used and --showgui is not present. */
 	bool headless_unit_test;
+	/** Non-empty if --unit-report was given on the command line. All --unit tests are run and their results written to this file. */
+	std::optional<std::string> unit_test_report;
 	/** True if --noreplaycheck was given on the command line. Dependent on --unit. */
 	bool noreplaycheck;
+	/** Non-empty if --verify-replay was given on the command line. Plays these replays headlessly and reports the result for each. */
+	std::vector<std::string> verify_replay;
 	/** True if --mp-test was given on the command line. */
 	bool mptest;
+	/** True if --uncompressed-cache was given on the command line. Stores the game data cache without compression. */
+	bool uncompressed_cache;
 	/** True if --usercache-path was given on the command line. Prints path to cache directory and exits. */
 	bool usercache_path;
 	/** Non-empty if --usercache-dir was given on the command line. Sets the cache dir to the specified one. */
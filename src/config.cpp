@@ -34,6 +34,7 @@
 #include <cstring>
 #include <istream>
 #include <locale>
+#include <type_traits>
 
 static lg::log_domain log_config("config");
 #define ERR_CF LOG_STREAM(err, log_config)
@@ -46,7 +47,7 @@ namespace
 {
 // std::map::operator[] does not support heterogeneous lookup so we need this to work around.
 template<typename Map, typename Key>
-typename Map::mapped_type& map_get(Map& map, Key&& key)
+typename Map::iterator map_get_iter(Map& map, Key&& key)
 {
 	auto res = map.lower_bound(key);
 
@@ -54,9 +55,10 @@ typename Map::mapped_type& map_get(Map& map, Key&& key)
 		res = map.emplace_hint(res, std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>());
 	}
 
-	return res->second;
+	return res;
 }
 
+
 // std::map::erase does not support heterogeneous lookup so we need this to work around.
 template<typename Map, typename Key>
 int map_erase_key(Map& map, Key&& key)
@@ -139,7 +141,37 @@ config::config(const config& cfg)
 	, children_()
 	, ordered_children()
 {
-	append_children(cfg);
+	check_valid(cfg);
+
+	// Copy the children tag by tag rather than through add_child, so that every
+	// child_list and the ordering are allocated exactly once and each tag name is
+	// only looked up when it differs from the previous child's.
+	for(const auto& [key, list] : cfg.children_) {
+		if(list.empty()) {
+			continue;
+		}
+
+		child_list& dst = children_.emplace_hint(children_.end(), key, child_list())->second;
+		dst.reserve(list.size());
+
+		for(const auto& child : list) {
+			dst.emplace_back(new config(*child));
+		}
+	}
+
+	ordered_children.reserve(cfg.ordered_children.size());
+
+	child_map::const_iterator last_src = cfg.children_.end();
+	child_map::iterator last_dst = children_.end();
+
+	for(const child_pos& pos : cfg.ordered_children) {
+		if(pos.pos != last_src) {
+			last_src = pos.pos;
+			last_dst = children_.find(pos.pos->first);
+		}
+
+		ordered_children.emplace_back(last_dst, pos.index);
+	}
 }
 
 config::config(config_key_type child)
@@ -233,18 +265,20 @@ void config::append_children(config&& cfg)
 {
 	check_valid(cfg);
 
-#if 0
-	//For some unknown reason this doesn't compile.
 	if(children_.empty()) {
-		//optimisation
-		children_ = std::move(cfg.children_);
-		ordered_children = std::move(cfg.ordered_children);
-		cfg.clear_all_children();
+		//optimisation: swapping keeps the child_pos iterators valid and saves
+		//reallocating every child.
+		children_.swap(cfg.children_);
+		ordered_children.swap(cfg.ordered_children);
 		return;
 	}
-#endif
-	for(const any_child value : cfg.all_children_range()) {
-		add_child(value.key, std::move(value.cfg));
+
+	// Hand over the child nodes themselves rather than moving their contents
+	// into newly allocated ones.
+	for(child_pos& pos : cfg.ordered_children) {
+		auto iter = map_get_iter(children_, pos.pos->first);
+		iter->second.push_back(std::move(pos.pos->second[pos.index]));
+		ordered_children.emplace_back(iter, iter->second.size() - 1);
 	}
 	cfg.clear_all_children();
 }
@@ -295,10 +329,15 @@ void config::append_children_by_move(config& cfg, const std::string& key)
 {
 	check_valid(cfg);
 
-	// DO note this leaves the tags empty in the source config. Not sure if
-	// that should be changed.
-	for(config& value : cfg.child_range(key)) {
-		add_child(key, std::move(value));
+	child_map::iterator i_src = cfg.children_.find(key);
+	if(i_src == cfg.children_.end()) {
+		return;
+	}
+
+	auto iter = map_get_iter(children_, key);
+	for(auto& child : i_src->second) {
+		iter->second.push_back(std::move(child));
+		ordered_children.emplace_back(iter, iter->second.size() - 1);
 	}
 
 	cfg.clear_children_impl(key);
@@ -515,9 +554,10 @@ config& config::add_child(config_key_type key)
 {
 	check_valid();
 
-	child_list& v = map_get(children_, key);
+	auto iter = map_get_iter(children_, key);
+	child_list& v = iter->second;
 	v.emplace_back(new config());
-	ordered_children.emplace_back(children_.find(key), v.size() - 1);
+	ordered_children.emplace_back(iter, v.size() - 1);
 	return *v.back();
 }
 
@@ -525,9 +565,10 @@ config& config::add_child(config_key_type key, const config& val)
 {
 	check_valid(val);
 
-	child_list& v = map_get(children_, key);
+	auto iter = map_get_iter(children_, key);
+	child_list& v = iter->second;
 	v.emplace_back(new config(val));
-	ordered_children.emplace_back(children_.find(key), v.size() - 1);
+	ordered_children.emplace_back(iter, v.size() - 1);
 
 	return *v.back();
 }
@@ -536,9 +577,10 @@ config& config::add_child(config_key_type key, config&& val)
 {
 	check_valid(val);
 
-	child_list& v = map_get(children_, key);
+	auto iter = map_get_iter(children_, key);
+	child_list& v = iter->second;
 	v.emplace_back(new config(std::move(val)));
-	ordered_children.emplace_back(children_.find(key), v.size() - 1);
+	ordered_children.emplace_back(iter, v.size() - 1);
 
 	return *v.back();
 }
@@ -547,7 +589,8 @@ config& config::add_child_at(config_key_type key, const config& val, unsigned in
 {
 	check_valid(val);
 
-	child_list& v = map_get(children_, key);
+	auto iter = map_get_iter(children_, key);
+	child_list& v = iter->second;
 	if(index > v.size()) {
 		throw error("illegal index to add child at");
 	}
@@ -556,7 +599,7 @@ config& config::add_child_at(config_key_type key, const config& val, unsigned in
 
 	bool inserted = false;
 
-	const child_pos value(children_.find(key), index);
+	const child_pos value(iter, index);
 
 	std::vector<child_pos>::iterator ord = ordered_children.begin();
 	for(; ord != ordered_children.end(); ++ord) {
@@ -674,8 +717,8 @@ void config::splice_children(config& src, const std::string& key)
 		std::remove_if(src.ordered_children.begin(), src.ordered_children.end(), remove_ordered(i_src)),
 		src.ordered_children.end());
 
-	child_list& dst = map_get(children_, key);
-	child_map::iterator i_dst = children_.find(key);
+	child_map::iterator i_dst = map_get_iter(children_, key);
+	child_list& dst = i_dst->second;
 
 	unsigned before = dst.size();
 	dst.insert(dst.end(), std::make_move_iterator(i_src->second.begin()), std::make_move_iterator(i_src->second.end()));
@@ -882,7 +925,7 @@ config::attr_itors config::attribute_range()
 	return range;
 }
 
-config& config::find_child(config_key_type key, const std::string& name, const std::string& value)
+config& config::find_child(config_key_type key, config_key_type name, const std::string& value)
 {
 	check_valid();
 
@@ -1389,45 +1432,51 @@ std::ostream& operator<<(std::ostream& outstream, const config& cfg)
 	return outstream;
 }
 
-std::string config::hash() const
+namespace
 {
-	check_valid();
+const unsigned int hash_length = 128;
 
-	static const unsigned int hash_length = 128;
+/**
+ * Computes config::hash() into @a hash_str, without allocating a string for each child
+ * and without creating a t_string for each attribute that isn't one.
+ */
+void hash_config(const config& cfg, char (&hash_str)[hash_length])
+{
 	static const char hash_string[] = "+-,.<>0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
-	char hash_str[hash_length + 1];
+	static const unsigned int hash_string_length = sizeof(hash_string) - 1;
 
 	unsigned int i;
 	for(i = 0; i != hash_length; ++i) {
 		hash_str[i] = 'a';
 	}
 
-	hash_str[hash_length] = 0;
-
-	i = 0;
-	for(const attribute& val : values_) {
-		if(val.second.blank()) {
-			continue;
-		}
-
-		for(char c : val.first) {
+	const auto add = [&hash_str, &i](const std::string& str) {
+		for(const char c : str) {
 			hash_str[i] ^= c;
 			if(++i == hash_length) {
 				i = 0;
 			}
 		}
+	};
 
-		std::string base_str = val.second.t_str().base_str();
-		for(const char c : base_str) {
-			hash_str[i] ^= c;
-			if(++i == hash_length) {
-				i = 0;
-			}
+	i = 0;
+	for(const config::attribute& val : cfg.attribute_range()) {
+		if(val.second.blank()) {
+			continue;
 		}
+
+		add(val.first);
+
+		// The untranslated string of anything but a t_string is just its string value.
+		const bool is_tstring = val.second.apply_visitor([](const auto& v) {
+			return std::is_same_v<std::decay_t<decltype(v)>, t_string>;
+		});
+		add(is_tstring ? val.second.t_str().base_str() : val.second.str());
 	}
 
-	for(const any_child ch : all_children_range()) {
-		std::string child_hash = ch.cfg.hash();
+	char child_hash[hash_length];
+	for(const config::any_child ch : cfg.all_children_range()) {
+		hash_config(ch.cfg, child_hash);
 		for(char c : child_hash) {
 			hash_str[i] ^= c;
 			++i;
@@ -1438,10 +1487,60 @@ std::string config::hash() const
 	}
 
 	for(i = 0; i != hash_length; ++i) {
-		hash_str[i] = hash_string[static_cast<unsigned>(hash_str[i]) % strlen(hash_string)];
+		hash_str[i] = hash_string[static_cast<unsigned>(hash_str[i]) % hash_string_length];
 	}
+}
+} // end anon namespace
+
+std::string config::hash() const
+{
+	check_valid();
+
+	char hash_str[hash_length];
+	hash_config(*this, hash_str);
+	return std::string(hash_str, hash_length);
+}
 
-	return std::string(hash_str);
+namespace
+{
+/** Rough bookkeeping overhead of a heap allocation, such as a std::map node. */
+const std::size_t allocation_overhead = 16;
+
+std::size_t heap_size(const std::string& str)
+{
+	// Short strings are stored inline.
+	return str.capacity() < sizeof(std::string) ? 0 : str.capacity() + 1 + allocation_overhead;
+}
+} // end anon namespace
+
+std::size_t config::memory_usage() const
+{
+	std::size_t res = ordered_children.capacity() * sizeof(child_pos);
+
+	for(const auto& [key, value] : values_) {
+		res += sizeof(attribute) + allocation_overhead + heap_size(key);
+		res += value.apply_visitor([](const auto& v) -> std::size_t {
+			using T = std::decay_t<decltype(v)>;
+			if constexpr(std::is_same_v<T, std::string>) {
+				return heap_size(v);
+			} else if constexpr(std::is_same_v<T, t_string>) {
+				// Translatable strings may be shared, so this can overestimate.
+				return v.base_str().size() + allocation_overhead;
+			} else {
+				return 0;
+			}
+		});
+	}
+
+	for(const auto& [key, list] : children_) {
+		res += sizeof(child_map::value_type) + allocation_overhead + heap_size(key);
+		res += list.capacity() * sizeof(child_list::value_type);
+		for(const auto& child : list) {
+			res += sizeof(config) + allocation_overhead + child->memory_usage();
+		}
+	}
+
+	return res;
 }
 
 void config::swap(config& cfg)
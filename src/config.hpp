@@ -569,10 +569,10 @@ public:
 	 * Returns the first child of tag @a key with a @a name attribute
 	 * containing @a value.
 	 */
-	config& find_child(config_key_type key, const std::string &name,
+	config& find_child(config_key_type key, config_key_type name,
 		const std::string &value);
 
-	const config& find_child(config_key_type key, const std::string &name,
+	const config& find_child(config_key_type key, config_key_type name,
 		const std::string &value) const
 	{ return const_cast<config *>(this)->find_child(key, name, value); }
 
@@ -606,6 +606,15 @@ public:
 	std::string debug() const;
 	std::string hash() const;
 
+	/**
+	 * Approximate heap memory used by this config and its children, in bytes.
+	 *
+	 * Counts the nodes and strings owned by the tree, with a rough estimate
+	 * of the allocator overhead. Walks the whole tree, so it is meant for
+	 * diagnostics rather than for regular use.
+	 */
+	std::size_t memory_usage() const;
+
 	struct error : public game::error {
 		error(const std::string& message) : game::error(message) {}
 	};
@@ -25,6 +25,8 @@
 #include "log.hpp"
 #include "serialization/string_utils.hpp"
 
+#include <cctype>
+#include <charconv>
 #include <cstdlib>
 #include <cstring>
 #include <deque>
@@ -134,26 +136,27 @@ config_attribute_value& config_attribute_value::operator=(double v)
 namespace
 {
 /**
- * Attempts to convert @a source to the template type.
+ * Attempts to convert @a source to the integer type @a To.
  * This is to avoid "overzealous reinterpretations of certain WML strings as numeric types".
  * For example: the version "2.1" and "2.10" are not the same.
  * Another example: the string "0001" given to [message] should not be displayed to the player as just "1".
  * @returns true if the conversion was successful and the source string
- *          can be reobtained by streaming the result.
+ *          can be reobtained by streaming the result: it has no sign other
+ *          than a minus, no leading zeros and no spaces, and is not "-0".
  */
 template<typename To>
 bool from_string_verify(const std::string& source, To& res)
 {
-	// Check 1: convertible to the target type.
-	std::istringstream in_str(source);
-	if(!(in_str >> res)) {
+	const char* first = source.data();
+	const char* last = first + source.size();
+
+	const auto [ptr, ec] = std::from_chars(first, last, res);
+	if(ec != std::errc() || ptr != last) {
 		return false;
 	}
 
-	// Check 2: convertible back to the same string.
-	std::ostringstream out_str;
-	out_str << res;
-	return out_str.str() == source;
+	const char* digits = *first == '-' ? first + 1 : first;
+	return *digits != '0' || (digits == first && digits + 1 == last);
 }
 } // end anon namespace
 
@@ -185,27 +188,27 @@ config_attribute_value& config_attribute_value::operator=(const std::string& v)
 		return *this;
 	}
 
-	// Attempt to convert to a number.
+	// Attempt to convert to an integer, which most numbers in WML are.
+	// (This is done from the string since the largest integer type could
+	// have more precision than a double.)
+	if(v[0] == '-') {
+		// The largest (variant) type for negative integers is int.
+		int i = 0;
+		if(from_string_verify(v, i)) {
+			return *this = i;
+		}
+	} else {
+		// The largest type for positive integers is unsigned long long.
+		unsigned long long ull = 0;
+		if(from_string_verify(v, ull)) {
+			return *this = ull;
+		}
+	}
+
+	// Attempt to convert to a double.
 	char* eptr;
 	double d = strtod(v.c_str(), &eptr);
 	if(*eptr == '\0') {
-		// Possibly a number. See what type it should be stored in.
-		// (All conversions will be from the string since the largest integer
-		// type could have more precision than a double.)
-		if(d > 0.0) {
-			// The largest type for positive integers is unsigned long long.
-			unsigned long long ull = 0;
-			if(from_string_verify<unsigned long long>(v, ull)) {
-				return *this = ull;
-			}
-		} else {
-			// The largest (variant) type for negative integers is int.
-			int i = 0;
-			if(from_string_verify<int>(v, i)) {
-				return *this = i;
-			}
-		}
-
 		// This does not look like an integer, so it should be a double.
 		// However, make sure it can convert back to the same string (in
 		// case this is a string that just looks like a numeric value).
@@ -275,7 +278,19 @@ public:
 	T operator()(int i)                const { return static_cast<T>(i); }
 	T operator()(unsigned long long u) const { return static_cast<T>(u); }
 	T operator()(double d)             const { return static_cast<T>(d); }
-	T operator()(const std::string& s) const { return lexical_cast_default<T>(s, def_); }
+	T operator()(const std::string& s) const
+	{
+		// Numbers are stored as such, so most strings are text that would only
+		// make the conversion throw and catch an exception.
+		if constexpr(std::is_integral_v<T>) {
+			const auto first = std::find_if_not(s.begin(), s.end(), [](unsigned char c) { return std::isspace(c); });
+			if(first == s.end() || !(std::isdigit(static_cast<unsigned char>(*first)) || *first == '-' || *first == '+')) {
+				return def_;
+			}
+		}
+
+		return lexical_cast_default<T>(s, def_);
+	}
 	T operator()(const t_string&)     const { return def_; }
 
 private:
@@ -421,8 +436,14 @@ bool config_attribute_value::operator==(const config_attribute_value& other) con
  * Note: Blanks have no string representation, so do not equal "" (an empty string).
  * Also note that translatable string are never equal to non translatable strings.
  */
-bool config_attribute_value::equals(const std::string& str) const
+bool config_attribute_value::equals(std::string_view str) const
 {
+	// A plain string is only ever stored if it could not be converted to any
+	// other type, so it can be compared directly without parsing @a str.
+	if(const std::string* p = utils::get_if<std::string>(&value_)) {
+		return *p == str;
+	}
+
 	config_attribute_value v;
 	v = str;
 	return *this == v;
@@ -37,6 +37,7 @@
 #include <iterator>
 #include <map>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 #include <type_traits>
@@ -173,7 +174,7 @@ public:
 		return !operator==(other);
 	}
 
-	bool equals(const std::string& str) const;
+	bool equals(std::string_view str) const;
 	// These function prevent t_string creation in case of c["a"] == "b" comparisons.
 	// The templates are needed to prevent using these function in case of c["a"] == 0 comparisons.
 	template<typename T>
@@ -187,7 +188,7 @@ public:
 	std::enable_if_t<std::is_same_v<const char*, T>, bool>
 		friend operator==(const config_attribute_value& val, T str)
 	{
-		return val.equals(std::string(str));
+		return val.equals(str);
 	}
 
 	template<typename T>
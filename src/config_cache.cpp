@@ -29,6 +29,8 @@
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
 
+#include <set>
+
 static lg::log_domain log_cache("cache");
 #define ERR_CACHE LOG_STREAM(err, log_cache)
 #define LOG_CACHE LOG_STREAM(info, log_cache)
@@ -65,8 +67,10 @@ config_cache::config_cache()
 	: force_valid_cache_(false)
 	, use_cache_(true)
 	, fake_invalid_cache_(false)
+	, cache_format_(compression::format::gzip)
 	, defines_map_()
 	, cache_file_prefix_("cache-v" + boost::algorithm::replace_all_copy(game_config::revision, ":", "_") + "-")
+	, define_file_hashes_()
 {
 	// To set-up initial defines map correctly
 	clear_defines();
@@ -95,11 +99,34 @@ void config_cache::get_config(const std::string& file_path, config& cfg, abstrac
 	load_configs(file_path, cfg, validator);
 }
 
+namespace
+{
+/** The compression of a cache file, as given by its extension. */
+compression::format cache_file_format(const std::string& file_path)
+{
+	if(filesystem::ends_with(file_path, compression::format_extension(compression::format::gzip))) {
+		return compression::format::gzip;
+	} else if(filesystem::ends_with(file_path, compression::format_extension(compression::format::bzip2))) {
+		return compression::format::bzip2;
+	}
+
+	return compression::format::none;
+}
+
+std::unique_ptr<config_writer> make_cache_writer(std::ostream& out, compression::format format)
+{
+	if(format == compression::format::gzip) {
+		return std::make_unique<config_writer>(out, true, game_config::cache_compression_level);
+	}
+
+	return std::make_unique<config_writer>(out, format);
+}
+} // end anon namespace
+
 void config_cache::write_file(std::string file_path, const config& cfg)
 {
 	filesystem::scoped_ostream stream = filesystem::ostream_file(file_path);
-	config_writer writer(*stream, true, game_config::cache_compression_level);
-	writer.write(cfg);
+	make_cache_writer(*stream, cache_file_format(file_path))->write(cfg);
 }
 
 void config_cache::write_file(std::string file_path, const preproc_map& defines)
@@ -112,18 +139,29 @@ void config_cache::write_file(std::string file_path, const preproc_map& defines)
 	}
 
 	filesystem::scoped_ostream stream = filesystem::ostream_file(file_path);
-	config_writer writer(*stream, true, game_config::cache_compression_level);
+	std::unique_ptr<config_writer> writer = make_cache_writer(*stream, cache_file_format(file_path));
 
 	// Write all defines to stream.
 	for(const preproc_map::value_type& define : defines) {
-		define.second.write(writer, define.first);
+		define.second.write(*writer, define.first);
 	}
 }
 
 void config_cache::read_file(const std::string& file_path, config& cfg)
 {
 	filesystem::scoped_istream stream = filesystem::istream_file(file_path);
-	read_gz(cfg, *stream);
+
+	switch(cache_file_format(file_path)) {
+	case compression::format::gzip:
+		read_gz(cfg, *stream);
+		break;
+	case compression::format::bzip2:
+		read_bz2(cfg, *stream);
+		break;
+	case compression::format::none:
+		read(cfg, *stream);
+		break;
+	}
 }
 
 preproc_map& config_cache::make_copy_map()
@@ -140,16 +178,107 @@ void config_cache::add_defines_map_diff(preproc_map& defines_map)
 	return config_cache_transaction::instance().add_defines_map_diff(defines_map);
 }
 
-void config_cache::read_configs(const std::string& file_path, config& cfg, preproc_map& defines_map, abstract_validator* validator)
+void config_cache::read_configs(const std::string& file_path, config& cfg, preproc_map& defines_map, abstract_validator* validator,
+		std::vector<std::string>* included_files)
 {
 	//read the file and then write to the cache
-	filesystem::scoped_istream stream = preprocess_file(file_path, &defines_map);
+	filesystem::scoped_istream stream = preprocess_file_async(file_path, &defines_map, included_files);
 	read(cfg, *stream, validator);
 }
 
+namespace
+{
+void write_file_stamp(config& cfg, const std::string& path)
+{
+	cfg["name"] = path;
+	cfg["modified"] = filesystem::file_modified_time(path);
+
+	if(!filesystem::is_directory(path)) {
+		cfg["size"] = filesystem::file_size(path);
+	}
+}
+
+bool file_stamp_matches(const config& cfg)
+{
+	const std::string& path = cfg["name"];
+
+	if(cfg["modified"].to_time_t() != filesystem::file_modified_time(path)) {
+		return false;
+	}
+
+	// Directories have no size, their modification time covers added and removed files.
+	return !cfg.has_attribute("size") || cfg["size"].to_int() == filesystem::file_size(path);
+}
+} // end anon namespace
+
+const std::string& config_cache::define_file_hash(const std::string& path)
+{
+	auto iter = define_file_hashes_.find(path);
+
+	if(iter == define_file_hashes_.end()) {
+		iter = define_file_hashes_.emplace(path, utils::md5(filesystem::read_file(path)).hex_digest()).first;
+	}
+
+	return iter->second;
+}
+
+void config_cache::write_dependencies(config& checksum_cfg, const std::vector<std::string>& included_files)
+{
+	// A file may be included more than once.
+	const std::set<std::string> files(included_files.begin(), included_files.end());
+
+	for(const std::string& path : files) {
+		write_file_stamp(checksum_cfg.add_child("file"), path);
+	}
+
+	// The macros defined by the caches loaded earlier in this transaction.
+	for(const std::string& path : config_cache_transaction::instance().get_define_files()) {
+		config& define_cfg = checksum_cfg.add_child("define_file");
+		define_cfg["name"] = path;
+		define_cfg["hash"] = define_file_hash(path);
+	}
+}
+
+bool config_cache::dependencies_unchanged(const config& checksum_cfg)
+{
+	const auto files = checksum_cfg.child_range("file");
+
+	// An empty list is a checksum from before dependencies were recorded.
+	if(files.empty()) {
+		return false;
+	}
+
+	for(const config& file : files) {
+		if(!file_stamp_matches(file)) {
+			DBG_CACHE << "modified since the cache was written: " << file["name"];
+			return false;
+		}
+	}
+
+	const std::vector<std::string>& define_files = config_cache_transaction::instance().get_define_files();
+	const auto recorded = checksum_cfg.child_range("define_file");
+
+	if(static_cast<std::size_t>(recorded.size()) != define_files.size()) {
+		return false;
+	}
+
+	auto define_file = define_files.begin();
+
+	for(const config& define_cfg : recorded) {
+		const std::string& path = *define_file++;
+
+		if(define_cfg["name"] != path || define_cfg["hash"] != define_file_hash(path)) {
+			DBG_CACHE << "macros changed since the cache was written: " << path;
+			return false;
+		}
+	}
+
+	return true;
+}
+
 void config_cache::read_cache(const std::string& file_path, config& cfg, abstract_validator* validator)
 {
-	static const std::string extension = ".gz";
+	const std::string extension = compression::format_extension(cache_format_);
 
 	std::stringstream defines_string;
 	defines_string << file_path;
@@ -182,7 +311,7 @@ void config_cache::read_cache(const std::string& file_path, config& cfg, abstrac
 								  utils::md5(defines_string.str()).hex_digest();
 		const std::string fname_checksum = fname + ".checksum" + extension;
 
-		filesystem::file_tree_checksum dir_checksum;
+		bool checksum_valid = false;
 
 		if(!force_valid_cache_ && !fake_invalid_cache_) {
 			try {
@@ -192,7 +321,7 @@ void config_cache::read_cache(const std::string& file_path, config& cfg, abstrac
 					DBG_CACHE << "Reading checksum: " << fname_checksum;
 					read_file(fname_checksum, checksum_cfg);
 
-					dir_checksum = filesystem::file_tree_checksum(checksum_cfg);
+					checksum_valid = dependencies_unchanged(checksum_cfg);
 				}
 			} catch(const config::error&) {
 				ERR_CACHE << "cache checksum is corrupt";
@@ -207,7 +336,7 @@ void config_cache::read_cache(const std::string& file_path, config& cfg, abstrac
 			LOG_CACHE << "skipping cache validation (forced)";
 		}
 
-		if(filesystem::file_exists(fname + extension) && (force_valid_cache_ || (dir_checksum == filesystem::data_tree_checksum()))) {
+		if(filesystem::file_exists(fname + extension) && (force_valid_cache_ || checksum_valid)) {
 			LOG_CACHE << "found valid cache at '" << fname << extension << "' with defines_map " << defines_string.str();
 			log_scope("read cache");
 
@@ -227,6 +356,9 @@ void config_cache::read_cache(const std::string& file_path, config& cfg, abstrac
 			} catch (const boost::iostreams::gzip_error& e) {
 				//read_file -> ... -> read_gz can throw this exception.
 				ERR_CACHE << "cache " << fname << extension << " is corrupt. Error code: " << e.error();
+			} catch(const std::ios_base::failure&) {
+				//read_file -> ... -> read_bz2 can throw this exception.
+				ERR_CACHE << "error reading cache " << fname << extension << ". Loading from files";
 			}
 		}
 
@@ -236,17 +368,27 @@ void config_cache::read_cache(const std::string& file_path, config& cfg, abstrac
 		read_defines_queue();
 
 		preproc_map copy_map(make_copy_map());
+		std::vector<std::string> included_files;
 
-		read_configs(file_path, cfg, copy_map, validator);
+		read_configs(file_path, cfg, copy_map, validator, &included_files);
 		add_defines_map_diff(copy_map);
 
 		try {
-			write_file(fname + extension, cfg);
-			write_file(fname + ".define" + extension, copy_map);
+			const std::string define_file = fname + ".define" + extension;
 
+			// Taken before this cache's own define file joins the transaction.
 			config checksum_cfg;
+			write_dependencies(checksum_cfg, included_files);
+
+			write_file(fname + extension, cfg);
+			write_file(define_file, copy_map);
+			define_file_hashes_.erase(define_file);
+
+			// Queue it like on a cache hit, so later caches record the same define files either way.
+			if(filesystem::file_exists(define_file)) {
+				config_cache_transaction::instance().add_define_file(define_file);
+			}
 
-			filesystem::data_tree_checksum().write(checksum_cfg);
 			write_file(fname_checksum, checksum_cfg);
 		} catch(const filesystem::io_exception&) {
 			ERR_CACHE << "could not write to cache '" << fname << "'";
@@ -315,9 +457,14 @@ void config_cache::set_force_valid_cache(bool force)
 	force_valid_cache_ = force;
 }
 
+void config_cache::set_cache_format(compression::format format)
+{
+	cache_format_ = format;
+}
+
 void config_cache::recheck_filetree_checksum()
 {
-	filesystem::data_tree_checksum(true);
+	define_file_hashes_.clear();
 }
 
 void config_cache::add_define(const std::string& define)
@@ -24,6 +24,7 @@
 #include <list>
 #include <memory>
 
+#include "serialization/compression.hpp"
 #include "serialization/preprocessor.hpp"
 
 class config;
@@ -83,10 +84,10 @@ typedef scoped_preproc_define_internal<config_cache> scoped_preproc_define;
 
 /**
  * Singleton class to manage game config file caching.
- * It uses paths to config files as key to find correct cache
- * @todo Make smarter filetree checksum caching so only required parts
- *       of tree are checked at startup. Trees are overlapping so have
- *       to split trees to subtrees to only do check once per file.
+ * It uses paths to config files as key to find correct cache.
+ * Each cache remembers the files it was preprocessed from and the macro
+ * caches it was built on, so changing an add-on only invalidates the caches
+ * that actually read it.
  * @todo Make cache system easily allow validation of in memory cache objects
  *       using hash checksum of preproc_map.
  **/
@@ -136,6 +137,12 @@ public:
 	 */
 	void set_force_valid_cache(bool force);
 
+	/**
+	 * Set the compression used for newly written cache files.
+	 * An uncompressed cache takes more disk space but skips decompression on every cache hit.
+	 */
+	void set_cache_format(compression::format format);
+
 	/**
 	 * Force cache checksum validation.
 	 */
@@ -155,22 +162,33 @@ private:
 	bool force_valid_cache_;
 	bool use_cache_;
 	bool fake_invalid_cache_;
+	compression::format cache_format_;
 
 	preproc_map defines_map_;
 
 	std::string cache_file_prefix_;
 
+	/** Content hashes of the define files checked so far, by path. */
+	std::map<std::string, std::string> define_file_hashes_;
+
 	void read_file(const std::string& file, config& cfg);
 	void write_file(std::string file, const config& cfg);
 	void write_file(std::string file, const preproc_map& defines);
 
 	void read_cache(const std::string& path, config& cfg, abstract_validator* validator = nullptr);
 
-	void read_configs(const std::string& path, config& cfg, preproc_map& defines, abstract_validator* validator = nullptr);
+	void read_configs(const std::string& path, config& cfg, preproc_map& defines, abstract_validator* validator = nullptr,
+		std::vector<std::string>* included_files = nullptr);
 	void load_configs(const std::string& path, config& cfg, abstract_validator* validator = nullptr);
 	void read_defines_queue();
 	void read_defines_file(const std::string& path);
 
+	/** Records what a cache built now depends on: the @a included_files and the queued define files. */
+	void write_dependencies(config& checksum_cfg, const std::vector<std::string>& included_files);
+	/** Whether nothing recorded by write_dependencies() changed since. */
+	bool dependencies_unchanged(const config& checksum_cfg);
+	const std::string& define_file_hash(const std::string& path);
+
 	preproc_map& make_copy_map();
 	void add_defines_map_diff(preproc_map&);
 
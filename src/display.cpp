@@ -42,6 +42,7 @@
 #include "play_controller.hpp" //note: this can probably be refactored out
 #include "reports.hpp"
 #include "resources.hpp"
+#include "sdl/utils.hpp"
 #include "show_dialog.hpp"
 #include "synced_context.hpp"
 #include "team.hpp"
@@ -53,6 +54,8 @@
 #include "units/animation_component.hpp"
 #include "units/drawer.hpp"
 #include "units/orb_status.hpp"
+#include "utils/frame_profiler.hpp"
+#include "utils/general.hpp"
 #include "video.hpp"
 #include "whiteboard/manager.hpp"
 
@@ -135,6 +138,27 @@ void display::parse_team_overlays()
 }
 
 
+bool display::overlay_visible_to_viewer(const std::string& team_names)
+{
+	// dont_show_all_ implies that viewing_team() is a valid index to get_teams()
+	const std::string& current_team_name = get_teams()[viewing_team()].team_name();
+	if(current_team_name != overlay_team_visibility_viewer_) {
+		overlay_team_visibility_.clear();
+		overlay_team_visibility_viewer_ = current_team_name;
+	}
+
+	auto [it, inserted] = overlay_team_visibility_.emplace(team_names, false);
+	if(inserted) {
+		const std::vector<std::string> current_team_names = utils::split(current_team_name);
+		const std::vector<std::string> names = utils::split(team_names);
+
+		it->second = std::find_first_of(names.begin(), names.end(),
+			current_team_names.begin(), current_team_names.end()) != names.end();
+	}
+
+	return it->second;
+}
+
 void display::add_overlay(const map_location& loc, const std::string& img, const std::string& halo, const std::string& team_name, const std::string& item_id, bool visible_under_fog, float submerge, float z_order)
 {
 	halo::handle halo_handle;
@@ -176,6 +200,8 @@ display::display(const display_context* dc,
 	, exclusive_unit_draw_requests_()
 	, currentTeam_(0)
 	, dont_show_all_(false)
+	, overlay_team_visibility_()
+	, overlay_team_visibility_viewer_()
 	, xpos_(0)
 	, ypos_(0)
 	, view_locked_(false)
@@ -185,6 +211,7 @@ display::display(const display_context* dc,
 	, builder_(new terrain_builder(level, (dc_ ? &dc_->map() : nullptr), theme_.border().tile_image, theme_.border().show_border))
 	, minimap_(nullptr)
 	, minimap_location_(sdl::empty_rect)
+	, minimap_state_()
 	, redraw_background_(false)
 	, invalidateAll_(true)
 	, diagnostic_label_(0)
@@ -197,7 +224,7 @@ display::display(const display_context* dc,
 	, fps_start_()
 	, fps_actual_()
 	, reportLocations_()
-	, reportSurfaces_()
+	, reportTexts_()
 	, reports_()
 	, menu_buttons_()
 	, action_buttons_()
@@ -475,17 +502,26 @@ const std::string& display::get_variant(const std::vector<std::string>& variants
 
 void display::rebuild_all()
 {
+	terrain_layer_cache_.clear();
 	builder_->rebuild_all();
 }
 
+void display::rebuild_region(const std::set<map_location>& locs)
+{
+	terrain_layer_cache_.clear();
+	builder_->rebuild_region(locs);
+}
+
 void display::reload_map()
 {
+	terrain_layer_cache_.clear();
 	redraw_background_ = true;
 	builder_->reload_map();
 }
 
 void display::change_display_context(const display_context * dc)
 {
+	terrain_layer_cache_.clear();
 	dc_ = dc;
 	builder_->change_map(&dc_->map()); //TODO: Should display_context own and initialize the builder object?
 }
@@ -790,27 +826,58 @@ surface display::screenshot(bool map_screenshot)
 		return nullptr;
 	}
 
-	// back up the current map view position and move to top-left
+	// back up the current map view position
 	int old_xpos = xpos_;
 	int old_ypos = ypos_;
-	xpos_ = 0;
-	ypos_ = 0;
 
-	// Reroute render output to a separate texture until the end of scope.
-	SDL_Rect area = max_map_area();
-	if (area.w > 1 << 16 || area.h > 1 << 16) {
-		WRN_DP << "Excessively large map screenshot area";
-	}
+	const SDL_Rect area = max_map_area();
 	LOG_DP << "creating " << area.w << " by " << area.h
-	       << " texture for map screenshot";
-	texture output_texture(area.w, area.h, SDL_TEXTUREACCESS_TARGET);
-	auto target_setter = draw::set_render_target(output_texture);
-	auto clipper = draw::override_clip(area);
+	       << " surface for map screenshot";
+	surface result(area.w, area.h);
+	if(!result) {
+		ERR_DP << "Could not allocate a surface for the map screenshot.";
+		return nullptr;
+	}
+
+	// Render the map a tile at a time, moving the viewport over each tile, so
+	// a large map doesn't need a render target the size of the whole map,
+	// which may be more than the renderer supports.
+	const int tile_size = 2048;
 
 	map_screenshot_ = true;
 
-	invalidate_locations_in_rect(map_area());
-	draw();
+	for(int tile_y = 0; tile_y < area.h; tile_y += tile_size) {
+		for(int tile_x = 0; tile_x < area.w; tile_x += tile_size) {
+			const int tile_w = std::min(tile_size, area.w - tile_x);
+			const int tile_h = std::min(tile_size, area.h - tile_y);
+
+			xpos_ = tile_x;
+			ypos_ = tile_y;
+
+			// Reroute render output to the tile until the end of scope.
+			texture tile_texture(tile_w, tile_h, SDL_TEXTUREACCESS_TARGET);
+			surface tile;
+			{
+				auto target_setter = draw::set_render_target(tile_texture);
+				auto clipper = draw::override_clip({0, 0, tile_w, tile_h});
+
+				// Hexes just outside the tile can still draw into it,
+				// for instance units taller than a hex.
+				const int margin = hex_size();
+				invalidate_locations_in_rect({-margin, -margin, tile_w + 2 * margin, tile_h + 2 * margin});
+				draw();
+
+				// Read rendered pixels back as an SDL surface.
+				tile = video::read_pixels();
+			}
+
+			if(tile) {
+				SDL_SetSurfaceBlendMode(tile, SDL_BLENDMODE_NONE);
+				SDL_Rect dst{tile_x, tile_y, 0, 0};
+				sdl_blit(tile, nullptr, result, &dst);
+			}
+		}
+	}
 
 	map_screenshot_ = false;
 
@@ -818,8 +885,7 @@ surface display::screenshot(bool map_screenshot)
 	xpos_ = old_xpos;
 	ypos_ = old_ypos;
 
-	// Read rendered pixels back as an SDL surface.
-	return video::read_pixels();
+	return result;
 }
 
 std::shared_ptr<gui::button> display::find_action_button(const std::string& id)
@@ -1175,6 +1241,24 @@ void display::get_terrain_images(const map_location& loc, const std::string& tim
 		}
 	}
 
+	// Reuse the textures from the last time this hex was drawn if nothing they depend on changed.
+	terrain_layer_cache_entry& cached = terrain_layer_cache_[loc];
+	if(cached.timeid != timeid || cached.light != lt) {
+		cached.timeid = timeid;
+		cached.light = lt;
+		cached.images = {};
+	} else if(cached.images[terrain_type]) {
+		terrain_image_vector_ = *cached.images[terrain_type];
+		return;
+	}
+
+	bool animated = false;
+
+	// A colour shift over the whole hex can be applied while drawing.
+	// That way only a silhouette of each image is needed instead of a
+	// coloured copy for every time of day.
+	const bool shift_on_draw = lt.size() == 4 && lt[0] == -1 && draw::color_shift_supported();
+
 	const terrain_builder::TERRAIN_TYPE builder_terrain_type = terrain_type == FOREGROUND
 		? terrain_builder::FOREGROUND
 		: terrain_builder::BACKGROUND;
@@ -1183,29 +1267,40 @@ void display::get_terrain_images(const map_location& loc, const std::string& tim
 		// Cache the offmap name. Since it is themeable it can change, so don't make it static.
 		const std::string off_map_name = "terrain/" + theme_.border().tile_image;
 		for(const auto& terrain : *terrains) {
+			animated = animated || !terrain.does_not_change();
+
 			const image::locator& image = animate_map_ ? terrain.get_current_frame() : terrain.get_first_frame();
 
 			// We prevent ToD coloring and brightening of off-map tiles,
 			// We need to test for the tile to be rendered and
 			// not the location, since the transitions are rendered
 			// over the offmap-terrain and these need a ToD coloring.
-			texture tex;
+			terrain_image img{};
 			const bool off_map = (image.get_filename() == off_map_name
 				|| image.get_modifications().find("NO_TOD_SHIFT()") != std::string::npos);
 
 			if(off_map) {
-				tex = image::get_texture(image, image::HEXED);
+				img.tex = image::get_terrain_texture(image);
 			} else if(lt.empty()) {
-				tex = image::get_texture(image, image::HEXED);
+				img.tex = image::get_terrain_texture(image);
+			} else if(shift_on_draw) {
+				// The light string stores halved values, see image::get_light_string().
+				img.tex = image::get_terrain_texture(image);
+				img.silhouette = image::get_terrain_silhouette(image);
+				img.shift = {lt[1] * 2, lt[2] * 2, lt[3] * 2};
 			} else {
-				tex = image::get_lighted_texture(image, lt);
+				img.tex = image::get_lighted_terrain_texture(image, lt);
 			}
 
-			if(tex) {
-				terrain_image_vector_.push_back(std::move(tex));
+			if(img.tex) {
+				terrain_image_vector_.push_back(std::move(img));
 			}
 		}
 	}
+
+	if(!animated) {
+		cached.images[terrain_type] = terrain_image_vector_;
+	}
 }
 
 namespace
@@ -1295,6 +1390,8 @@ void display::drawing_buffer_add(const drawing_layer layer, const map_location&
 
 void display::drawing_buffer_commit()
 {
+	PROFILE_SCOPE("display::drawing_buffer_commit");
+
 	// std::list::sort() is a stable sort
 	drawing_buffer_.sort();
 
@@ -1387,6 +1484,34 @@ void display::clear_fps_label()
 	}
 }
 
+rect display::frame_time_graph_area() const
+{
+	const rect& area = map_area();
+	const int height = 64;
+	return {area.x, area.y + area.h - height, int(util::frame_profiler::history_size), height};
+}
+
+void display::draw_frame_time_graph()
+{
+	const rect area = frame_time_graph_area();
+	draw::fill(area, 0, 0, 0, 160);
+
+	// Two pixels per millisecond, so the full height is 32ms.
+	const auto bar_height = [&area](int64_t us) { return std::min<int>(area.h, us / 500); };
+
+	int x = area.x + area.w - int(util::frame_profiler::get().frame_times().size());
+	for(const int64_t us : util::frame_profiler::get().frame_times()) {
+		const int h = bar_height(us);
+		const color_t col = us > 33333 ? color_t(255, 64, 64) : us > 16667 ? color_t(255, 200, 64) : color_t(64, 255, 64);
+		draw::fill(rect(x, area.y + area.h - h, 1, h), col);
+		++x;
+	}
+
+	// Mark the 60 fps frame budget.
+	const int budget_y = area.y + area.h - bar_height(16667);
+	draw::line(area.x, budget_y, area.x + area.w - 1, budget_y, {255, 255, 255, 128});
+}
+
 void display::draw_panel(const theme::panel& panel)
 {
 	// Most panels are transparent.
@@ -1648,11 +1773,59 @@ void display::recalculate_minimap()
 		return;
 	}
 
-	minimap_ = texture(image::getMinimap(
-		area.w, area.h, get_map(),
-		dc_->teams().empty() ? nullptr : &dc_->teams()[currentTeam_],
-		(selectedHex_.valid() && !is_blindfolded()) ? &reach_map_ : nullptr
-	));
+	const team* viewing_team = dc_->teams().empty() ? nullptr : &dc_->teams()[currentTeam_];
+	const reach_map* reach = (selectedHex_.valid() && !is_blindfolded()) ? &reach_map_ : nullptr;
+
+	// Many callers ask for a new minimap after actions that may not have changed
+	// anything it shows, so only render it again if its inputs differ.
+	std::vector<uint32_t> state {
+		static_cast<uint32_t>(area.w),
+		static_cast<uint32_t>(area.h),
+		preferences::minimap_draw_terrain(),
+		preferences::minimap_terrain_coding(),
+		preferences::minimap_draw_villages(),
+		preferences::minimap_movement_coding(),
+		static_cast<uint32_t>(std::hash<std::string>{}(preferences::unmoved_color() + ',' + preferences::enemy_color() + ',' + preferences::allied_color())),
+		is_blindfolded(),
+		static_cast<uint32_t>(currentTeam_),
+	};
+
+	const gamemap& map = get_map();
+	state.reserve(state.size() + 4 * (map.total_width() + 1) * (map.total_height() + 1));
+
+	for(int y = 0; y <= map.total_height(); ++y) {
+		for(int x = 0; x <= map.total_width(); ++x) {
+			const map_location loc(x, y);
+			if(!map.on_board_with_border(loc)) {
+				continue;
+			}
+
+			const t_translation::terrain_code terrain = map.get_terrain(loc);
+
+			uint32_t flags = 0;
+			if(viewing_team) {
+				flags |= viewing_team->shrouded(loc) ? 1 : 0;
+				flags |= viewing_team->fogged(loc) ? 2 : 0;
+			}
+
+			if(reach && reach->count(loc) != 0) {
+				flags |= 4;
+			}
+
+			state.push_back(terrain.base);
+			state.push_back(terrain.overlay);
+			state.push_back(flags);
+			state.push_back(map.is_village(loc) ? static_cast<uint32_t>(dc_->village_owner(loc)) : 0);
+		}
+	}
+
+	if(minimap_ && state == minimap_state_) {
+		redraw_minimap();
+		return;
+	}
+
+	minimap_ = texture(image::getMinimap(area.w, area.h, map, viewing_team, reach));
+	minimap_state_ = std::move(state);
 
 	redraw_minimap();
 }
@@ -1862,6 +2035,24 @@ bool display::scroll(int xmove, int ymove, bool force)
 		invalidate_locations_in_rect(r);
 	}
 
+	// Images of the hexes which will come into view if the scrolling goes on
+	// are decoded in the background meanwhile.
+	const int margin = 2 * hex_size();
+
+	if(diff_y != 0) {
+		SDL_Rect r = map_area();
+		r.y = diff_y < 0 ? r.y + r.h : r.y - margin;
+		r.h = margin;
+		prefetch_images_in_rect(r);
+	}
+
+	if(diff_x != 0) {
+		SDL_Rect r = map_area();
+		r.x = diff_x < 0 ? r.x + r.w : r.x - margin;
+		r.w = margin;
+		prefetch_images_in_rect(r);
+	}
+
 	scroll_event_.notify_observers();
 
 	redraw_minimap();
@@ -2332,7 +2523,7 @@ void display::queue_rerender()
 	invalidateGameStatus_ = true;
 
 	reportLocations_.clear();
-	reportSurfaces_.clear();
+	reportTexts_.clear();
 	reports_.clear();
 
 	bounds_check_position();
@@ -2394,6 +2585,8 @@ void display::draw()
 		DBG_DP << "display::draw denied";
 		return;
 	}
+
+	PROFILE_SCOPE("display::draw");
 	//DBG_DP << "display::draw";
 
 	// I have no idea why this is messing with sync context,
@@ -2434,11 +2627,17 @@ void display::update()
 	if(animate_water_ != preferences::animate_water()) {
 		animate_water_ = preferences::animate_water();
 		builder_->rebuild_cache_all();
+		terrain_layer_cache_.clear();
 	}
 
 	if(debug_flag_set(DEBUG_BENCHMARK)) {
 		invalidate_all();
 	}
+
+	// The frame time graph changes every frame.
+	if(util::frame_profiler::get().enabled()) {
+		draw_manager::invalidate_region(frame_time_graph_area());
+	}
 }
 
 void display::layout()
@@ -2540,6 +2739,10 @@ bool display::expose(const rect& region)
 		draw::fill(map_outside_area().intersect(region), fade_color_);
 	}
 
+	if(util::frame_profiler::get().enabled() && clipped_region.overlaps(frame_time_graph_area())) {
+		draw_frame_time_graph();
+	}
+
 	DBG_DP << "display::expose " << region;
 
 	// The display covers the entire screen.
@@ -2633,6 +2836,8 @@ rect display::get_clip_rect() const
 
 void display::draw_invalidated()
 {
+	PROFILE_SCOPE("display::draw_invalidated");
+
 	//	log_scope("display::draw_invalidated");
 	SDL_Rect clip_rect = get_clip_rect();
 	const auto clipper = draw::reduce_clip(clip_rect);
@@ -2688,8 +2893,11 @@ void display::draw_hex(const map_location& loc)
 		num_images_bg = terrain_image_vector_.size();
 
 		drawing_buffer_add(LAYER_TERRAIN_BG, loc, [images = std::exchange(terrain_image_vector_, {})](const rect& dest) {
-			for(const texture& t : images) {
-				draw::blit(t, dest);
+			for(const terrain_image& img : images) {
+				draw::blit(img.tex, dest);
+				if(img.silhouette) {
+					draw::color_shift(img.silhouette, dest, img.shift[0], img.shift[1], img.shift[2]);
+				}
 			}
 		});
 
@@ -2697,8 +2905,11 @@ void display::draw_hex(const map_location& loc)
 		num_images_fg = terrain_image_vector_.size();
 
 		drawing_buffer_add(LAYER_TERRAIN_BG, loc, [images = std::exchange(terrain_image_vector_, {})](const rect& dest) {
-			for(const texture& t : images) {
-				draw::blit(t, dest);
+			for(const terrain_image& img : images) {
+				draw::blit(img.tex, dest);
+				if(img.silhouette) {
+					draw::color_shift(img.silhouette, dest, img.shift[0], img.shift[1], img.shift[2]);
+				}
 			}
 		});
 
@@ -2726,24 +2937,17 @@ void display::draw_hex(const map_location& loc)
 			if(overlays.size() != 0) {
 				tod_color tod_col = tod.color + color_adjust_;
 				image::light_string lt = image::get_light_string(-1, tod_col.r, tod_col.g, tod_col.b);
+				const bool is_fogged = fogged(loc);
 
 				for(const overlay& ov : overlays) {
-					bool item_visible_for_team = true;
-					if(dont_show_all_ && !ov.team_name.empty()) {
-						// dont_show_all_ imples that viewing_team() is a valid index to get_teams()
-						const std::string& current_team_name = get_teams()[viewing_team()].team_name();
-						const std::vector<std::string>& current_team_names = utils::split(current_team_name);
-						const std::vector<std::string>& team_names = utils::split(ov.team_name);
-
-						item_visible_for_team = std::find_first_of(team_names.begin(), team_names.end(),
-							current_team_names.begin(), current_team_names.end()) != team_names.end();
-					}
+					const bool item_visible_for_team = !dont_show_all_ || ov.team_name.empty()
+						|| overlay_visible_to_viewer(ov.team_name);
 
-					if(item_visible_for_team && !(fogged(loc) && !ov.visible_in_fog)) {
-						point isize = image::get_size(ov.image, image::HEXED);
+					if(item_visible_for_team && !(is_fogged && !ov.visible_in_fog)) {
 						std::string ipf = ov.image;
 
 						if(ov.submerge) {
+							point isize = image::get_size(ov.image, image::HEXED);
 							// Adjust submerge appropriately
 							double sub = submerge * ov.submerge;
 							// Shift the image so the waterline remains static.
@@ -2929,6 +3133,7 @@ void display::refresh_report(const std::string& report_name, const config * new_
 	// Update the config and current location.
 	report = *new_cfg;
 	loc = new_loc;
+	reportTexts_.erase(report_name);
 
 	// Not 100% sure this is okay
 	// but it seems to be working so i'm not changing it.
@@ -2979,6 +3184,11 @@ void display::draw_report(const std::string& report_name, bool tooltip_test)
 	std::ostringstream ellipsis_tooltip;
 	SDL_Rect ellipsis_area = loc;
 
+	// The text elements only need laying out and rendering again after the
+	// report changed, which clears this.
+	std::vector<report_text>* text_cache = tooltip_test ? nullptr : &reportTexts_[report_name];
+	std::size_t text_index = 0;
+
 	for (config::const_child_itors elements = report.child_range("element");
 		 elements.begin() != elements.end(); elements.pop_front())
 	{
@@ -2991,7 +3201,6 @@ void display::draw_report(const std::string& report_name, bool tooltip_test)
 			if (used_ellipsis) goto skip_element;
 
 			// Draw a text element.
-			font::pango_text& text = font::get_text_renderer();
 			bool eol = false;
 			if (t[t.size() - 1] == '\n') {
 				eol = true;
@@ -3004,44 +3213,62 @@ void display::draw_report(const std::string& report_name, bool tooltip_test)
 				// is requested with get_size(). Hence this check.
 				continue;
 			}
-			text.set_link_aware(false)
-				.set_text(t, true);
-			text.set_family_class(font::FONT_SANS_SERIF)
-				.set_font_size(item->font_size())
-				.set_font_style(font::pango_text::STYLE_NORMAL)
-				.set_alignment(PANGO_ALIGN_LEFT)
-				.set_foreground_color(item->font_rgb_set() ? item->font_rgb() : font::NORMAL_COLOR)
-				.set_maximum_width(area.w)
-				.set_maximum_height(area.h, false)
-				.set_ellipse_mode(PANGO_ELLIPSIZE_END)
-				.set_characters_per_line(0);
-
-			point tsize = text.get_size();
-
-			// check if next element is text with almost no space to show it
-			const int minimal_text = 12; // width in pixels
-			config::const_child_iterator ee = elements.begin();
-			if (!eol && loc.w - (x - loc.x + tsize.x) < minimal_text &&
-				++ee != elements.end() && !(*ee)["text"].empty())
-			{
-				// make this element longer to trigger rendering of ellipsis
-				// (to indicate that next elements have not enough space)
-				//NOTE this space should be longer than minimal_text pixels
-				t = t + "    ";
-				text.set_text(t, true);
-				tsize = text.get_size();
+
+			report_text laid_out_now;
+			const report_text* laid_out = nullptr;
+			if (text_cache && text_index < text_cache->size()) {
+				laid_out = &(*text_cache)[text_index];
+			} else {
+				font::pango_text& text = font::get_text_renderer();
+				text.set_link_aware(false)
+					.set_text(t, true);
+				text.set_family_class(font::FONT_SANS_SERIF)
+					.set_font_size(item->font_size())
+					.set_font_style(font::pango_text::STYLE_NORMAL)
+					.set_alignment(PANGO_ALIGN_LEFT)
+					.set_foreground_color(item->font_rgb_set() ? item->font_rgb() : font::NORMAL_COLOR)
+					.set_maximum_width(area.w)
+					.set_maximum_height(area.h, false)
+					.set_ellipse_mode(PANGO_ELLIPSIZE_END)
+					.set_characters_per_line(0);
+
+				laid_out_now.size = text.get_size();
+				laid_out_now.ellipsis = false;
+
+				// check if next element is text with almost no space to show it
+				const int minimal_text = 12; // width in pixels
+				config::const_child_iterator ee = elements.begin();
+				if (!eol && loc.w - (x - loc.x + laid_out_now.size.x) < minimal_text &&
+					++ee != elements.end() && !(*ee)["text"].empty())
+				{
+					// make this element longer to trigger rendering of ellipsis
+					// (to indicate that next elements have not enough space)
+					//NOTE this space should be longer than minimal_text pixels
+					t = t + "    ";
+					text.set_text(t, true);
+					laid_out_now.size = text.get_size();
+					laid_out_now.ellipsis = true;
+				}
+
+				if (text_cache) {
+					laid_out_now.tex = text.render_and_get_texture();
+					text_cache->push_back(std::move(laid_out_now));
+					laid_out = &text_cache->back();
+				} else {
+					laid_out = &laid_out_now;
+				}
+			}
+			++text_index;
+
+			area.w = laid_out->size.x;
+			area.h = laid_out->size.y;
+			if (laid_out->ellipsis) {
 				// use the area of this element for next tooltips
 				used_ellipsis = true;
-				ellipsis_area.x = x;
-				ellipsis_area.y = y;
-				ellipsis_area.w = tsize.x;
-				ellipsis_area.h = tsize.y;
+				ellipsis_area = area;
 			}
-
-			area.w = tsize.x;
-			area.h = tsize.y;
 			if (!tooltip_test) {
-				draw::blit(text.render_and_get_texture(), area);
+				draw::blit(laid_out->tex, area);
 			}
 			if (area.h > tallest) {
 				tallest = area.h;
@@ -3206,6 +3433,30 @@ bool display::invalidate_locations_in_rect(const SDL_Rect& rect)
 	return result;
 }
 
+void display::prefetch_images_in_rect(const SDL_Rect& rect)
+{
+	for(const map_location& loc : hexes_under_rect(rect)) {
+		if(!get_map().on_board_with_border(loc) || shrouded(loc)) {
+			continue;
+		}
+
+		const std::string& timeid = get_time_of_day(loc).id;
+
+		for(const auto terrain_type : {terrain_builder::BACKGROUND, terrain_builder::FOREGROUND}) {
+			const terrain_builder::imagelist* const terrains = builder_->get_terrain_at(loc, timeid, terrain_type);
+			if(!terrains) {
+				continue;
+			}
+
+			for(const auto& terrain : *terrains) {
+				for(std::size_t n = 0; n < terrain.get_frames_count(); ++n) {
+					image::prefetch(terrain.get_frame(n));
+				}
+			}
+		}
+	}
+}
+
 void display::invalidate_animations_location(const map_location& loc)
 {
 	if(get_map().is_village(loc)) {
@@ -3219,6 +3470,8 @@ void display::invalidate_animations_location(const map_location& loc)
 
 void display::invalidate_animations()
 {
+	PROFILE_SCOPE("display::invalidate_animations");
+
 	// There are timing issues with this, but i'm not touching it.
 	new_animation_frame();
 	animate_map_ = preferences::animate_map();
@@ -3241,16 +3494,33 @@ void display::invalidate_animations()
 		u->anim_comp().refresh();
 	}
 
-	bool new_inval;
-	do {
-		new_inval = false;
-		for(const unit& u : dc_->units()) {
-			new_inval |= u.anim_comp().invalidate(*this);
+	// The first pass invalidates every animation that changed. Later passes
+	// propagate invalidation to animations overlapping the invalidated hexes,
+	// which only on-screen animations not yet invalidated can be affected by,
+	// so only those are visited again.
+	std::vector<const unit*> pending;
+	bool new_inval = false;
+	const auto first_pass = [&](const unit& u) {
+		new_inval |= u.anim_comp().invalidate(*this);
+		if(u.anim_comp().may_propagate()) {
+			pending.push_back(&u);
 		}
-		for(const unit* u : *fake_unit_man_) {
+	};
+
+	for(const unit& u : dc_->units()) {
+		first_pass(u);
+	}
+	for(const unit* u : *fake_unit_man_) {
+		first_pass(*u);
+	}
+
+	while(new_inval && !pending.empty()) {
+		new_inval = false;
+		utils::erase_if(pending, [&](const unit* u) {
 			new_inval |= u->anim_comp().invalidate(*this);
-		}
-	} while(new_inval);
+			return !u->anim_comp().may_propagate();
+		});
+	}
 
 	halo_man_.update();
 }
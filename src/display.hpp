@@ -68,6 +68,7 @@ namespace wb {
 
 #include <boost/circular_buffer.hpp>
 
+#include <array>
 #include <bitset>
 #include <functional>
 #include <chrono>
@@ -76,6 +77,7 @@ namespace wb {
 #include <list>
 #include <map>
 #include <memory>
+#include <optional>
 #include <vector>
 
 class gamemap;
@@ -430,6 +432,9 @@ public:
 	bool invalidate_locations_in_rect(const SDL_Rect& rect);
 	bool invalidate_visible_locations_in_rect(const SDL_Rect& rect);
 
+	/** Starts decoding the terrain images of the hexes under the rectangle rect (in screen coordinates) */
+	void prefetch_images_in_rect(const SDL_Rect& rect);
+
 	/**
 	 * Function to invalidate animated terrains and units which may have changed.
 	 */
@@ -449,9 +454,18 @@ public:
 	void clear_fps_label();
 	void update_fps_count();
 
+	/** Where the --frame-trace frame time graph is drawn. */
+	rect frame_time_graph_area() const;
+
+	/** Draws the recent frame times recorded by util::frame_profiler. */
+	void draw_frame_time_graph();
+
 	/** Rebuild all dynamic terrain. */
 	void rebuild_all();
 
+	/** Rebuild the dynamic terrain around the given changed locations. */
+	void rebuild_region(const std::set<map_location>& locs);
+
 	const theme::action* action_pressed();
 	const theme::menu*   menu_pressed();
 
@@ -706,8 +720,19 @@ protected:
 
 	static const std::string& get_variant(const std::vector<std::string>& variants, const map_location &loc);
 
+	/**
+	 * Whether an overlay restricted to the comma-separated @a team_names is
+	 * shown to the viewing team. Results are cached per list until the
+	 * viewing team's own names change.
+	 */
+	bool overlay_visible_to_viewer(const std::string& team_names);
+
 	std::size_t currentTeam_;
 	bool dont_show_all_; //const team *viewpoint_;
+
+	/** Cache for overlay_visible_to_viewer(), valid for the team names below. */
+	std::map<std::string, bool> overlay_team_visibility_;
+	std::string overlay_team_visibility_viewer_;
 	/**
 	 * Position of the top-left corner of the viewport, in pixels.
 	 *
@@ -729,6 +754,8 @@ protected:
 	const std::unique_ptr<terrain_builder> builder_;
 	texture minimap_;
 	SDL_Rect minimap_location_;
+	/** Everything minimap_ was rendered from, see recalculate_minimap(). */
+	std::vector<uint32_t> minimap_state_;
 	bool redraw_background_;
 	bool invalidateAll_;
 	int diagnostic_label_;
@@ -748,7 +775,18 @@ protected:
 
 	// Not set by the initializer:
 	std::map<std::string, rect> reportLocations_;
-	std::map<std::string, texture> reportSurfaces_;
+
+	/** A text element of a report, as last laid out and rendered by draw_report. */
+	struct report_text
+	{
+		texture tex;
+		point size;
+		/** Whether the element was widened to show an ellipsis for the ones after it. */
+		bool ellipsis;
+	};
+
+	/** Rendered text elements of each report, reused by redraws until the report changes. */
+	std::map<std::string, std::vector<report_text>> reportTexts_;
 	std::map<std::string, config> reports_;
 	std::vector<std::shared_ptr<gui::button>> menu_buttons_, action_buttons_;
 	std::set<map_location> invalidated_;
@@ -778,9 +816,35 @@ private:
 	/** Animated flags for each team */
 	std::vector<animated<image::locator>> flags_;
 
+	/**
+	 * A terrain image ready to draw. If the hex's time of day colour is
+	 * applied while drawing, @a silhouette is set and @a shift holds the
+	 * offset to add with draw::color_shift().
+	 */
+	struct terrain_image
+	{
+		texture tex;
+		texture silhouette;
+		std::array<int, 3> shift;
+	};
+
 	// This vector is a class member to avoid repeated memory allocations in get_terrain_images(),
 	// which turned out to be a significant bottleneck while profiling.
-	std::vector<texture> terrain_image_vector_;
+	std::vector<terrain_image> terrain_image_vector_;
+
+	/**
+	 * Terrain textures of a hex, reused by get_terrain_images() as long as
+	 * the hex's time of day and lighting stay the same. Animated terrain is
+	 * never stored here. Cleared whenever the terrain graphics are rebuilt.
+	 */
+	struct terrain_layer_cache_entry
+	{
+		std::string timeid;
+		image::light_string light;
+		std::array<std::optional<std::vector<terrain_image>>, 2> images;
+	};
+
+	std::map<map_location, terrain_layer_cache_entry> terrain_layer_cache_;
 
 public:
 	/**
@@ -25,6 +25,9 @@
 #include <SDL2/SDL_rect.h>
 #include <SDL2/SDL_render.h>
 
+#include <algorithm>
+#include <cstdlib>
+
 static lg::log_domain log_draw("draw");
 #define DBG_D LOG_STREAM(debug, log_draw)
 #define WRN_D LOG_STREAM(warn, log_draw)
@@ -253,35 +256,43 @@ void draw::disc(int cx, int cy, int r, uint8_t octants)
 	int x = r;
 	int y = 0;
 
+	// Every segment is a horizontal or vertical line, so the whole disc
+	// is drawn as one batch of filled rectangles.
+	std::vector<SDL_Rect> spans;
+	auto span = [&spans](int x1, int y1, int x2, int y2) {
+		spans.push_back({std::min(x1, x2), std::min(y1, y2),
+			std::abs(x2 - x1) + 1, std::abs(y2 - y1) + 1});
+	};
+
 	while(!(y > x)) {
 		// I use the formula of Bresenham's line algorithm
 		// to determine the boundaries of a segment.
 		// The slope of the line is always 1 or -1 in this case.
 		if(octants & 0x04)
 			// x2 - 1 = y2 - (cy + 1) + cx
-			draw::line(cx + x, cy + y + 1, cx + y + 1, cy + y + 1);
+			span(cx + x, cy + y + 1, cx + y + 1, cy + y + 1);
 		if(octants & 0x02)
 			// x2 - 1 = cy - y2 + cx
-			draw::line(cx + x, cy - y, cx + y + 1, cy - y);
+			span(cx + x, cy - y, cx + y + 1, cy - y);
 		if(octants & 0x20)
 			// x2 + 1 = (cy + 1) - y2 + (cx - 1)
-			draw::line(cx - x - 1, cy + y + 1, cx - y - 2, cy + y + 1);
+			span(cx - x - 1, cy + y + 1, cx - y - 2, cy + y + 1);
 		if(octants & 0x40)
 			// x2 + 1 = y2 - cy + (cx - 1)
-			draw::line(cx - x - 1, cy - y, cx - y - 2, cy - y);
+			span(cx - x - 1, cy - y, cx - y - 2, cy - y);
 
 		if(octants & 0x08)
 			// y2 = x2 - cx + (cy + 1)
-			draw::line(cx + y, cy + x + 1, cx + y, cy + y + 1);
+			span(cx + y, cy + x + 1, cx + y, cy + y + 1);
 		if(octants & 0x01)
 			// y2 = cx - x2 + cy
-			draw::line(cx + y, cy - x, cx + y, cy - y);
+			span(cx + y, cy - x, cx + y, cy - y);
 		if(octants & 0x10)
 			// y2 = (cx - 1) - x2 + (cy + 1)
-			draw::line(cx - y - 1, cy + x + 1, cx - y - 1, cy + y + 1);
+			span(cx - y - 1, cy + x + 1, cx - y - 1, cy + y + 1);
 		if(octants & 0x80)
 			// y2 = x2 - (cx - 1) + cy
-			draw::line(cx - y - 1, cy - x, cx - y - 1, cy - y);
+			span(cx - y - 1, cy - x, cx - y - 1, cy - y);
 
 		d += 2 * y + 1;
 		++y;
@@ -290,6 +301,8 @@ void draw::disc(int cx, int cy, int r, uint8_t octants)
 			--x;
 		}
 	}
+
+	SDL_RenderFillRects(renderer(), spans.data(), spans.size());
 }
 
 
@@ -319,6 +332,58 @@ void draw::blit(const texture& tex)
 }
 
 
+/** dst = dst - src * src_alpha on the colour channels, leaving alpha alone. */
+static SDL_BlendMode subtractive_blend_mode()
+{
+	static const SDL_BlendMode mode = SDL_ComposeCustomBlendMode(
+		SDL_BLENDFACTOR_SRC_ALPHA, SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_REV_SUBTRACT,
+		SDL_BLENDFACTOR_ZERO, SDL_BLENDFACTOR_ONE, SDL_BLENDOPERATION_ADD);
+	return mode;
+}
+
+void draw::color_shift(const texture& silhouette, const SDL_Rect& dst, int r, int g, int b)
+{
+	if (!silhouette) { DBG_D << "null color shift"; return; }
+	DBG_D << "color shift " << dst << " by " << r << ',' << g << ',' << b;
+
+	const auto channel = [](int c) { return static_cast<uint8_t>(std::clamp(c, 0, 255)); };
+	SDL_Texture* tex = silhouette;
+
+	// Brighten the positive channels and darken the negative ones in
+	// separate passes. Blending clamps to the valid range just like
+	// adjusting the colour of the image itself would.
+	if (r > 0 || g > 0 || b > 0) {
+		SDL_SetTextureColorMod(tex, channel(r), channel(g), channel(b));
+		SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_ADD);
+		SDL_RenderCopy(renderer(), tex, silhouette.src(), &dst);
+	}
+
+	if (r < 0 || g < 0 || b < 0) {
+		SDL_SetTextureColorMod(tex, channel(-r), channel(-g), channel(-b));
+		SDL_SetTextureBlendMode(tex, subtractive_blend_mode());
+		SDL_RenderCopy(renderer(), tex, silhouette.src(), &dst);
+	}
+
+	SDL_SetTextureColorMod(tex, 255, 255, 255);
+	SDL_SetTextureBlendMode(tex, SDL_BLENDMODE_BLEND);
+}
+
+bool draw::color_shift_supported()
+{
+	static const bool supported = [] {
+		if (!renderer()) {
+			return false;
+		}
+
+		texture test(1, 1, SDL_TEXTUREACCESS_STATIC);
+		const bool res = test && SDL_SetTextureBlendMode(test, subtractive_blend_mode()) == 0;
+		DBG_D << "subtractive blending " << (res ? "supported" : "not supported");
+		return res;
+	}();
+
+	return supported;
+}
+
 static SDL_RendererFlip get_flip(bool flip_h, bool flip_v)
 {
 	// This should be easier than it is.
@@ -276,6 +276,29 @@ void tiled_highres(const texture& tex,
 	bool mirrored = false
 );
 
+/**
+ * Adds a colour offset to what has been drawn under a texture's shape.
+ *
+ * Blitting a texture and then shifting its silhouette gives the same result
+ * as blitting a copy of the texture with the offset added to its colour, so
+ * time of day colouring can be applied while drawing instead of by making
+ * recoloured copies of the images.
+ *
+ * Negative offsets use a subtractive blend mode not every renderer has,
+ * check color_shift_supported() first.
+ *
+ * @param silhouette  A white texture of the shape to shift, such as
+ *                    image::get_terrain_silhouette(). Only its alpha is used.
+ * @param dst         Where the shape was drawn.
+ * @param r           Offset added to the red channel, from -255 to 255.
+ * @param g           Offset added to the green channel, from -255 to 255.
+ * @param b           Offset added to the blue channel, from -255 to 255.
+ */
+void color_shift(const texture& silhouette, const SDL_Rect& dst, int r, int g, int b);
+
+/** Whether the renderer supports the blend modes used by color_shift(). */
+bool color_shift_supported();
+
 
 /***************************/
 /* RAII state manipulation */
@@ -20,9 +20,11 @@
 #include "gui/core/top_level_drawable.hpp"
 #include "preferences/general.hpp"
 #include "sdl/rect.hpp"
+#include "utils/frame_profiler.hpp"
 #include "utils/general.hpp"
 #include "video.hpp"
 
+#include <SDL2/SDL_events.h>
 #include <SDL2/SDL_rect.h>
 #include <SDL2/SDL_timer.h>
 
@@ -48,6 +50,17 @@ std::vector<rect> invalidated_regions_;
 bool drawing_ = false;
 bool tlds_need_tidying_ = false;
 uint32_t last_sparkle_ = 0;
+/** Number of consecutive frames in which nothing was drawn. */
+unsigned idle_frames_ = 0;
+
+/** Frames without drawing after which the screen is considered static. */
+const unsigned idle_threshold = 60;
+/** How many frame lengths to wait between updates of a static screen. */
+const int idle_frame_multiplier = 4;
+/** Minimum frame length while the window doesn't have focus. */
+const int unfocused_frame_length = 33;
+/** Minimum frame length while the window is minimized. */
+const int minimized_frame_length = 250;
 } // namespace
 
 namespace draw_manager {
@@ -125,6 +138,8 @@ void invalidate_all()
 
 void sparkle()
 {
+	PROFILE_SCOPE("draw_manager::sparkle");
+
 	if (drawing_) {
 		ERR_DM << "Draw recursion detected";
 		throw game::error("recursive draw");
@@ -137,10 +152,16 @@ void sparkle()
 	}
 
 	// Animate, process, and update state.
-	draw_manager::update();
+	{
+		PROFILE_SCOPE("draw_manager::update");
+		draw_manager::update();
+	}
 
 	// Ensure layout is up-to-date.
-	draw_manager::layout();
+	{
+		PROFILE_SCOPE("draw_manager::layout");
+		draw_manager::layout();
+	}
 
 	// If we are running headless or executing unit tests, do not render.
 	// There are not currently any tests for actual rendering output.
@@ -150,17 +171,30 @@ void sparkle()
 	}
 
 	// Ensure any off-screen render buffers are up-to-date.
-	draw_manager::render();
+	{
+		PROFILE_SCOPE("draw_manager::render");
+		draw_manager::render();
+	}
 
 	// Draw to the screen.
-	if (draw_manager::expose()) {
+	bool drawn;
+	{
+		PROFILE_SCOPE("draw_manager::expose");
+		drawn = draw_manager::expose();
+	}
+
+	if (drawn) {
 		// We only need to flip the screen if something was drawn.
+		PROFILE_SCOPE("video::render_screen");
+		idle_frames_ = 0;
 		video::render_screen();
 	} else {
+		++idle_frames_;
 		wait_for_vsync();
 	}
 
 	last_sparkle_ = SDL_GetTicks();
+	util::frame_profiler::get().end_frame();
 }
 
 int get_frame_length()
@@ -173,15 +207,49 @@ int get_frame_length()
 	// allow 1ms for general processing
 	int vsync_delay = (1000 / rr) - 1;
 	// if there's a preferred limit, limit to that
-	return std::clamp(vsync_delay, preferences::draw_delay(), 1000);
+	const int frame_length = std::clamp(vsync_delay, preferences::draw_delay(), 1000);
+
+	if(video::headless() || video::testing()) {
+		return frame_length;
+	}
+
+	// Nobody is looking closely, so save some power.
+	if(video::window_is_minimized()) {
+		return std::max(frame_length, minimized_frame_length);
+	}
+
+	if(!video::window_has_focus()) {
+		return std::max(frame_length, unfocused_frame_length);
+	}
+
+	return frame_length;
 }
 
 static void wait_for_vsync()
 {
-	int time_to_wait = last_sparkle_ + get_frame_length() - SDL_GetTicks();
-	if (time_to_wait > 0) {
-		// delay a maximum of 1 second in case something crazy happens
-		SDL_Delay(std::min(time_to_wait, 1000));
+	int frame_length = get_frame_length();
+
+	// If nothing has been drawn for a while the screen is most likely static,
+	// so there is no need to look for changes at the full frame rate.
+	if(idle_frames_ >= idle_threshold) {
+		frame_length *= idle_frame_multiplier;
+	}
+
+	int time_to_wait = last_sparkle_ + frame_length - SDL_GetTicks();
+	if (time_to_wait <= 0) {
+		return;
+	}
+
+	// delay a maximum of 1 second in case something crazy happens
+	time_to_wait = std::min(time_to_wait, 1000);
+
+	// Wake up as soon as input or a timer event arrives, so that the longer
+	// idle waits don't add latency. If events are already queued nobody is
+	// processing them, and waiting for one would return immediately.
+	if(SDL_HasEvents(SDL_FIRSTEVENT, SDL_LASTEVENT)) {
+		SDL_Delay(time_to_wait);
+	} else {
+		SDL_WaitEventTimeout(nullptr, time_to_wait);
 	}
 }
 
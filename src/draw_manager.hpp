@@ -101,7 +101,9 @@ void invalidate_all();
  *
  * If vsync is enabled, this function will block until the next vblank.
  * If nothing is drawn, it will still block for an appropriate amount of
- * time to simulate vsync, even if vsync is disabled.
+ * time to simulate vsync, even if vsync is disabled. When nothing has been
+ * drawn for a while it blocks for several frames, returning early if an
+ * event arrives.
  */
 void sparkle();
 
@@ -109,6 +111,7 @@ void sparkle();
  * Returns the length of one display frame, in milliseconds.
  *
  * This will usually be determined by the active monitor's refresh rate.
+ * It is longer while the window is unfocused or minimized.
  */
 int get_frame_length();
 
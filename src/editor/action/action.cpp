@@ -70,6 +70,13 @@ std::unique_ptr<editor_action> editor_action::perform(map_context& mc) const
 
 IMPLEMENT_ACTION(whole_map)
 
+std::unique_ptr<editor_action> editor_action_whole_map::perform(map_context& mc) const
+{
+	editor_map map(m_);
+	mc.swap_map(map);
+	return std::make_unique<editor_action_whole_map>(std::move(map));
+}
+
 void editor_action_whole_map::perform_without_undo(map_context& mc) const
 {
 	mc.set_map(m_);
@@ -38,12 +38,18 @@ namespace editor
 class editor_action_whole_map : public editor_action
 {
 public:
-	editor_action_whole_map(const editor_map& m)
-		: m_(m)
+	editor_action_whole_map(editor_map m)
+		: m_(std::move(m))
 	{
 	}
 
 	std::unique_ptr<editor_action> clone() const override;
+
+	/**
+	 * Swaps the map in, so the map it replaces becomes the undo action
+	 * without being copied.
+	 */
+	std::unique_ptr<editor_action> perform(map_context& m) const override;
 	void perform_without_undo(map_context& m) const override;
 	const std::string& get_name() const override;
 
@@ -79,6 +79,7 @@ editor_controller::editor_controller()
 	, help_manager_(nullptr)
 	, do_quit_(false)
 	, quit_mode_(EXIT_ERROR)
+	, drag_refresh_pending_(false)
 	, music_tracks_()
 {
 	init_gui();
@@ -1273,7 +1274,7 @@ void editor_controller::mouse_motion(int x, int y, const bool /*browse*/,
 			} else {
 				get_current_map_context().perform_action(*a);
 			}
-			context_manager_->refresh_after_action(true);
+			drag_refresh_pending_ = true;
 		}
 	} else {
 		get_mouse_action().move(*gui_, hex_clicked);
@@ -1331,6 +1332,7 @@ void editor_controller::left_mouse_up(int x, int y, const bool /*browse*/)
 		set_button_state();
 	}
 	toolkit_->set_mouseover_overlay();
+	drag_refresh_pending_ = false;
 	context_manager_->refresh_after_action();
 }
 
@@ -1367,9 +1369,18 @@ void editor_controller::right_mouse_up(int x, int y, const bool browse)
 		set_button_state();
 	}
 	toolkit_->set_mouseover_overlay();
+	drag_refresh_pending_ = false;
 	context_manager_->refresh_after_action();
 }
 
+void editor_controller::process_event()
+{
+	if(drag_refresh_pending_) {
+		drag_refresh_pending_ = false;
+		context_manager_->refresh_after_action(true);
+	}
+}
+
 void editor_controller::terrain_description()
 {
 	const map_location& loc = gui().mouseover_hex();
@@ -167,6 +167,9 @@ class editor_controller : public controller_base,
 		void right_drag_end(int x, int y, const bool browse) override;
 		void right_mouse_up(int x, int y, const bool browse) override;
 
+		/** Refreshes the display once for all the drag steps handled since the last call. */
+		void process_event() override;
+
 		virtual hotkey::command_executor * get_hotkey_command_executor() override;
 
 		map_context& get_current_map_context() const
@@ -259,6 +262,12 @@ class editor_controller : public controller_base,
 		bool do_quit_;
 		EXIT_STATUS quit_mode_;
 
+		/**
+		 * Set when a drag has changed the map but the display hasn't been
+		 * refreshed yet. All the motion events of a frame share one refresh.
+		 */
+		bool drag_refresh_pending_;
+
 		std::vector<sound::music_track> music_tracks_;
 };
 
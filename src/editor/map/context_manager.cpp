@@ -545,7 +545,14 @@ void context_manager::refresh_after_action(bool drag_part)
 		|| ((auto_update_transitions_ == preferences::editor::TRANSITION_UPDATE_PARTIAL)
 		&& (!drag_part || get_map_context().everything_changed())))
 		{
-			gui_.rebuild_all();
+			// With partial updates, earlier quick previews may be anywhere on the map
+			if(auto_update_transitions_ == preferences::editor::TRANSITION_UPDATE_ON
+				&& !get_map_context().everything_changed())
+			{
+				gui_.rebuild_region(changed_locs);
+			} else {
+				gui_.rebuild_all();
+			}
 			get_map_context().set_needs_terrain_rebuild(false);
 			gui_.invalidate_all();
 		} else {
@@ -721,8 +728,7 @@ void context_manager::generate_map_dialog()
 		if(map_string.empty()) {
 			gui2::show_transient_message("", _("Map creation failed."));
 		} else {
-			editor_map new_map(map_string);
-			editor_action_whole_map a(new_map);
+			editor_action_whole_map a(editor_map{map_string});
 			get_map_context().set_needs_labels_reset(); // Ensure Player Start labels are updated together with newly generated map
 			perform_refresh(a);
 		}
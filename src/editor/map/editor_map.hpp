@@ -102,6 +102,11 @@ public:
 	 */
 	~editor_map();
 
+	editor_map(const editor_map&) = default;
+	editor_map(editor_map&&) = default;
+	editor_map& operator=(const editor_map&) = default;
+	editor_map& operator=(editor_map&&) = default;
+
 	/**
 	 * Debugging aid. Check if the widths and heights correspond to the actual map data sizes.
 	 */
@@ -685,6 +685,17 @@ void map_context::set_map(const editor_map& map)
 	map_ = map;
 }
 
+void map_context::swap_map(editor_map& map)
+{
+	if(map_.h() != map.h() || map_.w() != map.w()) {
+		set_needs_reload();
+	} else {
+		set_needs_terrain_rebuild();
+	}
+
+	std::swap(map_, map);
+}
+
 void map_context::perform_action(const editor_action& action)
 {
 	LOG_ED << "Performing action " << action.get_id() << ": " << action.get_name() << ", actions count is "
@@ -344,6 +344,9 @@ public:
 
 	void set_map(const editor_map& map);
 
+	/** Like set_map, but hands the previous map back in @a map instead of discarding it. */
+	void swap_map(editor_map& map);
+
 	/**
 	 * Performs an action (thus modifying the map). An appropriate undo action is added to
 	 * the undo stack. The redo stack is cleared. Note that this may throw, use caution
@@ -262,6 +262,31 @@ bool editor_palette<Item>::is_selected_bg_item(const std::string& id)
 	return selected_bg_item_ == id;
 }
 
+template<class Item>
+const typename editor_palette<Item>::item_tile& editor_palette<Item>::get_tile(const Item& item)
+{
+	const std::string& id = get_id(item);
+	auto [iter, added] = tiles_.try_emplace(id);
+	if(!added) {
+		return iter->second;
+	}
+
+	item_tile& res = iter->second;
+	std::stringstream tooltip_text;
+	setup_item(item, res.base, res.overlay, tooltip_text);
+
+	if(non_core_items_.find(id) != non_core_items_.end()) {
+		tooltip_text << " "
+				<< font::span_color(font::BAD_COLOR)
+		<< _("(non-core)") << "\n"
+		<< _("Will not work in game without extra care.")
+		<< "</span>";
+	}
+
+	res.tooltip = tooltip_text.str();
+	return res;
+}
+
 template<class Item>
 void editor_palette<Item>::layout()
 {
@@ -289,6 +314,11 @@ void editor_palette<Item>::layout()
 	if(downscroll_button)
 		downscroll_button->enable(can_scroll_down());
 
+	if(std::string variant = tile_variant(); variant != tiles_variant_) {
+		tiles_.clear();
+		tiles_variant_ = std::move(variant);
+	}
+
 	for(std::size_t i = 0; i < buttons_.size(); ++i) {
 		const auto item_index = items_start_ + i;
 		gui::tristate_button& tile = buttons_[i];
@@ -304,21 +334,9 @@ void editor_palette<Item>::layout()
 		//typedef std::map<std::string, Item> item_map_wurscht;
 		typename item_map::iterator item = item_map_.find(item_id);
 
-		texture item_base, item_overlay;
-		std::stringstream tooltip_text;
-		setup_item((*item).second, item_base, item_overlay, tooltip_text);
-
-		bool is_core = non_core_items_.find(get_id((*item).second)) == non_core_items_.end();
-		if (!is_core) {
-			tooltip_text << " "
-					<< font::span_color(font::BAD_COLOR)
-			<< _("(non-core)") << "\n"
-			<< _("Will not work in game without extra care.")
-			<< "</span>";
-		}
-
-		tile.set_tooltip_string(tooltip_text.str());
-		tile.set_item_image(item_base, item_overlay);
+		const item_tile& cached = get_tile(item->second);
+		tile.set_tooltip_string(cached.tooltip);
+		tile.set_item_image(cached.base, cached.overlay);
 		tile.set_item_id(item_id);
 
 //		if (get_id((*item).second) == selected_bg_item_
@@ -46,6 +46,8 @@ public:
 		, selected_bg_item_()
 		, toolkit_(toolkit)
 		, buttons_()
+		, tiles_()
+		, tiles_variant_()
 	{
 	}
 
@@ -111,6 +113,13 @@ private:
 
 	virtual const std::string& get_id(const Item& item) = 0;
 
+	/**
+	 * Anything besides the item itself that setup_item() depends on.
+	 *
+	 * The tiles already set up are thrown away when this changes.
+	 */
+	virtual std::string tile_variant() { return std::string(); }
+
 	/** Setup the internal data structure. */
 	virtual void setup(const game_config_view& cfg) = 0;
 
@@ -180,6 +189,26 @@ private:
 
 	editor_toolkit& toolkit_;
 	std::vector<gui::tristate_button> buttons_;
+
+	/** Image and tooltip of an item, as set up by setup_item(). */
+	struct item_tile
+	{
+		texture base;
+		texture overlay;
+		std::string tooltip;
+	};
+
+	/** Returns the tile of @a item, setting it up the first time it is shown. */
+	const item_tile& get_tile(const Item& item);
+
+	/**
+	 * Tiles of the items shown so far, by item id.
+	 *
+	 * Filled in by layout() as items scroll into view, so scrolling back
+	 * and redrawing the palette do not set the same items up again.
+	 */
+	std::map<std::string, item_tile> tiles_;
+	std::string tiles_variant_;
 };
 
 
@@ -218,6 +218,11 @@ const std::string& terrain_palette::get_id(const t_translation::terrain_code& te
 	return t_info.id();
 }
 
+std::string terrain_palette::tile_variant()
+{
+	return gui_.debug_flag_set(display::DEBUG_TERRAIN_CODES) ? "codes" : "";
+}
+
 std::string terrain_palette::get_help_string()
 {
 	std::ostringstream msg;
@@ -56,6 +56,9 @@ private:
 
 	virtual const std::string& get_id(const t_translation::terrain_code& terrain);
 
+	/** The tooltips show the terrain codes in debug mode. */
+	virtual std::string tile_variant();
+
 	virtual void setup_item(
 		const t_translation::terrain_code& item,
 		texture& item_base_image,
@@ -93,6 +93,11 @@ void unit_palette::setup_item(
 	tooltip_text << u.type_name();
 }
 
+std::string unit_palette::tile_variant()
+{
+	return team::get_side_color_id(gui_.viewing_side());
+}
+
 unit_palette::unit_palette(editor_display &gui, const game_config_view& cfg,
                            editor_toolkit &toolkit)
 //TODO avoid magic numbers
@@ -48,6 +48,9 @@ public:
 private:
 	virtual const std::string& get_id(const unit_type& terrain);
 
+	/** Units are shown in the color of the viewing side. */
+	virtual std::string tile_variant();
+
 	virtual void setup_item(
 		const unit_type& item,
 		texture& item_base_image,
@@ -23,6 +23,7 @@
 #include "sdl/userevent.hpp"
 #include "utils/ranges.hpp"
 #include "utils/general.hpp"
+#include "utils/frame_profiler.hpp"
 #include "video.hpp"
 
 #if defined _WIN32
@@ -482,6 +483,8 @@ void pump()
 		return;
 	}
 
+	PROFILE_SCOPE("events::pump");
+
 	pump_info info;
 
 	// Used to keep track of double click events
@@ -628,10 +631,14 @@ void pump()
 				draw_manager::invalidate_all();
 				break;
 
+			// The window may now be on a monitor with a different refresh rate.
+			case SDL_WINDOWEVENT_MOVED:
+				video::update_refresh_rate();
+				break;
+
 			case SDL_WINDOWEVENT_MAXIMIZED:
 			case SDL_WINDOWEVENT_RESTORED:
 			case SDL_WINDOWEVENT_SHOWN:
-			case SDL_WINDOWEVENT_MOVED:
 				// Not used.
 				break;
 			}
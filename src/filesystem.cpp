@@ -52,9 +52,13 @@
 #define VOLUME_NAME_NONE 0x4
 #endif
 
+#else
+#include <sys/stat.h>
 #endif /* !_WIN32 */
 
 #include <algorithm>
+#include <map>
+#include <mutex>
 #include <set>
 
 // Copied from boost::predef, as it's there only since 1.55.
@@ -406,6 +410,20 @@ void get_files_in_dir(const std::string& dir,
 			push_if_exists(files, di->path(), mode == name_mode::ENTIRE_FILE_PATH);
 
 			if(checksum != nullptr) {
+#ifndef _WIN32
+				// A single stat() gives both values; last_write_time() and file_size()
+				// would each make their own, which adds up over the whole data tree.
+				struct stat file_info;
+				if(::stat(di->path().c_str(), &file_info) != 0) {
+					LOG_FS << "Failed to read file information of " << di->path().string();
+				} else {
+					if(file_info.st_mtime > checksum->modified) {
+						checksum->modified = file_info.st_mtime;
+					}
+
+					checksum->sum_size += file_info.st_size;
+				}
+#else
 				std::time_t mtime = bfs::last_write_time(di->path(), ec);
 				if(ec) {
 					LOG_FS << "Failed to read modification time of " << di->path().string() << ": " << ec.message();
@@ -419,6 +437,7 @@ void get_files_in_dir(const std::string& dir,
 				} else {
 					checksum->sum_size += size;
 				}
+#endif
 
 				checksum->nfiles++;
 			}
@@ -433,12 +452,19 @@ void get_files_in_dir(const std::string& dir,
 				continue;
 			}
 
+			// Only a reordering listing cares about a subdirectory's _main.cfg, so
+			// others (like the data tree checksum walk) don't stat it.
+			if(reorder != reorder_mode::DO_REORDER) {
+				push_if_exists(dirs, di->path(), mode == name_mode::ENTIRE_FILE_PATH);
+				continue;
+			}
+
 			const bfs::path inner_main(di->path() / maincfg_filename);
 			bfs::file_status main_st = bfs::status(inner_main, ec);
 
 			if(error_except_not_found(ec)) {
 				LOG_FS << "Failed to get file status of " << inner_main.string() << ": " << ec.message();
-			} else if(reorder == reorder_mode::DO_REORDER && main_st.type() == bfs::regular_file) {
+			} else if(main_st.type() == bfs::regular_file) {
 				LOG_FS << "_main.cfg found : "
 					   << (mode == name_mode::ENTIRE_FILE_PATH ? inner_main.string() : inner_main.filename().string());
 				push_if_exists(files, inner_main, mode == name_mode::ENTIRE_FILE_PATH);
@@ -1104,6 +1130,18 @@ void copy_file(const std::string& src, const std::string& dest)
 	write_file(dest, read_file(src));
 }
 
+bool rename_file(const std::string& src, const std::string& dest)
+{
+	error_code ec;
+	bfs::rename(bfs::path(src), bfs::path(dest), ec);
+	if(ec) {
+		ERR_FS << "Could not move " << src << " to " << dest << ": " << ec.message();
+		return false;
+	}
+
+	return true;
+}
+
 bool create_directory_if_missing(const std::string& dirname)
 {
 	return create_directory_if_missing(bfs::path(dirname));
@@ -1308,6 +1346,21 @@ std::set<std::string> binary_paths;
 typedef std::map<std::string, std::vector<std::string>> paths_map;
 paths_map binary_paths_cache;
 
+/**
+ * Results of get_binary_file_location() by type and file name, including
+ * the files that were not found. Missing images (optional portraits, ~BLIT
+ * sources and so on) are otherwise looked up with a stat call for every
+ * binary path again and again.
+ */
+std::map<std::string, std::map<std::string, std::string>> binary_file_locations;
+std::mutex binary_file_locations_mutex;
+
+void clear_binary_file_locations()
+{
+	std::scoped_lock lock(binary_file_locations_mutex);
+	binary_file_locations.clear();
+}
+
 } // namespace
 
 static void init_binary_paths()
@@ -1357,6 +1410,7 @@ void binary_paths_manager::set_paths(const game_config_view& cfg)
 void binary_paths_manager::cleanup()
 {
 	binary_paths_cache.clear();
+	clear_binary_file_locations();
 
 	for(const std::string& p : paths_) {
 		binary_paths.erase(p);
@@ -1366,6 +1420,7 @@ void binary_paths_manager::cleanup()
 void clear_binary_paths_cache()
 {
 	binary_paths_cache.clear();
+	clear_binary_file_locations();
 }
 
 static bool is_legal_file(const std::string& filename_str)
@@ -1459,29 +1514,43 @@ std::string get_binary_file_location(const std::string& type, const std::string&
 		}
 	}
 
-	if(!is_legal_file(filename)) {
-		return std::string();
+	{
+		std::scoped_lock lock(binary_file_locations_mutex);
+		const auto type_i = binary_file_locations.find(type);
+		if(type_i != binary_file_locations.end()) {
+			const auto file_i = type_i->second.find(filename);
+			if(file_i != type_i->second.end()) {
+				return file_i->second;
+			}
+		}
 	}
 
 	std::string result;
-	for(const std::string& bp : get_binary_paths(type)) {
-		bfs::path bpath(bp);
-		bpath /= filename;
+	if(is_legal_file(filename)) {
+		for(const std::string& bp : get_binary_paths(type)) {
+			bfs::path bpath(bp);
+			bpath /= filename;
 
-		DBG_FS << "  checking '" << bp << "'";
+			DBG_FS << "  checking '" << bp << "'";
 
-		if(file_exists(bpath)) {
-			DBG_FS << "  found at '" << bpath.string() << "'";
-			if(result.empty()) {
-				result = bpath.string();
-			} else {
-				WRN_FS << "Conflicting files in binary_path: '" << result
-					   << "' and '" << bpath.string() << "'";
+			if(file_exists(bpath)) {
+				DBG_FS << "  found at '" << bpath.string() << "'";
+				if(result.empty()) {
+					result = bpath.string();
+				} else {
+					WRN_FS << "Conflicting files in binary_path: '" << result
+						   << "' and '" << bpath.string() << "'";
+				}
 			}
 		}
+
+		if(result.empty()) {
+			DBG_FS << "  not found";
+		}
 	}
 
-	DBG_FS << "  not found";
+	std::scoped_lock lock(binary_file_locations_mutex);
+	binary_file_locations[type].emplace(filename, result);
 	return result;
 }
 
@@ -223,6 +223,13 @@ void write_file(const std::string& fname, const std::string& data, std::ios_base
  */
 void copy_file(const std::string& src, const std::string& dest);
 
+/**
+ * Moves a file to a new path, replacing any file already there.
+ *
+ * @return @a false on failure, for example when both paths are not on the same file system.
+ */
+bool rename_file(const std::string& src, const std::string& dest);
+
 std::string read_map(const std::string& name);
 
 /**
@@ -427,6 +434,9 @@ const std::vector<std::string>& get_binary_paths(const std::string& type);
 /**
  * Returns a complete path to the actual file of a given @a type
  * or an empty string if the file isn't present.
+ *
+ * Results, including missing files, are cached until the binary paths change
+ * or clear_binary_paths_cache() is called.
  */
 std::string get_binary_file_location(const std::string& type, const std::string& filename);
 
@@ -39,7 +39,9 @@
 
 #include <cassert>
 #include <cstring>
+#include <list>
 #include <stdexcept>
+#include <unordered_map>
 
 static lg::log_domain log_font("font");
 #define DBG_FT LOG_STREAM(debug, log_font)
@@ -49,22 +51,121 @@ namespace font
 
 namespace
 {
+/**
+ * A least-recently-used cache keyed by hash, bounded by the summed cost of its entries.
+ */
+template<typename Value>
+class lru_cache
+{
+public:
+	explicit lru_cache(std::size_t budget)
+		: entries_()
+		, order_()
+		, budget_(budget)
+		, used_(0)
+		, hits_(0)
+		, misses_(0)
+	{
+	}
+
+	/** Returns the cached value, or nullptr if there is none. */
+	const Value* get(std::size_t key)
+	{
+		const auto iter = entries_.find(key);
+		if(iter == entries_.end()) {
+			++misses_;
+			return nullptr;
+		}
+
+		++hits_;
+		order_.splice(order_.begin(), order_, iter->second.position);
+		return &iter->second.value;
+	}
+
+	const Value& put(std::size_t key, Value value, std::size_t cost)
+	{
+		if(const auto iter = entries_.find(key); iter != entries_.end()) {
+			used_ -= iter->second.cost;
+			order_.erase(iter->second.position);
+			entries_.erase(iter);
+		}
+
+		// Keep at least the new entry, even if it's bigger than the whole budget.
+		while(!order_.empty() && used_ + cost > budget_) {
+			const auto victim = entries_.find(order_.back());
+			used_ -= victim->second.cost;
+			entries_.erase(victim);
+			order_.pop_back();
+		}
+
+		order_.push_front(key);
+		used_ += cost;
+		return entries_.emplace(key, entry{std::move(value), cost, order_.begin()}).first->second.value;
+	}
+
+	void clear()
+	{
+		entries_.clear();
+		order_.clear();
+		used_ = 0;
+	}
+
+	std::size_t size() const { return entries_.size(); }
+	std::size_t used() const { return used_; }
+	std::size_t hits() const { return hits_; }
+	std::size_t misses() const { return misses_; }
+
+private:
+	struct entry
+	{
+		Value value;
+		std::size_t cost;
+		std::list<std::size_t>::iterator position;
+	};
+
+	std::unordered_map<std::size_t, entry> entries_;
+
+	/** Keys, most recently used first. */
+	std::list<std::size_t> order_;
+
+	std::size_t budget_;
+	std::size_t used_;
+	std::size_t hits_;
+	std::size_t misses_;
+};
+
 /**
  * The text texture cache.
  *
  * Each time a specific bit of text is rendered, a corresponding texture is created and
  * added to the cache. We don't store the surface since there isn't really any use for
- * it. If we need texture size that can be easily queried.
+ * it. If we need texture size that can be easily queried. The cache is bounded by the
+ * memory used by the textures, the least recently used ones are dropped first.
  *
  * @todo Figure out how this can be optimized with a texture atlas. It should be possible
  * to store smaller bits of text in the atlas and construct new textures from hem.
  */
-std::map<std::size_t, texture> rendered_cache{};
+lru_cache<texture> rendered_cache{64 * 1024 * 1024};
+
+/**
+ * The text layout size cache.
+ *
+ * Maps the layout affecting settings of a pango_text to the size of the shaped
+ * text, so re-laying out widgets with text they already measured doesn't need
+ * to shape it again.
+ */
+lru_cache<PangoRectangle> layout_size_cache{4096};
 } // anon namespace
 
 void flush_texture_cache()
 {
+	DBG_FT << "text texture cache: " << rendered_cache.size() << " textures, " << rendered_cache.used() << " bytes, "
+		<< rendered_cache.hits() << " hits, " << rendered_cache.misses() << " misses";
+	DBG_FT << "text layout cache: " << layout_size_cache.size() << " layouts, "
+		<< layout_size_cache.hits() << " hits, " << layout_size_cache.misses() << " misses";
+
 	rendered_cache.clear();
+	layout_size_cache.clear();
 }
 
 pango_text::pango_text()
@@ -87,6 +188,7 @@ pango_text::pango_text()
 	, alignment_(PANGO_ALIGN_LEFT)
 	, maximum_length_(std::string::npos)
 	, calculation_dirty_(true)
+	, size_key_()
 	, length_(0)
 	, pixel_scale_(1)
 	, surface_buffer_()
@@ -117,16 +219,18 @@ texture pango_text::render_and_get_texture()
 {
 	// Update our settings then hash them.
 	update_pixel_scale(); // TODO: this should be in recalculate()
-	recalculate();
+	recalculate_size();
 	const std::size_t hash = std::hash<pango_text>{}(*this);
 	// If we already have the appropriate texture in-cache, use it.
-	if(const auto iter = rendered_cache.find(hash); iter != rendered_cache.end()) {
-		return with_draw_scale(iter->second);
+	if(const texture* cached = rendered_cache.get(hash)) {
+		return with_draw_scale(*cached);
 	}
 
+	recalculate();
 	if(surface text_surf = create_surface(); text_surf) {
-		const auto& [new_iter, added] = rendered_cache.try_emplace(hash, std::move(text_surf));
-		return with_draw_scale(new_iter->second);
+		texture tex(text_surf);
+		const point size = tex.get_raw_size();
+		return with_draw_scale(rendered_cache.put(hash, std::move(tex), std::size_t(size.x) * size.y * 4));
 	}
 
 	// Render output was null for some reason. Don't cache.
@@ -168,7 +272,7 @@ point pango_text::to_draw_scale(const point& p) const
 point pango_text::get_size()
 {
 	update_pixel_scale(); // TODO: this should be in recalculate()
-	this->recalculate();
+	this->recalculate_size();
 
 	return to_draw_scale({rect_.width, rect_.height});
 }
@@ -583,7 +687,49 @@ void pango_text::recalculate() const
 
 		calculation_dirty_ = false;
 		rect_ = calculate_size(*layout_);
+
+		size_key_ = layout_hash();
+		layout_size_cache.put(*size_key_, rect_, 1);
+	}
+}
+
+void pango_text::recalculate_size() const
+{
+	if(!calculation_dirty_) {
+		return;
+	}
+
+	const std::size_t key = layout_hash();
+	if(size_key_ == key) {
+		return;
 	}
+
+	if(const PangoRectangle* size = layout_size_cache.get(key)) {
+		rect_ = *size;
+		size_key_ = key;
+		return;
+	}
+
+	recalculate();
+}
+
+std::size_t pango_text::layout_hash() const
+{
+	std::size_t hash = 0;
+
+	boost::hash_combine(hash, text_);
+	boost::hash_combine(hash, markedup_text_);
+	boost::hash_combine(hash, link_aware_);
+	boost::hash_combine(hash, font_class_);
+	boost::hash_combine(hash, font_size_);
+	boost::hash_combine(hash, font_style_);
+	boost::hash_combine(hash, maximum_width_);
+	boost::hash_combine(hash, characters_per_line_);
+	boost::hash_combine(hash, maximum_height_);
+	boost::hash_combine(hash, ellipse_mode_);
+	boost::hash_combine(hash, alignment_);
+
+	return hash;
 }
 
 PangoRectangle pango_text::calculate_size(PangoLayout& layout) const
@@ -26,6 +26,7 @@
 
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -371,6 +372,9 @@ private:
 	/** The dirty state of the calculations. */
 	mutable bool calculation_dirty_;
 
+	/** Hash of the layout settings @ref rect_ was calculated for, see @ref layout_hash. */
+	mutable std::optional<std::size_t> size_key_;
+
 	/** Length of the text. */
 	mutable std::size_t length_;
 
@@ -380,6 +384,17 @@ private:
 	/** Recalculates the text layout. */
 	void recalculate() const;
 
+	/**
+	 * Updates @ref rect_ only, from the layout size cache when possible.
+	 *
+	 * The layout itself is only updated if the size wasn't cached, so anything
+	 * that queries the layout must call @ref recalculate instead.
+	 */
+	void recalculate_size() const;
+
+	/** Hashes the settings that affect the shaped layout. */
+	std::size_t layout_hash() const;
+
 	/** Calculates surface size. */
 	PangoRectangle calculate_size(PangoLayout& layout) const;
 
@@ -34,6 +34,8 @@
 #include "play_controller.hpp"
 #include "game_events/pump.hpp"
 
+#include <unordered_map>
+
 static lg::log_domain log_scripting_formula("scripting/formula");
 #define LOG_SF LOG_STREAM(info, log_scripting_formula)
 #define ERR_SF LOG_STREAM(err, log_scripting_formula)
@@ -186,152 +188,257 @@ unit_callable::unit_callable(const unit& u) : loc_(u.get_location()), u_(u)
 	type_ = UNIT_C;
 }
 
+namespace
+{
+/** The values a unit_callable has, see unit_keys(). */
+enum class unit_key
+{
+	x, y, loc, terrain, id, type, name, usage, canrecruit, undead, attacks, abilities,
+	hitpoints, max_hitpoints, experience, max_experience, level, total_movement, movement_left,
+	attacks_left, max_attacks, traits, extra_recruit, advances_to, states, side, side_number,
+	cost, upkeep, loyal, hidden, petrified, resting, role, race, gender, variation, zoc,
+	alignment, facing, resistance, movement_cost, vision_cost, jamming_cost, defense, flying,
+	vars, wml_vars, constant
+};
+
+/**
+ * The unit_callable keys and what they mean, so that a lookup is one hash rather
+ * than a comparison with every key before it.
+ */
+const std::unordered_map<std::string, unit_key>& unit_keys()
+{
+	static const std::unordered_map<std::string, unit_key> keys {
+		{"x", unit_key::x},
+		{"y", unit_key::y},
+		{"loc", unit_key::loc},
+		{"terrain", unit_key::terrain},
+		{"id", unit_key::id},
+		{"type", unit_key::type},
+		{"name", unit_key::name},
+		{"usage", unit_key::usage},
+		{"leader", unit_key::canrecruit},
+		{"canrecruit", unit_key::canrecruit},
+		{"undead", unit_key::undead},
+		{"attacks", unit_key::attacks},
+		{"abilities", unit_key::abilities},
+		{"hitpoints", unit_key::hitpoints},
+		{"max_hitpoints", unit_key::max_hitpoints},
+		{"experience", unit_key::experience},
+		{"max_experience", unit_key::max_experience},
+		// This allows writing "upkeep == full"
+		{"level", unit_key::level},
+		{"full", unit_key::level},
+		{"total_movement", unit_key::total_movement},
+		{"max_moves", unit_key::total_movement},
+		{"movement_left", unit_key::movement_left},
+		{"moves", unit_key::movement_left},
+		{"attacks_left", unit_key::attacks_left},
+		{"max_attacks", unit_key::max_attacks},
+		{"traits", unit_key::traits},
+		{"extra_recruit", unit_key::extra_recruit},
+		{"advances_to", unit_key::advances_to},
+		{"states", unit_key::states},
+		{"status", unit_key::states},
+		{"side", unit_key::side},
+		{"side_number", unit_key::side_number},
+		{"cost", unit_key::cost},
+		{"upkeep", unit_key::upkeep},
+		{"loyal", unit_key::loyal},
+		{"hidden", unit_key::hidden},
+		{"petrified", unit_key::petrified},
+		{"resting", unit_key::resting},
+		{"role", unit_key::role},
+		{"race", unit_key::race},
+		{"gender", unit_key::gender},
+		{"variation", unit_key::variation},
+		{"zoc", unit_key::zoc},
+		{"alignment", unit_key::alignment},
+		{"facing", unit_key::facing},
+		{"resistance", unit_key::resistance},
+		{"movement_cost", unit_key::movement_cost},
+		{"vision_cost", unit_key::vision_cost},
+		{"jamming_cost", unit_key::jamming_cost},
+		{"defense", unit_key::defense},
+		{"flying", unit_key::flying},
+		{"vars", unit_key::vars},
+		{"wml_vars", unit_key::wml_vars},
+		// Evaluate to their own name, so that one can write "facing = n" or "gender = male"
+		{"n", unit_key::constant},
+		{"s", unit_key::constant},
+		{"ne", unit_key::constant},
+		{"se", unit_key::constant},
+		{"nw", unit_key::constant},
+		{"sw", unit_key::constant},
+		{"lawful", unit_key::constant},
+		{"neutral", unit_key::constant},
+		{"chaotic", unit_key::constant},
+		{"liminal", unit_key::constant},
+		{"male", unit_key::constant},
+		{"female", unit_key::constant},
+	};
+
+	return keys;
+}
+
+/** The values of a movement type table, as percentages of success for @a flip tables. */
+variant movetype_table(const config& cfg, bool flip)
+{
+	std::map<variant, variant> res;
+	for(const auto& p : cfg.attribute_range()) {
+		int val = p.second;
+		if(flip) {
+			val = 100 - val;
+		}
+		res.emplace(variant(p.first), variant(val));
+	}
+
+	return variant(res);
+}
+} // end anon namespace
+
 variant unit_callable::get_value(const std::string& key) const
 {
-	if(key == "x") {
+	const auto k = unit_keys().find(key);
+	if(k == unit_keys().end()) {
+		return variant();
+	}
+
+	switch(k->second) {
+	case unit_key::x:
 		if(loc_ == map_location::null_location()) {
 			return variant();
 		}
 
 		return variant(loc_.wml_x());
-	} else if(key == "y") {
+	case unit_key::y:
 		if(loc_ == map_location::null_location()) {
 			return variant();
 		}
 
 		return variant(loc_.wml_y());
-	} else if(key == "loc") {
+	case unit_key::loc:
 		if(loc_ == map_location::null_location()) {
 			return variant();
 		}
 
 		return variant(std::make_shared<location_callable>(loc_));
-	} else if(key == "terrain") {
+	case unit_key::terrain:
 		if(loc_ == map_location::null_location()) {
 			return variant();
 		}
 		return variant(std::make_shared<terrain_callable>(*resources::gameboard, loc_));
-	} else if(key == "id") {
+	case unit_key::id:
 		return variant(u_.id());
-	} else if(key == "type") {
+	case unit_key::type:
 		return variant(u_.type_id());
-	} else if(key == "name") {
+	case unit_key::name:
 		return variant(u_.name());
-	} else if(key == "usage") {
+	case unit_key::usage:
 		return variant(u_.usage());
-	} else if(key == "leader" || key == "canrecruit") {
+	case unit_key::canrecruit:
 		return variant(u_.can_recruit());
-	} else if(key == "undead") {
+	case unit_key::undead:
 		return variant(u_.get_state("not_living") ? 1 : 0);
-	} else if(key == "attacks") {
+	case unit_key::attacks: {
 		std::vector<variant> res;
 		for(const attack_type& att : u_.attacks()) {
 			res.emplace_back(std::make_shared<attack_type_callable>(att));
 		}
 
 		return variant(res);
-	} else if(key == "abilities") {
+	}
+	case unit_key::abilities:
 		return formula_callable::convert_vector(u_.get_ability_list());
-	} else if(key == "hitpoints") {
+	case unit_key::hitpoints:
 		return variant(u_.hitpoints());
-	} else if(key == "max_hitpoints") {
+	case unit_key::max_hitpoints:
 		return variant(u_.max_hitpoints());
-	} else if(key == "experience") {
+	case unit_key::experience:
 		return variant(u_.experience());
-	} else if(key == "max_experience") {
+	case unit_key::max_experience:
 		return variant(u_.max_experience());
-	} else if(key == "level" || key == "full") {
-		// This allows writing "upkeep == full"
+	case unit_key::level:
 		return variant(u_.level());
-	} else if(key == "total_movement" || key == "max_moves") {
+	case unit_key::total_movement:
 		return variant(u_.total_movement());
-	} else if(key == "movement_left" || key == "moves") {
+	case unit_key::movement_left:
 		return variant(u_.movement_left());
-	} else if(key == "attacks_left") {
+	case unit_key::attacks_left:
 		return variant(u_.attacks_left());
-	} else if(key == "max_attacks") {
+	case unit_key::max_attacks:
 		return variant(u_.max_attacks());
-	} else if(key == "traits") {
+	case unit_key::traits:
 		return formula_callable::convert_vector(u_.get_traits_list());
-	} else if(key == "extra_recruit") {
+	case unit_key::extra_recruit:
 		return formula_callable::convert_vector(u_.recruits());
-	} else if(key == "advances_to") {
+	case unit_key::advances_to:
 		return formula_callable::convert_vector(u_.advances_to());
-	} else if(key == "states" || key == "status") {
+	case unit_key::states:
 		return formula_callable::convert_set(u_.get_states());
-	} else if(key == "side") {
+	case unit_key::side:
 		deprecated_message("unit.side", DEP_LEVEL::FOR_REMOVAL, version_info("1.17"), "This returns 0 for side 1 etc and should not be used. Use side_number instead.");
 		return variant(u_.side()-1);
-	} else if(key == "side_number") {
+	case unit_key::side_number:
 		return variant(u_.side());
-	} else if(key == "cost") {
+	case unit_key::cost:
 		return variant(u_.cost());
-	} else if(key == "upkeep") {
+	case unit_key::upkeep:
 		return variant(u_.upkeep());
-	} else if(key == "loyal") {
+	case unit_key::loyal:
 		// So we can write "upkeep == loyal"
 		return variant(0);
-	} else if(key == "hidden") {
+	case unit_key::hidden:
 		return variant(u_.get_hidden());
-	} else if(key == "petrified") {
+	case unit_key::petrified:
 		return variant(u_.incapacitated());
-	} else if(key == "resting") {
+	case unit_key::resting:
 		return variant(u_.resting());
-	} else if(key == "role") {
+	case unit_key::role:
 		return variant(u_.get_role());
-	} else if(key == "race") {
+	case unit_key::race:
 		return variant(u_.race()->id());
-	} else if(key == "gender") {
+	case unit_key::gender:
 		return variant(gender_string(u_.gender()));
-	} else if(key == "variation") {
+	case unit_key::variation:
 		return variant(u_.variation());
-	} else if(key == "zoc") {
+	case unit_key::zoc:
 		return variant(u_.get_emit_zoc());
-	} else if(key == "alignment") {
+	case unit_key::alignment:
 		return variant(unit_alignments::get_string(u_.alignment()));
-	} else if(key == "facing") {
+	case unit_key::facing:
 		return variant(map_location::write_direction(u_.facing()));
-	} else if(key == "resistance" || key == "movement_cost" || key == "vision_cost" || key == "jamming_cost" || key == "defense") {
-		const auto& mt = u_.movement_type();
+	case unit_key::resistance: {
 		config cfg;
-		bool needs_flip = false;
-		if(key == "resistance") {
-			mt.get_resistances().write(cfg);
-			needs_flip = true;
-		} else if(key == "movement_cost") {
-			mt.get_movement().write(cfg);
-		} else if(key == "vision_cost") {
-			mt.get_vision().write(cfg);
-		} else if(key == "jamming_cost") {
-			mt.get_vision().write(cfg);
-		} else if(key == "defense") {
-			mt.get_defense().write(cfg);
-			needs_flip = true;
-		}
-		std::map<variant, variant> res;
-		for(const auto& p : cfg.attribute_range()) {
-			int val = p.second;
-			if(needs_flip) {
-				val = 100 - val;
-			}
-			res.emplace(variant(p.first), variant(val));
-		}
-
-		return variant(res);
-	} else if(key == "flying") {
+		u_.movement_type().get_resistances().write(cfg);
+		return movetype_table(cfg, true);
+	}
+	case unit_key::movement_cost: {
+		config cfg;
+		u_.movement_type().get_movement().write(cfg);
+		return movetype_table(cfg, false);
+	}
+	case unit_key::vision_cost:
+	case unit_key::jamming_cost: {
+		config cfg;
+		u_.movement_type().get_vision().write(cfg);
+		return movetype_table(cfg, false);
+	}
+	case unit_key::defense: {
+		config cfg;
+		u_.movement_type().get_defense().write(cfg);
+		return movetype_table(cfg, true);
+	}
+	case unit_key::flying:
 		return variant(u_.is_flying());
-	} else if(key == "vars") {
+	case unit_key::vars:
 		if(u_.formula_manager().formula_vars()) {
 			return variant(u_.formula_manager().formula_vars());
 		}
 
 		return variant();
-	} else if(key == "wml_vars") {
+	case unit_key::wml_vars:
 		return variant(std::make_shared<config_callable>(u_.variables()));
-	} else if(key == "n"      || key == "s"       || key == "ne"      || key == "se"      || key == "nw" || key == "sw" ||
-	          key == "lawful" || key == "neutral" || key == "chaotic" || key == "liminal" ||
-	          key == "male"   || key == "female")
-	{
+	case unit_key::constant:
 		return variant(key);
 	}
 
@@ -656,31 +763,44 @@ void gamemap_callable::get_inputs(formula_input_vector& inputs) const
 variant gamemap_callable::get_value(const std::string& key) const
 {
 	if(key == "terrain") {
-		int w = get_gamemap().w();
-		int h = get_gamemap().h();
-
-		std::vector<variant> vars;
-		for(int i = 0; i < w; i++) {
-			for(int j = 0; j < h; j++) {
-				const map_location loc(i, j);
-				vars.emplace_back(std::make_shared<terrain_callable>(board_, loc));
+		if(terrain_.is_null()) {
+			int w = get_gamemap().w();
+			int h = get_gamemap().h();
+
+			std::vector<variant> vars;
+			vars.reserve(w * h);
+			for(int i = 0; i < w; i++) {
+				for(int j = 0; j < h; j++) {
+					const map_location loc(i, j);
+					vars.emplace_back(std::make_shared<terrain_callable>(board_, loc));
+				}
 			}
+
+			terrain_ = variant(vars);
 		}
 
-		return variant(vars);
+		return terrain_;
 	} else if(key == "gamemap") {
-		int w = get_gamemap().w();
-		int h = get_gamemap().h();
-
-		std::map<variant, variant> vars;
-		for(int i = 0; i < w; i++) {
-			for(int j = 0; j < h; j++) {
-				const map_location loc(i, j);
-				vars.emplace(std::make_shared<location_callable>(loc), std::make_shared<terrain_callable>(board_, loc));
+		if(gamemap_.is_null()) {
+			int w = get_gamemap().w();
+			int h = get_gamemap().h();
+
+			// The same callables as the terrain list, in the same order
+			const variant terrain = get_value("terrain");
+
+			std::map<variant, variant> vars;
+			std::size_t n = 0;
+			for(int i = 0; i < w; i++) {
+				for(int j = 0; j < h; j++) {
+					const map_location loc(i, j);
+					vars.emplace_hint(vars.end(), std::make_shared<location_callable>(loc), terrain[n++]);
+				}
 			}
+
+			gamemap_ = variant(vars);
 		}
 
-		return variant(vars);
+		return gamemap_;
 	} else if(key == "w") {
 		return variant(get_gamemap().w());
 	} else if(key == "h") {
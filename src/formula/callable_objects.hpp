@@ -72,7 +72,7 @@ private:
 class gamemap_callable : public formula_callable
 {
 public:
-	explicit gamemap_callable(const display_context& g) : board_(g)
+	explicit gamemap_callable(const display_context& g) : board_(g), terrain_(), gamemap_()
 	{}
 
 	void get_inputs(formula_input_vector& inputs) const override;
@@ -82,6 +82,15 @@ public:
 
 private:
 	const display_context& board_;
+
+	/**
+	 * The terrain list and the location to terrain map, built on first use.
+	 *
+	 * The terrain callables keep the village owners from when they were made,
+	 * so a map callable is meant to be used for one state of the game.
+	 */
+	mutable variant terrain_;
+	mutable variant gamemap_;
 };
 
 class location_callable : public formula_callable
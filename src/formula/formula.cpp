@@ -22,6 +22,7 @@
 #include "serialization/string_utils.hpp"
 #include "log.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <set>
 #include <sstream>
@@ -1036,6 +1037,12 @@ public:
 		return "'" + res + "'";
 	}
 
+	/** Whether the string has no substitutions, so always evaluates to the same value. */
+	bool is_constant() const
+	{
+		return subs_.empty();
+	}
+
 private:
 	variant execute(const formula_callable& variables, formula_debugger*fdb) const
 	{
@@ -1067,6 +1074,65 @@ private:
 	std::vector<substitution> subs_;
 };
 
+/** The precomputed value of a subexpression that does not depend on any variables. */
+class constant_expression : public formula_expression
+{
+public:
+	constant_expression(const variant& value, const std::string& str)
+		: value_(value), str_(str)
+	{
+	}
+
+	std::string str() const
+	{
+		return str_;
+	}
+
+private:
+	variant execute(const formula_callable& /*variables*/, formula_debugger* /*fdb*/) const
+	{
+		return value_;
+	}
+
+	variant value_;
+	std::string str_;
+};
+
+static bool is_constant(const expression_ptr& expr)
+{
+	if(dynamic_cast<const integer_expression*>(expr.get())
+		|| dynamic_cast<const decimal_expression*>(expr.get())
+		|| dynamic_cast<const constant_expression*>(expr.get())) {
+		return true;
+	}
+
+	const auto* str = dynamic_cast<const string_expression*>(expr.get());
+	return str && str->is_constant();
+}
+
+/**
+ * Replaces an operator or a pure function applied to constant operands by its
+ * result, so that it is not recomputed every time the formula is evaluated. Unit and filter
+ * formulas are evaluated for many units and hexes, which makes this add up.
+ *
+ * Operations that fail (like a division by zero) are left alone so that they
+ * report their error on evaluation, as before.
+ */
+static expression_ptr fold_constants(const expression_ptr& expr, const std::vector<expression_ptr>& operands)
+{
+	if(!std::all_of(operands.begin(), operands.end(), &is_constant)) {
+		return expr;
+	}
+
+	static map_formula_callable null_callable;
+	try {
+		return std::make_shared<constant_expression>(expr->evaluate(null_callable), expr->str());
+	} catch(const type_error&) {
+		return expr;
+	} catch(const formula_error&) {
+		return expr;
+	}
+}
 
 /**
  * Functions to handle the actual parsing of WFL.
@@ -1432,7 +1498,9 @@ expression_ptr parse_expression(const tk::token* i1, const tk::token* i2, functi
 				std::vector<expression_ptr> args;
 				parse_args(i1+2,i2-1,&args,symbols);
 				try{
-					return symbols->create_function(std::string(i1->begin, i1->end),args);
+					const std::string name(i1->begin, i1->end);
+					expression_ptr res = symbols->create_function(name, args);
+					return symbols->is_pure(name) ? fold_constants(res, args) : res;
 				}
 				catch(const formula_error& e) {
 					throw formula_error(e.type, tokens_to_string(function_call_begin, function_call_end), *i1->filename, i1->line_number);
@@ -1449,8 +1517,9 @@ expression_ptr parse_expression(const tk::token* i1, const tk::token* i2, functi
 
 	if(op == i1) {
 		try{
-			return expression_ptr(
-				new unary_operator_expression(std::string(op->begin, op->end), parse_expression(op + 1, i2 ,symbols)));
+			expression_ptr operand = parse_expression(op + 1, i2 ,symbols);
+			return fold_constants(expression_ptr(
+				new unary_operator_expression(std::string(op->begin, op->end), operand)), {operand});
 		} catch(const formula_error& e)	{
 			throw formula_error( e.type, tokens_to_string(begin,end - 1), *op->filename, op->line_number);
 		}
@@ -1474,12 +1543,16 @@ expression_ptr parse_expression(const tk::token* i1, const tk::token* i2, functi
 		return std::make_shared<where_expression>(parse_expression(i1, op, symbols), table);
 	}
 
-	return expression_ptr(
-		new operator_expression(op_name,
-			parse_expression(i1,     op, symbols),
-			parse_expression(op + 1, i2, symbols)
-		)
-	);
+	expression_ptr left = parse_expression(i1, op, symbols);
+	expression_ptr right = parse_expression(op + 1, i2, symbols);
+	expression_ptr expr(new operator_expression(op_name, left, right));
+
+	// Dice rolls are random, so they must be rolled anew every time.
+	if(op_name == "d") {
+		return expr;
+	}
+
+	return fold_constants(expr, {left, right});
 }
 
 } // namespace wfl
@@ -172,29 +172,182 @@ DEFINE_WFL_FUNCTION(abs, 1, 1)
 	}
 }
 
-DEFINE_WFL_FUNCTION(min, 1, -1)
+namespace
+{
+/**
+ * Evaluates the formula of choose(), filter(), find() or map() for each of @a items,
+ * calling @a fn with the item and the value until it returns false.
+ *
+ * @param args The arguments of the call: the items, optionally the name the
+ *             formula uses for the current item, and the formula.
+ */
+template<typename Fn>
+void for_each_item(const function_expression::args_list& args,
+		const variant& items,
+		const formula_callable& variables,
+		formula_debugger* fdb,
+		const Fn& fn)
+{
+	if(args.size() == 2) {
+		for(variant_iterator it = items.begin(); it != items.end(); ++it) {
+			const variant item = *it;
+			if(!fn(item, args[1]->evaluate(formula_variant_callable_with_backup(item, variables), fdb))) {
+				return;
+			}
+		}
+
+		return;
+	}
+
+	map_formula_callable self_callable;
+	const std::string self = args[1]->evaluate(variables, fdb).as_string();
+
+	for(variant_iterator it = items.begin(); it != items.end(); ++it) {
+		const variant item = *it;
+		self_callable.add(self, item);
+
+		const variant val = args.back()->evaluate(
+			formula_callable_with_backup(self_callable, formula_variant_callable_with_backup(item, variables)), fdb);
+
+		if(!fn(item, val)) {
+			return;
+		}
+	}
+}
+} // end anon namespace
+
+/** filter(), which size() asks for the number of matches without building the list of them. */
+class filter_function : public function_expression
+{
+public:
+	explicit filter_function(const args_list& args)
+		: function_expression("filter", args, 2, 3)
+	{
+	}
+
+	/** @return The number of items or entries the result of the call would have. */
+	int count(const formula_callable& variables) const;
+
+private:
+	variant execute(const formula_callable& variables, formula_debugger* fdb) const;
+};
+
+/** map(), whose values min() and max() go through without building the list of them. */
+class map_function : public function_expression
+{
+public:
+	explicit map_function(const args_list& args)
+		: function_expression("map", args, 2, 3)
+	{
+	}
+
+	/** Evaluates the list or map the call goes through. */
+	variant items(const formula_callable& variables) const
+	{
+		call_stack_manager manager(get_name());
+		return args()[0]->evaluate(variables);
+	}
+
+	/** @return The result of the call for @a items. */
+	variant apply(const variant& items, const formula_callable& variables, formula_debugger* fdb) const;
+
+	/** Calls @a fn with each value the result of the call for @a items would have, in order. */
+	template<typename Fn>
+	void for_each_value(const variant& items, const formula_callable& variables, const Fn& fn) const
+	{
+		call_stack_manager manager(get_name());
+		for_each_item(args(), items, variables, nullptr, [&fn](const variant& /*item*/, const variant& val) {
+			fn(val);
+			return true;
+		});
+	}
+
+private:
+	variant execute(const formula_callable& variables, formula_debugger* fdb) const
+	{
+		return apply(args()[0]->evaluate(variables, fdb), variables, fdb);
+	}
+};
+
+namespace
+{
+/**
+ * Evaluates an argument of min() or max(), replacing a list by its first element
+ * that no other is @a better than.
+ *
+ * The values of a map() over a list are compared as they come, without building
+ * the list of them.
+ *
+ * @param empty Set if the argument is an empty list, which gives null.
+ */
+template<typename Better>
+variant best_of_arg(const expression_ptr& arg,
+		const formula_callable& variables,
+		formula_debugger* fdb,
+		const Better& better,
+		bool& empty)
 {
-	variant res = args()[0]->evaluate(variables, fdb);
+	empty = false;
+
+	variant res;
+	const auto* map = fdb == nullptr ? dynamic_cast<const map_function*>(arg.get()) : nullptr;
+
+	if(map) {
+		const variant items = map->items(variables);
+		if(!items.is_list()) {
+			res = map->apply(items, variables, fdb);
+		} else if(items.is_empty()) {
+			empty = true;
+			return variant();
+		} else {
+			bool first = true;
+			map->for_each_value(items, variables, [&](const variant& val) {
+				if(first || better(val, res)) {
+					res = val;
+					first = false;
+				}
+			});
+
+			return res;
+		}
+	} else {
+		res = arg->evaluate(variables, fdb);
+	}
+
 	if(res.is_list()) {
 		if(res.is_empty()) {
-			throw formula_error("min(list): list is empty", "", "", 0);
+			empty = true;
+			return variant();
+		}
+
+		variant_iterator best = res.begin();
+		for(variant_iterator it = best; it != res.end(); ++it) {
+			if(better(*it, *best)) {
+				best = it;
+			}
 		}
 
-		res = *std::min_element(res.begin(), res.end());
+		res = *best;
 	}
 
-	for(std::size_t n = 1; n < args().size(); ++n) {
-		variant v = args()[n]->evaluate(variables, fdb);
+	return res;
+}
+} // end anon namespace
 
-		if(v.is_list()) {
-			if(v.is_empty()) {
-				continue;
-			}
+DEFINE_WFL_FUNCTION(min, 1, -1)
+{
+	const auto less = [](const variant& a, const variant& b) { return a < b; };
 
-			v = *std::min_element(v.begin(), v.end());
-		}
+	bool empty;
+	variant res = best_of_arg(args()[0], variables, fdb, less, empty);
+	if(empty) {
+		throw formula_error("min(list): list is empty", "", "", 0);
+	}
+
+	for(std::size_t n = 1; n < args().size(); ++n) {
+		const variant v = best_of_arg(args()[n], variables, fdb, less, empty);
 
-		if(res.is_null() || v < res) {
+		if(!empty && (res.is_null() || v < res)) {
 			res = v;
 		}
 	}
@@ -204,27 +357,18 @@ DEFINE_WFL_FUNCTION(min, 1, -1)
 
 DEFINE_WFL_FUNCTION(max, 1, -1)
 {
-	variant res = args()[0]->evaluate(variables, fdb);
-	if(res.is_list()) {
-		if(res.is_empty()) {
-			throw formula_error("max(list): list is empty", "", "", 0);
-		}
+	const auto greater = [](const variant& a, const variant& b) { return a > b; };
 
-		res = *std::max_element(res.begin(), res.end());
+	bool empty;
+	variant res = best_of_arg(args()[0], variables, fdb, greater, empty);
+	if(empty) {
+		throw formula_error("max(list): list is empty", "", "", 0);
 	}
 
 	for(std::size_t n = 1; n < args().size(); ++n) {
-		variant v = args()[n]->evaluate(variables, fdb);
-
-		if(v.is_list()) {
-			if(v.is_empty()) {
-				continue;
-			}
-
-			v = *std::max_element(v.begin(), v.end());
-		}
+		const variant v = best_of_arg(args()[n], variables, fdb, greater, empty);
 
-		if(res.is_null() || v > res) {
+		if(!empty && (res.is_null() || v > res)) {
 			res = v;
 		}
 	}
@@ -653,39 +797,20 @@ DEFINE_WFL_FUNCTION(choose, 2, 3)
 {
 	const variant items = args()[0]->evaluate(variables, fdb);
 	variant max_value;
-	variant_iterator max;
-
-	if(args().size() == 2) {
-		for(variant_iterator it = items.begin(); it != items.end(); ++it) {
-			const variant val = args().back()->evaluate(formula_variant_callable_with_backup(*it, variables), fdb);
-
-			if(max == variant_iterator() || val > max_value) {
-				max = it;
-				max_value = val;
-			}
-		}
-	} else {
-		map_formula_callable self_callable;
-		const std::string self = args()[1]->evaluate(variables, fdb).as_string();
-
-		for(variant_iterator it = items.begin(); it != items.end(); ++it) {
-			self_callable.add(self, *it);
-
-			const variant val = args().back()->evaluate(
-				formula_callable_with_backup(self_callable, formula_variant_callable_with_backup(*it, variables)), fdb);
-
-			if(max == variant_iterator() || val > max_value) {
-				max = it;
-				max_value = val;
-			}
+	variant max;
+	bool found = false;
+
+	for_each_item(args(), items, variables, fdb, [&](const variant& item, const variant& val) {
+		if(!found || val > max_value) {
+			max = item;
+			max_value = val;
+			found = true;
 		}
-	}
 
-	if(max == variant_iterator()) {
-		return variant();
-	}
+		return true;
+	});
 
-	return *max;
+	return max;
 }
 
 DEFINE_WFL_FUNCTION(wave, 1, 1)
@@ -813,119 +938,111 @@ DEFINE_WFL_FUNCTION(find_string, 2, 2)
 	return variant(static_cast<int>(pos));
 }
 
-DEFINE_WFL_FUNCTION(filter, 2, 3)
+variant filter_function::execute(const formula_callable& variables, formula_debugger* fdb) const
 {
-	std::vector<variant> list_vars;
-	std::map<variant, variant> map_vars;
-
 	const variant items = args()[0]->evaluate(variables, fdb);
 
-	if(args().size() == 2) {
-		for(variant_iterator it = items.begin(); it != items.end(); ++it) {
-			const variant val = args()[1]->evaluate(formula_variant_callable_with_backup(*it, variables), fdb);
+	if(items.is_map()) {
+		std::map<variant, variant> map_vars;
 
+		for_each_item(args(), items, variables, fdb, [&map_vars](const variant& item, const variant& val) {
 			if(val.as_bool()) {
-				if(items.is_map()) {
-					map_vars[(*it).get_member("key")] = (*it).get_member("value");
-				} else {
-					list_vars.push_back(*it);
-				}
+				// The entries come in order
+				map_vars.emplace_hint(map_vars.end(), item.get_member("key"), item.get_member("value"));
 			}
-		}
-	} else {
-		map_formula_callable self_callable;
-		const std::string self = args()[1]->evaluate(variables, fdb).as_string();
 
-		for(variant_iterator it = items.begin(); it != items.end(); ++it) {
-			self_callable.add(self, *it);
+			return true;
+		});
 
-			const variant val = args()[2]->evaluate(
-				formula_callable_with_backup(self_callable, formula_variant_callable_with_backup(*it, variables)), fdb);
+		return variant(map_vars);
+	}
 
-			if(val.as_bool()) {
-				if(items.is_map()) {
-					map_vars[(*it).get_member("key")] = (*it).get_member("value");
-				} else {
-					list_vars.push_back(*it);
-				}
+	// The items are only copied from the first one that doesn't pass, so a list
+	// that passes as a whole is returned as it is.
+	std::vector<variant> list_vars;
+	std::size_t index = 0;
+	bool all = true;
+
+	for_each_item(args(), items, variables, fdb, [&](const variant& item, const variant& val) {
+		if(!val.as_bool()) {
+			if(all) {
+				const std::vector<variant>& list = items.as_list();
+				list_vars.assign(list.begin(), list.begin() + index);
+				all = false;
 			}
+		} else if(!all) {
+			list_vars.push_back(item);
 		}
-	}
 
-	if(items.is_map()) {
-		return variant(map_vars);
+		++index;
+		return true;
+	});
+
+	if(all && items.is_list()) {
+		return items;
 	}
 
 	return variant(list_vars);
 }
 
-DEFINE_WFL_FUNCTION(find, 2, 3)
+int filter_function::count(const formula_callable& variables) const
 {
-	const variant items = args()[0]->evaluate(variables, fdb);
-
-	if(args().size() == 2) {
-		for(variant_iterator it = items.begin(); it != items.end(); ++it) {
-			const variant val = args()[1]->evaluate(formula_variant_callable_with_backup(*it, variables), fdb);
-			if(val.as_bool()) {
-				return *it;
-			}
-		}
-	} else {
-		map_formula_callable self_callable;
-		const std::string self = args()[1]->evaluate(variables, fdb).as_string();
-
-		for(variant_iterator it = items.begin(); it != items.end(); ++it) {
-			self_callable.add(self, *it);
+	call_stack_manager manager(get_name());
 
-			const variant val = args().back()->evaluate(
-				formula_callable_with_backup(self_callable, formula_variant_callable_with_backup(*it, variables)), fdb);
+	const variant items = args()[0]->evaluate(variables);
+	int res = 0;
 
-			if(val.as_bool()) {
-				return *it;
-			}
+	for_each_item(args(), items, variables, nullptr, [&res](const variant& /*item*/, const variant& val) {
+		if(val.as_bool()) {
+			++res;
 		}
-	}
 
-	return variant();
+		return true;
+	});
+
+	return res;
 }
 
-DEFINE_WFL_FUNCTION(map, 2, 3)
+DEFINE_WFL_FUNCTION(find, 2, 3)
 {
-	std::vector<variant> list_vars;
-	std::map<variant, variant> map_vars;
 	const variant items = args()[0]->evaluate(variables, fdb);
+	variant res;
 
-	if(args().size() == 2) {
-		for(variant_iterator it = items.begin(); it != items.end(); ++it) {
-			const variant val = args().back()->evaluate(formula_variant_callable_with_backup(*it, variables), fdb);
-			if(items.is_map()) {
-				map_vars[(*it).get_member("key")] = val;
-			} else {
-				list_vars.push_back(val);
-			}
+	for_each_item(args(), items, variables, fdb, [&res](const variant& item, const variant& val) {
+		if(val.as_bool()) {
+			res = item;
+			return false;
 		}
-	} else {
-		map_formula_callable self_callable;
-		const std::string self = args()[1]->evaluate(variables, fdb).as_string();
 
-		for(variant_iterator it = items.begin(); it != items.end(); ++it) {
-			self_callable.add(self, *it);
+		return true;
+	});
 
-			const variant val = args().back()->evaluate(
-				formula_callable_with_backup(self_callable, formula_variant_callable_with_backup(*it, variables)), fdb);
-
-			if(items.is_map()) {
-				map_vars[(*it).get_member("key")] = val;
-			} else {
-				list_vars.push_back(val);
-			}
-		}
-	}
+	return res;
+}
 
+variant map_function::apply(const variant& items, const formula_callable& variables, formula_debugger* fdb) const
+{
 	if(items.is_map()) {
+		std::map<variant, variant> map_vars;
+
+		for_each_item(args(), items, variables, fdb, [&map_vars](const variant& item, const variant& val) {
+			map_vars.emplace_hint(map_vars.end(), item.get_member("key"), val);
+			return true;
+		});
+
 		return variant(map_vars);
 	}
 
+	std::vector<variant> list_vars;
+	if(items.is_list()) {
+		list_vars.reserve(items.num_elements());
+	}
+
+	for_each_item(args(), items, variables, fdb, [&list_vars](const variant& /*item*/, const variant& val) {
+		list_vars.push_back(val);
+		return true;
+	});
+
 	return variant(list_vars);
 }
 
@@ -1124,6 +1241,11 @@ DEFINE_WFL_FUNCTION(tail, 1, 2)
 
 DEFINE_WFL_FUNCTION(size, 1, 1)
 {
+	// size(filter(...)) counts the matches rather than building the list of them
+	if(const auto* filter = dynamic_cast<const filter_function*>(args()[0].get()); filter && fdb == nullptr) {
+		return variant(filter->count(variables));
+	}
+
 	const variant items = args()[0]->evaluate(variables, fdb);
 	return variant(static_cast<int>(items.num_elements()));
 }
@@ -1480,6 +1602,16 @@ expression_ptr function_symbol_table::create_function(
 	throw formula_error("Unknown function: " + fn, "", "", 0);
 }
 
+bool function_symbol_table::is_pure(const std::string& fn) const
+{
+	const auto i = custom_formulas_.find(fn);
+	if(i != custom_formulas_.end()) {
+		return i->second->is_pure();
+	}
+
+	return parent && parent->is_pure(fn);
+}
+
 std::set<std::string> function_symbol_table::get_function_names() const
 {
 	std::set<std::string> res;
@@ -1506,17 +1638,17 @@ std::shared_ptr<function_symbol_table> function_symbol_table::get_builtins()
 		DECLARE_WFL_FUNCTION(dir);
 		DECLARE_WFL_FUNCTION(if);
 		DECLARE_WFL_FUNCTION(switch);
-		DECLARE_WFL_FUNCTION(abs);
-		DECLARE_WFL_FUNCTION(min);
-		DECLARE_WFL_FUNCTION(max);
+		DECLARE_PURE_WFL_FUNCTION(abs);
+		DECLARE_PURE_WFL_FUNCTION(min);
+		DECLARE_PURE_WFL_FUNCTION(max);
 		DECLARE_WFL_FUNCTION(choose);
 		DECLARE_WFL_FUNCTION(debug_float);
 		DECLARE_WFL_FUNCTION(debug_print);
 		DECLARE_WFL_FUNCTION(debug_profile);
-		DECLARE_WFL_FUNCTION(wave);
+		DECLARE_PURE_WFL_FUNCTION(wave);
 		DECLARE_WFL_FUNCTION(sort);
-		DECLARE_WFL_FUNCTION(contains_string);
-		DECLARE_WFL_FUNCTION(find_string);
+		DECLARE_PURE_WFL_FUNCTION(contains_string);
+		DECLARE_PURE_WFL_FUNCTION(find_string);
 		DECLARE_WFL_FUNCTION(reverse);
 		DECLARE_WFL_FUNCTION(filter);
 		DECLARE_WFL_FUNCTION(find);
@@ -1524,51 +1656,51 @@ std::shared_ptr<function_symbol_table> function_symbol_table::get_builtins()
 		DECLARE_WFL_FUNCTION(zip);
 		DECLARE_WFL_FUNCTION(take_while);
 		DECLARE_WFL_FUNCTION(reduce);
-		DECLARE_WFL_FUNCTION(sum);
-		DECLARE_WFL_FUNCTION(head);
-		DECLARE_WFL_FUNCTION(tail);
-		DECLARE_WFL_FUNCTION(size);
+		DECLARE_PURE_WFL_FUNCTION(sum);
+		DECLARE_PURE_WFL_FUNCTION(head);
+		DECLARE_PURE_WFL_FUNCTION(tail);
+		DECLARE_PURE_WFL_FUNCTION(size);
 		DECLARE_WFL_FUNCTION(null);
-		DECLARE_WFL_FUNCTION(ceil);
-		DECLARE_WFL_FUNCTION(floor);
-		DECLARE_WFL_FUNCTION(trunc);
-		DECLARE_WFL_FUNCTION(frac);
-		DECLARE_WFL_FUNCTION(sgn);
-		DECLARE_WFL_FUNCTION(round);
-		DECLARE_WFL_FUNCTION(as_decimal);
+		DECLARE_PURE_WFL_FUNCTION(ceil);
+		DECLARE_PURE_WFL_FUNCTION(floor);
+		DECLARE_PURE_WFL_FUNCTION(trunc);
+		DECLARE_PURE_WFL_FUNCTION(frac);
+		DECLARE_PURE_WFL_FUNCTION(sgn);
+		DECLARE_PURE_WFL_FUNCTION(round);
+		DECLARE_PURE_WFL_FUNCTION(as_decimal);
 		DECLARE_WFL_FUNCTION(pair);
-		DECLARE_WFL_FUNCTION(loc);
-		DECLARE_WFL_FUNCTION(distance_between);
-		DECLARE_WFL_FUNCTION(adjacent_locs);
-		DECLARE_WFL_FUNCTION(are_adjacent);
-		DECLARE_WFL_FUNCTION(relative_dir);
-		DECLARE_WFL_FUNCTION(direction_from);
-		DECLARE_WFL_FUNCTION(rotate_loc_around);
-		DECLARE_WFL_FUNCTION(index_of);
+		DECLARE_PURE_WFL_FUNCTION(loc);
+		DECLARE_PURE_WFL_FUNCTION(distance_between);
+		DECLARE_PURE_WFL_FUNCTION(adjacent_locs);
+		DECLARE_PURE_WFL_FUNCTION(are_adjacent);
+		DECLARE_PURE_WFL_FUNCTION(relative_dir);
+		DECLARE_PURE_WFL_FUNCTION(direction_from);
+		DECLARE_PURE_WFL_FUNCTION(rotate_loc_around);
+		DECLARE_PURE_WFL_FUNCTION(index_of);
 		DECLARE_WFL_FUNCTION(keys);
 		DECLARE_WFL_FUNCTION(values);
 		DECLARE_WFL_FUNCTION(tolist);
 		DECLARE_WFL_FUNCTION(tomap);
-		DECLARE_WFL_FUNCTION(substring);
-		DECLARE_WFL_FUNCTION(replace);
-		DECLARE_WFL_FUNCTION(length);
-		DECLARE_WFL_FUNCTION(concatenate);
-		DECLARE_WFL_FUNCTION(sin);
-		DECLARE_WFL_FUNCTION(cos);
-		DECLARE_WFL_FUNCTION(tan);
-		DECLARE_WFL_FUNCTION(asin);
-		DECLARE_WFL_FUNCTION(acos);
-		DECLARE_WFL_FUNCTION(atan);
-		DECLARE_WFL_FUNCTION(sqrt);
-		DECLARE_WFL_FUNCTION(cbrt);
-		DECLARE_WFL_FUNCTION(root);
-		DECLARE_WFL_FUNCTION(log);
-		DECLARE_WFL_FUNCTION(exp);
-		DECLARE_WFL_FUNCTION(pi);
-		DECLARE_WFL_FUNCTION(hypot);
-		DECLARE_WFL_FUNCTION(type);
-		DECLARE_WFL_FUNCTION(lerp);
-		DECLARE_WFL_FUNCTION(clamp);
+		DECLARE_PURE_WFL_FUNCTION(substring);
+		DECLARE_PURE_WFL_FUNCTION(replace);
+		DECLARE_PURE_WFL_FUNCTION(length);
+		DECLARE_PURE_WFL_FUNCTION(concatenate);
+		DECLARE_PURE_WFL_FUNCTION(sin);
+		DECLARE_PURE_WFL_FUNCTION(cos);
+		DECLARE_PURE_WFL_FUNCTION(tan);
+		DECLARE_PURE_WFL_FUNCTION(asin);
+		DECLARE_PURE_WFL_FUNCTION(acos);
+		DECLARE_PURE_WFL_FUNCTION(atan);
+		DECLARE_PURE_WFL_FUNCTION(sqrt);
+		DECLARE_PURE_WFL_FUNCTION(cbrt);
+		DECLARE_PURE_WFL_FUNCTION(root);
+		DECLARE_PURE_WFL_FUNCTION(log);
+		DECLARE_PURE_WFL_FUNCTION(exp);
+		DECLARE_PURE_WFL_FUNCTION(pi);
+		DECLARE_PURE_WFL_FUNCTION(hypot);
+		DECLARE_PURE_WFL_FUNCTION(type);
+		DECLARE_PURE_WFL_FUNCTION(lerp);
+		DECLARE_PURE_WFL_FUNCTION(clamp);
 	}
 
 	return std::shared_ptr<function_symbol_table>(&functions_table, [](function_symbol_table*) {});
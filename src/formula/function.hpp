@@ -47,6 +47,13 @@ namespace wfl
 #define DECLARE_WFL_FUNCTION(name)                                                                                     \
 	functions_table.add_function(#name, std::make_shared<builtin_formula_function<name##_function>>(#name))
 
+/**
+ * Like DECLARE_WFL_FUNCTION, for a function whose result only depends on its arguments and which
+ * has no side effects. Calls of it with constant arguments are evaluated once, when parsed.
+ */
+#define DECLARE_PURE_WFL_FUNCTION(name)                                                                                \
+	functions_table.add_function(#name, std::make_shared<builtin_formula_function<name##_function>>(#name, true))
+
 /**
  * Provides debugging information for error messages.
  */
@@ -181,6 +188,12 @@ public:
 
 	virtual function_expression_ptr generate_function_expression(const std::vector<expression_ptr>& args) const = 0;
 
+	/** Whether calls with the same arguments always give the same result, without side effects. */
+	virtual bool is_pure() const
+	{
+		return false;
+	}
+
 	virtual ~formula_function()
 	{
 	}
@@ -215,8 +228,9 @@ template<typename T>
 class builtin_formula_function : public formula_function
 {
 public:
-	builtin_formula_function(const std::string& name)
+	builtin_formula_function(const std::string& name, bool pure = false)
 		: formula_function(name)
+		, pure_(pure)
 	{
 	}
 
@@ -224,6 +238,14 @@ public:
 	{
 		return std::make_shared<T>(args);
 	}
+
+	bool is_pure() const
+	{
+		return pure_;
+	}
+
+private:
+	bool pure_;
 };
 
 typedef std::shared_ptr<formula_function> formula_function_ptr;
@@ -238,6 +260,9 @@ public:
 
 	expression_ptr create_function(const std::string& fn, const std::vector<expression_ptr>& args) const;
 
+	/** @return Whether @a fn resolves to a pure function, see formula_function::is_pure. */
+	bool is_pure(const std::string& fn) const;
+
 	std::set<std::string> get_function_names() const;
 
 	bool empty() const
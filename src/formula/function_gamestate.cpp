@@ -415,7 +415,7 @@ DEFINE_WFL_FUNCTION(tod_bonus, 0, 2)
 			}
 		}
 	}
-	int bonus = resources::tod_manager->get_illuminated_time_of_day(resources::gameboard->units(), resources::gameboard->map(), loc, turn).lawful_bonus;
+	int bonus = resources::tod_manager->get_illuminated_lawful_bonus(resources::gameboard->units(), resources::gameboard->map(), loc, turn);
 	return variant(bonus);
 }
 
@@ -39,6 +39,41 @@ namespace wfl
 // Static value to initialize null variants to ensure its value is never nullptr.
 static value_base_ptr null_value(new variant_value_base);
 
+// Integer and string values are immutable once constructed, so the common small
+// integers and the empty string are shared instead of allocated for every variant.
+static const int small_int_min = -128;
+static const int small_int_max = 1024;
+
+static value_base_ptr make_int_value(int n)
+{
+	if(n < small_int_min || n >= small_int_max) {
+		return std::make_shared<variant_int>(n);
+	}
+
+	static const std::vector<value_base_ptr> small_ints = [] {
+		std::vector<value_base_ptr> res;
+		res.reserve(small_int_max - small_int_min);
+
+		for(int i = small_int_min; i < small_int_max; ++i) {
+			res.push_back(std::make_shared<variant_int>(i));
+		}
+
+		return res;
+	}();
+
+	return small_ints[n - small_int_min];
+}
+
+static value_base_ptr make_string_value(const std::string& str)
+{
+	if(!str.empty()) {
+		return std::make_shared<variant_string>(str);
+	}
+
+	static const value_base_ptr empty_string = std::make_shared<variant_string>(str);
+	return empty_string;
+}
+
 static std::string variant_type_to_string(formula_variant::type type)
 {
 	return formula_variant::get_string(type);
@@ -145,7 +180,7 @@ variant::variant()
 {}
 
 variant::variant(int n)
-	: value_(std::make_shared<variant_int>(n))
+	: value_(make_int_value(n))
 {
 	assert(value_.get());
 }
@@ -169,7 +204,7 @@ variant::variant(const std::vector<variant>& vec)
 }
 
 variant::variant(const std::string& str)
-	: value_(std::make_shared<variant_string>(str))
+	: value_(make_string_value(str))
 {
 	assert(value_.get());
 }
@@ -291,26 +326,38 @@ variant variant::get_member(const std::string& name) const
 	return variant();
 }
 
-int variant::as_int() const
+int variant::numeric_value() const
 {
-	if(is_null())    { return 0; }
-	if(is_decimal()) { return as_decimal() / 1000; }
+	return static_cast<const variant_numeric&>(*value_).get_numeric_value();
+}
 
-	must_be(formula_variant::type::integer);
-	return value_cast<variant_int>()->get_numeric_value();
+int variant::as_int() const
+{
+	switch(type()) {
+	case formula_variant::type::integer:
+		return numeric_value();
+	case formula_variant::type::decimal:
+		return numeric_value() / 1000;
+	case formula_variant::type::null:
+		return 0;
+	default:
+		must_be(formula_variant::type::integer);
+		return 0;
+	}
 }
 
 int variant::as_decimal() const
 {
-	if(is_decimal()) {
-		return value_cast<variant_decimal>()->get_numeric_value();
-	} else if(is_int()) {
-		return value_cast<variant_int>()->get_numeric_value() * 1000;
-	} else if(is_null()) {
+	switch(type()) {
+	case formula_variant::type::decimal:
+		return numeric_value();
+	case formula_variant::type::integer:
+		return numeric_value() * 1000;
+	case formula_variant::type::null:
 		return 0;
+	default:
+		throw type_error(was_expecting("an integer or a decimal", *this));
 	}
-
-	throw type_error(was_expecting("an integer or a decimal", *this));
 }
 
 bool variant::as_bool() const
@@ -366,6 +413,10 @@ variant variant::operator+(const variant& v) const
 		return variant(res);
 	}
 
+	if(is_int() && v.is_int()) {
+		return variant(numeric_value() + v.numeric_value());
+	}
+
 	if(is_decimal() || v.is_decimal()) {
 		return variant(as_decimal() + v.as_decimal() , DECIMAL_VARIANT);
 	}
@@ -488,6 +539,10 @@ variant variant::operator-() const
 
 bool variant::operator==(const variant& v) const
 {
+	if(value_ == v.value_) {
+		return true;
+	}
+
 	if(type() != v.type()) {
 		if(is_decimal() || v.is_decimal()) {
 			return as_decimal() == v.as_decimal();
@@ -159,6 +159,9 @@ private:
 		return wfl::value_cast<T>(value_);
 	}
 
+	/** Raw value of an integer or decimal variant. The caller must have checked the type. */
+	int numeric_value() const;
+
 	void must_be(formula_variant::type t) const;
 
 	void must_both_be(formula_variant::type t, const variant& second) const;
@@ -39,6 +39,9 @@ game_board::game_board(const config& level)
 	, map_(std::make_unique<gamemap>(level["map_data"]))
 	, unit_id_manager_(level["next_underlying_unit_id"])
 	, units_()
+	, unit_neighbours_()
+	, unit_neighbours_generation_(0)
+	, castle_networks_()
 {
 }
 
@@ -48,6 +51,9 @@ game_board::game_board(const game_board& other)
 	, map_(new gamemap(*(other.map_)))
 	, unit_id_manager_(other.unit_id_manager_)
 	, units_(other.units_)
+	, unit_neighbours_()
+	, unit_neighbours_generation_(0)
+	, castle_networks_(other.castle_networks_)
 {
 }
 
@@ -64,6 +70,7 @@ void swap(game_board& one, game_board& other)
 	std::swap(one.units_, other.units_);
 	std::swap(one.unit_id_manager_, other.unit_id_manager_);
 	one.map_.swap(other.map_);
+	one.castle_networks_.swap(other.castle_networks_);
 }
 
 void game_board::new_turn(int player_num)
@@ -219,6 +226,79 @@ unit* game_board::get_visible_unit(const map_location& loc, const team& current_
 	return &*ui;
 }
 
+bool game_board::may_be_in_zoc(const map_location& loc) const
+{
+	if(!map_->on_board(loc)) {
+		return true;
+	}
+
+	const std::size_t size = static_cast<std::size_t>(map_->w()) * map_->h();
+
+	// The generation alone doesn't notice replace_map(), so check the size too
+	if(unit_neighbours_generation_ != units_.generation() || unit_neighbours_.size() != size) {
+		unit_neighbours_.assign(size, false);
+
+		for(const unit& u : units_) {
+			for(const map_location& adj : get_adjacent_tiles(u.get_location())) {
+				if(map_->on_board(adj)) {
+					unit_neighbours_[adj.x + static_cast<std::size_t>(adj.y) * map_->w()] = true;
+				}
+			}
+		}
+
+		unit_neighbours_generation_ = units_.generation();
+	}
+
+	return unit_neighbours_[loc.x + static_cast<std::size_t>(loc.y) * map_->w()];
+}
+
+int game_board::castle_network(const map_location& loc) const
+{
+	if(!map_->on_board(loc)) {
+		return -1;
+	}
+
+	const int w = map_->w();
+
+	if(castle_networks_.empty()) {
+		castle_networks_.assign(static_cast<std::size_t>(w) * map_->h(), -1);
+
+		int network = 0;
+		std::vector<map_location> pending;
+		for(int y = 0; y < map_->h(); ++y) {
+			for(int x = 0; x < w; ++x) {
+				if(castle_networks_[x + static_cast<std::size_t>(y) * w] != -1 || !map_->is_castle(map_location(x, y))) {
+					continue;
+				}
+
+				// Flood fill the network starting at this hex.
+				castle_networks_[x + static_cast<std::size_t>(y) * w] = network;
+				pending.emplace_back(x, y);
+				while(!pending.empty()) {
+					const map_location hex = pending.back();
+					pending.pop_back();
+
+					for(const map_location& adj : get_adjacent_tiles(hex)) {
+						if(!map_->on_board(adj)) {
+							continue;
+						}
+
+						int& adj_network = castle_networks_[adj.x + static_cast<std::size_t>(adj.y) * w];
+						if(adj_network == -1 && map_->is_castle(adj)) {
+							adj_network = network;
+							pending.push_back(adj);
+						}
+					}
+				}
+
+				++network;
+			}
+		}
+	}
+
+	return castle_networks_[loc.x + static_cast<std::size_t>(loc.y) * w];
+}
+
 void game_board::side_drop_to(int side_num, side_controller::type ctrl, side_proxy_controller::type proxy)
 {
 	team& tm = get_team(side_num);
@@ -320,6 +400,7 @@ std::optional<std::string> game_board::replace_map(const gamemap& newmap)
 	}
 
 	*map_ = newmap;
+	castle_networks_.clear();
 	return ret;
 }
 
@@ -369,6 +450,7 @@ bool game_board::change_terrain(const map_location &loc, const t_translation::te
 	}
 
 	map_->set_terrain(loc, new_t);
+	castle_networks_.clear();
 
 	for(const t_translation::terrain_code& ut : map_->underlying_union_terrain(loc)) {
 		preferences::encountered_terrains().insert(ut);
@@ -58,6 +58,14 @@ class game_board : public display_context
 	n_unit::id_manager unit_id_manager_;
 	unit_map units_;
 
+	/** Hexes next to at least one unit, see may_be_in_zoc(). */
+	mutable std::vector<bool> unit_neighbours_;
+	/** The unit map generation unit_neighbours_ was built from. */
+	mutable std::size_t unit_neighbours_generation_;
+
+	/** The castle network of each hex, see castle_network(). Empty when outdated. */
+	mutable std::vector<int> castle_networks_;
+
 	/**
 	 * Temporary unit move structs:
 	 *
@@ -173,6 +181,23 @@ public:
 
 	unit* get_visible_unit(const map_location &loc, const team &current_team, bool see_all = false); //TODO: can this not return a pointer?
 
+	/**
+	 * Whether any unit at all is next to @a loc. If not, @a loc can't be in
+	 * any side's zone of control, whatever the sides and visibility involved.
+	 *
+	 * Backed by a bitmap that is rebuilt after the unit map changes.
+	 */
+	bool may_be_in_zoc(const map_location& loc) const;
+
+	/**
+	 * The castle network @a loc is part of, or -1 if it is not a castle.
+	 * Two castle hexes are in the same network if a path of castle hexes
+	 * joins them, so a leader on a keep can reach the hexes of its network.
+	 *
+	 * Computed for the whole map at once, and again after the terrain changes.
+	 */
+	int castle_network(const map_location& loc) const;
+
 	// Wrapped functions from unit_map. These should ultimately provide notification to observers, pathfinding.
 
 	unit_map::iterator find_unit(const map_location & loc) { return units_.find(loc); }
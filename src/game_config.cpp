@@ -46,6 +46,8 @@ std::string default_preferences_path = "";
 #endif
 bool check_migration = false;
 
+std::string lua_profile;
+
 std::string wesnoth_program_dir;
 
 //
@@ -74,6 +74,9 @@ namespace game_config
 	extern std::string default_preferences_path;
 	extern bool check_migration;
 
+	/** File the Lua sampling profiler writes to, enabled from the start if not empty. */
+	extern std::string lua_profile;
+
 	struct server_info
 	{
 		std::string name;
@@ -42,6 +42,7 @@
 #include "terrain/type_data.hpp"
 #include "theme.hpp"
 #include "units/types.hpp"
+#include "utils/perf_counter.hpp"
 
 static lg::log_domain log_config("config");
 #define ERR_CONFIG LOG_STREAM(err, log_config)
@@ -59,6 +60,8 @@ game_config_manager::game_config_manager(const commandline_options& cmdline_opts
 	, addon_cfgs_()
 	, active_addons_()
 	, old_defines_map_()
+	, loaded_key_()
+	, previous_load_()
 	, paths_manager_()
 	, cache_(game_config::config_cache::instance())
 {
@@ -75,6 +78,10 @@ game_config_manager::game_config_manager(const commandline_options& cmdline_opts
 		cache_.set_force_valid_cache(true);
 	}
 
+	if(cmdline_opts_.uncompressed_cache) {
+		cache_.set_cache_format(compression::format::none);
+	}
+
 	// Clean the cache of any old Wesnoth version's cache data
 	if(const std::string last_cleaned = preferences::get("_last_cache_cleaned_ver"); !last_cleaned.empty()) {
 		if(version_info{last_cleaned} < game_config::wesnoth_version) {
@@ -99,6 +106,23 @@ game_config_manager* game_config_manager::get()
 	return singleton;
 }
 
+std::size_t game_config_manager::memory_usage() const
+{
+	std::size_t res = game_config_.memory_usage();
+	for(const auto& [id, cfg] : addon_cfgs_) {
+		res += cfg.memory_usage();
+	}
+
+	if(previous_load_) {
+		res += previous_load_->game_config.memory_usage();
+		for(const auto& [id, cfg] : previous_load_->addon_cfgs) {
+			res += cfg.memory_usage();
+		}
+	}
+
+	return res;
+}
+
 bool game_config_manager::init_game_config(FORCE_RELOAD_CONFIG force_reload)
 {
 	// Add preproc defines according to the command line arguments.
@@ -167,6 +191,11 @@ void game_config_manager::load_game_config_with_loadscreen(
 
 	bool reload_everything = true;
 
+	// The data on disk may have changed, so the configs of the previous load can't be reused either.
+	if(force_reload == FORCE_RELOAD) {
+		previous_load_.reset();
+	}
+
 	// Game_config already holds requested config in memory.
 	if(!game_config_.empty()) {
 		if(force_reload == NO_FORCE_RELOAD && old_defines_map_ == cache_.get_preproc_map()) {
@@ -187,6 +216,8 @@ void game_config_manager::load_game_config_with_loadscreen(
 
 void game_config_manager::load_game_config(bool reload_everything, const game_classification* classification, const std::string& scenario_id)
 {
+	PERF_TIMER("game_config_manager::load_game_config");
+
 	// Make sure that 'debug mode' symbol is set
 	// if command line parameter is selected
 	// also if we're in multiplayer and actual debug mode is disabled.
@@ -201,9 +232,10 @@ void game_config_manager::load_game_config(bool reload_everything, const game_cl
 		// Load the selected core.
 		// Handle terrains so that they are last loaded from the core.
 		// Load every compatible addon.
-		if(reload_everything) {
+		const load_key key = requested_load_key();
+
+		if(reload_everything && !swap_in_previous_game_config(key)) {
 			gui2::dialogs::loading_screen::progress(loading_stage::verify_cache);
-			filesystem::data_tree_checksum();
 			gui2::dialogs::loading_screen::progress(loading_stage::create_cache);
 
 			// Start transaction so macros are shared.
@@ -320,6 +352,8 @@ void game_config_manager::load_game_config(bool reload_everything, const game_cl
 			if(!game_config::no_addons && !cmdline_opts_.noaddons) {
 				load_addons_cfg();
 			}
+
+			loaded_key_ = key;
 		}
 
 		// only after addon configs have been loaded do we check for which addons are needed and whether they exist to be used
@@ -390,6 +424,39 @@ void game_config_manager::load_game_config(bool reload_everything, const game_cl
 	paths_manager_.set_paths(game_config());
 }
 
+game_config_manager::load_key game_config_manager::requested_load_key() const
+{
+	return {cache_.get_preproc_map(), preferences::core_id(), game_config::no_addons || cmdline_opts_.noaddons};
+}
+
+/**
+ * Makes the configs of the previous full load current again if they were
+ * loaded for @a key. Otherwise the current configs become the previous load,
+ * leaving game_config_ and addon_cfgs_ empty for a full load.
+ *
+ * @returns  Whether the previous configs were swapped in.
+ */
+bool game_config_manager::swap_in_previous_game_config(const load_key& key)
+{
+	if(previous_load_ && previous_load_->key == key) {
+		LOG_CONFIG << "reusing the configs of the previous load";
+		std::swap(loaded_key_, previous_load_->key);
+		game_config_.swap(previous_load_->game_config);
+		addon_cfgs_.swap(previous_load_->addon_cfgs);
+		return true;
+	}
+
+	if(game_config_.empty()) {
+		return false;
+	}
+
+	previous_load_ = std::make_unique<previous_load>();
+	previous_load_->key = std::move(loaded_key_);
+	previous_load_->game_config.swap(game_config_);
+	previous_load_->addon_cfgs.swap(addon_cfgs_);
+	return false;
+}
+
 void game_config_manager::load_addons_cfg()
 {
 	const std::string user_campaign_dir = filesystem::get_addons_dir();
@@ -424,19 +491,11 @@ void game_config_manager::load_addons_cfg()
 
 	loading_screen::spin();
 
-	// Rerun the directory scan using filename only, to get the addon_ids more easily.
-	user_files.clear();
-	user_dirs.clear();
-
-	filesystem::get_files_in_dir(user_campaign_dir, nullptr, &user_dirs,
-		filesystem::name_mode::FILE_NAME_ONLY);
-
-	loading_screen::spin();
-
 	// Load the addons.
-	for(const std::string& addon_id : user_dirs) {
+	for(const std::string& addon_dir : user_dirs) {
+		// The directory names are the addon_ids; no need to scan the directory a second time.
+		const std::string addon_id = filesystem::base_name(addon_dir);
 		log_scope2(log_config, "Loading add-on '" + addon_id + "'");
-		const std::string addon_dir = user_campaign_dir + "/" + addon_id;
 
 		const std::string main_cfg = addon_dir + "/_main.cfg";
 		const std::string info_cfg = addon_dir + "/_info.cfg";
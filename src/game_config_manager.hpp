@@ -21,6 +21,8 @@
 #include "filesystem.hpp"
 #include "game_config_view.hpp"
 #include "terrain/type_data.hpp"
+
+#include <memory>
 #include <optional>
 
 class game_classification;
@@ -51,6 +53,9 @@ public:
 	void load_game_config_for_game(const game_classification& classification, const std::string& scenario_id);
 	void load_game_config_for_create(bool is_mp, bool is_test = false);
 
+	/** Approximate memory used by the loaded core and add-on configs, in bytes. */
+	std::size_t memory_usage() const;
+
 	static game_config_manager * get();
 
 
@@ -65,6 +70,9 @@ private:
 	void load_game_config_with_loadscreen(FORCE_RELOAD_CONFIG force_reload, const game_classification* classification, const std::string& scenario_id);
 
 	// load_game_config() helper functions.
+	struct load_key;
+	load_key requested_load_key() const;
+	bool swap_in_previous_game_config(const load_key& key);
 	void load_addons_cfg();
 	void set_multiplayer_hashes();
 	void set_unit_data();
@@ -79,6 +87,36 @@ private:
 
 	preproc_map old_defines_map_;
 
+	/** What the result of a full load of the game config depends on. */
+	struct load_key
+	{
+		preproc_map defines;
+		std::string core_id;
+		bool no_addons;
+
+		bool operator==(const load_key& o) const
+		{
+			return defines == o.defines && core_id == o.core_id && no_addons == o.no_addons;
+		}
+	};
+
+	/** The key game_config_ and addon_cfgs_ were loaded with. */
+	load_key loaded_key_;
+
+	/** The core and add-on configs of the full load before the current one. */
+	struct previous_load
+	{
+		load_key key;
+		config game_config;
+		std::map<std::string, config> addon_cfgs;
+	};
+
+	/**
+	 * Kept so that switching back to the previous defines (between the title
+	 * screen and the editor, for example) doesn't reload everything.
+	 */
+	std::unique_ptr<previous_load> previous_load_;
+
 	filesystem::binary_paths_manager paths_manager_;
 
 	game_config::config_cache& cache_;
@@ -124,7 +124,7 @@ void game_data::clear_variable(const std::string& varname)
 	}
 }
 
-void game_data::write_snapshot(config& cfg) const
+void game_data::write_snapshot(config& cfg, bool with_variables) const
 {
 	cfg["next_scenario"] = next_scenario_;
 	cfg["id"] = id_;
@@ -138,8 +138,9 @@ void game_data::write_snapshot(config& cfg) const
 	cfg["random_seed"] = rng_.get_random_seed_str();
 	cfg["random_calls"] = rng_.get_random_calls();
 
-	cfg.add_child("variables", variables_);
-
+	if(with_variables) {
+		cfg.add_child("variables", variables_);
+	}
 }
 
 namespace {
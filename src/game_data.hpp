@@ -91,7 +91,8 @@ public:
 	/** the last location where a select event fired. Used by wml menu items with needs_select=yes*/
 	map_location last_selected;
 
-	void write_snapshot(config& cfg) const;
+	/** @param with_variables     Whether to add [variables], which can be large. */
+	void write_snapshot(config& cfg, bool with_variables = true) const;
 
 	const std::string& next_scenario() const { return next_scenario_; }
 	void set_next_scenario(const std::string& next_scenario) { next_scenario_ = next_scenario; }
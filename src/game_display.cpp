@@ -81,6 +81,7 @@ game_display::game_display(game_board& board,
 	, chat_man_(new display_chat_manager(*this))
 	, mode_(RUNNING)
 	, needs_rebuild_(false)
+	, rebuild_locs_()
 {
 }
 
@@ -657,14 +658,26 @@ void game_display::needs_rebuild(bool b) {
 	}
 }
 
+void game_display::needs_rebuild(const map_location& loc) {
+	rebuild_locs_.insert(loc);
+}
+
 bool game_display::maybe_rebuild() {
 	if (needs_rebuild_) {
 		needs_rebuild_ = false;
+		rebuild_locs_.clear();
 		recalculate_minimap();
 		invalidate_all();
 		rebuild_all();
 		return true;
 	}
+	if (!rebuild_locs_.empty()) {
+		recalculate_minimap();
+		rebuild_region(rebuild_locs_);
+		invalidate_all();
+		rebuild_locs_.clear();
+		return true;
+	}
 	return false;
 }
 
@@ -226,7 +226,10 @@ public:
 	/** Sets whether the screen (map visuals) needs to be rebuilt. This is typically after the map has been changed by wml. */
 	void needs_rebuild(bool b);
 
-	/** Rebuilds the screen if needs_rebuild(true) was previously called, and resets the flag. */
+	/** Marks a single location whose terrain changed, to be rebuilt by the next maybe_rebuild(). */
+	void needs_rebuild(const map_location& loc);
+
+	/** Rebuilds the screen if needs_rebuild() was previously called, and resets the flag. */
 	bool maybe_rebuild();
 
 private:
@@ -256,4 +259,7 @@ private:
 
 	bool needs_rebuild_;
 
+	/** Changed locations, when only part of the map needs to be rebuilt. */
+	std::set<map_location> rebuild_locs_;
+
 };
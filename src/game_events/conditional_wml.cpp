@@ -55,24 +55,35 @@ namespace builtin_conditions {
 		}
 		std::vector<std::pair<int,int>> counts = cfg.has_attribute("count")
 			? utils::parse_ranges(cfg["count"]) : default_counts;
+
+		// Counting can stop as soon as more matches can't change the result:
+		// after the first one by default, or once past the highest count allowed.
+		const bool any_match = counts == default_counts;
+		int max_count = 0;
+		for(const auto& range : counts) {
+			max_count = std::max(max_count, range.second);
+		}
+		const auto done = [&](int match_count) {
+			return any_match ? match_count > 0 : match_count > max_count;
+		};
+
 		int match_count = 0;
 		const unit_filter ufilt(cfg);
 		for(const unit &i : resources::gameboard->units()) {
 			if(i.hitpoints() > 0 && ufilt(i)) {
 				++match_count;
-				if(counts == default_counts) {
-					// by default a single match is enough, so avoid extra work
+				if(done(match_count)) {
 					break;
 				}
 			}
 		}
-		if(cfg["search_recall_list"].to_bool()) {
+		if(!done(match_count) && cfg["search_recall_list"].to_bool()) {
 			for(const team& team : resources::gameboard->teams()) {
-				if(counts == default_counts && match_count) {
+				if(done(match_count)) {
 					break;
 				}
 				for(std::size_t t = 0; t < team.recall_list().size(); ++t) {
-					if(counts == default_counts && match_count) {
+					if(done(match_count)) {
 						break;
 					}
 					scoped_recall_unit auto_store("this_unit", team.save_id_or_number(), t);
@@ -97,12 +108,13 @@ namespace builtin_conditions {
 
 	bool variable_matches(const vconfig& values)
 	{
-		if(values["name"].blank()) {
+		const config::attribute_value name_attr = values["name"];
+		if(name_attr.blank()) {
 			lg::log_to_chat() << "[variable] with missing name=\n";
 			ERR_WML << "[variable] with missing name=";
 			return true;
 		}
-		const std::string name = values["name"];
+		const std::string name = name_attr;
 		config::attribute_value value = resources::gamedata->get_variable_const(name);
 
 		if(auto n = values.get_config().attribute_count(); n > 2) {
@@ -161,20 +173,26 @@ namespace builtin_conditions {
 }
 
 namespace { // Support functions
-	bool internal_conditional_passed(const vconfig& cond)
+	using condition_children = std::vector<std::pair<std::string, vconfig>>;
+
+	bool internal_conditional_passed(const condition_children& children)
 	{
-		if(cond.has_child("true")) {
+		const auto has_child = [&children](const std::string& key) {
+			return std::any_of(children.begin(), children.end(), [&key](const auto& child) { return child.first == key; });
+		};
+
+		if(has_child("true")) {
 			return true;
 		}
-		if(cond.has_child("false")) {
+		if(has_child("false")) {
 			return false;
 		}
 
 		static const std::set<std::string> skip
 			{"then", "else", "elseif", "not", "and", "or", "do"};
 
-		for(const auto& [key, filter] : cond.all_ordered()) {
-			if(std::find(skip.begin(), skip.end(), key) == skip.end()) {
+		for(const auto& [key, filter] : children) {
+			if(skip.count(key) == 0) {
 				assert(resources::lua_kernel);
 				if(!resources::lua_kernel->run_wml_conditional(key, filter)) {
 					return false;
@@ -190,10 +208,13 @@ namespace { // Support functions
 
 bool conditional_passed(const vconfig& cond)
 {
-	bool matches = internal_conditional_passed(cond);
+	// Walked once, as expanding [insert_tag] children reads variables each time.
+	const condition_children children(cond.ordered_begin(), cond.ordered_end());
+
+	bool matches = internal_conditional_passed(children);
 
 	// Handle [and], [or], and [not] with in-order precedence
-	for(const auto& [key, filter] : cond.all_ordered()) {
+	for(const auto& [key, filter] : children) {
 		// Handle [and]
 		if(key == "and") {
 			matches = matches && conditional_passed(filter);
@@ -56,6 +56,7 @@ event_handler::event_handler(const std::string& types, const std::string& id)
 	, is_menu_item_(false)
 	, disabled_(false)
 	, is_lua_(false)
+	, order_(0)
 	, id_(id)
 	, types_(types)
 {}
@@ -117,9 +118,15 @@ void event_handler::handle_event(const queued_event& event_info, game_lua_kernel
 
 bool event_handler::filter_event(const queued_event& ev) const
 {
-	return std::all_of(filters_.begin(), filters_.end(), [&ev](const auto& filter) {
-		return (*filter)(ev);
-	});
+	// Check the simple side and unit filters first, so that most handlers are
+	// rejected before evaluating any conditional, formula or Lua filter.
+	const auto passes = [this, &ev](bool costly) {
+		return std::all_of(filters_.begin(), filters_.end(), [&ev, costly](const auto& filter) {
+			return filter->costly() != costly || (*filter)(ev);
+		});
+	};
+
+	return passes(false) && passes(true);
 }
 
 void event_handler::write_config(config &cfg, bool include_nonserializable) const
@@ -210,6 +217,10 @@ struct filter_side : public event_filter {
 	{
 		return true;
 	}
+	bool costly() const override
+	{
+		return false;
+	}
 private:
 	side_filter ssf_;
 };
@@ -230,6 +241,10 @@ struct filter_unit : public event_filter {
 	{
 		return true;
 	}
+	bool costly() const override
+	{
+		return false;
+	}
 private:
 	unit_filter suf_;
 	bool first_;
@@ -256,6 +271,10 @@ struct filter_attack : public event_filter {
 	{
 		return true;
 	}
+	bool costly() const override
+	{
+		return false;
+	}
 private:
 	vconfig swf_;
 	bool first_;
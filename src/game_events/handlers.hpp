@@ -43,6 +43,11 @@ struct event_filter {
 	virtual void serialize(config& cfg) const;
 	/** Returns true if it is possible to serialize the filter into a config. */
 	virtual bool can_serialize() const;
+	/** Returns false for the simple filters which are checked before all others. */
+	virtual bool costly() const
+	{
+		return true;
+	}
 	virtual ~event_filter() = default;
 	event_filter() = default;
 private:
@@ -71,6 +76,17 @@ public:
 		return is_menu_item_;
 	}
 
+	/** Position in the order handlers were added in, which is the order they run in. */
+	std::size_t order() const
+	{
+		return order_;
+	}
+
+	void set_order(std::size_t order)
+	{
+		order_ = order;
+	}
+
 	/** Flag this handler as disabled. */
 	void disable();
 
@@ -148,6 +164,7 @@ private:
 	 * So, this flag allows avoiding false positives in the warning message.
 	 */
 	bool has_preloaded_;
+	std::size_t order_;
 	int event_ref_;
 	config args_;
 	std::vector<std::shared_ptr<event_filter>> filters_;
@@ -26,6 +26,8 @@
 #include "resources.hpp"
 #include "serialization/string_utils.hpp"
 
+#include <algorithm>
+
 static lg::log_domain log_engine("engine");
 #define DBG_NG LOG_STREAM(debug, log_engine)
 #define LOG_NG LOG_STREAM(info, log_engine)
@@ -201,39 +203,29 @@ void manager::execute_on_events(const std::string& event_id, manager::event_func
 {
 	const std::string standardized_event_id = event_handlers::standardize_name(event_id);
 	const game_data* gd = resources::gamedata;
-	auto& active_handlers = event_handlers_->get_active();
-
-	// Save the end outside the loop so the end point remains constant,
-	// even if new events are added to the queue.
-	const unsigned saved_end = active_handlers.size();
-
 
 	{
 		// Ensure that event handlers won't be cleaned up while we're iterating them.
 		event_handler_list_lock lock;
 
-		for (unsigned i = 0; i < saved_end; ++i) {
-			handler_ptr handler = nullptr;
-
-			try {
-				handler = active_handlers.at(i);
-			}
-			catch (const std::out_of_range&) {
-				continue;
-			}
+		// Taken before running any handler, so handlers added by this event don't run for it.
+		std::vector<handler_ptr> candidates = event_handlers_->get_candidates(standardized_event_id);
 
-			// Shouldn't happen, but we're just being safe.
-			if (!handler || handler->disabled()) {
+		for(handler_ptr& handler : candidates) {
+			if(handler->disabled()) {
 				continue;
 			}
 
-			// Could be more than one.
-			for(const std::string& name : handler->names(gd)) {
-				if(standardized_event_id == name) {
-					func(*this, handler);
-					break;
+			// The names of handlers with variables in them are checked now,
+			// as the previous handlers may have changed those variables.
+			if(utils::might_contain_variables(handler->names_raw())) {
+				const std::vector<std::string> names = handler->names(gd);
+				if(std::find(names.begin(), names.end(), standardized_event_id) == names.end()) {
+					continue;
 				}
 			}
+
+			func(*this, handler);
 		}
 	}
 
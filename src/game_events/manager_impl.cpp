@@ -22,6 +22,8 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <algorithm>
+
 static lg::log_domain log_engine("engine");
 #define DBG_NG LOG_STREAM(debug, log_engine)
 #define LOG_NG LOG_STREAM(info, log_engine)
@@ -88,6 +90,35 @@ handler_list& event_handlers::get(const std::string& name)
 	return find_it == by_name_.end() ? empty_list : find_it->second;
 }
 
+std::vector<handler_ptr> event_handlers::get_candidates(const std::string& name)
+{
+	std::vector<handler_ptr> res;
+
+	auto find_it = by_name_.find(name);
+	if(find_it != by_name_.end()) {
+		for(const weak_handler_ptr& ptr : find_it->second) {
+			if(handler_ptr handler = ptr.lock()) {
+				res.push_back(std::move(handler));
+			}
+		}
+	}
+
+	const std::size_t by_name_count = res.size();
+	for(const weak_handler_ptr& ptr : dynamic_) {
+		if(handler_ptr handler = ptr.lock()) {
+			res.push_back(std::move(handler));
+		}
+	}
+
+	// Both lists are already in order, and a handler listing the same name
+	// several times is filed under it as often.
+	const auto by_order = [](const handler_ptr& a, const handler_ptr& b) { return a->order() < b->order(); };
+	std::inplace_merge(res.begin(), res.begin() + by_name_count, res.end(), by_order);
+	res.erase(std::unique(res.begin(), res.end()), res.end());
+
+	return res;
+}
+
 /**
  * Adds an event handler.
  * An event with a nonempty ID will not be added if an event with that
@@ -137,6 +168,7 @@ void event_handlers::finish_adding_event_handler(handler_ptr handler)
 	// Do note active_ holds the main shared_ptr, and the other three containers
 	// construct weak_ptrs from the shared one.
 	DBG_EH << "inserting event handler for name=" << names << " with id=" << id;
+	handler->set_order(next_order_++);
 	active_.emplace_back(handler);
 
 	// File by name.
@@ -20,6 +20,7 @@
 
 #include <deque>
 #include <unordered_map>
+#include <vector>
 
 class game_lua_kernel;
 
@@ -76,6 +77,9 @@ private:
 	/** Allows quick locating of handlers by id. */
 	id_map_t id_map_;
 
+	/** Order given to the next handler added. */
+	std::size_t next_order_;
+
 	void log_handlers();
 
 	friend pending_event_handler;
@@ -90,6 +94,7 @@ public:
 		, by_name_()
 		, dynamic_()
 		, id_map_()
+		, next_order_(0)
 	{
 	}
 
@@ -113,6 +118,14 @@ public:
 	/** Access to the handlers with fixed event names, by event name. */
 	handler_list& get(const std::string& name);
 
+	/**
+	 * The handlers which may handle the event @a name, which must be
+	 * standardized, in the order they run. This is the handlers filed under
+	 * that name and all handlers with variables in their names, whose names
+	 * can only be checked when they are about to run.
+	 */
+	std::vector<handler_ptr> get_candidates(const std::string& name);
+
 	/** Adds an event handler. */
 	pending_event_handler add_event_handler(const std::string& name, const std::string& id, bool repeat, bool is_menu_item = false);
 
@@ -144,6 +144,12 @@ const std::string& wml_menu_item::image() const
 
 bool wml_menu_item::can_show(const map_location& hex, const game_data& data, filter_context& filter_con) const
 {
+	// Failing to have a required selection means no show.
+	// This is checked first, as it is much cheaper than the WML conditions.
+	if(needs_select_ && !data.last_selected.valid()) {
+		return false;
+	}
+
 	// Failing the [show_if] tag means no show.
 	if(!show_if_.empty() && !conditional_passed(show_if_)) {
 		return false;
@@ -154,11 +160,6 @@ bool wml_menu_item::can_show(const map_location& hex, const game_data& data, fil
 		return false;
 	}
 
-	// Failing to have a required selection means no show.
-	if(needs_select_ && !data.last_selected.valid()) {
-		return false;
-	}
-
 	// Passed all tests.
 	return true;
 }
@@ -95,6 +95,12 @@ public:
 	 */
 	bool can_show(const map_location& hex, const game_data& data, filter_context& context) const;
 
+	/** Whether can_show() evaluates WML, from [show_if] or [filter_location]. */
+	bool has_conditions() const
+	{
+		return !show_if_.empty() || !filter_location_.empty();
+	}
+
 	/**
 	 * Causes the event associated with this item to fire.
 	 * Also records the event.
@@ -22,6 +22,7 @@
 #include "game_events/pump.hpp"
 #include "game_events/handlers.hpp"
 
+#include "ai/testing.hpp"
 #include "display_chat_manager.hpp"
 #include "game_config.hpp"
 #include "gettext.hpp"
@@ -32,10 +33,14 @@
 #include "side_filter.hpp"
 #include "units/map.hpp"
 #include "units/unit.hpp"
+#include "utils/frame_profiler.hpp"
+#include "utils/perf_counter.hpp"
+#include "utils/scope_exit.hpp"
 #include "variable.hpp"
 #include "video.hpp" // only for faked
 #include "whiteboard/manager.hpp"
 
+#include <chrono>
 #include <iomanip>
 
 static lg::log_domain log_engine("engine");
@@ -197,6 +202,8 @@ pump_manager::~pump_manager()
  */
 void wml_event_pump::process_event(handler_ptr& handler_p, const queued_event& ev)
 {
+	PROFILE_SCOPE("game_events::process_event");
+	PERF_TIMER("game_events::process_event");
 	DBG_EH << "processing event " << ev.name << " with id=" << ev.id;
 
 	// We currently never pass a null pointer to this function, but to
@@ -463,6 +470,15 @@ pump_result_t wml_event_pump::operator()()
 	// while events are being processed.
 	wb::real_map real_unit_map;
 
+	// Only the outermost pump is timed, nested ones are already included in it.
+	const auto start_time = std::chrono::steady_clock::now();
+	const bool outermost = impl_->instance_count == 0;
+	ON_SCOPE_EXIT(start_time, outermost) {
+		if(outermost) {
+			ai_testing::add_event_time(std::chrono::steady_clock::now() - start_time);
+		}
+	};
+
 	pump_manager pump_instance(*impl_);
 	context::scoped evc(impl_->contexts_, false);
 	// Loop through the events we need to process.
@@ -28,6 +28,8 @@
 #include "log.hpp"
 #include "map/location.hpp"
 
+#include <optional>
+
 static lg::log_domain log_engine("engine");
 #define WRN_NG LOG_STREAM(warn, log_engine)
 #define LOG_NG LOG_STREAM(info, log_engine)
@@ -125,29 +127,48 @@ void wmi_manager::get_items(const map_location& hex,
 		return;
 	}
 
-	// Prepare for can show().
+	// Only the items that can be used from the menu need their conditions checked.
+	const bool can_use_synced = resources::controller->can_use_synced_wml_menu();
+	std::vector<item_ptr> candidates;
+	bool has_conditions = false;
+	for(const auto& item_pair : wml_menu_items_) {
+		const item_ptr& item = item_pair.second;
+		if(item->use_wml_menu() && (!item->is_synced() || can_use_synced)) {
+			candidates.push_back(item);
+			has_conditions = has_conditions || item->has_conditions();
+		}
+	}
 
+	if(candidates.empty()) {
+		return;
+	}
 
-	config::attribute_value x1 = gamedata.get_variable("x1");
-	config::attribute_value y1 = gamedata.get_variable("y1");
-	gamedata.get_variable("x1") = hex.wml_x();
-	gamedata.get_variable("y1") = hex.wml_y();
-	scoped_xy_unit highlighted_unit("unit", hex, units);
+	// Prepare for can show(), unless no item evaluates any WML.
+	config::attribute_value x1, y1;
+	std::optional<scoped_xy_unit> highlighted_unit;
+	if(has_conditions) {
+		x1 = gamedata.get_variable("x1");
+		y1 = gamedata.get_variable("y1");
+		gamedata.get_variable("x1") = hex.wml_x();
+		gamedata.get_variable("y1") = hex.wml_y();
+		highlighted_unit.emplace("unit", hex, units);
+	}
 
 	// Check each menu item.
-	for(const auto& item_pair : wml_menu_items_) {
-		item_ptr item = item_pair.second;
-
+	for(const item_ptr& item : candidates) {
 		// Can this item be shown?
-		if(item->use_wml_menu() && (!item->is_synced() || resources::controller->can_use_synced_wml_menu())
-				&& item->can_show(hex, gamedata, fc)) {
+		if(item->can_show(hex, gamedata, fc)) {
 			// Include this item.
 			items.push_back(item);
 			descriptions.emplace_back("id", item->menu_text());
 		}
 	}
-	gamedata.get_variable("x1") = x1;
-	gamedata.get_variable("y1") = y1;
+
+	if(has_conditions) {
+		highlighted_unit.reset();
+		gamedata.get_variable("x1") = x1;
+		gamedata.get_variable("y1") = y1;
+	}
 }
 
 wmi_manager::item_ptr wmi_manager::get_item(const std::string& id) const
@@ -319,13 +319,41 @@ void connect_engine::update_level()
 
 void connect_engine::update_and_send_diff()
 {
-	config old_level = level_;
-	update_level();
+	config& scenario_cfg = scenario();
+	config diff;
+
+	// Only the sides are updated here. Comparing them one by one avoids
+	// copying and diffing the whole level, map and era included, on every
+	// change in the staging screen, and only the changed sides are sent.
+	if(scenario_cfg.child_count("side") == side_engines_.size()) {
+		DBG_MP << "updating changed sides";
+
+		for(std::size_t i = 0; i < side_engines_.size(); ++i) {
+			config side_cfg = side_engines_[i]->new_config();
+			config& old_side = scenario_cfg.child("side", i);
+
+			if(side_cfg != old_side) {
+				config& change = diff.add_child("change_child");
+				change["index"] = i;
+				change.add_child("side", side_cfg.get_diff(old_side));
+				old_side = std::move(side_cfg);
+			}
+		}
+	} else {
+		const config old_scenario = scenario_cfg;
+		update_level();
+		diff = scenario_cfg.get_diff(old_scenario);
+	}
 
-	config diff = level_.get_diff(old_level);
 	if(!diff.empty()) {
+		// Same shape as a diff of the whole level.
+		config level_diff;
+		config& change = level_diff.add_child("change_child");
+		change["index"] = 0;
+		change.add_child(level_.has_child("scenario") ? "scenario" : "snapshot", std::move(diff));
+
 		config scenario_diff;
-		scenario_diff.add_child("scenario_diff", std::move(diff));
+		scenario_diff.add_child("scenario_diff", std::move(level_diff));
 		mp::send_to_server(scenario_diff);
 	}
 }
@@ -66,6 +66,7 @@ manager::manager(const game_config_view& gamecfg, bool mp)
 	, prev_era_()
 	, prev_scenario_()
 	, prev_mods_()
+	, conflicts_()
 {
 	DBG_MP << "Initializing the dependency manager";
 
@@ -182,7 +183,7 @@ std::vector<std::string> manager::get_required(const elem& e) const
 		return result;
 	}
 
-	config data = depinfo_.find_child(e.type, "id", e.id);
+	const config& data = depinfo_.find_child(e.type, "id", e.id);
 
 	if(data.has_attribute("force_modification")) {
 		result = utils::split(data["force_modification"].str(), ',');
@@ -224,14 +225,28 @@ bool manager::does_conflict(const elem& elem1, const elem& elem2, bool directonl
 		return false;
 	}
 
+	// Selecting a modification checks it against every era and scenario,
+	// so the answers are kept rather than walking depinfo_ again.
+	auto key = std::make_tuple(elem1.type, elem1.id, elem2.type, elem2.id, directonly);
+	auto it = conflicts_.find(key);
+	if(it == conflicts_.end()) {
+		it = conflicts_.emplace(std::move(key), find_conflict(elem1, elem2, directonly)).first;
+	}
+
+	return it->second;
+}
+
+bool manager::find_conflict(const elem& elem1, const elem& elem2, bool directonly) const
+{
+
 	// We ignore nonexistent elements at this point, they will generate
 	// errors in change_era()/change_scenario() anyways.
 	if(!exists(elem1) || !exists(elem2)) {
 		return false;
 	}
 
-	config data1 = depinfo_.find_child(elem1.type, "id", elem1.id);
-	config data2 = depinfo_.find_child(elem2.type, "id", elem2.id);
+	const config& data1 = depinfo_.find_child(elem1.type, "id", elem1.id);
+	const config& data2 = depinfo_.find_child(elem2.type, "id", elem2.id);
 
 	// Whether we should skip the check entirely
 	if(data1.has_attribute("ignore_incompatible_" + elem2.type)) {
@@ -323,7 +338,7 @@ bool manager::does_require(const elem& elem1, const elem& elem2) const
 		return false;
 	}
 
-	config data = depinfo_.find_child(elem1.type, "id", elem1.id);
+	const config& data = depinfo_.find_child(elem1.type, "id", elem1.id);
 
 	if(data.has_attribute("force_modification")) {
 		std::vector<std::string> required = utils::split(data["force_modification"]);
@@ -508,6 +523,7 @@ void manager::insert_element(component_type type, const config& data, int index)
 	}
 
 	depinfo_.add_child_at(type_str, data, index);
+	conflicts_.clear();
 }
 
 bool manager::change_scenario(const std::string& id)
@@ -15,7 +15,9 @@
 
 #pragma once
 
+#include <map>
 #include <string>
+#include <tuple>
 #include <vector>
 #include "config.hpp"
 #include "gettext.hpp"
@@ -203,6 +205,13 @@ private:
 	/** used by save_state() and revert() to backup/restore mods_ */
 	std::vector<std::string> prev_mods_;
 
+	/**
+	 * Results of does_conflict, by the types and ids of both components and
+	 * directonly. They only depend on depinfo_, so they stay valid until a
+	 * component is inserted.
+	 */
+	mutable std::map<std::tuple<std::string, std::string, std::string, std::string, bool>, bool> conflicts_;
+
 	/** saves the current values of era_, scenarios_ and mods_ */
 	void save_state();
 
@@ -245,6 +254,9 @@ private:
 	 */
 	bool does_conflict(const elem& elem1, const elem& elem2, bool directonly=false) const;
 
+	/** Does the work of does_conflict, whose results are kept in conflicts_. */
+	bool find_conflict(const elem& elem1, const elem& elem2, bool directonly) const;
+
 	/**
 	 * Decides whether e1 requires e2
 	 *
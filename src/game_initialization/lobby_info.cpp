@@ -47,6 +47,8 @@ lobby_info::lobby_info()
 	, game_filters_()
 	, game_filter_invert_()
 	, games_visibility_()
+	, games_filtered_(false)
+	, games_to_refilter_()
 {
 	refresh_installed_addons_cache();
 }
@@ -245,10 +247,16 @@ void lobby_info::process_userlist()
 
 		switch(ui.get_relation()) {
 		case user_info::user_relation::FRIEND:
-			g->has_friends = true;
+			if(!g->has_friends) {
+				g->has_friends = true;
+				games_to_refilter_.insert(g->id);
+			}
 			break;
 		case user_info::user_relation::IGNORED:
-			g->has_ignored = true;
+			if(!g->has_ignored) {
+				g->has_ignored = true;
+				games_to_refilter_.insert(g->id);
+			}
 			break;
 		default:
 			break;
@@ -260,21 +268,42 @@ void lobby_info::process_userlist()
 
 std::function<void()> lobby_info::begin_state_sync()
 {
+	// Remember which games the filters currently hide, since make_games_vector() resets the
+	// visibility mask. Games that don't change in this sync then keep their result instead
+	// of going through the (expensive) filter functions again.
+	std::set<int> hidden_games;
+	const bool was_filtered = games_filtered_;
+
+	if(was_filtered) {
+		for(unsigned i = 0; i < games_.size(); ++i) {
+			if(!games_visibility_[i]) {
+				hidden_games.insert(games_[i]->id);
+			}
+		}
+	}
+
 	// First, update the list of game pointers to reflect any changes made to games_by_id_.
 	// This guarantees anything that calls games() before post cleanup has valid pointers,
 	// since there will likely have been changes to games_by_id_ caused by network traffic.
 	make_games_vector();
 
-	return [this]() {
+	return [this, was_filtered, hidden_games = std::move(hidden_games)]() {
 		DBG_LB << "lobby_info, second state sync stage";
 		DBG_LB << "games_by_id_ size: " << games_by_id_.size();
 
+		std::set<int> changed_games;
+		changed_games.swap(games_to_refilter_);
+
 		auto i = games_by_id_.begin();
 
 		while(i != games_by_id_.end()) {
 			if(i->second.display_status == game_info::disp_status::DELETED) {
 				i = games_by_id_.erase(i);
 			} else {
+				if(i->second.display_status != game_info::disp_status::CLEAN) {
+					changed_games.insert(i->first);
+				}
+
 				i->second.display_status = game_info::disp_status::CLEAN;
 				++i;
 			}
@@ -286,7 +315,23 @@ std::function<void()> lobby_info::begin_state_sync()
 
 		// Now that both containers are again in sync, update the visibility mask. We want to do
 		// this last since the filer functions are expensive.
-		apply_game_filter();
+		if(!was_filtered) {
+			apply_game_filter();
+			return;
+		}
+
+		DBG_LB << "refiltering " << changed_games.size() << " changed games";
+
+		for(unsigned j = 0; j < games_.size(); ++j) {
+			const game_info& game = *games_[j];
+			if(changed_games.count(game.id) != 0) {
+				games_visibility_[j] = is_game_visible(game);
+			} else {
+				games_visibility_[j] = hidden_games.count(game.id) == 0;
+			}
+		}
+
+		games_filtered_ = true;
 	};
 }
 
@@ -326,6 +371,7 @@ void lobby_info::make_games_vector()
 	games_visibility_.resize(games_.size());
 	games_visibility_.reset();
 	games_visibility_.flip();
+	games_filtered_ = false;
 }
 
 bool lobby_info::is_game_visible(const game_info& game)
@@ -348,6 +394,9 @@ void lobby_info::apply_game_filter()
 	for(unsigned i = 0; i < games_.size(); ++i) {
 		games_visibility_[i] = is_game_visible(*games_[i]);
 	}
+
+	games_filtered_ = true;
+	games_to_refilter_.clear();
 }
 
 } // end namespace mp
@@ -21,6 +21,7 @@
 #include <boost/dynamic_bitset.hpp>
 
 #include <memory>
+#include <set>
 
 namespace mp
 {
@@ -83,7 +84,10 @@ public:
 	/** Returns whether the game would be visible after the game filters are applied */
 	bool is_game_visible(const game_info&);
 
-	/** Generates a new list of games that match the current filter functions and inversion setting. */
+	/**
+	 * Generates a new list of games that match the current filter functions and inversion setting.
+	 * This runs the filters on every game; call it when the filters themselves changed.
+	 */
 	void apply_game_filter();
 
 	/** Returns info on a game with the given game ID. */
@@ -150,6 +154,12 @@ private:
 	std::function<bool(bool)> game_filter_invert_;
 
 	boost::dynamic_bitset<> games_visibility_;
+
+	/** Whether games_visibility_ holds filter results rather than the all-visible reset state. */
+	bool games_filtered_;
+
+	/** IDs of otherwise unchanged games whose friend or ignored flags changed since the last filtering. */
+	std::set<int> games_to_refilter_;
 };
 
 enum class notify_mode {
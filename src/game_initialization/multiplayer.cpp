@@ -15,10 +15,12 @@
 
 #include "game_initialization/multiplayer.hpp"
 
+#include "ai/testing.hpp"
 #include "build_info.hpp"
 #include "commandline_options.hpp"
 #include "connect_engine.hpp"
 #include "events.hpp"
+#include "filesystem.hpp"
 #include "formula/string_utils.hpp"
 #include "game_config_manager.hpp"
 #include "game_initialization/mp_game_utils.hpp"
@@ -39,11 +41,13 @@
 #include "replay.hpp"
 #include "resources.hpp"
 #include "saved_game.hpp"
+#include "serialization/parser.hpp"
 #include "sound.hpp"
 #include "statistics.hpp"
 #include "utils/parse_network_address.hpp"
 #include "wesnothd_connection.hpp"
 
+#include <chrono>
 #include <fstream>
 #include <functional>
 #include <future>
@@ -696,6 +700,7 @@ void start_local_game_commandline(const commandline_options& cmdline_opts)
 {
 	DBG_MP << "starting local MP game from commandline";
 
+	const auto load_start = std::chrono::steady_clock::now();
 	const game_config_view& game_config = game_config_manager::get()->game_config();
 
 	// The setup is done equivalently to lobby MP games using as much of existing
@@ -790,11 +795,32 @@ void start_local_game_commandline(const commandline_options& cmdline_opts)
 		resources::recorder->add_log_data("ai_log","ai_label",label);
 	}
 
+	// With --multiplayer-results, the outcome and timings of every game are
+	// written out so that batches of AI games can be analysed afterwards.
+	config results;
+	results["scenario"] = parameters.name;
+	results["era"] = state.classification().era_id;
+	results["load_time"] = std::chrono::duration<double>(std::chrono::steady_clock::now() - load_start).count();
+
 	unsigned int repeat = (cmdline_opts.multiplayer_repeat) ? *cmdline_opts.multiplayer_repeat : 1;
 	for(unsigned int i = 0; i < repeat; i++){
+		ai_testing::reset_game_results();
+		const auto game_start = std::chrono::steady_clock::now();
+
 		saved_game state_copy(state);
 		campaign_controller controller(state_copy);
-		controller.play_game();
+		const level_result::type result = controller.play_game();
+
+		if(cmdline_opts.multiplayer_results) {
+			config& game = results.add_child("game", ai_testing::game_results());
+			game["game"] = i + 1;
+			game["level_result"] = level_result::get_string(result);
+			game["time"] = std::chrono::duration<double>(std::chrono::steady_clock::now() - game_start).count();
+
+			// Rewritten after every game so that an aborted batch still leaves its results behind.
+			filesystem::scoped_ostream stream = filesystem::ostream_file(*cmdline_opts.multiplayer_results);
+			write(*stream, results);
+		}
 	}
 }
 
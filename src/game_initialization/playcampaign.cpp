@@ -39,11 +39,13 @@
 #include "map/exception.hpp"
 #include "map/map.hpp"
 #include "persist_manager.hpp"
+#include "picture.hpp"
 #include "playmp_controller.hpp"
 #include "preferences/game.hpp"
 #include "saved_game.hpp"
 #include "savegame.hpp"
 #include "sound.hpp"
+#include "units/types.hpp"
 #include "video.hpp"
 #include "wesnothd_connection.hpp"
 #include "wml_exception.hpp"
@@ -57,6 +59,47 @@ static lg::log_domain log_engine("engine");
 static lg::log_domain log_enginerefac("enginerefac");
 #define LOG_RG LOG_STREAM(info, log_enginerefac)
 
+namespace
+{
+/**
+ * Queues the images the opening of a scenario needs right away for background
+ * decoding: story screen backgrounds and the base images of the units placed
+ * at start. They are then mostly ready by the time the controller and the
+ * story viewer ask for them, instead of being read one by one afterwards.
+ */
+void prefetch_scenario_images(const config& scenario)
+{
+	for(const config& story : scenario.child_range("story")) {
+		for(const config& part : story.child_range("part")) {
+			image::prefetch(part["background"].str());
+
+			for(const config& layer : part.child_range("background_layer")) {
+				image::prefetch(layer["image"].str());
+			}
+
+			for(const config& img : part.child_range("image")) {
+				image::prefetch(img["file"].str());
+			}
+		}
+	}
+
+	const auto prefetch_type = [](const config& cfg) {
+		if(const unit_type* type = unit_types.find(cfg["type"], unit_type::CREATED)) {
+			image::prefetch(type->image());
+		}
+	};
+
+	for(const config& side : scenario.child_range("side")) {
+		prefetch_type(side);
+
+		for(const config& u : side.child_range("unit")) {
+			prefetch_type(u);
+		}
+	}
+}
+
+} // end anon namespace
+
 void campaign_controller::show_carryover_message(
 	playsingle_controller& playcontroller, const end_level_data& end_level, const level_result::type res)
 {
@@ -377,6 +420,9 @@ level_result::type campaign_controller::play_game()
 				// note that although starting_pos is const it might be changed by gamestate.some_non_const_operation()
 				const config& starting_pos = state_.get_starting_point();
 
+				// Start decoding its images while the staging, save and display setup run.
+				prefetch_scenario_images(starting_pos);
+
 				const bool is_mp = state_.classification().is_normal_mp_game();
 				state_.mp_settings().num_turns = starting_pos["turns"].to_int(-1);
 
@@ -54,6 +54,8 @@
 #include "serialization/string_utils.hpp" // for split
 #include "statistics.hpp"
 #include "tstring.hpp"       // for operator==, operator!=
+#include "utils/frame_profiler.hpp"
+#include "utils/perf_counter.hpp"
 #include "video.hpp"
 #include "wesnothd_connection_error.hpp"
 #include "wml_exception.hpp" // for wml_exception
@@ -100,6 +102,9 @@ static lg::log_domain log_network("network");
 static lg::log_domain log_enginerefac("enginerefac");
 #define LOG_RG LOG_STREAM(info, log_enginerefac)
 
+static lg::log_domain log_perf("perf");
+#define LOG_PERF LOG_STREAM(info, log_perf)
+
 game_launcher::game_launcher(const commandline_options& cmdline_opts)
 	: cmdline_opts_(cmdline_opts)
 	, font_manager_()
@@ -185,6 +190,8 @@ game_launcher::game_launcher(const commandline_options& cmdline_opts)
 	}
 	if(cmdline_opts_.fps)
 		preferences::set_show_fps(true);
+	if(cmdline_opts_.frame_trace)
+		util::frame_profiler::get().enable(*cmdline_opts_.frame_trace);
 	if(cmdline_opts_.fullscreen)
 		start_in_fullscreen_ = true;
 	if(cmdline_opts_.load)
@@ -199,7 +206,7 @@ game_launcher::game_launcher(const commandline_options& cmdline_opts)
 		}
 		preferences::set_draw_delay(fps);
 	}
-	if(cmdline_opts_.nogui || cmdline_opts_.headless_unit_test) {
+	if(cmdline_opts_.nogui || cmdline_opts_.headless_unit_test || !cmdline_opts_.verify_replay.empty()) {
 		no_sound = true;
 		preferences::disable_preferences_save();
 	}
@@ -317,12 +324,14 @@ bool game_launcher::init_video()
 	// Handle special commandline launch flags
 	if(cmdline_opts_.nogui
 		|| cmdline_opts_.headless_unit_test
+		|| !cmdline_opts_.verify_replay.empty()
 		|| cmdline_opts_.render_image)
 	{
 		if(!(cmdline_opts_.multiplayer
 			|| cmdline_opts_.screenshot
 			|| cmdline_opts_.plugin_file
 			|| cmdline_opts_.headless_unit_test
+			|| !cmdline_opts_.verify_replay.empty()
 			|| cmdline_opts_.render_image))
 		{
 			PLAIN_LOG << "--nogui flag is only valid with --multiplayer or --screenshot or --plugin flags";
@@ -509,8 +518,20 @@ game_launcher::unit_test_result game_launcher::unit_test()
 		return unit_test_result::TEST_FAIL;
 	}
 
+	// With a report, every test is run and the game config is only loaded once for all of them.
+	filesystem::scoped_ostream report;
+	if(cmdline_opts_.unit_test_report) {
+		report = filesystem::ostream_file(*cmdline_opts_.unit_test_report);
+	}
+
 	auto ret = unit_test_result::TEST_FAIL; // will only be returned if no test is run
+	std::optional<unit_test_result> first_failure;
 	for(const auto& scenario : test_scenarios_) {
+		if(report && scenario != test_scenarios_.front()) {
+			// Only this test's own log messages should break strict mode.
+			lg::reset_broke_strict();
+		}
+
 		set_test(scenario);
 		ret = single_unit_test();
 		const char* describe_result;
@@ -551,12 +572,23 @@ game_launcher::unit_test_result game_launcher::unit_test()
 		}
 
 		PLAIN_LOG << describe_result << " (" << int(ret) << "): " << scenario;
-		if(ret != unit_test_result::TEST_PASS) {
+
+		if(report) {
+			*report << int(ret) << ' ' << scenario << std::endl;
+			if(ret != unit_test_result::TEST_PASS && !first_failure) {
+				first_failure = ret;
+			}
+		} else if(ret != unit_test_result::TEST_PASS) {
 			break;
 		}
 	}
 
-	return ret;
+	if(report && !report->good()) {
+		PLAIN_LOG << "Could not write the unit test report to " << *cmdline_opts_.unit_test_report;
+		return unit_test_result::TEST_FAIL;
+	}
+
+	return first_failure.value_or(ret);
 }
 
 game_launcher::unit_test_result game_launcher::single_unit_test()
@@ -612,6 +644,57 @@ game_launcher::unit_test_result game_launcher::single_unit_test()
 	return pass_victory_or_defeat(game_res);
 }
 
+bool game_launcher::verify_replays()
+{
+	bool all_passed = true;
+
+	for(const std::string& file : cmdline_opts_.verify_replay) {
+		const std::string error = verify_single_replay(file);
+
+		if(error.empty()) {
+			PLAIN_LOG << "PASS REPLAY: " << file;
+		} else {
+			PLAIN_LOG << "FAIL REPLAY: " << file << ": " << error;
+			all_passed = false;
+		}
+	}
+
+	return all_passed;
+}
+
+std::string game_launcher::verify_single_replay(const std::string& file)
+{
+	// Like --load, plain names are looked up in the saves directory.
+	std::shared_ptr<savegame::save_index_class> manager;
+	if(file.find_first_of("/\\") == std::string::npos) {
+		manager = savegame::save_index_class::default_saves_dir();
+	} else {
+		manager = std::make_shared<savegame::save_index_class>(filesystem::directory_name(file));
+	}
+
+	load_data_ = savegame::load_game_metadata{manager, filesystem::base_name(file), "", true, false, false};
+
+	if(!load_game()) {
+		return "could not load the replay";
+	}
+
+	try {
+		const bool was_strict_broken = lg::broke_strict();
+		campaign_controller ccontroller(state_, true);
+		ccontroller.play_replay();
+		if(!was_strict_broken && lg::broke_strict()) {
+			return "errors were logged while playing the replay";
+		}
+	} catch(const wml_exception& e) {
+		return "WML exception: " + e.dev_message;
+	} catch(const game::error& e) {
+		// Out of sync errors are thrown as game::game_error when running headlessly.
+		return e.message;
+	}
+
+	return "";
+}
+
 game_launcher::unit_test_result game_launcher::pass_victory_or_defeat(level_result::type res)
 {
 	if(res == level_result::type::defeat) {
@@ -1070,6 +1153,10 @@ void game_launcher::clear_loaded_game()
 
 game_launcher::~game_launcher()
 {
+	if(!lg::info().dont_log(log_perf)) {
+		LOG_PERF << "Performance counters:\n" << util::perf_counter::report();
+	}
+
 	try {
 		sound::close_sound();
 		video::deinit();
@@ -88,7 +88,13 @@ public:
 	bool play_screenshot_mode();
 	bool play_render_image_mode();
 	/** Runs unit tests specified on the command line */
+	/**
+	 * Runs the --unit tests, stopping at the first one that doesn't pass
+	 * unless --unit-report was given.
+	 */
 	unit_test_result unit_test();
+	/** Plays the replays given by --verify-replay, returns whether all of them passed. */
+	bool verify_replays();
 
 	bool has_load_data() const;
 	bool load_game();
@@ -129,6 +135,12 @@ private:
 	 */
 	unit_test_result single_unit_test();
 
+	/**
+	 * Internal to the implementation of verify_replays(), called once per file.
+	 * Returns an empty string if the replay passed, otherwise the reason it failed.
+	 */
+	std::string verify_single_replay(const std::string& file);
+
 	const commandline_options& cmdline_opts_;
 	bool start_in_fullscreen_ = false;
 
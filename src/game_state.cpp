@@ -249,7 +249,7 @@ void game_state::set_game_display(game_display * gd)
 	lua_kernel_->set_game_display(gd);
 }
 
-void game_state::write(config& cfg) const
+void game_state::write(config& cfg, bool with_variables) const
 {
 	cfg["init_side_done"] = init_side_done_;
 	if(gamedata_.phase() == game_data::PLAY) {
@@ -274,7 +274,7 @@ void game_state::write(config& cfg) const
 	cfg.merge_with(pathfind_manager_->to_config());
 
 	//Write the game data, including wml vars
-	gamedata_.write_snapshot(cfg);
+	gamedata_.write_snapshot(cfg, with_variables);
 
 	// Preserve the undo stack so that fog/shroud clearing is kept accurate.
 	undo_stack_->write(cfg.add_child("undo_stack"));
@@ -373,6 +373,16 @@ bool game_state::can_recruit_on(const map_location& leader_loc, const map_locati
 			return false;
 		}
 
+		// Without shroud, any castle hex of the leader's network will do.
+		// Shroud can only cut a network, so other networks never qualify.
+		if(board_.castle_network(leader_loc) != board_.castle_network(recruit_loc)) {
+			return false;
+		}
+
+		if(!view_team.uses_shroud()) {
+			return true;
+		}
+
 		castle_cost_calculator calc(map, view_team);
 
 		// The limit computed in the third argument is more than enough for
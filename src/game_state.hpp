@@ -87,7 +87,8 @@ public:
 
 	void set_game_display(game_display *);
 
-	void write(config& cfg) const;
+	/** @param with_variables     Whether to write the WML variables, see game_data::write_snapshot. */
+	void write(config& cfg, bool with_variables = true) const;
 
 	/** Inherited from @ref filter_context. */
 	virtual const display_context& get_disp_context() const override
@@ -25,6 +25,8 @@
 #include "serialization/string_utils.hpp"
 #include "seed_rng.hpp"
 
+#include <algorithm>
+
 static lg::log_domain log_engine("engine");
 #define LOG_NG LOG_STREAM(info, log_engine)
 
@@ -94,6 +96,7 @@ cave_map_generator::cave_map_generator_job::cave_map_generator_job(const cave_ma
 	, chamber_ids_()
 	, chambers_()
 	, passages_()
+	, in_chamber_(params.width_ * params.height_, false)
 	, res_(params.cfg_.child_or_empty("settings"))
 	, rng_() //initialises with rand()
 {
@@ -129,16 +132,35 @@ cave_map_generator::cave_map_generator_job::cave_map_generator_job(const cave_ma
 	res_["map_data"] = t_translation::write_game_map(map_, starting_positions_);
 }
 
-void cave_map_generator::cave_map_generator_job::build_chamber(map_location loc, std::set<map_location>& locs, std::size_t size, std::size_t jagged)
+void cave_map_generator::cave_map_generator_job::build_chamber(map_location loc, std::vector<map_location>& locs, std::size_t size, std::size_t jagged)
 {
-	if(size == 0 || locs.count(loc) != 0 || !params.on_board(loc))
+	locs.clear();
+	grow_chamber(loc, locs, size, jagged);
+
+	for(const map_location& l : locs) {
+		in_chamber_[l.y * params.width_ + l.x] = false;
+	}
+
+	// Keep the order a std::set would have given, the placement of items and
+	// villages depends on it.
+	std::sort(locs.begin(), locs.end());
+}
+
+void cave_map_generator::cave_map_generator_job::grow_chamber(map_location loc, std::vector<map_location>& locs, std::size_t size, std::size_t jagged)
+{
+	if(size == 0 || !params.on_board(loc))
+		return;
+
+	std::vector<bool>::reference seen = in_chamber_[loc.y * params.width_ + loc.x];
+	if(seen)
 		return;
 
-	locs.insert(loc);
+	seen = true;
+	locs.push_back(loc);
 
 	for(const map_location& adj : get_adjacent_tiles(loc)) {
 		if(static_cast<int>(rng_() % 100) < (100l - static_cast<long>(jagged))) {
-			build_chamber(adj,locs,size-1,jagged);
+			grow_chamber(adj,locs,size-1,jagged);
 		}
 	}
 }
@@ -221,8 +243,8 @@ void cave_map_generator::cave_map_generator_job::generate_chambers()
 
 void cave_map_generator::cave_map_generator_job::place_chamber(const chamber& c)
 {
-	for(std::set<map_location>::const_iterator i = c.locs.begin(); i != c.locs.end(); ++i) {
-		set_terrain(*i,params.clear_);
+	for(const map_location& loc : c.locs) {
+		set_terrain(loc,params.clear_);
 	}
 
 	if (c.items == nullptr || c.locs.empty()) return;
@@ -243,25 +265,24 @@ void cave_map_generator::cave_map_generator_job::place_chamber(const chamber& c)
 		}
 		std::string loc_var = it.cfg["store_location_as"];
 
-		std::set<map_location>::const_iterator loc = c.locs.begin();
-		std::advance(loc,index);
+		const map_location& loc = c.locs[index];
 
-		cfg["x"] = loc->x + 1;
-		cfg["y"] = loc->y + 1;
+		cfg["x"] = loc.x + 1;
+		cfg["y"] = loc.y + 1;
 
 		if (filter) {
-			filter["x"] = loc->x + 1;
-			filter["y"] = loc->y + 1;
+			filter["x"] = loc.x + 1;
+			filter["y"] = loc.y + 1;
 		}
 
 		if (object_filter) {
-			(*object_filter)["x"] = loc->x + 1;
-			(*object_filter)["y"] = loc->y + 1;
+			(*object_filter)["x"] = loc.x + 1;
+			(*object_filter)["y"] = loc.y + 1;
 		}
 
 		// If this is a side, place a castle for the side
 		if (it.key == "side" && !it.cfg["no_castle"].to_bool()) {
-			place_castle(it.cfg["side"].to_int(-1), *loc);
+			place_castle(it.cfg["side"].to_int(-1), loc);
 		}
 
 		res_.add_child(it.key, cfg);
@@ -271,10 +292,10 @@ void cave_map_generator::cave_map_generator_job::place_chamber(const chamber& c)
 			temp["name"] = "prestart";
 			config &xcfg = temp.add_child("set_variable");
 			xcfg["name"] = loc_var + "_x";
-			xcfg["value"] = loc->x + 1;
+			xcfg["value"] = loc.x + 1;
 			config &ycfg = temp.add_child("set_variable");
 			ycfg["name"] = loc_var + "_y";
-			ycfg["value"] = loc->y + 1;
+			ycfg["value"] = loc.y + 1;
 		}
 	}
 }
@@ -329,11 +350,11 @@ void cave_map_generator::cave_map_generator_job::place_passage(const passage& p)
 	int width = std::max<int>(1, p.cfg["width"].to_int());
 	int jagged = p.cfg["jagged"];
 
-	for(std::vector<map_location>::const_iterator i = rt.steps.begin(); i != rt.steps.end(); ++i) {
-		std::set<map_location> locs;
-		build_chamber(*i,locs,width,jagged);
-		for(std::set<map_location>::const_iterator j = locs.begin(); j != locs.end(); ++j) {
-			set_terrain(*j, params.clear_);
+	std::vector<map_location> locs;
+	for(const map_location& step : rt.steps) {
+		build_chamber(step,locs,width,jagged);
+		for(const map_location& loc : locs) {
+			set_terrain(loc, params.clear_);
 		}
 	}
 }
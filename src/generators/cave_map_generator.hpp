@@ -20,8 +20,8 @@
 #include "terrain/translation.hpp"
 #include <optional>
 
-#include <set>
 #include <random>
+#include <vector>
 
 class cave_map_generator : public map_generator
 {
@@ -49,7 +49,8 @@ private:
 			}
 
 			map_location center;
-			std::set<map_location> locs;
+			/** The hexes of the chamber, sorted. */
+			std::vector<map_location> locs;
 			const config *items;
 		};
 
@@ -62,7 +63,8 @@ private:
 		};
 
 		void generate_chambers();
-		void build_chamber(map_location loc, std::set<map_location>& locs, std::size_t size, std::size_t jagged);
+		void build_chamber(map_location loc, std::vector<map_location>& locs, std::size_t size, std::size_t jagged);
+		void grow_chamber(map_location loc, std::vector<map_location>& locs, std::size_t size, std::size_t jagged);
 
 		void place_chamber(const chamber& c);
 
@@ -83,6 +85,8 @@ private:
 		std::map<std::string,std::size_t> chamber_ids_;
 		std::vector<chamber> chambers_;
 		std::vector<passage> passages_;
+		/** Scratch grid marking the hexes already added by build_chamber. */
+		std::vector<bool> in_chamber_;
 		config res_;
 		std::mt19937 rng_;
 	};
@@ -291,6 +291,21 @@ height_map default_map_generator_job::generate_height_map(size_t width, size_t h
 {
 	height_map res(width, std::vector<int>(height,0));
 
+	// The integer square roots of the squared distances a hill can cover, so that
+	// the loop below doesn't call std::sqrt for every hex of every hill. Unusually
+	// big hill sizes fall back to calling it.
+	const std::size_t max_distance_squared = 2 * hill_size * hill_size;
+	std::vector<int> int_sqrt(max_distance_squared < (1u << 20) ? max_distance_squared + 1 : 0);
+	for(std::size_t n = 0; n != int_sqrt.size(); ++n) {
+		int_sqrt[n] = static_cast<int>(std::sqrt(static_cast<double>(n)));
+	}
+
+	const auto distance = [&int_sqrt](int distance_squared) {
+		return static_cast<std::size_t>(distance_squared) < int_sqrt.size()
+			? int_sqrt[distance_squared]
+			: static_cast<int>(std::sqrt(static_cast<double>(distance_squared)));
+	};
+
 	DBG_NG << iterations << " iterations";
 	for(std::size_t i = 0; i != iterations; ++i) {
 
@@ -331,7 +346,7 @@ height_map default_map_generator_job::generate_height_map(size_t width, size_t h
 				const int xdiff = (x2-x1);
 				const int ydiff = (y2-y1);
 
-				const int hill_height = radius - static_cast<int>(std::sqrt(static_cast<double>(xdiff*xdiff + ydiff*ydiff)));
+				const int hill_height = radius - distance(xdiff*xdiff + ydiff*ydiff);
 
 				if(hill_height > 0) {
 					if(is_valley) {
@@ -214,6 +214,7 @@ namespace
 			, current_language_(default_utf8_locale_name::name())
 			, generator_()
 			, current_locale_()
+			, locale_cache_()
 			, is_dirty_(true)
 		{
 			const bl::localization_backend_manager& g_mgr = bl::localization_backend_manager::global();
@@ -251,6 +252,7 @@ namespace
 
 			generator_.add_messages_domain(domain);
 			loaded_domains_.insert(domain);
+			locale_cache_.clear();
 		}
 
 		void add_messages_path(const std::string& path)
@@ -261,11 +263,13 @@ namespace
 			}
 			generator_.add_messages_path(path);
 			loaded_paths_.insert(path);
+			locale_cache_.clear();
 		}
 
 		void set_default_messages_domain(const std::string& domain)
 		{
 			generator_.set_default_messages_domain(domain);
+			locale_cache_.clear();
 			update_locale();
 		}
 
@@ -307,11 +311,22 @@ namespace
 		 */
 		void update_locale_internal()
 		{
+			// Switching back to a language used before doesn't need to load its catalogs again.
+			const auto cached = locale_cache_.find(current_language_);
+			if(cached != locale_cache_.end())
+			{
+				LOG_G << "reusing the generated locale for '" << current_language_ << "'";
+				current_locale_ = cached->second;
+				is_dirty_ = false;
+				return;
+			}
+
 			try
 			{
 				LOG_G << "attempting to generate locale by name '" << current_language_ << "'";
 				current_locale_ = generator_.generate(current_language_);
 				current_locale_ = std::locale(current_locale_, new wesnoth_message_format(current_locale_, loaded_domains_, loaded_paths_));
+				locale_cache_.emplace(current_language_, current_locale_);
 				const bl::info& info = std::use_facet<bl::info>(current_locale_);
 				LOG_G << "updated locale to '" << current_language_ << "' locale is now '" << current_locale_.name() << "' ( "
 				      << "name='" << info.name()
@@ -386,6 +401,8 @@ namespace
 		std::string current_language_;
 		bl::generator generator_;
 		std::locale current_locale_;
+		/** Locales generated for the current paths and domains, by language name. */
+		std::map<std::string, std::locale> locale_cache_;
 		bool is_dirty_;
 	};
 
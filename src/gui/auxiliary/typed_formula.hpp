@@ -129,13 +129,21 @@ private:
 	 */
 	std::optional<std::string> formula_;
 
+	/**
+	 * The parsed formula, created the first time it's evaluated.
+	 *
+	 * Only used when no function table is passed, since the parsed formula
+	 * would keep a pointer to that table.
+	 */
+	mutable wfl::const_formula_ptr parsed_formula_;
+
 	/** If there's no formula it contains the value. */
 	T value_;
 };
 
 template<typename T>
 typed_formula<T>::typed_formula(const std::string& str, const T value)
-	: formula_(), value_(value)
+	: formula_(), parsed_formula_(), value_(value)
 {
 	if(str.empty()) {
 		return;
@@ -156,7 +164,17 @@ operator()(const wfl::map_formula_callable& variables, wfl::function_symbol_tabl
 		return value_;
 	}
 
-	wfl::variant v = wfl::formula(*formula_, functions).evaluate(variables);
+	wfl::variant v;
+	if(functions) {
+		v = wfl::formula(*formula_, functions).evaluate(variables);
+	} else {
+		if(!parsed_formula_) {
+			parsed_formula_ = std::make_shared<const wfl::formula>(*formula_);
+		}
+
+		v = parsed_formula_->evaluate(variables);
+	}
+
 	const T& result = execute(v);
 
 	DBG_GUI_D << "Formula: execute '" << *formula_ << "' result '" << result << "'.";
@@ -54,8 +54,11 @@ struct dispatcher_implementation
 	 */
 	static bool has_handler(dispatcher& dispatcher, const dispatcher::event_queue_type queue_type, ui_event event)
 	{
+		// Most widgets have no handler for most events, so don't use operator[]
+		// here: that would add an empty entry for every event checked.
 		const auto queue_check = [&](auto& queue_set) {
-			return !queue_set.queue[event].empty(queue_type);
+			const auto itor = queue_set.queue.find(event);
+			return itor != queue_set.queue.end() && !itor->second.empty(queue_type);
 		};
 
 		// We can't just use get_signal_queue since there's no way to know the event at compile time.
@@ -32,6 +32,7 @@
 #include "utils/ranges.hpp"
 
 #include <cassert>
+#include <optional>
 
 /**
  * @todo The items below are not implemented yet.
@@ -119,7 +120,7 @@ static uint32_t timer_sdl_poll_events(uint32_t, void*)
  *
  * It's a new experimental class.
  */
-class sdl_event_handler : public events::sdl_handler
+class sdl_event_handler : public events::sdl_handler, public events::pump_monitor
 {
 	friend bool gui2::is_in_dialog();
 
@@ -134,6 +135,9 @@ public:
 	/** Inherited from events::sdl_handler. */
 	void handle_window_event(const SDL_Event& event) override;
 
+	/** Inherited from events::pump_monitor. */
+	void process(events::pump_info& info) override;
+
 	/**
 	 * Connects a dispatcher.
 	 *
@@ -185,6 +189,16 @@ private:
 	 */
 	void mouse(const ui_event event, const point& position);
 
+	/**
+	 * Fires the motion event held back by handle_event, if any.
+	 *
+	 * Mice can report motion far more often than a frame is drawn, and every
+	 * motion event means a hit-test and a dispatch through the window. So
+	 * consecutive motion events are merged and only the last position is
+	 * fired, before the next other event or at the end of the pump.
+	 */
+	void flush_mouse_motion();
+
 	/**
 	 * Fires a mouse button up event.
 	 *
@@ -342,6 +356,9 @@ private:
 	 */
 	dispatcher* keyboard_focus_;
 	friend void capture_keyboard(dispatcher* dispatcher);
+
+	/** The position of the motion event waiting for flush_mouse_motion. */
+	std::optional<point> pending_motion_;
 };
 
 sdl_event_handler::sdl_event_handler()
@@ -349,6 +366,7 @@ sdl_event_handler::sdl_event_handler()
 	, mouse_focus(nullptr)
 	, dispatchers_()
 	, keyboard_focus_(nullptr)
+	, pending_motion_()
 {
 	if(SDL_WasInit(SDL_INIT_TIMER) == 0) {
 		if(SDL_InitSubSystem(SDL_INIT_TIMER) == -1) {
@@ -378,6 +396,10 @@ void sdl_event_handler::handle_event(const SDL_Event& event)
 
 	uint8_t button = event.button.button;
 
+	if(event.type != SDL_MOUSEMOTION) {
+		flush_mouse_motion();
+	}
+
 	switch(event.type) {
 		case SDL_MOUSEMOTION:
 #ifdef MOUSE_TOUCH_EMULATION
@@ -385,7 +407,7 @@ void sdl_event_handler::handle_event(const SDL_Event& event)
 			if (event.motion.state != 0)
 #endif
 			{
-				mouse(SDL_MOUSE_MOTION, {event.motion.x, event.motion.y});
+				pending_motion_ = point(event.motion.x, event.motion.y);
 			}
 			break;
 
@@ -523,6 +545,25 @@ void sdl_event_handler::handle_window_event(const SDL_Event& event)
 	handle_event(event);
 }
 
+void sdl_event_handler::process(events::pump_info&)
+{
+	flush_mouse_motion();
+}
+
+void sdl_event_handler::flush_mouse_motion()
+{
+	if(!pending_motion_) {
+		return;
+	}
+
+	const point position = *pending_motion_;
+	pending_motion_.reset();
+
+	if(!dispatchers_.empty()) {
+		mouse(SDL_MOUSE_MOTION, position);
+	}
+}
+
 void sdl_event_handler::connect(dispatcher* dispatcher)
 {
 	assert(std::find(dispatchers_.begin(), dispatchers_.end(), dispatcher)
@@ -566,6 +607,7 @@ void sdl_event_handler::disconnect(dispatcher* disp)
 
 	if(dispatchers_.empty()) {
 		LOG_GUI_E << "deleting unused dispatcher event context";
+		pending_motion_.reset();
 		leave();
 		delete event_context;
 		event_context = nullptr;
@@ -198,7 +198,52 @@ const typename TList::value_type& get_best_resolution(const TList& list, const T
 
 } // namespace
 
+namespace
+{
+/**
+ * Results of get_control, so building a window doesn't have to look up and
+ * rank the resolutions of the same widget definitions over and over again.
+ *
+ * Only valid for the GUI and screen size it was filled for.
+ */
+struct control_cache
+{
+	gui_theme_map_t::iterator gui = guis.end();
+	unsigned screen_width = 0;
+	unsigned screen_height = 0;
+	std::map<std::pair<std::string, std::string>, resolution_definition_ptr> controls;
+};
+
+control_cache control_cache_;
+
+resolution_definition_ptr find_control(const std::string& control_type, const std::string& definition);
+} // namespace
+
 resolution_definition_ptr get_control(const std::string& control_type, const std::string& definition)
+{
+	if(control_cache_.gui != current_gui
+		|| control_cache_.screen_width != settings::screen_width
+		|| control_cache_.screen_height != settings::screen_height)
+	{
+		control_cache_.gui = current_gui;
+		control_cache_.screen_width = settings::screen_width;
+		control_cache_.screen_height = settings::screen_height;
+		control_cache_.controls.clear();
+	}
+
+	auto key = std::make_pair(control_type, definition);
+	if(const auto iter = control_cache_.controls.find(key); iter != control_cache_.controls.end()) {
+		return iter->second;
+	}
+
+	resolution_definition_ptr result = find_control(control_type, definition);
+	control_cache_.controls.emplace(std::move(key), result);
+	return result;
+}
+
+namespace
+{
+resolution_definition_ptr find_control(const std::string& control_type, const std::string& definition)
 {
 	const auto& current_types = current_gui->second.widget_types;
 	const auto& default_types = default_gui->second.widget_types;
@@ -250,6 +295,7 @@ resolution_definition_ptr get_control(const std::string& control_type, const std
 		);
 	});
 }
+} // namespace
 
 const builder_window::window_resolution& get_window_builder(const std::string& type)
 {
@@ -300,6 +346,7 @@ bool add_single_widget_definition(const std::string& widget_type, const std::str
 	}
 
 	def_map.emplace(definition_id, parser->second.parser(cfg));
+	control_cache_.controls.clear();
 	return true;
 }
 
@@ -310,6 +357,7 @@ void remove_single_widget_definition(const std::string& widget_type, const std::
 	auto it = definition_map.find(definition_id);
 	if(it != definition_map.end()) {
 		definition_map.erase(it);
+		control_cache_.controls.clear();
 	}
 }
 
@@ -877,20 +877,25 @@ void addon_manager::update_addon(const addon_info& addon)
 
 void addon_manager::update_all_addons()
 {
+	std::vector<const addon_info*> upgradable;
+
 	for(const auto& a : addons_) {
 		if(tracking_info_[a.first].state == ADDON_INSTALLED_UPGRADABLE) {
-			addons_client::install_result result = client_.install_addon_with_checks(addons_, a.second);
+			upgradable.push_back(&a.second);
+		}
+	}
 
-			if(result.wml_changed) {
-				// Updating an add-on may have resulted in its dependencies being updated
-				// as well, so we need to reread version info blocks afterwards to make sure
-				// we don't try to re-download newly updated add-ons.
-				refresh_addon_version_info_cache();
-			}
+	if(!upgradable.empty()) {
+		addons_client::install_result result = client_.install_addons_with_checks(addons_, upgradable);
 
-			// Take note if any wml_changes occurred
-			need_wml_cache_refresh_ |= result.wml_changed;
+		if(result.wml_changed) {
+			// Updating add-ons may have resulted in their dependencies being updated
+			// as well, so we need to reread version info blocks afterwards.
+			refresh_addon_version_info_cache();
 		}
+
+		// Take note if any wml_changes occurred
+		need_wml_cache_refresh_ |= result.wml_changed;
 	}
 
 	if(need_wml_cache_refresh_) {
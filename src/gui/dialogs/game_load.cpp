@@ -131,6 +131,12 @@ void game_load::pre_show(window& window)
 	display_savegame();
 }
 
+void game_load::post_show(window& /*window*/)
+{
+	// Summaries rebuilt while browsing are written once, instead of after each selection.
+	savegame::save_index_class::default_saves_dir()->write_save_index_if_changed();
+}
+
 void game_load::set_save_dir_list(menu_button& dir_list)
 {
 	const auto other_dirs = filesystem::find_other_version_saves_dirs();
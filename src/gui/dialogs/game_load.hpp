@@ -56,6 +56,8 @@ public:
 private:
 	virtual void pre_show(window& window) override;
 
+	virtual void post_show(window& window) override;
+
 	virtual const std::string& window_id() const override;
 
 	void set_save_dir_list(menu_button& dir_list);
@@ -104,6 +104,7 @@ mp_lobby::mp_lobby(mp::lobby_info& info, wesnothd_connection& connection, int& j
 	, last_lobby_update_(0)
 	, gamelist_diff_update_(true)
 	, network_connection_(connection)
+	, server_filter_()
 	, lobby_update_timer_(0)
 	, gamelist_id_at_row_()
 	, delay_playerlist_update_(false)
@@ -515,6 +516,7 @@ void mp_lobby::adjust_game_row_contents(const mp::game_info& game, grid* grid, b
 void mp_lobby::update_gamelist_filter()
 {
 	DBG_LB << "mp_lobby::update_gamelist_filter";
+	send_server_filter();
 	lobby_info_.apply_game_filter();
 	DBG_LB << "Games in lobby_info: " << lobby_info_.games().size()
 		   << ", games in listbox: " << gamelistbox_->get_item_count();
@@ -523,6 +525,36 @@ void mp_lobby::update_gamelist_filter()
 	update_visible_games();
 }
 
+void mp_lobby::send_server_filter()
+{
+	config filter;
+
+	// The server can't invert its filter, so leave it to us
+	if(!filter_invert_->get_widget_value()) {
+		if(filter_slots_->get_widget_value()) {
+			filter["vacant_only"] = true;
+		}
+
+		if(filter_friends_->get_widget_value()) {
+			std::vector<std::string> friends;
+			for(const auto& [nick, info] : preferences::get_acquaintances()) {
+				if(info.get_status() == "friend") {
+					friends.push_back(nick);
+				}
+			}
+
+			filter["friends"] = utils::join(friends);
+		}
+	}
+
+	if(filter == server_filter_) {
+		return;
+	}
+
+	server_filter_ = filter;
+	network_connection_.send_data(config("lobby_filter", std::move(filter)));
+}
+
 void mp_lobby::update_playerlist()
 {
 	if(delay_playerlist_update_) return;
@@ -52,6 +52,14 @@ protected:
 
 	void update_gamelist_filter();
 
+	/**
+	 * Asks the server to only send the games the vacant slots and friends filters show.
+	 *
+	 * Only sent when that changes. Servers without lobby filters ignore it, the filters
+	 * are still applied here as well.
+	 */
+	void send_server_filter();
+
 	widget_data make_game_row_data(const mp::game_info& game);
 
 	void adjust_game_row_contents(const mp::game_info& game, grid* grid, bool add_callbacks = true);
@@ -165,6 +173,9 @@ private:
 
 	wesnothd_connection &network_connection_;
 
+	/** The last [lobby_filter] sent to the server. */
+	config server_filter_;
+
 	/** Timer for updating the lobby. */
 	std::size_t lobby_update_timer_;
 
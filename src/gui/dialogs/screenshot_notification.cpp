@@ -23,6 +23,7 @@
 #include "gettext.hpp"
 #include "gui/auxiliary/find_widget.hpp"
 #include "gui/core/event/dispatcher.hpp"
+#include "gui/core/timer.hpp"
 #include "gui/dialogs/message.hpp"
 #include "gui/widgets/button.hpp"
 #include "gui/widgets/label.hpp"
@@ -32,6 +33,7 @@
 
 #include <boost/filesystem/path.hpp>
 
+#include <chrono>
 #include <functional>
 #include <stdexcept>
 
@@ -45,6 +47,8 @@ screenshot_notification::screenshot_notification(const std::string& path, surfac
 	, path_(path)
 	, screenshots_dir_path_(filesystem::get_screenshot_dir())
 	, screenshot_(screenshot)
+	, pending_save_()
+	, save_timer_id_(0)
 {
 }
 
@@ -85,8 +89,23 @@ void screenshot_notification::pre_show(window& window)
 	connect_signal_mouse_left_click(save_b, std::bind(&screenshot_notification::save_screenshot, this));
 }
 
+void screenshot_notification::post_show(window& /*window*/)
+{
+	remove_timer(save_timer_id_);
+	save_timer_id_ = 0;
+
+	// Don't leave a half-written file behind if the dialog is closed early.
+	if(pending_save_.valid()) {
+		pending_save_.wait();
+	}
+}
+
 void screenshot_notification::save_screenshot()
 {
+	if(pending_save_.valid()) {
+		return;
+	}
+
 	text_box& path_box = find_widget<text_box>(get_window(), "path", false);
 	std::string filename = path_box.get_value();
 	boost::filesystem::path path(screenshots_dir_path_);
@@ -94,7 +113,34 @@ void screenshot_notification::save_screenshot()
 
 	path_ = path.string();
 
-	image::save_result res = image::save_image(screenshot_, path.string());
+	// Encoding a large screenshot can take a while, so it's done in the
+	// background and the dialog stays responsive.
+	path_box.set_active(false);
+	find_widget<button>(get_window(), "save", false).set_active(false);
+
+	pending_save_ = image::save_image_async(screenshot_, path_);
+	save_timer_id_ = add_timer(50, [this](std::size_t) { check_pending_save(); }, true);
+}
+
+void screenshot_notification::check_pending_save()
+{
+	if(!pending_save_.valid()
+		|| pending_save_.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+	{
+		return;
+	}
+
+	remove_timer(save_timer_id_);
+	save_timer_id_ = 0;
+
+	const image::save_result res = pending_save_.get();
+
+	text_box& path_box = find_widget<text_box>(get_window(), "path", false);
+	if(res != image::save_result::success) {
+		path_box.set_active(true);
+		find_widget<button>(get_window(), "save", false).set_active(true);
+	}
+
 	if(res == image::save_result::unsupported_format) {
 		gui2::show_error_message(_("Unsupported image format.\n\n"
 			"Try to save the screenshot as PNG instead."));
@@ -105,9 +151,7 @@ void screenshot_notification::save_screenshot()
 	} else if(res != image::save_result::success) {
 		throw std::logic_error("Unexpected error while trying to save a screenshot");
 	} else {
-		path_box.set_active(false);
 		find_widget<button>(get_window(), "open", false).set_active(true);
-		find_widget<button>(get_window(), "save", false).set_active(false);
 
 		if(desktop::clipboard::available()) {
 			find_widget<button>(get_window(), "copy", false).set_active(true);
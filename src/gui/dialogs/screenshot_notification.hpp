@@ -16,8 +16,11 @@
 #pragma once
 
 #include "gui/dialogs/modal_dialog.hpp"
+#include "picture.hpp"
 #include "sdl/surface.hpp"
 
+#include <future>
+
 namespace gui2::dialogs
 {
 
@@ -56,11 +59,23 @@ private:
 	const std::string screenshots_dir_path_;
 	surface screenshot_;
 
+	/** The image being written in the background, if any. */
+	std::future<image::save_result> pending_save_;
+
+	/** Polls @ref pending_save_ while it's being written. */
+	std::size_t save_timer_id_;
+
 	void save_screenshot();
+
+	/** Reports the outcome of @ref pending_save_ once the worker is done. */
+	void check_pending_save();
+
 	void keypress_callback(bool& handled, const SDL_Keycode key);
 
 	virtual const std::string& window_id() const override;
 
 	virtual void pre_show(window& window) override;
+
+	virtual void post_show(window& window) override;
 };
 } // namespace dialogs
@@ -24,8 +24,6 @@
 #include "gui/core/gui_definition.hpp"
 #include "gui/widgets/settings.hpp"
 #include "preferences/general.hpp"
-#include "serialization/parser.hpp"
-#include "serialization/preprocessor.hpp"
 #include "serialization/schema_validator.hpp"
 #include "wml_exception.hpp"
 
@@ -51,10 +49,9 @@ void init()
 	try {
 		schema_validation::schema_validator validator(filesystem::get_wml_location("schema/gui.cfg"));
 
-		preproc_map preproc(game_config::config_cache::instance().get_preproc_map());
-		filesystem::scoped_istream stream = preprocess_file(filesystem::get_wml_location("gui/_main.cfg"), &preproc);
-
-		read(cfg, *stream, &validator);
+		// Goes through the config cache so the preprocessed and parsed GUI WML
+		// is kept in the user's cache directory between runs.
+		game_config::config_cache::instance().get_config(filesystem::get_wml_location("gui/_main.cfg"), cfg, &validator);
 	} catch(const config::error& e) {
 		ERR_GUI_P << e.what();
 		ERR_GUI_P << "Setting: could not read file 'data/gui/_main.cfg'.";
@@ -199,6 +199,14 @@ void horizontal_list::set_visible_rectangle(const SDL_Rect& rectangle)
 	 */
 	for(std::size_t i = 0; i < get_item_count(); ++i) {
 		grid& grid = item_ordered(i);
+
+		// Items scrolled out of view only need to be marked as such, their
+		// children are not drawn and get updated once the item is visible again.
+		if(!grid.get_rectangle().overlaps(rectangle)) {
+			grid.widget::set_visible_rectangle(rectangle);
+			continue;
+		}
+
 		grid.set_visible_rectangle(rectangle);
 	}
 }
@@ -208,7 +216,8 @@ widget* horizontal_list::find_at(const point& coordinate, const bool must_be_act
 	assert(get_window());
 
 	for(std::size_t i = 0; i < get_item_count(); ++i) {
-		if(!get_item_shown(i)) {
+		// The children of an item are placed inside it, so only search the item under the cursor.
+		if(!get_item_shown(i) || !item(i).get_rectangle().contains(coordinate)) {
 			continue;
 		}
 
@@ -227,7 +236,8 @@ const widget* horizontal_list::find_at(const point& coordinate, const bool must_
 	assert(get_window());
 
 	for(std::size_t i = 0; i < get_item_count(); ++i) {
-		if(!get_item_shown(i)) {
+		// The children of an item are placed inside it, so only search the item under the cursor.
+		if(!get_item_shown(i) || !item(i).get_rectangle().contains(coordinate)) {
 			continue;
 		}
 
@@ -410,6 +420,14 @@ void vertical_list::set_visible_rectangle(const SDL_Rect& rectangle)
 	 */
 	for(std::size_t i = 0; i < get_item_count(); ++i) {
 		grid& grid = item(i);
+
+		// Items scrolled out of view only need to be marked as such, their
+		// children are not drawn and get updated once the item is visible again.
+		if(!grid.get_rectangle().overlaps(rectangle)) {
+			grid.widget::set_visible_rectangle(rectangle);
+			continue;
+		}
+
 		grid.set_visible_rectangle(rectangle);
 	}
 }
@@ -419,7 +437,8 @@ widget* vertical_list::find_at(const point& coordinate, const bool must_be_activ
 	assert(get_window());
 
 	for(std::size_t i = 0; i < get_item_count(); ++i) {
-		if(!get_item_shown(i)) {
+		// The children of an item are placed inside it, so only search the item under the cursor.
+		if(!get_item_shown(i) || !item(i).get_rectangle().contains(coordinate)) {
 			continue;
 		}
 
@@ -437,7 +456,8 @@ const widget* vertical_list::find_at(const point& coordinate, const bool must_be
 	assert(get_window());
 
 	for(std::size_t i = 0; i < get_item_count(); ++i) {
-		if(!get_item_shown(i)) {
+		// The children of an item are placed inside it, so only search the item under the cursor.
+		if(!get_item_shown(i) || !item(i).get_rectangle().contains(coordinate)) {
 			continue;
 		}
 
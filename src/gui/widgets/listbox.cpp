@@ -600,7 +600,20 @@ void listbox::order_by(const generator_base::order_func& func)
 {
 	generator_->set_order(func);
 
-	update_layout();
+	assert(content_grid());
+
+	// If we haven't initialized, or have no content, just return.
+	const point size = content_grid()->get_size();
+	if(size.x <= 0 || size.y <= 0) {
+		return;
+	}
+
+	// Sorting doesn't change the size of any row, so moving the rows to their
+	// new positions is enough; there's no need to lay all of them out again.
+	generator_->set_origin(generator_->get_origin());
+	content_grid()->set_visible_rectangle(content_visible_area_);
+
+	queue_redraw();
 }
 
 void listbox::set_column_order(unsigned col, const generator_sort_array& func)
@@ -83,6 +83,8 @@ class halo_impl
 
 		// The current halo image frame
 		texture tex_ = {};
+		// The animation frame tex_ was loaded for, so it is only looked up again when the frame changes
+		const image::locator* tex_image_ = nullptr;
 		// The current location where the halo will be drawn on the screen
 		rect screen_loc_ = {};
 		// The last drawn location
@@ -208,7 +210,11 @@ void halo_impl::effect::update()
 	}
 
 	// Load texture for current animation frame
-	tex_ = image::get_texture(current_image());
+	if(!tex_ || tex_image_ != &current_image()) {
+		tex_ = image::get_texture(current_image());
+		tex_image_ = &current_image();
+	}
+
 	if(!tex_) {
 		ERR_HL << "no texture found for current halo animation frame";
 		screen_loc_ = {};
@@ -281,6 +281,9 @@ bool command_executor::do_execute_command(const hotkey_command&  cmd, int /*inde
 		case HOTKEY_REPLAY_STOP:
 			stop_replay();
 			break;
+		case HOTKEY_REPLAY_PREV_TURN:
+			replay_prev_turn();
+			break;
 		case HOTKEY_REPLAY_NEXT_TURN:
 			replay_next_turn();
 			break;
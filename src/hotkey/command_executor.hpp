@@ -86,6 +86,7 @@ public:
 	virtual void play_replay() {  }
 	virtual void reset_replay() {}
 	virtual void stop_replay() {}
+	virtual void replay_prev_turn() {}
 	virtual void replay_next_turn() {  }
 	virtual void replay_next_side() {  }
 	virtual void replay_next_move() {  }
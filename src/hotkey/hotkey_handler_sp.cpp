@@ -295,6 +295,7 @@ bool playsingle_controller::hotkey_handler::can_execute_command(const hotkey::ho
 		case hotkey::HOTKEY_REPLAY_SHOW_EACH:
 		case hotkey::HOTKEY_REPLAY_SHOW_TEAM1:
 		case hotkey::HOTKEY_REPLAY_RESET:
+		case hotkey::HOTKEY_REPLAY_PREV_TURN:
 			return playsingle_controller_.get_replay_controller() && playsingle_controller_.get_replay_controller()->can_execute_command(cmd, index);
 		case hotkey::HOTKEY_REPLAY_EXIT:
 			return playsingle_controller_.is_replay() && (!playsingle_controller_.is_networked_mp() || resources::recorder->at_end());
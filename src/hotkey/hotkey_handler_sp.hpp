@@ -92,6 +92,8 @@ public:
 	{ return get_replay_controller().replay_show_team1(); }
 	virtual void reset_replay() override
 	{ return playsingle_controller_.reset_replay(); }
+	virtual void replay_prev_turn() override
+	{ return playsingle_controller_.replay_prev_turn(); }
 	virtual void replay_exit() override;
 	virtual void load_autosave(const std::string& filename) override;
 	virtual hotkey::ACTION_STATE get_action_state(hotkey::HOTKEY_COMMAND command, int index) const override;
@@ -74,6 +74,55 @@ modification * modification_queue::top() const
 	return priorities_.begin()->second.front().get();
 }
 
+void modification_queue::apply_top(surface& surf)
+{
+	// Pop the modifications before running them, so that a failing one
+	// leaves the queue like the others, and keep them alive meanwhile.
+	std::vector<std::shared_ptr<modification>> run { priorities_.begin()->second.front() };
+	pop();
+
+	const modification& mod = *run.front();
+	if(mod.per_pixel()) {
+		while(!empty() && top()->per_pixel()) {
+			run.push_back(priorities_.begin()->second.front());
+			pop();
+		}
+	} else if(!mod.in_place()) {
+		surf = mod(surf);
+		return;
+	}
+
+	if(surf == nullptr) {
+		return;
+	}
+
+	// Other holders of the surface, such as the image cache, must not see
+	// it change. A surface returned by an earlier modification is ours.
+	if(surf->refcount > 1) {
+		surf = surf.clone();
+	}
+
+	if(!mod.per_pixel()) {
+		mod.apply_in_place(surf);
+		return;
+	}
+
+	surface_lock lock(surf);
+	uint32_t* const beg = lock.pixels();
+	uint32_t* const end = beg + surf->w * surf->h;
+
+	// Run all the modifications over a block of pixels while it is in the
+	// cache, rather than each over the whole image.
+	const std::ptrdiff_t block_size = 4096;
+	for(uint32_t* block = beg; block != end;) {
+		uint32_t* const block_end = end - block > block_size ? block + block_size : end;
+		for(const auto& pixel_mod : run) {
+			pixel_mod->apply_to_pixels(block, block_end);
+		}
+		block = block_end;
+	}
+}
+
 
 namespace {
 
@@ -157,6 +206,11 @@ surface rc_modification::operator()(const surface& src) const
 	return recolor_image(src, rc_map_);
 }
 
+void rc_modification::apply_to_pixels(uint32_t* beg, uint32_t* end) const
+{
+	recolor_pixels(beg, end, rc_map_);
+}
+
 surface fl_modification::operator()(const surface& src) const
 {
 	surface ret = src;
@@ -197,31 +251,61 @@ surface gs_modification::operator()(const surface& src) const
 	return greyscale_image(src);
 }
 
+void gs_modification::apply_to_pixels(uint32_t* beg, uint32_t* end) const
+{
+	greyscale_pixels(beg, end);
+}
+
 surface bw_modification::operator()(const surface& src) const
 {
 	return monochrome_image(src, threshold_);
 }
 
+void bw_modification::apply_to_pixels(uint32_t* beg, uint32_t* end) const
+{
+	monochrome_pixels(beg, end, threshold_);
+}
+
 surface sepia_modification::operator()(const surface &src) const
 {
 	return sepia_image(src);
 }
 
+void sepia_modification::apply_to_pixels(uint32_t* beg, uint32_t* end) const
+{
+	sepia_pixels(beg, end);
+}
+
 surface negative_modification::operator()(const surface &src) const
 {
 	return negative_image(src, red_, green_, blue_);
 }
 
+void negative_modification::apply_to_pixels(uint32_t* beg, uint32_t* end) const
+{
+	negative_pixels(beg, end, red_, green_, blue_);
+}
+
 surface plot_alpha_modification::operator()(const surface& src) const
 {
 	return alpha_to_greyscale(src);
 }
 
+void plot_alpha_modification::apply_to_pixels(uint32_t* beg, uint32_t* end) const
+{
+	alpha_to_greyscale_pixels(beg, end);
+}
+
 surface wipe_alpha_modification::operator()(const surface& src) const
 {
 	return wipe_alpha(src);
 }
 
+void wipe_alpha_modification::apply_to_pixels(uint32_t* beg, uint32_t* end) const
+{
+	wipe_alpha_pixels(beg, end);
+}
+
 // TODO: Is this useful enough to move into formula/callable_objects?
 class pixel_callable : public wfl::formula_callable
 {
@@ -396,20 +480,27 @@ surface crop_modification::operator()(const surface& src) const
 
 surface blit_modification::operator()(const surface& src) const
 {
-	if(x_ >= src->w) {
+	surface nsrc = src.clone();
+	apply_in_place(nsrc);
+	return nsrc;
+}
+
+void blit_modification::apply_in_place(surface& surf) const
+{
+	if(x_ >= surf->w) {
 		std::stringstream sstr;
 		sstr << "~BLIT(): x-coordinate '"
 			<< x_ << "' larger than destination image's width '"
-			<< src->w << "' no blitting performed.\n";
+			<< surf->w << "' no blitting performed.\n";
 
 		throw imod_exception(sstr);
 	}
 
-	if(y_ >= src->h) {
+	if(y_ >= surf->h) {
 		std::stringstream sstr;
 		sstr << "~BLIT(): y-coordinate '"
 			<< y_ << "' larger than destination image's height '"
-			<< src->h << "' no blitting performed.\n";
+			<< surf->h << "' no blitting performed.\n";
 
 		throw imod_exception(sstr);
 	}
@@ -430,10 +521,8 @@ surface blit_modification::operator()(const surface& src) const
 		throw imod_exception(sstr);
 	}
 
-	surface nsrc = src.clone();
 	SDL_Rect r {x_, y_, 0, 0};
-	sdl_blit(surf_, nullptr, nsrc, &r);
-	return nsrc;
+	sdl_blit(surf_, nullptr, surf, &r);
 }
 
 surface mask_modification::operator()(const surface& src) const
@@ -580,6 +669,11 @@ surface cs_modification::operator()(const surface& src) const
 	);
 }
 
+void cs_modification::apply_to_pixels(uint32_t* beg, uint32_t* end) const
+{
+	adjust_pixels_color(beg, end, r_, g_, b_);
+}
+
 surface blend_modification::operator()(const surface& src) const
 {
 	return blend_surface(src, static_cast<double>(a_), color_t(r_, g_, b_));
@@ -50,6 +50,18 @@ public:
 	std::size_t size() const;
 	modification * top() const;
 
+	/**
+	 * Applies the top modification to @a surf and removes it from the queue.
+	 *
+	 * Consecutive per-pixel modifications are removed and applied together,
+	 * in a single pass over the pixels. These and other modifications that
+	 * support it change @a surf in place, after copying it if it is shared.
+	 *
+	 * @throws modification::imod_exception if the modification failed. It is
+	 *                                      removed from the queue anyway.
+	 */
+	void apply_top(surface& surf);
+
 private:
 	/** Map from a mod's priority() to the mods having that priority. */
 	typedef std::map<int, std::vector<std::shared_ptr<modification>>, std::greater<int>> map_type;
@@ -104,6 +116,24 @@ public:
 	/** Applies the image-path modification on the specified surface */
 	virtual surface operator()(const surface& src) const = 0;
 
+	/** Whether apply_in_place() changes the surface without allocating a new one. */
+	virtual bool in_place() const { return false; }
+
+	/**
+	 * Applies the modification to @a surf, which is neutral and not shared,
+	 * so it may be changed directly. The default uses operator().
+	 */
+	virtual void apply_in_place(surface& surf) const { surf = (*this)(surf); }
+
+	/**
+	 * Whether the modification computes each pixel from its old value alone.
+	 * Such modifications implement apply_to_pixels().
+	 */
+	virtual bool per_pixel() const { return false; }
+
+	/** Applies a per-pixel modification to the neutral pixels in [beg, end). */
+	virtual void apply_to_pixels(uint32_t* /*beg*/, uint32_t* /*end*/) const {}
+
 	/** Specifies the priority of the modification */
 	virtual int priority() const { return 0; }
 };
@@ -131,6 +161,8 @@ public:
 		: rc_map_(recolor_map)
 	{}
 	virtual surface operator()(const surface& src) const;
+	virtual bool per_pixel() const { return !no_op(); }
+	virtual void apply_to_pixels(uint32_t* beg, uint32_t* end) const;
 
 	// The rc modification has a higher priority
 	virtual int priority() const { return 1; }
@@ -222,6 +254,8 @@ class gs_modification : public modification
 {
 public:
 	virtual surface operator()(const surface& src) const;
+	virtual bool per_pixel() const { return true; }
+	virtual void apply_to_pixels(uint32_t* beg, uint32_t* end) const;
 };
 
 /**
@@ -232,6 +266,8 @@ class bw_modification : public modification
 public:
 	bw_modification(int threshold): threshold_(threshold) {}
 	virtual surface operator()(const surface& src) const;
+	virtual bool per_pixel() const { return true; }
+	virtual void apply_to_pixels(uint32_t* beg, uint32_t* end) const;
 private:
 	int threshold_;
 };
@@ -242,6 +278,8 @@ private:
 struct sepia_modification : modification
 {
 	virtual surface operator()(const surface &src) const;
+	virtual bool per_pixel() const { return true; }
+	virtual void apply_to_pixels(uint32_t* beg, uint32_t* end) const;
 };
 
 /**
@@ -252,6 +290,8 @@ class negative_modification : public modification
 public:
 	negative_modification(int r, int g, int b): red_(r), green_(g), blue_(b) {}
 	virtual surface operator()(const surface &src) const;
+	virtual bool per_pixel() const { return true; }
+	virtual void apply_to_pixels(uint32_t* beg, uint32_t* end) const;
 private:
 	int red_, green_, blue_;
 };
@@ -263,6 +303,8 @@ class plot_alpha_modification : public modification
 {
 public:
 	virtual surface operator()(const surface& src) const;
+	virtual bool per_pixel() const { return true; }
+	virtual void apply_to_pixels(uint32_t* beg, uint32_t* end) const;
 };
 
 /**
@@ -272,6 +314,8 @@ class wipe_alpha_modification : public modification
 {
 public:
 	virtual surface operator()(const surface& src) const;
+	virtual bool per_pixel() const { return true; }
+	virtual void apply_to_pixels(uint32_t* beg, uint32_t* end) const;
 };
 
 /**
@@ -350,6 +394,8 @@ public:
 		: surf_(surf), x_(x), y_(y)
 	{}
 	virtual surface operator()(const surface& src) const;
+	virtual bool in_place() const { return true; }
+	virtual void apply_in_place(surface& surf) const;
 
 	const surface& get_surface() const
 	{
@@ -527,6 +573,8 @@ public:
 		: r_(r), g_(g), b_(b)
 	{}
 	virtual surface operator()(const surface& src) const;
+	virtual bool per_pixel() const { return r_ != 0 || g_ != 0 || b_ != 0; }
+	virtual void apply_to_pixels(uint32_t* beg, uint32_t* end) const;
 
 	int get_r() const { return r_; }
 	int get_g() const { return g_; }
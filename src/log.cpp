@@ -31,6 +31,7 @@
 #include <sstream>
 #include <ctime>
 #include <mutex>
+#include <optional>
 #include <iostream>
 #include <iomanip>
 
@@ -264,6 +265,10 @@ bool broke_strict() {
 	return strict_threw_;
 }
 
+void reset_broke_strict() {
+	strict_threw_ = false;
+}
+
 std::string get_timestamp(const std::time_t& t, const std::string& format) {
 	std::ostringstream ss;
 
@@ -304,15 +309,23 @@ std::string sanitize_log(const std::string& logstr)
 {
 	std::string str = logstr;
 
+	// The user name doesn't change while running, so only build the patterns once.
+	static const std::optional<std::pair<std::string, std::string>> user_paths = []() -> std::optional<std::pair<std::string, std::string>> {
 #ifdef _WIN32
-	const char* user_name = getenv("USERNAME");
+		const char* user_name = getenv("USERNAME");
 #else
-	const char* user_name = getenv("USER");
+		const char* user_name = getenv("USER");
 #endif
+		if(user_name == nullptr) {
+			return std::nullopt;
+		}
 
-	if(user_name != nullptr) {
-		boost::replace_all(str, std::string("/") + user_name + "/", "/USER/");
-		boost::replace_all(str, std::string("\\") + user_name + "\\", "\\USER\\");
+		return std::pair(std::string("/") + user_name + "/", std::string("\\") + user_name + "\\");
+	}();
+
+	if(user_paths) {
+		boost::replace_all(str, user_paths->first, "/USER/");
+		boost::replace_all(str, user_paths->second, "\\USER\\");
 	}
 
 	return str;
@@ -354,19 +367,30 @@ log_in_progress::log_in_progress(std::ostream& stream)
 
 void log_in_progress::operator|(formatter&& message)
 {
-	std::scoped_lock lock(log_mutex);
+	// Put the whole record together before taking the lock, so that it goes
+	// out as a single write: std::cerr is unbuffered and would otherwise
+	// issue a separate write for every piece of the line.
+	std::ostringstream line;
 	for(int i = 0; i < indent; ++i)
-		stream_ << "  ";
+		line << "  ";
 	if(timestamp_) {
 		if(precise_timestamp) {
-			print_precise_timestamp(stream_);
+			print_precise_timestamp(line);
 		} else {
-			stream_ << get_timestamp(std::time(nullptr));
+			line << get_timestamp(std::time(nullptr));
 		}
 	}
-	stream_ << prefix_ << sanitize_log(message.str());
+	line << prefix_ << sanitize_log(message.str());
+	if(auto_newline_) {
+		line << '\n';
+	}
+
+	const std::string record = line.str();
+
+	std::scoped_lock lock(log_mutex);
+	stream_.write(record.data(), record.size());
 	if(auto_newline_) {
-		stream_ << std::endl;
+		stream_.flush();
 	}
 }
 
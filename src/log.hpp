@@ -126,6 +126,8 @@ std::string list_logdomains(const std::string& filter);
 void set_strict_severity(int severity);
 void set_strict_severity(const logger &lg);
 bool broke_strict();
+/** Forgets that the strict level was broken, so several unit tests can be run in one process. */
+void reset_broke_strict();
 void set_log_to_file();
 
 bool is_not_log_file(const std::string& filename);
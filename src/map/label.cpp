@@ -479,11 +479,13 @@ void terrain_label::update_info(const t_string& text,
 
 void terrain_label::calculate_shroud()
 {
+	const bool is_hidden = hidden();
+
 	if(handle_) {
-		font::show_floating_label(handle_, !hidden());
+		font::show_floating_label(handle_, !is_hidden);
 	}
 
-	if(tooltip_.empty() || hidden()) {
+	if(tooltip_.empty() || is_hidden) {
 		tooltips::remove_tooltip(tooltip_handle_);
 		tooltip_handle_ = 0;
 		return;
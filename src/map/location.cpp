@@ -317,8 +317,8 @@ map_location map_location::rotate_right_around_center(const map_location & cente
 
 bool map_location::matches_range(const std::string& xloc, const std::string &yloc) const
 {
-	const auto xlocs = utils::split(xloc);
-	const auto ylocs = utils::split(yloc);
+	const auto xlocs = utils::split_view(xloc);
+	const auto ylocs = utils::split_view(yloc);
 
 	if(xlocs.size() == 0 && ylocs.size() == 0) {
 		return true;
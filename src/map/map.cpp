@@ -425,8 +425,8 @@ std::vector<map_location> gamemap_base::parse_location_range(const std::string &
 	bool with_border) const
 {
 	std::vector<map_location> res;
-	const std::vector<std::string> xvals = utils::split(x);
-	const std::vector<std::string> yvals = utils::split(y);
+	const std::vector<std::string_view> xvals = utils::split_view(x);
+	const std::vector<std::string_view> yvals = utils::split_view(y);
 	int xmin = 1, xmax = w(), ymin = 1, ymax = h();
 	if (with_border) {
 		int bs = border_size();
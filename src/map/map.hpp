@@ -33,6 +33,11 @@ public:
 	using location_map = t_translation::starting_positions;
 	virtual ~gamemap_base();
 
+	gamemap_base(const gamemap_base&) = default;
+	gamemap_base(gamemap_base&&) = default;
+	gamemap_base& operator=(const gamemap_base&) = default;
+	gamemap_base& operator=(gamemap_base&&) = default;
+
 	/** The default border style for a map. */
 	static const int default_border = 1;
 
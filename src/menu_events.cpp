@@ -83,6 +83,7 @@
 #include "units/udisplay.hpp"
 #include "units/unit.hpp"
 #include "units/types.hpp"
+#include "utils/perf_counter.hpp"
 #include "whiteboard/manager.hpp"
 #include "sound.hpp"
 
@@ -1145,6 +1146,8 @@ protected:
 	void do_layers();
 	void do_fps();
 	void do_benchmark();
+	void do_memory();
+	void do_perf();
 	void do_save();
 	void do_save_quit();
 	void do_quit();
@@ -1247,6 +1250,9 @@ protected:
 				"layers", &console_handler::do_layers, _("Debug layers from terrain under the mouse."), "", "D");
 		register_command("fps", &console_handler::do_fps, _("Display and log fps (Frames Per Second)."));
 		register_command("benchmark", &console_handler::do_benchmark, _("Similar to the 'fps' command, but also forces everything to redraw instead of only things that have changed."));
+		register_command("memory", &console_handler::do_memory, _("Show the approximate memory used by the game config, image caches, Lua and other subsystems."));
+		register_command("perf", &console_handler::do_perf,
+				_("Show the calls and time spent in instrumented engine code, or reset the counters."), _("[reset]"));
 		register_command("save", &console_handler::do_save, _("Save game."));
 		register_alias("save", "w");
 		register_command("quit", &console_handler::do_quit, _("Quit game."));
@@ -1768,6 +1774,35 @@ void console_handler::do_benchmark()
 	menu_handler_.gui_->toggle_debug_flag(display::DEBUG_BENCHMARK);
 }
 
+void console_handler::do_memory()
+{
+	std::size_t total = 0;
+	for(const auto& [name, bytes] : menu_handler_.pc_.memory_usage()) {
+		print(get_cmd(), name + ": " + std::to_string(bytes / 1024) + " KiB");
+		total += bytes;
+	}
+
+	print(get_cmd(), "total: " + std::to_string(total / 1024) + " KiB");
+}
+
+void console_handler::do_perf()
+{
+	if(get_arg(1) == "reset") {
+		util::perf_counter::reset_all();
+		return;
+	}
+
+	const std::string report = util::perf_counter::report();
+	if(report.empty()) {
+		print(get_cmd(), _("No instrumented code has run yet."));
+		return;
+	}
+
+	for(const std::string& line : utils::split(report, '\n')) {
+		print(get_cmd(), line);
+	}
+}
+
 void console_handler::do_save()
 {
 	menu_handler_.pc_.do_consolesave(get_data());
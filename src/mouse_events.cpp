@@ -1071,16 +1071,16 @@ void mouse_handler::select_hex(const map_location& hex, const bool browse, const
 		pathfind::paths clicked_location;
 		clicked_location.destinations.insert(hex);
 
-		for(unit_map::iterator u = pc_.get_units().begin(); u != pc_.get_units().end();
-				++u) {
-			bool invisible = u->invisible(u->get_location());
+		const auto visible = [this](const ::unit& u) {
+			return !gui_->fogged(u.get_location()) && !u.incapacitated() && !u.invisible(u.get_location());
+		};
 
-			if(!gui_->fogged(u->get_location()) && !u->incapacitated() && !invisible) {
-				const pathfind::paths& path =
-					pathfind::paths(*u, false, true, viewing_team(), path_turns_, false, false);
+		for(const team& t : pc_.get_teams()) {
+			const pathfind::side_reach reach(t.side(), viewing_team(), path_turns_, false, visible);
 
-				if(path.destinations.find(hex) != path.destinations.end()) {
-					reaching_unit_locations.destinations.insert(u->get_location());
+			for(const ::unit& u : pc_.get_units()) {
+				if(u.side() == t.side() && reach.can_reach(u.get_location(), hex)) {
+					reaching_unit_locations.destinations.insert(u.get_location());
 					gui_->highlight_another_reach(clicked_location);
 				}
 			}
@@ -27,6 +27,9 @@
 #include "terrain/translation.hpp"
 #include "units/types.hpp" // for attack_type
 
+#include <cstdint>
+#include <unordered_map>
+
 static lg::log_domain log_config("config");
 #define ERR_CF LOG_STREAM(err, log_config)
 #define WRN_CF LOG_STREAM(warn, log_config)
@@ -97,28 +100,35 @@ public:
 	 * @a params must be long-lived (typically a static variable).
 	 */
 	explicit data(const parameters & params) :
-		cfg_(), cache_(), params_(params)
+		cfg_(), base_(), base_depth_(0), cache_(), params_(params)
 	{}
 	/**
 	 * Constructor.
 	 * @a params must be long-lived (typically a static variable).
 	 */
 	data(const config & cfg, const parameters & params) :
-		cfg_(cfg), cache_(), params_(params)
+		cfg_(cfg), base_(), base_depth_(0), cache_(), params_(params)
 	{}
 
 	// The copy constructor does not bother copying the cache since
 	// typically the cache will be cleared shortly after the copy.
 	data(const data & that) :
-		cfg_(that.cfg_), cache_(), params_(that.params_)
+		cfg_(that.cfg_), base_(that.base_), base_depth_(that.base_depth_), cache_(), params_(that.params_)
 	{}
 
+	/**
+	 * Constructor for a writable copy of shared data.
+	 * Only the values merged into the copy are stored in it, the others
+	 * are read from @a base.
+	 */
+	explicit data(std::shared_ptr<const data> base);
+
 	/** Clears the cached data (presumably our fallback has changed). */
 	void clear_cache() const;
 	/** Tests if merging @a new_values would result in changes. */
 	bool config_has_changes(const config & new_values, bool overwrite) const;
 	/** Tests for no data in this object. */
-	bool empty() const { return cfg_.empty(); }
+	bool empty() const { return cfg_.empty() && (!base_ || base_->empty()); }
 	/** Merges the given config over the existing costs. */
 	void merge(const config & new_values, bool overwrite);
 	/** Read-only access to our parameters. */
@@ -134,6 +144,10 @@ public:
 	           const terrain_info * fallback) const;
 
 private:
+	/** Returns the configured value for the terrain @a id, or nullptr. */
+	const config::attribute_value * get(const std::string & id) const;
+	/** Merges the data of our bases and then ours into @a out. */
+	void merge_into(config & out) const;
 	/** Calculates the value associated with the given terrain. */
 	int calc_value(const t_translation::terrain_code & terrain,
 	               const terrain_info * fallback, unsigned recurse_count) const;
@@ -142,10 +156,28 @@ private:
 	          const terrain_info * fallback, unsigned recurse_count) const;
 
 private:
-	typedef std::map<t_translation::terrain_code, int> cache_t;
+	struct terrain_code_hash
+	{
+		std::size_t operator()(const t_translation::terrain_code & terrain) const
+		{
+			return std::hash<std::uint64_t>()((std::uint64_t(terrain.base) << 32) | terrain.overlay);
+		}
+	};
+
+	typedef std::unordered_map<t_translation::terrain_code, int, terrain_code_hash> cache_t;
 
-	/** Config describing the terrain values. */
+	/**
+	 * Bases longer than this are flattened into a single config, so lookups
+	 * of units that went through many rounds of copy and merge stay cheap.
+	 */
+	static const unsigned max_base_depth = 4;
+
+	/** Config describing the terrain values, over those of base_. */
 	config cfg_;
+	/** Shared data this was copied from, consulted for values not in cfg_. */
+	std::shared_ptr<const data> base_;
+	/** Length of the chain of bases. */
+	unsigned base_depth_;
 	/** Cache of values based on the config. */
 	mutable cache_t cache_;
 	/** Various parameters used when calculating values. */
@@ -153,6 +185,43 @@ private:
 };
 
 
+movetype::terrain_info::data::data(std::shared_ptr<const data> base) :
+	cfg_(), base_(), base_depth_(0), cache_(), params_(base->params_)
+{
+	if(base->base_depth_ < max_base_depth) {
+		base_depth_ = base->base_depth_ + 1;
+		base_ = std::move(base);
+	} else {
+		base->merge_into(cfg_);
+	}
+}
+
+
+/**
+ * Returns the configured value for the terrain @a id, looking through the
+ * bases when it is not set here.
+ */
+const config::attribute_value * movetype::terrain_info::data::get(const std::string & id) const
+{
+	if(const config::attribute_value * val = cfg_.get(id)) {
+		return val;
+	}
+	return base_ ? base_->get(id) : nullptr;
+}
+
+
+/**
+ * Merges the data of our bases and then ours into @a out.
+ */
+void movetype::terrain_info::data::merge_into(config & out) const
+{
+	if(base_) {
+		base_->merge_into(out);
+	}
+	out.merge_with(cfg_);
+}
+
+
 /**
  * Clears the cached data (presumably our fallback has changed).
  */
@@ -172,9 +241,11 @@ bool movetype::terrain_info::data::config_has_changes(const config & new_values,
                                                       bool overwrite) const
 {
 	if ( overwrite ) {
-		for (const config::attribute & a : new_values.attribute_range())
-			if ( a.second != cfg_[a.first] )
+		for (const config::attribute & a : new_values.attribute_range()) {
+			const config::attribute_value * old = get(a.first);
+			if ( old ? a.second != *old : a.second != config::attribute_value() )
 				return true;
+		}
 	}
 	else {
 		for (const config::attribute & a : new_values.attribute_range())
@@ -206,8 +277,8 @@ void movetype::terrain_info::data::merge(const config & new_values, bool overwri
 		cfg_.merge_attributes(new_values);
 	else {
 		for (const config::attribute & a : new_values.attribute_range()) {
-			config::attribute_value & dest = cfg_[a.first];
-			int old = dest.to_int(params_.max_value);
+			const config::attribute_value * old_value = get(a.first);
+			int old = old_value ? old_value->to_int(params_.max_value) : params_.max_value;
 
 			// The new value is the absolute value of the old plus the
 			// provided value, capped between minimum and maximum, then
@@ -218,7 +289,7 @@ void movetype::terrain_info::data::merge(const config & new_values, bool overwri
 			if ( old < 0 )
 				value = -value;
 
-			dest = value;
+			cfg_[a.first] = value;
 		}
 	}
 
@@ -236,13 +307,15 @@ void movetype::terrain_info::data::merge(const config & new_values, bool overwri
 void movetype::terrain_info::data::write(
 	config & out_cfg, const std::string & child_name) const
 {
-	if ( cfg_.empty() )
+	if ( empty() )
 		return;
 
 	if ( child_name.empty() )
-		out_cfg.merge_with(cfg_);
-	else
+		merge_into(out_cfg);
+	else if ( !base_ )
 		out_cfg.add_child(child_name, cfg_);
+	else
+		merge_into(out_cfg.add_child(child_name));
 }
 
 
@@ -261,7 +334,7 @@ void movetype::terrain_info::data::write(
 
 	if ( fallback )
 		fallback->write(merged, "", true);
-	merged.merge_with(cfg_);
+	merge_into(merged);
 }
 
 
@@ -304,7 +377,7 @@ int movetype::terrain_info::data::calc_value(
 		int result = params_.default_value;
 
 		const std::string & id = tdata->get_terrain_info(terrain).id();
-		if (const config::attribute_value *val = cfg_.get(id)) {
+		if (const config::attribute_value *val = get(id)) {
 			// Read the value from our config.
 			result = val->to_int(params_.default_value);
 			if ( params_.eval != nullptr )
@@ -655,7 +728,7 @@ void movetype::terrain_info::make_data_writable() const
 	{
 		// Const hack because this is not really changing the data.
 		auto t = const_cast<terrain_info *>(this);
-		t->unique_data_.reset(new data(*shared_data_));
+		t->unique_data_.reset(new data(shared_data_));
 		t->shared_data_.reset();
 	}
 
@@ -21,6 +21,7 @@
 #include "serialization/parser.hpp"
 #include "tls_root_store.hpp"
 
+#include <boost/asio/buffers_iterator.hpp>
 #include <boost/asio/connect.hpp>
 #include <boost/asio/read.hpp>
 #include <boost/asio/write.hpp>
@@ -29,6 +30,7 @@
 #include <cstdint>
 #include <deque>
 #include <functional>
+#include <type_traits>
 
 static lg::log_domain log_network("network");
 #define DBG_NW LOG_STREAM(debug, log_network)
@@ -203,6 +205,8 @@ void connection::handle_handshake(const boost::system::error_code& ec)
 			socket.set_verify_callback(verbose_verify(boost::asio::ssl::rfc2818_verification(host_)));
 #endif
 
+			use_tls_session_cache(tls_context_, socket.native_handle(), host_, service_);
+
 			socket.async_handshake(boost::asio::ssl::stream_base::client, [this](const boost::system::error_code& ec) {
 				if(ec) {
 					throw system_error(ec);
@@ -232,6 +236,17 @@ void connection::fallback_to_unencrypted()
 }
 
 void connection::transfer(const config& request, config& response)
+{
+	start_transfer(request, response);
+}
+
+void connection::transfer(const config& request, std::string& response)
+{
+	start_transfer(request, response);
+}
+
+template<typename Response>
+void connection::start_transfer(const config& request, Response& response)
 {
 	io_context_.restart();
 	done_ = false;
@@ -255,7 +270,13 @@ void connection::transfer(const config& request, config& response)
 
 		boost::asio::async_read(*socket, *read_buf_,
 			std::bind(&connection::is_read_complete, this, std::placeholders::_1, std::placeholders::_2),
-			std::bind(&connection::handle_read, this, std::placeholders::_1, std::placeholders::_2, std::ref(response)));
+			[this, &response](const boost::system::error_code& ec, std::size_t bytes_transferred) {
+				if constexpr(std::is_same_v<Response, config>) {
+					handle_read(ec, bytes_transferred, response);
+				} else {
+					handle_read_raw(ec, bytes_transferred, response);
+				}
+			});
 	}, socket_);
 }
 
@@ -350,4 +371,21 @@ void connection::handle_read(const boost::system::error_code& ec, std::size_t by
 	std::istream is(read_buf_.get());
 	read_gz(response, is);
 }
+
+void connection::handle_read_raw(const boost::system::error_code& ec, std::size_t bytes_transferred, std::string& response)
+{
+	DBG_NW << "Read " << bytes_transferred << " bytes.";
+
+	bytes_to_read_ = 0;
+	bytes_to_write_ = 0;
+	done_ = true;
+
+	if(ec && ec != boost::asio::error::eof) {
+		throw system_error(ec);
+	}
+
+	const auto data = read_buf_->data();
+	response.assign(boost::asio::buffers_begin(data), boost::asio::buffers_end(data));
+	read_buf_->consume(read_buf_->size());
+}
 }
@@ -66,6 +66,12 @@ public:
 
 	void transfer(const config& request, config& response);
 
+	/**
+	 * Like transfer(), but keeps the response as the gzipped WML received
+	 * instead of parsing it, so that it can be decoded elsewhere.
+	 */
+	void transfer(const config& request, std::string& response);
+
 	/** Handle all pending asynchronous events and return */
 	std::size_t poll()
 	{
@@ -165,6 +171,10 @@ private:
 
 	std::size_t is_read_complete(const boost::system::error_code& error, std::size_t bytes_transferred);
 	void handle_read(const boost::system::error_code& ec, std::size_t bytes_transferred, config& response);
+	void handle_read_raw(const boost::system::error_code& ec, std::size_t bytes_transferred, std::string& response);
+
+	template<typename Response>
+	void start_transfer(const config& request, Response& response);
 
 	uint32_t payload_size_;
 
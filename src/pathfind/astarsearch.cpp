@@ -18,9 +18,12 @@
 #include "map/map.hpp"
 #include "pathfind/pathfind.hpp"
 #include "pathfind/teleport.hpp"
+#include "utils/perf_counter.hpp"
 
+#include <algorithm>
 #include <queue>
 #include <map>
+#include <tuple>
 
 static lg::log_domain log_engine("engine");
 #define LOG_PF LOG_STREAM(info, log_engine)
@@ -58,14 +61,51 @@ double heuristic(const map_location& src, const map_location& dst)
 
 // values 0 and 1 mean uninitialized
 const unsigned bad_search_counter = 0;
-// The number of nodes already processed.
-static unsigned search_counter = bad_search_counter;
+
+/**
+ * The parts of the teleport-aware heuristic that don't depend on the node,
+ * computed once per search rather than for every node constructed.
+ */
+struct teleport_heuristic {
+	teleport_heuristic(const teleport_map* teleports, const map_location& dst)
+		: sources()
+		, dst_h(1.0)
+	{
+		if (!teleports || teleports->empty()) return;
+
+		const std::set<map_location> srcs = teleports->get_sources();
+		sources.assign(srcs.begin(), srcs.end());
+
+		for(const map_location& target : teleports->get_targets()) {
+			const double tmp_dsth = heuristic(target, dst);
+			if (tmp_dsth < dst_h) { dst_h = tmp_dsth; }
+		}
+	}
+
+	bool empty() const { return sources.empty(); }
+
+	/**
+	 * Lowest heuristic from @a loc to a teleport source, capped at 1.
+	 *
+	 * The heuristic between two different hexes is at least 1, so this is
+	 * 0 on a source and 1 everywhere else.
+	 */
+	double source_h(const map_location& loc) const
+	{
+		return std::binary_search(sources.begin(), sources.end(), loc) ? 0.0 : 1.0;
+	}
+
+	/** Sorted, for source_h. */
+	std::vector<map_location> sources;
+	/** Lowest heuristic from a teleport target to the destination, capped at 1. */
+	double dst_h;
+};
 
 struct node {
 	double g, h, t;
 	map_location curr, prev;
 	/**
-	 * If equal to search_counter, the node is off the list.
+	 * If equal to the workspace's search_counter, the node is off the list.
 	 * If equal to search_counter + 1, the node is on the list.
 	 * Otherwise it is outdated.
 	 */
@@ -80,29 +120,12 @@ struct node {
 		, in(bad_search_counter)
 	{
 	}
-	node(double s, const map_location &c, const map_location &p, const map_location &dst, bool i, const teleport_map* teleports):
-		g(s), h(heuristic(c, dst)), t(g + h), curr(c), prev(p), in(search_counter + i)
+	node(double s, const map_location &c, const map_location &p, const map_location &dst, unsigned i, const teleport_heuristic& teleports):
+		g(s), h(heuristic(c, dst)), t(g + h), curr(c), prev(p), in(i)
 	{
-		if (teleports && !teleports->empty()) {
-
-			double new_srch = 1.0;
-			auto sources = teleports->get_sources();
-
-			std::set<map_location>::const_iterator it = sources.begin();
-			for(; it != sources.end(); ++it) {
-				const double tmp_srch = heuristic(c, *it);
-				if (tmp_srch < new_srch) { new_srch = tmp_srch; }
-			}
+		if (!teleports.empty()) {
 
-			double new_dsth = 1.0;
-			auto targets = teleports->get_targets();
-
-			for(it = targets.begin(); it != targets.end(); ++it) {
-				const double tmp_dsth = heuristic(*it, dst);
-				if (tmp_dsth < new_dsth) { new_dsth = tmp_dsth; }
-			}
-
-			double new_h = new_srch + new_dsth + 1.0;
+			double new_h = teleports.source_h(c) + teleports.dst_h + 1.0;
 			if (new_h < h) {
 				h = new_h;
 				t = g + h;
@@ -115,13 +138,21 @@ struct node {
 	}
 };
 
-class comp {
-	const std::vector<node>& nodes_;
+/**
+ * An entry of the open list.
+ *
+ * Nodes whose cost improves are pushed again rather than searched for and
+ * moved up the heap; entries that no longer match their node are skipped
+ * when popped.
+ */
+struct queue_entry {
+	double t;
+	int index;
+};
 
-public:
-	comp(const std::vector<node>& n) : nodes_(n) { }
-	bool operator()(int a, int b) const {
-		return nodes_[b] < nodes_[a];
+struct comp {
+	bool operator()(const queue_entry& a, const queue_entry& b) const {
+		return b.t < a.t;
 	}
 };
 
@@ -136,11 +167,45 @@ public:
 };
 }//anonymous namespace
 
+struct astar_workspace::data
+{
+	data()
+		: nodes()
+		, pq()
+		, search_counter(bad_search_counter)
+	{
+	}
+
+	std::vector<node> nodes;
+	std::vector<queue_entry> pq;
+	/** Bumped by two for each search, see node::in. */
+	unsigned search_counter;
+};
+
+astar_workspace::astar_workspace()
+	: data_(new data)
+{
+}
+
+astar_workspace::~astar_workspace()
+{
+}
+
+plain_route a_star_search(const map_location& src, const map_location& dst,
+                          double stop_at, const cost_calculator& calc,
+                          const std::size_t width, const std::size_t height,
+                          const teleport_map *teleports, bool border) {
+	static thread_local astar_workspace workspace;
+	return a_star_search(src, dst, stop_at, calc, width, height, workspace, teleports, border);
+}
 
 plain_route a_star_search(const map_location& src, const map_location& dst,
                           double stop_at, const cost_calculator& calc,
                           const std::size_t width, const std::size_t height,
+                          astar_workspace& workspace,
                           const teleport_map *teleports, bool border) {
+	PERF_TIMER("pathfind::a_star_search");
+
 	//----------------- PRE_CONDITIONS ------------------
 	assert(src.valid(width, height, border));
 	assert(dst.valid(width, height, border));
@@ -157,64 +222,71 @@ plain_route a_star_search(const map_location& src, const map_location& dst,
 	}
 
 	// increment search_counter but skip the range equivalent to uninitialized
+	unsigned& search_counter = workspace.data_->search_counter;
 	search_counter += 2;
 	if (search_counter - bad_search_counter <= 1u)
 		search_counter += 2;
 
-	static std::vector<node> nodes;
+	std::vector<node>& nodes = workspace.data_->nodes;
 	nodes.resize(width * height);  // this create uninitialized nodes
 
 	indexer index(width);
-	comp node_comp(nodes);
+	comp node_comp;
+	const teleport_heuristic teleport_h(teleports, dst);
+	const bool use_teleports = teleports && !teleports->empty();
 
 	nodes[index(dst)].g = stop_at + 1;
-	nodes[index(src)] = node(0, src, map_location::null_location(), dst, true, teleports);
+	nodes[index(src)] = node(0, src, map_location::null_location(), dst, search_counter + 1, teleport_h);
 
-	std::vector<int> pq;
-	pq.push_back(index(src));
+	std::vector<queue_entry>& pq = workspace.data_->pq;
+	pq.clear();
+	pq.push_back({nodes[index(src)].t, static_cast<int>(index(src))});
 
 	while (!pq.empty()) {
-		node& n = nodes[pq.front()];
-
-		n.in = search_counter;
+		const queue_entry top = pq.front();
 
 		std::pop_heap(pq.begin(), pq.end(), node_comp);
 		pq.pop_back();
 
-		if (n.t >= nodes[index(dst)].g) break;
+		node& n = nodes[top.index];
 
-		std::vector<map_location> locs(6);
-		get_adjacent_tiles(n.curr, locs.data());
+		// Skip entries superseded by a cheaper path to the same node
+		if (n.in != search_counter + 1 || n.t != top.t) continue;
 
-		if (teleports && !teleports->empty()) {
-			auto allowed_teleports = teleports->get_adjacents(n.curr);
-			locs.insert(locs.end(), allowed_teleports.begin(), allowed_teleports.end());
-		}
+		n.in = search_counter;
 
-		for(auto i = locs.rbegin(); i != locs.rend(); ++i) {
-			const map_location& loc = *i;
+		if (n.t >= nodes[index(dst)].g) break;
 
-			if (!loc.valid(width, height, border)) continue;
-			if (loc == n.curr) continue;
+		auto relax = [&](const map_location& loc) {
+			if (!loc.valid(width, height, border)) return;
+			if (loc == n.curr) return;
 			node& next = nodes[index(loc)];
 
 			double thresh = (next.in - search_counter <= 1u) ? next.g : stop_at + 1;
 			// cost() is always >= 1  (assumed and needed by the heuristic)
-			if (n.g + 1 >= thresh) continue;
+			if (n.g + 1 >= thresh) return;
 			double cost = n.g + calc.cost(loc, n.g);
-			if (cost >= thresh) continue;
+			if (cost >= thresh) return;
 
-			bool in_list = next.in == search_counter + 1;
+			next = node(cost, loc, n.curr, dst, search_counter + 1, teleport_h);
 
-			next = node(cost, loc, n.curr, dst, true, teleports);
+			pq.push_back({next.t, static_cast<int>(index(loc))});
+			std::push_heap(pq.begin(), pq.end(), node_comp);
+		};
 
-			if (in_list) {
-				std::push_heap(pq.begin(), std::find(pq.begin(), pq.end(), static_cast<int>(index(loc))) + 1, node_comp);
-			} else {
-				pq.push_back(index(loc));
-				std::push_heap(pq.begin(), pq.end(), node_comp);
+		if (use_teleports) {
+			const std::set<map_location> allowed_teleports = teleports->get_adjacents(n.curr);
+			for(auto i = allowed_teleports.rbegin(); i != allowed_teleports.rend(); ++i) {
+				relax(*i);
 			}
 		}
+
+		map_location adjacent[6];
+		get_adjacent_tiles(n.curr, adjacent);
+
+		for(int i = 5; i >= 0; --i) {
+			relax(adjacent[i]);
+		}
 	}
 
 	plain_route route;
@@ -234,5 +306,49 @@ plain_route a_star_search(const map_location& src, const map_location& dst,
 	return route;
 }
 
+route_cache::route_cache(std::size_t max_size)
+	: entries_()
+	, index_()
+	, max_size_(max_size)
+{
+}
+
+bool route_cache::entry_key::operator<(const entry_key& o) const
+{
+	return std::tie(calc_type, key, src, dst, stop_at) < std::tie(o.calc_type, o.key, o.src, o.dst, o.stop_at);
+}
+
+plain_route route_cache::search(std::size_t key, const map_location& src, const map_location& dst,
+		double stop_at, const cost_calculator& calc,
+		const std::size_t width, const std::size_t height,
+		const teleport_map* teleports, bool border)
+{
+	const entry_key k{typeid(calc), key, src, dst, stop_at};
+
+	auto it = index_.find(k);
+	if(it != index_.end()) {
+		DBG_PF << "A* search: " << src << " -> " << dst << " found in cache";
+		entries_.splice(entries_.begin(), entries_, it->second);
+		return it->second->second;
+	}
+
+	plain_route route = a_star_search(src, dst, stop_at, calc, width, height, teleports, border);
+
+	entries_.emplace_front(k, route);
+	index_.emplace(k, entries_.begin());
+
+	if(index_.size() > max_size_) {
+		index_.erase(entries_.back().first);
+		entries_.pop_back();
+	}
+
+	return route;
+}
+
+void route_cache::clear()
+{
+	entries_.clear();
+	index_.clear();
+}
 
 }//namespace pathfind
@@ -31,6 +31,7 @@
 #include "team.hpp"
 #include "units/unit.hpp"
 #include "units/map.hpp"
+#include "utils/perf_counter.hpp"
 #include "wml_exception.hpp"
 
 #include <vector>
@@ -134,6 +135,11 @@ map_location find_vacant_castle(const unit & leader)
 bool enemy_zoc(const team& current_team, const map_location& loc,
                const team& viewing_team, bool see_all)
 {
+	// Most hexes have no unit next to them at all.
+	if(!resources::gameboard->may_be_in_zoc(loc)) {
+		return false;
+	}
+
 	// Check the adjacent tiles.
 	for(const map_location& adj : get_adjacent_tiles(loc)) {
 		const unit *u = resources::gameboard->get_visible_unit(adj, viewing_team, see_all);
@@ -226,6 +232,21 @@ namespace {
 			return nodes[r] < nodes[l];
 		}
 	};
+
+	/**
+	 * State shared by the find_routes() calls made for side_reach.
+	 * All of these searches use the same current and viewing teams.
+	 */
+	struct findroute_batch {
+		/** Cost of entering each hex for the unit being searched. */
+		const std::vector<int>* costs;
+		/** What is known so far about each hex, see the flags below. */
+		std::vector<uint8_t> hex_state;
+		/** Receives the hexes reached, instead of the destinations. */
+		boost::dynamic_bitset<>* reach;
+
+		enum : uint8_t { ENEMY_KNOWN = 1, ENEMY = 2, ZOC_KNOWN = 4, ZOC = 8 };
+	};
 }
 
 /**
@@ -266,6 +287,9 @@ namespace {
  *                           cost itself, the second how many units already visited this hex
  * @param[in]  check_vision  If true, use vision check for teleports, that is, ignore
  *                           units potentially blocking the teleport exit
+ * @param[in,out] batch      If not nullptr, use its precomputed costs and remember
+ *                           where enemies and their zones of control are, then fill
+ *                           its reach bitset instead of destinations.
  */
 static void find_routes(
 		const map_location & origin, const movetype::terrain_costs & costs,
@@ -274,8 +298,11 @@ static void find_routes(
 		const unit * teleporter, const team * current_team,
 		const unit * skirmisher, const team * viewing_team,
 		const std::map<map_location, int> * jamming_map=nullptr,
-		std::vector<std::pair<int, int>> * full_cost_map=nullptr, bool check_vision=false)
+		std::vector<std::pair<int, int>> * full_cost_map=nullptr, bool check_vision=false,
+		findroute_batch * batch=nullptr)
 {
+	PERF_TIMER("pathfind::find_routes");
+
 	const gamemap& map = resources::gameboard->map();
 
 	const bool see_all =  viewing_team == nullptr;
@@ -375,7 +402,7 @@ static void find_routes(
 			next.prev = cur_hex;
 
 			// Calculate the cost of entering next_hex.
-			int cost = costs.cost(map[next_hex], slowed);
+			int cost = batch ? (*batch->costs)[next_index] : costs.cost(map[next_hex], slowed);
 			if ( jamming_map ) {
 				const std::map<map_location, int>::const_iterator jam_it =
 					jamming_map->find(next_hex);
@@ -400,18 +427,43 @@ static void find_routes(
 
 			if ( current_team ) {
 				// Account for enemy units.
-				const unit *v = resources::gameboard->get_visible_unit(next_hex, *viewing_team, see_all);
-				if ( v && current_team->is_enemy(v->side()) ) {
+				bool enemy_here;
+				if ( batch ) {
+					uint8_t& state = batch->hex_state[next_index];
+					if ( !(state & findroute_batch::ENEMY_KNOWN) ) {
+						const unit *v = resources::gameboard->get_visible_unit(next_hex, *viewing_team, see_all);
+						state |= findroute_batch::ENEMY_KNOWN;
+						if ( v && current_team->is_enemy(v->side()) )
+							state |= findroute_batch::ENEMY;
+					}
+					enemy_here = state & findroute_batch::ENEMY;
+				} else {
+					const unit *v = resources::gameboard->get_visible_unit(next_hex, *viewing_team, see_all);
+					enemy_here = v && current_team->is_enemy(v->side());
+				}
+				if ( enemy_here ) {
 					// Cannot enter enemy hexes.
 					if ( edges != nullptr )
 						edges->insert(next_hex);
 					continue;
 				}
 
-				if ( skirmisher  &&  next.moves_left > 0  &&
-				     enemy_zoc(*current_team, next_hex, *viewing_team, see_all)  &&
-				     !skirmisher->get_ability_bool("skirmisher", next_hex) ) {
-					next.moves_left = 0;
+				if ( skirmisher  &&  next.moves_left > 0 ) {
+					bool zoc_here;
+					if ( batch ) {
+						uint8_t& state = batch->hex_state[next_index];
+						if ( !(state & findroute_batch::ZOC_KNOWN) ) {
+							state |= findroute_batch::ZOC_KNOWN;
+							if ( enemy_zoc(*current_team, next_hex, *viewing_team, see_all) )
+								state |= findroute_batch::ZOC;
+						}
+						zoc_here = state & findroute_batch::ZOC;
+					} else {
+						zoc_here = enemy_zoc(*current_team, next_hex, *viewing_team, see_all);
+					}
+					if ( zoc_here && !skirmisher->get_ability_bool("skirmisher", next_hex) ) {
+						next.moves_left = 0;
+					}
 				}
 			}
 
@@ -455,6 +507,16 @@ static void find_routes(
 		return;
 	}
 
+	if ( batch ) {
+		for (int x = xmin; x <= xmax; ++x) {
+			for (int y = ymin; y <= ymax; ++y) {
+				if ( nodes[index(x,y)].search_num == search_counter )
+					batch->reach->set(index(x,y));
+			}
+		}
+		return;
+	}
+
 	// Build the routes for every map_location that we reached.
 	// The ordering must be compatible with map_location::operator<.
 	destinations.reserve(nb_dest);
@@ -554,6 +616,113 @@ paths::paths(const unit& u, bool force_ignore_zoc,
 	}
 }
 
+/**
+ * Computes the reach of several units of one side.
+ *
+ * Units whose movement costs are the same on every terrain of the map share
+ * a single table of hex costs, and all of the searches share what has been
+ * found out about enemy units and zones of control.
+ */
+side_reach::side_reach(int side, const team& viewing_team, int additional_turns,
+		bool see_all, const std::function<bool(const unit&)>& filter)
+	: width_(resources::gameboard->map().w())
+	, reach_()
+{
+	const gamemap& map = resources::gameboard->map();
+	const std::size_t hexes = static_cast<std::size_t>(map.w()) * map.h();
+
+	const team* current_team;
+	try {
+		current_team = &resources::gameboard->get_team(side);
+	} catch(const std::out_of_range&) {
+		// Invalid side.
+		return;
+	}
+
+	// Number the terrains of the map, so each group of units only needs one
+	// cost lookup per terrain.
+	std::vector<t_translation::terrain_code> terrains;
+	std::vector<std::size_t> terrain_index(hexes);
+	for(std::size_t i = 0; i != hexes; ++i) {
+		const t_translation::terrain_code terrain = map[map_location(i % map.w(), i / map.w())];
+		auto it = std::find(terrains.begin(), terrains.end(), terrain);
+		terrain_index[i] = it - terrains.begin();
+		if(it == terrains.end()) {
+			terrains.push_back(terrain);
+		}
+	}
+
+	// Hex costs, keyed by the costs of each terrain.
+	std::map<std::vector<int>, std::vector<int>> cost_tables;
+
+	findroute_batch batch { nullptr, std::vector<uint8_t>(hexes, 0), nullptr };
+
+	for(const unit& u : resources::gameboard->units()) {
+		if(u.side() != side || (filter && !filter(u))) {
+			continue;
+		}
+
+		const movetype::terrain_costs& costs = u.movement_type().get_movement();
+		const bool slowed = u.get_state(unit::STATE_SLOWED);
+
+		std::vector<int> terrain_costs;
+		terrain_costs.reserve(terrains.size());
+		for(const t_translation::terrain_code& terrain : terrains) {
+			terrain_costs.push_back(costs.cost(terrain, slowed));
+		}
+
+		std::vector<int>& hex_costs = cost_tables[terrain_costs];
+		if(hex_costs.empty()) {
+			hex_costs.resize(hexes);
+			for(std::size_t i = 0; i != hexes; ++i) {
+				hex_costs[i] = terrain_costs[terrain_index[i]];
+			}
+		}
+
+		boost::dynamic_bitset<>& reach = reach_[u.get_location()];
+		reach.resize(hexes);
+
+		batch.costs = &hex_costs;
+		batch.reach = &reach;
+
+		paths::dest_vect unused;
+		find_routes(
+			u.get_location(),
+			costs,
+			slowed,
+			u.movement_left(),
+			u.total_movement(),
+			additional_turns,
+			unused,
+			nullptr,
+			&u,
+			current_team,
+			&u,
+			see_all ? nullptr : &viewing_team,
+			nullptr,
+			nullptr,
+			false,
+			&batch
+		);
+	}
+}
+
+const boost::dynamic_bitset<>* side_reach::find(const map_location& unit_loc) const
+{
+	auto it = reach_.find(unit_loc);
+	return it != reach_.end() ? &it->second : nullptr;
+}
+
+bool side_reach::can_reach(const map_location& unit_loc, const map_location& dst) const
+{
+	const boost::dynamic_bitset<>* reach = find(unit_loc);
+	if(!reach || !resources::gameboard->map().on_board(dst)) {
+		return false;
+	}
+
+	return reach->test(dst.x + static_cast<std::size_t>(dst.y) * width_);
+}
+
 /**
  * Virtual destructor to support child classes.
  */
@@ -729,10 +898,38 @@ marked_route mark_route(const plain_route &rt, bool update_move_cost)
 	return res;
 }
 
+terrain_cost_grid::terrain_cost_grid(const movetype::terrain_costs& costs, bool slowed, const gamemap& map)
+	: costs_(costs)
+	, slowed_(slowed)
+	, map_(map)
+	, grid_(static_cast<std::size_t>(map.w()) * map.h(), 0)
+{
+}
+
+int terrain_cost_grid::operator()(const map_location& loc) const
+{
+	assert(map_.on_board(loc));
+
+	uint8_t& cached = grid_[loc.x + static_cast<std::size_t>(loc.y) * map_.w()];
+	if(cached != 0) {
+		return cached;
+	}
+
+	// Valid costs are at least 1 and at most twice UNREACHABLE, anything
+	// else is left for the caller to complain about.
+	const int cost = costs_.cost(map_[loc], slowed_);
+	if(cost >= 1 && cost <= 255) {
+		cached = static_cast<uint8_t>(cost);
+	}
+
+	return cost;
+}
+
 shortest_path_calculator::shortest_path_calculator(const unit& u, const team& t,
 		const std::vector<team>& teams, const gamemap& map,
 		bool ignore_unit, bool ignore_defense, bool see_all)
 	: unit_(u), viewing_team_(t), teams_(teams), map_(map),
+	  movement_costs_(u.movement_type().get_movement(), u.get_state(unit::STATE_SLOWED), map),
 	  movement_left_(unit_.movement_left()),
 	  total_movement_(unit_.total_movement()),
 	  ignore_unit_(ignore_unit), ignore_defense_(ignore_defense),
@@ -749,7 +946,7 @@ double shortest_path_calculator::cost(const map_location& loc, const double so_f
 		return getNoPathValue();
 
 	const t_translation::terrain_code terrain = map_[loc];
-	const int terrain_cost = unit_.movement_cost(terrain);
+	const int terrain_cost = movement_costs_(loc);
 	// Pathfinding heuristic: the cost must be at least 1
 	VALIDATE(terrain_cost >= 1, _("Terrain with a movement cost less than 1 encountered."));
 
@@ -822,7 +1019,8 @@ double shortest_path_calculator::cost(const map_location& loc, const double so_f
 
 move_type_path_calculator::move_type_path_calculator(const movetype& mt, int movement_left, int total_movement, const team& t, const gamemap& map)
 	: movement_type_(mt), movement_left_(movement_left),
-	  total_movement_(total_movement), viewing_team_(t), map_(map)
+	  total_movement_(total_movement), viewing_team_(t), map_(map),
+	  movement_costs_(mt.get_movement(), false, map)
 {}
 
 // This is an simplified version of shortest_path_calculator (see above for explanation)
@@ -832,8 +1030,7 @@ double move_type_path_calculator::cost(const map_location& loc, const double so_
 	if (viewing_team_.shrouded(loc))
 		return getNoPathValue();
 
-	const t_translation::terrain_code terrain = map_[loc];
-	const int terrain_cost = movement_type_.movement_cost(terrain);
+	const int terrain_cost = movement_costs_(loc);
 
 	if (total_movement_ < terrain_cost)
 		return getNoPathValue();
@@ -28,9 +28,16 @@ class game_board;
 #include "map/location.hpp"
 #include "movetype.hpp"
 
+#include <boost/dynamic_bitset.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
 #include <vector>
 #include <map>
 #include <set>
+#include <typeindex>
 
 namespace pathfind {
 
@@ -101,6 +108,38 @@ struct paths
 	dest_vect destinations;
 };
 
+/**
+ * Where each unit of a side can move, computed in one pass.
+ *
+ * Gives the same hexes as a paths object built for each unit with ZoC and
+ * teleports taken into account, but only keeps one bit per hex.
+ */
+class side_reach
+{
+public:
+	/**
+	 * @param side              The side whose units are considered.
+	 * @param viewing_team      Whose vision is used to detect enemy units. Ignored if @a see_all is set.
+	 * @param additional_turns  The number of turns to account for, in addition to the current.
+	 * @param see_all           Set to true to remove unit visibility from consideration.
+	 * @param filter            If set, only the units it accepts are considered.
+	 */
+	side_reach(int side, const team& viewing_team, int additional_turns = 0,
+		bool see_all = false, const std::function<bool(const unit&)>& filter = nullptr);
+
+	/**
+	 * Returns the hexes which the unit at @a unit_loc can reach, indexed by
+	 * x + y * map width, or nullptr if that unit wasn't considered.
+	 */
+	const boost::dynamic_bitset<>* find(const map_location& unit_loc) const;
+
+	bool can_reach(const map_location& unit_loc, const map_location& dst) const;
+
+private:
+	int width_;
+	std::map<map_location, boost::dynamic_bitset<>> reach_;
+};
+
 /**
  * A refinement of paths for use when calculating vision.
  */
@@ -190,17 +229,125 @@ struct marked_route
 	mark_map marks;
 };
 
+/**
+ * Scratch memory reused by successive a_star_search() calls, so that a search
+ * doesn't have to allocate a node for every hex of the map.
+ *
+ * A workspace may only be used by one search at a time. Searches running in
+ * parallel each need their own.
+ */
+class astar_workspace
+{
+public:
+	astar_workspace();
+	~astar_workspace();
+
+	astar_workspace(const astar_workspace&) = delete;
+	astar_workspace& operator=(const astar_workspace&) = delete;
+
+private:
+	friend plain_route a_star_search(const map_location& src, const map_location& dst,
+		double stop_at, const cost_calculator& costCalculator,
+		const std::size_t parWidth, const std::size_t parHeight,
+		astar_workspace& workspace,
+		const teleport_map* teleports, bool border);
+
+	struct data;
+	std::unique_ptr<data> data_;
+};
+
+/** Runs a search using a workspace private to the calling thread. */
+plain_route a_star_search(const map_location& src, const map_location& dst,
+		double stop_at, const cost_calculator& costCalculator,
+		const std::size_t parWidth, const std::size_t parHeight,
+		const teleport_map* teleports = nullptr, bool border = false);
+
+/** Runs a search using the given @a workspace. This is reentrant. */
 plain_route a_star_search(const map_location& src, const map_location& dst,
 		double stop_at, const cost_calculator& costCalculator,
 		const std::size_t parWidth, const std::size_t parHeight,
+		astar_workspace& workspace,
 		const teleport_map* teleports = nullptr, bool border = false);
 
+/**
+ * Least recently used cache of a_star_search() results.
+ *
+ * The cache knows nothing about what a cost calculator depends on. Searches
+ * are told apart by the type of calculator and a key chosen by the caller
+ * (such as the underlying id of the unit being moved), and the owner must
+ * clear() the cache whenever the units, terrain, fog or shroud seen by its
+ * calculators change.
+ */
+class route_cache
+{
+public:
+	explicit route_cache(std::size_t max_size = 512);
+
+	/**
+	 * Returns the route a_star_search() would find with these arguments,
+	 * running the search only if it isn't cached yet.
+	 *
+	 * @param key                 Identifies @a calc and @a teleports among
+	 *                            the searches with the same type of
+	 *                            calculator stored in this cache.
+	 */
+	plain_route search(std::size_t key, const map_location& src, const map_location& dst,
+		double stop_at, const cost_calculator& calc,
+		const std::size_t width, const std::size_t height,
+		const teleport_map* teleports = nullptr, bool border = false);
+
+	void clear();
+
+	std::size_t size() const { return index_.size(); }
+
+private:
+	struct entry_key
+	{
+		std::type_index calc_type;
+		std::size_t key;
+		map_location src, dst;
+		double stop_at;
+
+		bool operator<(const entry_key& o) const;
+	};
+
+	typedef std::list<std::pair<entry_key, plain_route>> entry_list;
+
+	/** Most recently used first. */
+	entry_list entries_;
+	std::map<entry_key, entry_list::iterator> index_;
+	std::size_t max_size_;
+};
+
 /**
  * Add marks on a route @a rt assuming that the unit located at the first hex of
  * rt travels along it.
  */
 marked_route mark_route(const plain_route &rt, bool update_move_cost = false);
 
+/**
+ * The movement costs of a movetype for each hex of a map.
+ *
+ * Costs are looked up from the movetype the first time a hex is queried, then
+ * read from a flat array. The grid must not outlive a terrain change, so it is
+ * meant to be owned by short-lived objects such as path calculators.
+ */
+class terrain_cost_grid
+{
+public:
+	terrain_cost_grid(const movetype::terrain_costs& costs, bool slowed, const gamemap& map);
+
+	/** Returns the cost of entering @a loc, which must be on the map. */
+	int operator()(const map_location& loc) const;
+
+private:
+	const movetype::terrain_costs& costs_;
+	const bool slowed_;
+	const gamemap& map_;
+	/** The cost of each hex, or 0 if it hasn't been looked up yet. */
+	mutable std::vector<uint8_t> grid_;
+};
+
 struct shortest_path_calculator : cost_calculator
 {
 	shortest_path_calculator(const unit& u, const team& t,
@@ -214,6 +361,7 @@ private:
 	const team& viewing_team_;
 	const std::vector<team>& teams_;
 	const gamemap& map_;
+	const terrain_cost_grid movement_costs_;
 	const int movement_left_;
 	const int total_movement_;
 	bool const ignore_unit_;
@@ -232,6 +380,7 @@ private:
 	const int total_movement_;
 	const team& viewing_team_;
 	const gamemap& map_;
+	const terrain_cost_grid movement_costs_;
 };
 
 /**
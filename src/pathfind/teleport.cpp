@@ -27,6 +27,8 @@
 #include "units/filter.hpp"
 #include "units/map.hpp"
 
+#include <deque>
+
 static lg::log_domain log_engine("engine");
 #define ERR_PF LOG_STREAM(err, log_engine)
 
@@ -164,7 +166,7 @@ config teleport_group::to_config() const {
 }
 
 teleport_map::teleport_map(
-		  const std::vector<teleport_group>& groups
+		  const std::vector<const teleport_group*>& groups
 		, const unit& unit
 		, const team &viewing_team
 		, const bool see_all
@@ -175,15 +177,14 @@ teleport_map::teleport_map(
 	, targets_()
 {
 
-	for (const teleport_group& group : groups) {
-
-		teleport_pair locations;
+	for (const teleport_group* group_ptr : groups) {
+		const teleport_group& group = *group_ptr;
 
 		if (check_vision && !group.allow_vision()) {
 			continue;
 		}
 
-		group.get_teleport_pair(locations, unit, ignore_units);
+		teleport_pair locations = resources::tunnels->get_teleport_pair(group, unit, ignore_units);
 		if (!see_all && !group.always_visible() && viewing_team.is_enemy(unit.side())) {
 			teleport_pair filter_locs;
 			for (const map_location &loc : locations.first) {
@@ -271,23 +272,28 @@ const teleport_map get_teleport_locations(const unit &u,
 	const team &viewing_team,
 	bool see_all, bool ignore_units, bool check_vision)
 {
-	std::vector<teleport_group> groups;
+	// Without the cache, the groups of the abilities only live for this call.
+	std::deque<teleport_group> ability_groups;
+	std::vector<const teleport_group*> groups;
 
 	for (const unit_ability & teleport : u.get_abilities("teleport")) {
-		const int tunnel_count = (teleport.ability_cfg)->child_count("tunnel");
-		for(int i = 0; i < tunnel_count; ++i) {
-			config teleport_group_cfg = (teleport.ability_cfg)->child("tunnel", i);
-			groups.emplace_back(vconfig(teleport_group_cfg, true), false);
+		for (const config& tunnel : teleport.ability_cfg->child_range("tunnel")) {
+			const teleport_group* group = resources::tunnels->cached_ability_group(tunnel);
+			if (!group) {
+				group = &ability_groups.emplace_back(vconfig(tunnel, true), false);
+			}
+			groups.push_back(group);
 		}
 	}
 
-	const std::vector<teleport_group>& global_groups = resources::tunnels->get();
-	groups.insert(groups.end(), global_groups.begin(), global_groups.end());
+	for (const teleport_group& group : resources::tunnels->get()) {
+		groups.push_back(&group);
+	}
 
 	return teleport_map(groups, u, viewing_team, see_all, ignore_units, check_vision);
 }
 
-manager::manager(const config &cfg) : tunnels_(), id_(cfg["next_teleport_group_id"].to_int(0)) {
+manager::manager(const config &cfg) : tunnels_(), id_(cfg["next_teleport_group_id"].to_int(0)), cache_users_(0), ability_groups_(), pairs_() {
 	const int tunnel_count = cfg.child_count("tunnel");
 	for(int i = 0; i < tunnel_count; ++i) {
 		const config& t = cfg.child("tunnel", i);
@@ -302,10 +308,12 @@ manager::manager(const config &cfg) : tunnels_(), id_(cfg["next_teleport_group_i
 }
 
 void manager::add(const teleport_group &group) {
+	clear_cache();
 	tunnels_.push_back(group);
 }
 
 void manager::remove(const std::string &id) {
+	clear_cache();
 	std::vector<teleport_group>::iterator t = tunnels_.begin();
 	for(;t != tunnels_.end();) {
 		if (t->get_teleport_id() == id || t->get_teleport_id() == id + reversed_suffix) {
@@ -336,5 +344,58 @@ std::string manager::next_unique_id() {
 	return std::to_string(++id_);
 }
 
+const teleport_group* manager::cached_ability_group(const config& tunnel)
+{
+	if (cache_users_ == 0) {
+		return nullptr;
+	}
+
+	auto i = ability_groups_.find(&tunnel);
+	if (i == ability_groups_.end()) {
+		i = ability_groups_.emplace(&tunnel, teleport_group(vconfig(tunnel, true), false)).first;
+	}
+
+	return &i->second;
+}
+
+teleport_pair manager::get_teleport_pair(const teleport_group& group, const unit& u, const bool ignore_units)
+{
+	if (cache_users_ == 0) {
+		teleport_pair res;
+		group.get_teleport_pair(res, u, ignore_units);
+		return res;
+	}
+
+	const auto key = std::make_tuple(&group, u.underlying_id(), ignore_units);
+	auto i = pairs_.find(key);
+	if (i == pairs_.end()) {
+		teleport_pair res;
+		group.get_teleport_pair(res, u, ignore_units);
+		i = pairs_.emplace(key, std::move(res)).first;
+	}
+
+	return i->second;
+}
+
+void manager::clear_cache()
+{
+	// The pairs refer to the groups, so they go first.
+	pairs_.clear();
+	ability_groups_.clear();
+}
+
+manager::cache_scope::cache_scope(manager& m)
+	: manager_(m)
+{
+	++manager_.cache_users_;
+}
+
+manager::cache_scope::~cache_scope()
+{
+	if (--manager_.cache_users_ == 0) {
+		manager_.clear_cache();
+	}
+}
+
 
 }//namespace pathfind
@@ -18,6 +18,8 @@
 #include "config.hpp"
 #include "map/location.hpp"
 
+#include <tuple>
+
 class team;
 class unit;
 class vconfig;
@@ -103,7 +105,7 @@ public:
 	 * @param check_vision
 	 */
 	teleport_map(
-			  const std::vector<teleport_group>& teleport_groups
+			  const std::vector<const teleport_group*>& teleport_groups
 			, const unit& u
 			, const team &viewing_team
 			, const bool see_all
@@ -179,9 +181,58 @@ public:
 	 * @returns the next free unique id for a teleport group
 	 */
 	std::string next_unique_id();
+
+	/**
+	 * The group for the [tunnel] tag @a tunnel of a teleport ability, or
+	 * nullptr when the cache is disabled, see cache_scope.
+	 */
+	const teleport_group* cached_ability_group(const config& tunnel);
+
+	/**
+	 * The locations of @a group for @a u, see teleport_group::get_teleport_pair.
+	 *
+	 * While the cache is enabled, the result is only computed once per
+	 * group, unit and @a ignore_units.
+	 */
+	teleport_pair get_teleport_pair(const teleport_group& group, const unit& u, bool ignore_units);
+
+	/**
+	 * Keeps the results of cached_ability_group and get_teleport_pair until
+	 * clear_cache is called.
+	 *
+	 * The filters of the tunnels can look at nearly everything in the game,
+	 * so whoever enables this must call clear_cache whenever the game state
+	 * changes. The AI does so for its turn, on every gamestate change it
+	 * raises.
+	 */
+	class cache_scope
+	{
+	public:
+		explicit cache_scope(manager& m);
+		~cache_scope();
+
+		cache_scope(const cache_scope&) = delete;
+		cache_scope& operator=(const cache_scope&) = delete;
+
+	private:
+		manager& manager_;
+	};
+
+	/** Forgets all cached teleport pairs, see cache_scope. */
+	void clear_cache();
+
 private:
 	std::vector<teleport_group> tunnels_;
 	int id_;
+
+	/** The number of cache_scope objects alive. */
+	int cache_users_;
+
+	/** The groups created from the [tunnel] tags of abilities, by tag. */
+	std::map<const config*, teleport_group> ability_groups_;
+
+	/** Results of get_teleport_pair, by group, unit underlying id and ignore_units. */
+	std::map<std::tuple<const teleport_group*, std::size_t, bool>, teleport_pair> pairs_;
 };
 
 }
@@ -23,6 +23,9 @@
 
 #include "map/map.hpp"
 
+#include <algorithm>
+#include <cstdint>
+
 
 /**
  * Function that will add to @a result all locations exactly @a radius tiles
@@ -239,15 +242,61 @@ void get_tiles_radius(const gamemap& map, const std::vector<map_location>& locs,
                       std::size_t radius, std::set<map_location> &result,
                       bool with_border, const xy_pred& pred)
 {
-	typedef std::set<map_location> location_set;
-	location_set not_visited(locs.begin(), locs.end());
-
-	get_tiles_radius(std::move(not_visited), radius, result,
-		[&](const map_location& l) {
-			return with_border ? map.on_board_with_border(l) : map.on_board(l);
-		},
-		[&](const map_location& l) {
-			return pred(l);
+	// The state of the hexes is kept in a grid covering the board, so the
+	// search does no set lookups and tests each hex against pred only once.
+	enum : uint8_t { UNSEEN, REACHED, FILTERED_OUT };
+
+	const int border = with_border ? map.border_size() : 0;
+	const int width = map.w() + 2 * border;
+	const int height = map.h() + 2 * border;
+	std::vector<uint8_t> state(static_cast<std::size_t>(std::max(width, 0)) * std::max(height, 0), UNSEEN);
+
+	// The index of @a loc in state, or -1 if it is off the board.
+	const auto index = [&](const map_location& loc) {
+		const int x = loc.x + border;
+		const int y = loc.y + border;
+		return x >= 0 && y >= 0 && x < width && y < height ? y * width + x : -1;
+	};
+
+	std::vector<map_location> frontier, next;
+	for(const map_location& loc : locs) {
+		const int i = index(loc);
+		if(i < 0 || state[i] == UNSEEN) {
+			if(i >= 0) {
+				state[i] = REACHED;
+			}
+			frontier.push_back(loc);
+		}
+	}
+
+	// Other hexes already in result are not expanded from.
+	for(const map_location& loc : result) {
+		if(const int i = index(loc); i >= 0) {
+			state[i] = REACHED;
+		}
+	}
+
+	result.insert(locs.begin(), locs.end());
+
+	for( ; radius != 0  &&  !frontier.empty(); --radius ) {
+		for(const map_location& cur : frontier) {
+			for(const map_location& loc : get_adjacent_tiles(cur)) {
+				const int i = index(loc);
+				if(i < 0 || state[i] != UNSEEN) {
+					continue;
+				}
+
+				if(pred(loc)) {
+					state[i] = REACHED;
+					next.push_back(loc);
+				} else {
+					state[i] = FILTERED_OUT;
+				}
+			}
 		}
-	);
+
+		result.insert(next.begin(), next.end());
+		frontier.swap(next);
+		next.clear();
+	}
 }
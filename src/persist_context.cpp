@@ -21,6 +21,14 @@
 #include "serialization/binary_or_text.hpp"
 #include "serialization/parser.hpp"
 
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <thread>
+
 config pack_scalar(const std::string &name, const t_string &val)
 {
 	config cfg;
@@ -32,23 +40,177 @@ static std::string get_persist_cfg_name(const std::string &name_space) {
 	return (filesystem::get_dir(filesystem::get_user_data_dir() + "/persist/") + name_space + ".cfg");
 }
 
+namespace {
+/**
+ * Writes namespace files on a worker thread.
+ *
+ * Only the latest content of each file is kept, so a burst of changes to the
+ * same namespace results in one write. The worker waits a little after a
+ * change before writing, for further changes to join it. Each file is first
+ * written with a ".part" suffix and then renamed over the old one.
+ */
+class persist_file_writer
+{
+public:
+	persist_file_writer()
+		: pending_()
+		, busy_(false)
+		, stopped_(false)
+		, mutex_()
+		, cond_()
+		, worker_()
+	{
+	}
+
+	/** Changes queued before the game exits are still written. */
+	~persist_file_writer()
+	{
+		{
+			std::scoped_lock lock(mutex_);
+			stopped_ = true;
+		}
+
+		cond_.notify_all();
+		if(worker_.joinable()) {
+			worker_.join();
+		}
+	}
+
+	/** Queues the new content of a file, or its deletion if @a data is empty. */
+	void add(const std::string& filename, std::optional<std::string> data)
+	{
+		{
+			std::scoped_lock lock(mutex_);
+			pending_.insert_or_assign(filename, std::move(data));
+		}
+
+		if(!worker_.joinable()) {
+			worker_ = std::thread([this]() { run(); });
+		}
+
+		cond_.notify_all();
+	}
+
+	/** Waits until everything queued is written. */
+	void flush()
+	{
+		std::unique_lock lock(mutex_);
+		if(pending_.empty() && !busy_) {
+			return;
+		}
+
+		flush_now_ = true;
+		cond_.notify_all();
+		cond_.wait(lock, [this]() { return pending_.empty() && !busy_; });
+		flush_now_ = false;
+	}
+
+private:
+	void run()
+	{
+		static const auto debounce = std::chrono::milliseconds(250);
+
+		std::unique_lock lock(mutex_);
+
+		while(true) {
+			cond_.wait(lock, [this]() { return !pending_.empty() || stopped_; });
+
+			if(pending_.empty()) {
+				return;
+			}
+
+			if(!stopped_ && !flush_now_) {
+				cond_.wait_for(lock, debounce, [this]() { return stopped_ || flush_now_; });
+			}
+
+			auto node = pending_.extract(pending_.begin());
+			busy_ = true;
+
+			lock.unlock();
+			write(node.key(), node.mapped());
+			lock.lock();
+
+			busy_ = false;
+			cond_.notify_all();
+		}
+	}
+
+	static void write(const std::string& filename, const std::optional<std::string>& data)
+	{
+		if(!data) {
+			if(filesystem::file_exists(filename) && !filesystem::delete_file(filename)) {
+				ERR_PERSist << "could not delete " << filename;
+			}
+			return;
+		}
+
+		const std::string part = filename + ".part";
+
+		try {
+			filesystem::scoped_ostream os = filesystem::ostream_file(part);
+			*os << *data;
+			if(!os->good()) {
+				ERR_PERSist << "could not write " << part;
+				return;
+			}
+		} catch(const filesystem::io_exception& e) {
+			ERR_PERSist << "could not write " << part << ": " << e.what();
+			return;
+		}
+
+		if(!filesystem::rename_file(part, filename)) {
+			ERR_PERSist << "could not replace " << filename;
+			filesystem::delete_file(part);
+		}
+	}
+
+	/** New content of each file not written yet, by file name. */
+	std::map<std::string, std::optional<std::string>> pending_;
+
+	/** Whether the worker is writing a file that's no longer in pending_. */
+	bool busy_;
+
+	bool stopped_;
+
+	/** Set while flush() waits, so the worker doesn't wait for more changes. */
+	bool flush_now_ = false;
+
+	std::mutex mutex_;
+	std::condition_variable cond_;
+	std::thread worker_;
+};
+
+/** Constructed on first use, so it's destroyed before the filesystem and logging statics it uses. */
+persist_file_writer& file_writer()
+{
+	static persist_file_writer writer;
+	return writer;
+}
+} // end anon namespace
+
 void persist_file_context::load()
 {
 	std::string cfg_name = get_persist_cfg_name(namespace_.root_);
+
+	// The file may still have changes of an earlier game on their way to disk.
+	file_writer().flush();
+
 	if (filesystem::file_exists(cfg_name) && !filesystem::is_directory(cfg_name)) {
 		filesystem::scoped_istream file_stream = filesystem::istream_file(cfg_name);
 		if (!(file_stream->fail())) {
 			try {
-				read(cfg_,*file_stream);
+				read(disk_cfg_,*file_stream);
 			} catch (const config::error &err) {
 				LOG_PERSIST << err.message;
 			}
 		}
 	}
+	cfg_ = disk_cfg_;
 }
 
 persist_file_context::persist_file_context(const std::string &name_space)
 	: persist_context(name_space)
+	, disk_cfg_()
 {
 	load();
 }
@@ -62,7 +224,7 @@ bool persist_file_context::clear_var(const std::string &global, bool immediate)
 		config *node = get_node(bak, namespace_);
 		if (node)
 			bactive = node->child_or_add("variables");
-		load();
+		cfg_ = disk_cfg_;
 	}
 	config *active = get_node(cfg_, namespace_);
 	if (active == nullptr)
@@ -177,28 +339,27 @@ config persist_file_context::get_var(const std::string &global) const
 	return ret;
 }
 bool persist_file_context::save_context() {
-	bool success = false;
-
 	std::string cfg_name = get_persist_cfg_name(namespace_.root_);
-	if (!cfg_name.empty()) {
-		if (cfg_.empty()) {
-			success = filesystem::delete_file(cfg_name);
-		} else {
-			filesystem::scoped_ostream out = filesystem::ostream_file(cfg_name);
-			if (!out->fail())
-			{
-				config_writer writer(*out,false);
-				try {
-					writer.write(cfg_);
-					success = true;
-				} catch(config::error &err) {
-					LOG_PERSIST << err.message;
-					success = false;
-				}
-			}
+	if (cfg_name.empty())
+		return false;
+
+	// Only the serialization happens here, the file is written in the background.
+	if (cfg_.empty()) {
+		file_writer().add(cfg_name, std::nullopt);
+	} else {
+		std::ostringstream out;
+		config_writer writer(out,false);
+		try {
+			writer.write(cfg_);
+		} catch(config::error &err) {
+			LOG_PERSIST << err.message;
+			return false;
 		}
+		file_writer().add(cfg_name, out.str());
 	}
-	return success;
+
+	disk_cfg_ = cfg_;
+	return true;
 }
 bool persist_file_context::set_var(const std::string &global,const config &val, bool immediate)
 {
@@ -207,7 +368,7 @@ bool persist_file_context::set_var(const std::string &global,const config &val,
 	if (immediate) {
 		bak = cfg_;
 		bactive = get_node(bak, namespace_, true)->child_or_add("variables");
-		load();
+		cfg_ = disk_cfg_;
 	}
 
 	config *active = get_node(cfg_, namespace_, true);
@@ -163,6 +163,12 @@ public:
 
 class persist_file_context : public persist_context {
 private:
+	/**
+	 * The namespace as last read from or queued for writing to its file,
+	 * without the changes of a running transaction.
+	 */
+	config disk_cfg_;
+
 	void load();
 	void init();
 	bool save_context();
@@ -189,7 +195,7 @@ public:
 	bool cancel_transaction () {
 		if (!in_transaction_)
 			return false;
-		load();
+		cfg_ = disk_cfg_;
 		in_transaction_ = false;
 		return true;
 	}
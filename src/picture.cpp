@@ -24,6 +24,7 @@
 #include "display.hpp"
 #include "filesystem.hpp"
 #include "game_config.hpp"
+#include "game_version.hpp"
 #include "image_modifications.hpp"
 #include "log.hpp"
 #include "preferences/general.hpp"
@@ -40,7 +41,13 @@
 #include <boost/functional/hash_fwd.hpp>
 
 #include <array>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <list>
+#include <mutex>
 #include <set>
+#include <thread>
 
 static lg::log_domain log_image("image");
 #define ERR_IMG LOG_STREAM(err, log_image)
@@ -59,17 +66,27 @@ struct cache_item
 	cache_item()
 		: item()
 		, loaded(false)
+		, size(0)
+		, lru_position()
 	{
 	}
 
 	cache_item(const T& item)
 		: item(item)
 		, loaded(true)
+		, size(0)
+		, lru_position()
 	{
 	}
 
 	T item;
 	bool loaded;
+
+	/** Approximate memory used by the item, in bytes. */
+	std::size_t size;
+
+	/** Position of the item in its cache's LRU list. */
+	std::list<int>::iterator lru_position;
 };
 
 namespace std
@@ -100,12 +117,65 @@ struct hash<image::locator::value>
 
 namespace image
 {
+namespace
+{
+/** Default size limit of each cache: 256 MiB. */
+std::size_t cache_size_limit = 256 * 1024 * 1024;
+
+std::size_t cache_size_of(const surface& surf)
+{
+	return surf ? static_cast<std::size_t>(surf->h) * surf->pitch : 0;
+}
+
+std::size_t cache_size_of(const texture& tex)
+{
+	if(!tex) {
+		return 0;
+	}
+
+	// Textures sharing an atlas page only account for their own slot.
+	const point size = tex.src() ? point{tex.src()->w, tex.src()->h} : tex.get_raw_size();
+	return static_cast<std::size_t>(size.x) * size.y * 4;
+}
+
+std::size_t cache_size_of(bool)
+{
+	// Never worth evicting.
+	return 0;
+}
+
+template<typename K, typename V>
+std::size_t cache_size_of(const std::map<K, V>& variants)
+{
+	std::size_t res = 0;
+	for(const auto& [key, value] : variants) {
+		res += sizeof(key) + cache_size_of(value);
+	}
+
+	return res;
+}
+
+} // end anon namespace
+
+/**
+ * Cache of images (or image properties), indexed by locator.
+ *
+ * The cache keeps track of the approximate memory used by its items, and
+ * evicts the least recently used ones once that goes past the limit set by
+ * set_cache_size_limit().
+ */
 template<typename T>
 class cache_type
 {
 public:
 	cache_type()
 		: content_()
+		, lru_()
+		, size_(0)
+		, modified_(-1)
+		, hits_(0)
+		, misses_(0)
+		, evictions_(0)
 	{
 	}
 
@@ -116,40 +186,142 @@ public:
 		return content_[index];
 	}
 
+	/** Checks whether an item is cached, counting the lookup as a hit or a miss. */
+	bool contains(int index)
+	{
+		const bool loaded = get_element(index).loaded;
+		++(loaded ? hits_ : misses_);
+		return loaded;
+	}
+
+	/** Returns an item, marking it as the most recently used one. */
+	const T& get(int index)
+	{
+		account_modified();
+
+		cache_item<T>& elt = get_element(index);
+		if(elt.loaded) {
+			lru_.splice(lru_.begin(), lru_, elt.lru_position);
+		}
+
+		return elt.item;
+	}
+
+	/**
+	 * Returns an item for in-place modification.
+	 * Its size is accounted for again on the next access to the cache.
+	 */
+	T& access(int index)
+	{
+		get(index);
+		modified_ = index;
+		return get_element(index).item;
+	}
+
+	void set(int index, const T& data)
+	{
+		account_modified();
+
+		cache_item<T>& elt = get_element(index);
+		if(elt.loaded) {
+			size_ -= elt.size;
+			lru_.erase(elt.lru_position);
+		}
+
+		elt = cache_item<T>(data);
+		elt.size = cache_size_of(data);
+		size_ += elt.size;
+
+		lru_.push_front(index);
+		elt.lru_position = lru_.begin();
+
+		evict();
+	}
+
 	void flush()
 	{
 		content_.clear();
+		lru_.clear();
+		size_ = 0;
+		modified_ = -1;
 	}
 
+	std::size_t size() const { return size_; }
+	unsigned hits() const { return hits_; }
+	unsigned misses() const { return misses_; }
+	unsigned evictions() const { return evictions_; }
+
 private:
+	void account_modified()
+	{
+		if(modified_ < 0) {
+			return;
+		}
+
+		cache_item<T>& elt = get_element(modified_);
+		modified_ = -1;
+
+		if(elt.loaded) {
+			size_ -= elt.size;
+			elt.size = cache_size_of(elt.item);
+			size_ += elt.size;
+			evict();
+		}
+	}
+
+	/** Drops the least recently used items until the cache fits its limit, always keeping the newest one. */
+	void evict()
+	{
+		while(cache_size_limit != 0 && size_ > cache_size_limit && lru_.size() > 1) {
+			cache_item<T>& elt = content_[lru_.back()];
+			lru_.pop_back();
+
+			size_ -= elt.size;
+			elt = cache_item<T>();
+			++evictions_;
+		}
+	}
+
 	std::vector<cache_item<T>> content_;
+
+	/** Indices of the loaded items, most recently used first. */
+	std::list<int> lru_;
+
+	std::size_t size_;
+
+	/** Index of the item last returned by access(), or -1. */
+	int modified_;
+
+	unsigned hits_;
+	unsigned misses_;
+	unsigned evictions_;
 };
 
 template<typename T>
 bool locator::in_cache(cache_type<T>& cache) const
 {
-	return index_ < 0 ? false : cache.get_element(index_).loaded;
+	return index_ < 0 ? false : cache.contains(index_);
 }
 
 template<typename T>
 const T& locator::locate_in_cache(cache_type<T>& cache) const
 {
 	static T dummy;
-	return index_ < 0 ? dummy : cache.get_element(index_).item;
+	return index_ < 0 ? dummy : cache.get(index_);
 }
 
 template<typename T>
 T& locator::access_in_cache(cache_type<T>& cache) const
 {
 	static T dummy;
-	return index_ < 0 ? dummy : cache.get_element(index_).item;
+	return index_ < 0 ? dummy : cache.access(index_);
 }
 
 template<typename T>
 void locator::add_to_cache(cache_type<T>& cache, const T& data) const
 {
 	if(index_ >= 0) {
-		cache.get_element(index_) = cache_item<T>(data);
+		cache.set(index_, data);
 	}
 }
 
@@ -157,6 +329,16 @@ namespace
 {
 image::locator::locator_finder_t locator_finder;
 
+/**
+ * Locators constructed from a single path string, by that string.
+ *
+ * Finding the string here skips splitting it into file and modifications
+ * and looking the parts up in locator_finder. The keys point into
+ * interned_paths, whose elements never move.
+ */
+std::unordered_map<std::string_view, image::locator> locators_by_path;
+std::deque<std::string> interned_paths;
+
 /** Definition of all image maps */
 std::array<surface_cache, NUM_TYPES> surfaces_;
 
@@ -179,6 +361,11 @@ image::bool_cache is_empty_hex_;
 // caches storing the different lighted cases for each image
 image::lit_surface_cache lit_surfaces_;
 image::lit_texture_cache lit_textures_;
+
+// terrain textures, possibly stored in the terrain atlas
+image::texture_cache terrain_textures_;
+image::lit_texture_cache lit_terrain_textures_;
+image::texture_cache terrain_silhouettes_;
 // caches storing each lightmap generated
 image::lit_surface_variants surface_lightmaps_;
 image::lit_texture_variants texture_lightmaps_;
@@ -223,6 +410,236 @@ parsed_data_URI::parsed_data_URI(std::string_view data_URI)
 	good = (scheme == "data" && base64 == "base64" && mime.length() > 0 && data.length() > 0);
 }
 
+/**
+ * Packs images of the same size into large shared textures.
+ *
+ * Each page is split in a grid of equally sized slots, handed out in order.
+ * Slots are never freed individually: the whole atlas is dropped by
+ * flush_cache(), together with the caches which refer to it.
+ */
+class texture_atlas
+{
+public:
+	/** Copies @a surf into a free slot. Returns an empty texture if it does not fit. */
+	texture add(const surface& surf);
+
+	void clear()
+	{
+		groups_.clear();
+		pages_used_ = 0;
+	}
+
+private:
+	static const int page_size = 2048;
+	static const int max_slot_size = 256;
+	static const int max_pages = 8;
+
+	struct page_group
+	{
+		std::vector<texture> pages;
+		int next_slot = 0;
+	};
+
+	/** Pages, by slot size. */
+	std::map<std::pair<int, int>, page_group> groups_;
+
+	int pages_used_ = 0;
+};
+
+texture texture_atlas::add(const surface& surf)
+{
+	if(!surf || surf->w <= 0 || surf->h <= 0 || surf->w > max_slot_size || surf->h > max_slot_size) {
+		return texture();
+	}
+
+	page_group& group = groups_[{surf->w, surf->h}];
+
+	const int columns = page_size / surf->w;
+	const int slots_per_page = columns * (page_size / surf->h);
+	const std::size_t page = group.next_slot / slots_per_page;
+
+	if(page == group.pages.size()) {
+		if(pages_used_ == max_pages) {
+			return texture();
+		}
+
+		// Filtering mode must be set before texture creation.
+		set_texture_scale_quality("nearest");
+
+		texture tex(page_size, page_size, SDL_TEXTUREACCESS_STATIC);
+		if(!tex) {
+			return texture();
+		}
+
+		DBG_IMG << "new " << surf->w << "x" << surf->h << " texture atlas page";
+		group.pages.push_back(std::move(tex));
+		++pages_used_;
+	}
+
+	texture res = group.pages[page];
+	if(res.get_format() != surf->format->format) {
+		return texture();
+	}
+
+	const int slot = group.next_slot % slots_per_page;
+	const rect area{(slot % columns) * surf->w, (slot / columns) * surf->h, surf->w, surf->h};
+
+	{
+		const_surface_lock lock(surf);
+		if(SDL_UpdateTexture(res, &area, lock.pixels(), surf->pitch) != 0) {
+			ERR_IMG << "failed to update texture atlas: " << SDL_GetError();
+			return texture();
+		}
+	}
+
+	++group.next_slot;
+
+	res.set_src_raw(area);
+	res.set_draw_size(surf->w, surf->h);
+	return res;
+}
+
+texture_atlas terrain_atlas_;
+
+/**
+ * Reads and decodes image files on a worker thread.
+ *
+ * Only the file decoding happens on the worker: finding the files and all the
+ * caches stay on the main thread. Decoded surfaces wait in ready_ until
+ * load_image_file() takes them.
+ */
+class image_prefetcher
+{
+public:
+	image_prefetcher()
+		: queue_()
+		, pending_()
+		, ready_()
+		, stopped_(false)
+		, mutex_()
+		, cond_()
+		, worker_()
+	{
+	}
+
+	~image_prefetcher()
+	{
+		{
+			std::scoped_lock lock(mutex_);
+			stopped_ = true;
+		}
+
+		cond_.notify_all();
+		if(worker_.joinable()) {
+			worker_.join();
+		}
+	}
+
+	/** Queues a file for decoding, unless it is already queued or decoded. */
+	void add(const std::string& location)
+	{
+		{
+			std::scoped_lock lock(mutex_);
+			if(pending_.count(location) != 0 || ready_.count(location) != 0) {
+				return;
+			}
+
+			pending_.insert(location);
+			queue_.push_back(location);
+		}
+
+		if(!worker_.joinable()) {
+			worker_ = std::thread([this]() { run(); });
+		}
+
+		cond_.notify_one();
+	}
+
+	/**
+	 * Returns the decoded surface of a file, or a null surface if it isn't ready.
+	 * In the latter case, the file is no longer considered for decoding.
+	 */
+	surface take(const std::string& location)
+	{
+		std::scoped_lock lock(mutex_);
+
+		pending_.erase(location);
+
+		auto it = ready_.find(location);
+		if(it == ready_.end()) {
+			return surface();
+		}
+
+		surface res = std::move(it->second);
+		ready_.erase(it);
+		return res;
+	}
+
+	void clear()
+	{
+		std::scoped_lock lock(mutex_);
+		queue_.clear();
+		pending_.clear();
+		ready_.clear();
+	}
+
+private:
+	void run()
+	{
+		std::unique_lock lock(mutex_);
+
+		while(true) {
+			cond_.wait(lock, [this]() { return !queue_.empty() || stopped_; });
+
+			if(stopped_) {
+				return;
+			}
+
+			const std::string location = std::move(queue_.front());
+			queue_.pop_front();
+
+			lock.unlock();
+
+			filesystem::rwops_ptr rwops = filesystem::make_read_RWops(location);
+			surface res(IMG_Load_RW(rwops.release(), true)); // SDL takes ownership of rwops
+
+			lock.lock();
+
+			// Dropped if it was loaded directly, or flushed, in the meantime.
+			if(pending_.erase(location) != 0 && res) {
+				ready_.emplace(location, std::move(res));
+			}
+		}
+	}
+
+	/** Files to decode, in request order. */
+	std::deque<std::string> queue_;
+
+	/** Files queued or being decoded. */
+	std::set<std::string> pending_;
+
+	/** Decoded files, not yet used. */
+	std::map<std::string, surface> ready_;
+
+	bool stopped_;
+
+	std::mutex mutex_;
+	std::condition_variable cond_;
+	std::thread worker_;
+};
+
+image_prefetcher prefetcher_;
+
+/** Returns a texture for a terrain surface, in the atlas if it fits. */
+texture make_terrain_texture(const surface& surf)
+{
+	if(texture res = terrain_atlas_.add(surf)) {
+		return res;
+	}
+
+	return texture(surf);
+}
+
 } // end anon namespace
 
 mini_terrain_cache_map mini_terrain_cache;
@@ -231,13 +648,59 @@ mini_terrain_cache_map mini_highlighted_terrain_cache;
 
 static int last_index_ = 0;
 
+void set_cache_size_limit(std::size_t limit)
+{
+	cache_size_limit = limit;
+}
+
+template<typename T>
+static void log_statistics(const std::string& name, const cache_type<T>& cache)
+{
+	LOG_IMG << name << " cache: " << cache.size() / 1024 << " KiB, " << cache.hits() << " hits, " << cache.misses()
+		<< " misses, " << cache.evictions() << " evictions";
+}
+
+void log_cache_statistics()
+{
+	if(!lg::info().dont_log(log_image)) {
+		for(int type = 0; type < NUM_TYPES; ++type) {
+			log_statistics("surface[" + std::to_string(type) + "]", surfaces_[type]);
+		}
+
+		log_statistics("lit surface", lit_surfaces_);
+		log_statistics("lit texture", lit_textures_);
+		log_statistics("terrain texture", terrain_textures_);
+		log_statistics("lit terrain texture", lit_terrain_textures_);
+		log_statistics("terrain silhouette", terrain_silhouettes_);
+	}
+}
+
+std::size_t cache_memory_usage()
+{
+	std::size_t res = lit_surfaces_.size() + lit_textures_.size() + terrain_textures_.size()
+		+ lit_terrain_textures_.size() + terrain_silhouettes_.size();
+
+	for(const surface_cache& cache : surfaces_) {
+		res += cache.size();
+	}
+
+	return res;
+}
+
 void flush_cache()
 {
+	log_cache_statistics();
+
 	for(surface_cache& cache : surfaces_) {
 		cache.flush();
 	}
 	lit_surfaces_.flush();
 	lit_textures_.flush();
+	terrain_textures_.flush();
+	lit_terrain_textures_.flush();
+	terrain_silhouettes_.flush();
+	terrain_atlas_.clear();
+	prefetcher_.clear();
 	surface_lightmaps_.clear();
 	texture_lightmaps_.clear();
 	in_hex_info_.flush();
@@ -315,20 +778,35 @@ locator::locator(const locator& a, const std::string& mods)
 	}
 }
 
-locator::locator(const char* filename)
-	: index_(-1)
-	, val_(filename)
+void locator::init_from_path(std::string_view path)
 {
+	const auto it = locators_by_path.find(path);
+	if(it != locators_by_path.end()) {
+		*this = it->second;
+		return;
+	}
+
+	val_.type_ = FILE;
+	val_.filename_ = path;
 	parse_arguments();
 	init_index();
+
+	const std::string& key = interned_paths.emplace_back(path);
+	locators_by_path.emplace(key, *this);
+}
+
+locator::locator(const char* filename)
+	: index_(-1)
+	, val_()
+{
+	init_from_path(filename);
 }
 
 locator::locator(const std::string& filename)
 	: index_(-1)
-	, val_(filename)
+	, val_()
 {
-	parse_arguments();
-	init_index();
+	init_from_path(filename);
 }
 
 locator::locator(const std::string& filename, const std::string& modifications)
@@ -495,11 +973,9 @@ static void add_localized_overlay(const std::string& ovr_file, surface& orig_sur
 	sdl_blit(ovr_surf, 0, orig_surf, &area);
 }
 
-static surface load_image_file(const image::locator& loc)
+/** Finds the file of an image, or an empty string if there is none. */
+static std::string find_image_file(const std::string& name, bool& localized)
 {
-	surface res;
-	const std::string& name = loc.get_filename();
-
 	std::string location = filesystem::get_binary_file_location("images", name);
 
 	// Many images have been converted from PNG to WEBP format,
@@ -514,19 +990,38 @@ static surface load_image_file(const image::locator& loc)
 		}
 	}
 
+	localized = false;
+	if(!location.empty()) {
+		// Check if there is a localized image.
+		const std::string loc_location = filesystem::get_localized_path(location);
+		if(!loc_location.empty()) {
+			location = loc_location;
+			localized = true;
+		}
+	}
+
+	return location;
+}
+
+static surface load_image_file(const image::locator& loc)
+{
+	surface res;
+	const std::string& name = loc.get_filename();
+
+	bool localized = false;
+	const std::string location = find_image_file(name, localized);
+
 	{
 		if(!location.empty()) {
-			// Check if there is a localized image.
-			const std::string loc_location = filesystem::get_localized_path(location);
-			if(!loc_location.empty()) {
-				location = loc_location;
-			}
+			res = prefetcher_.take(location);
 
-			filesystem::rwops_ptr rwops = filesystem::make_read_RWops(location);
-			res = IMG_Load_RW(rwops.release(), true); // SDL takes ownership of rwops
+			if(!res) {
+				filesystem::rwops_ptr rwops = filesystem::make_read_RWops(location);
+				res = IMG_Load_RW(rwops.release(), true); // SDL takes ownership of rwops
+			}
 
 			// If there was no standalone localized image, check if there is an overlay.
-			if(res && loc_location.empty()) {
+			if(res && !localized) {
 				const std::string ovr_location = filesystem::get_localized_path(location, "--overlay");
 				if(!ovr_location.empty()) {
 					add_localized_overlay(ovr_location, res);
@@ -546,7 +1041,144 @@ static surface load_image_file(const image::locator& loc)
 	return res;
 }
 
-static surface load_image_sub_file(const image::locator& loc)
+void prefetch(const locator& i_locator)
+{
+	if(i_locator.is_void() || i_locator.is_data_uri() || i_locator.get_filename().empty()) {
+		return;
+	}
+
+	// Modifications are applied on top of the plain file.
+	const locator file(i_locator.get_filename());
+	if(file.in_cache(surfaces_[UNSCALED])) {
+		return;
+	}
+
+	bool localized = false;
+	const std::string location = find_image_file(file.get_filename(), localized);
+	if(!location.empty()) {
+		prefetcher_.add(location);
+	}
+}
+
+namespace
+{
+/** Whether processed images are also saved to the user's cache directory. */
+bool disk_cache_enabled = false;
+
+const uint32_t disk_cache_magic = 0x43494D57; // "WMIC"
+const uint32_t disk_cache_format = 1;
+
+/**
+ * On-disk cache of images with modifications applied, so the recoloring
+ * and other image path functions don't have to be redone every session.
+ *
+ * Entries are raw ARGB pixels behind a small header. The key identifies
+ * the source file by path, size and modification time, so the entry is
+ * ignored once the file changes, and it includes the game version because
+ * team color definitions live in the game data.
+ */
+class disk_cache
+{
+public:
+	/** Returns the cached image, or a null surface if there is no valid entry. */
+	static surface load(const std::string& key)
+	{
+		const std::string path = entry_path(key);
+		if(!filesystem::file_exists(path)) {
+			return nullptr;
+		}
+
+		filesystem::scoped_istream in = filesystem::istream_file(path, false);
+
+		uint32_t header[3];
+		if(!in->read(reinterpret_cast<char*>(header), sizeof(header))
+			|| header[0] != disk_cache_magic || header[1] != disk_cache_format)
+		{
+			return nullptr;
+		}
+
+		std::string stored_key(header[2], '\0');
+		if(!in->read(&stored_key[0], stored_key.size()) || stored_key != key) {
+			return nullptr;
+		}
+
+		int32_t size[2];
+		if(!in->read(reinterpret_cast<char*>(size), sizeof(size)) || size[0] <= 0 || size[1] <= 0) {
+			return nullptr;
+		}
+
+		surface res(size[0], size[1]);
+		if(res == nullptr) {
+			return nullptr;
+		}
+
+		{
+			surface_lock lock(res);
+			if(!in->read(reinterpret_cast<char*>(lock.pixels()), std::streamsize(size[0]) * size[1] * 4)) {
+				return nullptr;
+			}
+		}
+
+		DBG_IMG << "loaded processed image from disk cache: " << key;
+		return res;
+	}
+
+	static void save(const std::string& key, const surface& surf)
+	{
+		if(surf == nullptr || surf->w <= 0 || surf->h <= 0) {
+			return;
+		}
+
+		const std::string path = entry_path(key);
+		const uint32_t header[3] { disk_cache_magic, disk_cache_format, static_cast<uint32_t>(key.size()) };
+		const int32_t size[2] { surf->w, surf->h };
+
+		try {
+			filesystem::scoped_ostream out = filesystem::ostream_file(path);
+			const_surface_lock lock(surf);
+
+			out->write(reinterpret_cast<const char*>(header), sizeof(header));
+			out->write(key.data(), key.size());
+			out->write(reinterpret_cast<const char*>(size), sizeof(size));
+			out->write(reinterpret_cast<const char*>(lock.pixels()), std::streamsize(surf->w) * surf->h * 4);
+		} catch(const filesystem::io_exception& e) {
+			ERR_IMG << "could not write processed image to disk cache: " << e.what();
+		}
+	}
+
+	/** Builds the cache key of a modified image, or an empty string if it shouldn't be cached. */
+	static std::string make_key(const image::locator& loc)
+	{
+		if(loc.is_data_uri() || loc.get_modifications().empty()) {
+			return std::string();
+		}
+
+		bool localized = false;
+		const std::string location = find_image_file(loc.get_filename(), localized);
+		if(location.empty()) {
+			return std::string();
+		}
+
+		std::ostringstream key;
+		key << game_config::wesnoth_version.str() << '|' << location << '|'
+			<< filesystem::file_size(location) << '|' << filesystem::file_modified_time(location) << '|'
+			<< loc.get_filename() << loc.get_modifications();
+
+		return key.str();
+	}
+
+private:
+	static std::string entry_path(const std::string& key)
+	{
+		std::ostringstream path;
+		path << filesystem::get_cache_dir() << "/images/" << std::hex << std::hash<std::string>{}(key) << ".img";
+		return path.str();
+	}
+};
+} // end anon namespace
+
+/** Loads the base file of @a loc and applies its modifications. */
+static surface apply_modifications(const image::locator& loc)
 {
 	surface surf = get_surface(loc.get_filename(), UNSCALED);
 	if(surf == nullptr) {
@@ -556,10 +1188,8 @@ static surface load_image_sub_file(const image::locator& loc)
 	modification_queue mods = modification::decode(loc.get_modifications());
 
 	while(!mods.empty()) {
-		modification* mod = mods.top();
-
 		try {
-			surf = (*mod)(surf);
+			mods.apply_top(surf);
 		} catch(const image::modification::imod_exception& e) {
 			std::ostringstream ss;
 			ss << "\n";
@@ -573,9 +1203,26 @@ static surface load_image_sub_file(const image::locator& loc)
 					<< "Modifications: " << ss.str() << "\n"
 					<< "Error: " << e.message;
 		}
+	}
+
+	return surf;
+}
+
+static surface load_image_sub_file(const image::locator& loc)
+{
+	const std::string disk_key = disk_cache_enabled ? disk_cache::make_key(loc) : std::string();
+	surface surf = disk_key.empty() ? surface(nullptr) : disk_cache::load(disk_key);
+
+	if(surf == nullptr) {
+		surf = apply_modifications(loc);
+
+		if(!disk_key.empty()) {
+			disk_cache::save(disk_key, surf);
+		}
+	}
 
-		// NOTE: do this *after* applying the mod or you'll get crashes!
-		mods.pop();
+	if(surf == nullptr) {
+		return nullptr;
 	}
 
 	if(loc.get_loc().valid()) {
@@ -737,6 +1384,17 @@ static surface load_from_disk(const locator& loc)
 
 manager::manager()
 {
+	// in MiB
+	const std::string limit = preferences::get("image_cache_size");
+	if(!limit.empty()) {
+		try {
+			set_cache_size_limit(std::stoul(limit) * 1024 * 1024);
+		} catch(const std::logic_error&) {
+			ERR_IMG << "invalid image_cache_size preference: " << limit;
+		}
+	}
+
+	disk_cache_enabled = preferences::get("image_disk_cache", false);
 }
 
 manager::~manager()
@@ -753,6 +1411,7 @@ void set_color_adjustment(int r, int g, int b)
 		surfaces_[TOD_COLORED].flush();
 		lit_surfaces_.flush();
 		lit_textures_.flush();
+		lit_terrain_textures_.flush();
 		texture_tod_colored_.clear();
 	}
 }
@@ -961,6 +1620,69 @@ texture get_lighted_texture(
 	return tex;
 }
 
+texture get_terrain_texture(const image::locator& i_locator)
+{
+	if(i_locator.is_void()) {
+		return texture();
+	}
+
+	if(i_locator.in_cache(terrain_textures_)) {
+		return i_locator.locate_in_cache(terrain_textures_);
+	}
+
+	DBG_IMG << "terrain texture cache miss: " << i_locator;
+
+	// skip the surface cache if we're loading plain files with no modifications
+	texture tex = make_terrain_texture(get_surface(i_locator, HEXED, i_locator.get_modifications().empty()));
+	i_locator.add_to_cache(terrain_textures_, tex);
+
+	return tex;
+}
+
+texture get_lighted_terrain_texture(const image::locator& i_locator, const light_string& ls)
+{
+	if(i_locator.is_void()) {
+		return texture();
+	}
+
+	if(!i_locator.in_cache(lit_terrain_textures_)) {
+		i_locator.add_to_cache(lit_terrain_textures_, lit_texture_variants());
+	}
+
+	{
+		const lit_texture_variants& lvar = i_locator.locate_in_cache(lit_terrain_textures_);
+		auto lvi = lvar.find(ls);
+		if(lvi != lvar.end()) {
+			return lvi->second;
+		}
+	}
+
+	DBG_IMG << "lit terrain texture cache miss: " << i_locator;
+
+	texture tex = make_terrain_texture(get_lighted_image(i_locator, ls));
+	i_locator.access_in_cache(lit_terrain_textures_)[ls] = tex;
+
+	return tex;
+}
+
+texture get_terrain_silhouette(const image::locator& i_locator)
+{
+	if(i_locator.is_void()) {
+		return texture();
+	}
+
+	if(i_locator.in_cache(terrain_silhouettes_)) {
+		return i_locator.locate_in_cache(terrain_silhouettes_);
+	}
+
+	DBG_IMG << "terrain silhouette cache miss: " << i_locator;
+
+	texture tex(adjust_surface_color(get_surface(i_locator, HEXED), 255, 255, 255));
+	i_locator.add_to_cache(terrain_silhouettes_, tex);
+
+	return tex;
+}
+
 surface get_hexmask()
 {
 	static const image::locator terrain_mask(game_config::images::terrain_mask);
@@ -1117,6 +1839,21 @@ save_result save_image(const surface& surf, const std::string& filename)
 	return save_result::unsupported_format;
 }
 
+std::future<save_result> save_image_async(const surface& surf, const std::string& filename)
+{
+	if(!surf) {
+		std::promise<save_result> none;
+		none.set_value(save_result::no_image);
+		return none.get_future();
+	}
+
+	// The worker gets the only reference to its copy, as surface reference
+	// counts aren't safe to share between threads.
+	return std::async(std::launch::async, [copy = surf.clone(), filename]() {
+		return save_image(copy, filename);
+	});
+}
+
 /*
  * TEXTURE INTERFACE ======================================================================
  *
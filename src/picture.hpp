@@ -18,6 +18,8 @@
 #include "map/location.hpp"
 #include "terrain/translation.hpp"
 
+#include <future>
+#include <string_view>
 #include <unordered_map>
 
 class surface;
@@ -57,7 +59,9 @@ class cache_type;
  * Constructing locators is somewhat slow, while accessing images through
  * locators is fast. The general idea is that callers should store locators
  * and not strings to construct new ones. (The latter will still work, of
- * course, even if it is slower.)
+ * course, even if it is slower.) Locators constructed from a single path
+ * string are interned by that string, so constructing one from the same
+ * string again costs a hash lookup and a copy.
  */
 class locator
 {
@@ -123,6 +127,9 @@ private:
 	void init_index();
 	void parse_arguments();
 
+	/** Constructs a locator from a path with optional modifications, reusing an earlier one for the same path. */
+	void init_from_path(std::string_view path);
+
 	struct value
 	{
 		value();
@@ -201,6 +208,30 @@ light_string get_light_string(int op, int r, int g, int b);
  */
 void flush_cache();
 
+/**
+ * Starts loading the file of an image in the background.
+ *
+ * The file is read and decoded on a worker thread. The next get_surface()
+ * call needing that file picks up the decoded surface instead of reading the
+ * file itself; image modifications are still applied at that point, on the
+ * calling thread. Does nothing if the file is already cached or queued.
+ */
+void prefetch(const locator& i_locator);
+
+/**
+ * Sets the size limit, in bytes, of each image cache.
+ *
+ * Once a cache grows past its limit, its least recently used images are
+ * evicted. A limit of 0 disables eviction.
+ */
+void set_cache_size_limit(std::size_t limit);
+
+/** Logs the size and hit/miss/eviction counts of the image caches. */
+void log_cache_statistics();
+
+/** Approximate memory used by the image caches, in bytes. */
+std::size_t cache_memory_usage();
+
 /**
  * Image cache manager.
  *
@@ -294,6 +325,36 @@ texture get_texture(const image::locator& i_locator, scale_quality quality,
 surface get_lighted_image(const image::locator& i_locator, const light_string& ls);
 texture get_lighted_texture(const image::locator& i_locator, const light_string& ls);
 
+/**
+ * Returns a HEXED texture for a terrain graphic.
+ *
+ * Where possible, the image is packed with other terrain images of the same
+ * size into a shared atlas texture, so that the many terrain images of a map
+ * are drawn from a handful of GPU textures. The returned texture refers to its
+ * slot through its source rect.
+ *
+ * As the atlas is shared, the alpha, color and blend modes of the returned
+ * texture must not be changed. Use get_texture() for images which need that.
+ *
+ * @param i_locator            Image path.
+ */
+texture get_terrain_texture(const image::locator& i_locator);
+
+/** Same as get_terrain_texture(), with a lightmap applied to the image. */
+texture get_lighted_terrain_texture(const image::locator& i_locator, const light_string& ls);
+
+/**
+ * Returns a white copy of a terrain image, keeping only its alpha, for
+ * draw::color_shift(). One silhouette serves every time of day, unlike
+ * get_lighted_terrain_texture() which makes a copy for each.
+ *
+ * It is not part of the terrain atlas, so its modes may be changed while
+ * drawing.
+ *
+ * @param i_locator            Image path.
+ */
+texture get_terrain_silhouette(const image::locator& i_locator);
+
 /**
  * Retrieves the standard hexagonal tile mask.
  */
@@ -346,4 +407,12 @@ enum class save_result
 save_result save_image(const locator& i_locator, const std::string& outfile);
 save_result save_image(const surface& surf, const std::string& outfile);
 
+/**
+ * Encodes and writes @a surf to @a outfile on a worker thread.
+ *
+ * The pixels are copied first, so the caller may keep using or change the
+ * surface while the image is being written.
+ */
+std::future<save_result> save_image_async(const surface& surf, const std::string& outfile);
+
 }
@@ -31,6 +31,7 @@
 #include "display_chat_manager.hpp"
 #include "floating_label.hpp"
 #include "formula/string_utils.hpp"
+#include "game_config_manager.hpp"
 #include "game_errors.hpp"
 #include "game_events/menu_item.hpp"
 #include "game_events/pump.hpp"
@@ -44,6 +45,7 @@
 #include "hotkey/hotkey_item.hpp"
 #include "log.hpp"
 #include "map/label.hpp"
+#include "picture.hpp"
 #include "pathfind/teleport.hpp"
 #include "preferences/credentials.hpp"
 #include "preferences/display.hpp"
@@ -62,6 +64,7 @@
 #include "soundsource.hpp"
 #include "statistics.hpp"
 #include "synced_context.hpp"
+#include "terrain/builder.hpp"
 #include "tooltips.hpp"
 #include "units/id.hpp"
 #include "units/types.hpp"
@@ -90,6 +93,9 @@ static lg::log_domain log_enginerefac("enginerefac");
 static lg::log_domain log_engine_enemies("engine/enemies");
 #define DBG_EE LOG_STREAM(debug, log_engine_enemies)
 
+static lg::log_domain log_memory("memory");
+#define LOG_MEM LOG_STREAM(info, log_memory)
+
 /**
  * Copies [scenario] attributes/tags that are not otherwise stored in C++ structs/clases.
  */
@@ -552,12 +558,12 @@ void play_controller::init_side_end()
 	whiteboard_manager_->on_init_side();
 }
 
-config play_controller::to_config() const
+config play_controller::to_config(bool with_variables) const
 {
 	config cfg = level_;
 
 	cfg["replay_pos"] = saved_game_.get_replay().get_pos();
-	gamestate().write(cfg);
+	gamestate().write(cfg, with_variables);
 
 	gui_->write(cfg.add_child("display"));
 
@@ -606,6 +612,46 @@ void play_controller::finish_turn()
 	pump().fire("turn_end");
 	pump().fire("turn_" + turn_num + "_end");
 	sync.do_final_checkup();
+
+	log_memory_usage();
+}
+
+std::vector<std::pair<std::string, std::size_t>> play_controller::memory_usage() const
+{
+	std::vector<std::pair<std::string, std::size_t>> res;
+
+	if(const game_config_manager* gcm = game_config_manager::get()) {
+		res.emplace_back("game config", gcm->memory_usage());
+	}
+
+	res.emplace_back("image caches", image::cache_memory_usage());
+
+	if(gui_) {
+		res.emplace_back("terrain builder", gui_->get_builder().memory_usage());
+	}
+
+	if(gamestate_ && gamestate_->lua_kernel_) {
+		res.emplace_back("Lua", gamestate_->lua_kernel_->get_memory_pool().bytes_in_use());
+	}
+
+	if(gamestate_) {
+		res.emplace_back("variables", gamestate_->gamedata_.get_variables().memory_usage());
+	}
+
+	res.emplace_back("replay", saved_game_.get_replay().memory_usage());
+
+	return res;
+}
+
+void play_controller::log_memory_usage() const
+{
+	if(lg::info().dont_log(log_memory)) {
+		return;
+	}
+
+	for(const auto& [name, bytes] : memory_usage()) {
+		LOG_MEM << "turn " << turn() << ": " << name << " " << bytes / 1024 << " KiB";
+	}
 }
 
 bool play_controller::enemies_visible() const
@@ -1444,7 +1490,9 @@ void play_controller::check_time_over()
 play_controller::scoped_savegame_snapshot::scoped_savegame_snapshot(const play_controller& controller)
 	: controller_(controller)
 {
-	controller_.update_savegame_snapshot();
+	// The snapshot only lives while the game is saved, so the variables are written from the game data
+	// instead of being copied into it.
+	controller_.saved_game_.set_snapshot(controller_.to_config(false), controller_.gamestate().gamedata_.get_variables());
 }
 
 play_controller::scoped_savegame_snapshot::~scoped_savegame_snapshot()
@@ -224,8 +224,10 @@ public:
 
 	/**
 	 * Builds the snapshot config from members and their respective configs.
+	 *
+	 * @param with_variables     Whether to copy the WML variables into it.
 	 */
-	config to_config() const;
+	config to_config(bool with_variables = true) const;
 
 	bool is_skipping_replay() const { return skip_replay_; }
 	void toggle_skipping_replay();
@@ -329,6 +331,14 @@ public:
 
 	saved_game& get_saved_game() { return saved_game_; }
 
+	/**
+	 * Approximate memory used by the main subsystems, in bytes.
+	 *
+	 * Walks the game config and other WML trees, so it can take a moment
+	 * with a large game config.
+	 */
+	std::vector<std::pair<std::string, std::size_t>> memory_usage() const;
+
 protected:
 	friend struct scoped_savegame_snapshot;
 	void play_slice_catch();
@@ -346,6 +356,8 @@ protected:
 	virtual void init_gui();
 	void finish_side_turn();
 	void finish_turn(); //this should not throw an end turn or end level exception
+	/** Logs memory_usage() to the "memory" log domain, if it is at info level. */
+	void log_memory_usage() const;
 	bool enemies_visible() const;
 
 	void enter_textbox();
@@ -486,7 +486,9 @@ void playmp_controller::play_slice(bool is_delay_enabled)
 		// receive chat during animations and delay
 		process_network_data(true);
 		// cannot use turn_data_.send_data() here.
-		replay_sender_.sync_non_undoable();
+		// Nothing waits on this data, so commands from a burst of actions
+		// (like an AI turn) are sent together.
+		replay_sender_.sync_non_undoable(true);
 	}
 
 	playsingle_controller::play_slice(is_delay_enabled);
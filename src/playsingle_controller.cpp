@@ -207,8 +207,8 @@ void playsingle_controller::play_scenario_main_loop()
 				local_players[i] = get_teams()[i].is_local();
 			}
 
-			if(ex.start_replay) {
-				// MP "Back to turn"
+			if(ex.stats_) {
+				// MP "Back to turn", or a replay keyframe
 				statistics::read_stats(*ex.stats_);
 			} else {
 				// SP replay
@@ -588,6 +588,7 @@ void playsingle_controller::play_ai_turn()
 	undo_stack().clear();
 	turn_data_.send_data();
 
+	const auto ai_start = std::chrono::steady_clock::now();
 	try {
 		try {
 			if(!should_return_to_play_side()) {
@@ -605,6 +606,8 @@ void playsingle_controller::play_ai_turn()
 		throw;
 	}
 
+	ai_testing::add_ai_time(current_side(), std::chrono::steady_clock::now() - ai_start);
+
 	if(!should_return_to_play_side()) {
 		end_turn_ = END_TURN_REQUIRED;
 	}
@@ -719,6 +722,17 @@ void playsingle_controller::reset_replay()
 	}
 }
 
+void playsingle_controller::replay_prev_turn()
+{
+	const replay_controller::keyframe* frame = replay_controller_ ? replay_controller_->prev_turn_keyframe() : nullptr;
+	if(frame) {
+		replay_controller_->stop_replay();
+		throw reset_gamestate_exception(frame->level, frame->stats, false);
+	} else {
+		ERR_NG << "received invalid previous turn";
+	}
+}
+
 void playsingle_controller::enable_replay(bool is_unit_test)
 {
 	replay_controller_ = std::make_unique<replay_controller>(
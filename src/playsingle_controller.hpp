@@ -98,4 +98,5 @@ protected:
 	void sync_end_turn() override;
 	void update_viewing_player() override;
 	void reset_replay();
+	void replay_prev_turn();
 };
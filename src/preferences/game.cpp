@@ -444,6 +444,16 @@ void set_hide_whiteboard(bool value)
 	preferences::set("hide_whiteboard", value);
 }
 
+bool hashed_checkups()
+{
+	return preferences::get("hashed_checkups", false);
+}
+
+void set_hashed_checkups(bool value)
+{
+	preferences::set("hashed_checkups", value);
+}
+
 bool show_combat()
 {
 	return preferences::get("show_combat", true);
@@ -112,6 +112,10 @@ void set_enable_whiteboard_mode_on_start(bool value);
 bool hide_whiteboard();
 void set_hide_whiteboard(bool value);
 
+/** Whether synced actions record a hash of their checkup data instead of each result. */
+bool hashed_checkups();
+void set_hashed_checkups(bool value);
+
 bool show_combat();
 
 bool allow_observers();
@@ -18,37 +18,72 @@
 #include "units/ptr.hpp"
 
 #include <algorithm>
+#include <cassert>
 #include <string>
 #include <vector>
 
 #include <functional>
 
-/**
- * Used to find units in vectors by their ID.
- */
-unit_ptr recall_list_manager::find_if_matches_id(const std::string &unit_id)
+void recall_list_manager::update_indexes() const
 {
-	std::vector<unit_ptr >::iterator it = std::find_if(recall_list_.begin(), recall_list_.end(),
-		[&unit_id](const unit_ptr & ptr) { return ptr->id() == unit_id; });
-	if (it != recall_list_.end()) {
-		return *it;
-	} else {
-		return unit_ptr();
+	if(indexes_valid_) {
+		return;
+	}
+
+	id_index_.clear();
+	uid_index_.clear();
+	for(std::size_t i = 0; i < recall_list_.size(); ++i) {
+		// emplace keeps the first unit, like the scans do.
+		id_index_.emplace(recall_list_[i]->id(), i);
+		uid_index_.emplace(recall_list_[i]->underlying_id(), i);
 	}
+
+	indexes_valid_ = true;
 }
 
-/**
- * Used to find units in vectors by their ID.
- */
-unit_const_ptr recall_list_manager::find_if_matches_id(const std::string &unit_id) const
+std::size_t recall_list_manager::find_index(const std::string & unit_id) const
 {
-	std::vector<unit_ptr >::const_iterator it = std::find_if(recall_list_.begin(), recall_list_.end(),
+	update_indexes();
+
+	const auto i = id_index_.find(unit_id);
+	if(i != id_index_.end() && recall_list_[i->second]->id() == unit_id) {
+		return i->second;
+	}
+
+	// The units can be changed through the iterators, so the index can miss
+	// a unit whose id was changed after it was built.
+	const_iterator it = std::find_if(recall_list_.begin(), recall_list_.end(),
 		[&unit_id](const unit_ptr & ptr) { return ptr->id() == unit_id; });
-	if (it != recall_list_.end()) {
-		return *it;
-	} else {
-		return unit_ptr();
+
+	return std::distance(recall_list_.begin(), it);
+}
+
+std::size_t recall_list_manager::find_underlying_index(std::size_t uid) const
+{
+	update_indexes();
+
+	const auto i = uid_index_.find(uid);
+	if(i != uid_index_.end() && recall_list_[i->second]->underlying_id() == uid) {
+		return i->second;
 	}
+
+	// See find_index().
+	const_iterator it = std::find_if(recall_list_.begin(), recall_list_.end(),
+		[uid](const unit_ptr & ptr) { return ptr->underlying_id() == uid; });
+
+	return std::distance(recall_list_.begin(), it);
+}
+
+unit_ptr recall_list_manager::find_if_matches_id(const std::string &unit_id)
+{
+	const std::size_t index = find_index(unit_id);
+	return index < recall_list_.size() ? recall_list_[index] : unit_ptr();
+}
+
+unit_const_ptr recall_list_manager::find_if_matches_id(const std::string &unit_id) const
+{
+	const std::size_t index = find_index(unit_id);
+	return index < recall_list_.size() ? recall_list_[index] : unit_ptr();
 }
 
 /**
@@ -61,36 +96,34 @@ void recall_list_manager::erase_if_matches_id(const std::string &unit_id)
 	recall_list_.erase(std::remove_if(recall_list_.begin(), recall_list_.end(),
 		[unit_id](const unit_ptr & ptr) { return ptr->id() == unit_id; }),
 	                       recall_list_.end());
+	indexes_valid_ = false;
 }
 
 void recall_list_manager::add(const unit_ptr & ptr, int pos)
 {
 	if (pos < 0 || pos >= static_cast<int>(recall_list_.size())) {
 		recall_list_.push_back(ptr);
+		if(indexes_valid_) {
+			// Appending doesn't move the other units.
+			id_index_.emplace(ptr->id(), recall_list_.size() - 1);
+			uid_index_.emplace(ptr->underlying_id(), recall_list_.size() - 1);
+		}
 	}
 	else {
 		recall_list_.insert(recall_list_.begin() + pos, ptr);
+		indexes_valid_ = false;
 	}
 }
 
-std::size_t recall_list_manager::find_index(const std::string & unit_id) const
-{
-	std::vector<unit_ptr >::const_iterator it = std::find_if(recall_list_.begin(), recall_list_.end(),
-		[&unit_id](const unit_ptr & ptr) { return ptr->id() == unit_id; });
-
-	return std::distance(recall_list_.begin(), it);
-}
-
 unit_ptr recall_list_manager::extract_if_matches_id(const std::string &unit_id, int * pos)
 {
-	std::vector<unit_ptr >::iterator it = std::find_if(recall_list_.begin(), recall_list_.end(),
-		[&unit_id](const unit_ptr & ptr) { return ptr->id() == unit_id; });
-	if (it != recall_list_.end()) {
-		unit_ptr ret = *it;
+	const std::size_t index = find_index(unit_id);
+	if (index < recall_list_.size()) {
+		unit_ptr ret = recall_list_[index];
 		if(pos) {
-			*pos = it - recall_list_.begin();
+			*pos = index;
 		}
-		recall_list_.erase(it);
+		erase_index(index);
 		return ret;
 	} else {
 		return unit_ptr();
@@ -99,24 +132,14 @@ unit_ptr recall_list_manager::extract_if_matches_id(const std::string &unit_id,
 
 unit_ptr recall_list_manager::find_if_matches_underlying_id(std::size_t uid)
 {
-	std::vector<unit_ptr >::iterator it = std::find_if(recall_list_.begin(), recall_list_.end(),
-		[uid](const unit_ptr & ptr) { return ptr->underlying_id() == uid; });
-	if (it != recall_list_.end()) {
-		return *it;
-	} else {
-		return unit_ptr();
-	}
+	const std::size_t index = find_underlying_index(uid);
+	return index < recall_list_.size() ? recall_list_[index] : unit_ptr();
 }
 
 unit_const_ptr recall_list_manager::find_if_matches_underlying_id(std::size_t uid) const
 {
-	std::vector<unit_ptr >::const_iterator it = std::find_if(recall_list_.begin(), recall_list_.end(),
-		[uid](const unit_ptr & ptr) { return ptr->underlying_id() == uid; });
-	if (it != recall_list_.end()) {
-		return *it;
-	} else {
-		return unit_ptr();
-	}
+	const std::size_t index = find_underlying_index(uid);
+	return index < recall_list_.size() ? recall_list_[index] : unit_ptr();
 }
 
 void recall_list_manager::erase_by_underlying_id(std::size_t uid)
@@ -124,15 +147,15 @@ void recall_list_manager::erase_by_underlying_id(std::size_t uid)
 	recall_list_.erase(std::remove_if(recall_list_.begin(), recall_list_.end(),
 		[uid](const unit_ptr & ptr) { return ptr->underlying_id() == uid; }),
 	                       recall_list_.end());
+	indexes_valid_ = false;
 }
 
 unit_ptr recall_list_manager::extract_if_matches_underlying_id(std::size_t uid)
 {
-	std::vector<unit_ptr >::iterator it = std::find_if(recall_list_.begin(), recall_list_.end(),
-		[uid](const unit_ptr & ptr) { return ptr->underlying_id() == uid; });
-	if (it != recall_list_.end()) {
-		unit_ptr ret = *it;
-		recall_list_.erase(it);
+	const std::size_t index = find_underlying_index(uid);
+	if (index < recall_list_.size()) {
+		unit_ptr ret = recall_list_[index];
+		erase_index(index);
 		return ret;
 	} else {
 		return unit_ptr();
@@ -141,9 +164,11 @@ unit_ptr recall_list_manager::extract_if_matches_underlying_id(std::size_t uid)
 
 std::vector<unit_ptr>::iterator recall_list_manager::erase_index(std::size_t idx) {
 	assert(idx < recall_list_.size());
+	indexes_valid_ = false;
 	return recall_list_.erase(recall_list_.begin()+idx);
 }
 
 std::vector<unit_ptr>::iterator recall_list_manager::erase(std::vector<unit_ptr>::iterator it) {
+	indexes_valid_ = false;
 	return recall_list_.erase(it);
 }
@@ -18,6 +18,7 @@
 #include "units/ptr.hpp"
 
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace ai {
@@ -27,6 +28,14 @@ namespace ai {
 /** This class encapsulates the recall list of a team. */
 class recall_list_manager {
 public:
+	recall_list_manager()
+		: recall_list_()
+		, id_index_()
+		, uid_index_()
+		, indexes_valid_(false)
+	{
+	}
+
 	typedef std::vector<unit_ptr >::iterator iterator;
 	typedef std::vector<unit_ptr >::const_iterator const_iterator;
 
@@ -71,8 +80,10 @@ public:
 	/** Erase an iterator to this object. */
 	iterator erase(iterator it);
 
-	/** Find the index of a unit by its id. */
+	/** Find the index of a unit by its id, size() if there is none. */
 	std::size_t find_index(const std::string & unit_id) const;
+	/** Find the index of a unit by its underlying id, size() if there is none. */
+	std::size_t find_underlying_index(std::size_t uid) const;
 	/** Get the number of units on the list. */
 	std::size_t size() const { return recall_list_.size(); }
 	/** Is it empty? */
@@ -90,4 +101,17 @@ private:
 	 * TODO: Should this be a map based on underlying id instead?
 	 */
 	std::vector<unit_ptr > recall_list_;
+
+	/** Builds id_index_ and uid_index_ if the list changed since they were. */
+	void update_indexes() const;
+
+	/**
+	 * The position of the first unit with each id and underlying id.
+	 *
+	 * Lookups check the unit they find, since the units can be changed in
+	 * place; only changes to the list itself invalidate the indexes.
+	 */
+	mutable std::unordered_map<std::string, std::size_t> id_index_;
+	mutable std::unordered_map<std::size_t, std::size_t> uid_index_;
+	mutable bool indexes_valid_;
 };
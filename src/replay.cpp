@@ -901,7 +901,13 @@ REPLAY_RETURN do_replay_handle(bool one_move)
 	}
 }
 
-replay_network_sender::replay_network_sender(replay& obj) : obj_(obj), upto_(obj_.ncommands())
+namespace
+{
+/** Minimum delay between two batched sends of replay_network_sender. */
+const std::chrono::milliseconds network_batch_interval(100);
+}
+
+replay_network_sender::replay_network_sender(replay& obj) : obj_(obj), upto_(obj_.ncommands()), last_sent_()
 {
 }
 
@@ -912,15 +918,21 @@ replay_network_sender::~replay_network_sender()
 	} catch (...) {}
 }
 
-void replay_network_sender::sync_non_undoable()
+void replay_network_sender::sync_non_undoable(bool batch)
 {
 	if(resources::controller->is_networked_mp()) {
+		const auto now = std::chrono::steady_clock::now();
+		if(batch && now - last_sent_ < network_batch_interval) {
+			return;
+		}
+
 		resources::whiteboard->send_network_data();
 
 		config cfg;
 		const config& data = cfg.add_child("turn",obj_.get_data_range(upto_,obj_.ncommands(),replay::NON_UNDO_DATA));
 		if(data.empty() == false) {
 			resources::controller->send_to_wesnothd(cfg);
+			last_sent_ = now;
 		}
 	}
 }
@@ -935,6 +947,7 @@ void replay_network_sender::commit_and_sync()
 
 		if(data.empty() == false) {
 			resources::controller->send_to_wesnothd(cfg);
+			last_sent_ = std::chrono::steady_clock::now();
 		}
 
 		upto_ = obj_.ncommands();
@@ -22,6 +22,7 @@
 
 #include "map/location.hpp"
 
+#include <chrono>
 #include <ctime>
 #include <deque>
 #include <iterator>
@@ -174,9 +175,19 @@ public:
 	replay_network_sender(replay& obj);
 	~replay_network_sender();
 
-	void sync_non_undoable();
+	/**
+	 * Sends the commands that can no longer be undone.
+	 *
+	 * @param batch  If true and something was sent very recently, nothing is
+	 *               sent now; a later call then sends the commands of the
+	 *               whole window in one [turn]. Used by the per-frame sync,
+	 *               where nobody is waiting on the data.
+	 */
+	void sync_non_undoable(bool batch = false);
 	void commit_and_sync();
 private:
 	replay& obj_;
 	int upto_;
+	/** When data was last sent to the server. */
+	std::chrono::steady_clock::time_point last_sent_;
 };
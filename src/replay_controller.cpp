@@ -20,6 +20,7 @@
 #include "replay.hpp"
 #include "resources.hpp"
 #include "playsingle_controller.hpp"
+#include "statistics.hpp"
 
 static lg::log_domain log_engine("engine");
 #define DBG_NG LOG_STREAM(debug, log_engine)
@@ -69,6 +70,7 @@ replay_controller::replay_controller(play_controller& controller, bool control_v
 	, disabler_()
 	, vision_()
 	, reset_state_(reset_state)
+	, keyframes_()
 	, on_end_replay_(on_end_replay)
 	, return_to_play_side_(false)
 {
@@ -133,6 +135,34 @@ void replay_controller::update_gui()
 	controller_.get_display().queue_rerender();
 }
 
+void replay_controller::add_keyframe()
+{
+	// Restoring a keyframe uses the same path as resetting the replay.
+	if(!allow_reset_replay()) {
+		return;
+	}
+
+	const int turn = controller_.gamestate().tod_manager_.turn();
+	if(keyframes_.count(turn) != 0) {
+		return;
+	}
+
+	keyframes_.emplace(turn, keyframe{
+		std::make_shared<config>(controller_.to_config()),
+		std::make_shared<config>(statistics::write_stats())
+	});
+}
+
+const replay_controller::keyframe* replay_controller::prev_turn_keyframe() const
+{
+	auto it = keyframes_.lower_bound(controller_.gamestate().tod_manager_.turn());
+	if(it == keyframes_.begin()) {
+		return nullptr;
+	}
+
+	return &std::prev(it)->second;
+}
+
 void replay_controller::update_enabled_buttons()
 {
 	controller_.get_display().queue_rerender();
@@ -178,6 +208,7 @@ REPLAY_RETURN replay_controller::play_side_impl()
 				}
 				if(res == REPLAY_FOUND_INIT_TURN)
 				{
+					add_keyframe();
 					stop_condition_->new_side_turn(controller_.current_side(), controller_.gamestate().tod_manager_.turn());
 				}
 			}
@@ -218,6 +249,8 @@ bool replay_controller::can_execute_command(const hotkey::hotkey_command& cmd, i
 		return should_stop() && (events::commands_disabled <= 1 ) && !recorder_at_end();
 	case hotkey::HOTKEY_REPLAY_RESET:
 		return allow_reset_replay() && events::commands_disabled <= 1;
+	case hotkey::HOTKEY_REPLAY_PREV_TURN:
+		return prev_turn_keyframe() != nullptr && events::commands_disabled <= 1;
 	default:
 		assert(false);
 		return false;
@@ -18,6 +18,7 @@
 #include "replay.hpp"
 #include "mouse_handler_base.hpp" //events::command_disabler
 
+#include <map>
 #include <vector>
 
 class replay_controller : public events::observer
@@ -31,6 +32,13 @@ public:
 		virtual bool should_stop() { return true; }
 		virtual ~replay_stop_condition(){}
 	};
+	/** The game state at the start of a turn, as recorded during playback. */
+	struct keyframe
+	{
+		std::shared_ptr<config> level;
+		std::shared_ptr<config> stats;
+	};
+
 	static void nop() {}
 	replay_controller(play_controller& controller, bool control_view, const std::shared_ptr<config>& reset_state, const std::function<void()>& on_end_replay = nop);
 	~replay_controller();
@@ -51,6 +59,8 @@ public:
 	}
 	bool allow_reset_replay() const { return reset_state_.get() != nullptr; }
 	const std::shared_ptr<config>& get_reset_state() const { return reset_state_; }
+	/** The latest keyframe from before the current turn, or nullptr if there isn't one. */
+	const keyframe* prev_turn_keyframe() const;
 	void return_to_play_side(bool r = true) { return_to_play_side_ = r; }
 	void replay_show_everything();
 	void replay_show_each();
@@ -62,6 +72,8 @@ private:
 	void add_replay_theme();
 	void init();
 	void update_gui();
+	/** Records a keyframe for the current turn, unless there already is one. */
+	void add_keyframe();
 	void handle_generic_event(const std::string& name) override;
 
 	/**
@@ -87,6 +99,11 @@ private:
 	};
 	std::optional<REPLAY_VISION> vision_;
 	std::shared_ptr<config> reset_state_;
+	/**
+	 * Keyframes by turn, taken at the first side initialization of each turn. These
+	 * survive resetting the game state, so seeking back doesn't replay from the start.
+	 */
+	std::map<int, keyframe> keyframes_;
 	std::function<void()> on_end_replay_;
 	bool return_to_play_side_;
 };
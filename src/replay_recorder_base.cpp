@@ -46,6 +46,16 @@ int replay_recorder_base::size() const
 	return commands_.size();
 }
 
+std::size_t replay_recorder_base::memory_usage() const
+{
+	std::size_t res = upload_log_.memory_usage();
+	for(const config& command : commands_) {
+		res += sizeof(config) + command.memory_usage();
+	}
+
+	return res;
+}
+
 config& replay_recorder_base::get_command_at(int pos)
 {
 	assert(pos < size());
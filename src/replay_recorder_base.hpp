@@ -31,6 +31,9 @@ public:
 
 	int size() const;
 
+	/** Approximate memory used by the recorded commands, in bytes. */
+	std::size_t memory_usage() const;
+
 	config& get_command_at(int pos);
 
 	config& add_child();
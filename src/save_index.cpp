@@ -48,6 +48,12 @@ void save_index_class::rebuild(const std::string& name)
 }
 
 void save_index_class::rebuild(const std::string& name, const std::time_t& modified)
+{
+	rebuild_summary(name, modified);
+	write_save_index();
+}
+
+void save_index_class::rebuild_summary(const std::string& name, const std::time_t& modified)
 {
 	log_scope("load_summary_from_file");
 
@@ -64,14 +70,21 @@ void save_index_class::rebuild(const std::string& name, const std::time_t& modif
 	}
 
 	summary["mod_time"] = std::to_string(static_cast<int>(modified));
-	write_save_index();
+	changed_ = true;
 }
 
 void save_index_class::remove(const std::string& name)
+{
+	remove_summary(name);
+	write_save_index();
+}
+
+void save_index_class::remove_summary(const std::string& name)
 {
 	config& root = data();
 	root.remove_children("save", [&name](const config& d) { return name == d["save"]; });
-	write_save_index();
+	by_name_.clear();
+	changed_ = true;
 }
 
 void save_index_class::set_modified(const std::string& name, const std::time_t& modified)
@@ -86,7 +99,8 @@ config& save_index_class::get(const std::string& name)
 
 	config::attribute_value& mod_time = result["mod_time"];
 	if(mod_time.empty() || mod_time.to_time_t() != m) {
-		rebuild(name, m);
+		// Written by write_save_index_if_changed(), as the load dialog may rebuild many of these.
+		rebuild_summary(name, m);
 	}
 
 	return result;
@@ -105,11 +119,13 @@ void save_index_class::clean_up_index()
 	filesystem::get_files_in_dir(dir(), &filenames);
 
 	if(root.all_children_count() > filenames.size()) {
+		std::sort(filenames.begin(), filenames.end());
 		root.remove_children("save", [&filenames](const config& d)
 			{
-				return std::find(filenames.begin(), filenames.end(), d["save"]) == filenames.end();
+				return !std::binary_search(filenames.begin(), filenames.end(), d["save"].str());
 			}
 		);
+		by_name_.clear();
 	}
 }
 
@@ -127,6 +143,8 @@ void save_index_class::write_save_index()
 		clean_up_index_ = false;
 	}
 
+	changed_ = false;
+
 	try {
 		filesystem::scoped_ostream stream = filesystem::ostream_file(filesystem::get_save_index_file());
 
@@ -141,9 +159,18 @@ void save_index_class::write_save_index()
 	}
 }
 
+void save_index_class::write_save_index_if_changed()
+{
+	if(changed_) {
+		write_save_index();
+	}
+}
+
 save_index_class::save_index_class(const std::string& dir)
 	: loaded_(false)
 	, data_()
+	, by_name_()
+	, changed_(false)
 	, modified_()
 	, dir_(dir)
 	, read_only_(true)
@@ -160,13 +187,23 @@ save_index_class::save_index_class(create_for_default_saves_dir)
 config& save_index_class::data(const std::string& name)
 {
 	config& cfg = data();
-	if(config& sv = cfg.find_child("save", "save", name)) {
-		fix_leader_image_path(sv);
-		return sv;
+
+	// Looking up each save by a linear search is quadratic over the whole list.
+	if(by_name_.empty()) {
+		for(config& sv : cfg.child_range("save")) {
+			by_name_.emplace(sv["save"], &sv);
+		}
+	}
+
+	auto it = by_name_.find(name);
+	if(it != by_name_.end()) {
+		fix_leader_image_path(*it->second);
+		return *it->second;
 	}
 
 	config& res = cfg.add_child("save");
 	res["save"] = name;
+	by_name_.emplace(name, &res);
 	return res;
 }
 
@@ -228,6 +265,9 @@ std::vector<save_info> save_index_class::get_saves_list(const std::string* filte
 
 		if(std::find(to_ignore.begin(), to_ignore.end(), filename) != to_ignore.end()) {
 			return true;
+		} else if(filesystem::ends_with(filename, ".part")) {
+			// A save still being written in the background
+			return true;
 		} else if(filter) {
 			return filename.end() == std::search(filename.begin(), filename.end(), filter->begin(), filter->end());
 		}
@@ -371,9 +411,12 @@ void save_index_class::delete_old_auto_saves(const int autosavemax, const int in
 	for(std::vector<save_info>::iterator i = games.begin(); i != games.end(); ++i) {
 		if(countdown-- <= 0) {
 			LOG_SAVE << "Deleting savegame '" << i->name() << "'";
-			delete_game(i->name());
+			filesystem::delete_file(dir() + "/" + i->name());
+			remove_summary(i->name());
 		}
 	}
+
+	write_save_index_if_changed();
 }
 
 void save_index_class::delete_game(const std::string& name)
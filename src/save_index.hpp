@@ -111,6 +111,9 @@ public:
 	/** Sync to disk, no-op if read_only_ is set */
 	void write_save_index();
 
+	/** Sync to disk if summaries were rebuilt by get() since the last write. */
+	void write_save_index_if_changed();
+
 	/**
 	 * If true, all of delete_game, delete_old_auto_saves and write_save_index will be no-ops.
 	 */
@@ -123,12 +126,20 @@ private:
 	config& data(const std::string& name);
 	config& data();
 
+	/** rebuild() and remove() without writing the index. */
+	void rebuild_summary(const std::string& name, const std::time_t& modified);
+	void remove_summary(const std::string& name);
+
 	static void fix_leader_image_path(config& data);
 	/** Deletes non-existent save files from the index. */
 	void clean_up_index();
 
 	bool loaded_;
 	config data_;
+	/** The [save] children of data_ by name, built on first use. */
+	std::map<std::string, config*> by_name_;
+	/** Whether data_ has changes that aren't on disk yet. */
+	bool changed_;
 	std::map<std::string, std::time_t> modified_;
 	const std::string dir_;
 	/**
@@ -127,6 +127,7 @@ saved_game::saved_game()
 	, mp_settings_()
 	, starting_point_type_(starting_point::NONE)
 	, starting_point_()
+	, snapshot_variables_(nullptr)
 	, replay_data_()
 	, skip_story_(false)
 {
@@ -140,6 +141,7 @@ saved_game::saved_game(config cfg)
 	, mp_settings_()
 	, starting_point_type_(starting_point::NONE)
 	, starting_point_()
+	, snapshot_variables_(nullptr)
 	, replay_data_()
 	, skip_story_(false)
 {
@@ -154,6 +156,7 @@ saved_game::saved_game(const saved_game& state)
 	, mp_settings_(state.mp_settings_)
 	, starting_point_type_(state.starting_point_type_)
 	, starting_point_(state.starting_point_)
+	, snapshot_variables_(state.snapshot_variables_)
 	, replay_data_(state.replay_data_)
 	, skip_story_(state.skip_story_)
 {
@@ -195,7 +198,12 @@ void saved_game::write_config(config_writer& out) const
 
 void saved_game::write_starting_point(config_writer& out) const
 {
-	if(starting_point_type_ == starting_point::SNAPSHOT) {
+	if(starting_point_type_ == starting_point::SNAPSHOT && snapshot_variables_) {
+		out.open_child("snapshot");
+		out.write(starting_point_);
+		out.write_child("variables", *snapshot_variables_);
+		out.close_child("snapshot");
+	} else if(starting_point_type_ == starting_point::SNAPSHOT) {
 		out.write_child("snapshot", starting_point_);
 	} else if(starting_point_type_ == starting_point::SCENARIO) {
 		out.write_child("scenario", starting_point_);
@@ -560,14 +568,27 @@ config& saved_game::set_snapshot(config snapshot)
 {
 	starting_point_type_ = starting_point::SNAPSHOT;
 	starting_point_.swap(snapshot);
+	snapshot_variables_ = nullptr;
 
 	return starting_point_;
 }
 
+void saved_game::set_snapshot(config snapshot, const config& variables)
+{
+	set_snapshot(std::move(snapshot));
+	snapshot_variables_ = &variables;
+}
+
+bool saved_game::validate_starting_point() const
+{
+	return starting_point_.validate_wml() && (!snapshot_variables_ || snapshot_variables_->validate_wml());
+}
+
 void saved_game::set_scenario(config scenario)
 {
 	starting_point_type_ = starting_point::SCENARIO;
 	starting_point_.swap(scenario);
+	snapshot_variables_ = nullptr;
 
 	has_carryover_expanded_ = false;
 
@@ -578,6 +599,7 @@ void saved_game::remove_snapshot()
 {
 	starting_point_type_ = starting_point::NONE;
 	starting_point_.clear();
+	snapshot_variables_ = nullptr;
 }
 
 config& saved_game::get_starting_point()
@@ -635,7 +657,10 @@ config saved_game::to_config() const
 	replay_data_.write(r.add_child("replay"));
 
 	if(starting_point_type_ == starting_point::SNAPSHOT) {
-		r.add_child("snapshot", starting_point_);
+		config& snapshot = r.add_child("snapshot", starting_point_);
+		if(snapshot_variables_) {
+			snapshot.add_child("variables", *snapshot_variables_);
+		}
 	} else if(starting_point_type_ == starting_point::SCENARIO) {
 		r.add_child("scenario", starting_point_);
 	}
@@ -724,6 +749,7 @@ void saved_game::swap(saved_game& other)
 	replay_data_.swap(other.replay_data_);
 	replay_start_.swap(other.replay_start_);
 	starting_point_.swap(other.starting_point_);
+	std::swap(snapshot_variables_, other.snapshot_variables_);
 
 	std::swap(starting_point_type_, other.starting_point_type_);
 }
@@ -769,6 +795,8 @@ void saved_game::set_data(config& cfg)
 		starting_point_.clear();
 	}
 
+	snapshot_variables_ = nullptr;
+
 	LOG_NG << "scenario: '" << carryover_["next_scenario"].str() << "'";
 
 	if(const config& stats = cfg.child("statistics")) {
@@ -791,6 +819,7 @@ void saved_game::clear()
 	replay_data_.swap({});
 	replay_start_.clear();
 	starting_point_.clear();
+	snapshot_variables_ = nullptr;
 	starting_point_type_ = starting_point::NONE;
 }
 
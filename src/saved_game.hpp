@@ -99,6 +99,13 @@ public:
 	bool valid() const;
 	/** @return the snapshot in the savefile (get_starting_point) */
 	config& set_snapshot(config snapshot);
+	/**
+	 * Sets a snapshot without its [variables], which are written from @a variables instead of being copied.
+	 *
+	 * For snapshots only made to be saved: @a variables must stay unchanged until the snapshot is removed,
+	 * and get_starting_point() returns the snapshot without them.
+	 */
+	void set_snapshot(config snapshot, const config& variables);
 	void set_scenario(config scenario);
 	void remove_snapshot();
 
@@ -120,6 +127,8 @@ public:
 	/** @return the config from which the game will be started. (this is [scenario] or [snapshot] in the savefile) */
 	config& get_starting_point();
 	const config& get_starting_point() const { return starting_point_; }
+	/** Checks the starting point, including the variables of a snapshot made by set_snapshot(config, const config&). */
+	bool validate_starting_point() const;
 	config& replay_start() { return replay_start_; }
 	const config& replay_start() const { return replay_start_; }
 
@@ -159,6 +168,8 @@ private:
 		This can eigher be a [scenario] for a fresh game or a [snapshot] if this is a reloaded game
 	*/
 	config starting_point_;
+	/** The [variables] of the snapshot when they are not in starting_point_, see set_snapshot(config, const config&). */
+	const config* snapshot_variables_;
 
 	replay_recorder_base replay_data_;
 
@@ -13,7 +13,9 @@
 	See the COPYING file for more details.
 */
 
+#include <boost/iostreams/filter/bzip2.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
 
 #include "savegame.hpp"
 
@@ -48,7 +50,12 @@
 #include "video.hpp" // only for faked
 
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
 #include <iomanip>
+#include <mutex>
+#include <thread>
+#include <utility>
 
 static lg::log_domain log_engine("engine");
 #define LOG_SAVE LOG_STREAM(info, log_engine)
@@ -59,8 +66,194 @@ static lg::log_domain log_enginerefac("enginerefac");
 
 namespace savegame
 {
+namespace
+{
+/**
+ * Compresses and writes saves on a worker thread, in the order they were queued.
+ *
+ * Each save is first written next to its destination with a ".part" suffix and
+ * then renamed, so an interrupted write never replaces an existing save.
+ */
+class background_save_writer
+{
+public:
+	struct job
+	{
+		std::string dir;
+		std::string filename;
+		/** Uncompressed WML of the save. */
+		std::string data;
+		compression::format compress;
+		std::string error_message;
+	};
+
+	struct result
+	{
+		std::string filename;
+		std::string error_message;
+		/** Empty if the save was written. */
+		std::string error;
+	};
+
+	background_save_writer()
+		: queue_()
+		, done_()
+		, busy_(false)
+		, stopped_(false)
+		, mutex_()
+		, cond_()
+		, worker_()
+	{
+	}
+
+	/** Saves queued before the game exits are still written. */
+	~background_save_writer()
+	{
+		{
+			std::unique_lock lock(mutex_);
+			cond_.wait(lock, [this]() { return queue_.empty() && !busy_; });
+			stopped_ = true;
+		}
+
+		cond_.notify_all();
+		if(worker_.joinable()) {
+			worker_.join();
+		}
+	}
+
+	void add(job&& j)
+	{
+		{
+			std::scoped_lock lock(mutex_);
+			queue_.push_back(std::move(j));
+		}
+
+		if(!worker_.joinable()) {
+			worker_ = std::thread([this]() { run(); });
+		}
+
+		cond_.notify_all();
+	}
+
+	/** Waits for all queued saves and returns the outcome of those written since the last call. */
+	std::vector<result> finish()
+	{
+		std::unique_lock lock(mutex_);
+		cond_.wait(lock, [this]() { return queue_.empty() && !busy_; });
+		return std::exchange(done_, {});
+	}
+
+private:
+	void run()
+	{
+		std::unique_lock lock(mutex_);
+
+		while(true) {
+			cond_.wait(lock, [this]() { return !queue_.empty() || stopped_; });
+
+			if(stopped_) {
+				return;
+			}
+
+			job j = std::move(queue_.front());
+			queue_.pop_front();
+			busy_ = true;
+
+			lock.unlock();
+			std::string error = write(j);
+			lock.lock();
+
+			done_.push_back({std::move(j.filename), std::move(j.error_message), std::move(error)});
+			busy_ = false;
+			cond_.notify_all();
+		}
+	}
+
+	/** Returns an error message, or an empty string on success. */
+	static std::string write(const job& j)
+	{
+		const std::string path = j.dir + "/" + j.filename;
+		const std::string part = path + ".part";
+
+		try {
+			filesystem::scoped_ostream os = filesystem::ostream_file(part);
+
+			if(j.compress == compression::format::none) {
+				*os << j.data;
+			} else {
+				boost::iostreams::filtering_ostream filter;
+				if(j.compress == compression::format::gzip) {
+					filter.push(boost::iostreams::gzip_compressor(boost::iostreams::gzip_params(9)));
+				} else {
+					filter.push(boost::iostreams::bzip2_compressor(boost::iostreams::bzip2_params()));
+				}
+				filter.push(*os);
+
+				// Same trailing newline as config_writer adds to compressed files
+				filter << j.data << "\n";
+			}
+
+			if(!os->good()) {
+				return _("Could not write to file");
+			}
+		} catch(const filesystem::io_exception& e) {
+			return e.what();
+		}
+
+		if(!filesystem::rename_file(part, path)) {
+			filesystem::delete_file(part);
+			return _("Could not write to file");
+		}
+
+		return "";
+	}
+
+	/** Saves not yet picked up by the worker. */
+	std::deque<job> queue_;
+
+	/** Saves written, or failed, since the last call to finish(). */
+	std::vector<result> done_;
+
+	/** Whether the worker is writing a save that's no longer in queue_. */
+	bool busy_;
+
+	bool stopped_;
+
+	std::mutex mutex_;
+	std::condition_variable cond_;
+	std::thread worker_;
+};
+
+/** Constructed on first use, so it's destroyed before the filesystem and logging statics it uses. */
+background_save_writer& background_writer()
+{
+	static background_save_writer writer;
+	return writer;
+}
+} // end anon namespace
+
+void finish_background_saves()
+{
+	const std::vector<background_save_writer::result> results = background_writer().finish();
+	if(results.empty()) {
+		return;
+	}
+
+	auto manager = save_index_class::default_saves_dir();
+	for(const auto& res : results) {
+		if(res.error.empty()) {
+			manager->rebuild(res.filename);
+		} else {
+			ERR_SAVE << res.error_message << res.error;
+			gui2::show_error_message(res.error_message + res.error);
+		}
+	}
+}
+
 bool save_game_exists(std::string name, compression::format compressed)
 {
+	finish_background_saves();
+
 	name += compression::format_extension(compressed);
 	auto manager = save_index_class::default_saves_dir();
 	return filesystem::file_exists(manager->dir() + "/" + name);
@@ -68,6 +261,8 @@ bool save_game_exists(std::string name, compression::format compressed)
 
 void clean_saves(const std::string& label)
 {
+	finish_background_saves();
+
 	const std::string prefix = label + "-" + _("Auto-Save");
 	LOG_SAVE << "Cleaning saves with prefix '" << prefix << "'";
 
@@ -85,6 +280,7 @@ loadgame::loadgame(const std::shared_ptr<save_index_class>& index, saved_game& g
 	, gamestate_(gamestate)
 	, load_data_{index}
 {
+	finish_background_saves();
 }
 
 bool loadgame::show_difficulty_dialog()
@@ -361,6 +557,7 @@ savegame::savegame(saved_game& gamestate, const compression::format compress_sav
 	, error_message_(_("The game could not be saved: "))
 	, show_confirmation_(false)
 	, compress_saves_(compress_saves)
+	, write_in_background_(false)
 {
 }
 
@@ -474,6 +671,8 @@ bool savegame::save_game(const std::string& filename)
 			resources::persist->start_transaction();
 		}
 
+		// Background saves are indexed once they are written, in finish_background_saves().
+		//
 		// Create an entry in the save_index. Doing this here ensures all leader image paths
 		// sre expanded in a context-independent fashion and can appear in the Load Game dialog
 		// even if a campaign-specific sprite is used. This is because the image's full path is
@@ -481,7 +680,9 @@ bool savegame::save_game(const std::string& filename)
 		// a player saves a game and exits the game or reloads the cache, the leader image will
 		// only be available within that specific binary context (when playing another game from
 		// the came campaign, for example).
-		save_index_manager_->rebuild(filename_);
+		if(!write_in_background_) {
+			save_index_manager_->rebuild(filename_);
+		}
 
 		end = SDL_GetTicks();
 		LOG_SAVE << "Milliseconds to save " << filename_ << ": " << end - start;
@@ -508,6 +709,22 @@ void savegame::write_game_to_disk(const std::string& filename)
 	filename_ = filename;
 	filename_ += compression::format_extension(compress_saves_);
 
+	if(write_in_background_) {
+		// Only the serialization needs the game state, compression and disk I/O are left to the worker.
+		std::ostringstream ss;
+		{
+			config_writer out(ss, compression::format::none);
+			write_game(out);
+			finish_save_game(out);
+		}
+
+		background_writer().add({save_index_manager_->dir(), filename_, ss.str(), compress_saves_, error_message_});
+		return;
+	}
+
+	// Keep saves to the same file in order.
+	finish_background_saves();
+
 	std::stringstream ss;
 	{
 		config_writer out(ss, compress_saves_);
@@ -516,7 +733,7 @@ void savegame::write_game_to_disk(const std::string& filename)
 	}
 
 	filesystem::scoped_ostream os(open_save_game(filename_));
-	(*os) << ss.str();
+	(*os) << ss.rdbuf();
 
 	if(!os->good()) {
 		throw game::save_game_failed(_("Could not write to file"));
@@ -604,6 +821,7 @@ autosave_savegame::autosave_savegame(saved_game& gamestate, const compression::f
 	: ingame_savegame(gamestate, compress_saves)
 {
 	set_error_message(_("Could not auto save the game. Please save the game manually."));
+	set_write_in_background();
 }
 
 void autosave_savegame::autosave(const bool disable_autosave, const int autosave_max, const int infinite_autosaves)
@@ -611,10 +829,15 @@ void autosave_savegame::autosave(const bool disable_autosave, const int autosave
 	if(disable_autosave)
 		return;
 
-	save_game_automatic();
+	// Old autosaves are counted on disk, where the previous one has to be by now. The one
+	// about to be written isn't, so keep one less of them.
+	finish_background_saves();
+	if(autosave_max != infinite_autosaves) {
+		auto manager = save_index_class::default_saves_dir();
+		manager->delete_old_auto_saves(std::max(autosave_max - 1, 0), infinite_autosaves);
+	}
 
-	auto manager = save_index_class::default_saves_dir();
-	manager->delete_old_auto_saves(autosave_max, infinite_autosaves);
+	save_game_automatic();
 }
 
 std::string autosave_savegame::create_initial_filename(unsigned int turn_number) const
@@ -666,14 +889,14 @@ void ingame_savegame::write_game(config_writer& out)
 {
 	log_scope("write_game");
 
-	if(!gamestate().get_starting_point().validate_wml()) {
+	if(!gamestate().validate_starting_point()) {
 		throw game::save_game_failed(_("Game state is corrupted"));
 	}
 
 	savegame::write_game(out);
 
 	gamestate().write_carryover(out);
-	out.write_child("snapshot", gamestate().get_starting_point());
+	gamestate().write_starting_point(out);
 	out.write_child("replay_start", gamestate().replay_start());
 	out.open_child("replay");
 	gamestate().get_replay().write(out);
@@ -40,6 +40,12 @@ void convert_old_saves(config& cfg);
  */
 bool save_game_exists(std::string name, compression::format compressed);
 
+/**
+ * Waits until all saves being written in the background are on disk, and updates
+ * the save index for them. Reports saves that could not be written.
+ */
+void finish_background_saves();
+
 /**
  * Delete all autosaves of a certain scenario from the default save directory.
  *
@@ -207,6 +213,9 @@ protected:
 	/** Writing the savegame config to a file. */
 	virtual void write_game(config_writer &out);
 
+	/** Compress and write the file on a background thread, see finish_background_saves(). */
+	void set_write_in_background() { write_in_background_ = true; }
+
 	/** Filename of the savegame file on disk */
 	std::string filename_;
 
@@ -245,6 +254,8 @@ private:
 	bool show_confirmation_; /** Determines if a confirmation of successful saving the game is shown. */
 
 	compression::format compress_saves_; /** Determines, what compression format is used for the savegame file */
+
+	bool write_in_background_; /** Determines if only the serialization is done before save_game returns */
 };
 
 /** Class for "normal" midgame saves. The additional members are needed for creating the snapshot
@@ -105,6 +105,8 @@
 #include "units/map.hpp"  // for unit_map, etc
 #include "units/ptr.hpp"                 // for unit_const_ptr, unit_ptr
 #include "units/types.hpp"    // for unit_type_data, unit_types, etc
+#include "utils/frame_profiler.hpp"
+#include "utils/perf_counter.hpp"
 #include "utils/scope_exit.hpp"
 #include "variable.hpp"                 // for vconfig, etc
 #include "variable_info.hpp"
@@ -120,6 +122,7 @@
 #include <iterator>                     // for distance, advance
 #include <map>                          // for map, map<>::value_type, etc
 #include <new>                          // for operator new
+#include <optional>                     // for optional
 #include <set>                          // for set
 #include <sstream>                      // for operator<<, basic_ostream, etc
 #include <utility>                      // for pair
@@ -478,9 +481,52 @@ int game_lua_kernel::intf_get_displayed_unit(lua_State *L)
 	return 1;
 }
 
+static const char unitFilterKey[] = "unit filter";
+
+static int impl_unit_filter_collect(lua_State* L)
+{
+	unit_filter& filter = *static_cast<unit_filter*>(luaL_checkudata(L, 1, unitFilterKey));
+	filter.~unit_filter();
+	return 0;
+}
+
+/**
+ * Compiles a unit filter, so that it can be used many times without
+ * converting and parsing the WML table each time.
+ * - Arg 1: table containing a filter
+ * - Ret 1: unit filter userdata, accepted by every function taking a unit filter
+ *          through luaW_checkunitfilter.
+ */
+static int intf_compile_unit_filter(lua_State* L)
+{
+	vconfig filter = luaW_checkvconfig(L, 1);
+	new(L) unit_filter(filter);
+	if(luaL_newmetatable(L, unitFilterKey)) {
+		lua_pushcfunction(L, impl_unit_filter_collect);
+		lua_setfield(L, -2, "__gc");
+		lua_pushstring(L, "__metatable");
+		lua_setfield(L, -2, unitFilterKey);
+	}
+	lua_setmetatable(L, -2);
+	return 1;
+}
+
+/**
+ * Gets a unit filter from the stack, either a compiled one or a WML table.
+ * A table is compiled into @a storage, which must outlive the returned reference.
+ */
+static const unit_filter& luaW_checkunitfilter(lua_State* L, int index, std::optional<unit_filter>& storage)
+{
+	if(const unit_filter* filter = static_cast<const unit_filter*>(luaL_testudata(L, index, unitFilterKey))) {
+		return *filter;
+	}
+
+	return storage.emplace(luaW_checkvconfig(L, index, true));
+}
+
 /**
  * Gets all the units matching a given filter.
- * - Arg 1: optional table containing a filter
+ * - Arg 1: optional table containing a filter, or a compiled unit filter
  * - Arg 2: optional location (to find all units that would match on that location)
  *          OR unit (to find all units that would match adjacent to that unit)
  * - Ret 1: table containing full userdata with __index pointing to
@@ -488,8 +534,8 @@ int game_lua_kernel::intf_get_displayed_unit(lua_State *L)
  */
 int game_lua_kernel::intf_get_units(lua_State *L)
 {
-	vconfig filter = luaW_checkvconfig(L, 1, true);
-	unit_filter filt(filter);
+	std::optional<unit_filter> storage;
+	const unit_filter& filt = luaW_checkunitfilter(L, 1, storage);
 	std::vector<const unit*> units;
 
 	if(unit* u_adj = luaW_tounit(L, 2)) {
@@ -525,7 +571,7 @@ int game_lua_kernel::intf_get_units(lua_State *L)
 /**
  * Matches a unit against the given filter.
  * - Arg 1: full userdata.
- * - Arg 2: table containing a filter
+ * - Arg 2: table containing a filter, or a compiled unit filter
  * - Arg 3: optional location OR optional "adjacent" unit
  * - Ret 1: boolean.
  */
@@ -533,13 +579,14 @@ int game_lua_kernel::intf_match_unit(lua_State *L)
 {
 	lua_unit& u = *luaW_checkunit_ref(L, 1);
 
-	vconfig filter = luaW_checkvconfig(L, 2, true);
-
-	if (filter.null()) {
+	if(lua_isnoneornil(L, 2)) {
 		lua_pushboolean(L, true);
 		return 1;
 	}
 
+	std::optional<unit_filter> storage;
+	const unit_filter& filter = luaW_checkunitfilter(L, 2, storage);
+
 	if(unit* u_adj = luaW_tounit(L, 3)) {
 		if(int side = u.on_recall_list()) {
 			WRN_LUA << "wesnoth.units.matches called with a secondary unit (3rd argument), ";
@@ -547,24 +594,24 @@ int game_lua_kernel::intf_match_unit(lua_State *L)
 			WRN_LUA << "Thus the 3rd argument is ignored.";
 			team &t = board().get_team(side);
 			scoped_recall_unit auto_store("this_unit", t.save_id_or_number(), t.recall_list().find_index(u->id()));
-			lua_pushboolean(L, unit_filter(filter).matches(*u, map_location()));
+			lua_pushboolean(L, filter.matches(*u, map_location()));
 			return 1;
 		}
 		if (!u_adj) {
 			return luaL_argerror(L, 3, "unit not found");
 		}
-		lua_pushboolean(L, unit_filter(filter).matches(*u, *u_adj));
+		lua_pushboolean(L, filter.matches(*u, *u_adj));
 	} else if(int side = u.on_recall_list()) {
 		map_location loc;
 		luaW_tolocation(L, 3, loc); // If argument 3 isn't a location, loc is unchanged
 		team &t = board().get_team(side);
 		scoped_recall_unit auto_store("this_unit", t.save_id_or_number(), t.recall_list().find_index(u->id()));
-		lua_pushboolean(L, unit_filter(filter).matches(*u, loc));
+		lua_pushboolean(L, filter.matches(*u, loc));
 		return 1;
 	} else {
 		map_location loc = u->get_location();
 		luaW_tolocation(L, 3, loc); // If argument 3 isn't a location, loc is unchanged
-		lua_pushboolean(L, unit_filter(filter).matches(*u, loc));
+		lua_pushboolean(L, filter.matches(*u, loc));
 	}
 	return 1;
 }
@@ -4616,6 +4663,16 @@ const game_events::queued_event & game_lua_kernel::get_event_info() {
 	return *queued_events_.top();
 }
 
+std::string game_lua_kernel::profiler_context() const
+{
+	// The bottom of the stack is the placeholder for code not run from an event.
+	if(queued_events_.size() <= 1) {
+		return "lua";
+	}
+
+	return "event " + queued_events_.top()->name;
+}
+
 
 game_lua_kernel::game_lua_kernel(game_state & gs, play_controller & pc, reports & reports_object)
 	: lua_kernel_base()
@@ -4633,6 +4690,11 @@ game_lua_kernel::game_lua_kernel(game_state & gs, play_controller & pc, reports
 
 	lua_State *L = mState;
 
+	// Most objects made by game scripts, such as locations and unit proxies,
+	// die young. Generational collection handles that with small, frequent
+	// collections instead of the long incremental cycles that cause hitches.
+	lua_gc(L, LUA_GCGEN, 0, 0);
+
 	cmd_log_ << "Registering game-specific wesnoth lib functions...\n";
 
 	// Put some callback functions in the scripting environment.
@@ -4748,6 +4810,8 @@ game_lua_kernel::game_lua_kernel(game_state & gs, play_controller & pc, reports
 		{"on_board", &intf_on_board},
 		{"on_border", &intf_on_border},
 		{"iter", &intf_terrainmap_iter},
+		{"get_terrains", &intf_terrainmap_get_terrains},
+		{"set_terrains", &intf_terrainmap_set_terrains},
 		// Village operations
 		{"get_owner", &dispatch<&game_lua_kernel::intf_get_village_owner>},
 		{"set_owner", &dispatch<&game_lua_kernel::intf_set_village_owner>},
@@ -4792,6 +4856,7 @@ game_lua_kernel::game_lua_kernel(game_state & gs, play_controller & pc, reports
 		{"add_modification", &intf_add_modification},
 		{"remove_modifications", &intf_remove_modifications},
 		// Static functions
+		{"compile_filter", &intf_compile_unit_filter},
 		{"create", &intf_create_unit},
 		{"find_on_map", &dispatch<&game_lua_kernel::intf_get_units>},
 		{"find_on_recall", &dispatch<&game_lua_kernel::intf_get_recall_units>},
@@ -5066,8 +5131,11 @@ void game_lua_kernel::initialize(const config& level)
 	cmd_log_ << "Running preload scripts...\n";
 
 	game_config::load_config(game_lua_kernel::preload_config);
-	for (const config &cfg : game_lua_kernel::preload_scripts) {
-		run_lua_tag(cfg);
+	{
+		const gc_pause pause(L);
+		for (const config &cfg : game_lua_kernel::preload_scripts) {
+			run_lua_tag(cfg);
+		}
 	}
 	for (const config &cfg : level_lua_.child_range("lua")) {
 		run_lua_tag(cfg);
@@ -5188,6 +5256,8 @@ void game_lua_kernel::save_game(config &cfg)
  */
 bool game_lua_kernel::run_event(const game_events::queued_event& ev)
 {
+	PROFILE_SCOPE("game_lua_kernel::run_event");
+	PERF_TIMER("game_lua_kernel::run_event");
 	lua_State *L = mState;
 
 	if (!luaW_getglobal(L, "wesnoth", "game_events", "on_event"))
@@ -5450,6 +5520,8 @@ void game_lua_kernel::clear_wml_event(int ref)
 
 bool game_lua_kernel::run_wml_event(int ref, const vconfig& args, const game_events::queued_event& ev, bool* out)
 {
+	PROFILE_SCOPE("game_lua_kernel::run_wml_event");
+	PERF_TIMER("game_lua_kernel::run_wml_event");
 	lua_State* L = mState;
 	lua_geti(L, LUA_REGISTRYINDEX, EVENT_TABLE);
 	ON_SCOPE_EXIT(L) {
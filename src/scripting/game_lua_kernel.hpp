@@ -65,6 +65,9 @@ class game_lua_kernel : public lua_kernel_base
 
 	const game_events::queued_event & get_event_info();
 
+	/** Names the WML event being handled, if any. */
+	std::string profiler_context() const override;
+
 	static void extract_preload_scripts(const game_config_view& game_config);
 	static std::vector<config> preload_scripts;
 	static config preload_config;
@@ -210,11 +210,12 @@ static int impl_vconfig_get(lua_State *L)
 
 	if (lua_isnumber(L, 2))
 	{
-		vconfig::all_children_iterator i = v->ordered_begin();
-		unsigned len = std::distance(i, v->ordered_end());
-		unsigned pos = lua_tointeger(L, 2) - 1;
-		if (pos >= len) return 0;
-		std::advance(i, pos);
+		vconfig::all_children_iterator i = v->ordered_begin(), i_end = v->ordered_end();
+		lua_Integer pos = lua_tointeger(L, 2) - 1;
+		if (pos < 0) return 0;
+		// Walk the children only once, instead of counting them first.
+		for (; pos > 0 && i != i_end; --pos) ++i;
+		if (i == i_end) return 0;
 
 		lua_createtable(L, 2, 0);
 		lua_pushstring(L, i.get_key().c_str());
@@ -238,12 +239,17 @@ static int impl_vconfig_get(lua_State *L)
 	if (shallow_literal || strcmp(m, "__shallow_parsed") == 0)
 	{
 		lua_newtable(L);
-		for (const config::attribute &a : v->get_config().attribute_range()) {
-			if (shallow_literal)
+		if (shallow_literal) {
+			for (const config::attribute &a : v->get_config().attribute_range()) {
 				luaW_pushscalar(L, a.second);
-			else
-				luaW_pushscalar(L, v->expand(a.first));
-			lua_setfield(L, -2, a.first.c_str());
+				lua_setfield(L, -2, a.first.c_str());
+			}
+		} else {
+			// Expands each attribute as it is visited, without looking it up again by name.
+			for (const config::attribute &a : v->attribute_range()) {
+				luaW_pushscalar(L, a.second);
+				lua_setfield(L, -2, a.first.c_str());
+			}
 		}
 		vconfig::all_children_iterator i = v->ordered_begin(),
 			i_end = v->ordered_end();
@@ -263,8 +269,10 @@ static int impl_vconfig_get(lua_State *L)
 		return 1;
 	}
 
-	if (v->null() || !v->has_attribute(m)) return 0;
-	luaW_pushscalar(L, (*v)[m]);
+	if (v->null()) return 0;
+	const std::string key = m;
+	if (!v->has_attribute(key)) return 0;
+	luaW_pushscalar(L, v->expand(key));
 	return 1;
 }
 
@@ -27,6 +27,8 @@
 
 #include <algorithm>
 #include <exception>
+#include <map>
+#include <mutex>
 #include <string>
 
 static lg::log_domain log_scripting_lua("scripting/lua");
@@ -246,48 +248,73 @@ int intf_read_file(lua_State *L)
 	return 1;
 }
 
-class lua_filestream
+namespace {
+/**
+ * Compiled Lua files, kept for the rest of the process.
+ *
+ * Each kernel loads the same core and add-on files again. The first load of
+ * a file compiles its source and keeps the bytecode Lua dumps for it; later
+ * loads of the unchanged file load that bytecode, which skips the parser.
+ * Only bytecode dumped here is ever loaded in binary mode, never bytecode
+ * from a file.
+ */
+class lua_chunk_cache
 {
 public:
-	lua_filestream(const std::string& fname)
-		: buff_()
-		, pistream_(filesystem::istream_file(fname))
+	/** Loads a file's contents as a function and pushes it, or an error message, like lua_load. */
+	int load(lua_State* L, const std::string& fname, const std::string& chunkname)
 	{
+		LOG_LUA << "starting to read from " << fname;
+		const std::string source = filesystem::read_file(fname);
+		const std::size_t source_hash = std::hash<std::string>{}(source);
+		const std::string key = chunkname + '\n' + fname;
 
-	}
+		{
+			std::scoped_lock lock(mutex_);
+			auto it = entries_.find(key);
+			if(it != entries_.end() && it->second.source_hash == source_hash) {
+				const std::string& bytecode = it->second.bytecode;
+				return luaL_loadbufferx(L, bytecode.data(), bytecode.size(), chunkname.c_str(), "b");
+			}
+		}
 
-	static const char * lua_read_data(lua_State * /*L*/, void *data, std::size_t *size)
-	{
-		lua_filestream* lfs = static_cast<lua_filestream*>(data);
+		const int res = luaL_loadbufferx(L, source.data(), source.size(), chunkname.c_str(), "t");
+		if(res != LUA_OK) {
+			return res;
+		}
 
-		//int startpos = lfs->pistream_->tellg();
-		lfs->pistream_->read(lfs->buff_, luaL_buffersize);
-		//int newpos = lfs->pistream_->tellg();
-		*size = lfs->pistream_->gcount();
-#if 0
-		ERR_LUA << "read bytes from " << startpos << " to " << newpos << " in total " *size << " from steam";
-		ERR_LUA << "streamstate being "
-			<< " goodbit:" << lfs->pistream_->good()
-			<< " endoffile:" << lfs->pistream_->eof()
-			<< " badbit:" <<  lfs->pistream_->bad()
-			<< " failbit:" << lfs->pistream_->fail();
-#endif
-		return lfs->buff_;
+		entry e{source_hash, {}};
+		if(lua_dump(L, &lua_chunk_cache::write_bytecode, &e.bytecode, 0) == 0) {
+			std::scoped_lock lock(mutex_);
+			entries_.insert_or_assign(key, std::move(e));
+		}
+
+		return res;
 	}
 
-	static int lua_loadfile(lua_State *L, const std::string& fname, const std::string& relativename)
+private:
+	static int write_bytecode(lua_State* /*L*/, const void* data, std::size_t size, void* bytecode)
 	{
-		lua_filestream lfs(fname);
-		//lua uses '@' to know that this is a file (as opposed to something loaded via loadstring )
-		std::string chunkname = '@' + relativename;
-		LOG_LUA << "starting to read from " << fname;
-		return  lua_load(L, &lua_filestream::lua_read_data, &lfs, chunkname.c_str(), "t");
+		static_cast<std::string*>(bytecode)->append(static_cast<const char*>(data), size);
+		return 0;
 	}
-private:
-	char buff_[luaL_buffersize];
-	const std::unique_ptr<std::istream> pistream_;
+
+	struct entry
+	{
+		std::size_t source_hash;
+		std::string bytecode;
+	};
+
+	/** By chunk name and path. */
+	std::map<std::string, entry> entries_;
+
+	/** Map generator kernels may run on another thread. */
+	std::mutex mutex_;
 };
 
+lua_chunk_cache chunk_cache;
+} // end anon namespace
+
 /**
  * Loads a Lua file and pushes the contents on the stack.
  * - Arg 1: string containing the file name.
@@ -304,7 +331,8 @@ int load_file(lua_State *L)
 
 	try
 	{
-		if(lua_filestream::lua_loadfile(L, p, rel)) {
+		//lua uses '@' to know that this is a file (as opposed to something loaded via loadstring )
+		if(chunk_cache.load(L, p, '@' + rel)) {
 			return lua_error(L);
 		}
 	}
@@ -15,6 +15,7 @@
 
 #include "scripting/lua_kernel_base.hpp"
 
+#include "filesystem.hpp"
 #include "game_config.hpp"
 #include "game_errors.hpp"
 #include "gui/core/gui_definition.hpp" // for remove_single_widget_definition
@@ -50,9 +51,13 @@
 #include "utils/markov_generator.hpp"
 #include "utils/context_free_grammar_generator.hpp"
 #include "utils/scope_exit.hpp"
+#include "utils/perf_counter.hpp"
 
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
 #include <exception>
+#include <fstream>
 #include <new>
 #include <string>
 #include <sstream>
@@ -505,6 +510,26 @@ static int intf_ms_since_init(lua_State *L) {
 	return 1;
 }
 
+/**
+ * Returns the engine's performance counters, see the :perf command.
+ * - Ret 1: table mapping each counter that was hit to a table with its
+ *          number of calls and the total time in milliseconds.
+ */
+static int intf_perf_counters(lua_State* L)
+{
+	const auto totals = util::perf_counter::all_totals();
+	lua_createtable(L, 0, totals.size());
+	for(const auto& [name, t] : totals) {
+		lua_createtable(L, 0, 2);
+		lua_pushinteger(L, t.calls);
+		lua_setfield(L, -2, "calls");
+		lua_pushnumber(L, std::chrono::duration<double, std::milli>(t.time).count());
+		lua_setfield(L, -2, "ms");
+		lua_setfield(L, -2, name.c_str());
+	}
+	return 1;
+}
+
 static int intf_get_language(lua_State* L)
 {
 	lua_push(L, get_language().localename);
@@ -705,14 +730,220 @@ int dispatch(lua_State *L) {
 	return ((lua_kernel_base::get_lua_kernel<lua_kernel_base>(L)).*method)(L);
 }
 
+lua_kernel_base::memory_pool::memory_pool()
+	: free_lists_()
+	, chunks_()
+	, chunk_pos_(nullptr)
+	, chunk_end_(nullptr)
+	, bytes_in_use_(0)
+	, allocations_(0)
+	, pooled_allocations_(0)
+{
+	free_lists_.fill(nullptr);
+}
+
+lua_kernel_base::memory_pool::~memory_pool()
+{
+	if(game_config::debug_lua) {
+		PLAIN_LOG << "Lua memory pool: " << allocations_ << " allocations, " << pooled_allocations_
+			<< " from the pool, " << bytes_reserved() / 1024 << " KiB reserved";
+	}
+}
+
+void* lua_kernel_base::memory_pool::pool_alloc(std::size_t size)
+{
+	void*& head = free_lists_[size_class(size)];
+	if(head) {
+		void* res = head;
+		head = *static_cast<void**>(res);
+		return res;
+	}
+
+	const std::size_t block_size = (size_class(size) + 1) * granularity;
+	if(chunk_pos_ == nullptr || static_cast<std::size_t>(chunk_end_ - chunk_pos_) < block_size) {
+		// Whatever is left of the old chunk is too small for this class, and stays unused.
+		chunks_.emplace_back(new char[chunk_size]);
+		chunk_pos_ = chunks_.back().get();
+		chunk_end_ = chunk_pos_ + chunk_size;
+	}
+
+	void* res = chunk_pos_;
+	chunk_pos_ += block_size;
+	return res;
+}
+
+void lua_kernel_base::memory_pool::pool_free(void* ptr, std::size_t size)
+{
+	void*& head = free_lists_[size_class(size)];
+	*static_cast<void**>(ptr) = head;
+	head = ptr;
+}
+
+void* lua_kernel_base::memory_pool::allocate(void* ud, void* ptr, std::size_t osize, std::size_t nsize)
+{
+	memory_pool& pool = *static_cast<memory_pool*>(ud);
+
+	// When ptr is null, osize is the type of the object rather than a size.
+	if(!ptr) {
+		osize = 0;
+	}
+
+	if(nsize == 0) {
+		if(ptr) {
+			if(osize <= max_pooled) {
+				pool.pool_free(ptr, osize);
+			} else {
+				std::free(ptr);
+			}
+		}
+		pool.bytes_in_use_ -= osize;
+		return nullptr;
+	}
+
+	const bool old_pooled = ptr && osize <= max_pooled;
+	const bool new_pooled = nsize <= max_pooled;
+
+	void* res;
+	if(old_pooled && new_pooled && size_class(osize) == size_class(nsize)) {
+		// Same block size, nothing to do.
+		res = ptr;
+	} else if(ptr && !old_pooled && !new_pooled) {
+		res = std::realloc(ptr, nsize);
+		if(!res) {
+			return nullptr;
+		}
+	} else {
+		res = new_pooled ? pool.pool_alloc(nsize) : std::malloc(nsize);
+		if(!res) {
+			return nullptr;
+		}
+
+		if(ptr) {
+			std::memcpy(res, ptr, std::min(osize, nsize));
+			if(old_pooled) {
+				pool.pool_free(ptr, osize);
+			} else {
+				std::free(ptr);
+			}
+		}
+	}
+
+	++pool.allocations_;
+	if(new_pooled) {
+		++pool.pooled_allocations_;
+	}
+
+	pool.bytes_in_use_ += nsize;
+	pool.bytes_in_use_ -= osize;
+	return res;
+}
+
+lua_kernel_base::sampling_profiler::sampling_profiler()
+	: running_(false)
+	, last_sample_()
+	, stacks_()
+{
+}
+
+void lua_kernel_base::sampling_profiler::start(lua_State* L)
+{
+	running_ = true;
+	last_sample_ = std::chrono::steady_clock::now();
+	lua_sethook(L, &hook, LUA_MASKCOUNT, hook_count);
+}
+
+void lua_kernel_base::sampling_profiler::stop(lua_State* L)
+{
+	running_ = false;
+	lua_sethook(L, nullptr, 0, 0);
+}
+
+void lua_kernel_base::sampling_profiler::hook(lua_State* L, lua_Debug*)
+{
+	lua_kernel_base& kernel = get_lua_kernel<lua_kernel_base>(L);
+	kernel.profiler_.sample(L, kernel.profiler_context());
+}
+
+void lua_kernel_base::sampling_profiler::sample(lua_State* L, const std::string& context)
+{
+	const auto now = std::chrono::steady_clock::now();
+	const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - last_sample_);
+	if(elapsed < sample_interval) {
+		return;
+	}
+
+	last_sample_ = now;
+
+	// Frames are listed from the innermost, the folded format wants the outermost first.
+	std::vector<std::string> frames;
+	lua_Debug ar;
+	for(int level = 0; level < max_depth && lua_getstack(L, level, &ar); ++level) {
+		lua_getinfo(L, "Sln", &ar);
+		std::string frame = ar.name ? ar.name : (*ar.what == 'm' ? "main chunk" : "?");
+		frame += ' ';
+		frame += ar.short_src;
+		if(ar.currentline > 0) {
+			frame += ':' + std::to_string(ar.currentline);
+		}
+
+		// Semicolons separate frames.
+		std::replace(frame.begin(), frame.end(), ';', ',');
+		frames.push_back(std::move(frame));
+	}
+
+	std::string stack = context.empty() ? "lua" : context;
+	for(auto i = frames.rbegin(); i != frames.rend(); ++i) {
+		stack += ';';
+		stack += *i;
+	}
+
+	stacks_[stack] += elapsed.count();
+}
+
+bool lua_kernel_base::sampling_profiler::flush(const std::string& file)
+{
+	// Each Lua state only holds its own samples, so only the first of the session starts the file anew.
+	static bool first = true;
+	std::ofstream out(file, first ? std::ios::trunc : std::ios::app);
+	first = false;
+
+	for(const auto& [stack, time] : stacks_) {
+		out << stack << ' ' << time << '\n';
+	}
+
+	stacks_.clear();
+	return static_cast<bool>(out);
+}
+
+std::string lua_kernel_base::profile_file()
+{
+	if(!game_config::lua_profile.empty()) {
+		return game_config::lua_profile;
+	}
+
+	return filesystem::get_user_data_dir() + "/lua-profile.txt";
+}
+
+static int impl_panic(lua_State* L)
+{
+	const char* msg = lua_tostring(L, -1);
+	ERR_LUA << "unprotected error in call to Lua API: " << (msg ? msg : "error object is not a string");
+	return 0;
+}
+
 // Ctor, initialization
 lua_kernel_base::lua_kernel_base()
- : mState(luaL_newstate())
+ : memory_pool_()
+ , profiler_()
+ , mState(lua_newstate(&memory_pool::allocate, &memory_pool_))
  , cmd_log_()
 {
 	get_lua_kernel_base_ptr(mState) = this;
 	lua_State *L = mState;
 
+	// luaL_newstate would have set this.
+	lua_atpanic(L, &impl_panic);
+
 	cmd_log_ << "Initializing " << my_name() << "...\n";
 
 	// Define the CPP_function metatable ( so we can override print to point to a C++ member function, add certain functions for this kernel, etc. )
@@ -783,6 +1014,10 @@ lua_kernel_base::lua_kernel_base()
 		{ "dofile",                   &dispatch<&lua_kernel_base::intf_dofile>           },
 		{ "require",                  &dispatch<&lua_kernel_base::intf_require>          },
 		{ "kernel_type",              &dispatch<&lua_kernel_base::intf_kernel_type>          },
+		{ "memory_stats",             &dispatch<&lua_kernel_base::intf_memory_stats>         },
+		{ "start_profiler",           &dispatch<&lua_kernel_base::intf_profiler_start>       },
+		{ "stop_profiler",            &dispatch<&lua_kernel_base::intf_profiler_stop>        },
+		{ "perf_counters",            &intf_perf_counters            },
 		{ "compile_formula",          &lua_formula_bridge::intf_compile_formula},
 		{ "eval_formula",             &lua_formula_bridge::intf_eval_formula},
 		{ "name_generator",           &intf_name_generator           },
@@ -948,6 +1183,10 @@ lua_kernel_base::lua_kernel_base()
 		lua_setfield(L, -3, function);
 	}
 	lua_pop(L, 1);
+
+	if(!game_config::lua_profile.empty()) {
+		profiler_.start(L);
+	}
 }
 
 lua_kernel_base::~lua_kernel_base()
@@ -955,6 +1194,12 @@ lua_kernel_base::~lua_kernel_base()
 	for (const auto& pair : this->registered_widget_definitions_) {
 		gui2::remove_single_widget_definition(std::get<0>(pair), std::get<1>(pair));
 	}
+	if(profiler_.running()) {
+		profiler_.stop(mState);
+		if(!profiler_.flush(profile_file())) {
+			ERR_LUA << "could not write the Lua profile to " << profile_file();
+		}
+	}
 	lua_close(mState);
 }
 
@@ -1199,6 +1444,57 @@ int lua_kernel_base::intf_kernel_type(lua_State* L)
 	lua_push(L, my_name());
 	return 1;
 }
+
+/**
+ * Returns statistics about the memory used by this Lua state.
+ * - Ret 1: table with the bytes in use, bytes reserved by the pool,
+ *          number of allocations and pooled allocations, and the size
+ *          the garbage collector counts, in KiB.
+ */
+int lua_kernel_base::intf_memory_stats(lua_State* L)
+{
+	lua_createtable(L, 0, 5);
+	lua_pushinteger(L, memory_pool_.bytes_in_use());
+	lua_setfield(L, -2, "in_use");
+	lua_pushinteger(L, memory_pool_.bytes_reserved());
+	lua_setfield(L, -2, "reserved");
+	lua_pushinteger(L, memory_pool_.allocations());
+	lua_setfield(L, -2, "allocations");
+	lua_pushinteger(L, memory_pool_.pooled_allocations());
+	lua_setfield(L, -2, "pooled_allocations");
+	lua_pushinteger(L, lua_gc(L, LUA_GCCOUNT));
+	lua_setfield(L, -2, "gc_kbytes");
+	return 1;
+}
+/**
+ * Starts sampling the Lua code run by this state.
+ */
+int lua_kernel_base::intf_profiler_start(lua_State* L)
+{
+	profiler_.start(L);
+	return 0;
+}
+
+/**
+ * Stops the profiler and writes its samples, see --lua-profile.
+ * - Ret 1: path of the file written, or nil if it could not be written.
+ */
+int lua_kernel_base::intf_profiler_stop(lua_State* L)
+{
+	if(!profiler_.running()) {
+		return 0;
+	}
+
+	profiler_.stop(L);
+	const std::string file = profile_file();
+	if(!profiler_.flush(file)) {
+		return luaL_error(L, "could not write the Lua profile to %s", file.c_str());
+	}
+
+	lua_push(L, file);
+	return 1;
+}
+
 int lua_kernel_base::impl_game_config_get(lua_State* L)
 {
 	char const *m = luaL_checkstring(L, 2);
@@ -1237,11 +1533,26 @@ void lua_kernel_base::load_package()
 	lua_call(L, 1, 0);
 }
 
+lua_kernel_base::gc_pause::gc_pause(lua_State* L)
+	: L_(L)
+	, was_running_(lua_gc(L, LUA_GCISRUNNING) != 0)
+{
+	lua_gc(L_, LUA_GCSTOP);
+}
+
+lua_kernel_base::gc_pause::~gc_pause()
+{
+	if(was_running_) {
+		lua_gc(L_, LUA_GCRESTART);
+	}
+}
+
 void lua_kernel_base::load_core()
 {
 	lua_State* L = mState;
 	lua_settop(L, 0);
 	cmd_log_ << "Loading core...\n";
+	const gc_pause pause(L);
 	luaW_getglobal(L, "wesnoth", "require");
 	lua_pushstring(L, "lua/core");
 	if(!protected_call(1, 1)) {
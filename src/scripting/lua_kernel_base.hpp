@@ -15,13 +15,18 @@
 
 #pragma once
 
+#include <array>
+#include <chrono>
+#include <map>
 #include <sstream>
 #include <string>
 #include <vector>
 #include <functional>
 #include <cstdint>
+#include <memory>
 
 struct lua_State;
+struct lua_Debug;
 class config;
 
 class lua_kernel_base {
@@ -78,6 +83,105 @@ public:
 	virtual uint32_t get_random_seed();
 	lua_State * get_state() { return mState; }
 	void add_widget_definition(const std::string& type, const std::string& id) { registered_widget_definitions_.emplace_back(type, id); }
+
+	/**
+	 * Allocator of the Lua state.
+	 *
+	 * Lua scripts create and drop large numbers of small objects, such as
+	 * location tables and unit proxies. Blocks up to max_pooled bytes are
+	 * served from free lists per size class, carved out of larger chunks, so
+	 * they don't each go through malloc and free. Chunks are only released
+	 * when the state is closed.
+	 */
+	class memory_pool
+	{
+	public:
+		memory_pool();
+		~memory_pool();
+
+		memory_pool(const memory_pool&) = delete;
+		memory_pool& operator=(const memory_pool&) = delete;
+
+		/** lua_Alloc function, with the pool as user data. */
+		static void* allocate(void* ud, void* ptr, std::size_t osize, std::size_t nsize);
+
+		/** Bytes currently allocated by Lua. */
+		std::size_t bytes_in_use() const { return bytes_in_use_; }
+		/** Bytes reserved for the pooled size classes. */
+		std::size_t bytes_reserved() const { return chunks_.size() * chunk_size; }
+		/** Number of allocations, and how many of them were served by the pool. */
+		std::size_t allocations() const { return allocations_; }
+		std::size_t pooled_allocations() const { return pooled_allocations_; }
+
+	private:
+		static const std::size_t granularity = 16;
+		static const std::size_t max_pooled = 256;
+		static const std::size_t chunk_size = 64 * 1024;
+
+		static std::size_t size_class(std::size_t size) { return (size + granularity - 1) / granularity - 1; }
+
+		void* pool_alloc(std::size_t size);
+		void pool_free(void* ptr, std::size_t size);
+
+		/** Heads of the free lists. Each free block starts with a pointer to the next. */
+		std::array<void*, max_pooled / granularity> free_lists_;
+		std::vector<std::unique_ptr<char[]>> chunks_;
+		char* chunk_pos_;
+		char* chunk_end_;
+
+		std::size_t bytes_in_use_;
+		std::size_t allocations_;
+		std::size_t pooled_allocations_;
+	};
+
+	const memory_pool& get_memory_pool() const { return memory_pool_; }
+
+	/**
+	 * Sampling profiler for the Lua code run by this kernel.
+	 *
+	 * A count hook looks at the Lua call stack about every sample_interval and
+	 * charges the time elapsed since the previous sample to that stack. The
+	 * result is written in the folded stack format read by flame graph tools,
+	 * one "outer;...;inner microseconds" line per distinct stack, with the
+	 * profiler_context() of the kernel as outermost frame.
+	 */
+	class sampling_profiler
+	{
+	public:
+		sampling_profiler();
+
+		void start(lua_State* L);
+		void stop(lua_State* L);
+		bool running() const { return running_; }
+
+		/**
+		 * Writes and discards the samples taken so far. The first write of
+		 * the session replaces @a file, later ones append to it.
+		 */
+		bool flush(const std::string& file);
+
+	private:
+		static const int hook_count = 1000;
+		static const int max_depth = 64;
+		static constexpr std::chrono::microseconds sample_interval{1000};
+
+		static void hook(lua_State* L, lua_Debug* ar);
+		void sample(lua_State* L, const std::string& context);
+
+		bool running_;
+		std::chrono::steady_clock::time_point last_sample_;
+		/** Microseconds spent in each folded stack. */
+		std::map<std::string, int64_t> stacks_;
+	};
+
+	/** File the samples of the profiler go to, game_config::lua_profile or a default in the user data directory. */
+	static std::string profile_file();
+
+private:
+	// Declared before mState, as it must outlive it.
+	memory_pool memory_pool_;
+	sampling_profiler profiler_;
+
 protected:
 	lua_State *mState;
 
@@ -128,6 +232,26 @@ protected:
 	bool load_string(char const * prog, const std::string& name, error_handler);
 
 	virtual bool protected_call(int nArgs, int nRets); 	// select default error handler polymorphically
+
+	/**
+	 * Stops the garbage collector until the end of scope.
+	 *
+	 * Used while the core scripts are loaded: nearly everything they create
+	 * stays alive, so collecting during the load would be wasted work.
+	 */
+	class gc_pause
+	{
+	public:
+		explicit gc_pause(lua_State* L);
+		~gc_pause();
+
+		gc_pause(const gc_pause&) = delete;
+		gc_pause& operator=(const gc_pause&) = delete;
+
+	private:
+		lua_State* L_;
+		bool was_running_;
+	};
 	virtual bool load_string(char const * prog, const std::string& name);		// select default error handler polymorphically
 
 	// dofile (using lua_fileops)
@@ -138,6 +262,16 @@ protected:
 
 	int intf_kernel_type(lua_State* L);
 
+	// Lua memory and garbage collector statistics
+	int intf_memory_stats(lua_State* L);
+
+	// Lua sampling profiler
+	int intf_profiler_start(lua_State* L);
+	int intf_profiler_stop(lua_State* L);
+
+	/** What the Lua code is currently run for, as the outermost frame of the profiler samples. */
+	virtual std::string profiler_context() const { return ""; }
+
 	virtual int impl_game_config_get(lua_State* L);
 	virtual int impl_game_config_set(lua_State* L);
 private:
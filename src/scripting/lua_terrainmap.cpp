@@ -236,41 +236,59 @@ static void luaW_push_terrain(lua_State* L, gamemap_base& map, map_location loc)
 	lua_pushstring(L, t_translation::write_terrain_code(t).c_str());
 }
 
-static void impl_merge_terrain(lua_State* L, gamemap_base& map, map_location loc)
+/** A terrain code as assigned to a map hex, with how it is merged into the existing terrain. */
+struct terrain_assignment
 {
-	auto mode = terrain_type_data::BOTH;
+	t_translation::terrain_code code;
+	terrain_type_data::merge_mode mode = terrain_type_data::BOTH;
 	bool replace_if_failed = false;
+};
+
+/**
+ * Reads a terrain code string or a replace_if_failed object.
+ * A code starting or ending with ^ only replaces the overlay or base.
+ */
+static terrain_assignment luaW_checkterrainassignment(lua_State* L, int index)
+{
+	terrain_assignment res;
 	string_view t_str;
-	if(luaL_testudata(L, 3, mapReplaceIfFailedKey)) {
-		replace_if_failed = true;
-		lua_getiuservalue(L, 3, replace_if_failed_idx::CODE);
+	if(luaL_testudata(L, index, mapReplaceIfFailedKey)) {
+		res.replace_if_failed = true;
+		lua_getiuservalue(L, index, replace_if_failed_idx::CODE);
 		t_str = luaL_checkstring(L, -1);
-		lua_getiuservalue(L, 3, replace_if_failed_idx::MODE);
-		mode = terrain_type_data::merge_mode(luaL_checkinteger(L, -1));
+		lua_getiuservalue(L, index, replace_if_failed_idx::MODE);
+		res.mode = terrain_type_data::merge_mode(luaL_checkinteger(L, -1));
+		lua_pop(L, 2);
 	} else {
-		t_str = luaL_checkstring(L, 3);
+		t_str = luaL_checkstring(L, index);
 		if(t_str.front() == '^') {
-			mode = terrain_type_data::OVERLAY;
+			res.mode = terrain_type_data::OVERLAY;
 		} else if(t_str.back() == '^') {
-			mode = terrain_type_data::BASE;
+			res.mode = terrain_type_data::BASE;
 		}
 	}
 
-	auto ter = t_translation::read_terrain_code(t_str);
+	res.code = t_translation::read_terrain_code(t_str);
+	return res;
+}
+
+static void impl_merge_terrain(lua_State* L, gamemap_base& map, map_location loc)
+{
+	terrain_assignment ter = luaW_checkterrainassignment(L, 3);
 
 	if(auto gm = dynamic_cast<gamemap*>(&map)) {
 		if(resources::gameboard) {
-			bool result = resources::gameboard->change_terrain(loc, ter, mode, replace_if_failed);
+			bool result = resources::gameboard->change_terrain(loc, ter.code, ter.mode, ter.replace_if_failed);
 
 			for(team& t : resources::gameboard->teams()) {
 				t.fix_villages(*gm);
 			}
 
-			if(resources::controller) {
-				resources::controller->get_display().needs_rebuild(result);
+			if(resources::controller && result) {
+				resources::controller->get_display().needs_rebuild(loc);
 			}
 		}
-	} else map.set_terrain(loc, ter, mode, replace_if_failed);
+	} else map.set_terrain(loc, ter.code, ter.mode, ter.replace_if_failed);
 }
 
 /**
@@ -425,6 +443,146 @@ int intf_on_border(lua_State* L)
 	return 1;
 }
 
+/**
+ * Reads the hexes addressed by a bulk terrain access, either as a rectangle
+ * (four integers x, y, width, height, walked row by row) or as a list of
+ * locations, starting at @a index.
+ * @return The index of the first argument following the area.
+ */
+static int read_terrain_area(lua_State* L, int index, const gamemap_base& map, std::vector<map_location>& locs)
+{
+	if(lua_isnumber(L, index)) {
+		int x = luaL_checkinteger(L, index);
+		int y = luaL_checkinteger(L, index + 1);
+		int w = luaL_checkinteger(L, index + 2);
+		int h = luaL_checkinteger(L, index + 3);
+		if(!map.on_board_with_border({x, y, wml_loc()}) || !map.on_board_with_border({x + w - 1, y + h - 1, wml_loc()}) || w < 1 || h < 1) {
+			luaL_error(L, "region %d,%d %dx%d is not on the map", x, y, w, h);
+		}
+
+		locs.reserve(w * h);
+		for(int j = y; j < y + h; ++j) {
+			for(int i = x; i < x + w; ++i) {
+				locs.emplace_back(i, j, wml_loc());
+			}
+		}
+
+		return index + 4;
+	}
+
+	luaL_checktype(L, index, LUA_TTABLE);
+	locs.reserve(lua_rawlen(L, index));
+	for(int i = 1, i_end = lua_rawlen(L, index); i <= i_end; ++i) {
+		lua_rawgeti(L, index, i);
+		map_location loc;
+		if(!luaW_tolocation(L, -1, loc) || !map.on_board_with_border(loc)) {
+			luaL_argerror(L, index, "expected a list of locations on the map");
+		}
+
+		locs.push_back(loc);
+		lua_pop(L, 1);
+	}
+
+	return index + 1;
+}
+
+/**
+ * Reads the terrain of many hexes at once.
+ * - Arg 1: map.
+ * - Args 2-5: rectangle x, y, width, height; or Arg 2: list of locations.
+ * - Ret 1: array with, for each hex, the index of its terrain in the palette.
+ * - Ret 2: palette, array of the distinct terrain codes.
+ */
+int intf_terrainmap_get_terrains(lua_State* L)
+{
+	gamemap_base& map = luaW_checkterrainmap(L, 1);
+	std::vector<map_location> locs;
+	read_terrain_area(L, 2, map, locs);
+
+	std::map<t_translation::terrain_code, int> palette;
+	lua_createtable(L, locs.size(), 0);
+	lua_newtable(L);
+	for(std::size_t i = 0; i < locs.size(); ++i) {
+		auto [entry, inserted] = palette.emplace(map.get_terrain(locs[i]), palette.size() + 1);
+		if(inserted) {
+			lua_pushstring(L, t_translation::write_terrain_code(entry->first).c_str());
+			lua_rawseti(L, -2, entry->second);
+		}
+
+		lua_pushinteger(L, entry->second);
+		lua_rawseti(L, -3, i + 1);
+	}
+
+	return 2;
+}
+
+/**
+ * Changes the terrain of many hexes at once. On the game map, villages are
+ * checked and the terrain graphics are rebuilt once for the whole batch.
+ * - Arg 1: map.
+ * - Args 2-5: rectangle x, y, width, height; or Arg 2: list of locations.
+ * - Next arg: array with, for each hex, the index of its new terrain in the palette.
+ * - Next arg: palette, array of terrain codes or replace_if_failed objects,
+ *   interpreted as for map[loc] = terrain.
+ */
+int intf_terrainmap_set_terrains(lua_State* L)
+{
+	gamemap_base& map = luaW_checkterrainmap(L, 1);
+	std::vector<map_location> locs;
+	int index = read_terrain_area(L, 2, map, locs);
+
+	luaL_checktype(L, index, LUA_TTABLE);
+	luaL_checktype(L, index + 1, LUA_TTABLE);
+	if(lua_rawlen(L, index) != locs.size()) {
+		return luaL_argerror(L, index, "expected one terrain index per location");
+	}
+
+	std::vector<terrain_assignment> palette;
+	for(int i = 1, i_end = lua_rawlen(L, index + 1); i <= i_end; ++i) {
+		lua_rawgeti(L, index + 1, i);
+		palette.push_back(luaW_checkterrainassignment(L, -1));
+		lua_pop(L, 1);
+	}
+
+	auto gm = dynamic_cast<gamemap*>(&map);
+	if(gm && !resources::gameboard) {
+		return 0;
+	}
+
+	std::vector<map_location> changed;
+	for(std::size_t i = 0; i < locs.size(); ++i) {
+		lua_rawgeti(L, index, i + 1);
+		lua_Integer p = lua_tointeger(L, -1);
+		lua_pop(L, 1);
+		if(p < 1 || static_cast<std::size_t>(p) > palette.size()) {
+			return luaL_argerror(L, index, "terrain index not in the palette");
+		}
+
+		terrain_assignment& t = palette[p - 1];
+		if(gm) {
+			if(resources::gameboard->change_terrain(locs[i], t.code, t.mode, t.replace_if_failed)) {
+				changed.push_back(locs[i]);
+			}
+		} else {
+			map.set_terrain(locs[i], t.code, t.mode, t.replace_if_failed);
+		}
+	}
+
+	if(gm && !changed.empty()) {
+		for(team& t : resources::gameboard->teams()) {
+			t.fix_villages(*gm);
+		}
+
+		if(resources::controller) {
+			for(const map_location& loc : changed) {
+				resources::controller->get_display().needs_rebuild(loc);
+			}
+		}
+	}
+
+	return 0;
+}
+
 static std::vector<gamemap::overlay_rule> read_rules_vector(lua_State *L, int index)
 {
 	std::vector<gamemap::overlay_rule> rules;
@@ -41,6 +41,16 @@ static const char getunitKey[] = "unit";
 static const char ustatusKey[] = "unit status";
 static const char unitvarKey[] = "unit variables";
 
+/**
+ * User values of a unit proxy holding the proxy sub-tables. These only refer
+ * back to the unit userdata, so they are created once per proxy and reused.
+ */
+enum {
+	unit_status_uservalue = 1,
+	unit_variables_uservalue,
+	unit_attacks_uservalue,
+};
+
 lua_unit::~lua_unit()
 {
 }
@@ -211,11 +221,30 @@ void lua_unit::setmetatable(lua_State *L)
 
 lua_unit* luaW_pushlocalunit(lua_State *L, unit& u)
 {
-	lua_unit* res = new(L) lua_unit(u);
+	lua_unit* res = new(L, lua_unit::uservalue_count) lua_unit(u);
 	lua_unit::setmetatable(L);
 	return res;
 }
 
+/**
+ * Pushes the status or variables table of the unit proxy at index 1, creating
+ * it on first access.
+ */
+static void push_unit_subtable(lua_State *L, int uservalue, const char* key)
+{
+	if(lua_getiuservalue(L, 1, uservalue) != LUA_TNIL) {
+		return;
+	}
+
+	lua_pop(L, 1);
+	lua_createtable(L, 1, 0);
+	lua_pushvalue(L, 1);
+	lua_rawseti(L, -2, 1);
+	luaL_setmetatable(L, key);
+	lua_pushvalue(L, -1);
+	lua_setiuservalue(L, 1, uservalue);
+}
+
 /**
  * Destroys a unit object before it is collected (__gc metamethod).
  */
@@ -297,116 +326,162 @@ static int impl_unit_get(lua_State *L)
 	const unit& u = *pu;
 
 	// Find the corresponding attribute.
-	return_int_attrib("x", u.get_location().wml_x());
-	return_int_attrib("y", u.get_location().wml_y());
-	if(strcmp(m, "loc") == 0) {
-		luaW_pushlocation(L, u.get_location());
-		return 1;
-	}
-	if(strcmp(m, "goto") == 0) {
-		luaW_pushlocation(L, u.get_goto());
-		return 1;
-	}
-	return_int_attrib("side", u.side());
-	return_string_attrib("id", u.id());
-	return_string_attrib("type", u.type_id());
-	return_string_attrib("image_mods", u.effect_image_mods());
-	return_string_attrib("usage", u.usage());
-	return_string_attrib("ellipse", u.image_ellipse());
-	return_string_attrib("halo", u.image_halo());
-	return_int_attrib("hitpoints", u.hitpoints());
-	return_int_attrib("max_hitpoints", u.max_hitpoints());
-	return_int_attrib("experience", u.experience());
-	return_int_attrib("max_experience", u.max_experience());
-	return_int_attrib("recall_cost", u.recall_cost());
-	return_int_attrib("moves", u.movement_left());
-	return_int_attrib("max_moves", u.total_movement());
-	return_int_attrib("max_attacks", u.max_attacks());
-	return_int_attrib("attacks_left", u.attacks_left());
-	return_int_attrib("vision", u.vision());
-	return_int_attrib("jamming", u.jamming());
-	return_tstring_attrib("name", u.name());
-	return_tstring_attrib("description", u.unit_description());
-	return_bool_attrib("canrecruit", u.can_recruit());
-	return_bool_attrib("renamable", !u.unrenamable());
-	return_int_attrib("level", u.level());
-	return_int_attrib("cost", u.cost());
-
-	return_vector_string_attrib("extra_recruit", u.recruits());
-	return_vector_string_attrib("advances_to", u.advances_to());
-
-	if(strcmp(m, "alignment") == 0) {
-		lua_push(L, unit_alignments::get_string(u.alignment()));
-		return 1;
-	}
-
-	if(strcmp(m, "upkeep") == 0) {
-		unit::upkeep_t upkeep = u.upkeep_raw();
-
-		// Need to keep these separate in order to ensure an int value is always used if applicable.
-		if(int* v = utils::get_if<int>(&upkeep)) {
-			lua_push(L, *v);
-		} else {
-			const std::string type = utils::visit(unit::upkeep_type_visitor{}, upkeep);
-			lua_push(L, type);
-		}
+	// Only the attributes starting with the same letter as the key are
+	// compared against it, and anything else is looked up as a method.
+	switch(m[0]) {
+		case '_':
+			return_cfg_attrib("__cfg", u.write(cfg); u.get_location().write(cfg));
+			break;
+		case 'a':
+			return_int_attrib("attacks_left", u.attacks_left());
+			return_vector_string_attrib("advances_to", u.advances_to());
+			if(strcmp(m, "alignment") == 0) {
+				lua_push(L, unit_alignments::get_string(u.alignment()));
+				return 1;
+			}
+			if(strcmp(m, "advancements") == 0) {
+				lua_push(L, u.modification_advancements());
+				return 1;
+			}
+			if(strcmp(m, "abilities") == 0) {
+				lua_push(L, u.get_ability_list());
+				return 1;
+			}
+			if(strcmp(m, "attacks") == 0) {
+				if(lua_getiuservalue(L, 1, unit_attacks_uservalue) == LUA_TNIL) {
+					lua_pop(L, 1);
+					push_unit_attacks_table(L, 1);
+					lua_pushvalue(L, -1);
+					lua_setiuservalue(L, 1, unit_attacks_uservalue);
+				}
+				return 1;
+			}
+			return_vector_string_attrib("animations", u.anim_comp().get_flags());
+			break;
+		case 'c':
+			return_bool_attrib("canrecruit", u.can_recruit());
+			return_int_attrib("cost", u.cost());
+			break;
+		case 'd':
+			return_tstring_attrib("description", u.unit_description());
+			break;
+		case 'e':
+			return_string_attrib("ellipse", u.image_ellipse());
+			return_int_attrib("experience", u.experience());
+			return_vector_string_attrib("extra_recruit", u.recruits());
+			break;
+		case 'f':
+			return_string_attrib("facing", map_location::write_direction(u.facing()));
+			break;
+		case 'g':
+			if(strcmp(m, "goto") == 0) {
+				luaW_pushlocation(L, u.get_goto());
+				return 1;
+			}
+			return_string_attrib("gender", gender_string(u.gender()));
+			break;
+		case 'h':
+			return_string_attrib("halo", u.image_halo());
+			return_int_attrib("hitpoints", u.hitpoints());
+			return_bool_attrib("hidden", u.get_hidden());
+			break;
+		case 'i':
+			return_string_attrib("id", u.id());
+			return_string_attrib("image_mods", u.effect_image_mods());
+			break;
+		case 'j':
+			return_int_attrib("jamming", u.jamming());
+			break;
+		case 'l':
+			if(strcmp(m, "loc") == 0) {
+				luaW_pushlocation(L, u.get_location());
+				return 1;
+			}
+			return_int_attrib("level", u.level());
+			break;
+		case 'm':
+			return_int_attrib("max_hitpoints", u.max_hitpoints());
+			return_int_attrib("max_experience", u.max_experience());
+			return_int_attrib("moves", u.movement_left());
+			return_int_attrib("max_moves", u.total_movement());
+			return_int_attrib("max_attacks", u.max_attacks());
+			break;
+		case 'n':
+			return_tstring_attrib("name", u.name());
+			break;
+		case 'o':
+			if(strcmp(m, "overlays") == 0) {
+				lua_push(L, u.overlays());
+				return 1;
+			}
+			break;
+		case 'p':
+			if(strcmp(m, "petrified") == 0) {
+				deprecated_message("(unit).petrified", DEP_LEVEL::INDEFINITE, {1,17,0}, "use (unit).status.petrified instead");
+				lua_pushboolean(L, u.incapacitated());
+				return 1;
+			}
+			return_string_attrib("portrait", u.big_profile() == u.absolute_image()
+				? u.absolute_image() + u.image_mods() + "~XBRZ(2)"
+				: u.big_profile());
+			break;
+		case 'r':
+			return_int_attrib("recall_cost", u.recall_cost());
+			return_bool_attrib("renamable", !u.unrenamable());
+			return_cfg_attrib("recall_filter", cfg = u.recall_filter());
+			return_bool_attrib("resting", u.resting());
+			return_string_attrib("role", u.get_role());
+			return_string_attrib("race", u.race()->id());
+			break;
+		case 's':
+			return_int_attrib("side", u.side());
+			if(strcmp(m, "status") == 0) {
+				push_unit_subtable(L, unit_status_uservalue, ustatusKey);
+				return 1;
+			}
+			break;
+		case 't':
+			return_string_attrib("type", u.type_id());
+			if(strcmp(m, "traits") == 0) {
+				lua_push(L, u.get_traits_list());
+				return 1;
+			}
+			break;
+		case 'u':
+			return_string_attrib("usage", u.usage());
+			if(strcmp(m, "upkeep") == 0) {
+				unit::upkeep_t upkeep = u.upkeep_raw();
+
+				// Need to keep these separate in order to ensure an int value is always used if applicable.
+				if(int* v = utils::get_if<int>(&upkeep)) {
+					lua_push(L, *v);
+				} else {
+					const std::string type = utils::visit(unit::upkeep_type_visitor{}, upkeep);
+					lua_push(L, type);
+				}
 
-		return 1;
-	}
-	if(strcmp(m, "advancements") == 0) {
-		lua_push(L, u.modification_advancements());
-		return 1;
-	}
-	if(strcmp(m, "overlays") == 0) {
-		lua_push(L, u.overlays());
-		return 1;
-	}
-	if(strcmp(m, "traits") == 0) {
-		lua_push(L, u.get_traits_list());
-		return 1;
-	}
-	if(strcmp(m, "abilities") == 0) {
-		lua_push(L, u.get_ability_list());
-		return 1;
-	}
-	if(strcmp(m, "status") == 0) {
-		lua_createtable(L, 1, 0);
-		lua_pushvalue(L, 1);
-		lua_rawseti(L, -2, 1);
-		luaL_setmetatable(L, ustatusKey);
-		return 1;
-	}
-	if(strcmp(m, "variables") == 0) {
-		lua_createtable(L, 1, 0);
-		lua_pushvalue(L, 1);
-		lua_rawseti(L, -2, 1);
-		luaL_setmetatable(L, unitvarKey);
-		return 1;
-	}
-	if(strcmp(m, "attacks") == 0) {
-		push_unit_attacks_table(L, 1);
-		return 1;
-	}
-	if(strcmp(m, "petrified") == 0) {
-		deprecated_message("(unit).petrified", DEP_LEVEL::INDEFINITE, {1,17,0}, "use (unit).status.petrified instead");
-		lua_pushboolean(L, u.incapacitated());
-		return 1;
+				return 1;
+			}
+			return_string_attrib("undead_variation", u.undead_variation());
+			break;
+		case 'v':
+			return_int_attrib("vision", u.vision());
+			if(strcmp(m, "variables") == 0) {
+				push_unit_subtable(L, unit_variables_uservalue, unitvarKey);
+				return 1;
+			}
+			return_string_attrib("variation", u.variation());
+			break;
+		case 'x':
+			return_int_attrib("x", u.get_location().wml_x());
+			break;
+		case 'y':
+			return_int_attrib("y", u.get_location().wml_y());
+			break;
+		case 'z':
+			return_bool_attrib("zoc", u.get_emit_zoc());
+			break;
 	}
-	return_vector_string_attrib("animations", u.anim_comp().get_flags());
-	return_cfg_attrib("recall_filter", cfg = u.recall_filter());
-	return_bool_attrib("hidden", u.get_hidden());
-	return_bool_attrib("resting", u.resting());
-	return_string_attrib("role", u.get_role());
-	return_string_attrib("race", u.race()->id());
-	return_string_attrib("gender", gender_string(u.gender()));
-	return_string_attrib("variation", u.variation());
-	return_string_attrib("undead_variation", u.undead_variation());
-	return_bool_attrib("zoc", u.get_emit_zoc());
-	return_string_attrib("facing", map_location::write_direction(u.facing()));
-	return_string_attrib("portrait", u.big_profile() == u.absolute_image()
-		? u.absolute_image() + u.image_mods() + "~XBRZ(2)"
-		: u.big_profile());
-	return_cfg_attrib("__cfg", u.write(cfg); u.get_location().write(cfg));
 
 	if(luaW_getglobal(L, "wesnoth", "units", m)) {
 		return 1;
@@ -90,6 +90,8 @@ class lua_unit
 	friend lua_unit* luaW_pushunit(lua_State *L, Args... args);
 	friend lua_unit* luaW_pushlocalunit(lua_State *L, unit& u);
 	static void setmetatable(lua_State *L);
+	/** Number of user values of the proxy, caching its status, variables and attacks tables. */
+	static const int uservalue_count = 3;
 public:
 	lua_unit(std::size_t u): uid(u), ptr(), side(0), c_ptr() {}
 	lua_unit(unit_ptr u): uid(0), ptr(u), side(0), c_ptr() {}
@@ -114,7 +116,7 @@ public:
 
 template<typename... Args>
 inline lua_unit* luaW_pushunit(lua_State *L, Args... args) {
-	lua_unit* lu = new(L) lua_unit(args...);
+	lua_unit* lu = new(L, lua_unit::uservalue_count) lua_unit(args...);
 	lua_unit::setmetatable(L);
 	return lu;
 }
@@ -257,6 +257,8 @@ mapgen_lua_kernel::mapgen_lua_kernel(const config* vars)
 		// Map methods
 		{ "find",                &intf_mg_get_locations            },
 		{ "find_in_radius",      &intf_mg_get_tiles_radius         },
+		{ "get_terrains",        &intf_terrainmap_get_terrains     },
+		{ "set_terrains",        &intf_terrainmap_set_terrains     },
 		// Static functions
 		{ "filter",              &intf_terrainfilter_create        },
 		{ "create",              &intf_terrainmap_create           },
@@ -25,8 +25,11 @@
 #include "xBRZ/xbrz.hpp"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstring>
+#include <future>
+#include <thread>
 
 #include <boost/circular_buffer.hpp>
 #include <boost/math/constants/constants.hpp>
@@ -52,6 +55,25 @@ bool sdl::runtime_at_least(uint8_t major, uint8_t minor, uint8_t patch)
 	return true;
 }
 
+namespace
+{
+/**
+ * Builds a lookup table mapping every 8-bit channel value through @a f,
+ * clamped to [0, 255]. Used by the per-pixel color kernels so the inner
+ * loops don't have to redo the arithmetic and clamping on every channel.
+ */
+template<typename F>
+std::array<uint32_t, 256> make_channel_table(const F& f)
+{
+	std::array<uint32_t, 256> table;
+	for(int c = 0; c < 256; ++c) {
+		table[c] = static_cast<uint32_t>(std::clamp<int>(f(c), 0, 255));
+	}
+
+	return table;
+}
+} // end anon namespace
+
 surface scale_surface_xbrz(const surface & surf, std::size_t z)
 {
 	if(surf == nullptr)
@@ -83,7 +105,38 @@ surface scale_surface_xbrz(const surface & surf, std::size_t z)
 		const_surface_lock src_lock(surf);
 		surface_lock dst_lock(dst);
 
-		xbrz::scale(z, src_lock.pixels(), dst_lock.pixels(), surf->w, surf->h);
+		const uint32_t* src = src_lock.pixels();
+		uint32_t* dst_pixels = dst_lock.pixels();
+		const int width = surf->w;
+		const int height = surf->h;
+
+		// xBRZ supports scaling disjoint row ranges concurrently. Only worth it
+		// for large images like portraits; unit sprites stay on this thread.
+		static const int min_rows_per_slice = 32;
+		const int max_slices = std::max(1u, std::thread::hardware_concurrency());
+		const int slices = width * height >= 128 * 128
+			? std::clamp(height / min_rows_per_slice, 1, max_slices)
+			: 1;
+
+		if(slices == 1) {
+			xbrz::scale(z, src, dst_pixels, width, height);
+		} else {
+			const int rows_per_slice = (height + slices - 1) / slices;
+			std::vector<std::future<void>> workers;
+
+			for(int first = rows_per_slice; first < height; first += rows_per_slice) {
+				const int last = std::min(first + rows_per_slice, height);
+				workers.push_back(std::async(std::launch::async, [=]() {
+					xbrz::scale(z, src, dst_pixels, width, height, xbrz::ScalerCfg(), first, last);
+				}));
+			}
+
+			xbrz::scale(z, src, dst_pixels, width, height, xbrz::ScalerCfg(), 0, rows_per_slice);
+
+			for(auto& worker : workers) {
+				worker.get();
+			}
+		}
 	}
 
 	return dst;
@@ -481,6 +534,28 @@ surface scale_surface_sharp(const surface& surf, int w, int h)
 	return dst;
 }
 
+void adjust_pixels_color(uint32_t* beg, uint32_t* end, int red, int green, int blue)
+{
+	// The clamped per-channel shifts are precomputed once so the pixel loop
+	// reduces to three table lookups.
+	const auto red_table = make_channel_table([red](int c) { return c + red; });
+	const auto green_table = make_channel_table([green](int c) { return c + green; });
+	const auto blue_table = make_channel_table([blue](int c) { return c + blue; });
+
+	while(beg != end) {
+		const uint32_t pixel = *beg;
+
+		if(pixel & 0xFF000000) {
+			*beg = (pixel & 0xFF000000)
+				| (red_table[(pixel >> 16) & 0xFF] << 16)
+				| (green_table[(pixel >> 8) & 0xFF] << 8)
+				| blue_table[pixel & 0xFF];
+		}
+
+		++beg;
+	}
+}
+
 surface adjust_surface_color(const surface &surf, int red, int green, int blue)
 {
 	if(surf == nullptr)
@@ -501,29 +576,38 @@ surface adjust_surface_color(const surface &surf, int red, int green, int blue)
 	{
 		surface_lock lock(nsurf);
 		uint32_t* beg = lock.pixels();
-		uint32_t* end = beg + nsurf->w*surf->h;
-
-		while(beg != end) {
-			uint8_t alpha = (*beg) >> 24;
-
-			if(alpha) {
-				uint8_t r, g, b;
-				r = (*beg) >> 16;
-				g = (*beg) >> 8;
-				b = (*beg) >> 0;
+		adjust_pixels_color(beg, beg + nsurf->w*nsurf->h, red, green, blue);
+	}
 
-				r = std::max<int>(0,std::min<int>(255,static_cast<int>(r)+red));
-				g = std::max<int>(0,std::min<int>(255,static_cast<int>(g)+green));
-				b = std::max<int>(0,std::min<int>(255,static_cast<int>(b)+blue));
+	return nsurf;
+}
 
-				*beg = (alpha << 24) + (r << 16) + (g << 8) + b;
-			}
+void greyscale_pixels(uint32_t* beg, uint32_t* end)
+{
+	while(beg != end) {
+		uint8_t alpha = (*beg) >> 24;
 
-			++beg;
+		if(alpha) {
+			uint8_t r, g, b;
+			r = (*beg) >> 16;
+			g = (*beg) >> 8;
+			b = (*beg);
+			//const uint8_t avg = (red+green+blue)/3;
+
+			// Use the correct formula for RGB to grayscale conversion.
+			// Ok, this is no big deal :)
+			// The correct formula being:
+			// gray=0.299red+0.587green+0.114blue
+			const uint8_t avg = static_cast<uint8_t>((
+				77  * static_cast<uint16_t>(r) +
+				150 * static_cast<uint16_t>(g) +
+				29  * static_cast<uint16_t>(b)  ) / 256);
+
+			*beg = (alpha << 24) | (avg << 16) | (avg << 8) | avg;
 		}
-	}
 
-	return nsurf;
+		++beg;
+	}
 }
 
 surface greyscale_image(const surface &surf)
@@ -540,35 +624,33 @@ surface greyscale_image(const surface &surf)
 	{
 		surface_lock lock(nsurf);
 		uint32_t* beg = lock.pixels();
-		uint32_t* end = beg + nsurf->w*surf->h;
+		greyscale_pixels(beg, beg + nsurf->w*nsurf->h);
+	}
 
-		while(beg != end) {
-			uint8_t alpha = (*beg) >> 24;
+	return nsurf;
+}
 
-			if(alpha) {
-				uint8_t r, g, b;
-				r = (*beg) >> 16;
-				g = (*beg) >> 8;
-				b = (*beg);
-				//const uint8_t avg = (red+green+blue)/3;
-
-				// Use the correct formula for RGB to grayscale conversion.
-				// Ok, this is no big deal :)
-				// The correct formula being:
-				// gray=0.299red+0.587green+0.114blue
-				const uint8_t avg = static_cast<uint8_t>((
-					77  * static_cast<uint16_t>(r) +
-					150 * static_cast<uint16_t>(g) +
-					29  * static_cast<uint16_t>(b)  ) / 256);
-
-				*beg = (alpha << 24) | (avg << 16) | (avg << 8) | avg;
-			}
+void monochrome_pixels(uint32_t* beg, uint32_t* end, const int threshold)
+{
+	while(beg != end) {
+		uint8_t alpha = (*beg) >> 24;
 
-			++beg;
+		if(alpha) {
+			uint8_t r, g, b, result;
+			r = (*beg) >> 16;
+			g = (*beg) >> 8;
+			b = (*beg);
+
+			// first convert the pixel to grayscale
+			// if the resulting value is above the threshold make it black
+			// else make it white
+			result = static_cast<uint8_t>(0.299 * r + 0.587 * g + 0.114 * b) > threshold ? 255 : 0;
+
+			*beg = (alpha << 24) | (result << 16) | (result << 8) | result;
 		}
-	}
 
-	return nsurf;
+		++beg;
+	}
 }
 
 surface monochrome_image(const surface &surf, const int threshold)
@@ -585,30 +667,35 @@ surface monochrome_image(const surface &surf, const int threshold)
 	{
 		surface_lock lock(nsurf);
 		uint32_t* beg = lock.pixels();
-		uint32_t* end = beg + nsurf->w*surf->h;
-
-		while(beg != end) {
-			uint8_t alpha = (*beg) >> 24;
-
-			if(alpha) {
-				uint8_t r, g, b, result;
-				r = (*beg) >> 16;
-				g = (*beg) >> 8;
-				b = (*beg);
+		monochrome_pixels(beg, beg + nsurf->w*nsurf->h, threshold);
+	}
 
-				// first convert the pixel to grayscale
-				// if the resulting value is above the threshold make it black
-				// else make it white
-				result = static_cast<uint8_t>(0.299 * r + 0.587 * g + 0.114 * b) > threshold ? 255 : 0;
+	return nsurf;
+}
 
-				*beg = (alpha << 24) | (result << 16) | (result << 8) | result;
-			}
+void sepia_pixels(uint32_t* beg, uint32_t* end)
+{
+	while(beg != end) {
+		uint8_t alpha = (*beg) >> 24;
 
-			++beg;
+		if(alpha) {
+			uint8_t r, g, b;
+			r = (*beg) >> 16;
+			g = (*beg) >> 8;
+			b = (*beg);
+
+			// this is the formula for applying a sepia effect
+			// that can be found on various web sites
+			// for example here: https://software.intel.com/sites/default/files/article/346220/sepiafilter-intelcilkplus.pdf
+			uint8_t outRed = std::min(255, static_cast<int>((r * 0.393) + (g * 0.769) + (b * 0.189)));
+			uint8_t outGreen = std::min(255, static_cast<int>((r * 0.349) + (g * 0.686) + (b * 0.168)));
+			uint8_t outBlue = std::min(255, static_cast<int>((r * 0.272) + (g * 0.534) + (b * 0.131)));
+
+			*beg = (alpha << 24) | (outRed << 16) | (outGreen << 8) | (outBlue);
 		}
-	}
 
-	return nsurf;
+		++beg;
+	}
 }
 
 surface sepia_image(const surface &surf)
@@ -625,32 +712,36 @@ surface sepia_image(const surface &surf)
 	{
 		surface_lock lock(nsurf);
 		uint32_t* beg = lock.pixels();
-		uint32_t* end = beg + nsurf->w*surf->h;
-
-		while(beg != end) {
-			uint8_t alpha = (*beg) >> 24;
-
-			if(alpha) {
-				uint8_t r, g, b;
-				r = (*beg) >> 16;
-				g = (*beg) >> 8;
-				b = (*beg);
+		sepia_pixels(beg, beg + nsurf->w*nsurf->h);
+	}
 
-				// this is the formula for applying a sepia effect
-				// that can be found on various web sites
-				// for example here: https://software.intel.com/sites/default/files/article/346220/sepiafilter-intelcilkplus.pdf
-				uint8_t outRed = std::min(255, static_cast<int>((r * 0.393) + (g * 0.769) + (b * 0.189)));
-				uint8_t outGreen = std::min(255, static_cast<int>((r * 0.349) + (g * 0.686) + (b * 0.168)));
-				uint8_t outBlue = std::min(255, static_cast<int>((r * 0.272) + (g * 0.534) + (b * 0.131)));
+	return nsurf;
+}
 
-				*beg = (alpha << 24) | (outRed << 16) | (outGreen << 8) | (outBlue);
-			}
+void negative_pixels(uint32_t* beg, uint32_t* end, const int thresholdR, const int thresholdG, const int thresholdB)
+{
+	while(beg != end) {
+		uint8_t alpha = (*beg) >> 24;
 
-			++beg;
+		if(alpha) {
+			uint8_t r, g, b, newR, newG, newB;
+			r = (*beg) >> 16;
+			g = (*beg) >> 8;
+			b = (*beg);
+
+			// invert he channel only if its value is greater than the supplied threshold
+			// this can be used for solarization effects
+			// for a full negative effect, use a value of -1
+			// 255 is a no-op value (doesn't do anything, since a uint8_t cannot contain a greater value than that)
+			newR = r > thresholdR ? 255 - r : r;
+			newG = g > thresholdG ? 255 - g : g;
+			newB = b > thresholdB ? 255 - b : b;
+
+			*beg = (alpha << 24) | (newR << 16) | (newG << 8) | (newB);
 		}
-	}
 
-	return nsurf;
+		++beg;
+	}
 }
 
 surface negative_image(const surface &surf, const int thresholdR, const int thresholdG, const int thresholdB)
@@ -667,33 +758,21 @@ surface negative_image(const surface &surf, const int thresholdR, const int thre
 	{
 		surface_lock lock(nsurf);
 		uint32_t* beg = lock.pixels();
-		uint32_t* end = beg + nsurf->w*surf->h;
-
-		while(beg != end) {
-			uint8_t alpha = (*beg) >> 24;
+		negative_pixels(beg, beg + nsurf->w*nsurf->h, thresholdR, thresholdG, thresholdB);
+	}
 
-			if(alpha) {
-				uint8_t r, g, b, newR, newG, newB;
-				r = (*beg) >> 16;
-				g = (*beg) >> 8;
-				b = (*beg);
+	return nsurf;
+}
 
-				// invert he channel only if its value is greater than the supplied threshold
-				// this can be used for solarization effects
-				// for a full negative effect, use a value of -1
-				// 255 is a no-op value (doesn't do anything, since a uint8_t cannot contain a greater value than that)
-				newR = r > thresholdR ? 255 - r : r;
-				newG = g > thresholdG ? 255 - g : g;
-				newB = b > thresholdB ? 255 - b : b;
+void alpha_to_greyscale_pixels(uint32_t* beg, uint32_t* end)
+{
+	while(beg != end) {
+		uint8_t alpha = (*beg) >> 24;
 
-				*beg = (alpha << 24) | (newR << 16) | (newG << 8) | (newB);
-			}
+		*beg = (0xff << 24) | (alpha << 16) | (alpha << 8) | alpha;
 
-			++beg;
-		}
+		++beg;
 	}
-
-	return nsurf;
 }
 
 surface alpha_to_greyscale(const surface &surf)
@@ -710,18 +789,20 @@ surface alpha_to_greyscale(const surface &surf)
 	{
 		surface_lock lock(nsurf);
 		uint32_t* beg = lock.pixels();
-		uint32_t* end = beg + nsurf->w*surf->h;
+		alpha_to_greyscale_pixels(beg, beg + nsurf->w*nsurf->h);
+	}
 
-		while(beg != end) {
-			uint8_t alpha = (*beg) >> 24;
+	return nsurf;
+}
+
+void wipe_alpha_pixels(uint32_t* beg, uint32_t* end)
+{
+	while(beg != end) {
 
-			*beg = (0xff << 24) | (alpha << 16) | (alpha << 8) | alpha;
+		*beg = 0xff000000 | *beg;
 
-			++beg;
-		}
+		++beg;
 	}
-
-	return nsurf;
 }
 
 surface wipe_alpha(const surface &surf)
@@ -738,14 +819,7 @@ surface wipe_alpha(const surface &surf)
 	{
 		surface_lock lock(nsurf);
 		uint32_t* beg = lock.pixels();
-		uint32_t* end = beg + nsurf->w*surf->h;
-
-		while(beg != end) {
-
-			*beg = 0xff000000 | *beg;
-
-			++beg;
-		}
+		wipe_alpha_pixels(beg, beg + nsurf->w*nsurf->h);
 	}
 
 	return nsurf;
@@ -891,6 +965,36 @@ surface swap_channels_image(const surface& surf, channel r, channel g, channel b
 	return nsurf;
 }
 
+void recolor_pixels(uint32_t* beg, uint32_t* end, const color_range_map& map_rgb)
+{
+	// Sprites are mostly made of runs of identical colors, so remember the
+	// result of the previous lookup instead of hashing every pixel.
+	uint32_t last_rgb = 0;
+	uint32_t last_result = 0;
+	bool have_last = false;
+
+	while(beg != end) {
+		uint8_t alpha = (*beg) >> 24;
+
+		// Don't recolor invisible pixels.
+		if(alpha) {
+			// Palette use only RGB channels, so remove alpha
+			uint32_t oldrgb = (*beg) | 0xFF000000;
+
+			if(!have_last || oldrgb != last_rgb) {
+				auto i = map_rgb.find(color_t::from_argb_bytes(oldrgb));
+				last_rgb = oldrgb;
+				last_result = i != map_rgb.end() ? (i->second.to_argb_bytes() & 0x00FFFFFF) : (oldrgb & 0x00FFFFFF);
+				have_last = true;
+			}
+
+			*beg = (alpha << 24) | last_result;
+		}
+
+		++beg;
+	}
+}
+
 surface recolor_image(surface surf, const color_range_map& map_rgb)
 {
 	if(surf == nullptr)
@@ -908,24 +1012,7 @@ surface recolor_image(surface surf, const color_range_map& map_rgb)
 
 	surface_lock lock(nsurf);
 	uint32_t* beg = lock.pixels();
-	uint32_t* end = beg + nsurf->w*surf->h;
-
-	while(beg != end) {
-		uint8_t alpha = (*beg) >> 24;
-
-		// Don't recolor invisible pixels.
-		if(alpha) {
-			// Palette use only RGB channels, so remove alpha
-			uint32_t oldrgb = (*beg) | 0xFF000000;
-
-			auto i = map_rgb.find(color_t::from_argb_bytes(oldrgb));
-			if(i != map_rgb.end()) {
-				*beg = (alpha << 24) | (i->second.to_argb_bytes() & 0x00FFFFFF);
-			}
-		}
-
-		++beg;
-	}
+	recolor_pixels(beg, beg + nsurf->w*nsurf->h, map_rgb);
 
 	return nsurf;
 }
@@ -949,20 +1036,16 @@ surface brighten_image(const surface &surf, int32_t amount)
 		uint32_t* end = beg + nsurf->w*surf->h;
 
 		if (amount < 0) amount = 0;
-		while(beg != end) {
-			uint8_t alpha = (*beg) >> 24;
-
-			if(alpha) {
-				uint8_t r, g, b;
-				r = (*beg) >> 16;
-				g = (*beg) >> 8;
-				b = (*beg);
+		const auto table = make_channel_table([amount](int c) { return fixed_point_multiply(c, amount); });
 
-				r = std::min<unsigned>(fixed_point_multiply(r, amount),255);
-				g = std::min<unsigned>(fixed_point_multiply(g, amount),255);
-				b = std::min<unsigned>(fixed_point_multiply(b, amount),255);
+		while(beg != end) {
+			const uint32_t pixel = *beg;
 
-				*beg = (alpha << 24) + (r << 16) + (g << 8) + b;
+			if(pixel & 0xFF000000) {
+				*beg = (pixel & 0xFF000000)
+					| (table[(pixel >> 16) & 0xFF] << 16)
+					| (table[(pixel >> 8) & 0xFF] << 8)
+					| table[pixel & 0xFF];
 			}
 
 			++beg;
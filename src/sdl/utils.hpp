@@ -119,6 +119,21 @@ surface sepia_image(const surface &surf);
 surface negative_image(const surface &surf, const int thresholdR, const int thresholdG, const int thresholdB);
 surface alpha_to_greyscale(const surface & surf);
 surface wipe_alpha(const surface & surf);
+
+/*
+ * The per-pixel work of the functions above, applied in place to the
+ * neutral (ARGB8888) pixels in [beg, end). Each pixel is handled on its
+ * own, so a buffer can be processed in any number of pieces.
+ */
+void adjust_pixels_color(uint32_t* beg, uint32_t* end, int r, int g, int b);
+void greyscale_pixels(uint32_t* beg, uint32_t* end);
+void monochrome_pixels(uint32_t* beg, uint32_t* end, const int threshold);
+void sepia_pixels(uint32_t* beg, uint32_t* end);
+void negative_pixels(uint32_t* beg, uint32_t* end, const int thresholdR, const int thresholdG, const int thresholdB);
+void alpha_to_greyscale_pixels(uint32_t* beg, uint32_t* end);
+void wipe_alpha_pixels(uint32_t* beg, uint32_t* end);
+void recolor_pixels(uint32_t* beg, uint32_t* end, const color_range_map& map_rgb);
+
 /** create an heavy shadow of the image, by blurring, increasing alpha and darkening */
 surface shadow_image(const surface &surf, int scale = 1);
 
@@ -40,11 +40,11 @@ window::window(const std::string& title,
 		throw exception("Failed to create a SDL_Window object.", true);
 	}
 
-	if(sdl::runtime_at_least(2,0,10)) {
-		// Rendering in batches (for efficiency) is enabled by default from SDL 2.0.10
-		// The way Wesnoth uses SDL as of September 2019 does not work well with this rendering mode (eg story-only scenarios)
-		SDL_SetHint(SDL_HINT_RENDER_BATCHING, "0");
-	}
+	// Let SDL queue draw calls and submit them in batches. All drawing goes
+	// through the renderer API, so SDL knows when it has to flush: on target
+	// and texture changes, readback and present. This is only the default
+	// when no render driver was forced, so ask for it explicitly.
+	SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1");
 
 	if(!SDL_CreateRenderer(window_, -1, render_flags)) {
 		throw exception("Failed to create a SDL_Renderer object.", true);
@@ -29,6 +29,7 @@
 #include "serialization/string_utils.hpp"
 #include "serialization/tokenizer.hpp"
 #include "serialization/validator.hpp"
+#include "utils/perf_counter.hpp"
 #include "wesconfig.h"
 
 #include <boost/algorithm/string/replace.hpp>
@@ -47,6 +48,7 @@
 #pragma warning(pop)
 #endif
 
+#include <algorithm>
 #include <stack>
 
 static lg::log_domain log_config("config");
@@ -70,10 +72,11 @@ class parser
 	parser& operator=(const parser&) = delete;
 
 public:
-	parser(config& cfg, std::istream& in, abstract_validator* validator = nullptr)
+	parser(config& cfg, std::istream& in, abstract_validator* validator = nullptr, const tag_close_handler& on_close = {})
 		: cfg_(cfg)
 		, tok_(in)
 		, validator_(validator)
+		, on_close_(on_close)
 		, elements()
 	{
 	}
@@ -115,6 +118,7 @@ private:
 	config& cfg_;
 	tokenizer tok_;
 	abstract_validator* validator_;
+	tag_close_handler on_close_;
 
 	std::stack<element> elements;
 };
@@ -280,6 +284,11 @@ void parser::parse_element()
 			validator_->close_tag();
 		}
 
+		if(on_close_) {
+			element& el = elements.top();
+			on_close_(el.name, *el.cfg);
+		}
+
 		elements.pop();
 		break;
 
@@ -497,30 +506,39 @@ void parser::error(const std::string& error_type, const std::string& pos_format)
 // ==================================================================================
 
 /**
- * Copies a string fragment and converts it to a suitable format for WML.
- * (I.e., quotes are doubled.)
+ * Writes a string fragment in a suitable format for WML, without surrounding quotes.
+ * (I.e., quotes are doubled.) The text between quotes is written as is, with no copy.
  */
-std::string escaped_string(const std::string::const_iterator& begin, const std::string::const_iterator& end)
+void write_escaped(std::ostream& out, const std::string::const_iterator& begin, const std::string::const_iterator& end)
 {
-	std::string res;
 	std::string::const_iterator iter = begin;
 
-	while(iter != end) {
-		const char c = *iter;
-		res.append(c == '"' ? 2 : 1, c);
-		++iter;
-	}
+	while(true) {
+		const std::string::const_iterator quote = std::find(iter, end, '"');
 
-	return res;
+		if(quote != iter) {
+			out.write(&*iter, quote - iter);
+		}
+
+		if(quote == end) {
+			return;
+		}
+
+		out << "\"\"";
+		iter = quote + 1;
+	}
 }
 
-/**
- * Copies a string and converts it to a suitable format for WML.
- * (I.e., quotes are doubled.)
- */
-inline std::string escaped_string(const std::string& value)
+/** Writes @a level tabs. */
+void write_indent(std::ostream& out, std::size_t level)
 {
-	return escaped_string(value.begin(), value.end());
+	static const std::string tabs(16, '\t');
+
+	for(; level > tabs.size(); level -= tabs.size()) {
+		out.write(tabs.data(), tabs.size());
+	}
+
+	out.write(tabs.data(), level);
 }
 
 class write_key_val_visitor
@@ -557,7 +575,9 @@ public:
 	void operator()(const std::string& s) const
 	{
 		indent();
-		out_ << key_ << '=' << '"' << escaped_string(s) << '"' << '\n';
+		out_ << key_ << '=' << '"';
+		write_escaped(out_, s.begin(), s.end());
+		out_ << '"' << '\n';
 	}
 
 	void operator()(const t_string& s) const;
@@ -565,9 +585,7 @@ public:
 private:
 	void indent() const
 	{
-		for(unsigned i = 0; i < level_; ++i) {
-			out_ << '\t';
-		}
+		write_indent(out_, level_);
 	}
 
 	std::ostream& out_;
@@ -610,7 +628,9 @@ void write_key_val_visitor::operator()(const t_string& value) const
 			out_ << '_';
 		}
 
-		out_ << '"' << escaped_string(w.begin(), w.end()) << '"';
+		out_ << '"';
+		write_escaped(out_, w.begin(), w.end());
+		out_ << '"';
 		first = false;
 	}
 
@@ -626,17 +646,20 @@ void write_key_val_visitor::operator()(const t_string& value) const
 
 void read(config& cfg, std::istream& in, abstract_validator* validator)
 {
+	// Includes preprocessing, which happens as the stream is read.
+	PERF_TIMER("read");
 	parser(cfg, in, validator)();
 }
 
 void read(config& cfg, const std::string& in, abstract_validator* validator)
 {
+	PERF_TIMER("read");
 	std::istringstream ss(in);
 	parser(cfg, ss, validator)();
 }
 
 template<typename decompressor>
-void read_compressed(config& cfg, std::istream& file, abstract_validator* validator)
+void read_compressed(config& cfg, std::istream& file, abstract_validator* validator, const tag_close_handler& on_close = {})
 {
 	// An empty gzip file seems to confuse boost on MSVC, so return early if this is the case.
 	if(file.peek() == EOF) {
@@ -676,7 +699,7 @@ void read_compressed(config& cfg, std::istream& file, abstract_validator* valida
 		       << "This indicates a malformed gz stream and can make Wesnoth crash.";
 	}
 
-	parser(cfg, filter, validator)();
+	parser(cfg, filter, validator, on_close)();
 }
 
 /** Might throw a std::ios_base::failure especially a gzip_error. */
@@ -685,6 +708,12 @@ void read_gz(config& cfg, std::istream& file, abstract_validator* validator)
 	read_compressed<boost::iostreams::gzip_decompressor>(cfg, file, validator);
 }
 
+/** Might throw a std::ios_base::failure especially a gzip_error. */
+void read_gz(config& cfg, std::istream& file, const tag_close_handler& on_close)
+{
+	read_compressed<boost::iostreams::gzip_decompressor>(cfg, file, nullptr, on_close);
+}
+
 /** Might throw a std::ios_base::failure especially bzip2_error. */
 void read_bz2(config& cfg, std::istream& file, abstract_validator* validator)
 {
@@ -702,12 +731,14 @@ void write_key_val(std::ostream& out,
 
 void write_open_child(std::ostream& out, const std::string& child, unsigned int level)
 {
-	out << std::string(level, '\t') << '[' << child << "]\n";
+	write_indent(out, level);
+	out << '[' << child << "]\n";
 }
 
 void write_close_child(std::ostream& out, const std::string& child, unsigned int level)
 {
-	out << std::string(level, '\t') << "[/" << child << "]\n";
+	write_indent(out, level);
+	out << "[/" << child << "]\n";
 }
 
 static void write_internal(const config& cfg, std::ostream& out, std::string& textdomain, std::size_t tab = 0)
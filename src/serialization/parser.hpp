@@ -20,6 +20,8 @@
 #include "config.hpp"
 #include "configr_assign.hpp"
 
+#include <functional>
+
 class abstract_validator;
 
 // Read data in, clobbering existing data.
@@ -28,6 +30,17 @@ void read(config& cfg, const std::string& in, abstract_validator* validator = nu
 void read_gz(config& cfg, std::istream& in, abstract_validator* validator = nullptr);
 void read_bz2(config& cfg, std::istream& in, abstract_validator* validator = nullptr);
 
+/**
+ * Called by the parser for each WML tag as soon as it is closed.
+ *
+ * It receives the tag name and contents, and may modify the latter, e.g. to
+ * drop data it has already consumed.
+ */
+typedef std::function<void(const std::string& tag, config& cfg)> tag_close_handler;
+
+/** Reads gzipped WML, passing each tag to @a on_close as soon as it is complete. */
+void read_gz(config& cfg, std::istream& in, const tag_close_handler& on_close);
+
 void write(std::ostream& out, const configr_of& cfg, unsigned int level = 0);
 void write_gz(std::ostream& out, const configr_of& cfg);
 void write_bz2(std::ostream& out, const configr_of& cfg);
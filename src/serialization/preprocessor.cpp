@@ -32,8 +32,13 @@
 #include "wesconfig.h"
 #include "deprecation.hpp"
 
-#include <stdexcept>
+#include <atomic>
+#include <condition_variable>
 #include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
 
 static lg::log_domain log_preprocessor("preprocessor");
 #define ERR_PREPROC LOG_STREAM(err, log_preprocessor)
@@ -49,12 +54,18 @@ static const std::string right_curly_str = "RIGHT_BRACE";
 // map associating each filename encountered to a number
 static std::map<std::string, int> file_number_map;
 
+// guards file_number_map, which error reporting may read while preprocess_file_async's worker writes it
+static std::mutex file_number_map_mutex;
+
 static bool encode_filename = true;
 
 static std::string preprocessor_error_detail_prefix = "\n    ";
 
 static const char OUTPUT_SEPARATOR = '\xFE';
 
+static std::atomic<std::size_t> macro_expansion_hits{0};
+static std::atomic<std::size_t> macro_expansion_misses{0};
+
 // get filename associated to this code
 static std::string get_filename(const std::string& file_code)
 {
@@ -67,6 +78,8 @@ static std::string get_filename(const std::string& file_code)
 	int n = 0;
 	s >> std::hex >> n;
 
+	std::scoped_lock lock(file_number_map_mutex);
+
 	for(const auto& p : file_number_map) {
 		if(p.second == n) {
 			return p.first;
@@ -86,6 +99,8 @@ static std::string get_file_code(const std::string& filename)
 	// Current number of encountered filenames
 	static int current_file_number = 0;
 
+	std::scoped_lock lock(file_number_map_mutex);
+
 	int& fnum = file_number_map[utils::escape(filename, " \\")];
 	if(fnum == 0) {
 		fnum = ++current_file_number;
@@ -307,6 +322,28 @@ private:
 // PREPROCESSOR BUFFER
 // ==================================================================================
 
+/**
+ * Results of the macro substitutions done inside macro arguments, by macro,
+ * arguments and textdomain.
+ *
+ * These are expanded into a buffer of their own, which starts without the
+ * location of the call, so the result is the same wherever the call is as long
+ * as the defines don't change. Any #define or #undef therefore empties it.
+ */
+struct macro_expansion_cache
+{
+	macro_expansion_cache()
+		: results()
+		, generation(0)
+	{
+	}
+
+	std::map<std::string, std::string> results;
+
+	/** Incremented whenever the defines change. */
+	unsigned generation;
+};
+
 /**
  * Target for sending preprocessed output.
  * Objects of this class can be plugged into an STL stream.
@@ -314,13 +351,15 @@ private:
 class preprocessor_streambuf : public std::streambuf
 {
 public:
-	preprocessor_streambuf(preproc_map* def)
+	preprocessor_streambuf(preproc_map* def, std::vector<std::string>* included_files, macro_expansion_cache* expansions)
 		: std::streambuf()
 		, out_buffer_("")
 		, buffer_()
 		, preprocessor_queue_()
 		, defines_(def)
 		, default_defines_()
+		, included_files_(included_files)
+		, expansions_(expansions)
 		, textdomain_(PACKAGE)
 		, location_("")
 		, linenum_(0)
@@ -331,6 +370,13 @@ public:
 	/** Decodes the filenames placed in a location. */
 	std::string get_current_file();
 
+	/** To be called after changing #defines_, invalidates the expansions based on them. */
+	void defines_changed()
+	{
+		++expansions_->generation;
+		expansions_->results.clear();
+	}
+
 	void error(const std::string&, int);
 	void warning(const std::string&, int);
 
@@ -364,6 +410,8 @@ private:
 		, preprocessor_queue_()
 		, defines_(t.defines_)
 		, default_defines_()
+		, included_files_(t.included_files_)
+		, expansions_(t.expansions_)
 		, textdomain_(PACKAGE)
 		, location_("")
 		, linenum_(0)
@@ -388,6 +436,11 @@ private:
 	preproc_map* defines_;
 	preproc_map default_defines_;
 
+	/** If set, receives the name of every file and directory read. */
+	std::vector<std::string>* included_files_;
+
+	macro_expansion_cache* expansions_;
+
 	std::string textdomain_;
 	std::string location_;
 
@@ -782,6 +835,10 @@ preprocessor_file::preprocessor_file(preprocessor_streambuf& t, const std::strin
 	, name_(name)
 	, is_directory_(filesystem::is_directory(name))
 {
+	if(parent_.included_files_) {
+		parent_.included_files_->push_back(name);
+	}
+
 	if(is_directory_) {
 		filesystem::get_files_in_dir(name, &files_, nullptr,
 			filesystem::name_mode::ENTIRE_FILE_PATH,
@@ -1317,6 +1374,7 @@ bool preprocessor_data::get_chunk()
 				(*parent_.defines_)[symbol]
 						= preproc_define(buffer, items, optargs, parent_.textdomain_, linenum, parent_.location_,
 						deprecation_detail, deprecation_level, deprecation_version);
+				parent_.defines_changed();
 
 				LOG_PREPROC << "defining macro " << symbol << " (location " << get_location(parent_.location_) << ")";
 			}
@@ -1409,6 +1467,7 @@ bool preprocessor_data::get_chunk()
 			const std::string& symbol = read_word();
 			if(!skipping_) {
 				parent_.defines_->erase(symbol);
+				parent_.defines_changed();
 				LOG_PREPROC << "undefine macro " << symbol << " (location " << get_location(parent_.location_) << ")";
 			}
 		} else if(command == "error") {
@@ -1617,22 +1676,49 @@ bool preprocessor_data::get_chunk()
 				} else {
 					DBG_PREPROC << "substituting (slow) macro " << symbol;
 
-					std::unique_ptr<preprocessor_streambuf> buf(new preprocessor_streambuf(parent_));
+					// Everything the expansion depends on besides the defines, with
+					// the length of each part so that they can't run together.
+					std::ostringstream key;
+					key << symbol.size() << ':' << symbol << parent_.textdomain_.size() << ':' << parent_.textdomain_
+						<< (parent_.quoted_ ? 'q' : 'u');
 
-					// Make the nested preprocessor_data responsible for
-					// restoring our current textdomain if needed.
-					buf->textdomain_ = parent_.textdomain_;
+					for(const auto& argument : *defines) {
+						key << argument.first.size() << ':' << argument.first << argument.second.size() << ':' << argument.second;
+					}
 
-					std::ostringstream res;
-					{
-						std::istream in(buf.get());
-						buf->add_preprocessor<preprocessor_data>(
-							std::move(buffer), val.location, "", val.linenum, dir, val.textdomain, std::move(defines), true);
+					macro_expansion_cache& expansions = *parent_.expansions_;
+					const auto cached = expansions.results.find(key.str());
 
-						res << in.rdbuf();
-					}
+					if(cached != expansions.results.end()) {
+						++macro_expansion_hits;
+						put(cached->second);
+					} else {
+						++macro_expansion_misses;
+
+						std::unique_ptr<preprocessor_streambuf> buf(new preprocessor_streambuf(parent_));
+
+						// Make the nested preprocessor_data responsible for
+						// restoring our current textdomain if needed.
+						buf->textdomain_ = parent_.textdomain_;
 
-					put(res.str());
+						// Macros that change the defines can't be reused.
+						const unsigned generation = expansions.generation;
+
+						std::ostringstream res;
+						{
+							std::istream in(buf.get());
+							buf->add_preprocessor<preprocessor_data>(
+								std::move(buffer), val.location, "", val.linenum, dir, val.textdomain, std::move(defines), true);
+
+							res << in.rdbuf();
+						}
+
+						put(res.str());
+
+						if(expansions.generation == generation) {
+							expansions.results.emplace(key.str(), res.str());
+						}
+					}
 				}
 			} else if(parent_.depth() < 40) {
 				LOG_PREPROC << "Macro definition not found for " << symbol << " , attempting to open as file.";
@@ -1690,8 +1776,9 @@ bool preprocessor_data::get_chunk()
 
 struct preprocessor_scope_helper : std::basic_istream<char>
 {
-	preprocessor_scope_helper(const std::string& fname, preproc_map* defines)
+	preprocessor_scope_helper(const std::string& fname, preproc_map* defines, std::vector<std::string>* included_files)
 		: std::basic_istream<char>(nullptr)
+		, expansions_()
 		, buf_(nullptr)
 		, local_defines_(nullptr)
 	{
@@ -1705,7 +1792,7 @@ struct preprocessor_scope_helper : std::basic_istream<char>
 			defines = local_defines_.get();
 		}
 
-		buf_.reset(new preprocessor_streambuf(defines));
+		buf_.reset(new preprocessor_streambuf(defines, included_files, &expansions_));
 
 		// Begin processing.
 		buf_->add_preprocessor<preprocessor_file>(fname);
@@ -1728,21 +1815,194 @@ struct preprocessor_scope_helper : std::basic_istream<char>
 		rdbuf(nullptr);
 	}
 
+	/** Outlives #buf_, which refers to it. */
+	macro_expansion_cache expansions_;
 	std::unique_ptr<preprocessor_streambuf> buf_;
 	std::unique_ptr<preproc_map> local_defines_;
 };
 
 
+
+// ==================================================================================
+// THREADED PREPROCESSOR PIPE
+// ==================================================================================
+
+/**
+ * Stream buffer fed by a worker thread that drains a preprocessor stream.
+ *
+ * The worker reads the preprocessed data in chunks and queues them; underflow()
+ * hands them to the reader in the same order. Only a handful of chunks are
+ * buffered, so the worker waits for the reader if it gets too far ahead.
+ */
+class preprocessor_pipe_streambuf : public std::streambuf
+{
+public:
+	explicit preprocessor_pipe_streambuf(filesystem::scoped_istream source)
+		: std::streambuf()
+		, source_(std::move(source))
+		, current_()
+		, queue_()
+		, error_()
+		, done_(false)
+		, cancelled_(false)
+		, mutex_()
+		, cond_()
+		, worker_()
+	{
+		// Started last, once all the members it uses exist.
+		worker_ = std::thread([this]() { run(); });
+	}
+
+	~preprocessor_pipe_streambuf()
+	{
+		{
+			std::scoped_lock lock(mutex_);
+			cancelled_ = true;
+		}
+
+		cond_.notify_all();
+		worker_.join();
+	}
+
+private:
+	static const std::size_t chunk_size = 64 * 1024;
+	static const std::size_t max_queued_chunks = 16;
+
+	void run()
+	{
+		try {
+			// Make preprocessor errors propagate instead of just setting the badbit.
+			source_->exceptions(std::ios_base::badbit);
+
+			std::string chunk(chunk_size, '\0');
+
+			while(true) {
+				source_->read(&chunk.front(), chunk_size);
+				const std::size_t count = static_cast<std::size_t>(source_->gcount());
+
+				if(count == 0) {
+					break;
+				}
+
+				std::unique_lock lock(mutex_);
+				cond_.wait(lock, [this]() { return queue_.size() < max_queued_chunks || cancelled_; });
+
+				if(cancelled_) {
+					break;
+				}
+
+				queue_.push_back(chunk.substr(0, count));
+				cond_.notify_all();
+
+				if(count < chunk_size) {
+					break;
+				}
+			}
+		} catch(...) {
+			std::scoped_lock lock(mutex_);
+			error_ = std::current_exception();
+		}
+
+		{
+			std::scoped_lock lock(mutex_);
+			done_ = true;
+		}
+
+		cond_.notify_all();
+	}
+
+	virtual int underflow() override
+	{
+		if(gptr() && gptr() < egptr()) {
+			return traits_type::to_int_type(*gptr());
+		}
+
+		std::unique_lock lock(mutex_);
+		cond_.wait(lock, [this]() { return !queue_.empty() || done_; });
+
+		if(queue_.empty()) {
+			// Everything preprocessed before the error has been read, report it now.
+			if(error_) {
+				std::rethrow_exception(std::exchange(error_, nullptr));
+			}
+
+			return traits_type::eof();
+		}
+
+		current_ = std::move(queue_.front());
+		queue_.pop_front();
+		cond_.notify_all();
+
+		char* begin = &current_.front();
+		setg(begin, begin, begin + current_.size());
+
+		return traits_type::to_int_type(*gptr());
+	}
+
+	/** The preprocessor output, only accessed by the worker. */
+	filesystem::scoped_istream source_;
+
+	/** The chunk currently being read. */
+	std::string current_;
+
+	/** Chunks produced by the worker and not yet read. */
+	std::deque<std::string> queue_;
+
+	/** Exception thrown by the preprocessor, if any. */
+	std::exception_ptr error_;
+
+	bool done_;
+	bool cancelled_;
+
+	std::mutex mutex_;
+	std::condition_variable cond_;
+	std::thread worker_;
+};
+
+struct preprocessor_pipe : std::basic_istream<char>
+{
+	explicit preprocessor_pipe(filesystem::scoped_istream source)
+		: std::basic_istream<char>(nullptr)
+		, buf_(std::move(source))
+	{
+		init(&buf_);
+	}
+
+	~preprocessor_pipe()
+	{
+		clear(std::ios_base::goodbit);
+		exceptions(std::ios_base::goodbit);
+		rdbuf(nullptr);
+	}
+
+	preprocessor_pipe_streambuf buf_;
+};
+
+
 // ==================================================================================
 // FREE-STANDING FUNCTIONS
 // ==================================================================================
 
-filesystem::scoped_istream preprocess_file(const std::string& fname, preproc_map* defines)
+preproc_expansion_stats macro_expansion_stats()
+{
+	return {macro_expansion_hits, macro_expansion_misses};
+}
+
+filesystem::scoped_istream preprocess_file(const std::string& fname, preproc_map* defines, std::vector<std::string>* included_files)
 {
 	log_scope("preprocessing file " + fname + " ...");
 
 	// NOTE: the preprocessor_scope_helper does *not* take ownership of defines.
-	return filesystem::scoped_istream(new preprocessor_scope_helper(fname, defines));
+	return filesystem::scoped_istream(new preprocessor_scope_helper(fname, defines, included_files));
+}
+
+filesystem::scoped_istream preprocess_file_async(const std::string& fname, preproc_map* defines, std::vector<std::string>* included_files)
+{
+	if(std::thread::hardware_concurrency() < 2) {
+		return preprocess_file(fname, defines, included_files);
+	}
+
+	return filesystem::scoped_istream(new preprocessor_pipe(preprocess_file(fname, defines, included_files)));
 }
 
 void preprocess_resource(const std::string& res_name,
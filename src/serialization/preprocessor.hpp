@@ -127,6 +127,17 @@ struct preproc_config
 	};
 };
 
+struct preproc_expansion_stats
+{
+	/** Macro substitutions inside macro arguments that reused an earlier identical expansion. */
+	std::size_t hits;
+	/** Those that had to be expanded. */
+	std::size_t misses;
+};
+
+/** Returns the totals of all the preprocessing done so far. */
+preproc_expansion_stats macro_expansion_stats();
+
 std::string lineno_string(const std::string& lineno);
 
 std::ostream& operator<<(std::ostream& stream, const preproc_map::value_type& def);
@@ -136,10 +147,25 @@ std::ostream& operator<<(std::ostream& stream, const preproc_map::value_type& de
  *
  * @param defines                 A map of symbols defined.
  * @param fname                   The file to be preprocessed.
+ * @param included_files          If set, every file and directory read is
+ *                                appended to it as the output is produced.
  *
  * @returns                       The resulting preprocessed file data.
  */
-filesystem::scoped_istream preprocess_file(const std::string& fname, preproc_map* defines = nullptr);
+filesystem::scoped_istream preprocess_file(const std::string& fname, preproc_map* defines = nullptr,
+		std::vector<std::string>* included_files = nullptr);
+
+/**
+ * Like @ref preprocess_file, but the preprocessor runs on a worker thread and
+ * hands its output over in chunks, so that preprocessing and parsing the result
+ * overlap. The output and the final state of @a defines are identical to
+ * preprocess_file's; errors are rethrown when the reader reaches them.
+ *
+ * @a defines and @a included_files must not be accessed by anyone else until the
+ * returned stream has been destroyed.
+ */
+filesystem::scoped_istream preprocess_file_async(const std::string& fname, preproc_map* defines = nullptr,
+		std::vector<std::string>* included_files = nullptr);
 
 void preprocess_resource(const std::string& res_name,
 		preproc_map* defines_map,
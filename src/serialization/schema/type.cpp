@@ -21,7 +21,9 @@
 #include "serialization/schema/type.hpp"
 
 #include "config.hpp"
+#include <algorithm>
 #include <optional>
+#include <string_view>
 
 struct is_translatable
 {
@@ -82,11 +84,46 @@ std::shared_ptr<wml_type> wml_type::from_config(const config& cfg)
 	return type;
 }
 
+wml_type_simple::wml_type_simple(const std::string& name, const std::string& pattern)
+	: wml_type(name)
+	, pattern_(pattern)
+	, shortcut_(shortcut::none)
+{
+	// In boost's default syntax '.' matches any character, newlines included.
+	if(pattern == ".*") {
+		shortcut_ = shortcut::anything;
+	} else if(pattern == ".+") {
+		shortcut_ = shortcut::non_empty;
+	} else if(pattern == "\\d+") {
+		shortcut_ = shortcut::digits;
+	} else if(pattern == "-?\\d+") {
+		shortcut_ = shortcut::integer;
+	}
+}
+
+static bool all_digits(std::string_view str)
+{
+	return !str.empty() && std::all_of(str.begin(), str.end(), [](char c) { return c >= '0' && c <= '9'; });
+}
+
 bool wml_type_simple::matches(const config_attribute_value& value, const map&) const
 {
 	if(!allow_translatable_ && value.apply_visitor(is_translatable(false))) return false;
-	boost::smatch sub;
-	return boost::regex_match(value.str(), sub, pattern_);
+	if(shortcut_ == shortcut::anything) {
+		return true;
+	}
+
+	const std::string str = value.str();
+	switch(shortcut_) {
+	case shortcut::non_empty:
+		return !str.empty();
+	case shortcut::digits:
+		return all_digits(str);
+	case shortcut::integer:
+		return all_digits(!str.empty() && str.front() == '-' ? std::string_view(str).substr(1) : std::string_view(str));
+	default:
+		return boost::regex_match(str, pattern_);
+	}
 }
 
 bool wml_type_alias::matches(const config_attribute_value& value, const map& type_map) const
@@ -51,10 +51,14 @@ public:
  * This type represents a simple pattern match.
  */
 class wml_type_simple : public wml_type {
+	/** Common patterns that are checked without running the regex. */
+	enum class shortcut { none, anything, non_empty, digits, integer };
+
 	boost::regex pattern_;
+	shortcut shortcut_;
 	bool allow_translatable_ = false;
 public:
-	wml_type_simple(const std::string& name, const std::string& pattern) : wml_type(name), pattern_(pattern) {}
+	wml_type_simple(const std::string& name, const std::string& pattern);
 	bool matches(const config_attribute_value& value, const map& type_map) const override;
 	void allow_translatable() {allow_translatable_ =  true;}
 };
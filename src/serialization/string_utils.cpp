@@ -98,6 +98,15 @@ std::set<std::string> split_set(std::string_view s, char sep, const int flags)
 	return res;
 }
 
+std::vector<std::string_view> split_view(std::string_view s, const char sep, const int flags)
+{
+	std::vector<std::string_view> res;
+	split_foreach(s, sep, flags, [&](std::string_view item) {
+		res.push_back(item);
+	});
+	return res;
+}
+
 std::vector<std::string> square_parenthetical_split(const std::string& val,
 		const char separator, const std::string& left,
 		const std::string& right,const int flags)
@@ -822,11 +831,11 @@ std::vector<std::string> quoted_split(const std::string& val, char c, int flags,
 	return res;
 }
 
-std::pair<int, int> parse_range(const std::string& str)
+std::pair<int, int> parse_range(std::string_view str)
 {
-	const std::string::const_iterator dash = std::find(str.begin(), str.end(), '-');
-	const std::string a(str.begin(), dash);
-	const std::string b = dash != str.end() ? std::string(dash + 1, str.end()) : a;
+	const std::size_t dash = str.find('-');
+	const std::string a(str.substr(0, dash));
+	const std::string b = dash != std::string_view::npos ? std::string(str.substr(dash + 1)) : a;
 	std::pair<int,int> res {0,0};
 	try {
 		if (b == "infinity") {
@@ -100,6 +100,12 @@ void split_foreach(std::string_view s, char sep, const int flags, const F& f)
 std::vector<std::string> split(std::string_view val, const char c = ',', const int flags = REMOVE_EMPTY | STRIP_SPACES);
 std::set<std::string> split_set(std::string_view val, const char c = ',', const int flags = REMOVE_EMPTY | STRIP_SPACES);
 
+/**
+ * Like split(), but the pieces are views into @a val instead of copies.
+ * They are only valid as long as the string @a val refers to.
+ */
+std::vector<std::string_view> split_view(std::string_view val, const char c = ',', const int flags = REMOVE_EMPTY | STRIP_SPACES);
+
 /**
  * This function is identical to split(), except it does not split when it otherwise would if the
  * previous character was identical to the parameter 'quote' (i.e. it does not split quoted commas).
@@ -282,7 +288,7 @@ std::string bullet_list(const T& v, std::size_t indent = 4, const std::string& b
  */
 std::string indent(const std::string& string, std::size_t indent_size = 4);
 
-std::pair<int, int> parse_range(const std::string& str);
+std::pair<int, int> parse_range(std::string_view str);
 
 std::vector<std::pair<int, int>> parse_ranges(const std::string& str);
 
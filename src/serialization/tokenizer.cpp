@@ -97,6 +97,7 @@ const token &tokenizer::next_token()
 				break;
 			}
 			token_.value += current_;
+			append_run(token_.value, [](int c) { return c != '>' && c != '\n' && c != '\r'; });
 		}
 		break;
 
@@ -118,6 +119,7 @@ const token &tokenizer::next_token()
 				continue;
 			}
 			token_.value += current_;
+			append_run(token_.value, [](int c) { return c != '"' && c != 254 && c != '\n' && c != '\r'; });
 		}
 		break;
 
@@ -139,6 +141,7 @@ const token &tokenizer::next_token()
 			token_.type = token::STRING;
 			do {
 				token_.value += current_;
+				append_run(token_.value, [this](int c) { return is_alnum(c) || c == '$'; });
 				next_char_fast();
 				while (current_ == 254) {
 					skip_comment();
@@ -206,6 +209,7 @@ void tokenizer::skip_comment()
 	dst->clear();
 	while (current_ != '\n' && current_ != EOF) {
 		*dst += current_;
+		append_run(*dst, [](int c) { return c != '\n' && c != '\r'; });
 		next_char_fast();
 	}
 }
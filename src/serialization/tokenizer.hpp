@@ -22,6 +22,7 @@
 
 #include <istream>
 #include <string>
+#include <string_view>
 
 struct token
 {
@@ -130,6 +131,36 @@ private:
 		return in_.peek();
 	}
 
+	/**
+	 * Appends the characters following the current one to @a dst for as long
+	 * as @a accept returns true for them, copying whole runs from the input
+	 * buffer instead of going through next_char_fast() for each of them.
+	 * The current character is left unchanged; the next call to next_char()
+	 * or next_char_fast() reads the first rejected character.
+	 *
+	 * @a accept must reject '\r', '\n', and 254 since their handling needs
+	 * next_char() and skip_comment().
+	 */
+	template<typename Accept>
+	void append_run(std::string& dst, Accept accept)
+	{
+		while(true) {
+			const std::string_view buffer = in_.peek_buffer();
+			std::size_t count = 0;
+
+			while(count < buffer.size() && accept(static_cast<unsigned char>(buffer[count]))) {
+				++count;
+			}
+
+			dst.append(buffer.data(), count);
+			in_.skip(count);
+
+			if(count < buffer.size() || buffer.empty()) {
+				return;
+			}
+		}
+	}
+
 	enum
 	{
 		TOK_NONE = 0,
@@ -26,7 +26,10 @@
 
 #include "log.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <limits>
 
 static lg::log_domain log_engine("engine");
@@ -49,18 +52,79 @@ static int byte_size_from_utf8_first(const unsigned char ch)
 	return count;
 }
 
+/**
+ * Number of leading US-ASCII bytes in [@a first, @a last).
+ * Checks eight bytes at a time, as most text is plain ASCII.
+ */
+static std::size_t ascii_prefix(const char* first, const char* last)
+{
+	const char* p = first;
+
+	for(; last - p >= 8; p += 8) {
+		std::uint64_t word;
+		std::memcpy(&word, p, sizeof(word));
+		if(word & 0x8080808080808080ull) {
+			break;
+		}
+	}
+
+	while(p != last && !(static_cast<unsigned char>(*p) & 0x80)) {
+		++p;
+	}
+
+	return p - first;
+}
+
+/**
+ * Moves the byte offset @a pos in @a str forward by up to @a count code points.
+ *
+ * @returns The number of code points passed, which is less than @a count
+ *          if the end of the string or invalid UTF-8 was reached first.
+ */
+static std::size_t advance(const std::string& str, std::size_t& pos, const std::size_t count)
+{
+	const std::size_t len = str.size();
+	std::size_t chr = 0;
+
+	try {
+		while(chr < count && pos < len) {
+			if(!(static_cast<unsigned char>(str[pos]) & 0x80)) {
+				// A run of US-ASCII is one code point per byte.
+				const char* first = str.data() + pos;
+				const std::size_t ascii = ascii_prefix(first, first + std::min(len - pos, count - chr));
+				pos += ascii;
+				chr += ascii;
+			} else {
+				pos += byte_size_from_utf8_first(str[pos]);
+				++chr;
+			}
+		}
+	} catch(const invalid_utf8_exception&) {
+		ERR_GENERAL << "Invalid UTF-8 string.";
+	}
+
+	// A truncated sequence at the end must not point past the string.
+	pos = std::min(pos, len);
+	return chr;
+}
+
 std::string lowercase(const std::string& s)
 {
 	if(!s.empty()) {
 		utf8::iterator itor(s);
 		std::string res;
+		res.reserve(s.size());
 
 		for(;itor != utf8::iterator::end(s); ++itor) {
 			char32_t uchar = *itor;
 			// If wchar_t is less than 32 bits wide, we cannot apply towlower() to all codepoints
 			if(uchar <= static_cast<char32_t>(std::numeric_limits<wchar_t>::max()))
 				uchar = towlower(static_cast<wchar_t>(uchar));
-			res += unicode_cast<std::string>(uchar);
+			if(uchar < 0x80) {
+				res += static_cast<char>(uchar);
+			} else {
+				res += unicode_cast<std::string>(uchar);
+			}
 		}
 
 		res.append(itor.substr().second, s.end());
@@ -71,30 +135,16 @@ std::string lowercase(const std::string& s)
 
 std::size_t index(const std::string& str, const std::size_t index)
 {
-	// chr counts characters, i is the codepoint index
 	// remark: several functions rely on the fallback to str.length()
-	unsigned int i = 0, len = str.size();
-	try {
-		for (unsigned int chr=0; chr<index && i<len; ++chr) {
-			i += byte_size_from_utf8_first(str[i]);
-		}
-	} catch(const invalid_utf8_exception&) {
-		ERR_GENERAL << "Invalid UTF-8 string.";
-	}
-	return i;
+	std::size_t pos = 0;
+	advance(str, pos, index);
+	return pos;
 }
 
 std::size_t size(const std::string& str)
 {
-	unsigned int chr, i = 0, len = str.size();
-	try {
-		for (chr=0; i<len; ++chr) {
-			i += byte_size_from_utf8_first(str[i]);
-		}
-	} catch(const invalid_utf8_exception&) {
-		ERR_GENERAL << "Invalid UTF-8 string.";
-	}
-	return chr;
+	std::size_t pos = 0;
+	return advance(str, pos, std::string::npos);
 }
 
 std::string& insert(std::string& str, const std::size_t pos, const std::string& insert)
@@ -104,14 +154,17 @@ std::string& insert(std::string& str, const std::size_t pos, const std::string&
 
 std::string& erase(std::string& str, const std::size_t start, const std::size_t len)
 {
-	if (start > size(str)) return str;
-	unsigned pos = index(str, start);
+	std::size_t pos = 0;
+	if (advance(str, pos, start) < start) return str;
 
 	if (len == std::string::npos) {
 		// without second argument, std::string::erase truncates
 		return str.erase(pos);
 	} else {
-		return str.erase(pos, index(str,start+len) - pos);
+		// Continue from the start instead of walking the string again.
+		std::size_t end = pos;
+		advance(str, end, len);
+		return str.erase(pos, end - pos);
 	}
 }
 
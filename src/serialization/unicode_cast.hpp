@@ -65,6 +65,8 @@ typename ucs4_convert_impl::enableif<TD, typename TS::value_type>::type unicode_
 	typedef typename TS::const_iterator input_itor;
 
 	TD res;
+	// Exact for ASCII, the common case, and avoids regrowing otherwise.
+	res.reserve(source.size());
 	try
 	{
 		output_itor inserter(res);
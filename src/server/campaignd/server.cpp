@@ -217,6 +217,30 @@ inline std::string index_from_full_pack_filename(std::string pack_fn)
 	return pack_fn;
 }
 
+/**
+ * Returns the blob store filename for the specified file hash.
+ *
+ * @a hash is in the form used by index files, see write_hashlist(). The
+ * filename is in the form @p "<XX>/<CONTENTS_MD5>.gz", where XX are the first
+ * two digits of the hex digest.
+ */
+std::string make_blob_filename(const std::string& hash)
+{
+	static const char hex_digits[] = "0123456789abcdef";
+
+	std::string hex;
+	for(uint8_t byte : crypt64::decode(hash)) {
+		hex += hex_digits[byte >> 4];
+		hex += hex_digits[byte & 0xF];
+	}
+
+	if(hex.size() < 2) {
+		return {};
+	}
+
+	return hex.substr(0, 2) + '/' + hex + ".gz";
+}
+
 /**
  * Returns @a false if @a cfg is null or empty.
  */
@@ -279,11 +303,16 @@ server::server(const std::string& cfg_file, unsigned short port)
 	, capabilities_(cap_defaults)
 	, addons_()
 	, dirty_addons_()
+	, catalog_entries_()
+	, catalogs_()
+	, indexes_()
+	, catalog_revision_(0)
 	, cfg_()
 	, cfg_file_(cfg_file)
 	, read_only_(false)
 	, compress_level_(0)
 	, update_pack_lifespan_(0)
+	, blob_dir_()
 	, strict_versions_(true)
 	, hooks_()
 	, handlers_()
@@ -346,6 +375,7 @@ void server::load_config()
 	compress_level_ = cfg_["compress_level"].to_int(6);
 	// One month probably will be fine (#TODO: testing needed)
 	update_pack_lifespan_ = cfg_["update_pack_lifespan"].to_time_t(30 * 24 * 60 * 60);
+	blob_dir_ = cfg_["blob_dir"].str("blobs");
 
 	if(const auto& svinfo_cfg = server_info()) {
 		server_id_ = svinfo_cfg["id"].str();
@@ -400,6 +430,8 @@ void server::load_config()
 
 	//Loading addons
 	addons_.clear();
+	catalog_entries_.clear();
+	++catalog_revision_;
 	std::vector<std::string> legacy_addons, dirs;
 	filesystem::get_files_in_dir("data", &legacy_addons, &dirs);
 	config meta;
@@ -588,6 +620,9 @@ void server::handle_read_from_fifo(const boost::system::error_code& error, std::
 			LOG_CS << "deleting add-on '" << addon_id << "' requested from control FIFO";
 			delete_addon(addon_id);
 		}
+	} else if(ctl == "collect_blobs") {
+		LOG_CS << "Collecting unreferenced blobs...";
+		collect_blobs();
 	} else if(ctl == "hide" || ctl == "unhide") {
 		if(ctl.args_count() != 1) {
 			ERR_CS << "Incorrect number of arguments for '" << ctl.cmd() << "'";
@@ -911,7 +946,12 @@ void server::delete_addon(const std::string& id)
 		       << "' (" << fn << "): " << strerror(errno);
 	}
 
+	for(auto iter = indexes_.lower_bound(fn + '/'); iter != indexes_.end() && iter->first.compare(0, fn.size() + 1, fn + '/') == 0;) {
+		iter = indexes_.erase(iter);
+	}
+
 	addons_.erase(id);
+	invalidate_catalog(id);
 	write_config();
 
 	fire("hook_post_erase", id);
@@ -919,6 +959,318 @@ void server::delete_addon(const std::string& id)
 	LOG_CS << "Deleted add-on '" << id << "'";
 }
 
+void server::store_blobs(const config& data)
+{
+	for(const config& f : data.child_range("file")) {
+		const auto& contents = f["contents"].str();
+		const auto& blob_path = blob_dir_ + '/' + make_blob_filename(utils::md5(contents).base64_digest());
+
+		if(filesystem::file_exists(blob_path)) {
+			continue;
+		}
+
+		filesystem::atomic_commit blob_file{blob_path};
+		config_writer{*blob_file.ostream(), true, compress_level_}.write(config{"contents", contents});
+		blob_file.commit();
+	}
+
+	for(const config& d : data.child_range("dir")) {
+		store_blobs(d);
+	}
+}
+
+bool server::load_blobs(config& data, bool keep_hashes)
+{
+	for(config& f : data.child_range("file")) {
+		const auto& blob_path = blob_dir_ + '/' + make_blob_filename(f["hash"].str());
+
+		config blob;
+		if(filesystem::file_exists(blob_path)) {
+			auto in = filesystem::istream_file(blob_path);
+			read_gz(blob, *in);
+		}
+
+		if(!blob.has_attribute("contents")) {
+			ERR_CS << "Missing blob for file '" << f["name"].str() << "' (" << blob_path << ")";
+			return false;
+		}
+
+		f["contents"] = blob["contents"];
+
+		if(!keep_hashes) {
+			f.remove_attribute("hash");
+		}
+	}
+
+	for(config& d : data.child_range("dir")) {
+		if(!load_blobs(d, keep_hashes)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+std::string server::get_full_pack(const config& addon, const config& version_cfg)
+{
+	const auto& pack_path = addon["filename"].str() + '/' + version_cfg["filename"].str();
+
+	if(filesystem::file_exists(pack_path) || !version_cfg["blobs"].to_bool()) {
+		return pack_path;
+	}
+
+	LOG_CS << "Rebuilding full pack for '" << addon["name"].str() << "' version " << version_cfg["version"].str() << "...";
+
+	config pack;
+	{
+		auto in = filesystem::istream_file(index_from_full_pack_filename(pack_path));
+		read_gz(pack, *in);
+	}
+
+	if(pack.empty() || !load_blobs(pack, false)) {
+		ERR_CS << "Unable to rebuild the full pack for '" << addon["name"].str() << "' version " << version_cfg["version"].str();
+		return {};
+	}
+
+	filesystem::atomic_commit pack_file{pack_path};
+	config_writer{*pack_file.ostream(), true, compress_level_}.write(pack);
+	pack_file.commit();
+
+	return pack_path;
+}
+
+std::string server::get_update_pack(config& addon, const config& from_cfg, const config& to_cfg)
+{
+	const auto& from_version = from_cfg["version"].str();
+	const auto& to_version = to_cfg["version"].str();
+	const auto& pathstem = addon["filename"].str();
+
+	for(const config& pack_info : addon.child_range("update_pack")) {
+		if(pack_info["from"].str() == from_version && pack_info["to"].str() == to_version) {
+			const auto& cached_path = pathstem + '/' + pack_info["filename"].str();
+			if(filesystem::file_exists(cached_path)) {
+				return cached_path;
+			}
+		}
+	}
+
+	LOG_CS << "Generating update pack for '" << addon["name"].str() << "' version " << from_version << " -> " << to_version << "...";
+
+	config pack;
+
+	if(from_cfg["blobs"].to_bool() && to_cfg["blobs"].to_bool()) {
+		// The indexes carry the same hashes the full packs would have, so
+		// only the files that changed need to be read from the blob store.
+		config from, to;
+
+		// Copied, since reading the second one may drop the first from the cache
+		if(const addon_index* index = get_index(pathstem + '/' + index_from_full_pack_filename(from_cfg["filename"].str()))) {
+			from = index->files;
+		}
+		if(const addon_index* index = get_index(pathstem + '/' + index_from_full_pack_filename(to_cfg["filename"].str()))) {
+			to = index->files;
+		}
+
+		if(from.empty() || to.empty()) {
+			ERR_CS << "Missing index files for '" << addon["name"].str() << "' version " << from_version << " -> " << to_version;
+			return {};
+		}
+
+		make_updatepack(pack, from, to);
+
+		if(!load_blobs(pack.child("addlist"), true)) {
+			return {};
+		}
+	} else {
+		const auto& from_path = get_full_pack(addon, from_cfg);
+		const auto& to_path = get_full_pack(addon, to_cfg);
+
+		if(filesystem::file_size(from_path) <= 0 || filesystem::file_size(to_path) <= 0) {
+			ERR_CS << "Unable to generate an update pack for '" << addon["name"].str()
+					<< "' for version " << from_version << " to " << to_version;
+			return {};
+		}
+
+		config from, to;
+
+		filesystem::scoped_istream in = filesystem::istream_file(from_path);
+		read_gz(from, *in);
+		in = filesystem::istream_file(to_path);
+		read_gz(to, *in);
+
+		make_updatepack(pack, from, to);
+	}
+
+	const auto& update_pack_fn = make_update_pack_filename(from_version, to_version);
+
+	{
+		filesystem::atomic_commit pack_file{pathstem + '/' + update_pack_fn};
+		config_writer{*pack_file.ostream(), true, compress_level_}.write(pack);
+		pack_file.commit();
+	}
+
+	addon.remove_children("update_pack", [&update_pack_fn](const config& p) {
+		return p["filename"].str() == update_pack_fn;
+	});
+
+	config& pack_info = addon.add_child("update_pack");
+	pack_info["from"] = from_version;
+	pack_info["to"] = to_version;
+	pack_info["expire"] = std::time(nullptr) + update_pack_lifespan_;
+	pack_info["filename"] = update_pack_fn;
+
+	mark_dirty(addon["name"].str());
+
+	return pathstem + '/' + update_pack_fn;
+}
+
+const server::addon_index* server::get_index(const std::string& path)
+{
+	// Indexes are small, but there is one for every version of every add-on
+	static const std::size_t max_indexes = 4096;
+
+	if(auto iter = indexes_.find(path); iter != indexes_.end()) {
+		return &iter->second;
+	}
+
+	const std::string compressed = filesystem::read_file(path);
+	if(compressed.empty()) {
+		return nullptr;
+	}
+
+	addon_index index;
+	try {
+		std::istringstream in(compressed);
+		read_gz(index.files, in);
+		index.doc = encode_compressed(simple_wml::string_span(compressed.data(), compressed.size()));
+	} catch(const config::error& e) {
+		ERR_CS << "Could not read the index file '" << path << "': " << e.message;
+		return nullptr;
+	}
+
+	index.checksum = hashlist_checksum(index.files);
+
+	if(indexes_.size() >= max_indexes) {
+		indexes_.erase(indexes_.begin());
+	}
+
+	return &indexes_.emplace(path, std::move(index)).first->second;
+}
+
+void server::write_index(const std::string& path, const config& index)
+{
+	filesystem::atomic_commit index_file{path};
+	config_writer{*index_file.ostream(), true, compress_level_}.write(index);
+	index_file.commit();
+
+	indexes_.erase(path);
+}
+
+void server::prune_full_packs(config& addon)
+{
+	const auto& pathstem = addon["filename"].str();
+	const auto version_map = get_version_map(addon);
+	if(version_map.empty()) {
+		return;
+	}
+
+	const version_info& latest_version = version_map.rbegin()->first;
+
+	for(config& version_cfg : addon.child_range("version")) {
+		const auto& pack_path = pathstem + '/' + version_cfg["filename"].str();
+
+		if(!version_cfg["blobs"].to_bool()) {
+			config pack;
+			{
+				auto in = filesystem::istream_file(pack_path);
+				read_gz(pack, *in);
+			}
+
+			if(pack.empty()) {
+				ERR_CS << "Unable to read the full pack for '" << addon["name"].str() << "' version " << version_cfg["version"].str();
+				continue;
+			}
+
+			LOG_CS << "Moving '" << addon["name"].str() << "' version " << version_cfg["version"].str() << " to the blob store...";
+
+			store_blobs(pack);
+
+			const auto& index_path = index_from_full_pack_filename(pack_path);
+			if(!filesystem::file_exists(index_path)) {
+				config pack_index{"name", ""};
+				write_hashlist(pack_index, pack);
+				write_index(index_path, pack_index);
+			}
+
+			version_cfg["size"] = filesystem::file_size(pack_path);
+			version_cfg["blobs"] = true;
+		}
+
+		if(version_info{version_cfg["version"].str()} != latest_version && filesystem::file_exists(pack_path)) {
+			filesystem::delete_file(pack_path);
+		}
+	}
+}
+
+void server::collect_blobs()
+{
+	std::set<std::string> referenced;
+
+	for(const auto& entry : addons_) {
+		const config& addon = entry.second;
+
+		for(const config& version_cfg : addon.child_range("version")) {
+			if(!version_cfg["blobs"].to_bool()) {
+				continue;
+			}
+
+			config index;
+			{
+				auto in = filesystem::istream_file(addon["filename"].str() + '/' + index_from_full_pack_filename(version_cfg["filename"].str()));
+				read_gz(index, *in);
+			}
+
+			if(index.empty()) {
+				ERR_CS << "Missing index for '" << entry.first << "' version " << version_cfg["version"].str() << ", not collecting blobs";
+				return;
+			}
+
+			std::vector<const config*> dirs{&index};
+			while(!dirs.empty()) {
+				const config* dir = dirs.back();
+				dirs.pop_back();
+
+				for(const config& f : dir->child_range("file")) {
+					referenced.insert(make_blob_filename(f["hash"].str()));
+				}
+
+				for(const config& d : dir->child_range("dir")) {
+					dirs.push_back(&d);
+				}
+			}
+		}
+	}
+
+	std::vector<std::string> prefixes;
+	filesystem::get_files_in_dir(blob_dir_, nullptr, &prefixes);
+
+	std::size_t deleted = 0;
+
+	for(const std::string& prefix : prefixes) {
+		std::vector<std::string> blobs;
+		filesystem::get_files_in_dir(blob_dir_ + '/' + prefix, &blobs);
+
+		for(const std::string& blob : blobs) {
+			const auto& blob_fn = prefix + '/' + blob;
+			if(referenced.count(blob_fn) == 0 && filesystem::delete_file(blob_dir_ + '/' + blob_fn)) {
+				++deleted;
+			}
+		}
+	}
+
+	LOG_CS << "Deleted " << deleted << " unreferenced blobs, " << referenced.size() << " remain";
+}
+
 #define REGISTER_CAMPAIGND_HANDLER(req_id) \
 	handlers_[#req_id] = std::bind(&server::handle_##req_id, \
 		std::placeholders::_1, std::placeholders::_2)
@@ -955,53 +1307,44 @@ void server::handle_server_id(const server::request& req)
 	utils::visit([this, &doc](auto&& sock) { async_send_doc_queued(sock, doc); }, req.sock);
 }
 
-void server::handle_request_campaign_list(const server::request& req)
+const config& server::get_catalog_entry(const std::string& id, const config& addon)
 {
-	LOG_CS << req << "Sending add-ons list";
-
-	std::time_t epoch = std::time(nullptr);
-	config addons_list;
-
-	addons_list["timestamp"] = epoch;
-	if(req.cfg["times_relative_to"] != "now") {
-		epoch = 0;
+	auto iter = catalog_entries_.find(id);
+	if(iter != catalog_entries_.end()) {
+		return iter->second;
 	}
 
-	bool before_flag = false;
-	std::time_t before = epoch;
-	if(!req.cfg["before"].empty()) {
-		before += req.cfg["before"].to_time_t();
-		before_flag = true;
-	}
+	config entry = addon;
 
-	bool after_flag = false;
-	std::time_t after = epoch;
-	if(!req.cfg["after"].empty()) {
-		after += req.cfg["after"].to_time_t();
-		after_flag = true;
-	}
+	// Remove attributes containing information that's considered sensitive
+	// or irrelevant to clients
+	entry.remove_attributes("passphrase", "passhash", "passsalt", "upload_ip", "email");
 
-	const std::string& name = req.cfg["name"];
-	const std::string& lang = req.cfg["language"];
+	// Build a feedback_url string attribute from the internal [feedback]
+	// data or deliver an empty value, in case clients decide to assume its
+	// presence.
+	const config& url_params = entry.child_or_empty("feedback");
+	entry["feedback_url"] = !url_params.empty() && !feedback_url_format_.empty()
+						? format_addon_feedback_url(feedback_url_format_, url_params) : "";
 
-	for(const auto& addon : addons_)
-	{
-		if(!name.empty() && name != addon.first) {
-			continue;
-		}
+	// Clients don't need to see the original data, so discard it.
+	entry.clear_children("feedback");
 
-		config i = addon.second;
+	// Update packs info is internal stuff
+	entry.clear_children("update_pack");
 
-		if(i["hidden"].to_bool()) {
-			continue;
-		}
+	return catalog_entries_.emplace(id, std::move(entry)).first->second;
+}
 
-		const auto& tm = i["timestamp"];
+config server::make_catalog(const std::string& lang, const std::function<bool(const std::string&, const config&)>& filter)
+{
+	config addons_list;
 
-		if(before_flag && (tm.empty() || tm.to_time_t(0) >= before)) {
-			continue;
-		}
-		if(after_flag && (tm.empty() || tm.to_time_t(0) <= after)) {
+	for(const auto& addon : addons_)
+	{
+		const config& i = addon.second;
+
+		if(i["hidden"].to_bool() || !filter(addon.first, i)) {
 			continue;
 		}
 
@@ -1021,29 +1364,119 @@ void server::handle_request_campaign_list(const server::request& req)
 			}
 		}
 
-		addons_list.add_child("campaign", i);
+		addons_list.add_child("campaign", get_catalog_entry(addon.first, i));
 	}
 
-	for(config& j : addons_list.child_range("campaign"))
-	{
-		// Remove attributes containing information that's considered sensitive
-		// or irrelevant to clients
-		j.remove_attributes("passphrase", "passhash", "passsalt", "upload_ip", "email");
+	return addons_list;
+}
 
-		// Build a feedback_url string attribute from the internal [feedback]
-		// data or deliver an empty value, in case clients decide to assume its
-		// presence.
-		const config& url_params = j.child_or_empty("feedback");
-		j["feedback_url"] = !url_params.empty() && !feedback_url_format_.empty()
-							? format_addon_feedback_url(feedback_url_format_, url_params) : "";
+const server::catalog* server::get_catalog(const std::string& lang)
+{
+	// Languages are only ever requested by their codes, so this is plenty
+	static const std::size_t max_catalogs = 64;
 
-		// Clients don't need to see the original data, so discard it.
-		j.clear_children("feedback");
+	auto iter = catalogs_.find(lang);
 
-		// Update packs info is internal stuff
-		j.clear_children("update_pack");
+	if(iter == catalogs_.end()) {
+		if(catalogs_.size() >= max_catalogs) {
+			return nullptr;
+		}
+	} else if(iter->second.revision == catalog_revision_ || std::time(nullptr) <= iter->second.built) {
+		// Download counts change all the time, so don't rebuild more than once a second
+		return &iter->second;
 	}
 
+	config response;
+	response.add_child("campaigns", make_catalog(lang, [](const std::string&, const config&) { return true; }));
+
+	std::ostringstream ostr;
+	write(ostr, response);
+	const std::string wml = ostr.str();
+	const std::string hash = utils::md5(wml).hex_digest();
+
+	simple_wml::document doc(wml.c_str(), simple_wml::INIT_STATIC);
+	simple_wml::node& campaigns = *doc.child("campaigns");
+	// The list is shared by every client until it changes, so this is the
+	// time it was built rather than that of the request.
+	campaigns.set_attr_int("timestamp", std::time(nullptr));
+	campaigns.set_attr_dup("catalog_hash", hash.c_str());
+
+	catalog& cat = catalogs_[lang];
+	cat.doc = encode_doc(doc);
+	cat.hash = hash;
+	cat.revision = catalog_revision_;
+	cat.built = std::time(nullptr);
+
+	return &cat;
+}
+
+void server::handle_request_campaign_list(const server::request& req)
+{
+	LOG_CS << req << "Sending add-ons list";
+
+	const std::string& name = req.cfg["name"];
+	const std::string& lang = req.cfg["language"];
+
+	// Only the full lists are prebuilt, filtered requests are serviced from the
+	// cached list entries instead.
+	const bool unfiltered = name.empty() && req.cfg["before"].empty() && req.cfg["after"].empty();
+
+	if(const catalog* cat = unfiltered ? get_catalog(lang) : nullptr) {
+		if(req.cfg["catalog_hash"].str() == cat->hash) {
+			simple_wml::document doc;
+			simple_wml::node& campaigns = doc.root().add_child("campaigns");
+			campaigns.set_attr_int("timestamp", std::time(nullptr));
+			campaigns.set_attr_dup("catalog_hash", cat->hash.c_str());
+			campaigns.set_attr("not_modified", "yes");
+
+			utils::visit([this, &doc](auto&& sock) { async_send_doc_queued(sock, doc); }, req.sock);
+		} else {
+			utils::visit([this, cat](auto&& sock) { async_send_doc_queued(sock, cat->doc); }, req.sock);
+		}
+
+		return;
+	}
+
+	std::time_t epoch = std::time(nullptr);
+	const std::time_t now = epoch;
+
+	if(req.cfg["times_relative_to"] != "now") {
+		epoch = 0;
+	}
+
+	bool before_flag = false;
+	std::time_t before = epoch;
+	if(!req.cfg["before"].empty()) {
+		before += req.cfg["before"].to_time_t();
+		before_flag = true;
+	}
+
+	bool after_flag = false;
+	std::time_t after = epoch;
+	if(!req.cfg["after"].empty()) {
+		after += req.cfg["after"].to_time_t();
+		after_flag = true;
+	}
+
+	config addons_list = make_catalog(lang, [&](const std::string& id, const config& i) {
+		if(!name.empty() && name != id) {
+			return false;
+		}
+
+		const auto& tm = i["timestamp"];
+
+		if(before_flag && (tm.empty() || tm.to_time_t(0) >= before)) {
+			return false;
+		}
+		if(after_flag && (tm.empty() || tm.to_time_t(0) <= after)) {
+			return false;
+		}
+
+		return true;
+	});
+
+	addons_list["timestamp"] = now;
+
 	config response;
 	response.add_child("campaigns", std::move(addons_list));
 
@@ -1087,102 +1520,52 @@ void server::handle_request_campaign(const server::request& req)
 		return;
 	}
 
-	auto full_pack_path = addon["filename"].str() + '/' + to_version_iter->second["filename"].str();
-	const int full_pack_size = filesystem::file_size(full_pack_path);
-
-	// Assert `From < To` before attempting to do build an update sequence, since std::distance(A, B)
-	// requires A <= B to avoid UB with std::map (which doesn't support random access iterators) and
-	// we're going to be using that a lot next. We also can't do anything fancy with downgrades anyway,
-	// and same-version downloads can be regarded as though no From version was specified in order to
-	// keep things simple.
-
-	if(!from.empty() && from_parsed < to_parsed && version_map.count(from_parsed) != 0) {
-		// Build a sequence of updates beginning from the client's old version to the
-		// requested version. Every pair of incrementing versions on the server should
-		// have an update pack written to disk during the original upload(s).
-		//
-		// TODO: consider merging update packs instead of building a linear
-		// and possibly redundant sequence out of them.
-
-		config delta;
-		int delivery_size = 0;
-		bool force_use_full = false;
-
-		auto start_point = version_map.find(from_parsed); // Already known to exist
-		auto end_point = std::next(to_version_iter, 1); // May be end()
-
-		if(std::distance(start_point, end_point) <= 1) {
-			// This should not happen, skip the sequence build entirely
-			ERR_CS << "Bad update sequence bounds in version " << from << " -> " << to << " update sequence for the add-on '" << name << "', sending a full pack instead";
-			force_use_full = true;
-		}
+	const config& to_version_cfg = to_version_iter->second;
+	int full_pack_size = filesystem::file_size(addon["filename"].str() + '/' + to_version_cfg["filename"].str());
+	if(full_pack_size < 0) {
+		// Not the latest version, so the full pack may only exist in the blob store
+		full_pack_size = to_version_cfg["size"].to_int(-1);
+	}
 
-		for(auto iter = start_point; !force_use_full && std::distance(iter, end_point) > 1;) {
-			const auto& prev_version_cfg = iter->second;
-			const auto& next_version_cfg = (++iter)->second;
+	bool sent_delta = false;
 
-			for(const config& pack : addon.child_range("update_pack")) {
-				if(pack["from"].str() != prev_version_cfg["version"].str() ||
-				   pack["to"].str() != next_version_cfg["version"].str()) {
-					continue;
-				}
+	// Update packs can be computed for any pair of versions known by the
+	// server, downgrades included. Same-version downloads are regarded as
+	// though no From version was specified in order to keep things simple.
 
-				config step_delta;
-				const auto& update_pack_path = addon["filename"].str() + '/' + pack["filename"].str();
-				auto in = filesystem::istream_file(update_pack_path);
+	auto from_version_iter = version_map.find(from_parsed);
 
-				read_gz(step_delta, *in);
+	if(!from.empty() && from_parsed != to_parsed && from_version_iter != version_map.end()) {
+		const auto& update_pack_path = get_update_pack(addon, from_version_iter->second, to_version_cfg);
+		const int delivery_size = filesystem::file_size(update_pack_path);
 
-				if(!step_delta.empty()) {
-					// Don't copy arbitrarily large data around
-					delta.append(std::move(step_delta));
-					delivery_size += filesystem::file_size(update_pack_path);
-				} else {
-					ERR_CS << "Broken update sequence from version " << from << " to "
-							<< to << " for the add-on '" << name << "', sending a full pack instead";
-					force_use_full = true;
-					break;
-				}
+		// No point in sending an overlarge delta update.
+		if(delivery_size > 0 && (delivery_size < full_pack_size || full_pack_size <= 0)) {
+			LOG_CS << req << "Sending add-on '" << name << "' version: " << from << " -> " << to << " (delta) size: " << delivery_size / 1024 << " KiB";
 
-				// No point in sending an overlarge delta update.
-				// FIXME: This doesn't take into account over-the-wire compression
-				// from async_send_doc() though, maybe some heuristics based on
-				// individual update pack size would be useful?
-				if(delivery_size > full_pack_size && full_pack_size > 0) {
-					force_use_full = true;
-					break;
-				}
-			}
-		}
-
-		if(!force_use_full && !delta.empty()) {
-			std::ostringstream ostr;
-			write(ostr, delta);
-			const auto& wml_text = ostr.str();
-
-			simple_wml::document doc(wml_text.c_str(), simple_wml::INIT_STATIC);
-			doc.compress();
-
-			LOG_CS << req << "Sending add-on '" << name << "' version: " << from << " -> " << to << " (delta)";
-
-			utils::visit([this, &req, &doc](auto && sock) {
-				coro_send_doc(sock, doc, req.yield);
+			utils::visit([this, &req, &update_pack_path](auto&& socket) {
+				coro_send_file(socket, update_pack_path, req.yield);
 			}, req.sock);
 
-			full_pack_path.clear();
+			sent_delta = true;
+		} else if(delivery_size <= 0) {
+			ERR_CS << "Broken update sequence from version " << from << " to "
+					<< to << " for the add-on '" << name << "', sending a full pack instead";
 		}
 	}
 
 	// Send a full pack if the client's previous version was not specified, is
 	// not known by the server, or if any other condition above caused us to
 	// give up on the update pack option.
-	if(!full_pack_path.empty()) {
-		if(full_pack_size < 0) {
+	if(!sent_delta) {
+		const auto& full_pack_path = get_full_pack(addon, to_version_cfg);
+
+		if(full_pack_path.empty() || filesystem::file_size(full_pack_path) < 0) {
 			send_error("Add-on '" + name + "' could not be read by the server.", req.sock);
 			return;
 		}
 
-		LOG_CS << req << "Sending add-on '" << name << "' version: " << to << " size: " << full_pack_size / 1024 << " KiB";
+		LOG_CS << req << "Sending add-on '" << name << "' version: " << to << " size: " << filesystem::file_size(full_pack_path) / 1024 << " KiB";
 		utils::visit([this, &req, &full_pack_path](auto&& socket) {
 			coro_send_file(socket, full_pack_path, req.yield);
 		}, req.sock);
@@ -1232,17 +1615,28 @@ void server::handle_request_campaign_hash(const server::request& req)
 		}
 
 		path = index_from_full_pack_filename(path);
-		const int file_size = filesystem::file_size(path);
+		const addon_index* index = get_index(path);
 
-		if(file_size < 0) {
+		if(!index) {
 			send_error("Missing index file for the add-on '" + req.cfg["name"].str() + "'.", req.sock);
 			return;
 		}
 
-		LOG_CS << req << "Sending add-on hash index for '" << req.cfg["name"] << "' size: " << file_size / 1024 << " KiB";
-		utils::visit([this, &path, &req](auto&& socket) {
-			coro_send_file(socket, path, req.yield);
-		}, req.sock);
+		// Clients send the checksum of their own copy, there's nothing to compare if it's the same
+		if(req.cfg["index_checksum"].str() == index->checksum) {
+			LOG_CS << req << "Add-on hash index for '" << req.cfg["name"] << "' not modified";
+
+			simple_wml::document doc;
+			doc.root().set_attr("name", "");
+			doc.root().set_attr("not_modified", "yes");
+			doc.root().set_attr_dup("index_checksum", index->checksum.c_str());
+
+			utils::visit([this, &doc](auto&& socket) { async_send_doc_queued(socket, doc); }, req.sock);
+			return;
+		}
+
+		LOG_CS << req << "Sending add-on hash index for '" << req.cfg["name"] << "' size: " << index->doc->message.size() / 1024 << " KiB";
+		utils::visit([this, doc = index->doc](auto&& socket) { async_send_doc_queued(socket, doc); }, req.sock);
 	}
 }
 
@@ -1658,7 +2052,7 @@ void server::handle_upload(const server::request& req)
 			return;
 		}
 
-		auto in = filesystem::istream_file(pathstem + '/' + it->second["filename"].str());
+		auto in = filesystem::istream_file(get_full_pack(addon, it->second));
 		rw_full_pack.clear();
 		read_gz(rw_full_pack, *in);
 
@@ -1693,7 +2087,7 @@ void server::handle_upload(const server::request& req)
 	);
 
 	version_map.emplace(new_version_parsed, version_cfg);
-	addon.add_child("version", version_cfg);
+	config& version_entry = addon.add_child("version", version_cfg);
 
 	// Clean-up
 
@@ -1712,12 +2106,14 @@ void server::handle_upload(const server::request& req)
 		config_writer{*addon_pack_file.ostream(), true, compress_level_}.write(rw_full_pack);
 		addon_pack_file.commit();
 
-		filesystem::atomic_commit addon_index_file{index_path};
-		config_writer{*addon_index_file.ostream(), true, compress_level_}.write(pack_index);
-		addon_index_file.commit();
+		write_index(index_path, pack_index);
+
+		store_blobs(rw_full_pack);
 	}
 
 	addon["size"] = filesystem::file_size(full_pack_path);
+	version_entry["size"] = addon["size"];
+	version_entry["blobs"] = true;
 
 	// Expire old update packs and delete them
 
@@ -1738,67 +2134,11 @@ void server::handle_upload(const server::request& req)
 		});
 	}
 
-	// Create any missing update packs between consecutive versions. This covers
-	// cases where clients were not able to upload those update packs themselves.
-
-	for(auto iter = version_map.begin(); std::distance(iter, version_map.end()) > 1;) {
-		const config& prev_version = iter->second;
-		const config& next_version = (++iter)->second;
-
-		const auto& prev_version_name = prev_version["version"].str();
-		const auto& next_version_name = next_version["version"].str();
-
-		bool found = false;
-
-		for(const auto& pack : addon.child_range("update_pack")) {
-			if(pack["from"].str() == prev_version_name && pack["to"].str() == next_version_name) {
-				found = true;
-				break;
-			}
-		}
-
-		if(found) {
-			// Nothing to do
-			continue;
-		}
-
-		LOG_CS << "Automatically generating update pack for " << prev_version_name << " -> " << next_version_name << "...";
+	// Move the new version and any older ones still stored as full packs into
+	// the blob store. Update packs between any pair of versions are generated
+	// from there on demand instead.
 
-		const auto& prev_path = pathstem + '/' + prev_version["filename"].str();
-		const auto& next_path = pathstem + '/' + next_version["filename"].str();
-
-		if(filesystem::file_size(prev_path) <= 0 || filesystem::file_size(next_path) <= 0) {
-			ERR_CS << "Unable to automatically generate an update pack for '" << name
-					<< "' for version " << prev_version_name << " to " << next_version_name
-					<< "!";
-			continue;
-		}
-
-		const auto& update_pack_fn = make_update_pack_filename(prev_version_name, next_version_name);
-
-		config& pack_info = addon.add_child("update_pack");
-		pack_info["from"] = prev_version_name;
-		pack_info["to"] = next_version_name;
-		pack_info["expire"] = upload_ts + update_pack_lifespan_;
-		pack_info["filename"] = update_pack_fn;
-
-		// Generate the update pack from both full packs
-
-		config pack, from, to;
-
-		filesystem::scoped_istream in = filesystem::istream_file(prev_path);
-		read_gz(from, *in);
-		in = filesystem::istream_file(next_path);
-		read_gz(to, *in);
-
-		make_updatepack(pack, from, to);
-
-		{
-			filesystem::atomic_commit pack_file{pathstem + '/' + update_pack_fn};
-			config_writer{*pack_file.ostream(), true, compress_level_}.write(pack);
-			pack_file.commit();
-		}
-	}
+	prune_full_packs(addon);
 
 	mark_dirty(name);
 	write_config();
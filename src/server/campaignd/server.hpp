@@ -25,8 +25,10 @@
 #include <boost/asio/basic_waitable_timer.hpp>
 
 #include <chrono>
+#include <ctime>
 #include <functional>
 #include <iosfwd>
+#include <map>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
@@ -109,6 +111,38 @@ private:
 	/**The set of unique addon names with pending metadata updates*/
 	std::unordered_set<std::string> dirty_addons_;
 
+	/** Client-facing add-on list entries, dropped by mark_dirty(). */
+	std::unordered_map<std::string, config> catalog_entries_;
+
+	/** A prebuilt add-on list response. */
+	struct catalog
+	{
+		encoded_doc_ptr doc;
+		/** MD5 of the list contents, sent to clients as @a catalog_hash. */
+		std::string hash;
+		/** Value of catalog_revision_ when the list was built. */
+		unsigned revision;
+		std::time_t built;
+	};
+
+	/** Unfiltered add-on list responses, keyed by requested language ("" for all). */
+	std::map<std::string, catalog> catalogs_;
+	/** Bumped whenever any add-on list entry changes. */
+	unsigned catalog_revision_;
+
+	/** The file hash index of an add-on version. */
+	struct addon_index
+	{
+		config files;
+		/** The index file as it is sent for request_campaign_hash. */
+		encoded_doc_ptr doc;
+		/** See hashlist_checksum(). */
+		std::string checksum;
+	};
+
+	/** Indexes read so far, keyed by their path. */
+	std::map<std::string, addon_index> indexes_;
+
 	/**Server config*/
 	config cfg_;
 	const std::string cfg_file_;
@@ -116,6 +150,8 @@ private:
 	bool read_only_;
 	int compress_level_; /**< Used for add-on archives. */
 	time_t update_pack_lifespan_;
+	/** Root of the content-addressed file blob store shared by all add-ons. */
+	std::string blob_dir_;
 
 	bool strict_versions_;
 
@@ -182,11 +218,102 @@ private:
 
 	void delete_addon(const std::string& id);
 
+	/**
+	 * Writes the contents of every file in a WML pack to the blob store.
+	 *
+	 * Blobs are named after the MD5 of their contents, so files shared by
+	 * several versions or add-ons are only stored once.
+	 */
+	void store_blobs(const config& data);
+
+	/**
+	 * Fills in the contents of every hashed file in a WML pack or index.
+	 *
+	 * @param data             The pack to fill in.
+	 * @param keep_hashes      Whether to keep the @a hash attributes, as
+	 *                         expected in update packs.
+	 *
+	 * @return @a false if any of the required blobs is missing.
+	 */
+	bool load_blobs(config& data, bool keep_hashes);
+
+	/**
+	 * Returns the path to the full pack of an add-on version.
+	 *
+	 * Only the latest version of each add-on is kept as a full pack on disk.
+	 * Older versions are rebuilt from their index and the blob store when
+	 * requested and cached until the next upload.
+	 *
+	 * @return An empty string if the pack could not be rebuilt.
+	 */
+	std::string get_full_pack(const config& addon, const config& version_cfg);
+
+	/**
+	 * Returns the path to an update pack between two add-on versions.
+	 *
+	 * Packs are computed on demand for any pair of versions, including
+	 * downgrades, and cached like the ones uploaded by clients.
+	 *
+	 * @return An empty string if the pack could not be generated.
+	 */
+	std::string get_update_pack(config& addon, const config& from_cfg, const config& to_cfg);
+
+	/**
+	 * Returns the index file at @a path, only reading it on first use.
+	 *
+	 * @return nullptr if the file could not be read.
+	 */
+	const addon_index* get_index(const std::string& path);
+
+	/** Writes an index file, replacing any copy kept by get_index(). */
+	void write_index(const std::string& path, const config& index);
+
+	/**
+	 * Moves every version of an add-on into the blob store.
+	 *
+	 * Versions not yet in the store are converted from their full packs, and
+	 * full packs other than the latest version's are deleted afterwards.
+	 */
+	void prune_full_packs(config& addon);
+
+	/**
+	 * Deletes blobs no longer referenced by any add-on version.
+	 */
+	void collect_blobs();
+
 	void mark_dirty(const std::string& addon)
 	{
 		dirty_addons_.emplace(addon);
+		invalidate_catalog(addon);
 	}
 
+	void invalidate_catalog(const std::string& addon)
+	{
+		catalog_entries_.erase(addon);
+		++catalog_revision_;
+	}
+
+	/** Returns the client-facing add-on list entry for an add-on. */
+	const config& get_catalog_entry(const std::string& id, const config& addon);
+
+	/**
+	 * Builds an add-on list from the cached list entries.
+	 *
+	 * @param lang             Only include add-ons supporting this language
+	 *                         if not empty.
+	 * @param filter           Additional predicate on the add-on metadata.
+	 */
+	config make_catalog(const std::string& lang, const std::function<bool(const std::string&, const config&)>& filter);
+
+	/**
+	 * Returns the prebuilt unfiltered add-on list for a language.
+	 *
+	 * Lists are rebuilt at most once a second after any add-on changes.
+	 *
+	 * @return nullptr if too many languages are cached already.
+	 */
+	const catalog* get_catalog(const std::string& lang);
+
 	/**
 	 * Performs validation on an incoming add-on.
 	 *
@@ -22,6 +22,8 @@
 #include "log.hpp"
 #include "serialization/unicode.hpp"
 
+#include <algorithm>
+
 static lg::log_domain log_sql_handler("sql_executor");
 #define ERR_SQL LOG_STREAM(err, log_sql_handler)
 #define WRN_SQL LOG_STREAM(warn, log_sql_handler)
@@ -40,14 +42,17 @@ dbconn::dbconn(const config& c)
 	, db_topics_table_(c["db_topics_table"].str())
 	, db_addon_info_table_(c["db_addon_info_table"].str())
 	, db_connection_history_table_(c["db_connection_history_table"].str())
+	, idle_connections_()
+	, max_idle_connections_(std::max(1, c["db_pool_size"].to_int(4)))
+	, pool_mutex_()
 {
 	try
 	{
 		account_ = mariadb::account::create(c["db_host"].str(), c["db_user"].str(), c["db_password"].str());
 		account_->set_connect_option(mysql_option::MYSQL_SET_CHARSET_NAME, std::string("utf8mb4"));
 		account_->set_schema(c["db_name"].str());
-		// initialize the connection used to run synchronous queries.
-		connection_ = create_connection();
+		// open the first connection right away so a misconfiguration is reported at startup.
+		idle_connections_.push_back(create_connection());
 	}
 	catch(const mariadb::exception::base& e)
 	{
@@ -67,6 +72,30 @@ mariadb::connection_ref dbconn::create_connection()
 	return mariadb::connection::create(account_);
 }
 
+dbconn::pooled_connection::pooled_connection(dbconn& db)
+	: db_(db)
+	, connection_()
+{
+	{
+		std::lock_guard<std::mutex> lock(db_.pool_mutex_);
+		if(!db_.idle_connections_.empty()) {
+			connection_ = std::move(db_.idle_connections_.back());
+			db_.idle_connections_.pop_back();
+			return;
+		}
+	}
+	// connecting takes a round trip, don't hold up the other threads meanwhile.
+	connection_ = db_.create_connection();
+}
+
+dbconn::pooled_connection::~pooled_connection()
+{
+	std::lock_guard<std::mutex> lock(db_.pool_mutex_);
+	if(db_.idle_connections_.size() < db_.max_idle_connections_) {
+		db_.idle_connections_.push_back(std::move(connection_));
+	}
+}
+
 //
 // queries
 //
@@ -79,7 +108,7 @@ int dbconn::async_test_query(int limit)
 					  "select T+1 from TEST where T < ? "
 					  ") "
 					  "select count(*) from TEST";
-	int t = get_single_long(create_connection(), sql, limit);
+	int t = get_single_long(acquire_connection(), sql, limit);
 	return t;
 }
 
@@ -87,7 +116,7 @@ std::string dbconn::get_uuid()
 {
 	try
 	{
-		return get_single_string(connection_, "SELECT UUID()");
+		return get_single_string(acquire_connection(), "SELECT UUID()");
 	}
 	catch(const mariadb::exception::base& e)
 	{
@@ -106,7 +135,7 @@ std::string dbconn::get_tournaments()
 	try
 	{
 		tournaments t;
-		get_complex_results(connection_, t, db_tournament_query_);
+		get_complex_results(acquire_connection(), t, db_tournament_query_);
 		return t.str();
 	}
 	catch(const mariadb::exception::base& e)
@@ -167,7 +196,7 @@ std::unique_ptr<simple_wml::document> dbconn::get_game_history(int player_id, in
 "limit 11 offset ? ";
 
 		game_history gh;
-		get_complex_results(create_connection(), gh, game_history_query, player_id, offset);
+		get_complex_results(acquire_connection(), gh, game_history_query, player_id, offset);
 		return gh.to_doc();
 	}
 	catch(const mariadb::exception::base& e)
@@ -183,7 +212,7 @@ bool dbconn::user_exists(const std::string& name)
 {
 	try
 	{
-		return exists(connection_, "SELECT 1 FROM `"+db_users_table_+"` WHERE UPPER(username)=UPPER(?)", name);
+		return exists(acquire_connection(), "SELECT 1 FROM `"+db_users_table_+"` WHERE UPPER(username)=UPPER(?)", name);
 	}
 	catch(const mariadb::exception::base& e)
 	{
@@ -196,7 +225,7 @@ long dbconn::get_forum_id(const std::string& name)
 {
 	try
 	{
-		return get_single_long(connection_, "SELECT IFNULL((SELECT user_id FROM `"+db_users_table_+"` WHERE UPPER(username)=UPPER(?)), 0)", name);
+		return get_single_long(acquire_connection(), "SELECT IFNULL((SELECT user_id FROM `"+db_users_table_+"` WHERE UPPER(username)=UPPER(?)), 0)", name);
 	}
 	catch(const mariadb::exception::base& e)
 	{
@@ -209,7 +238,7 @@ bool dbconn::extra_row_exists(const std::string& name)
 {
 	try
 	{
-		return exists(connection_, "SELECT 1 FROM `"+db_extra_table_+"` WHERE UPPER(username)=UPPER(?)", name);
+		return exists(acquire_connection(), "SELECT 1 FROM `"+db_extra_table_+"` WHERE UPPER(username)=UPPER(?)", name);
 	}
 	catch(const mariadb::exception::base& e)
 	{
@@ -222,7 +251,7 @@ bool dbconn::is_user_in_group(const std::string& name, int group_id)
 {
 	try
 	{
-		return exists(connection_, "SELECT 1 FROM `"+db_users_table_+"` u, `"+db_user_group_table_+"` ug WHERE UPPER(u.username)=UPPER(?) AND u.USER_ID = ug.USER_ID AND ug.GROUP_ID = ?",
+		return exists(acquire_connection(), "SELECT 1 FROM `"+db_users_table_+"` u, `"+db_user_group_table_+"` ug WHERE UPPER(u.username)=UPPER(?) AND u.USER_ID = ug.USER_ID AND ug.GROUP_ID = ?",
 		name, group_id);
 	}
 	catch(const mariadb::exception::base& e)
@@ -238,7 +267,7 @@ ban_check dbconn::get_ban_info(const std::string& name, const std::string& ip)
 	{
 		// selected ban_type value must be part of user_handler::BAN_TYPE
 		ban_check b;
-		get_complex_results(connection_, b, "select ban_userid, ban_email, case when ban_ip != '' then 1 when ban_userid != 0 then 2 when ban_email != '' then 3 end as ban_type, ban_end from `"+db_banlist_table_+"` where (ban_ip = ? or ban_userid = (select user_id from `"+db_users_table_+"` where UPPER(username) = UPPER(?)) or UPPER(ban_email) = (select UPPER(user_email) from `"+db_users_table_+"` where UPPER(username) = UPPER(?))) AND ban_exclude = 0 AND (ban_end = 0 OR ban_end >= ?)",
+		get_complex_results(acquire_connection(), b, "select ban_userid, ban_email, case when ban_ip != '' then 1 when ban_userid != 0 then 2 when ban_email != '' then 3 end as ban_type, ban_end from `"+db_banlist_table_+"` where (ban_ip = ? or ban_userid = (select user_id from `"+db_users_table_+"` where UPPER(username) = UPPER(?)) or UPPER(ban_email) = (select UPPER(user_email) from `"+db_users_table_+"` where UPPER(username) = UPPER(?))) AND ban_exclude = 0 AND (ban_end = 0 OR ban_end >= ?)",
 			ip, name, name, std::time(nullptr));
 		return b;
 	}
@@ -253,7 +282,7 @@ std::string dbconn::get_user_string(const std::string& table, const std::string&
 {
 	try
 	{
-		return get_single_string(connection_, "SELECT `"+column+"` from `"+table+"` WHERE UPPER(username)=UPPER(?)", name);
+		return get_single_string(acquire_connection(), "SELECT `"+column+"` from `"+table+"` WHERE UPPER(username)=UPPER(?)", name);
 	}
 	catch(const mariadb::exception::base& e)
 	{
@@ -265,7 +294,7 @@ int dbconn::get_user_int(const std::string& table, const std::string& column, co
 {
 	try
 	{
-		return static_cast<int>(get_single_long(connection_, "SELECT `"+column+"` from `"+table+"` WHERE UPPER(username)=UPPER(?)", name));
+		return static_cast<int>(get_single_long(acquire_connection(), "SELECT `"+column+"` from `"+table+"` WHERE UPPER(username)=UPPER(?)", name));
 	}
 	catch(const mariadb::exception::base& e)
 	{
@@ -279,9 +308,9 @@ void dbconn::write_user_int(const std::string& column, const std::string& name,
 	{
 		if(!extra_row_exists(name))
 		{
-			modify(connection_, "INSERT INTO `"+db_extra_table_+"` VALUES(?,?,'0')", name, value);
+			modify(acquire_connection(), "INSERT INTO `"+db_extra_table_+"` VALUES(?,?,'0')", name, value);
 		}
-		modify(connection_, "UPDATE `"+db_extra_table_+"` SET "+column+"=? WHERE UPPER(username)=UPPER(?)", value, name);
+		modify(acquire_connection(), "UPDATE `"+db_extra_table_+"` SET "+column+"=? WHERE UPPER(username)=UPPER(?)", value, name);
 	}
 	catch(const mariadb::exception::base& e)
 	{
@@ -293,7 +322,7 @@ void dbconn::insert_game_info(const std::string& uuid, int game_id, const std::s
 {
 	try
 	{
-		modify(connection_, "INSERT INTO `"+db_game_info_table_+"`(INSTANCE_UUID, GAME_ID, INSTANCE_VERSION, GAME_NAME, RELOAD, OBSERVERS, PUBLIC, PASSWORD) VALUES(?, ?, ?, ?, ?, ?, ?, ?)",
+		modify(acquire_connection(), "INSERT INTO `"+db_game_info_table_+"`(INSTANCE_UUID, GAME_ID, INSTANCE_VERSION, GAME_NAME, RELOAD, OBSERVERS, PUBLIC, PASSWORD) VALUES(?, ?, ?, ?, ?, ?, ?, ?)",
 			uuid, game_id, version, name, reload, observers, is_public, has_password);
 	}
 	catch(const mariadb::exception::base& e)
@@ -305,7 +334,7 @@ void dbconn::update_game_end(const std::string& uuid, int game_id, const std::st
 {
 	try
 	{
-		modify(connection_, "UPDATE `"+db_game_info_table_+"` SET END_TIME = CURRENT_TIMESTAMP, REPLAY_NAME = ? WHERE INSTANCE_UUID = ? AND GAME_ID = ?",
+		modify(acquire_connection(), "UPDATE `"+db_game_info_table_+"` SET END_TIME = CURRENT_TIMESTAMP, REPLAY_NAME = ? WHERE INSTANCE_UUID = ? AND GAME_ID = ?",
 			replay_location, uuid, game_id);
 	}
 	catch(const mariadb::exception::base& e)
@@ -317,7 +346,7 @@ void dbconn::insert_game_player_info(const std::string& uuid, int game_id, const
 {
 	try
 	{
-		modify(connection_, "INSERT INTO `"+db_game_player_info_table_+"`(INSTANCE_UUID, GAME_ID, USER_ID, SIDE_NUMBER, IS_HOST, FACTION, CLIENT_VERSION, CLIENT_SOURCE, USER_NAME) VALUES(?, ?, IFNULL((SELECT user_id FROM `"+db_users_table_+"` WHERE username = ?), -1), ?, ?, ?, ?, ?, ?)",
+		modify(acquire_connection(), "INSERT INTO `"+db_game_player_info_table_+"`(INSTANCE_UUID, GAME_ID, USER_ID, SIDE_NUMBER, IS_HOST, FACTION, CLIENT_VERSION, CLIENT_SOURCE, USER_NAME) VALUES(?, ?, IFNULL((SELECT user_id FROM `"+db_users_table_+"` WHERE username = ?), -1), ?, ?, ?, ?, ?, ?)",
 			uuid, game_id, username, side_number, is_host, faction, version, source, current_user);
 	}
 	catch(const mariadb::exception::base& e)
@@ -329,7 +358,7 @@ unsigned long long dbconn::insert_game_content_info(const std::string& uuid, int
 {
 	try
 	{
-		return modify(connection_, "INSERT INTO `"+db_game_content_info_table_+"`(INSTANCE_UUID, GAME_ID, TYPE, NAME, ID, SOURCE, VERSION) VALUES(?, ?, ?, ?, ?, ?, ?)",
+		return modify(acquire_connection(), "INSERT INTO `"+db_game_content_info_table_+"`(INSTANCE_UUID, GAME_ID, TYPE, NAME, ID, SOURCE, VERSION) VALUES(?, ?, ?, ?, ?, ?, ?)",
 			uuid, game_id, type, name, id, source, version);
 	}
 	catch(const mariadb::exception::base& e)
@@ -342,7 +371,7 @@ void dbconn::set_oos_flag(const std::string& uuid, int game_id)
 {
 	try
 	{
-		modify(connection_, "UPDATE `"+db_game_info_table_+"` SET OOS = 1 WHERE INSTANCE_UUID = ? AND GAME_ID = ?",
+		modify(acquire_connection(), "UPDATE `"+db_game_info_table_+"` SET OOS = 1 WHERE INSTANCE_UUID = ? AND GAME_ID = ?",
 			uuid, game_id);
 	}
 	catch(const mariadb::exception::base& e)
@@ -354,7 +383,7 @@ void dbconn::set_oos_flag(const std::string& uuid, int game_id)
 bool dbconn::topic_id_exists(int topic_id) {
 	try
 	{
-		return exists(connection_, "SELECT 1 FROM `"+db_topics_table_+"` WHERE TOPIC_ID = ?",
+		return exists(acquire_connection(), "SELECT 1 FROM `"+db_topics_table_+"` WHERE TOPIC_ID = ?",
 			topic_id);
 	}
 	catch(const mariadb::exception::base& e)
@@ -368,7 +397,7 @@ void dbconn::insert_addon_info(const std::string& instance_version, const std::s
 {
 	try
 	{
-		modify(connection_, "INSERT INTO `"+db_addon_info_table_+"`(INSTANCE_VERSION, ADDON_ID, ADDON_NAME, TYPE, VERSION, FORUM_AUTH, FEEDBACK_TOPIC) VALUES(?, ?, ?, ?, ?, ?, ?)",
+		modify(acquire_connection(), "INSERT INTO `"+db_addon_info_table_+"`(INSTANCE_VERSION, ADDON_ID, ADDON_NAME, TYPE, VERSION, FORUM_AUTH, FEEDBACK_TOPIC) VALUES(?, ?, ?, ?, ?, ?, ?)",
 			instance_version, id, name, type, version, forum_auth, topic_id);
 	}
 	catch(const mariadb::exception::base& e)
@@ -381,7 +410,7 @@ unsigned long long dbconn::insert_login(const std::string& username, const std::
 {
 	try
 	{
-		return modify_get_id(connection_, "INSERT INTO `"+db_connection_history_table_+"`(USER_NAME, IP, VERSION) values(lower(?), ?, ?)",
+		return modify_get_id(acquire_connection(), "INSERT INTO `"+db_connection_history_table_+"`(USER_NAME, IP, VERSION) values(lower(?), ?, ?)",
 			username, ip, version);
 	}
 	catch(const mariadb::exception::base& e)
@@ -395,7 +424,7 @@ void dbconn::update_logout(unsigned long long login_id)
 {
 	try
 	{
-		modify(connection_, "UPDATE `"+db_connection_history_table_+"` SET LOGOUT_TIME = CURRENT_TIMESTAMP WHERE LOGIN_ID = ?",
+		modify(acquire_connection(), "UPDATE `"+db_connection_history_table_+"` SET LOGOUT_TIME = CURRENT_TIMESTAMP WHERE LOGIN_ID = ?",
 			login_id);
 	}
 	catch(const mariadb::exception::base& e)
@@ -408,7 +437,8 @@ void dbconn::get_users_for_ip(const std::string& ip, std::ostringstream* out)
 {
 	try
 	{
-		mariadb::result_set_ref rslt = select(connection_, "SELECT USER_NAME, IP, date_format(LOGIN_TIME, '%Y/%m/%d %h:%i:%s'), coalesce(date_format(LOGOUT_TIME, '%Y/%m/%d %h:%i:%s'), '(not set)') FROM `"+db_connection_history_table_+"` WHERE IP LIKE ? order by LOGIN_TIME",
+		pooled_connection connection = acquire_connection();
+		mariadb::result_set_ref rslt = select(connection, "SELECT USER_NAME, IP, date_format(LOGIN_TIME, '%Y/%m/%d %h:%i:%s'), coalesce(date_format(LOGOUT_TIME, '%Y/%m/%d %h:%i:%s'), '(not set)') FROM `"+db_connection_history_table_+"` WHERE IP LIKE ? order by LOGIN_TIME",
 			ip);
 
 		*out << "\nCount of results for ip: " << rslt->row_count();
@@ -429,7 +459,8 @@ void dbconn::get_ips_for_user(const std::string& username, std::ostringstream* o
 {
 	try
 	{
-		mariadb::result_set_ref rslt = select(connection_, "SELECT USER_NAME, IP, date_format(LOGIN_TIME, '%Y/%m/%d %h:%i:%s'), coalesce(date_format(LOGOUT_TIME, '%Y/%m/%d %h:%i:%s'), '(not set)') FROM `"+db_connection_history_table_+"` WHERE USER_NAME LIKE ? order by LOGIN_TIME",
+		pooled_connection connection = acquire_connection();
+		mariadb::result_set_ref rslt = select(connection, "SELECT USER_NAME, IP, date_format(LOGIN_TIME, '%Y/%m/%d %h:%i:%s'), coalesce(date_format(LOGOUT_TIME, '%Y/%m/%d %h:%i:%s'), '(not set)') FROM `"+db_connection_history_table_+"` WHERE USER_NAME LIKE ? order by LOGIN_TIME",
 			utf8::lowercase(username));
 
 		*out << "\nCount of results for user: " << rslt->row_count();
@@ -450,7 +481,7 @@ void dbconn::update_addon_download_count(const std::string& instance_version, co
 {
 	try
 	{
-		modify(connection_, "UPDATE `"+db_addon_info_table_+"` SET DOWNLOAD_COUNT = DOWNLOAD_COUNT+1 WHERE INSTANCE_VERSION = ? AND ADDON_ID = ? AND VERSION = ?",
+		modify(acquire_connection(), "UPDATE `"+db_addon_info_table_+"` SET DOWNLOAD_COUNT = DOWNLOAD_COUNT+1 WHERE INSTANCE_VERSION = ? AND ADDON_ID = ? AND VERSION = ?",
 			instance_version, id, version);
 	}
 	catch(const mariadb::exception::base& e)
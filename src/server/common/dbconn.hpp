@@ -26,6 +26,7 @@
 #include "mariadb++/result_set.hpp"
 #include "mariadb++/exceptions.hpp"
 
+#include <mutex>
 #include <vector>
 #include <unordered_map>
 
@@ -38,7 +39,8 @@ class dbconn
 {
 	public:
 		/**
-		 * Initializes the synchronous query connection as well as the account object that has the connection settings.
+		 * Initializes the account object that has the connection settings, and opens the first pooled connection.
+		 * Every query borrows a connection from the pool for its duration, so the public functions may be called from any thread.
 		 *
 		 * @param c The config object to read information from.
 		 */
@@ -186,8 +188,6 @@ class dbconn
 		 * @note settings put on the connection, rather than the account, are NOT kept if a reconnect occurs!
 		 */
 		mariadb::account_ref account_;
-		/** The actual connection to the database. */
-		mariadb::connection_ref connection_;
 
 		/** The name of the table that contains forum user information. */
 		std::string db_users_table_;
@@ -212,6 +212,12 @@ class dbconn
 		/** The name of the table that contains user connection history. */
 		std::string db_connection_history_table_;
 
+		/** Connections not currently used by a query, guarded by #pool_mutex_. */
+		std::vector<mariadb::connection_ref> idle_connections_;
+		/** At most this many connections are kept open once their query finishes, set by db_pool_size. */
+		std::size_t max_idle_connections_;
+		std::mutex pool_mutex_;
+
 		/**
 		 * This is used to write out error text when an SQL-related exception occurs.
 		 *
@@ -225,6 +231,32 @@ class dbconn
 		 */
 		mariadb::connection_ref create_connection();
 
+		/**
+		 * A connection borrowed from the pool, handed back when this goes out of scope.
+		 * Converts to the connection itself so it can be passed straight to the query functions below.
+		 */
+		class pooled_connection
+		{
+		public:
+			pooled_connection(dbconn& db);
+			~pooled_connection();
+
+			pooled_connection(const pooled_connection&) = delete;
+			pooled_connection& operator=(const pooled_connection&) = delete;
+
+			operator mariadb::connection_ref() const { return connection_; }
+
+		private:
+			dbconn& db_;
+			mariadb::connection_ref connection_;
+		};
+
+		/**
+		 * Takes an idle connection from the pool, or opens a new one if all of them are busy.
+		 * A temporary handle keeps the connection until the end of the full expression, so a result set that is read afterwards needs a named one.
+		 */
+		pooled_connection acquire_connection() { return pooled_connection(*this); }
+
 		/**
 		 * Queries can return data with various types that can't be easily fit into a pre-determined structure.
 		 * Therefore for queries that can return multiple rows with multiple columns, a class that extends @ref rs_base handles reading the results.
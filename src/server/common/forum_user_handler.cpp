@@ -20,9 +20,11 @@
 #include "hash.hpp"
 #include "log.hpp"
 #include "config.hpp"
+#include "serialization/unicode.hpp"
 
 #include <boost/asio/post.hpp>
 
+#include <algorithm>
 #include <cstdlib>
 #include <sstream>
 
@@ -35,6 +37,55 @@ static lg::log_domain log_mp_user_handler("mp_user_handler");
 namespace {
 	const int USER_INACTIVE = 1;
 	const int USER_IGNORE = 2;
+
+	/** Expired entries are only swept once a cache holds this many. */
+	const std::size_t max_cached_lookups = 1024;
+}
+
+template<typename T>
+fuh::lookup_cache<T>::lookup_cache(std::chrono::steady_clock::duration ttl)
+	: ttl_(ttl)
+	, entries_()
+	, mutex_()
+{
+}
+
+template<typename T>
+bool fuh::lookup_cache<T>::get(const std::string& key, T& value)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto i = entries_.find(key);
+	if(i == entries_.end() || i->second.first <= std::chrono::steady_clock::now()) {
+		return false;
+	}
+	value = i->second.second;
+	return true;
+}
+
+template<typename T>
+void fuh::lookup_cache<T>::put(const std::string& key, const T& value)
+{
+	if(ttl_ <= std::chrono::steady_clock::duration::zero()) {
+		return;
+	}
+
+	const auto now = std::chrono::steady_clock::now();
+	std::lock_guard<std::mutex> lock(mutex_);
+
+	if(entries_.size() >= max_cached_lookups) {
+		for(auto i = entries_.begin(); i != entries_.end();) {
+			i = i->second.first <= now ? entries_.erase(i) : std::next(i);
+		}
+	}
+
+	entries_[key] = { now + ttl_, value };
+}
+
+template<typename T>
+void fuh::lookup_cache<T>::erase(const std::string& key)
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	entries_.erase(key);
 }
 
 fuh::fuh(const config& c)
@@ -42,6 +93,9 @@ fuh::fuh(const config& c)
 	, db_users_table_(c["db_users_table"].str())
 	, db_extra_table_(c["db_extra_table"].str())
 	, mp_mod_group_(0)
+	, moderator_cache_(std::chrono::seconds(c["db_cache_ttl"].to_int(30)))
+	, ban_cache_(std::chrono::seconds(c["db_cache_ttl"].to_int(30)))
+	, query_pool_(std::max(1, c["db_threads"].to_int(2)))
 {
 	try {
 		mp_mod_group_ = std::stoi(c["mp_mod_group"].str());
@@ -116,10 +170,15 @@ bool fuh::user_is_active(const std::string& name) {
 }
 
 bool fuh::user_is_moderator(const std::string& name) {
-	if(!user_exists(name)){
-		return false;
+	const std::string key = utf8::lowercase(name);
+	bool is_moderator;
+	if(moderator_cache_.get(key, is_moderator)) {
+		return is_moderator;
 	}
-	return conn_.get_user_int(db_extra_table_, "user_is_moderator", name) == 1 || (mp_mod_group_ != 0 && conn_.is_user_in_group(name, mp_mod_group_));
+
+	is_moderator = user_exists(name) && (conn_.get_user_int(db_extra_table_, "user_is_moderator", name) == 1 || (mp_mod_group_ != 0 && conn_.is_user_in_group(name, mp_mod_group_)));
+	moderator_cache_.put(key, is_moderator);
+	return is_moderator;
 }
 
 void fuh::set_is_moderator(const std::string& name, const bool& is_moderator) {
@@ -127,9 +186,23 @@ void fuh::set_is_moderator(const std::string& name, const bool& is_moderator) {
 		return;
 	}
 	conn_.write_user_int("user_is_moderator", name, is_moderator);
+	moderator_cache_.erase(utf8::lowercase(name));
 }
 
 fuh::ban_info fuh::user_is_banned(const std::string& name, const std::string& addr)
+{
+	const std::string key = utf8::lowercase(name) + ' ' + addr;
+	ban_info cached;
+	if(ban_cache_.get(key, cached)) {
+		return cached;
+	}
+
+	ban_info result = check_ban(name, addr);
+	ban_cache_.put(key, result);
+	return result;
+}
+
+fuh::ban_info fuh::check_ban(const std::string& name, const std::string& addr)
 {
 	ban_check b = conn_.get_ban_info(name, addr);
 	switch(b.get_ban_type())
@@ -208,7 +281,7 @@ std::string fuh::get_tournaments(){
 }
 
 void fuh::async_get_and_send_game_history(boost::asio::io_service& io_service, wesnothd::server& s, wesnothd::player_iterator player, int player_id, int offset) {
-	boost::asio::post([this, &s, player, player_id, offset, &io_service] {
+	boost::asio::post(query_pool_, [this, &s, player, player_id, offset, &io_service] {
 		boost::asio::post(io_service, [player, &s, doc = conn_.get_game_history(player_id, offset)]{
 			s.send_to_player(player, *doc);
 		});
@@ -236,7 +309,7 @@ void fuh::db_set_oos_flag(const std::string& uuid, int game_id){
 }
 
 void fuh::async_test_query(boost::asio::io_service& io_service, int limit) {
-	boost::asio::post([this, limit, &io_service] {
+	boost::asio::post(query_pool_, [this, limit, &io_service] {
 		ERR_UH << "async test query starts!";
 		int i = conn_.async_test_query(limit);
 		boost::asio::post(io_service, [i]{ ERR_UH << "async test query output: " << i; });
@@ -18,9 +18,12 @@
 #include "server/common/user_handler.hpp"
 #include "server/common/dbconn.hpp"
 
+#include <chrono>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <ctime>
+#include <unordered_map>
 
 /**
  * A class to handle the non-SQL logic for connecting to the phpbb forum database.
@@ -82,6 +85,7 @@ public:
 	 * @param name The player's username.
 	 * @return Whether the user is a moderator or not.
 	 * @note This can be either from the extra table or whether the player is a member of the MP Moderators groups.
+	 * @note The answer is cached for db_cache_ttl seconds.
 	 */
 	bool user_is_moderator(const std::string& name);
 
@@ -101,6 +105,7 @@ public:
 	 * @note Glob IP and email address bans are NOT supported yet since they require a different kind of query that isn't supported
 	 *       by our prepared SQL statement API right now. However, they are basically never used on forums.wesnoth.org,
 	 *       so this shouldn't be a problem.
+	 * @note The answer is cached for db_cache_ttl seconds, so a new forum ban may take that long to apply.
 	 */
 	ban_info user_is_banned(const std::string& name, const std::string& addr);
 
@@ -272,6 +277,11 @@ public:
 	 */
 	void db_update_addon_download_count(const std::string& instance_version, const std::string& id, const std::string& version);
 
+	/**
+	 * @return The executor of the threads running the queries, sized by db_threads.
+	 */
+	boost::asio::thread_pool::executor_type query_executor() { return query_pool_.get_executor(); }
+
 private:
 	/** An instance of the class responsible for executing the queries and handling the database connection. */
 	dbconn conn_;
@@ -282,6 +292,37 @@ private:
 	/** The group ID of the forums MP Moderators group */
 	int mp_mod_group_;
 
+	/**
+	 * Remembers lookups that every login repeats, keyed by the lowercased username.
+	 * Shared by the query threads, so every access locks it.
+	 */
+	template<typename T>
+	class lookup_cache
+	{
+	public:
+		lookup_cache(std::chrono::steady_clock::duration ttl);
+
+		/** @return Whether a fresh value for @a key was copied to @a value. */
+		bool get(const std::string& key, T& value);
+		void put(const std::string& key, const T& value);
+		void erase(const std::string& key);
+
+	private:
+		std::chrono::steady_clock::duration ttl_;
+		std::unordered_map<std::string, std::pair<std::chrono::steady_clock::time_point, T>> entries_;
+		std::mutex mutex_;
+	};
+
+	lookup_cache<bool> moderator_cache_;
+	/** Keyed by the lowercased username and the IP address. */
+	lookup_cache<ban_info> ban_cache_;
+
+	/** Runs the queries off the event loop. Declared last so it is joined before anything the queries use is destroyed. */
+	boost::asio::thread_pool query_pool_;
+
+	/** The uncached part of @ref user_is_banned(). */
+	ban_info check_ban(const std::string& name, const std::string& addr);
+
 	/**
 	 * @param user The player's username.
 	 * @return The player's hashed password from the phpbb forum database.
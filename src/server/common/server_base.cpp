@@ -28,6 +28,7 @@
 #endif
 
 #ifdef HAVE_SENDFILE
+#include <netinet/tcp.h>
 #include <sys/sendfile.h>
 #endif
 
@@ -36,17 +37,21 @@
 #include <boost/scope_exit.hpp>
 #endif
 
+#include <boost/asio/async_result.hpp>
 #include <boost/asio/ip/v6_only.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/asio/read.hpp>
 #ifndef _WIN32
 #include <boost/asio/read_until.hpp>
 #endif
 #include <boost/asio/write.hpp>
 
+#include <algorithm>
 #include <array>
 #include <ctime>
+#include <deque>
 #include <functional>
-#include <queue>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <iostream>
@@ -64,6 +69,10 @@ static lg::log_domain log_config("config");
 
 bool dump_wml = false;
 
+/** Index of a socket type in server_base::io_stats. */
+static int io_stats_index(const socket_ptr&) { return 0; }
+static int io_stats_index(const tls_socket_ptr&) { return 1; }
+
 server_base::server_base(unsigned short port, bool keep_alive)
 	: port_(port)
 	, keep_alive_(keep_alive)
@@ -79,6 +88,24 @@ server_base::server_base(unsigned short port, bool keep_alive)
 {
 }
 
+void server_base::start_decode_pool(std::size_t threads)
+{
+	if(threads > 0) {
+		decode_pool_ = std::make_unique<boost::asio::thread_pool>(threads);
+	} else {
+		decode_pool_.reset();
+	}
+}
+
+void server_base::start_hash_pool(std::size_t threads)
+{
+	if(threads > 0) {
+		hash_pool_ = std::make_unique<boost::asio::thread_pool>(threads);
+	} else {
+		hash_pool_.reset();
+	}
+}
+
 void server_base::start_server()
 {
 	boost::asio::ip::tcp::endpoint endpoint_v6(boost::asio::ip::tcp::v6(), port_);
@@ -184,10 +211,21 @@ void server_base::serve(boost::asio::yield_context yield, boost::asio::ip::tcp::
 			}
 
 			final_socket = tls_socket_ptr { new tls_socket_ptr::element_type(std::move(*socket), tls_context_) };
-			utils::get<tls_socket_ptr>(final_socket)->async_handshake(boost::asio::ssl::stream_base::server, yield[error]);
-			if(error) {
-				ERR_SERVER << "TLS handshake failed: " << error.message();
-				return;
+			{
+				const auto& tls_socket = utils::get<tls_socket_ptr>(final_socket);
+				const auto start = std::chrono::steady_clock::now();
+				tls_socket->async_handshake(boost::asio::ssl::stream_base::server, yield[error]);
+				if(error) {
+					++io_stats_.tls_handshake_failures;
+					ERR_SERVER << "TLS handshake failed: " << error.message();
+					return;
+				}
+
+				++io_stats_.tls_handshakes;
+				io_stats_.tls_handshake_time += std::chrono::steady_clock::now() - start;
+				if(SSL_session_reused(tls_socket->native_handle())) {
+					++io_stats_.tls_resumed;
+				}
 			}
 
 			break;
@@ -330,6 +368,8 @@ template<class SocketPtr> void server_base::coro_send_doc(SocketPtr socket, simp
 			socket->lowest_layer().close();
 			return;
 		}
+
+		io_stats_.bytes_out[io_stats_index(socket)] += 4 + s.size();
 	} catch (simple_wml::error& e) {
 		WRN_CONFIG << __func__ << ": simple_wml error: " << e.message;
 		throw;
@@ -338,7 +378,16 @@ template<class SocketPtr> void server_base::coro_send_doc(SocketPtr socket, simp
 template void server_base::coro_send_doc<socket_ptr>(socket_ptr socket, simple_wml::document& doc, boost::asio::yield_context yield);
 template void server_base::coro_send_doc<tls_socket_ptr>(tls_socket_ptr socket, simple_wml::document& doc, boost::asio::yield_context yield);
 
-template<class SocketPtr> void coro_send_file_userspace(SocketPtr socket, const std::string& filename, boost::asio::yield_context yield)
+/** @return The number of bytes sent. */
+/**
+ * Largest chunk of a file read and written at once by coro_send_file_userspace().
+ *
+ * TLS records are at most 16 KiB, so larger chunks let the SSL stream emit
+ * several records per write instead of waking the coroutine for each one.
+ */
+static const std::size_t send_file_chunk_size = 64 * 1024;
+
+template<class SocketPtr> std::size_t coro_send_file_userspace(SocketPtr socket, const std::string& filename, boost::asio::yield_context yield)
 {
 	std::size_t filesize { std::size_t(filesystem::file_size(filename)) };
 	union DataSize
@@ -348,42 +397,66 @@ template<class SocketPtr> void coro_send_file_userspace(SocketPtr socket, const
 	} data_size {};
 	data_size.size = htonl(filesize);
 
-	boost::system::error_code ec;
-	async_write(*socket, boost::asio::buffer(data_size.buf), yield[ec]);
-	if(check_error(ec, socket)) {
-		socket->lowest_layer().close();
-		return;
-	}
+	// The size header goes out together with the first chunk of the file so
+	// that it doesn't end up in a TLS record or TCP segment of its own.
+	std::vector<char> buf(sizeof(data_size.buf) + send_file_chunk_size);
+	std::copy(std::begin(data_size.buf), std::end(data_size.buf), buf.begin());
+	std::size_t header_size = sizeof(data_size.buf);
 
+	boost::system::error_code ec;
 	auto ifs { filesystem::istream_file(filename) };
 	ifs->seekg(0);
-	while(ifs->good()) {
-		char buf[16384];
-		ifs->read(buf, sizeof(buf));
-		async_write(*socket, boost::asio::buffer(buf, ifs->gcount()), yield[ec]);
+	while(header_size != 0 || ifs->good()) {
+		ifs->read(buf.data() + header_size, send_file_chunk_size);
+		const std::size_t len = header_size + ifs->gcount();
+		header_size = 0;
+
+		if(len == 0) {
+			break;
+		}
+
+		async_write(*socket, boost::asio::buffer(buf.data(), len), yield[ec]);
 		if(check_error(ec, socket)) {
 			socket->lowest_layer().close();
-			return;
+			return 0;
 		}
 	}
+
+	return 4 + filesize;
 }
 
 #ifdef HAVE_SENDFILE
 
 void server_base::coro_send_file(tls_socket_ptr socket, const std::string& filename, boost::asio::yield_context yield)
 {
-	// We fallback to userspace if using TLS socket because sendfile is not aware of TLS state
-	// TODO: keep in mind possibility of using KTLS instead. This seem to be available only in openssl3 branch for now
-	coro_send_file_userspace(socket, filename, yield);
+	// We fallback to userspace if using TLS socket because sendfile is not aware of TLS state.
+	// Kernel TLS doesn't help either: asio's SSL stream drives OpenSSL through a memory BIO,
+	// so the socket never carries the session keys that SSL_sendfile() would need.
+	io_stats_.bytes_out[io_stats_index(socket)] += coro_send_file_userspace(socket, filename, yield);
 }
 
 void server_base::coro_send_file(socket_ptr socket, const std::string& filename, boost::asio::yield_context yield)
 {
 	std::size_t filesize { std::size_t(filesystem::file_size(filename)) };
 	int in_file { open(filename.c_str(), O_RDONLY) };
+	if(in_file < 0) {
+		ERR_SERVER << log_address(socket) << "\tcould not open " << filename << " for sending: " << strerror(errno);
+		socket->close();
+		return;
+	}
 	ON_SCOPE_EXIT(in_file) { close(in_file); };
 	off_t offset { 0 };
-	//std::size_t total_bytes_transferred { 0 };
+
+#ifdef TCP_CORK
+	// Hold back partial segments so the size header shares the first one with
+	// the file contents.
+	int cork { 1 };
+	setsockopt(socket->native_handle(), IPPROTO_TCP, TCP_CORK, &cork, sizeof(cork));
+	ON_SCOPE_EXIT(&socket) {
+		int uncork { 0 };
+		setsockopt(socket->native_handle(), IPPROTO_TCP, TCP_CORK, &uncork, sizeof(uncork));
+	};
+#endif
 
 	union DataSize
 	{
@@ -396,6 +469,8 @@ void server_base::coro_send_file(socket_ptr socket, const std::string& filename,
 	async_write(*socket, boost::asio::buffer(data_size.buf), yield[ec]);
 	if(check_error(ec, socket)) return;
 
+	io_stats_.bytes_out[io_stats_index(socket)] += 4 + filesize;
+
 	// Put the underlying socket into non-blocking mode.
 	if(!socket->native_non_blocking()) {
 		socket->native_non_blocking(true, ec);
@@ -406,10 +481,9 @@ void server_base::coro_send_file(socket_ptr socket, const std::string& filename,
 	{
 		// Try the system call.
 		errno = 0;
-		int n = ::sendfile(socket->native_handle(), in_file, &offset, 65536);
+		ssize_t n = ::sendfile(socket->native_handle(), in_file, &offset, filesize - std::size_t(offset));
 		ec = boost::system::error_code(n < 0 ? errno : 0,
 									   boost::asio::error::get_system_category());
-		//total_bytes_transferred += *(yield.ec_) ? 0 : n;
 
 		// Retry operation immediately if interrupted by signal.
 		if(ec == boost::asio::error::interrupted)
@@ -440,13 +514,12 @@ void server_base::coro_send_file(socket_ptr socket, const std::string& filename,
 
 void server_base::coro_send_file(tls_socket_ptr socket, const std::string& filename, boost::asio::yield_context yield)
 {
-	coro_send_file_userspace(socket, filename, yield);
+	io_stats_.bytes_out[io_stats_index(socket)] += coro_send_file_userspace(socket, filename, yield);
 }
 
 void server_base::coro_send_file(socket_ptr socket, const std::string& filename, boost::asio::yield_context yield)
 {
-	OVERLAPPED overlap;
-	std::vector<boost::asio::const_buffer> buffers;
+	OVERLAPPED overlap {};
 
 	SetLastError(ERROR_SUCCESS);
 
@@ -459,7 +532,7 @@ void server_base::coro_send_file(socket_ptr socket, const std::string& filename,
 		throw std::runtime_error("Failed to open the file");
 	}
 	BOOST_SCOPE_EXIT_ALL(in_file) {
-		CloseHandle(&in_file);
+		CloseHandle(in_file);
 	};
 
 	HANDLE event = CreateEvent(nullptr, TRUE, TRUE, nullptr);
@@ -480,9 +553,14 @@ void server_base::coro_send_file(socket_ptr socket, const std::string& filename,
 	} data_size {};
 	data_size.size = htonl(filesize);
 
-	async_write(*socket, boost::asio::buffer(data_size.buf, 4), yield);
+	// Let TransmitFile send the size header ahead of the file contents
+	TRANSMIT_FILE_BUFFERS header {};
+	header.Head = data_size.buf;
+	header.HeadLength = sizeof(data_size.buf);
 
-	BOOL success = TransmitFile(socket->native_handle(), in_file, 0, 0, &overlap, nullptr, 0);
+	io_stats_.bytes_out[io_stats_index(socket)] += 4 + filesize;
+
+	BOOL success = TransmitFile(socket->native_handle(), in_file, 0, 0, &overlap, &header, 0);
 	if(!success) {
 		if(WSAGetLastError() == WSA_IO_PENDING) {
 			while(true) {
@@ -505,12 +583,12 @@ void server_base::coro_send_file(socket_ptr socket, const std::string& filename,
 
 void server_base::coro_send_file(tls_socket_ptr socket, const std::string& filename, boost::asio::yield_context yield)
 {
-	coro_send_file_userspace(socket, filename, yield);
+	io_stats_.bytes_out[io_stats_index(socket)] += coro_send_file_userspace(socket, filename, yield);
 }
 
 void server_base::coro_send_file(socket_ptr socket, const std::string& filename, boost::asio::yield_context yield)
 {
-	coro_send_file_userspace(socket, filename, yield);
+	io_stats_.bytes_out[io_stats_index(socket)] += coro_send_file_userspace(socket, filename, yield);
 }
 
 #endif
@@ -540,49 +618,212 @@ template<class SocketPtr> std::unique_ptr<simple_wml::document> server_base::cor
 		return {};
 	}
 
-	boost::shared_array<char> buffer{ new char[size] };
-	async_read(*socket, boost::asio::buffer(buffer.get(), size), yield[ec]);
+	// Enough for the documents of a busy lobby, without hoarding the odd huge one.
+	const std::size_t max_receive_buffers = 32;
+	const std::size_t max_receive_buffer_size = 1024 * 1024;
+
+	std::vector<char> buffer;
+	if(!receive_buffers_.empty()) {
+		buffer = std::move(receive_buffers_.back());
+		receive_buffers_.pop_back();
+	}
+	ON_SCOPE_EXIT(this, &buffer) {
+		if(receive_buffers_.size() < max_receive_buffers && buffer.capacity() <= max_receive_buffer_size) {
+			receive_buffers_.push_back(std::move(buffer));
+		}
+	};
+
+	buffer.resize(size);
+	async_read(*socket, boost::asio::buffer(buffer.data(), size), yield[ec]);
 	if(check_error(ec, socket)) return {};
 
-	try {
-		simple_wml::string_span compressed_buf(buffer.get(), size);
-		return std::make_unique<simple_wml::document>(compressed_buf);
-	}  catch (simple_wml::error& e) {
+	io_stats_.bytes_in[io_stats_index(socket)] += 4 + size;
+
+	std::unique_ptr<simple_wml::document> doc;
+	std::optional<std::string> error;
+
+	// Only touches the locals above, so it can run on any thread.
+	auto decode = [&doc, &error, &buffer, size]() {
+		try {
+			simple_wml::string_span compressed_buf(buffer.data(), size);
+			doc = std::make_unique<simple_wml::document>(compressed_buf);
+		} catch(simple_wml::error& e) {
+			error = e.message;
+		}
+	};
+
+	// Small documents are decoded faster than the threads could be switched.
+	const uint32_t min_pooled_size = 8 * 1024;
+
+	if(decode_pool_ && size >= min_pooled_size) {
+		boost::asio::async_completion<boost::asio::yield_context, void()> completion(yield);
+
+		// The handler resumes this coroutine on the event loop; the locals stay alive until then.
+		boost::asio::post(*decode_pool_, [&decode, handler = std::move(completion.completion_handler)]() mutable {
+			decode();
+			boost::asio::post(std::move(handler));
+		});
+
+		completion.result.get();
+	} else {
+		decode();
+	}
+
+	if(error) {
 		ERR_SERVER <<
 			log_address(socket) <<
-			"\tsimple_wml error in received data: " << e.message;
-		async_send_error(socket, "Invalid WML received: " + e.message);
+			"\tsimple_wml error in received data: " << *error;
+		async_send_error(socket, "Invalid WML received: " + *error);
 		return {};
 	}
+
+	return doc;
 }
 template std::unique_ptr<simple_wml::document> server_base::coro_receive_doc<socket_ptr>(socket_ptr socket, boost::asio::yield_context yield);
 template std::unique_ptr<simple_wml::document> server_base::coro_receive_doc<tls_socket_ptr>(tls_socket_ptr socket, boost::asio::yield_context yield);
 
-template<class SocketPtr> void server_base::send_doc_queued(SocketPtr socket, std::unique_ptr<simple_wml::document>& doc_ptr, boost::asio::yield_context yield)
+static void append_message(std::string& message, const simple_wml::string_span& compressed)
+{
+	const uint32_t data_size = htonl(compressed.size());
+	message.reserve(4 + compressed.size());
+	message.append(reinterpret_cast<const char*>(&data_size), 4);
+	message.append(compressed.begin(), compressed.size());
+}
+
+server_base::encoded_doc_ptr server_base::encode_doc(simple_wml::document& doc)
+{
+	auto encoded = std::make_shared<encoded_doc>();
+
+	try {
+		if(dump_wml) {
+			encoded->text = doc.output();
+		}
+
+		append_message(encoded->message, doc.output_compressed());
+	} catch (simple_wml::error& e) {
+		WRN_CONFIG << __func__ << ": simple_wml error: " << e.message;
+		throw;
+	}
+
+	return encoded;
+}
+
+server_base::encoded_doc_ptr server_base::encode_compressed(const simple_wml::string_span& compressed)
+{
+	if(dump_wml) {
+		simple_wml::document doc(compressed);
+		return encode_doc(doc);
+	}
+
+	auto encoded = std::make_shared<encoded_doc>();
+	append_message(encoded->message, compressed);
+	return encoded;
+}
+
+namespace {
+
+/** Documents waiting to be sent on one connection, with a FIFO per priority class. */
+struct send_queue
+{
+	/** Indexed by send_priority, where lobby_full shares the lobby FIFO. */
+	std::array<std::deque<server_base::encoded_doc_ptr>, 3> fifos;
+	/** Whether a coroutine is sending from this queue. */
+	bool sending = false;
+
+	static std::size_t fifo_index(server_base::send_priority priority)
+	{
+		return std::min(static_cast<std::size_t>(priority), std::size_t(2));
+	}
+
+	std::size_t size() const
+	{
+		return fifos[0].size() + fifos[1].size() + fifos[2].size();
+	}
+
+	/** Removes and returns the next document to send, or nullptr if there is none. */
+	server_base::encoded_doc_ptr pop()
+	{
+		for(auto& fifo : fifos) {
+			if(!fifo.empty()) {
+				server_base::encoded_doc_ptr doc = std::move(fifo.front());
+				fifo.pop_front();
+				return doc;
+			}
+		}
+
+		return nullptr;
+	}
+};
+
+} // namespace
+
+template<class SocketPtr> void server_base::send_doc_queued(SocketPtr socket, encoded_doc_ptr doc, send_priority priority, boost::asio::yield_context yield)
 {
-	static std::map<SocketPtr, std::queue<std::unique_ptr<simple_wml::document>>> queues;
+	static std::map<SocketPtr, send_queue> queues;
 
-	queues[socket].push(std::move(doc_ptr));
-	if(queues[socket].size() > 1) {
+	// The node stays put until the sending coroutine below erases it.
+	send_queue& queue = queues[socket];
+	auto& fifo = queue.fifos[send_queue::fifo_index(priority)];
+
+	if(priority == send_priority::lobby_full) {
+		// The client replaces its whole gamelist, so the diffs and lists before it are moot.
+		io_stats_.queued_docs -= fifo.size();
+		io_stats_.superseded_docs += fifo.size();
+		fifo.clear();
+	}
+
+	fifo.push_back(std::move(doc));
+	++io_stats_.queued_docs;
+	io_stats_.max_queue_depth = std::max(io_stats_.max_queue_depth, queue.size() + queue.sending);
+	if(queue.sending) {
 		return;
 	}
 
-	ON_SCOPE_EXIT(socket) { queues.erase(socket); };
+	queue.sending = true;
+	++io_stats_.send_coroutines;
+	ON_SCOPE_EXIT(this, socket) {
+		io_stats_.queued_docs -= queues[socket].size();
+		--io_stats_.send_coroutines;
+		queues.erase(socket);
+	};
+
+	while(const encoded_doc_ptr current = queue.pop()) {
+		ON_SCOPE_EXIT(this) {
+			--io_stats_.queued_docs;
+		};
+
+		if(dump_wml) {
+			std::cout << "Sending WML to " << log_address(socket) << ": \n" << current->text << std::endl;
+		}
 
-	while(queues[socket].size() > 0) {
-		coro_send_doc(socket, *(queues[socket].front()), yield);
-		ON_SCOPE_EXIT(socket) { queues[socket].pop(); };
+		boost::system::error_code ec;
+		async_write(*socket, boost::asio::buffer(current->message), yield[ec]);
+		if(check_error(ec, socket)) {
+			socket->lowest_layer().close();
+			return;
+		}
+
+		io_stats_.bytes_out[io_stats_index(socket)] += current->message.size();
 	}
 }
 
-template<class SocketPtr> void server_base::async_send_doc_queued(SocketPtr socket, simple_wml::document& doc)
+template<class SocketPtr> void server_base::async_send_doc_queued(SocketPtr socket, simple_wml::document& doc, send_priority priority)
+{
+	async_send_doc_queued(socket, encode_doc(doc), priority);
+}
+
+template<class SocketPtr> void server_base::async_send_doc_queued(SocketPtr socket, const encoded_doc_ptr& doc, send_priority priority)
 {
 	boost::asio::spawn(
-		io_service_, [this, doc_ptr = doc.clone(), socket](boost::asio::yield_context yield) mutable {
-			send_doc_queued(socket, doc_ptr, yield);
+		io_service_, [this, doc, socket, priority](boost::asio::yield_context yield) {
+			send_doc_queued(socket, doc, priority, yield);
 		}
 	);
 }
+template void server_base::async_send_doc_queued<socket_ptr>(socket_ptr socket, simple_wml::document& doc, send_priority priority);
+template void server_base::async_send_doc_queued<tls_socket_ptr>(tls_socket_ptr socket, simple_wml::document& doc, send_priority priority);
+template void server_base::async_send_doc_queued<socket_ptr>(socket_ptr socket, const encoded_doc_ptr& doc, send_priority priority);
+template void server_base::async_send_doc_queued<tls_socket_ptr>(tls_socket_ptr socket, const encoded_doc_ptr& doc, send_priority priority);
 
 template<class SocketPtr> void server_base::async_send_error(SocketPtr socket, const std::string& msg, const char* error_code, const info_table& info)
 {
@@ -627,6 +868,34 @@ void server_base::load_tls_config(const config& cfg)
 	tls_context_.use_certificate_chain_file(cfg["tls_fullchain"].str());
 	tls_context_.use_private_key_file(cfg["tls_private_key"].str(), boost::asio::ssl::context::pem);
 	if(!cfg["tls_dh"].str().empty()) tls_context_.use_tmp_dh_file(cfg["tls_dh"].str());
+
+	SSL_CTX* ctx = tls_context_.native_handle();
+
+	// Forward secret ciphers with hardware friendly or cheap software implementations first.
+	// This only applies to TLS 1.2, the TLS 1.3 suites are all of that kind already.
+	const std::string ciphers = cfg["tls_ciphers"].str("ECDHE+AESGCM:ECDHE+CHACHA20");
+	if(SSL_CTX_set_cipher_list(ctx, ciphers.c_str()) != 1) {
+		ERR_SERVER << "Invalid tls_ciphers '" << ciphers << "', keeping the OpenSSL defaults";
+	}
+	SSL_CTX_set_options(ctx, SSL_OP_CIPHER_SERVER_PREFERENCE);
+
+	// Let reconnecting clients resume their session instead of doing a full handshake,
+	// either from the cache here or from the ticket they were given.
+	static const unsigned char session_id_context[] = "wesnoth";
+	SSL_CTX_set_session_id_context(ctx, session_id_context, sizeof(session_id_context) - 1);
+	SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER);
+	SSL_CTX_sess_set_cache_size(ctx, cfg["tls_session_cache_size"].to_int(20480));
+	SSL_CTX_set_timeout(ctx, cfg["tls_session_timeout"].to_int(7200));
+
+	if(cfg["tls_session_tickets"].to_bool(true)) {
+		SSL_CTX_clear_options(ctx, SSL_OP_NO_TICKET);
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+		// Clients only keep the latest, the default of two per handshake is wasted work.
+		SSL_CTX_set_num_tickets(ctx, 1);
+#endif
+	} else {
+		SSL_CTX_set_options(ctx, SSL_OP_NO_TICKET);
+	}
 }
 
 std::string server_base::hash_password(const std::string& pw, const std::string& salt, const std::string& username)
@@ -673,6 +942,25 @@ std::string server_base::hash_password(const std::string& pw, const std::string&
 	}
 }
 
+std::string server_base::async_hash_password(boost::asio::yield_context yield, const std::string& pw, const std::string& salt, const std::string& username)
+{
+	if(!hash_pool_) {
+		return hash_password(pw, salt, username);
+	}
+
+	std::string hash;
+	boost::asio::async_completion<boost::asio::yield_context, void()> completion(yield);
+
+	// The handler resumes this coroutine on the event loop; the locals stay alive until then.
+	boost::asio::post(*hash_pool_, [&, handler = std::move(completion.completion_handler)]() mutable {
+		hash = hash_password(pw, salt, username);
+		boost::asio::post(std::move(handler));
+	});
+
+	completion.result.get();
+	return hash;
+}
+
 // This is just here to get it to build without the deprecation_message function
 #include "game_version.hpp"
 #include "deprecation.hpp"
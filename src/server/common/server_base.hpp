@@ -39,9 +39,13 @@
 #include <boost/asio/streambuf.hpp>
 #include <boost/asio/ssl.hpp>
 #include <boost/asio/spawn.hpp>
-#include <boost/shared_array.hpp>
+#include <boost/asio/thread_pool.hpp>
 
+#include <chrono>
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <string>
 
 extern bool dump_wml;
 
@@ -78,7 +82,40 @@ struct server_shutdown : public game::error
  */
 class server_base
 {
-	template<class SocketPtr> void send_doc_queued(SocketPtr socket, std::unique_ptr<simple_wml::document>& doc_ptr, boost::asio::yield_context yield);
+public:
+	/**
+	 * A WML document already encoded as a complete network message: the size header followed by the gzipped payload.
+	 *
+	 * It is immutable once built, so the same message can be queued to any number of connections.
+	 */
+	struct encoded_doc
+	{
+		std::string message;
+		/** Uncompressed WML, only kept when @ref dump_wml is set. */
+		std::string text;
+	};
+	typedef std::shared_ptr<const encoded_doc> encoded_doc_ptr;
+
+	/**
+	 * How urgent a queued document is.
+	 *
+	 * Each connection sends the oldest document of the most urgent class first,
+	 * so game data isn't held up behind chat or big lobby updates.
+	 */
+	enum class send_priority
+	{
+		/** Game data, [whiteboard] and replies to the client's requests. */
+		normal,
+		/** Chat, whispers and server messages. */
+		chat,
+		/** Gamelist diffs and other lobby updates. */
+		lobby,
+		/** A full gamelist, which makes the lobby documents still queued before it obsolete. */
+		lobby_full
+	};
+
+private:
+	template<class SocketPtr> void send_doc_queued(SocketPtr socket, encoded_doc_ptr doc, send_priority priority, boost::asio::yield_context yield);
 
 public:
 	server_base(unsigned short port, bool keep_alive);
@@ -112,11 +149,30 @@ public:
 	 * High level wrapper for sending a WML document
 	 *
 	 * This function returns before send is finished. This function can be called again on same socket before previous send was finished.
-	 * WML documents are kept in internal queue and sent in FIFO order.
+	 * WML documents are kept in internal queue and sent in FIFO order within each @ref send_priority.
 	 * @param socket
-	 * @param doc Document to send. A copy of it will be made so there is no need to keep the reference live after the function returns.
+	 * @param doc Document to send. It is encoded right away so there is no need to keep the reference live after the function returns.
+	 * @param priority
+	 */
+	template<class SocketPtr> void async_send_doc_queued(SocketPtr socket, simple_wml::document& doc, send_priority priority = send_priority::normal);
+	/**
+	 * Queue an already encoded document, see @ref encode_doc.
+	 *
+	 * Only a reference to the message is kept, so this is the cheap way to send one document to many connections.
 	 */
-	template<class SocketPtr> void async_send_doc_queued(SocketPtr socket, simple_wml::document& doc);
+	template<class SocketPtr> void async_send_doc_queued(SocketPtr socket, const encoded_doc_ptr& doc, send_priority priority = send_priority::normal);
+
+	/**
+	 * Serialize and compress a WML document once so it can be sent to several connections.
+	 * @param doc
+	 * @return The encoded message, shared between every queue it is added to.
+	 */
+	static encoded_doc_ptr encode_doc(simple_wml::document& doc);
+	/**
+	 * Wrap data that is already gzipped WML as a message, without parsing or recompressing it.
+	 * @param compressed
+	 */
+	static encoded_doc_ptr encode_compressed(const simple_wml::string_span& compressed);
 
 	typedef std::map<std::string, std::string> info_table;
 	template<class SocketPtr> void async_send_error(SocketPtr socket, const std::string& msg, const char* error_code = "", const info_table& info = {});
@@ -147,6 +203,12 @@ public:
 	 */
 	std::string hash_password(const std::string& pw, const std::string& salt, const std::string& username);
 
+	/**
+	 * Same as hash_password(), but run on #hash_pool_ while the calling coroutine is suspended.
+	 * Each bcrypt hash takes milliseconds, which would otherwise hold up everyone else.
+	 */
+	std::string async_hash_password(boost::asio::yield_context yield, const std::string& pw, const std::string& salt, const std::string& username);
+
 protected:
 	unsigned short port_;
 	bool keep_alive_;
@@ -156,6 +218,49 @@ protected:
 	boost::asio::ip::tcp::acceptor acceptor_v6_;
 	boost::asio::ip::tcp::acceptor acceptor_v4_;
 
+	/**
+	 * Threads decompressing and parsing large received documents, so that
+	 * the event loop keeps serving everyone else meanwhile. Null if all
+	 * of it happens on the event loop.
+	 */
+	std::unique_ptr<boost::asio::thread_pool> decode_pool_;
+
+	/** Starts @a threads threads for #decode_pool_, none means decoding on the event loop. */
+	void start_decode_pool(std::size_t threads);
+
+	/** Threads hashing passwords for async_hash_password(). Null if it happens on the event loop. */
+	std::unique_ptr<boost::asio::thread_pool> hash_pool_;
+
+	/** Starts @a threads threads for #hash_pool_, none means hashing on the event loop. */
+	void start_hash_pool(std::size_t threads);
+
+	/**
+	 * Buffers of finished receives, handed to the next ones so that every
+	 * message doesn't allocate its own. Only touched from the event loop.
+	 */
+	std::vector<std::vector<char>> receive_buffers_;
+
+	/** Network counters, only touched from the event loop. */
+	struct io_stats
+	{
+		/** Traffic of plain (0) and TLS (1) connections. */
+		std::uint64_t bytes_in[2] {};
+		std::uint64_t bytes_out[2] {};
+		/** Documents waiting in send queues, and the longest a single queue has been. */
+		std::size_t queued_docs { 0 };
+		std::size_t max_queue_depth { 0 };
+		/** Queued lobby documents dropped because a full gamelist was queued after them. */
+		std::uint64_t superseded_docs { 0 };
+		/** Coroutines currently running a send queue. */
+		std::size_t send_coroutines { 0 };
+		/** Successful TLS handshakes, how many resumed a session, and their total time. */
+		std::uint64_t tls_handshakes { 0 };
+		std::uint64_t tls_resumed { 0 };
+		std::chrono::steady_clock::duration tls_handshake_time { 0 };
+		std::uint64_t tls_handshake_failures { 0 };
+	};
+	io_stats io_stats_;
+
 	void load_tls_config(const config& cfg);
 
 	void start_server();
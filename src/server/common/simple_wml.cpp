@@ -13,9 +13,12 @@
 	See the COPYING file for more details.
 */
 
+#include <algorithm>
+#include <mutex>
 #include <sstream>
 
 #include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/array.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
 #include <boost/iostreams/filter/bzip2.hpp>
 #include <boost/iostreams/filter/counter.hpp>
@@ -36,16 +39,13 @@ std::size_t document::document_size_limit = 40000000;
 
 namespace {
 
-void debug_delete(node* n) {
-	delete n;
-}
-
 char* uncompress_buffer(const string_span& input, string_span* span)
 {
 	int nalloc = input.size();
 	int state = 0;
 	try {
-		std::istringstream stream(std::string(input.begin(), input.end()));
+		// Read the input in place, it can be a few megabytes.
+		boost::iostreams::array_source stream(input.begin(), input.size());
 		state = 1;
 		boost::iostreams::filtering_stream<boost::iostreams::input> filter;
 		state = 2;
@@ -211,7 +211,8 @@ node::node(document& doc, node* parent) :
 	parent_(parent),
 	children_(),
 	ordered_children_(),
-	output_cache_()
+	output_cache_(),
+	in_arena_(false)
 {
 }
 
@@ -225,7 +226,8 @@ node::node(document& doc, node* parent, const char** str, int depth) :
 	parent_(parent),
 	children_(),
 	ordered_children_(),
-	output_cache_()
+	output_cache_(),
+	in_arena_(false)
 {
 	if(depth >= 1000) {
 		throw error("elements nested too deep");
@@ -254,12 +256,18 @@ node::node(document& doc, node* parent, const char** str, int depth) :
 				throw error("unterminated element");
 			}
 
+			if(children_.empty()) {
+				// Most nodes with children have a few of them, skip the first reallocations.
+				children_.reserve(2);
+				ordered_children_.reserve(4);
+			}
+
 			const int list_index = get_children(string_span(s, end - s));
 			check_ordered_children();
 
 			s = end + 1;
 
-			children_[list_index].second.push_back(new node(doc, this, str, depth+1));
+			children_[list_index].second.push_back(doc.parse_node(this, str, depth+1));
 			ordered_children_.emplace_back(list_index, children_[list_index].second.size() - 1);
 			check_ordered_children();
 
@@ -353,6 +361,11 @@ node::node(document& doc, node* parent, const char** str, int depth) :
 
 			s = end + 1;
 
+			if(attr_.empty()) {
+				// Same as above, most nodes have a handful of attributes.
+				attr_.reserve(4);
+			}
+
 			attr_.emplace_back(name, value);
 		}
 		}
@@ -362,11 +375,20 @@ node::node(document& doc, node* parent, const char** str, int depth) :
 	check_ordered_children();
 }
 
+void node::destroy(node* n)
+{
+	if(n && n->in_arena_) {
+		n->~node();
+	} else {
+		delete n;
+	}
+}
+
 node::~node()
 {
 	for(child_map::iterator i = children_.begin(); i != children_.end(); ++i) {
 		for(child_list::iterator j = i->second.begin(); j != i->second.end(); ++j) {
-			debug_delete(*j);
+			node::destroy(*j);
 		}
 	}
 }
@@ -493,7 +515,7 @@ void node::remove_child(const string_span& name, std::size_t index)
 
 	remove_ordered_child(std::distance(children_.begin(), itor), index);
 
-	debug_delete(list[index]);
+	node::destroy(list[index]);
 	list.erase(list.begin() + index);
 
 	if(list.empty()) {
@@ -940,6 +962,7 @@ document::document() :
 	compressed_buf_(),
 	output_(nullptr),
 	buffers_(),
+	arena_(),
 	root_(new node(*this, nullptr)),
 	prev_(nullptr),
 	next_(nullptr)
@@ -951,6 +974,7 @@ document::document(char* buf, INIT_BUFFER_CONTROL control) :
 	compressed_buf_(),
 	output_(buf),
 	buffers_(),
+	arena_(),
 	root_(nullptr),
 	prev_(nullptr),
 	next_(nullptr)
@@ -959,7 +983,7 @@ document::document(char* buf, INIT_BUFFER_CONTROL control) :
 		buffers_.push_back(buf);
 	}
 	const char* cbuf = buf;
-	root_ = new node(*this, nullptr, &cbuf);
+	root_ = parse_node(nullptr, &cbuf);
 
 	attach_list();
 }
@@ -968,6 +992,7 @@ document::document(const char* buf, INIT_STATE state) :
 	compressed_buf_(),
 	output_(buf),
 	buffers_(),
+	arena_(),
 	root_(nullptr),
 	prev_(nullptr),
 	next_(nullptr)
@@ -976,7 +1001,7 @@ document::document(const char* buf, INIT_STATE state) :
 		output_compressed();
 		output_ = nullptr;
 	} else {
-		root_ = new node(*this, nullptr, &buf);
+		root_ = parse_node(nullptr, &buf);
 	}
 
 	attach_list();
@@ -986,6 +1011,7 @@ document::document(string_span compressed_buf) :
 	compressed_buf_(compressed_buf),
 	output_(nullptr),
 	buffers_(),
+	arena_(),
 	root_(nullptr),
 	prev_(nullptr),
 	next_(nullptr)
@@ -995,7 +1021,7 @@ document::document(string_span compressed_buf) :
 	output_ = uncompressed_buf.begin();
 	const char* cbuf = output_;
 	try {
-		root_ = new node(*this, nullptr, &cbuf);
+		root_ = parse_node(nullptr, &cbuf);
 	} catch(...) {
 		ERR_SWML << "Caught exception creating a new simple_wml node: " << utils::get_unknown_exception_type();
 		delete [] buffers_.front();
@@ -1006,6 +1032,60 @@ document::document(string_span compressed_buf) :
 	attach_list();
 }
 
+node_arena::node_arena() :
+	chunks_(),
+	chunk_size_(0),
+	used_(0),
+	reserved_(0)
+{
+}
+
+void* node_arena::allocate()
+{
+	// Small documents are the common case, so start small and double.
+	const std::size_t first_chunk_size = 16;
+	const std::size_t max_chunk_size = 4096;
+
+	if(used_ == chunk_size_) {
+		chunk_size_ = chunk_size_ == 0 ? first_chunk_size : std::min(2 * chunk_size_, max_chunk_size);
+		chunks_.emplace_back(new slot[chunk_size_]);
+		used_ = 0;
+		reserved_ += chunk_size_;
+	}
+
+	return &chunks_.back()[used_++];
+}
+
+void node_arena::release()
+{
+	if(chunks_.size() > 1) {
+		chunks_.front() = std::move(chunks_.back());
+		chunks_.resize(1);
+		reserved_ = chunk_size_;
+	}
+	used_ = 0;
+}
+
+void node_arena::swap(node_arena& o)
+{
+	chunks_.swap(o.chunks_);
+	std::swap(chunk_size_, o.chunk_size_);
+	std::swap(used_, o.used_);
+	std::swap(reserved_, o.reserved_);
+}
+
+std::size_t node_arena::capacity() const
+{
+	return reserved_ * sizeof(slot);
+}
+
+node* document::parse_node(node* parent, const char** str, int depth)
+{
+	node* n = new(arena_.allocate()) node(*this, parent, str, depth);
+	n->in_arena_ = true;
+	return n;
+}
+
 document::~document()
 {
 	for(std::vector<char*>::iterator i = buffers_.begin(); i != buffers_.end(); ++i) {
@@ -1013,7 +1093,7 @@ document::~document()
 	}
 
 	buffers_.clear();
-	debug_delete(root_);
+	node::destroy(root_);
 
 	detach_list();
 }
@@ -1088,8 +1168,9 @@ string_span document::output_compressed(bool bzip2)
 void document::compress()
 {
 	output_compressed();
-	debug_delete(root_);
+	node::destroy(root_);
 	root_ = nullptr;
+	arena_.release();
 	output_ = nullptr;
 	std::vector<char*> new_buffers;
 	for(std::vector<char*>::iterator i = buffers_.begin(); i != buffers_.end(); ++i) {
@@ -1115,7 +1196,7 @@ void document::generate_root()
 
 	assert(root_ == nullptr);
 	const char* cbuf = output_;
-	root_ = new node(*this, nullptr, &cbuf);
+	root_ = parse_node(nullptr, &cbuf);
 }
 
 std::unique_ptr<document> document::clone()
@@ -1130,6 +1211,7 @@ void document::swap(document& o)
 	std::swap(compressed_buf_, o.compressed_buf_);
 	std::swap(output_, o.output_);
 	buffers_.swap(o.buffers_);
+	arena_.swap(o.arena_);
 	std::swap(root_, o.root_);
 
 	root_->set_doc(this);
@@ -1140,7 +1222,8 @@ void document::clear()
 {
 	compressed_buf_ = string_span();
 	output_ = nullptr;
-	debug_delete(root_);
+	node::destroy(root_);
+	arena_.release();
 	root_ = new node(*this, nullptr);
 	for(std::vector<char*>::iterator i = buffers_.begin(); i != buffers_.end(); ++i) {
 		delete [] *i;
@@ -1151,10 +1234,15 @@ void document::clear()
 
 namespace {
 document* head_doc = nullptr;
+
+// Documents may be created on other threads than the one using them, e.g. wesnothd's decoding threads.
+std::mutex doc_list_mutex;
 }
 
 void document::attach_list()
 {
+	std::scoped_lock lock(doc_list_mutex);
+
 	prev_ = nullptr;
 	next_ = head_doc;
 
@@ -1166,6 +1254,8 @@ void document::attach_list()
 
 void document::detach_list()
 {
+	std::scoped_lock lock(doc_list_mutex);
+
 	if(head_doc == this) {
 		head_doc = next_;
 	}
@@ -1192,9 +1282,14 @@ std::string document::stats()
 	int nnodes = 0;
 	int ndirty = 0;
 	int nattributes = 0;
+	int arena_size = 0;
+
+	std::scoped_lock lock(doc_list_mutex);
+
 	for(document* d = head_doc; d != nullptr; d = d->next_) {
 		ndocs++;
 		nbuffers += d->buffers_.size();
+		arena_size += d->arena_.capacity();
 
 		if(d->compressed_buf_.is_null() == false) {
 			++ncompressed;
@@ -1229,6 +1324,7 @@ std::string document::stats()
 	  << "Nodes: " << nnodes << " (" << nodes_alloc << " bytes)\n"
 	  << "Attr: " << nattributes << " (" << attr_alloc << " bytes)\n"
 	  << "Buffers: " << nbuffers << "\n"
+	  << "Node arenas: " << arena_size << " bytes\n"
 	  << "Total allocation: " << total_alloc << " bytes\n";
 
 	return s.str();
@@ -20,9 +20,14 @@ class config;
 #include "exceptions.hpp"
 
 #include <ctime>
+#include <exception>
+#include <optional>
 #include <string>
 
 #include <boost/asio/io_service.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/thread_pool.hpp>
 
 #include "server/wesnothd/player_connection.hpp"
 
@@ -153,4 +158,39 @@ public:
 	virtual void get_users_for_ip(const std::string& ip, std::ostringstream* out) = 0;
 	virtual void get_ips_for_user(const std::string& username, std::ostringstream* out) = 0;
 	virtual void db_update_addon_download_count(const std::string& instance_version, const std::string& id, const std::string& version) = 0;
+
+	/** The threads the blocking calls above should be run on, so they don't stall the event loop. */
+	virtual boost::asio::thread_pool::executor_type query_executor() = 0;
+
+	/**
+	 * Runs @a query on #query_executor() and suspends the calling coroutine until it is done.
+	 *
+	 * @param yield The coroutine to resume on its own executor once @a query has returned.
+	 * @param query Any callable with a non-void result, usually a few calls on this object.
+	 * @return The result of @a query. Exceptions thrown by it are rethrown here.
+	 */
+	template<typename Query>
+	auto async_query(boost::asio::yield_context yield, Query query) -> decltype(query())
+	{
+		std::optional<decltype(query())> result;
+		std::exception_ptr failure;
+		boost::asio::async_completion<boost::asio::yield_context, void()> completion(yield);
+
+		// The handler resumes this coroutine on the event loop; the locals stay alive until then.
+		boost::asio::post(query_executor(), [&, handler = std::move(completion.completion_handler)]() mutable {
+			try {
+				result.emplace(query());
+			} catch(...) {
+				failure = std::current_exception();
+			}
+			boost::asio::post(std::move(handler));
+		});
+
+		completion.result.get();
+
+		if(failure) {
+			std::rethrow_exception(failure);
+		}
+		return std::move(*result);
+	}
 };
@@ -0,0 +1,449 @@
+/*
+	Copyright (C) 2022
+	Part of the Battle for Wesnoth Project https://www.wesnoth.org/
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY.
+
+	See the COPYING file for more details.
+*/
+
+/**
+ * @file
+ * Load generator for wesnothd.
+ *
+ * Opens many simulated client sessions against a server. Each session does
+ * the handshake, sends its version and logs in, then until the test ends
+ * repeatedly:
+ * - sends a [query] and measures the time until the server answers it,
+ * - sends a lobby chat message, which the server relays to everyone,
+ * - if it is a hosting session, alternately creates a game and leaves it,
+ *   which makes the server send gamelist diffs to the whole lobby.
+ *
+ * All sessions keep reading what the server sends them, like a real client.
+ * At the end, the login and query latency percentiles are printed.
+ *
+ * Like wesnothd, all sessions run as coroutines on a single thread. To
+ * generate more load than one core can, run several instances.
+ */
+
+#include "game_version.hpp"
+#include "server/common/simple_wml.hpp"
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/spawn.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/write.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+using clock = std::chrono::steady_clock;
+
+struct options
+{
+	std::string host = "localhost";
+	std::string port = "15000";
+	std::string version = game_config::wesnoth_version.str();
+	std::size_t clients = 100;
+	std::size_t host_every = 10;
+	std::chrono::seconds duration{60};
+	std::chrono::seconds ramp_up{10};
+	std::chrono::milliseconds interval{5000};
+	std::chrono::seconds reply_timeout{10};
+};
+
+/** What a session measured. Owned by the session, merged after the test. */
+struct session_stats
+{
+	std::vector<double> login_ms;
+	std::vector<double> query_ms;
+	std::size_t sent = 0;
+	std::size_t received = 0;
+	std::size_t timeouts = 0;
+	std::size_t failures = 0;
+};
+
+class session : public std::enable_shared_from_this<session>
+{
+public:
+	session(boost::asio::io_context& io, const options& opts, const boost::asio::ip::tcp::resolver::results_type& endpoints, std::size_t id)
+		: io_(io)
+		, socket_(io)
+		, reply_timer_(io)
+		, sleep_timer_(io)
+		, opts_(opts)
+		, endpoints_(endpoints)
+		, id_(id)
+		, name_("loadtest" + std::to_string(id))
+		, awaiting_reply_(false)
+		, query_sent_()
+		, rng_(id)
+		, stats_()
+	{
+	}
+
+	void start()
+	{
+		boost::asio::spawn(io_, [self = shared_from_this()](boost::asio::yield_context yield) { self->run(yield); });
+	}
+
+	const session_stats& stats() const
+	{
+		return stats_;
+	}
+
+private:
+	void run(boost::asio::yield_context yield)
+	{
+		boost::system::error_code ec;
+
+		// Spread the logins over the ramp up time rather than opening every connection at once.
+		sleep_timer_.expires_after(opts_.ramp_up * id_ / opts_.clients);
+		sleep_timer_.async_wait(yield[ec]);
+
+		if(!log_in(yield)) {
+			++stats_.failures;
+			socket_.close(ec);
+			return;
+		}
+
+		boost::asio::spawn(io_, [self = shared_from_this()](boost::asio::yield_context yield) { self->read_loop(yield); });
+
+		const bool hosting = opts_.host_every != 0 && id_ % opts_.host_every == 0;
+		bool in_game = false;
+		const auto end = clock::now() + opts_.duration;
+
+		while(clock::now() < end && socket_.is_open()) {
+			simple_wml::document query;
+			query.root().add_child("query").set_attr("type", "version");
+			awaiting_reply_ = true;
+			query_sent_ = clock::now();
+			if(!send(query, yield)) {
+				break;
+			}
+
+			// The read loop cancels the timer when the answer arrives.
+			reply_timer_.expires_after(opts_.reply_timeout);
+			reply_timer_.async_wait(yield[ec]);
+			if(awaiting_reply_) {
+				awaiting_reply_ = false;
+				++stats_.timeouts;
+			}
+
+			simple_wml::document chat;
+			simple_wml::node& message = chat.root().add_child("message");
+			message.set_attr_dup("sender", name_.c_str());
+			message.set_attr("message", "Load test message");
+			if(!send(chat, yield)) {
+				break;
+			}
+
+			if(hosting) {
+				if(in_game ? leave_game(yield) : create_game(yield)) {
+					in_game = !in_game;
+				} else {
+					break;
+				}
+			}
+
+			// Some jitter keeps the sessions from falling into lockstep.
+			sleep_timer_.expires_after(opts_.interval / 2 + opts_.interval * static_cast<int>(rng_() % 1000) / 1000);
+			sleep_timer_.async_wait(yield[ec]);
+		}
+
+		socket_.close(ec);
+	}
+
+	bool log_in(boost::asio::yield_context yield)
+	{
+		boost::system::error_code ec;
+		const auto start = clock::now();
+
+		boost::asio::async_connect(socket_, endpoints_, yield[ec]);
+		if(ec) {
+			std::cerr << name_ << ": connection failed: " << ec.message() << "\n";
+			return false;
+		}
+
+		// Handshake for an unencrypted connection, see server_base.
+		std::array<std::uint8_t, 4> handshake{0, 0, 0, 0};
+		boost::asio::async_write(socket_, boost::asio::buffer(handshake), yield[ec]);
+		if(!ec) {
+			boost::asio::async_read(socket_, boost::asio::buffer(handshake), yield[ec]);
+		}
+		if(ec) {
+			std::cerr << name_ << ": handshake failed: " << ec.message() << "\n";
+			return false;
+		}
+
+		if(!receive(yield, [](simple_wml::document& doc) { return doc.child("version") != nullptr; })) {
+			return false;
+		}
+
+		simple_wml::document version;
+		version.root().add_child("version").set_attr_dup("version", opts_.version.c_str());
+		if(!send(version, yield)) {
+			return false;
+		}
+
+		if(!receive(yield, [](simple_wml::document& doc) { return doc.child("mustlogin") != nullptr; })) {
+			return false;
+		}
+
+		simple_wml::document login;
+		login.root().add_child("login").set_attr_dup("username", name_.c_str());
+		if(!send(login, yield)) {
+			return false;
+		}
+
+		if(!receive(yield, [](simple_wml::document& doc) { return doc.child("join_lobby") != nullptr; })) {
+			return false;
+		}
+
+		stats_.login_ms.push_back(std::chrono::duration<double, std::milli>(clock::now() - start).count());
+		return true;
+	}
+
+	bool create_game(boost::asio::yield_context yield)
+	{
+		simple_wml::document create;
+		create.root().add_child("create_game").set_attr_dup("name", (name_ + "'s game").c_str());
+		if(!send(create, yield)) {
+			return false;
+		}
+
+		// The smallest level data the server accepts as a game description.
+		simple_wml::document level;
+		level.root().add_child("scenario");
+		level.root().add_child("multiplayer").set_attr("scenario", "loadtest");
+		return send(level, yield);
+	}
+
+	bool leave_game(boost::asio::yield_context yield)
+	{
+		simple_wml::document leave;
+		leave.root().add_child("leave_game");
+		return send(leave, yield);
+	}
+
+	void read_loop(boost::asio::yield_context yield)
+	{
+		while(receive(yield, [this](simple_wml::document& doc) {
+			const simple_wml::node* message = doc.child("message");
+			if(awaiting_reply_ && message && (*message)["sender"] == "server") {
+				stats_.query_ms.push_back(std::chrono::duration<double, std::milli>(clock::now() - query_sent_).count());
+				awaiting_reply_ = false;
+				reply_timer_.cancel();
+			}
+			return true;
+		})) {
+		}
+	}
+
+	bool send(simple_wml::document& doc, boost::asio::yield_context yield)
+	{
+		const simple_wml::string_span data = doc.output_compressed();
+		const std::uint32_t size = htonl(data.size());
+
+		const std::array<boost::asio::const_buffer, 2> buffers{
+			boost::asio::buffer(&size, 4),
+			boost::asio::buffer(data.begin(), data.size())
+		};
+
+		boost::system::error_code ec;
+		boost::asio::async_write(socket_, buffers, yield[ec]);
+		if(ec) {
+			return false;
+		}
+
+		++stats_.sent;
+		return true;
+	}
+
+	/**
+	 * Reads documents until @a handler accepts one.
+	 *
+	 * Documents with an [error] end the session, as the server closes the
+	 * connection after sending them.
+	 */
+	template<typename Handler>
+	bool receive(boost::asio::yield_context yield, const Handler& handler)
+	{
+		for(;;) {
+			boost::system::error_code ec;
+			std::uint32_t size;
+			boost::asio::async_read(socket_, boost::asio::buffer(&size, 4), yield[ec]);
+			if(ec) {
+				return false;
+			}
+
+			buffer_.resize(ntohl(size));
+			boost::asio::async_read(socket_, boost::asio::buffer(buffer_), yield[ec]);
+			if(ec) {
+				return false;
+			}
+
+			++stats_.received;
+
+			try {
+				simple_wml::document doc(simple_wml::string_span(buffer_.data(), buffer_.size()));
+
+				if(const simple_wml::node* error = doc.child("error")) {
+					std::cerr << name_ << ": server error: " << (*error)["message"].to_string() << "\n";
+					return false;
+				}
+
+				if(handler(doc)) {
+					return true;
+				}
+			} catch(const simple_wml::error& e) {
+				std::cerr << name_ << ": invalid WML received: " << e.message << "\n";
+				return false;
+			}
+		}
+	}
+
+	boost::asio::io_context& io_;
+	boost::asio::ip::tcp::socket socket_;
+	boost::asio::steady_timer reply_timer_;
+	boost::asio::steady_timer sleep_timer_;
+
+	const options& opts_;
+	const boost::asio::ip::tcp::resolver::results_type& endpoints_;
+	std::size_t id_;
+	std::string name_;
+
+	bool awaiting_reply_;
+	clock::time_point query_sent_;
+	std::vector<char> buffer_;
+	std::minstd_rand rng_;
+
+	session_stats stats_;
+};
+
+void print_percentiles(const std::string& name, std::vector<double> samples)
+{
+	std::cout << std::left << std::setw(8) << name << std::right << std::setw(10) << samples.size();
+
+	if(samples.empty()) {
+		std::cout << "\n";
+		return;
+	}
+
+	std::sort(samples.begin(), samples.end());
+	for(double percentile : {0.5, 0.9, 0.99}) {
+		const std::size_t index = static_cast<std::size_t>(percentile * (samples.size() - 1));
+		std::cout << std::setw(10) << std::fixed << std::setprecision(1) << samples[index];
+	}
+	std::cout << std::setw(10) << samples.back() << "\n";
+}
+
+void usage(const char* program)
+{
+	std::cerr
+		<< "Usage: " << program << " [options]\n"
+		<< "  --host <host>          server to connect to (default localhost)\n"
+		<< "  --port <port>          port of the server (default 15000)\n"
+		<< "  --clients <n>          number of simulated clients (default 100)\n"
+		<< "  --duration <seconds>   how long each client stays connected (default 60)\n"
+		<< "  --ramp-up <seconds>    time over which the clients connect (default 10)\n"
+		<< "  --interval <ms>        average time between a client's actions (default 5000)\n"
+		<< "  --host-every <n>       every nth client creates and leaves games, 0 for none (default 10)\n"
+		<< "  --version <version>    version the clients claim to be (default this build's)\n";
+}
+
+} // end anon namespace
+
+int main(int argc, char** argv)
+{
+	options opts;
+
+	for(int arg = 1; arg < argc; ++arg) {
+		const std::string val(argv[arg]);
+		if(arg + 1 == argc) {
+			usage(argv[0]);
+			return 2;
+		}
+
+		const std::string next(argv[++arg]);
+		if(val == "--host") {
+			opts.host = next;
+		} else if(val == "--port") {
+			opts.port = next;
+		} else if(val == "--clients") {
+			opts.clients = std::max(1, std::atoi(next.c_str()));
+		} else if(val == "--duration") {
+			opts.duration = std::chrono::seconds(std::atoi(next.c_str()));
+		} else if(val == "--ramp-up") {
+			opts.ramp_up = std::chrono::seconds(std::atoi(next.c_str()));
+		} else if(val == "--interval") {
+			opts.interval = std::chrono::milliseconds(std::max(1, std::atoi(next.c_str())));
+		} else if(val == "--host-every") {
+			opts.host_every = std::max(0, std::atoi(next.c_str()));
+		} else if(val == "--version") {
+			opts.version = next;
+		} else {
+			usage(argv[0]);
+			return 2;
+		}
+	}
+
+	boost::asio::io_context io;
+
+	boost::system::error_code ec;
+	boost::asio::ip::tcp::resolver resolver(io);
+	const auto endpoints = resolver.resolve(opts.host, opts.port, ec);
+	if(ec) {
+		std::cerr << "Could not resolve " << opts.host << ": " << ec.message() << "\n";
+		return 1;
+	}
+
+	std::vector<std::shared_ptr<session>> sessions;
+	for(std::size_t i = 0; i < opts.clients; ++i) {
+		sessions.push_back(std::make_shared<session>(io, opts, endpoints, i));
+		sessions.back()->start();
+	}
+
+	io.run();
+
+	session_stats total;
+	for(const auto& s : sessions) {
+		const session_stats& stats = s->stats();
+		total.login_ms.insert(total.login_ms.end(), stats.login_ms.begin(), stats.login_ms.end());
+		total.query_ms.insert(total.query_ms.end(), stats.query_ms.begin(), stats.query_ms.end());
+		total.sent += stats.sent;
+		total.received += stats.received;
+		total.timeouts += stats.timeouts;
+		total.failures += stats.failures;
+	}
+
+	std::cout << "Sessions: " << opts.clients << " (" << total.failures << " failed to log in)\n"
+		<< "Documents sent: " << total.sent << ", received: " << total.received << "\n"
+		<< "Queries without an answer within " << opts.reply_timeout.count() << "s: " << total.timeouts << "\n\n";
+
+	std::cout << std::left << std::setw(8) << "ms" << std::right << std::setw(10) << "samples"
+		<< std::setw(10) << "p50" << std::setw(10) << "p90" << std::setw(10) << "p99" << std::setw(10) << "max" << "\n";
+	print_percentiles("login", total.login_ms);
+	print_percentiles("query", total.query_ms);
+
+	return total.failures == 0 ? 0 : 1;
+}
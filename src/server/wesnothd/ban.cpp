@@ -282,7 +282,13 @@ void ban_manager::read()
 	for(const config& b : cfg.child_range("ban")) {
 		try {
 			auto new_ban = std::make_shared<banned>(b);
-			assert(bans_.insert(new_ban).second);
+			// Not an assert: the insertion must also happen in release builds
+			if(!bans_.insert(new_ban).second) {
+				ERR_SERVER << "Ignoring duplicate ban on " << new_ban->get_ip() << " while reading bans";
+				continue;
+			}
+
+			index_ban(new_ban);
 
 			if (new_ban->get_end_time() != 0)
 				time_queue_.push(new_ban);
@@ -505,6 +511,7 @@ std::string ban_manager::ban(const std::string& ip,
 		if((ban = bans_.find(std::make_shared<banned>(ip))) != bans_.end()) {
 			// Already exsiting ban for ip. We have to first remove it
 			ret << "Overwriting ban: " << (**ban) << "\n";
+			unindex_ban(*ban);
 			bans_.erase(ban);
 		}
 	} catch(const banned::error& e) {
@@ -515,6 +522,7 @@ std::string ban_manager::ban(const std::string& ip,
 	try {
 		auto new_ban = std::make_shared<banned>(ip, end_time, reason, who_banned, group, nick);
 		bans_.insert(new_ban);
+		index_ban(new_ban);
 		if(end_time != 0) {
 			time_queue_.push(new_ban);
 		}
@@ -549,6 +557,7 @@ void ban_manager::unban(std::ostringstream& os, const std::string& ip, bool imme
 	os << "Ban on '" << **ban << "' removed.";
 	// group bans don't get saved
 	if ((*ban)->get_group().empty()) deleted_bans_.push_back(*ban);
+	unindex_ban(*ban);
 	bans_.erase(ban);
 	dirty_ = true;
 	if(immediate_write) {
@@ -563,6 +572,12 @@ void ban_manager::unban_group(std::ostringstream& os, const std::string& group)
 	std::remove_copy_if(bans_.begin(), bans_.end(), temp_inserter, [&group](const banned_ptr& p) { return p->match_group(group); });
 
 	os << "Removed " << (bans_.size() - temp.size()) << " bans";
+	for(const auto& b : bans_) {
+		if(b->match_group(group)) {
+			unindex_ban(b);
+		}
+	}
+
 	bans_.swap(temp);
 	dirty_ = true;
 	write();
@@ -580,11 +595,18 @@ void ban_manager::check_ban_times(std::time_t time_now)
 			break;
 		}
 
+		time_queue_.pop();
+
+		// The ban may have been lifted or replaced by a new one on the same IP since it was queued.
+		const auto current = bans_.find(ban);
+		if(current == bans_.end() || *current != ban) {
+			continue;
+		}
+
 		// This ban is going to expire so delete it.
 		LOG_SERVER << "Remove a ban " << ban->get_ip() << ". time: " << time_now << " end_time " << ban->get_end_time();
 		std::ostringstream os;
 		unban(os, ban->get_ip(), false);
-		time_queue_.pop();
 	}
 
 	// Save bans if there is any new ones
@@ -664,10 +686,41 @@ std::string ban_manager::is_ip_banned(const std::string& ip)
 		return "";
 	}
 
-	auto ban = std::find_if(bans_.begin(), bans_.end(), [pair](const banned_ptr& p) { return p->match_ip(pair); });
-	if (ban == bans_.end()) return "";
-	const std::string& nick = (*ban)->get_nick();
-	return (*ban)->get_reason() + (nick.empty() ? "" : " (" + nick + ")") + " (Remaining ban duration: " + (*ban)->get_human_time_span() + ")";
+	// Only a handful of distinct masks are in use, so check each of them
+	// and report the matching ban with the lowest IP, like a scan of bans_ would.
+	banned_ptr ban;
+	for(const auto& [mask, by_ip] : ban_index_) {
+		const auto match = by_ip.find(pair.first & mask);
+		if(match != by_ip.end() && (!ban || match->second->get_int_ip() < ban->get_int_ip())) {
+			ban = match->second;
+		}
+	}
+
+	if (!ban) return "";
+	const std::string& nick = ban->get_nick();
+	return ban->get_reason() + (nick.empty() ? "" : " (" + nick + ")") + " (Remaining ban duration: " + ban->get_human_time_span() + ")";
+}
+
+void ban_manager::index_ban(const banned_ptr& ban)
+{
+	ban_index_[ban->mask()][ban->get_int_ip() & ban->mask()] = ban;
+}
+
+void ban_manager::unindex_ban(const banned_ptr& ban)
+{
+	const auto by_mask = ban_index_.find(ban->mask());
+	if(by_mask == ban_index_.end()) {
+		return;
+	}
+
+	const auto match = by_mask->second.find(ban->get_int_ip() & ban->mask());
+	if(match != by_mask->second.end() && match->second == ban) {
+		by_mask->second.erase(match);
+	}
+
+	if(by_mask->second.empty()) {
+		ban_index_.erase(by_mask);
+	}
 }
 
 void ban_manager::init_ban_help()
@@ -722,6 +775,7 @@ ban_manager::~ban_manager()
 
 ban_manager::ban_manager()
 	: bans_()
+	, ban_index_()
 	, deleted_bans_()
 	, time_queue_()
 	, ban_times_()
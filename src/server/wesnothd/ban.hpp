@@ -22,6 +22,7 @@
 #include <map>
 #include <queue>
 #include <set>
+#include <unordered_map>
 
 class config;
 
@@ -53,6 +54,8 @@ typedef std::set<banned_ptr, banned_compare_subnet> ban_set;
 typedef std::list<banned_ptr> deleted_ban_list;
 typedef std::priority_queue<banned_ptr, std::vector<banned_ptr>, banned_compare> ban_time_queue;
 typedef std::map<std::string, std::size_t> default_ban_times;
+/** Bans by mask, then by the masked IP they match. */
+typedef std::map<unsigned int, std::unordered_map<unsigned int, banned_ptr>> ban_index;
 typedef std::pair<unsigned int, unsigned int> ip_mask;
 
 ip_mask parse_ip(const std::string&);
@@ -123,6 +126,8 @@ public:
 class ban_manager
 {
 	ban_set bans_;
+	/** The same bans as @ref bans_, for looking up the ones matching an IP. */
+	ban_index ban_index_;
 	deleted_ban_list deleted_bans_;
 	ban_time_queue time_queue_;
 	default_ban_times ban_times_;
@@ -141,6 +146,8 @@ class ban_manager
 	}
 
 	void init_ban_help();
+	void index_ban(const banned_ptr& ban);
+	void unindex_ban(const banned_ptr& ban);
 	void check_ban_times(std::time_t time_now);
 	inline void expire_bans()
 	{
@@ -39,6 +39,9 @@ static lg::log_domain log_config("config");
 
 namespace
 {
+/** Compressed history size at which it is merged into one segment and moved to disk. */
+const std::size_t max_history_in_memory = 256 * 1024;
+
 void split_conv_impl(std::vector<int>& res, const simple_wml::string_span& span)
 {
 	if(!span.empty()) {
@@ -96,6 +99,9 @@ game::game(wesnothd::server& server, player_connections& player_connections,
 	, started_(false)
 	, level_()
 	, history_()
+	, history_size_(0)
+	, history_file_(nullptr, &std::fclose)
+	, history_segments_()
 	, description_(nullptr)
 	, current_turn_(0)
 	, current_side_index_(0)
@@ -592,7 +598,7 @@ void game::change_controller(
 
 	if(started_) {
 		// the purpose of these records is so that observers, replay viewers, etc get controller updates correctly
-		record_data(response->clone());
+		record_data(*response);
 	}
 
 	// Tell the new player that he controls this side now.
@@ -607,8 +613,8 @@ void game::change_controller(
 std::unique_ptr<simple_wml::document> game::change_controller_type(const std::size_t side_index, player_iterator player, const std::string& player_name)
 {
 	const std::string& side = std::to_string(side_index + 1);
-	simple_wml::document response;
-	simple_wml::node& change = response.root().add_child("change_controller");
+	auto response = std::make_unique<simple_wml::document>();
+	simple_wml::node& change = response->root().add_child("change_controller");
 
 	change.set_attr_dup("side", side.c_str());
 	change.set_attr_dup("player", player_name.c_str());
@@ -616,8 +622,8 @@ std::unique_ptr<simple_wml::document> game::change_controller_type(const std::si
 	change.set_attr_dup("controller", side_controller::get_string(side_controllers_[side_index]).c_str());
 	change.set_attr("is_local", "no");
 
-	send_data(response, player);
-	return response.clone();
+	send_data(*response, player);
+	return response;
 }
 
 void game::notify_new_host()
@@ -1066,7 +1072,7 @@ bool game::process_turn(simple_wml::document& data, player_iterator user)
 	}
 
 	if(!repackage) {
-		record_data(data.clone());
+		record_data(data);
 		send_data(data, user);
 		return turn_ended;
 	}
@@ -1632,9 +1638,11 @@ void game::load_next_scenario(player_iterator user)
 template<typename Container>
 void game::send_to_players(simple_wml::document& data, const Container& players, std::optional<player_iterator> exclude)
 {
+	const server_base::encoded_doc_ptr encoded = server_base::encode_doc(data);
+
 	for(const auto& player : players) {
 		if(player != exclude) {
-			server.send_to_player(player, data);
+			server.send_to_player(player, encoded);
 		}
 	}
 }
@@ -1721,9 +1729,37 @@ void game::send_observerquit(player_iterator observer)
 }
 
 void game::send_history(player_iterator player) const
+{
+	// Older segments are sent as they are stored, each one as a separate document.
+	std::string data;
+	for(std::size_t i = 0; i < history_segments_.size(); ++i) {
+		if(!read_history_segment(i, data)) {
+			return;
+		}
+
+		server.send_to_player(player, server_base::encode_compressed(simple_wml::string_span(data.data(), data.size())));
+	}
+
+	try {
+		auto doc = compact_history();
+		if(!doc) {
+			return;
+		}
+
+		server.send_to_player(player, *doc);
+
+		history_size_ = doc->output_compressed().size();
+		history_.clear();
+		history_.push_back(std::move(doc));
+	} catch(const simple_wml::error& e) {
+		WRN_CONFIG << __func__ << ": simple_wml error: " << e.message;
+	}
+}
+
+std::unique_ptr<simple_wml::document> game::compact_history() const
 {
 	if(history_.empty()) {
-		return;
+		return nullptr;
 	}
 
 	// we make a new document based on converting to plain text and
@@ -1734,17 +1770,64 @@ void game::send_history(player_iterator player) const
 		buf += h->output();
 	}
 
+	auto doc = std::make_unique<simple_wml::document>(buf.c_str(), simple_wml::INIT_STATIC);
+	doc->compress();
+	return doc;
+}
+
+void game::spill_history()
+{
+	std::unique_ptr<simple_wml::document> doc;
 	try {
-		auto doc = std::make_unique<simple_wml::document>(buf.c_str(), simple_wml::INIT_STATIC);
-		doc->compress();
+		doc = compact_history();
+	} catch(const simple_wml::error& e) {
+		WRN_CONFIG << __func__ << ": simple_wml error: " << e.message;
+		return;
+	}
 
-		server.send_to_player(player, *doc);
+	if(!doc) {
+		return;
+	}
+
+	const simple_wml::string_span data = doc->output_compressed();
+
+	if(!history_file_) {
+		history_file_.reset(std::tmpfile());
+	}
 
+	long offset = -1;
+	if(history_file_ && std::fseek(history_file_.get(), 0, SEEK_END) == 0) {
+		offset = std::ftell(history_file_.get());
+	}
+
+	if(offset < 0 || std::fwrite(data.begin(), 1, data.size(), history_file_.get()) != std::size_t(data.size())) {
+		ERR_GAME << "Could not write the history of game " << id_ << " to a temporary file, keeping it in memory";
+
+		// Don't try again until another full batch has been recorded.
+		history_size_ = 0;
 		history_.clear();
 		history_.push_back(std::move(doc));
-	} catch(const simple_wml::error& e) {
-		WRN_CONFIG << __func__ << ": simple_wml error: " << e.message;
+		return;
+	}
+
+	history_segments_.emplace_back(offset, data.size());
+	history_size_ = 0;
+	history_.clear();
+}
+
+bool game::read_history_segment(std::size_t index, std::string& data) const
+{
+	const auto& [offset, size] = history_segments_[index];
+	data.resize(size);
+
+	if(std::fseek(history_file_.get(), offset, SEEK_SET) != 0
+		|| std::fread(data.data(), 1, size, history_file_.get()) != size)
+	{
+		ERR_GAME << "Could not read the history of game " << id_ << " back from its temporary file";
+		return false;
 	}
+
+	return true;
 }
 
 static bool is_invalid_filename_char(char c)
@@ -1770,7 +1853,7 @@ static bool is_invalid_filename_char(char c)
 std::string game::get_replay_filename()
 {
 	std::stringstream name;
-	name << (*starting_pos(level_.root()))["name"] << " Turn " << current_turn() << " (" << db_id_ << ").bz2";
+	name << (*starting_pos(level_.root()))["name"] << " Turn " << current_turn() << " (" << db_id_ << ")" << server.replay_file_extension();
 	std::string filename(name.str());
 	std::replace(filename.begin(), filename.end(), ' ', '_');
 	filename.erase(std::remove_if(filename.begin(), filename.end(), is_invalid_filename_char), filename.end());
@@ -1779,23 +1862,32 @@ std::string game::get_replay_filename()
 
 void game::save_replay()
 {
-	if(!save_replays_ || !started_ || history_.empty()) {
+	if(!save_replays_ || !started_ || (history_.empty() && history_segments_.empty())) {
 		return;
 	}
 
-	std::string replay_commands;
-	for(const auto& h : history_) {
-		const simple_wml::node::child_list& turn_list = h->root().children("turn");
+	std::stringstream replay_data;
+	try {
+		std::string replay_commands;
+		const auto add_turns = [&replay_commands](const simple_wml::document& doc) {
+			for(const simple_wml::node* turn : doc.root().children("turn")) {
+				replay_commands += simple_wml::node_to_string(*turn);
+			}
+		};
 
-		for(const simple_wml::node* turn : turn_list) {
-			replay_commands += simple_wml::node_to_string(*turn);
+		std::string data;
+		for(std::size_t i = 0; i < history_segments_.size(); ++i) {
+			if(read_history_segment(i, data)) {
+				add_turns(simple_wml::document(simple_wml::string_span(data.data(), data.size())));
+			}
 		}
-	}
 
-	history_.clear();
+		for(const auto& h : history_) {
+			add_turns(*h);
+		}
+
+		clear_history();
 
-	std::stringstream replay_data;
-	try {
 		// level_.set_attr_dup("label", name.str().c_str());
 
 		// Used by replays.wesnoth.org as of December 2017. No client usecases.
@@ -1816,18 +1908,11 @@ void game::save_replay()
 			<< (has_old_replay ? "" : "\t[command]\n\t\t[start]\n\t\t[/start]\n\t[/command]\n")
 			<< replay_commands << "[/replay]\n";
 
-		std::string replay_data_str = replay_data.str();
-		simple_wml::document replay(replay_data_str.c_str(), simple_wml::INIT_STATIC);
-
 		std::string filename = get_replay_filename();
 		DBG_GAME << "saving replay: " << filename;
 
-		filesystem::scoped_ostream os(filesystem::ostream_file(replay_save_path_ + filename));
-		(*os) << replay.output_compressed(true);
-
-		if(!os->good()) {
-			ERR_GAME << "Could not save replay! (" << filename << ")";
-		}
+		// Compressing and writing it is left to the replay threads.
+		server.save_replay_file(replay_save_path_ + filename, replay_data.str());
 	} catch(const simple_wml::error& e) {
 		WRN_CONFIG << __func__ << ": simple_wml error: " << e.message;
 	}
@@ -1836,12 +1921,26 @@ void game::save_replay()
 void game::record_data(std::unique_ptr<simple_wml::document> data)
 {
 	data->compress();
+	history_size_ += data->output_compressed().size();
 	history_.push_back(std::move(data));
+
+	if(history_size_ > max_history_in_memory) {
+		spill_history();
+	}
+}
+
+void game::record_data(simple_wml::document& data)
+{
+	// Only the compressed text is kept, so don't parse a clone just to throw the tree away.
+	record_data(std::make_unique<simple_wml::document>(data.output(), simple_wml::INIT_COMPRESSED));
 }
 
 void game::clear_history()
 {
 	history_.clear();
+	history_size_ = 0;
+	history_file_.reset();
+	history_segments_.clear();
 }
 
 void game::set_description(simple_wml::node* desc)
@@ -21,8 +21,12 @@
 #include "server/common/simple_wml.hpp"
 #include "side_controller.hpp"
 
+#include <algorithm>
+#include <cstdio>
 #include <map>
+#include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
 // class player;
@@ -67,6 +71,14 @@ public:
 		return db_id_;
 	}
 
+	/**
+	 * Makes new games take their IDs from @a first on, so that wesnothd processes sharing a lobby don't reuse each other's.
+	 */
+	static void set_first_id(int first)
+	{
+		id_num = std::max(id_num, first);
+	}
+
 	/**
 	 * Increments the ID used when running database queries.
 	 */
@@ -449,6 +461,13 @@ public:
 	 */
 	void record_data(std::unique_ptr<simple_wml::document> data);
 
+	/**
+	 * Records a copy of a WML document that is still needed afterwards.
+	 *
+	 * @param data The WML document to record.
+	 */
+	void record_data(simple_wml::document& data);
+
 	/**
 	 * Move the level information and recorded history into a replay file and save it.
 	 */
@@ -716,6 +735,13 @@ private:
 	void send_observerquit(player_iterator observer);
 	void send_history(player_iterator sock) const;
 
+	/** Merge the documents in @ref history_ into a single compressed document, or return nullptr if there are none. */
+	std::unique_ptr<simple_wml::document> compact_history() const;
+	/** Append the in-memory history to @ref history_file_ as one compressed segment. */
+	void spill_history();
+	/** Read back the compressed bytes of segment @a index from @ref history_file_. */
+	bool read_history_segment(std::size_t index, std::string& data) const;
+
 	/** In case of a host transfer, notify the new host about its status. */
 	void notify_new_host();
 
@@ -856,8 +882,15 @@ private:
 	*/
 	simple_wml::document level_;
 
-	/** Replay data. */
+	/** Replay data recorded since the last spill. */
 	mutable std::vector<std::unique_ptr<simple_wml::document>> history_;
+	/** Compressed size of the documents in @ref history_. */
+	mutable std::size_t history_size_;
+
+	/** Older replay data, as compressed segments appended to a temporary file that is deleted when closed. */
+	std::unique_ptr<std::FILE, int(*)(std::FILE*)> history_file_;
+	/** Offset and size of each segment in @ref history_file_. */
+	std::vector<std::pair<long, std::size_t>> history_segments_;
 
 	/** Pointer to the game's description in the games_and_users_list_. */
 	simple_wml::node* description_;
@@ -74,7 +74,7 @@ void metrics::no_requests()
 	current_requests_ = 0;
 }
 
-void metrics::record_sample(const simple_wml::string_span& name, clock_t parsing_time, clock_t processing_time)
+void metrics::record_sample(const simple_wml::string_span& name, std::chrono::steady_clock::duration processing_time)
 {
 	auto isample = std::lower_bound(samples_.begin(), samples_.end(), name,compare_samples_to_stringspan());
 	if(isample == samples_.end() || isample->name != name) {
@@ -91,11 +91,31 @@ void metrics::record_sample(const simple_wml::string_span& name, clock_t parsing
 		isample = samples_.begin() + index;
 	}
 
+	const auto time = std::chrono::duration_cast<std::chrono::microseconds>(processing_time);
+
+	std::size_t bucket = 0;
+	while(bucket + 1 < nbuckets && time.count() > (1ll << bucket)) {
+		++bucket;
+	}
+
 	isample->nsamples++;
-	isample->parsing_time += parsing_time;
-	isample->processing_time += processing_time;
-	isample->max_parsing_time = std::max(parsing_time,isample->max_parsing_time);
-	isample->max_processing_time = std::max(processing_time,isample->max_processing_time);
+	isample->processing_time += time;
+	isample->max_processing_time = std::max(time,isample->max_processing_time);
+	isample->buckets[bucket]++;
+}
+
+std::chrono::microseconds metrics::sample::percentile(double q) const
+{
+	const double wanted = q * nsamples;
+	int seen = 0;
+	for(std::size_t bucket = 0; bucket + 1 < nbuckets; ++bucket) {
+		seen += buckets[bucket];
+		if(seen >= wanted) {
+			return std::chrono::microseconds(1ll << bucket);
+		}
+	}
+
+	return max_processing_time;
 }
 
 void metrics::game_terminated(const std::string& reason)
@@ -128,19 +148,71 @@ std::ostream& metrics::requests(std::ostream& out) const
 	out << "\nSampled request types:\n";
 
 	std::size_t n = 0;
-	std::size_t pa = 0;
-	std::size_t pr = 0;
+	std::chrono::microseconds pr(0);
 	for(const auto& s : ordered_samples) {
 		out << "'" << s.name << "' called " << s.nsamples << " times "
-			<< s.parsing_time << "("<< s.max_parsing_time <<") parsing time, "
-			<< s.processing_time << "("<<s.max_processing_time<<") processing time\n";
+			<< s.processing_time.count() << "us ("<<s.max_processing_time.count()<<"us) processing time\n";
 		n += s.nsamples;
-		pa += s.parsing_time;
 		pr += s.processing_time;
 	}
 	out << "Total number of request samples = " << n << "\n"
-		<< "Total parsing time = " << pa << "\n"
-		<< "Total processing time = " << pr;
+		<< "Total processing time = " << pr.count() << "us";
+
+	return out;
+}
+
+std::ostream& metrics::latency(std::ostream& out) const
+{
+	if (samples_.empty()) return out << "No requests sampled so far.";
+
+	out << "Request processing time percentiles (p50/p90/p99/max):";
+	for(const auto& s : samples_) {
+		out << "\n'" << s.name << "' " << s.nsamples << " samples: "
+			<< s.percentile(0.5).count() << "us/"
+			<< s.percentile(0.9).count() << "us/"
+			<< s.percentile(0.99).count() << "us/"
+			<< s.max_processing_time.count() << "us";
+	}
+
+	return out;
+}
+
+/** Request names come from clients, so escape them for use as label values. */
+static std::string prometheus_label(const simple_wml::string_span& name)
+{
+	std::string res;
+	for(char c : name) {
+		if(c == '\\' || c == '"') {
+			res += '\\';
+			res += c;
+		} else if(c == '\n') {
+			res += "\\n";
+		} else {
+			res += c;
+		}
+	}
+
+	return res;
+}
+
+std::ostream& metrics::latency_prometheus(std::ostream& out) const
+{
+	out << "# HELP wesnothd_request_duration_seconds Wall-clock time spent processing sampled requests.\n"
+		<< "# TYPE wesnothd_request_duration_seconds histogram\n";
+
+	for(const auto& s : samples_) {
+		const std::string label = prometheus_label(s.name);
+		int cumulative = 0;
+		for(std::size_t bucket = 0; bucket + 1 < nbuckets; ++bucket) {
+			cumulative += s.buckets[bucket];
+			out << "wesnothd_request_duration_seconds_bucket{request=\"" << label << "\",le=\""
+				<< (1ll << bucket) / 1e6 << "\"} " << cumulative << "\n";
+		}
+
+		out << "wesnothd_request_duration_seconds_bucket{request=\"" << label << "\",le=\"+Inf\"} " << s.nsamples << "\n"
+			<< "wesnothd_request_duration_seconds_sum{request=\"" << label << "\"} " << s.processing_time.count() / 1e6 << "\n"
+			<< "wesnothd_request_duration_seconds_count{request=\"" << label << "\"} " << s.nsamples << "\n";
+	}
 
 	return out;
 }
@@ -17,10 +17,13 @@
 
 #include "server/common/simple_wml.hpp"
 
+#include <array>
+#include <chrono>
 #include <ctime>
 #include <iosfwd>
 #include <map>
 #include <string>
+#include <vector>
 
 class metrics
 {
@@ -31,30 +34,41 @@ public:
 	void service_request();
 	void no_requests();
 
-	void record_sample(const simple_wml::string_span& name, clock_t parsing_time, clock_t processing_time);
+	/** Record the wall-clock time taken to process one request of type @a name. */
+	void record_sample(const simple_wml::string_span& name, std::chrono::steady_clock::duration processing_time);
 
 	void game_terminated(const std::string& reason);
 
 	std::ostream& games(std::ostream& out) const;
 	std::ostream& requests(std::ostream& out) const;
+	/** The processing time percentiles of each sampled request type. */
+	std::ostream& latency(std::ostream& out) const;
+	/** The processing time histograms in the Prometheus text exposition format. */
+	std::ostream& latency_prometheus(std::ostream& out) const;
 	friend std::ostream& operator<<(std::ostream& out, metrics& met);
 
+	/** Upper bounds of the histogram buckets are 1us, 2us, 4us and so on; the last bucket takes everything slower. */
+	static const std::size_t nbuckets = 24;
+
 	struct sample
 	{
 		sample()
 			: name()
 			, nsamples(0)
-			, parsing_time(0)
 			, processing_time(0)
-			, max_parsing_time(0)
 			, max_processing_time(0)
+			, buckets()
 		{
 		}
 
 		simple_wml::string_span name;
 		int nsamples;
-		clock_t parsing_time, processing_time;
-		clock_t max_parsing_time, max_processing_time;
+		std::chrono::microseconds processing_time;
+		std::chrono::microseconds max_processing_time;
+		std::array<int, nbuckets> buckets;
+
+		/** The upper bound of the bucket holding the @a q quantile. */
+		std::chrono::microseconds percentile(double q) const;
 
 		operator const simple_wml::string_span&()
 		{
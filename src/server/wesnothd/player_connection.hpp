@@ -84,6 +84,7 @@ private:
 struct socket_t {};
 struct name_t {};
 struct game_t {};
+struct ip_t {};
 
 namespace bmi = boost::multi_index;
 
@@ -93,7 +94,9 @@ using player_connections = bmi::multi_index_container<player_record, bmi::indexe
 	bmi::hashed_unique<bmi::tag<name_t>,
 		bmi::const_mem_fun<player_record, const std::string&, &player_record::name>>,
 	bmi::ordered_non_unique<bmi::tag<game_t>,
-		bmi::const_mem_fun<player_record, int, &player_record::game_id>>
+		bmi::const_mem_fun<player_record, int, &player_record::game_id>>,
+	bmi::hashed_non_unique<bmi::tag<ip_t>,
+		bmi::const_mem_fun<player_record, std::string, &player_record::client_ip>>
 >>;
 
 typedef player_connections::const_iterator player_iterator;
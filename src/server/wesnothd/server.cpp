@@ -46,20 +46,28 @@
 #endif
 
 #include <boost/algorithm/string.hpp>
+#include <boost/asio/connect.hpp>
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
 #include <boost/scope_exit.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <cassert>
 #include <cerrno>
 #include <csignal>
 #include <cstdlib>
+#include <cstring>
 #include <functional>
 #include <iostream>
 #include <iomanip>
+#include <limits>
 #include <map>
 #include <queue>
 #include <set>
 #include <sstream>
+#include <tuple>
 #include <vector>
 
 static lg::log_domain log_server("server");
@@ -188,6 +196,150 @@ static bool make_change_diff(const simple_wml::node& src,
 	return true;
 }
 
+namespace
+{
+/** The child types held by the two lists a gamelist diff can change. */
+const char* const lobby_diff_types[] { "user", "game" };
+
+/** Flush early when this many diffs are waiting. */
+const std::size_t max_lobby_diffs = 64;
+
+/** The most friends a lobby filter can name. */
+const std::size_t max_lobby_filter_friends = 256;
+
+/** Identifies a game across shards, which may reuse ids, from a game or from the @a id of a user's game. */
+std::string lobby_game_key(const simple_wml::node& entry, const char* id = "id")
+{
+	return entry["shard"].to_string() + '/' + entry[id].to_string();
+}
+
+/**
+ * Folds a sequence of gamelist diffs for one list into a single diff.
+ *
+ * The list is tracked as runs of the children the clients already have, plus
+ * the children inserted since. Deleted originals are remembered by their old
+ * index so that they can be deleted from the merged diff.
+ */
+class merged_list_diff
+{
+public:
+	/** Insert @a node so that it ends up at @a index. */
+	void insert(int index, const simple_wml::node* node)
+	{
+		int offset;
+		const auto e = find(index, offset);
+
+		if(offset > 0) {
+			const auto head = split(e, offset);
+			entries_.insert(head + 1, { 0, 0, node });
+		} else {
+			entries_.insert(e, { 0, 0, node });
+		}
+	}
+
+	/** Delete whichever child is currently at @a index. */
+	void remove(int index)
+	{
+		int offset;
+		auto e = find(index, offset);
+
+		if(e->node) {
+			entries_.erase(e);
+			return;
+		}
+
+		deleted_.insert(e->first + offset);
+		if(offset > 0) {
+			e = split(e, offset) + 1;
+		}
+
+		e->first += 1;
+		e->count -= 1;
+		if(e->count == 0) {
+			entries_.erase(e);
+		}
+	}
+
+	bool empty() const
+	{
+		return deleted_.empty()
+			&& std::none_of(entries_.begin(), entries_.end(), [](const entry& e) { return e.node != nullptr; });
+	}
+
+	/**
+	 * Write the merged inserts and deletes into @a out.
+	 *
+	 * The client performs all inserts before it looks up the deleted indices, so
+	 * both refer to the list with the inserts done and the deleted children still there.
+	 * Deletes are written from the back so that removing them one by one stays valid.
+	 */
+	void write(simple_wml::node& out, const char* type) const
+	{
+		std::vector<int> deletes;
+		auto deleted = deleted_.begin();
+		int pos = 0;
+
+		for(const entry& e : entries_) {
+			if(e.node) {
+				simple_wml::node& insert = out.add_child("insert_child");
+				insert.set_attr_int("index", pos++);
+				e.node->copy_into(insert.add_child(type));
+				continue;
+			}
+
+			for(; deleted != deleted_.end() && *deleted < e.first; ++deleted) {
+				deletes.push_back(pos++);
+			}
+
+			if(&e != &entries_.back()) {
+				pos += e.count;
+			}
+		}
+
+		for(auto i = deletes.rbegin(); i != deletes.rend(); ++i) {
+			simple_wml::node& del = out.add_child("delete_child");
+			del.set_attr_int("index", *i);
+			del.add_child(type);
+		}
+	}
+
+private:
+	/** A run of original children, or a single inserted child when @a node is set. */
+	struct entry
+	{
+		int first;
+		int count;
+		const simple_wml::node* node;
+	};
+
+	std::vector<entry>::iterator find(int index, int& offset)
+	{
+		for(auto e = entries_.begin();; ++e) {
+			const int size = e->node ? 1 : e->count;
+			if(index < size) {
+				offset = index;
+				return e;
+			}
+
+			index -= size;
+		}
+	}
+
+	/** Split the run @a e after @a offset children, returning the first half. */
+	std::vector<entry>::iterator split(std::vector<entry>::iterator e, int offset)
+	{
+		const entry tail { e->first + offset, e->count - offset, nullptr };
+		e->count = offset;
+		return std::prev(entries_.insert(e + 1, tail));
+	}
+
+	/** The last run never ends, so every index resolves to an entry. */
+	std::vector<entry> entries_ { { 0, std::numeric_limits<int>::max(), nullptr } };
+	std::set<int> deleted_;
+};
+
+} // end anon namespace
+
 static std::string player_status(const wesnothd::player_record& player)
 {
 	std::ostringstream out;
@@ -201,7 +353,7 @@ const std::string help_msg =
 	"Available commands are: adminmsg <msg>,"
 	" ban <mask> <time> <reason>, bans [deleted] [<ipmask>], clones,"
 	" dul|deny_unregistered_login [yes|no], kick <mask> [<reason>],"
-	" k[ick]ban <mask> <time> <reason>, help, games, metrics,"
+	" k[ick]ban <mask> <time> <reason>, help, games, latency [prometheus], metrics,"
 	" [lobby]msg <message>, motd [<message>],"
 	" pm|privatemsg <nickname> <message>, requests, roll <sides>, sample, searchlog <mask>,"
 	" signout, stats, status [<mask>], stopgame <nick> [<reason>], unban <ipmask>\n"
@@ -211,12 +363,12 @@ const std::string help_msg =
 server::server(int port,
 		bool keep_alive,
 		const std::string& config_file,
-		std::size_t /*min_threads*/,
+		std::size_t min_threads,
 		std::size_t /*max_threads*/)
 	: server_base(port, keep_alive)
 	, ban_manager_()
 	, ip_log_()
-	, failed_logins_()
+	, login_logs_()
 	, user_handler_(nullptr)
 	, die_(static_cast<unsigned>(std::time(nullptr)))
 #ifndef _WIN32
@@ -246,16 +398,24 @@ server::server(int port,
 	, deny_unregistered_login_(false)
 	, save_replays_(false)
 	, replay_save_path_()
+	, replay_codec_(replay_codec::bzip2)
+	, replay_queue_limit_(0)
+	, replays_pending_(0)
+	, replay_pool_()
 	, allow_remote_shutdown_(false)
 	, client_sources_()
 	, tor_ip_list_()
 	, failed_login_limit_()
 	, failed_login_ban_()
 	, failed_login_buffer_size_()
+	, login_attempt_burst_(0)
+	, login_attempt_rate_(0)
+	, lobby_diff_interval_(0)
 	, version_query_response_("[version]\n[/version]\n", simple_wml::INIT_COMPRESSED)
 	, login_response_("[mustlogin]\n[/mustlogin]\n", simple_wml::INIT_COMPRESSED)
 	, games_and_users_list_("[gamelist]\n[/gamelist]\n", simple_wml::INIT_STATIC)
 	, metrics_()
+	, request_count_(0)
 	, dump_stats_timer_(io_service_)
 	, tournaments_timer_(io_service_)
 	, cmd_handlers_()
@@ -263,12 +423,34 @@ server::server(int port,
 	, lan_server_timer_(io_service_)
 	, dummy_player_timer_(io_service_)
 	, dummy_player_timer_interval_(30)
+	, lobby_diffs_()
+	, lobby_diff_nodes_()
+	, lobby_diff_start_()
+	, lobby_diff_excluded_()
+	, lobby_diff_timer_(io_service_)
+	, lobby_filters_()
+	, game_revisions_()
+	, lobby_filter_timer_(io_service_)
+	, lobby_filter_update_pending_(false)
+	, shard_id_()
+	, shard_secret_()
+	, shard_sync_interval_(1000)
+	, shard_peers_()
 {
 	setup_handlers();
 	load_config();
 	ban_manager_.read();
 
+	start_decode_pool(min_threads);
+	start_hash_pool(cfg_["hash_threads"].to_size_t(2));
+
+	// Not in load_config() since a reload would have to wait for the queued saves.
+	if(const int replay_threads = cfg_["replay_save_threads"].to_int(1); replay_threads > 0) {
+		replay_pool_.reset(new boost::asio::thread_pool(replay_threads));
+	}
+
 	start_server();
+	start_shards();
 
 	start_dump_stats();
 	start_tournaments_timer();
@@ -380,6 +562,7 @@ void server::setup_handlers()
 	SETUP_HANDLER("version", &server::version_handler);
 	SETUP_HANDLER("metrics", &server::metrics_handler);
 	SETUP_HANDLER("requests", &server::requests_handler);
+	SETUP_HANDLER("latency", &server::latency_handler);
 	SETUP_HANDLER("roll", &server::roll_handler);
 	SETUP_HANDLER("games", &server::games_handler);
 	SETUP_HANDLER("wml", &server::wml_handler);
@@ -448,6 +631,18 @@ void server::load_config()
 	save_replays_ = cfg_["save_replays"].to_bool();
 	replay_save_path_ = cfg_["replay_save_path"].str();
 
+	const std::string replay_compression = cfg_["replay_compression"].str("bz2");
+	if(replay_compression == "gz") {
+		replay_codec_ = replay_codec::gzip;
+	} else {
+		if(replay_compression != "bz2") {
+			ERR_CONFIG << "Unknown replay_compression '" << replay_compression << "', using bz2";
+		}
+		replay_codec_ = replay_codec::bzip2;
+	}
+
+	replay_queue_limit_ = cfg_["replay_save_queue"].to_size_t(16);
+
 	tor_ip_list_ = utils::split(cfg_["tor_ip_list_path"].empty()
 		? ""
 		: filesystem::read_file(cfg_["tor_ip_list_path"]), '\n');
@@ -490,7 +685,12 @@ void server::load_config()
 
 	failed_login_limit_ = cfg_["failed_logins_limit"].to_int(10);
 	failed_login_ban_ = cfg_["failed_logins_ban"].to_int(3600);
-	failed_login_buffer_size_ = cfg_["failed_logins_buffer_size"].to_int(500);
+	failed_login_buffer_size_ = cfg_["failed_logins_buffer_size"].to_size_t(500);
+	login_attempt_burst_ = std::max(1, cfg_["login_attempt_burst"].to_int(5));
+	login_attempt_rate_ = cfg_["login_attempt_rate"].to_double(10);
+
+	// Milliseconds to hold back gamelist diffs so they can be merged, 0 sends them right away
+	lobby_diff_interval_ = cfg_["lobby_diff_interval"].to_int(0);
 
 	// Example config line:
 	// restart_command="./wesnothd-debug -d -c ~/.wesnoth1.5/server.cfg"
@@ -527,6 +727,7 @@ void server::load_config()
 	// allow nick registration, otherwise we set user_handler_
 	// to nullptr. Thus we must check user_handler_ for not being
 	// nullptr every time we want to use it.
+	db_writes_.reset();
 	user_handler_.reset();
 
 #ifdef HAVE_MYSQLPP
@@ -537,6 +738,7 @@ void server::load_config()
 		}
 
 		user_handler_.reset(new fuh(user_handler));
+		db_writes_.emplace(boost::asio::make_strand(user_handler_->query_executor()));
 		uuid_ = user_handler_->get_uuid();
 		tournaments_ = user_handler_->get_tournaments();
 	}
@@ -569,14 +771,7 @@ bool server::ip_exceeds_connection_limit(const std::string& ip) const
 		return false;
 	}
 
-	std::size_t connections = 0;
-	for(const auto& player : player_connections_) {
-		if(player.client_ip() == ip) {
-			++connections;
-		}
-	}
-
-	return connections >= concurrent_connections_;
+	return player_connections_.get<ip_t>().count(ip) >= concurrent_connections_;
 }
 
 std::string server::is_ip_banned(const std::string& ip)
@@ -757,6 +952,16 @@ void server::login_client(boost::asio::yield_context yield, SocketPtr socket)
 		async_send_error(socket, "You must login first.", MP_MUST_LOGIN);
 	}
 
+	long forum_id = 0;
+	unsigned long long login_id = 0;
+
+	if(user_handler_) {
+		std::tie(forum_id, login_id) = user_handler_->async_query(yield,
+			[this, &username, &client_version, address = client_address(socket)]() {
+				return std::make_pair(user_handler_->get_forum_id(username), user_handler_->db_insert_login(username, address, client_version));
+			});
+	}
+
 	simple_wml::document join_lobby_response;
 	join_lobby_response.root().add_child("join_lobby").set_attr("is_moderator", is_moderator ? "yes" : "no");
 	join_lobby_response.root().child("join_lobby")->set_attr_dup("profile_url_prefix", "https://r.wesnoth.org/u");
@@ -768,11 +973,11 @@ void server::login_client(boost::asio::yield_context yield, SocketPtr socket)
 		[this, socket, new_player = wesnothd::player{
 			username,
 			player_cfg,
-			user_handler_ ? user_handler_->get_forum_id(username) : 0,
+			forum_id,
 			registered,
 			client_version,
 			client_source,
-			user_handler_ ? user_handler_->db_insert_login(username, client_address(socket), client_version) : 0,
+			login_id,
 			default_max_messages_,
 			default_time_period_,
 			is_moderator
@@ -841,9 +1046,16 @@ template<class SocketPtr> bool server::is_login_allowed(boost::asio::yield_conte
 	auto p = player_connections_.get<name_t>().find(username);
 	bool name_taken = p != player_connections_.get<name_t>().end();
 
+	if(!name_taken && find_shard_entry("user", "name", username)) {
+		async_send_error(socket, "The nickname '" + username + "' is already logged in on another server of this network.",
+			MP_NAME_TAKEN_ERROR);
+
+		return false;
+	}
+
 	// Check for password
 
-	if(!authenticate(socket, username, (*login)["password"].to_string(), name_taken, registered))
+	if(!authenticate(yield, socket, username, (*login)["password"].to_string(), name_taken, registered))
 		return false;
 
 	// If we disallow unregistered users and this user is not registered send an error
@@ -856,11 +1068,17 @@ template<class SocketPtr> bool server::is_login_allowed(boost::asio::yield_conte
 		return false;
 	}
 
-	is_moderator = user_handler_ && user_handler_->user_is_moderator(username);
+	is_moderator = false;
 	user_handler::ban_info auth_ban;
 
 	if(user_handler_) {
-		auth_ban = user_handler_->user_is_banned(username, client_address(socket));
+		std::tie(is_moderator, auth_ban) = user_handler_->async_query(yield,
+			[this, &username, address = client_address(socket)]() {
+				return std::make_pair(user_handler_->user_is_moderator(username), user_handler_->user_is_banned(username, address));
+			});
+
+		// Someone else may have logged in with this name while the queries ran.
+		name_taken = player_connections_.get<name_t>().count(username) > 0;
 	}
 
 	if(auth_ban.type) {
@@ -931,7 +1149,7 @@ template<class SocketPtr> bool server::is_login_allowed(boost::asio::yield_conte
 	return true;
 }
 
-template<class SocketPtr> bool server::authenticate(
+template<class SocketPtr> bool server::authenticate(boost::asio::yield_context yield,
 		SocketPtr socket, const std::string& username, const std::string& password, bool name_taken, bool& registered)
 {
 	// Current login procedure  for registered nicks is:
@@ -943,16 +1161,34 @@ template<class SocketPtr> bool server::authenticate(
 	registered = false;
 
 	if(user_handler_) {
-		const bool exists = user_handler_->user_exists(username);
+		struct account_info
+		{
+			bool exists;
+			bool active;
+			std::string salt;
+		};
+
+		const account_info account = user_handler_->async_query(yield, [this, &username]() {
+			account_info info { user_handler_->user_exists(username), false, "" };
+			if(info.exists) {
+				info.active = user_handler_->user_is_active(username);
+				if(info.active) {
+					info.salt = user_handler_->extract_salt(username);
+				}
+			}
+			return info;
+		});
+
+		const bool exists = account.exists;
 
 		// This name is registered but the account is not active
-		if(exists && !user_handler_->user_is_active(username)) {
+		if(exists && !account.active) {
 			async_send_warning(socket,
 				"The nickname '" + username + "' is inactive. You cannot claim ownership of this "
 				"nickname until you activate your account via email or ask an administrator to do it for you.",
 				MP_NAME_INACTIVE_WARNING);
 		} else if(exists) {
-			const std::string salt = user_handler_->extract_salt(username);
+			const std::string& salt = account.salt;
 			if(salt.empty()) {
 				async_send_error(socket,
 					"Even though your nickname is registered on this server you "
@@ -961,7 +1197,6 @@ template<class SocketPtr> bool server::authenticate(
 					"may fix this problem.");
 				return false;
 			}
-			const std::string hashed_password = hash_password(password, salt, username);
 
 			// This name is registered and no password provided
 			if(password.empty()) {
@@ -979,6 +1214,21 @@ template<class SocketPtr> bool server::authenticate(
 				return false;
 			}
 
+			const std::string ip = client_address(socket);
+
+			// Shape the checks per address, so that reconnect storms can't keep the hash threads busy
+			if(login_attempt_rate_ > 0) {
+				login_log& log = get_login_log(ip);
+				if(log.tokens < 1) {
+					LOG_SERVER << log_address(socket) << "\tLogin attempt for nickname '" << username << "' rate limited.";
+					async_send_error(socket, "You are trying to log in too quickly, please wait a moment.", MP_TOO_MANY_ATTEMPTS_ERROR);
+					return false;
+				}
+				log.tokens -= 1;
+			}
+
+			const std::string hashed_password = async_hash_password(yield, password, salt, username);
+
 			// hashing the password failed
 			// note: this could be due to other related problems other than *just* the hashing step failing
 			if(hashed_password.empty()) {
@@ -986,33 +1236,14 @@ template<class SocketPtr> bool server::authenticate(
 				return false;
 			}
 			// This name is registered and an incorrect password provided
-			else if(!(user_handler_->login(username, hashed_password))) {
+			else if(!user_handler_->async_query(yield, [this, &username, &hashed_password]() { return user_handler_->login(username, hashed_password); })) {
 				const std::time_t now = std::time(nullptr);
 
-				login_log login_ip { client_address(socket), 0, now };
-				auto i = std::find(failed_logins_.begin(), failed_logins_.end(), login_ip);
-
-				if(i == failed_logins_.end()) {
-					failed_logins_.push_back(login_ip);
-					i = --failed_logins_.end();
-
-					// Remove oldest entry if maximum size is exceeded
-					if(failed_logins_.size() > failed_login_buffer_size_) {
-						failed_logins_.pop_front();
-					}
-				}
-
-				if(i->first_attempt + failed_login_ban_ < now) {
-					// Clear and move to the beginning
-					failed_logins_.erase(i);
-					failed_logins_.push_back(login_ip);
-					i = --failed_logins_.end();
-				}
-
-				i->attempts++;
+				login_log& log = get_login_log(ip);
+				log.attempts++;
 
-				if(i->attempts > failed_login_limit_) {
-					LOG_SERVER << ban_manager_.ban(login_ip.ip, now + failed_login_ban_,
+				if(log.attempts > failed_login_limit_) {
+					LOG_SERVER << ban_manager_.ban(ip, now + failed_login_ban_,
 						"Maximum login attempts exceeded", "automatic", "", username);
 
 					async_send_error(socket, "You have made too many failed login attempts.", MP_TOO_MANY_ATTEMPTS_ERROR);
@@ -1030,13 +1261,50 @@ template<class SocketPtr> bool server::authenticate(
 
 			// This name exists and the password was neither empty nor incorrect
 			registered = true;
-			user_handler_->user_logged_in(username);
+			boost::asio::post(user_handler_->query_executor(), [this, username]() { user_handler_->user_logged_in(username); });
 		}
 	}
 
 	return true;
 }
 
+server::login_log& server::get_login_log(const std::string& ip)
+{
+	const std::time_t now = std::time(nullptr);
+	const auto steady_now = std::chrono::steady_clock::now();
+
+	auto [iter, inserted] = login_logs_.try_emplace(ip, login_log{0, now, double(login_attempt_burst_), steady_now});
+
+	if(inserted && login_logs_.size() > failed_login_buffer_size_) {
+		// Forget the addresses that are back to a clean slate first, then any others
+		const auto idle = login_attempt_rate_ > 0
+			? std::chrono::duration<double, std::ratio<60>>(login_attempt_burst_ / login_attempt_rate_)
+			: std::chrono::duration<double, std::ratio<60>>(0);
+
+		for(auto i = login_logs_.begin(); i != login_logs_.end() && login_logs_.size() > failed_login_buffer_size_;) {
+			const bool expired = i->second.first_attempt + failed_login_ban_ < now && steady_now - i->second.refilled >= idle;
+			i = (i != iter && expired) ? login_logs_.erase(i) : std::next(i);
+		}
+
+		for(auto i = login_logs_.begin(); i != login_logs_.end() && login_logs_.size() > failed_login_buffer_size_;) {
+			i = i != iter ? login_logs_.erase(i) : std::next(i);
+		}
+	}
+
+	login_log& log = iter->second;
+
+	if(log.first_attempt + failed_login_ban_ < now) {
+		log.attempts = 0;
+		log.first_attempt = now;
+	}
+
+	const double minutes = std::chrono::duration<double, std::ratio<60>>(steady_now - log.refilled).count();
+	log.tokens = std::min<double>(login_attempt_burst_, log.tokens + minutes * login_attempt_rate_);
+	log.refilled = steady_now;
+
+	return log;
+}
+
 template<class SocketPtr> void server::send_password_request(SocketPtr socket,
 		const std::string& msg,
 		const char* error_code,
@@ -1071,7 +1339,7 @@ template<class SocketPtr> void server::handle_player(boost::asio::yield_context
 		}
 	};
 
-	async_send_doc_queued(socket, games_and_users_list_);
+	send_gamelist(player);
 
 	if(!motd_.empty()) {
 		send_server_message(player, motd_+'\n'+announcements_+tournaments_, "motd");
@@ -1095,31 +1363,46 @@ template<class SocketPtr> void server::handle_player(boost::asio::yield_context
 		if(!doc) return;
 
 		// DBG_SERVER << client_address(socket) << "\tWML received:\n" << doc->output();
-		if(doc->child("refresh_lobby")) {
-			async_send_doc_queued(socket, games_and_users_list_);
-			continue;
-		}
+		if(request_sample_frequency > 0 && ++request_count_ % request_sample_frequency == 0) {
+			// The handlers may modify the document, so keep the request name
+			const std::string name = doc->root().first_child().to_string();
+			const auto start = std::chrono::steady_clock::now();
 
-		if(simple_wml::node* whisper = doc->child("whisper")) {
-			handle_whisper(player, *whisper);
-			continue;
-		}
+			handle_request(player, *doc);
 
-		if(simple_wml::node* query = doc->child("query")) {
-			handle_query(player, *query);
-			continue;
+			metrics_.record_sample(simple_wml::string_span(name.c_str(), name.size()), std::chrono::steady_clock::now() - start);
+		} else {
+			handle_request(player, *doc);
 		}
+	}
+}
 
-		if(simple_wml::node* nickserv = doc->child("nickserv")) {
-			handle_nickserv(player, *nickserv);
-			continue;
-		}
+void server::handle_request(player_iterator player, simple_wml::document& doc)
+{
+	if(doc.child("refresh_lobby")) {
+		send_gamelist(player);
+		return;
+	}
 
-		if(!player_is_in_game(player)) {
-			handle_player_in_lobby(player, *doc);
-		} else {
-			handle_player_in_game(player, *doc);
-		}
+	if(simple_wml::node* whisper = doc.child("whisper")) {
+		handle_whisper(player, *whisper);
+		return;
+	}
+
+	if(simple_wml::node* query = doc.child("query")) {
+		handle_query(player, *query);
+		return;
+	}
+
+	if(simple_wml::node* nickserv = doc.child("nickserv")) {
+		handle_nickserv(player, *nickserv);
+		return;
+	}
+
+	if(!player_is_in_game(player)) {
+		handle_player_in_lobby(player, doc);
+	} else {
+		handle_player_in_game(player, doc);
 	}
 }
 
@@ -1139,6 +1422,49 @@ void server::handle_player_in_lobby(player_iterator player, simple_wml::document
 		handle_join_game(player, *join);
 		return;
 	}
+
+	if(const simple_wml::node* filter = data.child("lobby_filter")) {
+		handle_lobby_filter(player, *filter);
+		return;
+	}
+}
+
+void server::handle_lobby_filter(player_iterator player, const simple_wml::node& filter)
+{
+	lobby_filter f;
+	f.vacant_only = filter["vacant_only"].to_bool();
+	f.no_password = filter["no_password"].to_bool();
+	f.era = filter["era"].to_string();
+	f.offset = std::max(filter["offset"].to_int(), 0);
+	f.limit = std::max(filter["limit"].to_int(), 0);
+
+	for(const std::string& name : utils::split(filter["friends"].to_string())) {
+		if(f.friends.size() == max_lobby_filter_friends) {
+			break;
+		}
+
+		f.friends.insert(name);
+	}
+
+	const any_socket_ptr socket = player->socket();
+
+	// An empty filter goes back to the whole gamelist
+	if(!f.vacant_only && !f.no_password && f.era.empty() && f.friends.empty() && f.offset == 0 && f.limit == 0) {
+		if(lobby_filters_.erase(socket) == 0) {
+			return;
+		}
+
+		if(lobby_filters_.empty()) {
+			game_revisions_.clear();
+		}
+	} else {
+		lobby_filters_[socket] = std::move(f);
+	}
+
+	DBG_SERVER << player->client_ip() << "\t" << player->name() << "\tchanged the lobby filter, "
+			   << lobby_filters_.size() << " players filter the gamelist";
+
+	send_gamelist(player);
 }
 
 void server::handle_whisper(player_iterator player, simple_wml::node& whisper)
@@ -1160,7 +1486,9 @@ void server::handle_whisper(player_iterator player, simple_wml::node& whisper)
 
 	auto receiver_iter = player_connections_.get<name_t>().find(whisper["receiver"].to_string());
 	if(receiver_iter == player_connections_.get<name_t>().end()) {
-		send_server_message(player, "Can't find '" + whisper["receiver"].to_string() + "'.", "error");
+		if(!send_shard_whisper(whisper)) {
+			send_server_message(player, "Can't find '" + whisper["receiver"].to_string() + "'.", "error");
+		}
 		return;
 	}
 
@@ -1170,6 +1498,11 @@ void server::handle_whisper(player_iterator player, simple_wml::node& whisper)
 		return;
 	}
 
+	deliver_whisper(player_connections_.project<0>(receiver_iter), whisper);
+}
+
+void server::deliver_whisper(player_iterator receiver, const simple_wml::node& whisper)
+{
 	simple_wml::document cwhisper;
 
 	simple_wml::node& trunc_whisper = cwhisper.root().add_child("whisper");
@@ -1178,7 +1511,7 @@ void server::handle_whisper(player_iterator player, simple_wml::node& whisper)
 	const simple_wml::string_span& msg = trunc_whisper["message"];
 	chat_message::truncate_message(msg, trunc_whisper);
 
-	send_to_player(player_connections_.project<0>(receiver_iter), cwhisper);
+	send_to_player(receiver, cwhisper, send_priority::chat);
 }
 
 void server::handle_query(player_iterator iter, simple_wml::node& query)
@@ -1321,7 +1654,7 @@ void server::handle_create_game(player_iterator player, simple_wml::node& create
 			"This server is shutting down. You aren't allowed to make new games. Please "
 			"reconnect to the new server.", "error");
 
-		send_to_player(player, games_and_users_list_);
+		send_gamelist(player);
 		return;
 	}
 
@@ -1355,12 +1688,61 @@ void server::handle_create_game(player_iterator player, simple_wml::node& create
 	create_game.copy_into(g.level().root());
 }
 
+void server::save_replay_file(const std::string& path, std::string data)
+{
+	if(!replay_pool_ || replays_pending_ >= replay_queue_limit_) {
+		if(replay_pool_) {
+			WRN_SERVER << "Replay save queue is full, saving '" << path << "' on the event loop";
+		}
+
+		write_replay_file(path, data, replay_codec_);
+		return;
+	}
+
+	++replays_pending_;
+	boost::asio::post(*replay_pool_, [this, path, data = std::move(data), codec = replay_codec_]() {
+		write_replay_file(path, data, codec);
+		--replays_pending_;
+	});
+}
+
+const char* server::replay_file_extension() const
+{
+	return replay_codec_ == replay_codec::gzip ? ".gz" : ".bz2";
+}
+
+void server::write_replay_file(const std::string& path, const std::string& data, replay_codec codec)
+{
+	try {
+		// The data is already simple_wml output, so it is compressed as it is rather than parsed again.
+		filesystem::scoped_ostream os(filesystem::ostream_file(path));
+		{
+			boost::iostreams::filtering_ostream out;
+			if(codec == replay_codec::gzip) {
+				out.push(boost::iostreams::gzip_compressor());
+			} else {
+				out.push(boost::iostreams::bzip2_compressor());
+			}
+			out.push(*os);
+			out.write(data.data(), data.size());
+		}
+
+		if(!os->good()) {
+			ERR_SERVER << "Could not save replay! (" << path << ")";
+		}
+	} catch(const std::exception& e) {
+		ERR_SERVER << "Could not save replay '" << path << "': " << e.what();
+	}
+}
+
 void server::cleanup_game(game* game_ptr)
 {
 	metrics_.game_terminated(game_ptr->termination_reason());
 
 	if(user_handler_){
-		user_handler_->db_update_game_end(uuid_, game_ptr->db_id(), game_ptr->get_replay_filename());
+		async_db_write([uuid = uuid_, id = game_ptr->db_id(), replay = game_ptr->get_replay_filename()](user_handler& uh) {
+			uh.db_update_game_end(uuid, id, replay);
+		});
 	}
 
 	simple_wml::node* const gamelist = games_and_users_list_.child("gamelist");
@@ -1403,19 +1785,28 @@ void server::handle_join_game(player_iterator player, simple_wml::node& join)
 	}
 
 	static simple_wml::document leave_game_doc("[leave_game]\n[/leave_game]\n", simple_wml::INIT_COMPRESSED);
-	if(!g) {
+	const simple_wml::node* shard_game = g ? nullptr : find_shard_entry("game", "id", std::to_string(game_id));
+
+	if(shard_game) {
+		const shard_peer& peer = shard_peers_.at((*shard_game)["shard"].to_string());
+		send_to_player(player, leave_game_doc);
+		send_server_message(player, "This game is hosted on " + peer.client_host + ":" + peer.client_port
+			+ ". Connect to that server to join it.", "error");
+		send_gamelist(player);
+		return;
+	} else if(!g) {
 		WRN_SERVER << player->client_ip() << "\t" << player->info().name()
 				   << "\tattempted to join unknown game:\t" << game_id << ".";
 		send_to_player(player, leave_game_doc);
 		send_server_message(player, "Attempt to join unknown game.", "error");
-		send_to_player(player, games_and_users_list_);
+		send_gamelist(player);
 		return;
 	} else if(!g->level_init()) {
 		WRN_SERVER << player->client_ip() << "\t" << player->info().name()
 				   << "\tattempted to join uninitialized game:\t\"" << g->name() << "\" (" << game_id << ").";
 		send_to_player(player, leave_game_doc);
 		send_server_message(player, "Attempt to join an uninitialized game.", "error");
-		send_to_player(player, games_and_users_list_);
+		send_gamelist(player);
 		return;
 	} else if(player->info().is_moderator()) {
 		// Admins are always allowed to join.
@@ -1425,14 +1816,14 @@ void server::handle_join_game(player_iterator player, simple_wml::node& join)
 				   << "\tfrom game:\t\"" << g->name() << "\" (" << game_id << ").";
 		send_to_player(player, leave_game_doc);
 		send_server_message(player, "You are banned from this game.", "error");
-		send_to_player(player, games_and_users_list_);
+		send_gamelist(player);
 		return;
 	} else if(!g->password_matches(password)) {
 		WRN_SERVER << player->client_ip() << "\t" << player->info().name()
 				   << "\tattempted to join game:\t\"" << g->name() << "\" (" << game_id << ") with bad password";
 		send_to_player(player, leave_game_doc);
 		send_server_message(player, "Incorrect password.", "error");
-		send_to_player(player, games_and_users_list_);
+		send_gamelist(player);
 		return;
 	}
 
@@ -1447,7 +1838,7 @@ void server::handle_join_game(player_iterator player, simple_wml::node& join)
 			"Attempt to observe a game that doesn't allow observers. (You probably joined the "
 			"game shortly after it filled up.)", "error");
 
-		send_to_player(player, games_and_users_list_);
+		send_gamelist(player);
 		return;
 	}
 
@@ -1597,7 +1988,9 @@ void server::handle_player_in_game(player_iterator p, simple_wml::document& data
 
 		g.save_replay();
 		if(user_handler_){
-			user_handler_->db_update_game_end(uuid_, g.db_id(), g.get_replay_filename());
+			async_db_write([uuid = uuid_, id = g.db_id(), replay = g.get_replay_filename()](user_handler& uh) {
+				uh.db_update_game_end(uuid, id, replay);
+			});
 		}
 
 		g.new_scenario(p);
@@ -1678,17 +2071,23 @@ void server::handle_player_in_game(player_iterator p, simple_wml::document& data
 			// [addon] info handling
 			for(const auto& addon : m.children("addon")) {
 				for(const auto& content : addon->children("content")) {
-					unsigned long long rows_inserted = user_handler_->db_insert_game_content_info(uuid_, g.db_id(), content->attr("type").to_string(), content->attr("name").to_string(), content->attr("id").to_string(), addon->attr("id").to_string(), addon->attr("version").to_string());
-					if(rows_inserted == 0) {
-						WRN_SERVER << "Did not insert content row for [addon] data with uuid '" << uuid_ << "', game ID '" << g.db_id() << "', type '" << content->attr("type").to_string() << "', and content ID '" << content->attr("id").to_string() << "'";
-					}
+					async_db_write([uuid = uuid_, id = g.db_id(), type = content->attr("type").to_string(), name = content->attr("name").to_string(),
+							content_id = content->attr("id").to_string(), source = addon->attr("id").to_string(), version = addon->attr("version").to_string()](user_handler& uh) {
+						unsigned long long rows_inserted = uh.db_insert_game_content_info(uuid, id, type, name, content_id, source, version);
+						if(rows_inserted == 0) {
+							WRN_SERVER << "Did not insert content row for [addon] data with uuid '" << uuid << "', game ID '" << id << "', type '" << type << "', and content ID '" << content_id << "'";
+						}
+					});
 				}
 			}
 			if(m.children("addon").size() == 0) {
 				WRN_SERVER << "Game content info missing for game with uuid '" << uuid_ << "', game ID '" << g.db_id() << "', named '" << g.name() << "'";
 			}
 
-			user_handler_->db_insert_game_info(uuid_, g.db_id(), server_id_, g.name(), g.is_reload(), m["observer"].to_bool(), !m["private_replay"].to_bool(), g.has_password());
+			async_db_write([uuid = uuid_, id = g.db_id(), server_id = server_id_, name = g.name(), reload = g.is_reload(),
+					observers = m["observer"].to_bool(), is_public = !m["private_replay"].to_bool(), has_password = g.has_password()](user_handler& uh) {
+				uh.db_insert_game_info(uuid, id, server_id, name, reload, observers, is_public, has_password);
+			});
 
 			const simple_wml::node::child_list& sides = g.get_sides_list();
 			for(unsigned side_index = 0; side_index < sides.size(); ++side_index) {
@@ -1709,7 +2108,10 @@ void server::handle_player_in_game(player_iterator p, simple_wml::document& data
 						source = "Default";
 					}
 				}
-				user_handler_->db_insert_game_player_info(uuid_, g.db_id(), side["player_id"].to_string(), side["side"].to_int(), side["is_host"].to_bool(), side["faction"].to_string(), version, source, side["current_player"].to_string());
+				async_db_write([uuid = uuid_, id = g.db_id(), username = side["player_id"].to_string(), side_number = side["side"].to_int(), is_host = side["is_host"].to_bool(),
+						faction = side["faction"].to_string(), version, source, current_user = side["current_player"].to_string()](user_handler& uh) {
+					uh.db_insert_game_player_info(uuid, id, username, side_number, is_host, faction, version, source, current_user);
+				});
 			}
 		}
 
@@ -1740,7 +2142,7 @@ void server::handle_player_in_game(player_iterator p, simple_wml::document& data
 			}
 
 			// Send the player who has quit the gamelist.
-			send_to_player(p, games_and_users_list_);
+			send_gamelist(p);
 		}
 
 		return;
@@ -1813,7 +2215,7 @@ void server::handle_player_in_game(player_iterator p, simple_wml::document& data
 			send_to_lobby(gamelist_diff, p);
 
 			// Send the removed user the lobby game list.
-			send_to_player(*user, games_and_users_list_);
+			send_gamelist(*user);
 		}
 
 		return;
@@ -1831,7 +2233,7 @@ void server::handle_player_in_game(player_iterator p, simple_wml::document& data
 			if((*info)["condition"].to_string() == "out of sync") {
 				g.send_and_record_server_message(player.name() + " reports out of sync errors.");
 				if(user_handler_){
-					user_handler_->db_set_oos_flag(uuid_, g.db_id());
+					async_db_write([uuid = uuid_, id = g.db_id()](user_handler& uh) { uh.db_set_oos_flag(uuid, id); });
 				}
 			}
 		}
@@ -1911,7 +2313,7 @@ template<class SocketPtr> void server::send_server_message(SocketPtr socket, con
 	msg.set_attr_dup("message", message.c_str());
 	msg.set_attr_dup("type", type.c_str());
 
-	async_send_doc_queued(socket, server_message);
+	async_send_doc_queued(socket, server_message, send_priority::chat);
 }
 
 void server::disconnect_player(player_iterator player)
@@ -1949,6 +2351,10 @@ void server::remove_player(player_iterator iter)
 
 	games_and_users_list_.root().remove_child("user", index);
 
+	if(lobby_filters_.erase(iter->socket()) != 0 && lobby_filters_.empty()) {
+		game_revisions_.clear();
+	}
+
 	LOG_SERVER << ip << "\t" << iter->info().name() << "\thas logged off";
 
 	// Find the matching nick-ip pair in the log and update the sign off time
@@ -1973,95 +2379,802 @@ void server::remove_player(player_iterator iter)
 
 void server::send_to_lobby(simple_wml::document& data, std::optional<player_iterator> exclude)
 {
-	for(const auto& p : player_connections_.get<game_t>().equal_range(0)) {
-		auto player { player_connections_.iterator_to(p) };
-		if(player != exclude) {
-			send_to_player(player, data);
+	// Players with a lobby filter get the games from update_lobby_filters() instead.
+	// Users moving between games can change which games have friends in them, too.
+	const bool games_changed = !lobby_filters_.empty() && note_lobby_game_changes(data);
+	if(!lobby_filters_.empty() && data.child("gamelist_diff") && !lobby_filter_update_pending_) {
+		lobby_filter_update_pending_ = true;
+		lobby_filter_timer_.expires_after(std::chrono::milliseconds(std::max(lobby_diff_interval_, 0)));
+		lobby_filter_timer_.async_wait([this](const boost::system::error_code& ec) {
+			if(!ec) {
+				update_lobby_filters();
+			}
+		});
+	}
+
+	if(queue_lobby_diff(data, exclude)) {
+		return;
+	}
+
+	const encoded_doc_ptr encoded = encode_doc(data);
+	const send_priority priority = data.child("gamelist_diff") ? send_priority::lobby : send_priority::chat;
+	encoded_doc_ptr users_only;
+
+	if(games_changed) {
+		const std::unique_ptr<simple_wml::document> users = data.clone();
+		simple_wml::node& diff = *users->child("gamelist_diff");
+		while(diff.child("change_child")) {
+			diff.remove_child("change_child", 0);
+		}
+
+		if(!diff.no_children()) {
+			users_only = encode_doc(*users);
 		}
 	}
-}
 
-void server::send_server_message_to_lobby(const std::string& message, std::optional<player_iterator> exclude)
-{
 	for(const auto& p : player_connections_.get<game_t>().equal_range(0)) {
 		auto player { player_connections_.iterator_to(p) };
-		if(player != exclude) {
-			send_server_message(player, message, "alert");
+		if(player == exclude) {
+			continue;
 		}
-	}
-}
 
-void server::send_server_message_to_all(const std::string& message, std::optional<player_iterator> exclude)
-{
-	for(auto player = player_connections_.begin(); player != player_connections_.end(); ++player) {
-		if(player != exclude) {
-			send_server_message(player, message, "alert");
+		if(!games_changed || lobby_filters_.count(player->socket()) == 0) {
+			send_to_player(player, encoded, priority);
+		} else if(users_only) {
+			send_to_player(player, users_only, priority);
 		}
 	}
 }
 
-void server::start_new_server()
+void server::send_gamelist(player_iterator player)
 {
-	if(restart_command.empty()) {
-		return;
+	const any_socket_ptr socket = player->socket();
+
+	if(!lobby_diffs_.empty()) {
+		// The list already has every recorded diff applied
+		lobby_diff_start_[socket] = lobby_diffs_.size();
+		lobby_diff_excluded_.erase(socket);
 	}
 
-	// Example config line:
-	// restart_command="./wesnothd-debug -d -c ~/.wesnoth1.5/server.cfg"
-	// remember to make new one as a daemon or it will block old one
-	if(std::system(restart_command.c_str())) {
-		ERR_SERVER << "Failed to start new server with command: " << restart_command;
-	} else {
-		LOG_SERVER << "New server started with command: " << restart_command;
+	const auto filter = lobby_filters_.find(socket);
+	if(filter != lobby_filters_.end()) {
+		send_filtered_gamelist(player, filter->second);
+		return;
 	}
+
+	send_to_player(player, games_and_users_list_, send_priority::lobby_full);
 }
 
-std::string server::process_command(std::string query, std::string issuer_name)
+bool server::note_lobby_game_changes(const simple_wml::document& data)
 {
-	boost::trim(query);
-
-	if(issuer_name == "*socket*" && !query.empty() && query.at(0) == '+') {
-		// The first argument might be "+<issuer>: ".
-		// In that case we use +<issuer>+ as the issuer_name.
-		// (Mostly used for communication with IRC.)
-		auto issuer_end = std::find(query.begin(), query.end(), ':');
+	const simple_wml::node* diff = data.child("gamelist_diff");
+	if(!diff || diff->children("change_child").empty()) {
+		return false;
+	}
 
-		std::string issuer(query.begin() + 1, issuer_end);
-		if(!issuer.empty()) {
-			issuer_name = "+" + issuer + "+";
-			query = std::string(issuer_end + 1, query.end());
-			boost::trim(query);
+	for(const simple_wml::node* change : diff->children("change_child")) {
+		if(const simple_wml::node* gamelist = change->child("gamelist")) {
+			for(const simple_wml::node* insert : gamelist->children("insert_child")) {
+				if(const simple_wml::node* game = insert->child("game")) {
+					++game_revisions_[lobby_game_key(*game)];
+				}
+			}
 		}
 	}
 
-	const auto i = std::find(query.begin(), query.end(), ' ');
-
-	try {
-		const std::string command = utf8::lowercase(std::string(query.begin(), i));
+	return true;
+}
 
-		std::string parameters = (i == query.end() ? "" : std::string(i + 1, query.end()));
-		boost::trim(parameters);
+std::vector<const simple_wml::node*> server::filtered_games(const lobby_filter& filter, std::size_t& matching) const
+{
+	std::set<std::string> friend_games;
+	if(!filter.friends.empty()) {
+		for(const simple_wml::node* user : games_and_users_list_.root().children("user")) {
+			if(filter.friends.count((*user)["name"].to_string()) != 0) {
+				friend_games.insert(lobby_game_key(*user, "game_id"));
+			}
+		}
+	}
 
-		std::ostringstream out;
-		auto handler_itor = cmd_handlers_.find(command);
+	std::vector<const simple_wml::node*> res;
+	matching = 0;
 
-		if(handler_itor == cmd_handlers_.end()) {
-			out << "Command '" << command << "' is not recognized.\n" << help_msg;
-		} else {
-			const cmd_handler& handler = handler_itor->second;
-			try {
-				handler(issuer_name, query, parameters, &out);
-			} catch(const std::bad_function_call& ex) {
-				ERR_SERVER << "While handling a command '" << command
-						   << "', caught a std::bad_function_call exception.";
-				ERR_SERVER << ex.what();
-				out << "An internal server error occurred (std::bad_function_call) while executing '" << command
-					<< "'\n";
+	for(const simple_wml::node* game : games_and_users_list_.child("gamelist")->children("game")) {
+		if(filter.vacant_only) {
+			const simple_wml::node* slots = game->child("slot_data");
+			if(!slots || (*slots)["vacant"].to_int() <= 0) {
+				continue;
 			}
 		}
 
-		return out.str();
-
+		if(filter.no_password && (*game)["password"].to_bool()) {
+			continue;
+		}
+
+		if(!filter.era.empty() && (*game)["mp_era"] != filter.era) {
+			continue;
+		}
+
+		if(!filter.friends.empty() && friend_games.count(lobby_game_key(*game)) == 0) {
+			continue;
+		}
+
+		if(matching >= filter.offset && (filter.limit == 0 || res.size() < filter.limit)) {
+			res.push_back(game);
+		}
+
+		++matching;
+	}
+
+	return res;
+}
+
+void server::send_filtered_gamelist(player_iterator player, lobby_filter& filter)
+{
+	simple_wml::document doc;
+	simple_wml::node& gamelist = doc.root().add_child("gamelist");
+
+	filter.shown.clear();
+	for(const simple_wml::node* game : filtered_games(filter, filter.matching)) {
+		game->copy_into(gamelist.add_child("game"));
+
+		const std::string key = lobby_game_key(*game);
+		const auto revision = game_revisions_.find(key);
+		filter.shown.emplace_back(key, revision != game_revisions_.end() ? revision->second : 0);
+	}
+
+	// Lets the client page through the games the filter lets through
+	gamelist.set_attr_int("matching_games", filter.matching);
+
+	for(const simple_wml::node* user : games_and_users_list_.root().children("user")) {
+		user->copy_into(doc.root().add_child("user"));
+	}
+
+	send_to_player(player, doc, send_priority::lobby_full);
+}
+
+void server::update_lobby_filters()
+{
+	lobby_filter_update_pending_ = false;
+
+	if(lobby_filters_.empty()) {
+		return;
+	}
+
+	// Forget the revisions of games that are gone
+	std::set<std::string> games;
+	for(const simple_wml::node* game : games_and_users_list_.child("gamelist")->children("game")) {
+		games.insert(lobby_game_key(*game));
+	}
+
+	for(auto i = game_revisions_.begin(); i != game_revisions_.end();) {
+		if(games.count(i->first) == 0) {
+			i = game_revisions_.erase(i);
+		} else {
+			++i;
+		}
+	}
+
+	for(const auto& p : player_connections_.get<game_t>().equal_range(0)) {
+		auto player { player_connections_.iterator_to(p) };
+		const auto f = lobby_filters_.find(player->socket());
+		if(f == lobby_filters_.end()) {
+			continue;
+		}
+
+		lobby_filter& filter = f->second;
+		const std::size_t old_matching = filter.matching;
+
+		std::map<std::string, unsigned> wanted;
+		const std::vector<const simple_wml::node*> page = filtered_games(filter, filter.matching);
+		for(const simple_wml::node* game : page) {
+			const std::string key = lobby_game_key(*game);
+			const auto revision = game_revisions_.find(key);
+			wanted.emplace(key, revision != game_revisions_.end() ? revision->second : 0);
+		}
+
+		simple_wml::document doc;
+		simple_wml::node& gamelist = doc.root().add_child("gamelist_diff")
+			.add_child("change_child").set_attr_int("index", 0)
+			.add_child("gamelist");
+
+		// Keep the games the player has as they are, and delete those it should not have any more
+		std::vector<std::pair<std::string, unsigned>> shown;
+		for(std::size_t i = 0; i < filter.shown.size(); ++i) {
+			const auto w = wanted.find(filter.shown[i].first);
+			if(w != wanted.end() && w->second == filter.shown[i].second) {
+				shown.push_back(filter.shown[i]);
+				wanted.erase(w);
+			} else {
+				gamelist.add_child("delete_child").set_attr_int("index", i).add_child("game");
+			}
+		}
+
+		// The client inserts before it deletes, so the new games go after all the old ones
+		std::size_t index = filter.shown.size();
+		for(const simple_wml::node* game : page) {
+			const auto w = wanted.find(lobby_game_key(*game));
+			if(w == wanted.end()) {
+				continue;
+			}
+
+			game->copy_into(gamelist.add_child("insert_child").set_attr_int("index", index++).add_child("game"));
+			shown.push_back(*w);
+		}
+
+		if(filter.matching != old_matching) {
+			gamelist.add_child("insert").set_attr_int("matching_games", filter.matching);
+		}
+
+		filter.shown = std::move(shown);
+
+		if(!gamelist.no_children()) {
+			send_to_player(player, doc, send_priority::lobby);
+		}
+	}
+}
+
+bool server::parse_lobby_diff(const simple_wml::node& diff, lobby_diff& out)
+{
+	if(!lobby_diff_nodes_) {
+		lobby_diff_nodes_ = std::make_unique<simple_wml::document>();
+	}
+
+	int parsed = 0;
+	const auto parse_list = [&](const simple_wml::node& list, int type) {
+		for(const simple_wml::node* insert : list.children("insert_child")) {
+			const simple_wml::node* item = insert->child(lobby_diff_types[type]);
+			if(!item || !insert->one_child()) {
+				return false;
+			}
+
+			simple_wml::node& copy = lobby_diff_nodes_->root().add_child(lobby_diff_types[type]);
+			item->copy_into(copy);
+			out.inserts[type].emplace_back(insert->attr("index").to_int(), &copy);
+		}
+
+		for(const simple_wml::node* del : list.children("delete_child")) {
+			if(!del->child(lobby_diff_types[type]) || !del->one_child()) {
+				return false;
+			}
+
+			out.deletes[type].push_back(del->attr("index").to_int());
+		}
+
+		parsed += list.children("insert_child").size() + list.children("delete_child").size();
+		for(const char* key : { "insert_child", "delete_child" }) {
+			for(const simple_wml::node* child : list.children(key)) {
+				parsed += child->nchildren();
+			}
+		}
+
+		return true;
+	};
+
+	if(!parse_list(diff, 0)) {
+		return false;
+	}
+
+	for(const simple_wml::node* change : diff.children("change_child")) {
+		const simple_wml::node* gamelist = change->child("gamelist");
+		if(!gamelist || !change->one_child() || change->attr("index").to_int() != 0 || !parse_list(*gamelist, 1)) {
+			return false;
+		}
+
+		parsed += 2;
+	}
+
+	// Anything the above did not account for is a diff this can't merge
+	return parsed == diff.nchildren();
+}
+
+bool server::queue_lobby_diff(simple_wml::document& data, std::optional<player_iterator> exclude)
+{
+	const simple_wml::node* diff = data.child("gamelist_diff");
+	if(!diff || (lobby_diff_interval_ <= 0 && lobby_diffs_.empty())) {
+		return false;
+	}
+
+	lobby_diff parsed;
+	if(lobby_diff_interval_ <= 0 || !data.root().one_child() || !parse_lobby_diff(*diff, parsed)) {
+		// Keep the diffs in order
+		flush_lobby_diffs();
+		return false;
+	}
+
+	if(exclude) {
+		// A player left out of a diff normally has just been sent the full gamelist
+		const any_socket_ptr socket = (*exclude)->socket();
+		const auto start = lobby_diff_start_.find(socket);
+		if(start != lobby_diff_start_.end() && start->second == lobby_diffs_.size()) {
+			++start->second;
+		} else {
+			lobby_diff_excluded_.insert(socket);
+		}
+	}
+
+	if(lobby_diffs_.empty()) {
+		lobby_diff_timer_.expires_after(std::chrono::milliseconds(lobby_diff_interval_));
+		lobby_diff_timer_.async_wait([this](const boost::system::error_code& ec) {
+			if(!ec) {
+				flush_lobby_diffs();
+			}
+		});
+	}
+
+	lobby_diffs_.push_back(std::move(parsed));
+	if(lobby_diffs_.size() >= max_lobby_diffs) {
+		flush_lobby_diffs();
+	}
+
+	return true;
+}
+
+server_base::encoded_doc_ptr server::merge_lobby_diffs(std::size_t first, bool games) const
+{
+	merged_list_diff lists[2];
+	for(std::size_t i = first; i < lobby_diffs_.size(); ++i) {
+		for(int type = 0; type < (games ? 2 : 1); ++type) {
+			for(const auto& insert : lobby_diffs_[i].inserts[type]) {
+				lists[type].insert(insert.first, insert.second);
+			}
+
+			// The client marks every delete before removing any of them
+			std::vector<int> deletes = lobby_diffs_[i].deletes[type];
+			std::sort(deletes.rbegin(), deletes.rend());
+			for(int index : deletes) {
+				lists[type].remove(index);
+			}
+		}
+	}
+
+	if(lists[0].empty() && lists[1].empty()) {
+		return nullptr;
+	}
+
+	simple_wml::document doc;
+	simple_wml::node& top = doc.root().add_child("gamelist_diff");
+	lists[0].write(top, lobby_diff_types[0]);
+
+	if(!lists[1].empty()) {
+		simple_wml::node& change = top.add_child("change_child");
+		change.set_attr_int("index", 0);
+		lists[1].write(change.add_child("gamelist"), lobby_diff_types[1]);
+	}
+
+	return encode_doc(doc);
+}
+
+void server::flush_lobby_diffs()
+{
+	if(lobby_diffs_.empty()) {
+		return;
+	}
+
+	lobby_diff_timer_.cancel();
+
+	// Players who were sent the gamelist at the same point share one merged diff,
+	// which has only the users for those with a lobby filter
+	std::map<std::size_t, encoded_doc_ptr> merged[2];
+	encoded_doc_ptr gamelist;
+
+	for(const auto& p : player_connections_.get<game_t>().equal_range(0)) {
+		auto player { player_connections_.iterator_to(p) };
+		const any_socket_ptr socket = player->socket();
+		const auto filter = lobby_filters_.find(socket);
+
+		if(lobby_diff_excluded_.count(socket) != 0) {
+			if(filter != lobby_filters_.end()) {
+				send_filtered_gamelist(player, filter->second);
+				continue;
+			}
+
+			if(!gamelist) {
+				gamelist = encode_doc(games_and_users_list_);
+			}
+
+			send_to_player(player, gamelist, send_priority::lobby_full);
+			continue;
+		}
+
+		const auto start = lobby_diff_start_.find(socket);
+		const std::size_t first = start != lobby_diff_start_.end() ? start->second : 0;
+		if(first >= lobby_diffs_.size()) {
+			continue;
+		}
+
+		const bool games = filter == lobby_filters_.end();
+		auto diff = merged[games].find(first);
+		if(diff == merged[games].end()) {
+			diff = merged[games].emplace(first, merge_lobby_diffs(first, games)).first;
+		}
+
+		if(diff->second) {
+			send_to_player(player, diff->second, send_priority::lobby);
+		}
+	}
+
+	lobby_diffs_.clear();
+	lobby_diff_nodes_.reset();
+	lobby_diff_start_.clear();
+	lobby_diff_excluded_.clear();
+}
+
+void server::send_server_message_to_lobby(const std::string& message, std::optional<player_iterator> exclude)
+{
+	for(const auto& p : player_connections_.get<game_t>().equal_range(0)) {
+		auto player { player_connections_.iterator_to(p) };
+		if(player != exclude) {
+			send_server_message(player, message, "alert");
+		}
+	}
+}
+
+void server::send_server_message_to_all(const std::string& message, std::optional<player_iterator> exclude)
+{
+	for(auto player = player_connections_.begin(); player != player_connections_.end(); ++player) {
+		if(player != exclude) {
+			send_server_message(player, message, "alert");
+		}
+	}
+}
+
+void server::start_new_server()
+{
+	if(restart_command.empty()) {
+		return;
+	}
+
+	// Example config line:
+	// restart_command="./wesnothd-debug -d -c ~/.wesnoth1.5/server.cfg"
+	// remember to make new one as a daemon or it will block old one
+	if(std::system(restart_command.c_str())) {
+		ERR_SERVER << "Failed to start new server with command: " << restart_command;
+	} else {
+		LOG_SERVER << "New server started with command: " << restart_command;
+	}
+}
+
+void server::start_shards()
+{
+	shard_id_ = cfg_["shard_id"].str();
+	if(shard_id_.empty()) {
+		return;
+	}
+
+	shard_secret_ = cfg_["shard_secret"].str();
+	shard_sync_interval_ = std::max(10, cfg_["shard_sync_interval"].to_int(1000));
+
+	std::vector<std::string> ids { shard_id_ };
+	for(const config& shard : cfg_.child_range("shard")) {
+		const std::string id = shard["id"].str();
+		if(id.empty() || id == shard_id_ || shard_peers_.count(id) > 0) {
+			ERR_SERVER << "Ignoring [shard] with missing or duplicate id '" << id << "'";
+			continue;
+		}
+
+		shard_peer& peer = shard_peers_[id];
+		peer.host = shard["host"].str();
+		peer.port = shard["port"].str();
+		peer.client_host = shard["client_host"].str(peer.host);
+		peer.client_port = shard["client_port"].str("15000");
+		peer.wake = std::make_unique<boost::asio::steady_timer>(io_service_);
+		ids.push_back(id);
+	}
+
+	// Every shard numbers its games in its own range, so game ids stay unique across the lobby.
+	// The shards only agree on their ranges if they are all configured with the same shard ids.
+	const int shard_game_id_range = 100000000;
+	std::sort(ids.begin(), ids.end());
+	const auto index = std::distance(ids.begin(), std::find(ids.begin(), ids.end(), shard_id_));
+	game::set_first_id(1 + index * shard_game_id_range);
+
+	if(const int port = cfg_["shard_port"].to_int()) {
+		boost::asio::spawn(io_service_, [this, port](boost::asio::yield_context yield) { accept_shard_links(yield, port); });
+	}
+
+	for(const auto& [id, peer] : shard_peers_) {
+		boost::asio::spawn(io_service_, [this, id = id](boost::asio::yield_context yield) { run_shard_link(yield, id); });
+	}
+
+	LOG_SERVER << "Sharing the lobby as shard '" << shard_id_ << "' with " << shard_peers_.size() << " other shards";
+}
+
+void server::accept_shard_links(boost::asio::yield_context yield, unsigned short port)
+{
+	boost::asio::ip::tcp::acceptor acceptor(io_service_);
+	const boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::tcp::v4(), port);
+
+	try {
+		acceptor.open(endpoint.protocol());
+		acceptor.set_option(boost::asio::ip::tcp::acceptor::reuse_address(true));
+		acceptor.bind(endpoint);
+		acceptor.listen();
+	} catch(const boost::system::system_error& e) {
+		ERR_SERVER << "Exception when trying to bind the shard port: " << e.code().message();
+		BOOST_THROW_EXCEPTION(server_shutdown("Port binding failed", e.code()));
+	}
+
+	while(true) {
+		socket_ptr socket = std::make_shared<socket_ptr::element_type>(io_service_);
+
+		boost::system::error_code error;
+		acceptor.async_accept(*socket, yield[error]);
+		if(error) {
+			ERR_SERVER << "Accepting a shard link failed: " << error.message();
+			return;
+		}
+
+		boost::asio::spawn(io_service_, [this, socket](boost::asio::yield_context yield) { serve_shard_link(yield, socket); });
+	}
+}
+
+void server::serve_shard_link(boost::asio::yield_context yield, socket_ptr socket)
+{
+	auto hello { coro_receive_doc(socket, yield) };
+	const simple_wml::node* shard = hello ? hello->child("shard_hello") : nullptr;
+	if(!shard) {
+		return;
+	}
+
+	const std::string id = (*shard)["id"].to_string();
+	auto peer = shard_peers_.find(id);
+
+	if(peer == shard_peers_.end() || (*shard)["secret"] != shard_secret_) {
+		ERR_SERVER << log_address(socket) << "	rejected a shard link claiming to be '" << id << "'";
+		return;
+	}
+
+	LOG_SERVER << log_address(socket) << "	shard '" << id << "' connected";
+
+	const unsigned link = ++peer->second.incoming;
+	BOOST_SCOPE_EXIT_ALL(this, peer, link) {
+		if(!destructed && peer->second.incoming == link) {
+			import_shard_lobby(peer->first, nullptr);
+		}
+	};
+
+	while(true) {
+		auto doc { coro_receive_doc(socket, yield) };
+		if(!doc) {
+			LOG_SERVER << "Shard '" << id << "' disconnected, removing its users and games";
+			return;
+		}
+
+		if(simple_wml::node* lobby = doc->child("shard_lobby")) {
+			import_shard_lobby(id, lobby);
+		} else if(const simple_wml::node* whisper = doc->child("whisper")) {
+			auto receiver = player_connections_.get<name_t>().find((*whisper)["receiver"].to_string());
+			if(receiver != player_connections_.get<name_t>().end()) {
+				deliver_whisper(player_connections_.project<0>(receiver), *whisper);
+			}
+		}
+	}
+}
+
+void server::run_shard_link(boost::asio::yield_context yield, const std::string& id)
+{
+	// Map elements stay put, and the peers are never removed.
+	shard_peer& peer = shard_peers_.at(id);
+	boost::asio::ip::tcp::resolver resolver(io_service_);
+	boost::system::error_code error;
+
+	while(!destructed) {
+		socket_ptr socket = std::make_shared<socket_ptr::element_type>(io_service_);
+		const auto endpoints = resolver.async_resolve(peer.host, peer.port, yield[error]);
+		if(!error) {
+			boost::asio::async_connect(*socket, endpoints, yield[error]);
+		}
+
+		if(error) {
+			WRN_SERVER << "Could not connect to shard '" << id << "' at " << peer.host << ":" << peer.port << ": " << error.message();
+		} else {
+			LOG_SERVER << "Connected to shard '" << id << "'";
+
+			simple_wml::document hello;
+			simple_wml::node& shard = hello.root().add_child("shard_hello");
+			shard.set_attr_dup("id", shard_id_.c_str());
+			shard.set_attr_dup("secret", shard_secret_.c_str());
+			coro_send_doc(socket, hello, yield);
+
+			peer.connected = socket->is_open();
+			std::string last_sent;
+
+			while(peer.connected) {
+				// The whole lobby is sent, but only when it changed; the peer works out the differences.
+				auto lobby = make_shard_lobby();
+				std::string text = lobby->output();
+				if(text != last_sent) {
+					coro_send_doc(socket, *lobby, yield);
+					last_sent = std::move(text);
+				}
+
+				while(socket->is_open() && !peer.outgoing.empty()) {
+					auto doc = std::move(peer.outgoing.front());
+					peer.outgoing.pop_front();
+					coro_send_doc(socket, *doc, yield);
+				}
+
+				peer.connected = socket->is_open();
+				if(peer.connected) {
+					// Cancelled by send_shard_whisper(), in which case the error is expected.
+					peer.wake->expires_after(std::chrono::milliseconds(shard_sync_interval_));
+					peer.wake->async_wait(yield[error]);
+				}
+			}
+
+			peer.outgoing.clear();
+			WRN_SERVER << "Lost the connection to shard '" << id << "'";
+		}
+
+		peer.wake->expires_after(std::chrono::seconds(5));
+		peer.wake->async_wait(yield[error]);
+	}
+}
+
+std::unique_ptr<simple_wml::document> server::make_shard_lobby()
+{
+	auto doc = std::make_unique<simple_wml::document>();
+	simple_wml::node& lobby = doc->root().add_child("shard_lobby");
+
+	for(const simple_wml::node* user : games_and_users_list_.root().children("user")) {
+		if((*user)["shard"].empty()) {
+			user->copy_into(lobby.add_child("user"));
+		}
+	}
+
+	for(const simple_wml::node* game : games_and_users_list_.child("gamelist")->children("game")) {
+		if((*game)["shard"].empty()) {
+			game->copy_into(lobby.add_child("game"));
+		}
+	}
+
+	return doc;
+}
+
+void server::import_shard_lobby(const std::string& id, simple_wml::node* lobby)
+{
+	sync_shard_entries(id, lobby, games_and_users_list_.root(), nullptr, "user", "name");
+	sync_shard_entries(id, lobby, *games_and_users_list_.child("gamelist"), "gamelist", "game", "id");
+}
+
+void server::sync_shard_entries(const std::string& id, simple_wml::node* lobby, simple_wml::node& list, const char* gamelist, const char* type, const char* key)
+{
+	// Looked up again every time, adding and removing children invalidates the list.
+	const auto index_of = [&list, type](const simple_wml::node* entry) {
+		const simple_wml::node::child_list& entries = list.children(type);
+		return std::distance(entries.begin(), std::find(entries.begin(), entries.end(), entry));
+	};
+
+	// What the lobby had from this shard so far.
+	std::map<std::string, const simple_wml::node*> previous;
+	for(const simple_wml::node* entry : list.children(type)) {
+		if((*entry)["shard"] == id) {
+			previous.emplace((*entry)[key].to_string(), entry);
+		}
+	}
+
+	if(lobby) {
+		for(simple_wml::node* entry : lobby->children(type)) {
+			entry->set_attr_dup("shard", id.c_str());
+
+			simple_wml::document diff;
+			const auto old = previous.find((*entry)[key].to_string());
+
+			if(old == previous.end()) {
+				entry->copy_into(list.add_child(type));
+				make_add_diff(list, gamelist, type, diff);
+				send_to_lobby(diff);
+				continue;
+			}
+
+			const simple_wml::node* current = old->second;
+			previous.erase(old);
+
+			if(simple_wml::node_to_string(*current) == simple_wml::node_to_string(*entry)) {
+				continue;
+			}
+
+			const auto index = index_of(current);
+			list.remove_child(type, index);
+			entry->copy_into(list.add_child_at(type, index));
+
+			make_change_diff(list, gamelist, type, list.children(type)[index], diff);
+			send_to_lobby(diff);
+		}
+	}
+
+	for(const auto& [name, entry] : previous) {
+		simple_wml::document diff;
+		if(make_delete_diff(list, gamelist, type, entry, diff)) {
+			send_to_lobby(diff);
+		}
+
+		list.remove_child(type, index_of(entry));
+	}
+}
+
+const simple_wml::node* server::find_shard_entry(const char* type, const char* key, const std::string& value) const
+{
+	if(shard_peers_.empty()) {
+		return nullptr;
+	}
+
+	const simple_wml::node& list = std::strcmp(type, "game") == 0 ? *games_and_users_list_.child("gamelist") : games_and_users_list_.root();
+	for(const simple_wml::node* entry : list.children(type)) {
+		if(!(*entry)["shard"].empty() && (*entry)[key] == value) {
+			return entry;
+		}
+	}
+
+	return nullptr;
+}
+
+bool server::send_shard_whisper(const simple_wml::node& whisper)
+{
+	const simple_wml::node* user = find_shard_entry("user", "name", whisper["receiver"].to_string());
+	if(!user) {
+		return false;
+	}
+
+	shard_peer& peer = shard_peers_.at((*user)["shard"].to_string());
+	if(!peer.connected) {
+		return false;
+	}
+
+	auto doc = std::make_unique<simple_wml::document>();
+	whisper.copy_into(doc->root().add_child("whisper"));
+	peer.outgoing.push_back(std::move(doc));
+	peer.wake->cancel();
+	return true;
+}
+
+std::string server::process_command(std::string query, std::string issuer_name)
+{
+	boost::trim(query);
+
+	if(issuer_name == "*socket*" && !query.empty() && query.at(0) == '+') {
+		// The first argument might be "+<issuer>: ".
+		// In that case we use +<issuer>+ as the issuer_name.
+		// (Mostly used for communication with IRC.)
+		auto issuer_end = std::find(query.begin(), query.end(), ':');
+
+		std::string issuer(query.begin() + 1, issuer_end);
+		if(!issuer.empty()) {
+			issuer_name = "+" + issuer + "+";
+			query = std::string(issuer_end + 1, query.end());
+			boost::trim(query);
+		}
+	}
+
+	const auto i = std::find(query.begin(), query.end(), ' ');
+
+	try {
+		const std::string command = utf8::lowercase(std::string(query.begin(), i));
+
+		std::string parameters = (i == query.end() ? "" : std::string(i + 1, query.end()));
+		boost::trim(parameters);
+
+		std::ostringstream out;
+		auto handler_itor = cmd_handlers_.find(command);
+
+		if(handler_itor == cmd_handlers_.end()) {
+			out << "Command '" << command << "' is not recognized.\n" << help_msg;
+		} else {
+			const cmd_handler& handler = handler_itor->second;
+			try {
+				handler(issuer_name, query, parameters, &out);
+			} catch(const std::bad_function_call& ex) {
+				ERR_SERVER << "While handling a command '" << command
+						   << "', caught a std::bad_function_call exception.";
+				ERR_SERVER << ex.what();
+				out << "An internal server error occurred (std::bad_function_call) while executing '" << command
+					<< "'\n";
+			}
+		}
+
+		return out.str();
+
 	} catch(const utf8::invalid_utf8_exception& e) {
 		std::string msg = "While handling a command, caught an invalid utf8 exception: ";
 		msg += e.what();
@@ -2195,6 +3308,56 @@ void server::requests_handler(const std::string& /*issuer_name*/,
 	metrics_.requests(*out);
 }
 
+void server::latency_handler(const std::string& /*issuer_name*/,
+		const std::string& /*query*/,
+		std::string& parameters,
+		std::ostringstream* out)
+{
+	assert(out != nullptr);
+
+	if(utf8::lowercase(parameters) == "prometheus") {
+		metrics_.latency_prometheus(*out);
+
+		*out << "# TYPE wesnothd_network_bytes_total counter\n";
+		for(int tls = 0; tls < 2; ++tls) {
+			const char* socket = tls ? "tls" : "plain";
+			*out << "wesnothd_network_bytes_total{socket=\"" << socket << "\",direction=\"in\"} " << io_stats_.bytes_in[tls] << "\n"
+				<< "wesnothd_network_bytes_total{socket=\"" << socket << "\",direction=\"out\"} " << io_stats_.bytes_out[tls] << "\n";
+		}
+
+		*out << "# TYPE wesnothd_send_queue_documents gauge\n"
+			<< "wesnothd_send_queue_documents " << io_stats_.queued_docs << "\n"
+			<< "# TYPE wesnothd_send_queue_max_depth gauge\n"
+			<< "wesnothd_send_queue_max_depth " << io_stats_.max_queue_depth << "\n"
+			<< "# TYPE wesnothd_send_queue_superseded_total counter\n"
+			<< "wesnothd_send_queue_superseded_total " << io_stats_.superseded_docs << "\n"
+			<< "# TYPE wesnothd_send_coroutines gauge\n"
+			<< "wesnothd_send_coroutines " << io_stats_.send_coroutines << "\n"
+			<< "# TYPE wesnothd_tls_handshakes_total counter\n"
+			<< "wesnothd_tls_handshakes_total{result=\"full\"} " << io_stats_.tls_handshakes - io_stats_.tls_resumed << "\n"
+			<< "wesnothd_tls_handshakes_total{result=\"resumed\"} " << io_stats_.tls_resumed << "\n"
+			<< "wesnothd_tls_handshakes_total{result=\"failed\"} " << io_stats_.tls_handshake_failures << "\n"
+			<< "# TYPE wesnothd_tls_handshake_seconds_total counter\n"
+			<< "wesnothd_tls_handshake_seconds_total " << std::chrono::duration<double>(io_stats_.tls_handshake_time).count() << "\n"
+			<< "# TYPE wesnothd_users gauge\n"
+			<< "wesnothd_users " << player_connections_.size() << "\n";
+		return;
+	}
+
+	metrics_.latency(*out);
+	*out << "\nBytes in/out: plain " << io_stats_.bytes_in[0] << "/" << io_stats_.bytes_out[0]
+		<< ", TLS " << io_stats_.bytes_in[1] << "/" << io_stats_.bytes_out[1]
+		<< "\nQueued documents: " << io_stats_.queued_docs << " (longest queue " << io_stats_.max_queue_depth
+		<< ", " << io_stats_.superseded_docs << " superseded lobby updates dropped)"
+		<< "\nSend coroutines: " << io_stats_.send_coroutines
+		<< "\nTLS handshakes: " << io_stats_.tls_handshakes << " (" << io_stats_.tls_resumed << " resumed, "
+		<< io_stats_.tls_handshake_failures << " failed)";
+
+	if(io_stats_.tls_handshakes > 0) {
+		*out << ", average " << std::chrono::duration<double, std::milli>(io_stats_.tls_handshake_time).count() / io_stats_.tls_handshakes << " ms";
+	}
+}
+
 void server::roll_handler(const std::string& issuer_name,
 		const std::string& /*query*/,
 		std::string& parameters,
@@ -2284,14 +3447,8 @@ void server::adminmsg_handler(
 		}
 	}
 
-	bool is_admin = false;
-
-	for(const auto& player : player_connections_) {
-		if(issuer_name == player.info().name() && player.info().is_moderator()) {
-			is_admin = true;
-			break;
-		}
-	}
+	const auto issuer = player_connections_.get<name_t>().find(issuer_name);
+	const bool is_admin = issuer != player_connections_.get<name_t>().end() && issuer->info().is_moderator();
 
 	if(!is_admin) {
 		*out << "Your report has been logged and sent to the server administrators. Thanks!";
@@ -2330,12 +3487,9 @@ void server::pm_handler(
 	msg.set_attr_dup("sender", ("server message from " + sender).c_str());
 	msg.set_attr_dup("message", message.c_str());
 
-	for(const auto& player : player_connections_) {
-		if(receiver != player.info().name().c_str()) {
-			continue;
-		}
-
-		send_to_player(player_connections_.iterator_to(player), data);
+	const auto player = player_connections_.get<name_t>().find(receiver);
+	if(player != player_connections_.get<name_t>().end()) {
+		send_to_player(player_connections_.project<0>(player), data);
 		*out << "Message to " << receiver << " successfully sent.";
 		return;
 	}
@@ -2396,11 +3550,10 @@ void server::version_handler(
 		return;
 	}
 
-	for(const auto& player : player_connections_) {
-		if(parameters == player.info().name()) {
-			*out << "Player " << parameters << " is using wesnoth " << player.info().version();
-			return;
-		}
+	const auto player = player_connections_.get<name_t>().find(parameters);
+	if(player != player_connections_.get<name_t>().end()) {
+		*out << "Player " << parameters << " is using wesnoth " << player->info().version();
+		return;
 	}
 
 	*out << "Player '" << parameters << "' not found.";
@@ -2416,11 +3569,19 @@ void server::status_handler(
 
 	// If a simple username is given we'll check for its IP instead.
 	if(utils::isvalid_username(parameters)) {
-		for(const auto& player : player_connections_) {
-			if(utf8::lowercase(parameters) == utf8::lowercase(player.info().name())) {
-				parameters = player.client_ip();
-				found_something = true;
-				break;
+		const auto player = player_connections_.get<name_t>().find(parameters);
+		if(player != player_connections_.get<name_t>().end()) {
+			parameters = player->client_ip();
+			found_something = true;
+		} else {
+			// Fall back to a case insensitive match
+			const std::string name = utf8::lowercase(parameters);
+			for(const auto& player : player_connections_) {
+				if(name == utf8::lowercase(player.info().name())) {
+					parameters = player.client_ip();
+					found_something = true;
+					break;
+				}
 			}
 		}
 
@@ -2456,28 +3617,23 @@ void server::clones_handler(const std::string& /*issuer_name*/,
 	assert(out != nullptr);
 	*out << "CLONES STATUS REPORT";
 
-	std::set<std::string> clones;
-
-	for(auto it = player_connections_.begin(); it != player_connections_.end(); ++it) {
-		if(clones.find(it->client_ip()) != clones.end()) {
-			continue;
-		}
-
-		bool found = false;
-		for(auto clone = std::next(it); clone != player_connections_.end(); ++clone) {
-			if(it->client_ip() == clone->client_ip()) {
-				if(!found) {
-					found = true;
-					clones.insert(it->client_ip());
-					*out << std::endl << player_status(*it);
-				}
+	bool clones = false;
 
+	// Players with the same IP are next to each other in the IP index
+	const auto& by_ip = player_connections_.get<ip_t>();
+	for(auto it = by_ip.begin(); it != by_ip.end();) {
+		const auto same_ip = by_ip.equal_range(it->client_ip());
+		if(std::next(same_ip.first) != same_ip.second) {
+			clones = true;
+			for(auto clone = same_ip.first; clone != same_ip.second; ++clone) {
 				*out << std::endl << player_status(*clone);
 			}
 		}
+
+		it = same_ip.second;
 	}
 
-	if(clones.empty()) {
+	if(!clones) {
 		*out << std::endl << "No clones found.";
 	}
 }
@@ -2948,7 +4104,7 @@ void server::delete_game(int gameid, const std::string& reason)
 		} else {
 			send_to_player(p, leave_game_doc);
 		}
-		send_to_player(p, games_and_users_list_);
+		send_gamelist(p);
 	}
 }
 
@@ -3042,7 +4198,7 @@ int main(int argc, char** argv)
 					  << "                             Available levels: error, warning, info, debug.\n"
 					  << "  -p, --port <port>          Binds the server to the specified port.\n"
 					  << "  --keepalive                Enable TCP keepalive.\n"
-					  << "  -t, --threads <n>          Uses n worker threads for network I/O (default: 5).\n"
+					  << "  -t, --threads <n>          Uses n threads to decode large received data (default: 5).\n"
 					  << "  -v  --verbose              Turns on more verbose logging.\n"
 					  << "  -V, --version              Returns the server version.\n"
 					  << "  -w, --dump-wml             Print all WML sent to clients to stdout.\n";
@@ -24,10 +24,17 @@
 #include "server/common/server_base.hpp"
 #include "server/wesnothd/player_connection.hpp"
 
+#include <boost/asio/post.hpp>
 #include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/thread_pool.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <optional>
 #include <random>
+#include <unordered_map>
 
 namespace wesnothd
 {
@@ -50,14 +57,17 @@ private:
 
 	template<class SocketPtr> void login_client(boost::asio::yield_context yield, SocketPtr socket);
 	template<class SocketPtr> bool is_login_allowed(boost::asio::yield_context yield, SocketPtr socket, const simple_wml::node* const login, const std::string& username, bool& registered, bool& is_moderator);
-	template<class SocketPtr> bool authenticate(SocketPtr socket, const std::string& username, const std::string& password, bool name_taken, bool& registered);
+	template<class SocketPtr> bool authenticate(boost::asio::yield_context yield, SocketPtr socket, const std::string& username, const std::string& password, bool name_taken, bool& registered);
 	template<class SocketPtr> void send_password_request(SocketPtr socket, const std::string& msg, const char* error_code = "", bool force_confirmation = false);
 	bool accepting_connections() const { return !graceful_restart; }
 
 	template<class SocketPtr> void handle_player(boost::asio::yield_context yield, SocketPtr socket, const player& player);
+	void handle_request(player_iterator player, simple_wml::document& doc);
 	void handle_player_in_lobby(player_iterator player, simple_wml::document& doc);
 	void handle_player_in_game(player_iterator player, simple_wml::document& doc);
+	void handle_lobby_filter(player_iterator player, const simple_wml::node& filter);
 	void handle_whisper(player_iterator player, simple_wml::node& whisper);
+	void deliver_whisper(player_iterator receiver, const simple_wml::node& whisper);
 	void handle_query(player_iterator player, simple_wml::node& query);
 	void handle_nickserv(player_iterator player, simple_wml::node& nickserv);
 	void handle_message(player_iterator player, simple_wml::node& message);
@@ -75,10 +85,28 @@ public:
 			player->socket()
 		);
 	}
+	/**
+	 * Send a document to every player in the lobby.
+	 *
+	 * Gamelist diffs are held back for lobby_diff_interval milliseconds when that is configured,
+	 * and everything recorded in that window is sent as a single merged diff.
+	 */
 	void send_to_lobby(simple_wml::document& data, std::optional<player_iterator> exclude = {});
-	void send_to_player(player_iterator player, simple_wml::document& data) {
+	/**
+	 * Send the full gamelist, keeping track of which held back diffs the player still needs.
+	 *
+	 * Players with a lobby filter only get the games it lets through.
+	 */
+	void send_gamelist(player_iterator player);
+	void send_to_player(player_iterator player, simple_wml::document& data, send_priority priority = send_priority::normal) {
 		utils::visit(
-			[this, &data](auto&& socket) { async_send_doc_queued(socket, data); },
+			[this, &data, priority](auto&& socket) { async_send_doc_queued(socket, data, priority); },
+			player->socket()
+		);
+	}
+	void send_to_player(player_iterator player, const encoded_doc_ptr& data, send_priority priority = send_priority::normal) {
+		utils::visit(
+			[this, &data, priority](auto&& socket) { async_send_doc_queued(socket, data, priority); },
 			player->socket()
 		);
 	}
@@ -89,6 +117,21 @@ public:
 		return player->get_game() != nullptr;
 	}
 
+	/**
+	 * Compresses a replay and writes it to @a path.
+	 *
+	 * This happens on the replay threads unless replay_save_threads is 0 or
+	 * replay_save_queue saves are already waiting, in which case the caller
+	 * does it right away rather than dropping the replay.
+	 *
+	 * @param path The file to write.
+	 * @param data The uncompressed replay WML.
+	 */
+	void save_replay_file(const std::string& path, std::string data);
+
+	/** @return The extension of replay files for the configured replay_compression, with its dot. */
+	const char* replay_file_extension() const;
+
 private:
 	wesnothd::ban_manager ban_manager_;
 
@@ -106,23 +149,44 @@ private:
 
 	std::deque<connection_log> ip_log_;
 
+	/** Password checks of one IP address. */
 	struct login_log
 	{
-		std::string ip;
+		/** Failed attempts since first_attempt, see failed_logins_limit. */
 		int attempts;
 		std::time_t first_attempt;
-
-		bool operator==(const login_log& l) const
-		{
-			// only the IP matters
-			return l.ip == ip;
-		}
+		/** Checks the address may start right away, refilled at login_attempt_rate per minute. */
+		double tokens;
+		std::chrono::steady_clock::time_point refilled;
 	};
 
-	std::deque<login_log> failed_logins_;
+	/** Keyed by IP address, with at most failed_logins_buffer_size entries. */
+	std::unordered_map<std::string, login_log> login_logs_;
+
+	/**
+	 * @return The log of @a ip, with its failed attempts reset if failed_logins_ban
+	 *         has passed and its tokens refilled. Don't keep it across a yield,
+	 *         another login may drop it meanwhile.
+	 */
+	login_log& get_login_log(const std::string& ip);
 
 	std::unique_ptr<user_handler> user_handler_;
 
+	/** Serializes the writes queued by async_db_write() on the query threads of #user_handler_. */
+	std::optional<boost::asio::strand<boost::asio::thread_pool::executor_type>> db_writes_;
+
+	/**
+	 * Runs @a write with #user_handler_ on its query threads without waiting for it.
+	 *
+	 * The writes run one at a time in the order they were queued, so the rows of a game
+	 * are inserted before the update that marks its end.
+	 */
+	template<typename Write>
+	void async_db_write(Write write)
+	{
+		boost::asio::post(*db_writes_, [uh = user_handler_.get(), write = std::move(write)]() { write(*uh); });
+	}
+
 	std::mt19937 die_;
 
 #ifndef _WIN32
@@ -161,12 +225,43 @@ private:
 	bool deny_unregistered_login_;
 	bool save_replays_;
 	std::string replay_save_path_;
+
+	enum class replay_codec { bzip2, gzip };
+	/** How replays are compressed, from replay_compression. */
+	replay_codec replay_codec_;
+	/** How many replays may wait for the replay threads before saving blocks the caller. */
+	std::size_t replay_queue_limit_;
+	/** Replays queued or being written by the replay threads. */
+	std::atomic<std::size_t> replays_pending_;
+
+	/** Finishes the queued replays before the threads are stopped. */
+	struct replay_pool_deleter
+	{
+		void operator()(boost::asio::thread_pool* pool) const
+		{
+			pool->join();
+			delete pool;
+		}
+	};
+
+	/**
+	 * Compresses and writes replays off the event loop, sized by replay_save_threads.
+	 * Declared before the games, which save their replay when destroyed.
+	 */
+	std::unique_ptr<boost::asio::thread_pool, replay_pool_deleter> replay_pool_;
+
+	static void write_replay_file(const std::string& path, const std::string& data, replay_codec codec);
 	bool allow_remote_shutdown_;
 	std::set<std::string> client_sources_;
 	std::vector<std::string> tor_ip_list_;
 	int failed_login_limit_;
 	std::time_t failed_login_ban_;
-	std::deque<login_log>::size_type failed_login_buffer_size_;
+	std::size_t failed_login_buffer_size_;
+	/** How many password checks an address may start at once, see login_log::tokens. */
+	int login_attempt_burst_;
+	/** Password checks per minute an address may sustain, 0 for no limit. */
+	double login_attempt_rate_;
+	int lobby_diff_interval_;
 
 	/** Parse the server config into local variables. */
 	void load_config();
@@ -179,6 +274,8 @@ private:
 	simple_wml::document games_and_users_list_;
 
 	metrics metrics_;
+	/** Requests handled so far, for request_sample_frequency. */
+	unsigned long request_count_;
 
 	player_connections player_connections_;
 
@@ -232,6 +329,7 @@ private:
 	void stats_handler(const std::string &, const std::string &, std::string &, std::ostringstream *);
 	void metrics_handler(const std::string &, const std::string &, std::string &, std::ostringstream *);
 	void requests_handler(const std::string &, const std::string &, std::string &, std::ostringstream *);
+	void latency_handler(const std::string &, const std::string &, std::string &, std::ostringstream *);
 	void roll_handler(const std::string &, const std::string &, std::string &, std::ostringstream *);
 	void games_handler(const std::string &, const std::string &, std::string &, std::ostringstream *);
 	void wml_handler(const std::string &, const std::string &, std::string &, std::ostringstream *);
@@ -270,6 +368,110 @@ private:
 	int dummy_player_timer_interval_;
 	void start_dummy_player_updates();
 	void dummy_player_updates(const boost::system::error_code& ec);
+
+	/** The inserts and deletes of one gamelist diff, for the lobby users (0) and the games (1). */
+	struct lobby_diff
+	{
+		std::vector<std::pair<int, const simple_wml::node*>> inserts[2];
+		std::vector<int> deletes[2];
+	};
+
+	/** Diffs recorded since the last flush, in the order they were made. */
+	std::vector<lobby_diff> lobby_diffs_;
+	/** Owns copies of the children inserted by @ref lobby_diffs_. */
+	std::unique_ptr<simple_wml::document> lobby_diff_nodes_;
+	/** Players sent the full gamelist since the last flush, and the first recorded diff they still need. */
+	std::map<any_socket_ptr, std::size_t> lobby_diff_start_;
+	/** Players left out of a recorded diff, who get the full gamelist on the next flush instead. */
+	std::set<any_socket_ptr> lobby_diff_excluded_;
+	boost::asio::steady_timer lobby_diff_timer_;
+
+	bool parse_lobby_diff(const simple_wml::node& diff, lobby_diff& out);
+	bool queue_lobby_diff(simple_wml::document& data, std::optional<player_iterator> exclude);
+	encoded_doc_ptr merge_lobby_diffs(std::size_t first, bool games = true) const;
+	void flush_lobby_diffs();
+
+	/**
+	 * The games a player asked for with [lobby_filter], and what it was sent of them.
+	 *
+	 * Such players get only the user parts of the gamelist diffs sent to the lobby. The games are
+	 * compared with what they have in @ref update_lobby_filters, and the differences sent to each.
+	 */
+	struct lobby_filter
+	{
+		bool vacant_only { false };
+		bool no_password { false };
+		std::string era;
+		/** Only games one of these players is in. */
+		std::set<std::string> friends;
+		/** The page of the matching games to send, all of them if limit is 0. */
+		std::size_t offset { 0 };
+		std::size_t limit { 0 };
+		/** The games the player has, in the order of its list, with their revision when sent. */
+		std::vector<std::pair<std::string, unsigned>> shown;
+		/** How many games matched when the player was last updated. */
+		std::size_t matching { 0 };
+	};
+
+	std::map<any_socket_ptr, lobby_filter> lobby_filters_;
+	/** Bumped for a game whenever a diff inserts it, only kept while someone has a filter. */
+	std::map<std::string, unsigned> game_revisions_;
+	/** Delays @ref update_lobby_filters like the gamelist diffs, so changes in between go together. */
+	boost::asio::steady_timer lobby_filter_timer_;
+	bool lobby_filter_update_pending_;
+
+	/** Bumps the revisions of the games @a data inserts. @return Whether it changes the games. */
+	bool note_lobby_game_changes(const simple_wml::document& data);
+	/** @return The page of games @a filter lets through, in gamelist order, and how many match in @a matching. */
+	std::vector<const simple_wml::node*> filtered_games(const lobby_filter& filter, std::size_t& matching) const;
+	void send_filtered_gamelist(player_iterator player, lobby_filter& filter);
+	void update_lobby_filters();
+
+	/**
+	 * Another wesnothd process sharing the lobby with this one.
+	 *
+	 * Every shard sends its own users and games, and whispers to players logged in on the receiving
+	 * shard, over a link it opens to each of its peers. Games stay on the shard they were created on.
+	 */
+	struct shard_peer
+	{
+		/** Where the link to the peer connects to, its shard_port. */
+		std::string host;
+		std::string port;
+		/** Where players have to connect to join games hosted there. */
+		std::string client_host;
+		std::string client_port;
+		/** Whether the link to the peer is up. */
+		bool connected { false };
+		/** Counts links accepted from the peer, so that a stale one closing doesn't drop the newer one's lobby. */
+		unsigned incoming { 0 };
+		/** Documents waiting to be sent over the link. */
+		std::deque<std::unique_ptr<simple_wml::document>> outgoing;
+		/** Paces the lobby updates, cancelled to send #outgoing right away. */
+		std::unique_ptr<boost::asio::steady_timer> wake;
+	};
+
+	/** Empty if this server doesn't share its lobby. */
+	std::string shard_id_;
+	std::string shard_secret_;
+	/** Milliseconds between checks for changes of the local lobby to send to the peers. */
+	int shard_sync_interval_;
+	std::map<std::string, shard_peer> shard_peers_;
+
+	/** Reads the shard settings and starts the links. Only done at startup. */
+	void start_shards();
+	void accept_shard_links(boost::asio::yield_context yield, unsigned short port);
+	void serve_shard_link(boost::asio::yield_context yield, socket_ptr socket);
+	void run_shard_link(boost::asio::yield_context yield, const std::string& id);
+	/** The users and games of this shard, as sent to the peers. */
+	std::unique_ptr<simple_wml::document> make_shard_lobby();
+	/** Replaces the users and games of shard @a id by those of @a lobby, or removes them if that is null. */
+	void import_shard_lobby(const std::string& id, simple_wml::node* lobby);
+	void sync_shard_entries(const std::string& id, simple_wml::node* lobby, simple_wml::node& list, const char* gamelist, const char* type, const char* key);
+	/** @return The user or game of another shard whose @a key is @a value, or null. */
+	const simple_wml::node* find_shard_entry(const char* type, const char* key, const std::string& value) const;
+	/** Sends @a whisper to a player on another shard. @return Whether a shard has that player. */
+	bool send_shard_whisper(const simple_wml::node& whisper);
 };
 
 }
@@ -96,6 +96,20 @@ void scenario_stats::write(config_writer &out) const
 
 std::vector<scenario_stats> master_stats;
 
+/**
+ * Per save_id totals of the scenarios before the current one, so that
+ * calculate_stats() only has to merge the current scenario on top of them.
+ * Extended lazily as scenarios are finished.
+ */
+struct finished_scenario_totals
+{
+	/** How many scenarios from the front of master_stats are included. */
+	std::size_t scenarios = 0;
+	team_stats_t team_stats;
+};
+
+finished_scenario_totals finished_totals;
+
 } // end anon namespace
 
 static stats &get_stats(const std::string &save_id)
@@ -701,12 +715,31 @@ stats calculate_stats(const std::string & save_id)
 	stats res;
 
 	DBG_NG << "calculate_stats, side: " << save_id << " master_stats.size: " << master_stats.size();
-	// The order of this loop matters since the turn stats are taken from the
+	if(master_stats.empty()) {
+		return res;
+	}
+
+	// The order of the merges matters since the turn stats are taken from the
 	// last stats merged.
-	for ( std::size_t i = 0; i != master_stats.size(); ++i ) {
-		team_stats_t::const_iterator find_it = master_stats[i].team_stats.find(save_id);
-		if ( find_it != master_stats[i].team_stats.end() )
-			merge_stats(res, find_it->second);
+	const std::size_t finished = master_stats.size() - 1;
+	if(finished_totals.scenarios > finished) {
+		finished_totals = {};
+	}
+
+	for(; finished_totals.scenarios != finished; ++finished_totals.scenarios) {
+		for(const auto& [id, team_stats] : master_stats[finished_totals.scenarios].team_stats) {
+			merge_stats(finished_totals.team_stats[id], team_stats);
+		}
+	}
+
+	team_stats_t::const_iterator find_it = finished_totals.team_stats.find(save_id);
+	if(find_it != finished_totals.team_stats.end()) {
+		res = find_it->second;
+	}
+
+	find_it = master_stats.back().team_stats.find(save_id);
+	if(find_it != master_stats.back().team_stats.end()) {
+		merge_stats(res, find_it->second);
 	}
 
 	return res;
@@ -783,6 +816,7 @@ void read_stats(const config& cfg)
 void fresh_stats()
 {
 	master_stats.clear();
+	finished_totals = {};
 	mid_scenario = false;
 }
 
@@ -14,10 +14,14 @@
 */
 
 #include "synced_checkup.hpp"
+#include "config.hpp"
 #include "log.hpp"
 #include "replay.hpp"
 #include "synced_user_choice.hpp"
 
+#include <iomanip>
+#include <sstream>
+
 static lg::log_domain log_replay("replay");
 #define DBG_REPLAY LOG_STREAM(debug, log_replay)
 #define LOG_REPLAY LOG_STREAM(info, log_replay)
@@ -107,6 +111,66 @@ namespace
 	};
 }
 
+namespace
+{
+	// 64 bit FNV-1a, the result needs to be the same on all platforms.
+	const uint64_t hash_offset = 14695981039346656037ull;
+	const uint64_t hash_prime = 1099511628211ull;
+
+	void hash_string(uint64_t& hash, const std::string& str)
+	{
+		for(unsigned char c : str) {
+			hash = (hash ^ c) * hash_prime;
+		}
+		// Separator, so that "ab" + "c" differs from "a" + "bc".
+		hash = (hash ^ 0xFF) * hash_prime;
+	}
+
+	void hash_config(uint64_t& hash, const config& cfg)
+	{
+		for(const config::attribute& attr : cfg.attribute_range()) {
+			hash_string(hash, attr.first);
+			hash_string(hash, attr.second.str());
+		}
+		for(const config::any_child child : cfg.all_children_range()) {
+			hash_string(hash, child.key);
+			hash_config(hash, child.cfg);
+		}
+		hash_string(hash, "");
+	}
+}
+
+hashed_checkup::hashed_checkup(config& buffer)
+	: buffer_(buffer), hash_(hash_offset)
+{
+}
+
+hashed_checkup::~hashed_checkup()
+{
+}
+
+bool hashed_checkup::local_checkup(const config& expected_data, config& real_data)
+{
+	assert(real_data.empty());
+	hash_config(hash_, expected_data);
+	return true;
+}
+
+bool hashed_checkup::finish()
+{
+	// Prefixed, so it's never stored as a (rounded) number.
+	std::ostringstream ss;
+	ss << 'h' << std::hex << std::setw(16) << std::setfill('0') << hash_;
+	const std::string hash = ss.str();
+
+	if(buffer_.has_attribute("hash")) {
+		return buffer_["hash"].str() == hash;
+	}
+
+	buffer_["hash"] = hash;
+	return true;
+}
+
 mp_debug_checkup::mp_debug_checkup()
 {
 }
@@ -15,6 +15,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 class config;
 /**
 	A class to check whether the results that were calculated in the replay match the results calculated during the original game.
@@ -33,6 +35,11 @@ public:
 		returns whether the two config objects are equal.
 	*/
 	virtual bool local_checkup(const config& expected_data, config& real_data) = 0;
+	/**
+		Called once at the end of the synced action, after the last local_checkup.
+		returns false if the data of the whole action doesn't match the original game.
+	*/
+	virtual bool finish() { return true; }
 };
 
 /**
@@ -51,6 +58,26 @@ private:
 	unsigned int  pos_;
 };
 
+/**
+	Like synced_checkup, but only records a hash of all the checkup data of the action, instead of each result.
+	This makes replays and network traffic much smaller, but a mismatch is only detected at the end of the
+	action, and the original results are not available to local_checkup callers.
+*/
+class hashed_checkup : public checkup
+{
+public:
+	hashed_checkup(config& buffer);
+	virtual ~hashed_checkup();
+	/**
+		always returns true, the data is compared in finish()
+	*/
+	virtual bool local_checkup(const config& expected_data, config& real_data);
+	virtual bool finish();
+private:
+	config& buffer_;
+	uint64_t hash_;
+};
+
 class ignored_checkup : public checkup
 {
 public:
@@ -457,7 +457,7 @@ SYNCED_COMMAND_HANDLER_FUNCTION(debug_terrain, child, use_undo, /*show*/, /*erro
 	bool result = resources::gameboard->change_terrain(loc, terrain_type, mode_str, false);
 	if(result) {
 		display::get_singleton()->invalidate(loc);
-		game_display::get_singleton()->needs_rebuild(result);
+		game_display::get_singleton()->needs_rebuild(loc);
 		game_display::get_singleton()->maybe_rebuild();
 	}
 	return true;
@@ -25,6 +25,7 @@
 #include "log.hpp"
 #include "lua_jailbreak_exception.hpp"
 #include "play_controller.hpp"
+#include "preferences/game.hpp"
 #include "random.hpp"
 #include "random_deterministic.hpp"
 #include "random_synced.hpp"
@@ -380,8 +381,17 @@ checkup* set_scontext_synced::generate_checkup(const std::string& tagname)
 {
 	if(resources::classification->oos_debug) {
 		return new mp_debug_checkup();
+	}
+
+	config& buffer = resources::recorder->get_last_real_command().child_or_add(tagname);
+
+	// When replaying, use whatever the original game recorded.
+	if(buffer.has_attribute("hash")) {
+		return new hashed_checkup(buffer);
+	} else if(buffer.has_child("result") || !preferences::hashed_checkups()) {
+		return new synced_checkup(buffer);
 	} else {
-		return new synced_checkup(resources::recorder->get_last_real_command().child_or_add(tagname));
+		return new hashed_checkup(buffer);
 	}
 }
 
@@ -406,11 +416,16 @@ void set_scontext_synced::do_final_checkup(bool dont_throw)
 		"next_unit_id", resources::gameboard->unit_id_manager().get_save_id() + 1,
 	};
 
-	if(checkup_instance->local_checkup(cn, co)) {
+	const bool results_match = checkup_instance->local_checkup(cn, co);
+	const bool hash_matches = checkup_instance->finish();
+
+	if(results_match && hash_matches) {
 		return;
 	}
 
-	if(co["random_calls"].empty()) {
+	if(!hash_matches) {
+		msg << "The results of this action differ from the original game, which only recorded a hash of them." << std::endl;
+	} else if(co["random_calls"].empty()) {
 		msg << "cannot find random_calls check in replay" << std::endl;
 	} else if(co["random_calls"] != cn["random_calls"]) {
 		msg << "We called random " << new_rng_->get_random_calls() << " times, but the original game called random "
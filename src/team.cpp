@@ -342,6 +342,10 @@ team::team()
 	, enemies_()
 	, ally_shroud_()
 	, ally_fog_()
+	, merged_shroud_()
+	, merged_fog_()
+	, merged_shroud_changes_(0)
+	, merged_fog_changes_(0)
 	, planned_actions_()
 {
 }
@@ -632,6 +636,8 @@ void team::clear_caches()
 			t.enemies_.clear();
 			t.ally_shroud_.clear();
 			t.ally_fog_.clear();
+			t.merged_shroud_changes_ = 0;
+			t.merged_fog_changes_ = 0;
 		}
 	}
 }
@@ -651,7 +657,7 @@ bool team::shrouded(const map_location& loc) const
 		return shroud_.value(loc.wml_x(), loc.wml_y());
 	}
 
-	return shroud_.shared_value(ally_shroud(resources::gameboard->teams()), loc.wml_x(), loc.wml_y());
+	return merged_shroud(resources::gameboard->teams()).value(loc.wml_x(), loc.wml_y());
 }
 
 bool team::fogged(const map_location& loc) const
@@ -669,7 +675,7 @@ bool team::fogged(const map_location& loc) const
 		return fog_.value(loc.wml_x(), loc.wml_y());
 	}
 
-	return fog_.shared_value(ally_fog(resources::gameboard->teams()), loc.wml_x(), loc.wml_y());
+	return merged_fog(resources::gameboard->teams()).value(loc.wml_x(), loc.wml_y());
 }
 
 const std::vector<const shroud_map*>& team::ally_shroud(const std::vector<team>& teams) const
@@ -698,6 +704,26 @@ const std::vector<const shroud_map*>& team::ally_fog(const std::vector<team>& te
 	return ally_fog_;
 }
 
+const shroud_map& team::merged_shroud(const std::vector<team>& teams) const
+{
+	if(merged_shroud_changes_ != shroud_map::changes()) {
+		merged_shroud_.assign_union(ally_shroud(teams), shroud_.enabled());
+		merged_shroud_changes_ = shroud_map::changes();
+	}
+
+	return merged_shroud_;
+}
+
+const shroud_map& team::merged_fog(const std::vector<team>& teams) const
+{
+	if(merged_fog_changes_ != shroud_map::changes()) {
+		merged_fog_.assign_union(ally_fog(teams), fog_.enabled());
+		merged_fog_changes_ = shroud_map::changes();
+	}
+
+	return merged_fog_;
+}
+
 bool team::knows_about_team(std::size_t index) const
 {
 	const team& t = resources::gameboard->teams()[index];
@@ -762,17 +788,29 @@ void validate_side(int side)
 	}
 }
 
-int shroud_map::width() const
-{
-	return data_.size();
-}
+// Starts above the zero that team uses to mark its merged maps as stale.
+std::size_t shroud_map::changes_ = 1;
 
-int shroud_map::height() const
+void shroud_map::resize(int width, int height)
 {
-	if(data_.size() == 0) return 0;
-	return std::max_element(data_.begin(), data_.end(), [](const auto& a, const auto& b) {
-		return a.size() < b.size();
-	})->size();
+	width = std::max(width, width_);
+	height = std::max(height, height_);
+
+	const std::size_t words = (height + 63) / 64;
+	if(words != column_words_) {
+		std::vector<uint64_t> data(width * words, 0);
+		for(int x = 0; x < width_; ++x) {
+			std::copy_n(data_.begin() + x * column_words_, column_words_, data.begin() + x * words);
+		}
+
+		data_.swap(data);
+	} else {
+		data_.resize(width * words, 0);
+	}
+
+	width_ = width;
+	height_ = height;
+	column_words_ = words;
 }
 
 bool shroud_map::clear(int x, int y)
@@ -781,16 +819,13 @@ bool shroud_map::clear(int x, int y)
 		return false;
 	}
 
-	if(x >= static_cast<int>(data_.size())) {
-		data_.resize(x + 1);
+	if(x >= width_ || y >= height_) {
+		resize(x + 1, y + 1);
 	}
 
-	if(y >= static_cast<int>(data_[x].size())) {
-		data_[x].resize(y + 1);
-	}
-
-	if(data_[x][y] == false) {
-		data_[x][y] = true;
+	if(cleared(x, y) == false) {
+		set_cleared(x, y, true);
+		++changes_;
 		return true;
 	}
 
@@ -803,14 +838,15 @@ void shroud_map::place(int x, int y)
 		return;
 	}
 
-	if(x >= static_cast<int>(data_.size())) {
+	if(x >= width_) {
 		DBG_NG << "Couldn't place shroud on invalid x coordinate: (" << x << ", " << y
-			   << ") - max x: " << data_.size() - 1;
-	} else if(y >= static_cast<int>(data_[x].size())) {
+			   << ") - max x: " << width_ - 1;
+	} else if(y >= height_) {
 		DBG_NG << "Couldn't place shroud on invalid y coordinate: (" << x << ", " << y
-			   << ") - max y: " << data_[x].size() - 1;
-	} else {
-		data_[x][y] = false;
+			   << ") - max y: " << height_ - 1;
+	} else if(cleared(x, y)) {
+		set_cleared(x, y, false);
+		++changes_;
 	}
 }
 
@@ -820,9 +856,8 @@ void shroud_map::reset()
 		return;
 	}
 
-	for(auto& i : data_) {
-		std::fill(i.begin(), i.end(), false);
-	}
+	std::fill(data_.begin(), data_.end(), 0);
+	++changes_;
 }
 
 bool shroud_map::value(int x, int y) const
@@ -832,73 +867,67 @@ bool shroud_map::value(int x, int y) const
 	}
 
 	// Locations for which we have no data are assumed to still be covered.
-	if(x < 0 || x >= static_cast<int>(data_.size())) {
-		return true;
-	}
-
-	if(y < 0 || y >= static_cast<int>(data_[x].size())) {
+	if(x < 0 || x >= width_ || y < 0 || y >= height_) {
 		return true;
 	}
 
 	// data_ stores whether or not a location has been cleared, while
 	// we want to return whether or not a location is covered.
-	return !data_[x][y];
+	return !cleared(x, y);
 }
 
-bool shroud_map::shared_value(const std::vector<const shroud_map*>& maps, int x, int y) const
+std::string shroud_map::write() const
 {
-	if(!enabled_) {
-		return false;
-	}
+	std::string shroud_str;
+	shroud_str.reserve(width_ * (height_ + 2));
 
-	// A quick abort:
-	if(x < 0 || y < 0) {
-		return true;
-	}
+	for(int x = 0; x < width_; ++x) {
+		shroud_str += '|';
 
-	// A tile is uncovered if it is uncovered on any shared map.
-	for(const shroud_map* const shared_map : maps) {
-		if(shared_map->enabled_ && !shared_map->value(x, y)) {
-			return false;
+		for(int y = 0; y < height_; ++y) {
+			shroud_str += cleared(x, y) ? '1' : '0';
 		}
+
+		shroud_str += '\n';
 	}
 
-	return true;
+	return shroud_str;
 }
 
-std::string shroud_map::write() const
+void shroud_map::read(const std::string& str)
 {
-	std::stringstream shroud_str;
-	for(const auto& sh : data_) {
-		shroud_str << '|';
-
-		for(bool i : sh) {
-			shroud_str << (i ? '1' : '0');
+	// Find the size first, the columns need not all be the same length.
+	int width = 0, height = 0, column_height = 0;
+	for(const char sh : str) {
+		if(sh == '|') {
+			++width;
+			column_height = 0;
+		} else if(width > 0 && (sh == '1' || sh == '0')) {
+			height = std::max(height, ++column_height);
 		}
-
-		shroud_str << '\n';
 	}
 
-	return shroud_str.str();
-}
-
-void shroud_map::read(const std::string& str)
-{
 	data_.clear();
+	width_ = 0;
+	height_ = 0;
+	column_words_ = 0;
+	resize(width, height);
 
+	int x = -1, y = 0;
 	for(const char sh : str) {
 		if(sh == '|') {
-			data_.resize(data_.size() + 1);
-		}
-
-		if(data_.empty() == false) {
+			++x;
+			y = 0;
+		} else if(x >= 0 && (sh == '1' || sh == '0')) {
 			if(sh == '1') {
-				data_.back().push_back(true);
-			} else if(sh == '0') {
-				data_.back().push_back(false);
+				set_cleared(x, y, true);
 			}
+
+			++y;
 		}
 	}
+
+	++changes_;
 }
 
 void shroud_map::merge(const std::string& str)
@@ -925,17 +954,44 @@ bool shroud_map::copy_from(const std::vector<const shroud_map*>& maps)
 
 	bool cleared = false;
 	for(const shroud_map* m : maps) {
-		if(m->enabled_ == false) {
-			continue;
+		cleared |= add_cleared(*m);
+	}
+
+	if(cleared) {
+		++changes_;
+	}
+
+	return cleared;
+}
+
+void shroud_map::assign_union(const std::vector<const shroud_map*>& maps, bool enabled)
+{
+	enabled_ = enabled;
+	std::fill(data_.begin(), data_.end(), 0);
+
+	if(enabled) {
+		for(const shroud_map* m : maps) {
+			add_cleared(*m);
 		}
+	}
+}
 
-		const std::vector<std::vector<bool>>& v = m->data_;
-		for(std::size_t x = 0; x != v.size(); ++x) {
-			for(std::size_t y = 0; y != v[x].size(); ++y) {
-				if(v[x][y]) {
-					cleared |= clear(x, y);
-				}
-			}
+bool shroud_map::add_cleared(const shroud_map& m)
+{
+	if(m.enabled_ == false) {
+		return false;
+	}
+
+	resize(m.width_, m.height_);
+
+	// Our columns are at least as long as theirs, and the padding bits are never set.
+	bool cleared = false;
+	for(int x = 0; x < m.width_; ++x) {
+		const uint64_t* src = m.column(x);
+		uint64_t* dst = data_.data() + x * column_words_;
+		for(std::size_t w = 0; w < m.column_words_; ++w) {
+			cleared |= (src[w] & ~dst[w]) != 0;
+			dst[w] |= src[w];
 		}
 	}
 
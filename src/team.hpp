@@ -41,31 +41,85 @@ namespace wb {
 	class side_actions;
 }
 
+/**
+ * The hexes a side has cleared of shroud or fog.
+ *
+ * The data is a bitset stored column by column (the WML x coordinate first), each column padded to
+ * a whole number of 64-bit words, so that whole columns of several maps can be combined a word at
+ * a time.
+ */
 class shroud_map {
 public:
-	shroud_map() : enabled_(false), data_() {}
+	shroud_map() : enabled_(false), width_(0), height_(0), column_words_(0), data_() {}
 
 	void place(int x, int y);
 	bool clear(int x, int y);
 	void reset();
 
 	bool value(int x, int y) const;
-	bool shared_value(const std::vector<const shroud_map*>& maps, int x, int y) const;
 
 	bool copy_from(const std::vector<const shroud_map*>& maps);
 
+	/**
+	 * Sets this to the hexes cleared on any of @a maps, as a cache of their union.
+	 * Unlike the other modifications, this does not count in changes().
+	 */
+	void assign_union(const std::vector<const shroud_map*>& maps, bool enabled);
+
+	/** Number of modifications made to any shroud_map so far, to tell when caches built from them are stale. */
+	static std::size_t changes() { return changes_; }
+
 	std::string write() const;
 	void read(const std::string& shroud_data);
 	void merge(const std::string& shroud_data);
 
 	bool enabled() const { return enabled_; }
-	void set_enabled(bool enabled) { enabled_ = enabled; }
+	void set_enabled(bool enabled)
+	{
+		enabled_ = enabled;
+		++changes_;
+	}
+
+	int width() const { return width_; }
+	int height() const { return height_; }
+
+	/**
+	 * The cleared bits of column @a x, bit y % 64 of word y / 64 standing for (x, y).
+	 * @returns column_words() words, or nullptr if @a x is outside the stored data.
+	 */
+	const uint64_t* column(int x) const
+	{
+		return x >= 0 && x < width_ ? data_.data() + x * column_words_ : nullptr;
+	}
+
+	std::size_t column_words() const { return column_words_; }
 
-	int width() const;
-	int height() const;
 private:
+	/** Grows the data to cover @a width columns of @a height hexes. */
+	void resize(int width, int height);
+
+	/** Clears the hexes cleared on @a map. @returns whether any hex was newly cleared. */
+	bool add_cleared(const shroud_map& map);
+
+	bool cleared(int x, int y) const
+	{
+		return (data_[x * column_words_ + y / 64] >> (y % 64)) & 1;
+	}
+
+	void set_cleared(int x, int y, bool value)
+	{
+		const uint64_t bit = uint64_t(1) << (y % 64);
+		uint64_t& word = data_[x * column_words_ + y / 64];
+		word = value ? (word | bit) : (word & ~bit);
+	}
+
 	bool enabled_;
-	std::vector<std::vector<bool>> data_;
+	int width_;
+	int height_;
+	std::size_t column_words_;
+	std::vector<uint64_t> data_;
+
+	static std::size_t changes_;
 };
 
 /**
@@ -404,6 +458,11 @@ private:
 	const std::vector<const shroud_map*>& ally_shroud(const std::vector<team>& teams) const;
 	const std::vector<const shroud_map*>& ally_fog(const std::vector<team>& teams) const;
 
+	/** The union of the allied shroud maps, rebuilt when any map changed since the last call. */
+	const shroud_map& merged_shroud(const std::vector<team>& teams) const;
+	/** The union of the allied fog maps, rebuilt when any map changed since the last call. */
+	const shroud_map& merged_fog(const std::vector<team>& teams) const;
+
 	int gold_;
 	std::set<map_location> villages_;
 
@@ -428,6 +487,14 @@ private:
 
 	mutable std::vector<const shroud_map*> ally_shroud_, ally_fog_;
 
+	/**
+	 * Cached union of ally_shroud_ and ally_fog_, so that the per-hex queries
+	 * read a single bit. Valid while shroud_map::changes() matches the
+	 * recorded count, which clear_caches() resets.
+	 */
+	mutable shroud_map merged_shroud_, merged_fog_;
+	mutable std::size_t merged_shroud_changes_, merged_fog_changes_;
+
 	/**
 	 * Whiteboard planned actions for this team.
 	 */
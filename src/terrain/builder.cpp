@@ -26,11 +26,16 @@
 #include "map/map.hpp"
 #include "preferences/game.hpp"
 #include "serialization/string_utils.hpp"
+#include "utils/frame_profiler.hpp"
+#include "utils/perf_counter.hpp"
 #include "game_config_view.hpp"
 
+#include <boost/functional/hash.hpp>
+
 static lg::log_domain log_engine("engine");
 #define ERR_NG LOG_STREAM(err, log_engine)
 #define WRN_NG LOG_STREAM(warn, log_engine)
+#define DBG_NG LOG_STREAM(debug, log_engine)
 
 /**
  *
@@ -208,6 +213,21 @@ void terrain_builder::tilemap::reset()
 		it->clear();
 }
 
+std::size_t terrain_builder::tilemap::memory_usage() const
+{
+	std::size_t res = tiles_.capacity() * sizeof(tile);
+	for(const tile& t : tiles_) {
+		res += t.images.capacity() * sizeof(tile::rule_image_rand);
+		res += (t.images_foreground.capacity() + t.images_background.capacity()) * sizeof(imagelist::value_type);
+		for(const std::string& flag : t.flags) {
+			// A set node holds the string and three pointers.
+			res += sizeof(std::string) + 4 * sizeof(void*) + (flag.capacity() < sizeof(std::string) ? 0 : flag.capacity());
+		}
+	}
+
+	return res;
+}
+
 void terrain_builder::tilemap::reload(int x, int y)
 {
 	x_ = x;
@@ -289,6 +309,22 @@ void terrain_builder::flush_local_rules()
 void terrain_builder::set_terrain_rules_cfg(const game_config_view& cfg)
 {
 	rules_cfg_ = &cfg;
+
+	// Reloading the game config (e.g. when the active add-ons change) rarely
+	// changes the terrain graphics: keep the parsed rules when their WML is
+	// the same as the one they were built from.
+	std::size_t checksum = 0;
+	for(const config& rule : cfg.child_range("terrain_graphics")) {
+		boost::hash_combine(checksum, rule.hash());
+	}
+
+	if(!building_rules_.empty() && checksum == rules_checksum_) {
+		DBG_NG << "terrain graphics unchanged, keeping " << building_rules_.size() << " parsed rules";
+		return;
+	}
+
+	rules_checksum_ = checksum;
+
 	// use the swap trick to clear the rules cache and get a fresh one.
 	// because simple clear() seems to cause some progressive memory degradation.
 	building_ruleset empty;
@@ -391,6 +427,91 @@ void terrain_builder::rebuild_all()
 	build_terrains();
 }
 
+void terrain_builder::rebuild_region(const std::set<map_location>& locs)
+{
+	PROFILE_SCOPE("terrain_builder::rebuild_region");
+	PERF_TIMER("terrain_builder::rebuild_region");
+
+	if(locs.empty()) {
+		return;
+	}
+
+	log_scope("terrain_builder::rebuild_region");
+
+	hex_area changed{locs.begin()->x, locs.begin()->y, locs.begin()->x, locs.begin()->y};
+	for(const map_location& loc : locs) {
+		changed.x1 = std::min(changed.x1, loc.x);
+		changed.y1 = std::min(changed.y1, loc.y);
+		changed.x2 = std::max(changed.x2, loc.x);
+		changed.y2 = std::max(changed.y2, loc.y);
+	}
+
+	// A rule matching at most `radius` hexes away from a changed hex can set
+	// images and flags up to `2 * radius` hexes away: that is the area which
+	// gets rebuilt. Rules are re-applied on a wider margin around it so that
+	// the flags they depend on are rebuilt in the same order as in a full pass;
+	// the tiles of that margin keep their previous contents.
+	const int radius = rule_radius();
+	const hex_area rebuilt = changed.expand(2 * radius);
+	const hex_area anchors = rebuilt.expand(3 * radius);
+	const hex_area work = anchors.expand(radius);
+
+	const hex_area board{-2, -2, map().w(), map().h()};
+	const hex_area clipped{
+		std::max(work.x1, board.x1), std::max(work.y1, board.y1),
+		std::min(work.x2, board.x2), std::min(work.y2, board.y2)};
+
+	const long long board_size = static_cast<long long>(board.x2 - board.x1 + 1) * (board.y2 - board.y1 + 1);
+	const long long work_size = static_cast<long long>(clipped.x2 - clipped.x1 + 1) * (clipped.y2 - clipped.y1 + 1);
+	if(work_size * 2 >= board_size) {
+		rebuild_all();
+		return;
+	}
+
+	std::vector<std::pair<map_location, tile>> kept;
+	terrain_by_type_map terrain_by_type;
+
+	for(int x = clipped.x1; x <= clipped.x2; ++x) {
+		for(int y = clipped.y1; y <= clipped.y2; ++y) {
+			const map_location loc(x, y);
+			tile& btile = tile_map_[loc];
+
+			if(!rebuilt.contains(loc)) {
+				kept.emplace_back(loc, std::move(btile));
+			}
+
+			btile.clear();
+			if(draw_border_ && !map().on_board(loc)) {
+				btile.flags.insert("_border");
+			} else {
+				btile.flags.insert("_board");
+			}
+
+			terrain_by_type[map().get_terrain(loc)].push_back(loc);
+		}
+	}
+
+	apply_building_rules(terrain_by_type, &anchors);
+
+	for(auto& [loc, btile] : kept) {
+		tile_map_[loc] = std::move(btile);
+	}
+}
+
+int terrain_builder::rule_radius() const
+{
+	int radius = 0;
+
+	for(const building_rule& rule : building_rules_) {
+		for(const terrain_constraint& constraint : rule.constraints) {
+			radius = std::max({radius, std::abs(constraint.loc.x), std::abs(constraint.loc.y)});
+		}
+	}
+
+	// legacy_sum() may shift odd columns by one more hex
+	return radius + 1;
+}
+
 static bool image_exists(const std::string& name)
 {
 	bool precached = name.find("..") == std::string::npos;
@@ -1131,6 +1252,8 @@ unsigned int terrain_builder::building_rule::get_hash() const
 void terrain_builder::build_terrains()
 {
 	log_scope("terrain_builder::build_terrains");
+	PROFILE_SCOPE("terrain_builder::build_terrains");
+	PERF_TIMER("terrain_builder::build_terrains");
 
 	// Builds the terrain_by_type_ cache
 	for(int x = -2; x <= map().w(); ++x) {
@@ -1150,6 +1273,30 @@ void terrain_builder::build_terrains()
 		}
 	}
 
+	apply_building_rules(terrain_by_type_, nullptr);
+}
+
+void terrain_builder::apply_building_rules(const terrain_by_type_map& terrain_by_type, const hex_area* anchors)
+{
+	// Many rules share the same terrain patterns, so the terrains of this map
+	// matching each distinct pattern are only looked up once.
+	std::map<t_translation::ter_list, std::vector<terrain_by_type_map::const_iterator>> types_by_match;
+
+	const auto matching_types_of = [&](const t_translation::ter_match& match)
+		-> const std::vector<terrain_by_type_map::const_iterator>&
+	{
+		auto [cached, inserted] = types_by_match.try_emplace(match.terrain);
+		if(inserted) {
+			for(auto type_it = terrain_by_type.cbegin(); type_it != terrain_by_type.cend(); ++type_it) {
+				if(terrain_matches(type_it->first, match)) {
+					cached->second.push_back(type_it);
+				}
+			}
+		}
+
+		return cached->second;
+	};
+
 	for(const building_rule& rule : building_rules_) {
 		// Find the constraint that contains the less terrain of all terrain rules.
 		// We will keep a track of the matching terrains of this constraint
@@ -1162,21 +1309,16 @@ void terrain_builder::build_terrains()
 		const terrain_constraint* min_constraint = nullptr;
 
 		for(const terrain_constraint& constraint : rule.constraints) {
-			const t_translation::ter_match& match = constraint.terrain_types_match;
 			t_translation::ter_list matching_types;
 			std::size_t constraint_size = 0;
 
-			for(terrain_by_type_map::iterator type_it = terrain_by_type_.begin(); type_it != terrain_by_type_.end();
-					++type_it) {
-				const t_translation::terrain_code t = type_it->first;
-				if(terrain_matches(t, match)) {
-					const std::size_t match_size = type_it->second.size();
-					constraint_size += match_size;
-					if(constraint_size >= min_size) {
-						break; // not a minimum, bail out
-					}
-					matching_types.push_back(t);
+			for(const auto& type_it : matching_types_of(constraint.terrain_types_match)) {
+				const std::size_t match_size = type_it->second.size();
+				constraint_size += match_size;
+				if(constraint_size >= min_size) {
+					break; // not a minimum, bail out
 				}
+				matching_types.push_back(type_it->first);
 			}
 
 			if(constraint_size < min_size) {
@@ -1195,11 +1337,15 @@ void terrain_builder::build_terrains()
 
 		// NOTE: if min_types is not empty, we have found a valid min_constraint;
 		for(t_translation::ter_list::const_iterator t = min_types.begin(); t != min_types.end(); ++t) {
-			const std::vector<map_location>* locations = &terrain_by_type_[*t];
+			const std::vector<map_location>* locations = &terrain_by_type.at(*t);
 
 			for(std::vector<map_location>::const_iterator itor = locations->begin(); itor != locations->end(); ++itor) {
 				const map_location loc = legacy_difference(*itor, min_constraint->loc);
 
+				if(anchors && !anchors->contains(loc)) {
+					continue;
+				}
+
 				if(rule_matches(rule, loc, min_constraint)) {
 					apply_rule(rule, loc);
 				}
@@ -1208,6 +1354,11 @@ void terrain_builder::build_terrains()
 	}
 }
 
+std::size_t terrain_builder::memory_usage() const
+{
+	return tile_map_.memory_usage();
+}
+
 terrain_builder::tile* terrain_builder::get_tile(const map_location& loc)
 {
 	if(tile_map_.on_map(loc))
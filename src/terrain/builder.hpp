@@ -151,6 +151,15 @@ public:
 	 */
 	void rebuild_all();
 
+	/** Rebuilds the terrain graphics around a set of changed locations.
+	 * Only the rules whose matches may be affected by the change are
+	 * re-applied, on a neighbourhood of the changed locations. Falls back to
+	 * rebuild_all() when that neighbourhood covers most of the map.
+	 *
+	 * @param locs  the locations whose terrain has changed
+	 */
+	void rebuild_region(const std::set<map_location>& locs);
+
 	void rebuild_cache_all();
 
 	void set_draw_border(bool do_draw)
@@ -389,6 +398,9 @@ public:
 
 	tile* get_tile(const map_location& loc);
 
+	/** Approximate memory used by the tiles of the current map, in bytes. */
+	std::size_t memory_usage() const;
+
 private:
 	/** The tile width used when using basex and basey. This is not,
 	 * necessarily, the tile width in pixels, this is totally
@@ -515,6 +527,9 @@ private:
 		 */
 		void reload(int x, int y);
 
+		/** Approximate memory used by the tiles, in bytes. */
+		std::size_t memory_usage() const;
+
 	private:
 		/** The map */
 		std::vector<tile> tiles_;
@@ -856,6 +871,34 @@ private:
 	 */
 	terrain_by_type_map terrain_by_type_;
 
+	/** A rectangle of locations, bounds included. */
+	struct hex_area
+	{
+		int x1, y1, x2, y2;
+
+		bool contains(const map_location& loc) const
+		{
+			return loc.x >= x1 && loc.x <= x2 && loc.y >= y1 && loc.y <= y2;
+		}
+
+		hex_area expand(int n) const
+		{
+			return {x1 - n, y1 - n, x2 + n, y2 + n};
+		}
+	};
+
+	/**
+	 * Applies the building rules, in order, to the locations of the given index.
+	 *
+	 * @param terrain_by_type  The locations to consider, by terrain type.
+	 * @param anchors          If not nullptr, rules are only applied when
+	 *                         their origin lies in this area.
+	 */
+	void apply_building_rules(const terrain_by_type_map& terrain_by_type, const hex_area* anchors);
+
+	/** The largest distance between a rule's origin and one of its constraints. */
+	int rule_radius() const;
+
 	/** Whether the map border should be drawn. */
 	bool draw_border_;
 
@@ -864,4 +907,7 @@ private:
 
 	/** Config used to parse global terrain rules */
 	static const inline game_config_view* rules_cfg_ = nullptr;
+
+	/** Checksum of the [terrain_graphics] the cached rules were parsed from */
+	static inline std::size_t rules_checksum_ = 0;
 };
@@ -44,6 +44,16 @@ static lg::log_domain log_engine("engine");
 static lg::log_domain log_wml("wml");
 #define ERR_WML LOG_STREAM(err, log_wml)
 
+/** Whether @a item is one of the entries of the comma-separated @a list, without splitting it into strings. */
+static bool list_contains(std::string_view list, std::string_view item)
+{
+	bool found = false;
+	utils::split_foreach(list, ',', utils::REMOVE_EMPTY | utils::STRIP_SPACES, [&](std::string_view entry) {
+		found = found || entry == item;
+	});
+	return found;
+}
+
 terrain_filter::~terrain_filter()
 {
 }
@@ -156,14 +166,15 @@ bool terrain_filter::match_internal(const map_location& loc, const unit* ref_uni
 			}
 		}
 		if (cfg_.has_attribute("location_id")) {
-			std::set<map_location> matching_locs;
-			for(const auto& id : utils::split(cfg_["location_id"])) {
-				map_location test_loc = fc_->get_disp_context().map().special_location(id);
-				if(test_loc.valid()) {
-					matching_locs.insert(test_loc);
+			const t_string& t_location_ids = cfg_["location_id"];
+			bool found = false;
+			utils::split_foreach(t_location_ids.str(), ',', utils::REMOVE_EMPTY | utils::STRIP_SPACES, [&](std::string_view id) {
+				if(!found) {
+					const map_location test_loc = fc_->get_disp_context().map().special_location(std::string(id));
+					found = test_loc.valid() && test_loc == loc;
 				}
-			}
-			if (matching_locs.count(loc) == 0) {
+			});
+			if (!found) {
 				return false;
 			}
 		}
@@ -273,17 +284,16 @@ bool terrain_filter::match_internal(const map_location& loc, const unit* ref_uni
 		}
 
 		if(!tod_type.empty()) {
-			const std::vector<std::string>& vals = utils::split(tod_type);
 			if(tod.lawful_bonus<0) {
-				if(std::find(vals.begin(),vals.end(), unit_alignments::chaotic) == vals.end()) {
+				if(!list_contains(tod_type, unit_alignments::chaotic)) {
 					return false;
 				}
 			} else if(tod.lawful_bonus>0) {
-				if(std::find(vals.begin(),vals.end(), unit_alignments::lawful) == vals.end()) {
+				if(!list_contains(tod_type, unit_alignments::lawful)) {
 					return false;
 				}
-			} else if(std::find(vals.begin(),vals.end(), unit_alignments::neutral) == vals.end() &&
-				std::find(vals.begin(),vals.end(), unit_alignments::liminal) == vals.end()) {
+			} else if(!list_contains(tod_type, unit_alignments::neutral) &&
+				!list_contains(tod_type, unit_alignments::liminal)) {
 				return false;
 			}
 		}
@@ -293,8 +303,7 @@ bool terrain_filter::match_internal(const map_location& loc, const unit* ref_uni
 				if(std::find(tod_id.begin(),tod_id.end(),',') != tod_id.end() &&
 					std::search(tod_id.begin(),tod_id.end(),
 					tod.id.begin(),tod.id.end()) != tod_id.end()) {
-					const std::vector<std::string>& vals = utils::split(tod_id);
-					if(std::find(vals.begin(),vals.end(),tod.id) == vals.end()) {
+					if(!list_contains(tod_id, tod.id)) {
 						return false;
 					}
 				} else {
@@ -498,7 +507,8 @@ public:
 	{
 		if (filter.cfg_.has_attribute("x") || filter.cfg_.has_attribute("y")) {
 			std::vector<map_location> xy_vector = filter.fc_->get_disp_context().map().parse_location_range(filter.cfg_["x"], filter.cfg_["y"], with_border);
-			filter_area(src, dest, filter, [&xy_vector](const map_location& loc) { return std::find(xy_vector.begin(), xy_vector.end(), loc) != xy_vector.end(); });
+			std::sort(xy_vector.begin(), xy_vector.end());
+			filter_area(src, dest, filter, [&xy_vector](const map_location& loc) { return std::binary_search(xy_vector.begin(), xy_vector.end(), loc); });
 		}
 		else {
 			filter_area(src, dest, filter, no_filter());
@@ -527,6 +537,28 @@ void terrain_filter::get_locs_impl(std::set<map_location>& locs, const unit* ref
 	// See if the caller provided an override to with_border
 	with_border = cfg_["include_borders"].to_bool(with_border);
 
+	//handle location filter
+	if(cfg_.has_child("filter_adjacent_location")) {
+		if(cache_.adjacent_matches == nullptr) {
+			cache_.adjacent_matches.reset(new std::vector<std::set<map_location>>());
+		}
+		const vconfig::child_list& adj_cfgs = cfg_.get_children("filter_adjacent_location");
+		for (unsigned i = 0; i < adj_cfgs.size(); ++i) {
+			std::set<map_location> adj_set;
+			/* GCC-3.3 doesn't like operator[] so use at(), which has the same result */
+			terrain_filter(adj_cfgs.at(i), *this).get_locations(adj_set, with_border);
+			cache_.adjacent_matches->push_back(adj_set);
+			if(i >= max_loop_ && i+1 < adj_cfgs.size()) {
+				ERR_NG << "terrain_filter: loop count greater than " << max_loop_
+				<< ", aborting";
+				break;
+			}
+		}
+	}
+
+	// Whether the candidates are the whole map, which are matched as they are collected.
+	bool whole_map = false;
+
 	if (cfg_.has_attribute("find_in")) {
 
 		if (const game_data * gd = fc_->get_game_data()) {
@@ -563,42 +595,32 @@ void terrain_filter::get_locs_impl(std::set<map_location>& locs, const unit* ref
 	}
 	else {
 		//consider all locations on the map
+		//only the matching ones are stored, as most of the map usually doesn't match
 		int bs = fc_->get_disp_context().map().border_size();
 		int w = with_border ? fc_->get_disp_context().map().w() + bs : fc_->get_disp_context().map().w();
 		int h = with_border ? fc_->get_disp_context().map().h() + bs : fc_->get_disp_context().map().h();
 		for (int x = with_border ? 0 - bs : 0; x < w; ++x) {
 			for (int y = with_border ? 0 - bs : 0; y < h; ++y) {
-				match_set.insert(map_location(x, y));
+				const map_location loc(x, y);
+				if(match_internal(loc, ref_unit, true)) {
+					// locations are visited in order, so this is constant time
+					match_set.insert(match_set.end(), loc);
+				}
 			}
 		}
+		whole_map = true;
 	}
 
-	//handle location filter
-	if(cfg_.has_child("filter_adjacent_location")) {
-		if(cache_.adjacent_matches == nullptr) {
-			cache_.adjacent_matches.reset(new std::vector<std::set<map_location>>());
-		}
-		const vconfig::child_list& adj_cfgs = cfg_.get_children("filter_adjacent_location");
-		for (unsigned i = 0; i < adj_cfgs.size(); ++i) {
-			std::set<map_location> adj_set;
-			/* GCC-3.3 doesn't like operator[] so use at(), which has the same result */
-			terrain_filter(adj_cfgs.at(i), *this).get_locations(adj_set, with_border);
-			cache_.adjacent_matches->push_back(adj_set);
-			if(i >= max_loop_ && i+1 < adj_cfgs.size()) {
-				ERR_NG << "terrain_filter: loop count greater than " << max_loop_
-				<< ", aborting";
-				break;
+	if(!whole_map) {
+		std::set<map_location>::iterator loc_itor = match_set.begin();
+		while(loc_itor != match_set.end()) {
+			if(match_internal(*loc_itor, ref_unit, true)) {
+				++loc_itor;
+			} else {
+				loc_itor = match_set.erase(loc_itor);
 			}
 		}
 	}
-	std::set<map_location>::iterator loc_itor = match_set.begin();
-	while(loc_itor != match_set.end()) {
-		if(match_internal(*loc_itor, ref_unit, true)) {
-			++loc_itor;
-		} else {
-			loc_itor = match_set.erase(loc_itor);
-		}
-	}
 
 	int ors_left = std::count_if(cfg_.ordered_begin(), cfg_.ordered_end(), [](const auto& val) { return val.first == "or"; });
 
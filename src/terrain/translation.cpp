@@ -106,6 +106,16 @@ namespace t_translation {
 	 */
 	static std::string number_to_string_(terrain_code terrain, const std::vector<std::string>& start_position = std::vector<std::string>());
 
+	/**
+	 * Appends the string representation of a terrain to a string.
+	 * Same as number_to_string_ without starting positions, but
+	 * without creating a temporary string.
+	 *
+	 * @param result                The string to append to.
+	 * @param terrain               The terrain number to convert.
+	 */
+	static void append_terrain_string_(std::string& result, terrain_code terrain);
+
 	/**
 	 * Converts a terrain string to a number for the builder.
 	 * The translation rules differ from the normal conversion rules
@@ -308,15 +318,18 @@ ter_map read_game_map(std::string_view str, starting_positions& starting_positio
 	auto map_size = get_map_size(&str[0], &str[0] + str.size());
 	ter_map result(map_size.first, map_size.second);
 
+	static constexpr std::string_view separators = ",\n\r";
+	// Reused for every chunk, most chunks have no starting positions
+	std::vector<std::string> sp;
+
 	while(offset < str.length()) {
 
 		// Get a terrain chunk
-		const std::string separators = ",\n\r";
 		const std::size_t pos_separator = str.find_first_of(separators, offset);
 		std::string_view terrain = str.substr(offset, pos_separator - offset);
 
 		// Process the chunk
-		std::vector<std::string> sp;
+		sp.clear();
 		// The gamemap never has a wildcard
 		const terrain_code tile = string_to_number_(terrain, sp, NO_LAYER);
 
@@ -390,32 +403,41 @@ ter_map read_game_map(std::string_view str, starting_positions& starting_positio
 
 std::string write_game_map(const ter_map& map, const starting_positions& starting_positions, coordinate border_offset)
 {
-	std::stringstream str;
+	std::string str;
+	// Most hexes are written as "Xx^Yy, ", reserve enough for that
+	str.reserve(static_cast<std::size_t>(map.w) * map.h * 8 + map.h);
 
 	for(int y = 0; y < map.h; ++y) {
 		for(int x = 0; x < map.w; ++x) {
 
-			// If the current location is a starting position,
-			// it needs to be added to the terrain.
-			// After it's found it can't be found again,
-			// so the location is removed from the map.
-			std::vector<std::string> sp;
-
-			for(const auto& pair : starting_positions.right.equal_range(coordinate(x - border_offset.x, y - border_offset.y))) {
-				sp.push_back(pair.second);
-			}
 			// Add the separator
 			if(x != 0) {
-				str << ", ";
+				str += ", ";
 			}
-			str << number_to_string_(map[x][y], sp);
+
+			// If the current location is a starting position,
+			// it needs to be added to the terrain.
+			if(!starting_positions.empty()) {
+				const auto range = starting_positions.right.equal_range(coordinate(x - border_offset.x, y - border_offset.y));
+				// Each position was historically prepended, keep that order
+				std::vector<std::string_view> sp;
+				for(const auto& pair : range) {
+					sp.push_back(pair.second);
+				}
+				for(auto itor = sp.rbegin(); itor != sp.rend(); ++itor) {
+					str += *itor;
+					str += ' ';
+				}
+			}
+
+			append_terrain_string_(str, map[x][y]);
 		}
 
 		if (y < map.h -1)
-			str << "\n";
+			str += '\n';
 	}
 
-	return str.str();
+	return str;
 }
 
 bool terrain_matches(const terrain_code& src, const terrain_code& dest)
@@ -774,15 +796,8 @@ static terrain_code string_to_number_(std::string_view str, std::vector<std::str
 	return result;
 }
 
-static std::string number_to_string_(terrain_code terrain, const std::vector<std::string>& start_positions)
+static void append_terrain_string_(std::string& result, terrain_code terrain)
 {
-	std::string result = "";
-
-	// Insert the start position
-	for (const std::string& str : start_positions) {
-		result = str + " " + result;
-	}
-
 	/*
 	 * The initialization of tcode is done to make gcc-4.7 happy. Otherwise it
 	 * some uninitialized fields might be used. Its analysis are wrong, but
@@ -816,7 +831,18 @@ static std::string number_to_string_(terrain_code terrain, const std::vector<std
 			break;
 		}
 	}
+}
+
+static std::string number_to_string_(terrain_code terrain, const std::vector<std::string>& start_positions)
+{
+	std::string result = "";
+
+	// Insert the start position
+	for (const std::string& str : start_positions) {
+		result = str + " " + result;
+	}
 
+	append_terrain_string_(result, terrain);
 	return result;
 }
 
@@ -18,6 +18,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include "addon/validation.hpp"
+#include "config.hpp"
 
 BOOST_AUTO_TEST_SUITE( addons )
 
@@ -127,4 +128,29 @@ BOOST_AUTO_TEST_CASE( encoding )
 	BOOST_CHECK( recursive_encoded == raw );
 }
 
+BOOST_AUTO_TEST_CASE( hashlist_checksums )
+{
+	config a;
+	a.add_child("file", config{"name", "_main.cfg", "hash", "AAAA"});
+	a.add_child("dir", config{"name", "maps"}).add_child("file", config{"name", "1.map", "hash", "BBBB"});
+
+	// Same files in another order
+	config b;
+	b.add_child("dir", config{"name", "maps"}).add_child("file", config{"name", "1.map", "hash", "BBBB"});
+	b.add_child("file", config{"name", "_main.cfg", "hash", "AAAA"});
+
+	BOOST_CHECK_EQUAL( hashlist_checksum(a), hashlist_checksum(b) );
+	BOOST_CHECK_EQUAL( hashlist_checksum(a).size(), 16u );
+
+	// Changed contents
+	b.child("file")["hash"] = "CCCC";
+	BOOST_CHECK_NE( hashlist_checksum(a), hashlist_checksum(b) );
+
+	// Same file in another directory
+	config c;
+	c.add_child("file", config{"name", "_main.cfg", "hash", "AAAA"});
+	c.add_child("file", config{"name", "1.map", "hash", "BBBB"});
+	BOOST_CHECK_NE( hashlist_checksum(a), hashlist_checksum(c) );
+}
+
 BOOST_AUTO_TEST_SUITE_END()
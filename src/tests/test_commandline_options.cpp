@@ -40,6 +40,7 @@ BOOST_AUTO_TEST_CASE (test_empty_options)
 #endif
 	BOOST_CHECK(!co.editor);
 	BOOST_CHECK(!co.fps);
+	BOOST_CHECK(!co.frame_trace);
 	BOOST_CHECK(!co.fullscreen);
 	BOOST_CHECK(!co.gunzip);
 	BOOST_CHECK(!co.gzip);
@@ -47,6 +48,7 @@ BOOST_AUTO_TEST_CASE (test_empty_options)
 	BOOST_CHECK(!co.load);
 	BOOST_CHECK(!co.log);
 	BOOST_CHECK(!co.logdomains);
+	BOOST_CHECK(!co.lua_profile);
 	BOOST_CHECK(!co.multiplayer);
 	BOOST_CHECK(!co.multiplayer_ai_config);
 	BOOST_CHECK(!co.multiplayer_algorithm);
@@ -79,6 +81,7 @@ BOOST_AUTO_TEST_CASE (test_empty_options)
 	BOOST_CHECK(!co.screenshot_map_file);
 	BOOST_CHECK(!co.screenshot_output_file);
 	BOOST_CHECK(!co.test);
+	BOOST_CHECK(!co.uncompressed_cache);
 	BOOST_CHECK(!co.userconfig_dir);
 	BOOST_CHECK(!co.userconfig_path);
 	BOOST_CHECK(!co.userdata_dir);
@@ -115,6 +118,7 @@ BOOST_AUTO_TEST_CASE (test_default_options)
 #endif
 	BOOST_CHECK(co.editor && co.editor->empty());
 	BOOST_CHECK(!co.fps);
+	BOOST_CHECK(!co.frame_trace);
 	BOOST_CHECK(!co.fullscreen);
 	BOOST_CHECK(!co.gunzip);
 	BOOST_CHECK(!co.gzip);
@@ -122,6 +126,7 @@ BOOST_AUTO_TEST_CASE (test_default_options)
 	BOOST_CHECK(!co.load);
 	BOOST_CHECK(!co.log);
 	BOOST_CHECK(co.logdomains && co.logdomains->empty());
+	BOOST_CHECK(!co.lua_profile);
 	BOOST_CHECK(!co.multiplayer);
 	BOOST_CHECK(!co.multiplayer_ai_config);
 	BOOST_CHECK(!co.multiplayer_algorithm);
@@ -154,6 +159,7 @@ BOOST_AUTO_TEST_CASE (test_default_options)
 	BOOST_CHECK(!co.screenshot_map_file);
 	BOOST_CHECK(!co.screenshot_output_file);
 	BOOST_CHECK(co.test && co.test->empty());
+	BOOST_CHECK(!co.uncompressed_cache);
 	BOOST_CHECK(!co.userconfig_dir);
 	BOOST_CHECK(!co.userconfig_path);
 	BOOST_CHECK(!co.userdata_dir);
@@ -190,6 +196,7 @@ BOOST_AUTO_TEST_CASE (test_full_options)
 		"--era=erafoo",
 		"--exit-at-end",
 		"--fps",
+		"--frame-trace=tracefoo.json",
 		"--fullscreen",
 		"--gunzip=gunzipfoo.gz",
 		"--gzip=gzipfoo",
@@ -202,6 +209,7 @@ BOOST_AUTO_TEST_CASE (test_full_options)
 		"--log-info=infofoo",
 		"--log-debug=dbgfoo,dbgbar,dbg/foo/bar/baz",
 		"--logdomains=filterfoo",
+		"--lua-profile=profilefoo.txt",
 		"--max-fps=100",
 		"--multiplayer",
 		"--new-widgets",
@@ -225,6 +233,7 @@ BOOST_AUTO_TEST_CASE (test_full_options)
 		"--server=servfoo",
 		"--test=testfoo",
 		"--turns=42",
+		"--uncompressed-cache",
 		"--userconfig-dir=userconfigdirfoo",
 		"--userconfig-path",
 		"--userdata-dir=userdatadirfoo",
@@ -250,6 +259,7 @@ BOOST_AUTO_TEST_CASE (test_full_options)
 #endif
 	BOOST_CHECK(co.editor && *co.editor == "editfoo");
 	BOOST_CHECK(co.fps);
+	BOOST_CHECK(co.frame_trace && *co.frame_trace == "tracefoo.json");
 	BOOST_CHECK(co.fullscreen);
 	BOOST_CHECK(co.gunzip && *co.gunzip == "gunzipfoo.gz");
 	BOOST_CHECK(co.gzip && *co.gzip == "gzipfoo");
@@ -266,6 +276,7 @@ BOOST_AUTO_TEST_CASE (test_full_options)
 	BOOST_CHECK(co.log->at(5).first  == 3         && co.log->at(6).first == 3        && co.log->at(7).first == 3);
 	BOOST_CHECK(co.log->at(5).second == "dbgfoo"  && co.log->at(6).second == "dbgbar" && co.log->at(7).second == "dbg/foo/bar/baz");
 	BOOST_CHECK(co.logdomains && *co.logdomains == "filterfoo");
+	BOOST_CHECK(co.lua_profile && *co.lua_profile == "profilefoo.txt");
 	BOOST_CHECK(co.multiplayer);
 	BOOST_CHECK(co.multiplayer_ai_config);
 	BOOST_CHECK(co.multiplayer_ai_config->size() == 2);
@@ -310,6 +321,7 @@ BOOST_AUTO_TEST_CASE (test_full_options)
 	BOOST_CHECK(co.screenshot && co.screenshot_map_file && co.screenshot_output_file);
 	BOOST_CHECK(*co.screenshot_map_file == "mapfoo" && *co.screenshot_output_file == "outssfoo");
 	BOOST_CHECK(co.test && *co.test == "testfoo");
+	BOOST_CHECK(co.uncompressed_cache);
 	BOOST_CHECK(co.userconfig_dir && *co.userconfig_dir == "userconfigdirfoo");
 	BOOST_CHECK(co.userconfig_path);
 	BOOST_CHECK(co.userdata_dir && *co.userdata_dir == "userdatadirfoo");
@@ -342,6 +354,7 @@ BOOST_AUTO_TEST_CASE (test_positional_options)
 #endif
 	BOOST_CHECK(!co.editor);
 	BOOST_CHECK(!co.fps);
+	BOOST_CHECK(!co.frame_trace);
 	BOOST_CHECK(!co.fullscreen);
 	BOOST_CHECK(!co.gunzip);
 	BOOST_CHECK(!co.gzip);
@@ -349,6 +362,7 @@ BOOST_AUTO_TEST_CASE (test_positional_options)
 	BOOST_CHECK(!co.load);
 	BOOST_CHECK(!co.log);
 	BOOST_CHECK(!co.logdomains);
+	BOOST_CHECK(!co.lua_profile);
 	BOOST_CHECK(!co.multiplayer);
 	BOOST_CHECK(!co.multiplayer_ai_config);
 	BOOST_CHECK(!co.multiplayer_algorithm);
@@ -381,6 +395,7 @@ BOOST_AUTO_TEST_CASE (test_positional_options)
 	BOOST_CHECK(!co.screenshot_map_file);
 	BOOST_CHECK(!co.screenshot_output_file);
 	BOOST_CHECK(!co.test);
+	BOOST_CHECK(!co.uncompressed_cache);
 	BOOST_CHECK(!co.userconfig_dir);
 	BOOST_CHECK(!co.userconfig_path);
 	BOOST_CHECK(!co.userdata_dir);
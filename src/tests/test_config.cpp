@@ -62,6 +62,16 @@ BOOST_AUTO_TEST_CASE(test_config_attribute_value)
 	c2["x"] = "6.0";
 	BOOST_CHECK_NE(c1["x"], c2["x"]);
 
+// compare stored values against plain strings
+	c1["x"] = "6.0";
+	BOOST_CHECK(c1["x"] == "6.0");
+	BOOST_CHECK(c1["x"] != "6");
+	c1["x"] = 6;
+	BOOST_CHECK(c1["x"] == "6");
+	BOOST_CHECK(c1["x"] == std::string("6"));
+	c1["x"] = "yes";
+	BOOST_CHECK(c1["x"] == "true");
+
 // check what happens when trying to get a numeric result from a non-numeric value
 	c["x"] = "1aaaa";
 	x_str = c["x"].str();
@@ -192,6 +202,21 @@ BOOST_AUTO_TEST_CASE(test_config_attribute_value)
 	x_dbl = c["x"].to_double();
 	BOOST_CHECK_EQUAL(x_dbl, 1e20);
 
+// check that only canonical integer strings are stored as integers
+	c1["x"] = "-12";
+	c2["x"] = -12;
+	BOOST_CHECK_EQUAL(c1["x"], c2["x"]);
+	c["x"] = "-12";
+	BOOST_CHECK_EQUAL(c["x"].str(), "-12");
+	c["x"] = "+12";
+	BOOST_CHECK_EQUAL(c["x"].str(), "+12");
+	BOOST_CHECK_EQUAL(c["x"].to_int(), 12);
+	c["x"] = "12 ";
+	BOOST_CHECK_EQUAL(c["x"].str(), "12 ");
+	c["x"] = "text";
+	BOOST_CHECK_EQUAL(c["x"].to_int(42), 42);
+	BOOST_CHECK_EQUAL(c["x"].to_long_long(42), 42ll);
+
 // check type conversion when assigned as a floating point
 	c["x"] = 1.499;
 	x_sll = c["x"].to_long_long();
@@ -384,4 +409,65 @@ BOOST_DATA_TEST_CASE(add_child_NonEmptyThis_newOrExistingKey_lOrRValue_AppendAnd
 	BOOST_CHECK_NE(&new_child, &update);
 }
 
+BOOST_AUTO_TEST_CASE(copy_and_move_children_PreserveChildOrder)
+{
+	config base;
+	base.add_child("A")["n"] = 1;
+	base.add_child("B")["n"] = 2;
+	base.add_child("A")["n"] = 3;
+	base.add_child("C");
+	base.remove_child("C", 0);
+	base.add_child("B")["n"] = 4;
+
+	const auto order = [](const config& cfg) {
+		std::string res;
+		for(const config::any_child child : cfg.all_children_range()) {
+			res += child.key + child.cfg["n"].str();
+		}
+		return res;
+	};
+
+	const config copy(base);
+	BOOST_CHECK_EQUAL(copy, base);
+	BOOST_CHECK_EQUAL(order(copy), "A1B2A3B4");
+	BOOST_CHECK(!copy.has_child("C"));
+
+	config moved_into;
+	config source(base);
+	moved_into.append_children(std::move(source));
+	BOOST_CHECK_EQUAL(order(moved_into), "A1B2A3B4");
+	BOOST_CHECK_EQUAL(source.all_children_count(), 0);
+
+	source = base;
+	moved_into.append_children(std::move(source));
+	BOOST_CHECK_EQUAL(order(moved_into), "A1B2A3B4A1B2A3B4");
+	BOOST_CHECK_EQUAL(moved_into.child_count("A"), 4);
+	BOOST_CHECK_EQUAL(source.all_children_count(), 0);
+
+	source = base;
+	moved_into.append_children_by_move(source, "B");
+	BOOST_CHECK_EQUAL(order(moved_into), "A1B2A3B4A1B2A3B4B2B4");
+	BOOST_CHECK_EQUAL(order(source), "A1A3");
+}
+
+BOOST_AUTO_TEST_CASE(memory_usage_GrowsWithContent)
+{
+	config cfg;
+	const std::size_t empty = cfg.memory_usage();
+
+	cfg["short"] = 1;
+	const std::size_t with_attribute = cfg.memory_usage();
+	BOOST_CHECK_GT(with_attribute, empty);
+
+	cfg["long"] = std::string(1000, 'x');
+	const std::size_t with_long_string = cfg.memory_usage();
+	BOOST_CHECK_GE(with_long_string, with_attribute + 1000);
+
+	cfg.add_child("child")["long"] = std::string(1000, 'y');
+	BOOST_CHECK_GE(cfg.memory_usage(), with_long_string + 1000);
+
+	cfg.clear();
+	BOOST_CHECK_LT(cfg.memory_usage(), with_attribute);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -180,6 +180,15 @@ BOOST_AUTO_TEST_CASE( test_fs_binary_path )
 	BOOST_CHECK( get_binary_file_location("music", "this_track_does_not_exist.aiff").empty() );
 	BOOST_CHECK( get_binary_file_location("sounds", "rude_noises.aiff").empty() );
 	BOOST_CHECK( get_independent_binary_file_path("images", "dopefish.txt").empty() );
+
+	// Repeated lookups are answered from the location cache, with the same results.
+	BOOST_CHECK_EQUAL( get_binary_file_location("images", "wesnoth-icon.png"),
+	                   gamedata + "/data/core/images/wesnoth-icon.png" );
+	BOOST_CHECK( get_binary_file_location("images", "bunnies_and_ponies_and_rainbows_oh_em_gee.psd").empty() );
+
+	clear_binary_paths_cache();
+	BOOST_CHECK_EQUAL( get_binary_file_location("images", "wesnoth-icon.png"),
+	                   gamedata + "/data/core/images/wesnoth-icon.png" );
 }
 
 BOOST_AUTO_TEST_CASE( test_fs_wml_path )
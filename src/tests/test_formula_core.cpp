@@ -141,6 +141,17 @@ BOOST_AUTO_TEST_CASE(test_formula_strings)
 		"String with embedded string!");
 }
 
+BOOST_AUTO_TEST_CASE(test_formula_constant_folding)
+{
+	BOOST_CHECK_EQUAL(formula("(1 + 2) * strength").evaluate(c).as_int(), 45);
+	BOOST_CHECK_EQUAL(formula("-(2 * 3) + strength").evaluate(c).as_int(), 9);
+	BOOST_CHECK_EQUAL(formula("'ab' .. 'cd' .. '[agility]'").evaluate(c).as_string(), "abcd12");
+
+	// Errors in constant subexpressions are still reported on evaluation.
+	formula div_by_zero("strength + 1 / 0");
+	BOOST_CHECK_THROW(div_by_zero.evaluate(c), type_error);
+}
+
 BOOST_AUTO_TEST_CASE(test_formula_dice) {
 	const int dice_roll = formula("3d6").evaluate().as_int();
 	assert(dice_roll >= 3 && dice_roll <= 18);
@@ -200,4 +200,34 @@ BOOST_AUTO_TEST_CASE(test_formula_function_trig)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(test_formula_function_list_fast_paths)
+{
+	map_formula_callable variables;
+	variables.add("n", variant(3));
+
+	BOOST_CHECK_EQUAL(formula("size(filter([1,2,3,4,5], value > n))").evaluate(variables).as_int(), 2);
+	BOOST_CHECK_EQUAL(formula("size(filter([1,2,3], x, x > n))").evaluate(variables).as_int(), 0);
+	BOOST_CHECK_EQUAL(formula("size(filter(['a' -> 1, 'b' -> 5], value > n))").evaluate(variables).as_int(), 1);
+
+	BOOST_CHECK_EQUAL(formula("max(map([1,2,3], value * n))").evaluate(variables).as_int(), 9);
+	BOOST_CHECK_EQUAL(formula("min(map([4,2,3], x, x - n))").evaluate(variables).as_int(), -1);
+	BOOST_CHECK_EQUAL(formula("max(1, map([], value))").evaluate(variables).as_int(), 1);
+	BOOST_CHECK_THROW(formula("max(map([], value))").evaluate(variables), formula_error);
+
+	BOOST_CHECK_EQUAL(formula("filter([1,2,3], value > 0)").evaluate(variables).num_elements(), 3);
+	BOOST_CHECK(formula("filter([1,2,3,4], value % 2 = 0)").evaluate(variables) == formula("[2,4]").evaluate());
+	BOOST_CHECK_EQUAL(formula("find([1,2,3,4], value > n)").evaluate(variables).as_int(), 4);
+	BOOST_CHECK_EQUAL(formula("choose([1,5,2], -value)").evaluate(variables).as_int(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_formula_function_constant_calls)
+{
+	BOOST_CHECK_EQUAL(formula("distance_between(loc(1,1), loc(4,1))").evaluate().as_int(), 3);
+	BOOST_CHECK_EQUAL(formula("sqrt(16) + abs(-2)").evaluate().as_int(), 6);
+	BOOST_CHECK_EQUAL(formula("substring('hello world', 6)").evaluate().as_string(), "world");
+
+	// Calls that fail are left to fail on evaluation
+	BOOST_CHECK_THROW(formula("loc('a', 1)").evaluate(), type_error);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -16,6 +16,7 @@
 #define GETTEXT_DOMAIN "wesnoth-test"
 
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
 #include <sstream>
 
 #include "game_config.hpp"
@@ -27,6 +28,7 @@
 #include "image_modifications.hpp"
 #include "log.hpp"
 #include "filesystem.hpp"
+#include "sdl/surface.hpp"
 
 using namespace image;
 
@@ -882,4 +884,71 @@ BOOST_AUTO_TEST_CASE(test_bg_modification_decoding_4_args)
 	BOOST_CHECK_EQUAL(mod->get_color().a, 4);
 }
 
+/** Tests that locators constructed again from the same path are the same locator */
+BOOST_AUTO_TEST_CASE(test_locator_from_path)
+{
+	const std::string path = "units/elves-wood/shyde.png~TC(4,magenta)~FL()";
+
+	const locator first(path);
+	const locator second(path.c_str());
+
+	BOOST_CHECK(first == second);
+	BOOST_CHECK_EQUAL(second.get_type(), locator::SUB_FILE);
+	BOOST_CHECK_EQUAL(second.get_filename(), "units/elves-wood/shyde.png");
+	BOOST_CHECK_EQUAL(second.get_modifications(), "~TC(4,magenta)~FL()");
+
+	const locator split(std::string("units/elves-wood/shyde.png"), std::string("~TC(4,magenta)~FL()"));
+	BOOST_CHECK(first == split);
+
+	const locator plain("units/elves-wood/shyde.png");
+	BOOST_CHECK(first != plain);
+	BOOST_CHECK_EQUAL(plain.get_type(), locator::FILE);
+	BOOST_CHECK(plain.get_modifications().empty());
+}
+
+/** Tests that fused per-pixel modifications give the same result as applying them one by one */
+BOOST_AUTO_TEST_CASE(test_modification_queue_apply_top)
+{
+	environment_setup env_setup;
+
+	// Large enough to be processed in several blocks.
+	surface src(96, 80);
+	{
+		surface_lock lock(src);
+		uint32_t* pixels = lock.pixels();
+		for(int i = 0; i != src->w * src->h; ++i) {
+			pixels[i] = (static_cast<uint32_t>(i % 7 ? 0xFF : 0) << 24) | (i * 2654435761u & 0x00FFFFFF);
+		}
+	}
+
+	const std::string mods = "~GS()~CS(20,-10,5)~NEG()~BLIT(wesnoth-icon.png)";
+
+	surface expected = src;
+	for(modification_queue queue = modification::decode(mods); !queue.empty(); queue.pop()) {
+		expected = (*queue.top())(expected);
+	}
+
+	const surface before = src.clone();
+	surface fused = src;
+	modification_queue queue = modification::decode(mods);
+	BOOST_REQUIRE_EQUAL(queue.size(), 4);
+
+	// The three per-pixel modifications are applied together.
+	queue.apply_top(fused);
+	BOOST_CHECK_EQUAL(queue.size(), 1);
+	queue.apply_top(fused);
+	BOOST_CHECK(queue.empty());
+
+	BOOST_REQUIRE(fused != src);
+	const_surface_lock src_lock(src);
+	const_surface_lock before_lock(before);
+	const_surface_lock fused_lock(fused);
+	const_surface_lock expected_lock(expected);
+	const std::size_t size = src->w * src->h;
+	BOOST_CHECK(std::equal(fused_lock.pixels(), fused_lock.pixels() + size, expected_lock.pixels()));
+
+	// The shared source surface was copied, not changed.
+	BOOST_CHECK(std::equal(src_lock.pixels(), src_lock.pixels() + size, before_lock.pixels()));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
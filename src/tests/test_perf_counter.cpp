@@ -0,0 +1,66 @@
+/*
+	Copyright (C) 2022
+	Part of the Battle for Wesnoth Project https://www.wesnoth.org/
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY.
+
+	See the COPYING file for more details.
+*/
+
+#define GETTEXT_DOMAIN "wesnoth-test"
+
+#include "utils/perf_counter.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(perf_counter)
+
+static void timed_function()
+{
+	PERF_TIMER("test::timed_function");
+}
+
+static void counted_function()
+{
+	PERF_COUNT("test::counted_function");
+}
+
+BOOST_AUTO_TEST_CASE(test_perf_counter_totals)
+{
+	util::perf_counter::reset_all();
+
+	for(int i = 0; i < 3; ++i) {
+		timed_function();
+		counted_function();
+	}
+
+	auto totals = util::perf_counter::all_totals();
+	BOOST_CHECK_EQUAL(totals["test::timed_function"].calls, 3u);
+	BOOST_CHECK_EQUAL(totals["test::counted_function"].calls, 3u);
+	BOOST_CHECK_EQUAL(totals["test::counted_function"].time.count(), 0);
+
+	const std::string report = util::perf_counter::report();
+	BOOST_CHECK(report.find("test::timed_function: 3 calls") != std::string::npos);
+
+	util::perf_counter::reset_all();
+	BOOST_CHECK(util::perf_counter::all_totals().count("test::timed_function") == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_perf_counter_merges_names)
+{
+	util::perf_counter a("test::shared");
+	util::perf_counter b("test::shared");
+	a.add(std::chrono::milliseconds(2));
+	b.add(std::chrono::milliseconds(3));
+
+	const auto totals = util::perf_counter::all_totals();
+	BOOST_CHECK_EQUAL(totals.at("test::shared").calls, 2u);
+	BOOST_CHECK(totals.at("test::shared").time == std::chrono::milliseconds(5));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -76,6 +76,19 @@ BOOST_AUTO_TEST_CASE( test_1 ) {
 	BOOST_CHECK_MESSAGE(recall_man.find_if_matches_id("larry") == orc1, "found something unexpected");
 	BOOST_CHECK_MESSAGE(recall_man.find_if_matches_id("moe") == orc2, "found something unexpected");
 
+	// Units changed in place are still found after the lookups built the indexes.
+	orc1->set_id("curly");
+	BOOST_CHECK_MESSAGE(recall_man.find_if_matches_id("curly") == orc1, "found something unexpected");
+	BOOST_CHECK_MESSAGE(!recall_man.find_if_matches_id("larry"), "found something unexpected");
+	BOOST_CHECK_EQUAL(recall_man.find_index("curly"), 1);
+	BOOST_CHECK_EQUAL(recall_man.find_index("larry"), 2);
+
+	BOOST_CHECK_MESSAGE(recall_man.find_if_matches_underlying_id(orc2->underlying_id()) == orc2, "found something unexpected");
+	BOOST_CHECK_MESSAGE(recall_man.extract_if_matches_underlying_id(orc2->underlying_id()) == orc2, "extracted something unexpected");
+	BOOST_CHECK_EQUAL(recall_man.size(), 1);
+	BOOST_CHECK_MESSAGE(recall_man[0] == orc1, "unexpected result at index [0]");
+	BOOST_CHECK_MESSAGE(!recall_man.find_if_matches_underlying_id(orc2->underlying_id()), "found something unexpected");
+	BOOST_CHECK_MESSAGE(recall_man.find_if_matches_underlying_id(orc1->underlying_id()) == orc1, "found something unexpected");
 }
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -107,6 +107,34 @@ BOOST_AUTO_TEST_CASE( utils_split_test )
 	}
 }
 
+BOOST_AUTO_TEST_CASE( utils_split_view_test )
+{
+	const std::string test_string = "a,  ,  bb,  ccc  ||  d,  ee,,  fff  | |  g,  ,  hh,  iii";
+
+	{
+		auto split = utils::split_view(test_string);
+		auto expect = utils::split(test_string);
+		BOOST_CHECK_EQUAL_COLLECTIONS(split.begin(), split.end(), expect.begin(), expect.end());
+	}
+	{
+		auto split = utils::split_view(test_string, '|', 0);
+		auto expect = utils::split(test_string, '|', 0);
+		BOOST_CHECK_EQUAL_COLLECTIONS(split.begin(), split.end(), expect.begin(), expect.end());
+	}
+}
+
+BOOST_AUTO_TEST_CASE( utils_parse_range_test )
+{
+	BOOST_CHECK(utils::parse_range("3") == std::pair(3, 3));
+	BOOST_CHECK(utils::parse_range("2-5") == std::pair(2, 5));
+	BOOST_CHECK(utils::parse_range("5-2") == std::pair(5, 5));
+	BOOST_CHECK(utils::parse_range("1-infinity") == std::pair(1, std::numeric_limits<int>::max()));
+
+	const std::string ranges = "1-2,7";
+	const auto views = utils::split_view(ranges);
+	BOOST_CHECK(utils::parse_range(views.back()) == std::pair(7, 7));
+}
+
 BOOST_AUTO_TEST_CASE( utils_quoted_split_test )
 {
 	const std::string test_string = "a,  `,  bb,  ccc  ||  d,  ee,,  fff  | `|  g,  `,  hh,  iii";
@@ -536,6 +564,44 @@ BOOST_AUTO_TEST_CASE( utils_unicode_test )
 	BOOST_CHECK(nonbmp_u4 == unicode_cast<std::u32string>(nonbmp_u16));
 }
 
+BOOST_AUTO_TEST_CASE( utils_unicode_long_test )
+{
+	// Long enough for the word-at-a-time ASCII runs, mixed with multi-byte characters.
+	std::string text;
+	for(int i = 0; i < 20; ++i) {
+		text += "a long line of chat ";
+		text += "€ü";
+	}
+
+	BOOST_CHECK_EQUAL( utf8::size(text), 440u );
+	BOOST_CHECK_EQUAL( utf8::index(text, 0), 0u );
+	BOOST_CHECK_EQUAL( utf8::index(text, 20), 20u );
+	BOOST_CHECK_EQUAL( utf8::index(text, 21), 23u );
+	BOOST_CHECK_EQUAL( utf8::index(text, 22), 25u );
+	BOOST_CHECK_EQUAL( utf8::index(text, 440), text.size() );
+	BOOST_CHECK_EQUAL( utf8::index(text, 1000), text.size() );
+
+	std::string erased = text;
+	utf8::erase(erased, 19, 4);
+	BOOST_CHECK_EQUAL( erased.substr(0, 24), "a long line of chat long" );
+	BOOST_CHECK_EQUAL( utf8::size(erased), 436u );
+
+	std::string unchanged = text;
+	utf8::erase(unchanged, 441, 1);
+	BOOST_CHECK_EQUAL( unchanged, text );
+
+	std::string inserted = "ab";
+	utf8::insert(inserted, 1, "€");
+	BOOST_CHECK_EQUAL( inserted, "a€b" );
+
+	// A truncated sequence at the end does not point past the string.
+	const std::string truncated = "abc\xE2\x82";
+	BOOST_CHECK_EQUAL( utf8::size(truncated), 4u );
+	BOOST_CHECK_EQUAL( utf8::index(truncated, 4), truncated.size() );
+
+	BOOST_CHECK_EQUAL( utf8::lowercase("ünicod€ CHECK"), "ünicod€ check" );
+}
+
 BOOST_AUTO_TEST_CASE( test_lowercase )
 {
 	BOOST_CHECK_EQUAL ( utf8::lowercase("FOO") , "foo" );
@@ -45,5 +45,40 @@ d="\"""
 	BOOST_CHECK((*test_node)["e"] == "f");
 }
 
+BOOST_AUTO_TEST_CASE( simple_wml_parsed_nodes_test )
+{
+	std::string text;
+	for(int i = 0; i < 100; ++i) {
+		text += "[side]\nside=\"" + std::to_string(i) + "\"\n[unit]\n[/unit]\n[/side]\n";
+	}
+
+	simple_wml::document doc(text.c_str(), INIT_STATE::INIT_STATIC);
+	BOOST_CHECK_EQUAL(doc.root().children("side").size(), 100u);
+
+	// Removed nodes are destroyed in place, the rest of the tree stays intact.
+	doc.root().remove_child("side", 0);
+	doc.root().child("side")->remove_child("unit", 0);
+	doc.root().add_child("side").set_attr("side", "100");
+	BOOST_CHECK_EQUAL(doc.root().children("side").size(), 100u);
+	BOOST_CHECK((*doc.root().child("side"))["side"] == "1");
+	BOOST_CHECK(!doc.root().child("side")->child("unit"));
+
+	const std::string output = doc.output();
+
+	// Parsing again after compress() reuses the memory of the first tree.
+	doc.compress();
+	BOOST_CHECK_EQUAL(doc.root().children("side").size(), 100u);
+	BOOST_CHECK_EQUAL(doc.output(), output);
+
+	simple_wml::document other("[era]\nid=\"default\"\n[/era]\n", INIT_STATE::INIT_STATIC);
+	doc.swap(other);
+	BOOST_CHECK(doc.root().child("era"));
+	BOOST_CHECK_EQUAL(other.root().children("side").size(), 100u);
+	BOOST_CHECK_EQUAL(other.output(), output);
+
+	other.clear();
+	BOOST_CHECK(other.root().no_children());
+}
+
 /* vim: set ts=4 sw=4: */
 BOOST_AUTO_TEST_SUITE_END()
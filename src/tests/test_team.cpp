@@ -15,6 +15,8 @@
 
 #define GETTEXT_DOMAIN "wesnoth-test"
 
+#include "team.hpp"
+
 #include <boost/test/unit_test.hpp>
 
 
@@ -25,5 +27,36 @@ BOOST_AUTO_TEST_CASE( test_user_team_name )
 	BOOST_WARN_EQUAL(0,0);
 }
 
+BOOST_AUTO_TEST_CASE( test_shroud_union )
+{
+	shroud_map own, ally, merged;
+	own.set_enabled(true);
+	own.read("|000\n|000\n");
+	ally.set_enabled(true);
+	ally.read("|000\n|000\n|001\n");
+
+	const std::size_t changes = shroud_map::changes();
+	merged.assign_union({&own, &ally}, true);
+	BOOST_CHECK_EQUAL(shroud_map::changes(), changes);
+
+	own.clear(0, 1);
+	BOOST_CHECK(shroud_map::changes() != changes);
+	merged.assign_union({&own, &ally}, true);
+
+	BOOST_CHECK(!merged.value(0, 1));
+	BOOST_CHECK(!merged.value(2, 2));
+	BOOST_CHECK(merged.value(1, 1));
+	BOOST_CHECK(merged.value(5, 0));
+
+	// Allies that don't use the map don't uncover anything.
+	ally.set_enabled(false);
+	merged.assign_union({&own, &ally}, true);
+	BOOST_CHECK(merged.value(2, 2));
+
+	// Nothing is covered when we don't use the map ourselves.
+	merged.assign_union({&own, &ally}, false);
+	BOOST_CHECK(!merged.value(1, 1));
+}
+
 /* vim: set ts=4 sw=4: */
 BOOST_AUTO_TEST_SUITE_END()
@@ -270,5 +270,77 @@ BOOST_AUTO_TEST_CASE( track_fake_unit_by_iterator ) {
 	BOOST_CHECK(unit_iterator == unit_iterator2);
 }
 
+BOOST_AUTO_TEST_CASE( generation_changes_with_units ) {
+	config orc_config;
+	orc_config["id"]="Orcish Grunt";
+	orc_config["random_traits"]=false;
+	orc_config["animate"]=false;
+	unit_type orc_type(orc_config);
+
+	unit_types.build_unit_type(orc_type, unit_type::FULL);
+
+	unit_ptr orc = unit::create(orc_type, 0, false);
+
+	unit_map unit_map, other_map;
+	BOOST_CHECK(unit_map.generation() != other_map.generation());
+
+	std::size_t generation = unit_map.generation();
+	unit_map.add(map_location(1,1), *orc);
+	BOOST_CHECK(unit_map.generation() != generation);
+
+	generation = unit_map.generation();
+	unit_map.find(map_location(1,1));
+	BOOST_CHECK_EQUAL(unit_map.generation(), generation);
+
+	unit_map.move(map_location(1,1), map_location(2,2));
+	BOOST_CHECK(unit_map.generation() != generation);
+
+	generation = unit_map.generation();
+	const std::size_t other_generation = other_map.generation();
+	unit_map.swap(other_map);
+	BOOST_CHECK(unit_map.generation() != generation && unit_map.generation() != other_generation);
+	BOOST_CHECK(other_map.generation() != generation && other_map.generation() != other_generation);
+
+	generation = other_map.generation();
+	other_map.erase(map_location(2,2));
+	BOOST_CHECK(other_map.generation() != generation);
+}
+
+BOOST_AUTO_TEST_CASE( locations_beyond_the_grid ) {
+	config orc_config;
+	orc_config["id"]="Orcish Grunt";
+	orc_config["random_traits"]=false;
+	orc_config["animate"]=false;
+	unit_type orc_type(orc_config);
+
+	unit_types.build_unit_type(orc_type, unit_type::FULL);
+
+	unit_ptr orc = unit::create(orc_type, 0, false);
+
+	unit_map unit_map;
+	BOOST_CHECK(unit_map.find(map_location(0,0)) == unit_map.end());
+	BOOST_CHECK(unit_map.find(map_location(-1,0)) == unit_map.end());
+
+	BOOST_CHECK(unit_map.add(map_location(1,1), *orc).second);
+	BOOST_CHECK(unit_map.add(map_location(40,3), *orc).second);
+	BOOST_CHECK(unit_map.add(map_location(2,50), *orc).second);
+	BOOST_CHECK_EQUAL(unit_map.size(), 3);
+	BOOST_CHECK(unit_map.find(map_location(1,1)) != unit_map.end());
+	BOOST_CHECK(unit_map.find(map_location(40,3)) != unit_map.end());
+	BOOST_CHECK(unit_map.find(map_location(2,50)) != unit_map.end());
+	BOOST_CHECK(unit_map.find(map_location(41,51)) == unit_map.end());
+
+	BOOST_CHECK(unit_map.move(map_location(1,1), map_location(100,100)).second);
+	BOOST_CHECK(unit_map.find(map_location(1,1)) == unit_map.end());
+	BOOST_CHECK_EQUAL(unit_map.count(map_location(100,100)), 1);
+	BOOST_CHECK(!unit_map.move(map_location(100,100), map_location(40,3)).second);
+	BOOST_CHECK(!unit_map.move(map_location(100,100), map_location(-1,3)).second);
+	BOOST_CHECK_EQUAL(unit_map.find(map_location(100,100))->get_location(), map_location(100,100));
+
+	BOOST_CHECK_EQUAL(unit_map.erase(map_location(40,3)), 1);
+	BOOST_CHECK_EQUAL(unit_map.size(), 2);
+	BOOST_CHECK(unit_map.self_check());
+}
+
 /* vim: set ts=4 sw=4: */
 BOOST_AUTO_TEST_SUITE_END()
@@ -16,6 +16,9 @@
 
 #include "log.hpp"
 
+#include <map>
+#include <mutex>
+
 #ifdef _WIN32
 #include <wincrypt.h>
 #elif defined(__APPLE__)
@@ -104,4 +107,62 @@ void load_tls_root_certs(boost::asio::ssl::context &ctx)
 #endif
 }
 
+namespace
+{
+/** The last session of each server, keyed by host and port. Shared by the network threads. */
+std::map<std::string, SSL_SESSION*> tls_sessions;
+std::mutex tls_sessions_mutex;
+
+void free_session_key(void*, void* key, CRYPTO_EX_DATA*, int, long, void*)
+{
+	delete static_cast<std::string*>(key);
+}
+
+/** Where the key of a connection is attached to its SSL object. */
+int session_key_index()
+{
+	static const int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, &free_session_key);
+	return index;
+}
+
+/**
+ * Called by OpenSSL when the server hands out a session, which with TLS 1.3
+ * happens after the handshake.
+ * @return 1 to take over the reference to @a session.
+ */
+int store_session(SSL* ssl, SSL_SESSION* session)
+{
+	const auto* key = static_cast<const std::string*>(SSL_get_ex_data(ssl, session_key_index()));
+	if(!key) {
+		return 0;
+	}
+
+	std::lock_guard lock(tls_sessions_mutex);
+	SSL_SESSION*& stored = tls_sessions[*key];
+	if(stored) {
+		SSL_SESSION_free(stored);
+	}
+
+	stored = session;
+	return 1;
+}
+
+} // end anon namespace
+
+void use_tls_session_cache(boost::asio::ssl::context& ctx, SSL* ssl, const std::string& host, const std::string& service)
+{
+	SSL_CTX_set_session_cache_mode(ctx.native_handle(), SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+	SSL_CTX_sess_set_new_cb(ctx.native_handle(), &store_session);
+
+	const std::string key = host + ":" + service;
+	SSL_set_ex_data(ssl, session_key_index(), new std::string(key));
+
+	std::lock_guard lock(tls_sessions_mutex);
+	const auto iter = tls_sessions.find(key);
+	if(iter != tls_sessions.end()) {
+		DBG_NW << "Offering the previous TLS session to " << key;
+		SSL_set_session(ssl, iter->second);
+	}
+}
+
 }
@@ -16,9 +16,23 @@
 
 #include <boost/asio/ssl/context.hpp>
 
+#include <string>
+
 namespace network_asio
 {
 
 void load_tls_root_certs(boost::asio::ssl::context &ctx);
 
+/**
+ * Offers the server the TLS session of the last connection to the same address,
+ * and remembers the session of this one for the next, so that reconnecting can
+ * skip the full handshake.
+ *
+ * Call before the handshake of @a ssl, which must have been created from @a ctx.
+ *
+ * @param host The server's host name.
+ * @param service The server's port.
+ */
+void use_tls_session_cache(boost::asio::ssl::context& ctx, SSL* ssl, const std::string& host, const std::string& service);
+
 }
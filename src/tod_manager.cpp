@@ -222,63 +222,81 @@ const time_of_day tod_manager::get_illuminated_time_of_day(
 	time_of_day tod = get_time_of_day(loc, for_turn);
 
 	if(map.on_board_with_border(loc)) {
-		// Now add terrain illumination.
-		const int terrain_light = map.get_terrain_info(loc).light_bonus(tod.lawful_bonus);
-
-		std::vector<int> mod_list;
-		std::vector<int> max_list;
-		std::vector<int> min_list;
-		int most_add = 0;
-		int most_sub = 0;
-
-		// Find the "illuminates" effects from units that can affect loc.
-		std::array<map_location, 7> locs;
-		locs[0] = loc;
-		get_adjacent_tiles(loc, locs.data() + 1); // start at [1]
-
-		for(std::size_t i = 0; i < locs.size(); ++i) {
-			const auto itor = units.find(locs[i]);
-			if(itor != units.end() && !itor->incapacitated()) {
-				unit_ability_list illum = itor->get_abilities("illuminates");
-				if(!illum.empty()) {
-					unit_abilities::effect illum_effect(illum, terrain_light);
-					const int unit_mod = illum_effect.get_composite_value();
-
-					// Record this value.
-					mod_list.push_back(unit_mod);
-					max_list.push_back(illum.highest("max_value").first);
-					min_list.push_back(illum.lowest("min_value").first);
-
-					if(unit_mod > most_add) {
-						most_add = unit_mod;
-					} else if(unit_mod < most_sub) {
-						most_sub = unit_mod;
-					}
+		const int best_result = get_illuminated_lawful_bonus(units, map, loc, for_turn);
+
+		// Update the object we will return.
+		tod.bonus_modified = best_result - tod.lawful_bonus;
+		tod.lawful_bonus = best_result;
+	}
+
+	return tod;
+}
+
+int tod_manager::get_illuminated_lawful_bonus(
+	const unit_map& units, const gamemap& map, const map_location& loc, int for_turn) const
+{
+	// get ToD ignoring illumination
+	const int lawful_bonus = get_time_of_day(loc, for_turn).lawful_bonus;
+
+	if(!map.on_board_with_border(loc)) {
+		return lawful_bonus;
+	}
+
+	// Now add terrain illumination.
+	const int terrain_light = map.get_terrain_info(loc).light_bonus(lawful_bonus);
+
+	// At most one entry for loc and each of its neighbours.
+	std::array<int, 7> mod_list;
+	std::array<int, 7> max_list;
+	std::array<int, 7> min_list;
+	std::size_t num_mods = 0;
+	int most_add = 0;
+	int most_sub = 0;
+
+	// Find the "illuminates" effects from units that can affect loc.
+	std::array<map_location, 7> locs;
+	locs[0] = loc;
+	get_adjacent_tiles(loc, locs.data() + 1); // start at [1]
+
+	for(std::size_t i = 0; i < locs.size(); ++i) {
+		const auto itor = units.find(locs[i]);
+		if(itor != units.end() && !itor->incapacitated()) {
+			unit_ability_list illum = itor->get_abilities("illuminates");
+			if(!illum.empty()) {
+				unit_abilities::effect illum_effect(illum, terrain_light);
+				const int unit_mod = illum_effect.get_composite_value();
+
+				// Record this value.
+				mod_list[num_mods] = unit_mod;
+				max_list[num_mods] = illum.highest("max_value").first;
+				min_list[num_mods] = illum.lowest("min_value").first;
+				++num_mods;
+
+				if(unit_mod > most_add) {
+					most_add = unit_mod;
+				} else if(unit_mod < most_sub) {
+					most_sub = unit_mod;
 				}
 			}
 		}
-		const bool net_darker = most_add < -most_sub;
+	}
+	const bool net_darker = most_add < -most_sub;
 
-		// Apply each unit's effect, tracking the best result.
-		int best_result = terrain_light;
-		const int base_light = terrain_light + (net_darker ? most_add : most_sub);
+	// Apply each unit's effect, tracking the best result.
+	int best_result = terrain_light;
+	const int base_light = terrain_light + (net_darker ? most_add : most_sub);
 
-		for(std::size_t i = 0; i != mod_list.size(); ++i) {
-			int result = bounded_add(base_light, mod_list[i], max_list[i], min_list[i]);
+	for(std::size_t i = 0; i != num_mods; ++i) {
+		int result = bounded_add(base_light, mod_list[i], max_list[i], min_list[i]);
 
-			if(net_darker && result < best_result) {
-				best_result = result;
-			} else if(!net_darker && result > best_result) {
-				best_result = result;
-			}
+		if(net_darker && result < best_result) {
+			best_result = result;
+		} else if(!net_darker && result > best_result) {
+			best_result = result;
 		}
-
-		// Update the object we will return.
-		tod.bonus_modified = best_result - tod.lawful_bonus;
-		tod.lawful_bonus = best_result;
 	}
 
-	return tod;
+	return best_result;
 }
 
 bool tod_manager::is_start_ToD(const std::string& random_start_time)
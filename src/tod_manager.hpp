@@ -79,6 +79,13 @@ class tod_manager
 		const time_of_day get_illuminated_time_of_day(const unit_map & units, const gamemap & map, const map_location& loc,
 				int for_turn = 0) const;
 
+		/**
+		 * Returns the lawful_bonus of get_illuminated_time_of_day(), without
+		 * copying the time of day. This is what combat calculations need.
+		 */
+		int get_illuminated_lawful_bonus(const unit_map & units, const gamemap & map, const map_location& loc,
+				int for_turn = 0) const;
+
 		const time_of_day& get_previous_time_of_day() const;
 
 		static bool is_start_ToD(const std::string&);
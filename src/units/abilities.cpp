@@ -42,6 +42,7 @@
 
 #include <boost/dynamic_bitset.hpp>
 
+#include <map>
 #include <string_view>
 
 static lg::log_domain log_engine("engine");
@@ -159,6 +160,9 @@ bool unit::get_ability_bool(const std::string& tag_name, const map_location& loc
 
 	assert(display::get_singleton());
 	const unit_map& units = display::get_singleton()->get_units();
+	if(!units.has_adjacent_ability(tag_name, loc)) {
+		return false;
+	}
 
 	const auto adjacent = get_adjacent_tiles(loc);
 	for(unsigned i = 0; i < adjacent.size(); ++i) {
@@ -200,6 +204,9 @@ unit_ability_list unit::get_abilities(const std::string& tag_name, const map_loc
 
 	assert(display::get_singleton());
 	const unit_map& units = display::get_singleton()->get_units();
+	if(!units.has_adjacent_ability(tag_name, loc)) {
+		return res;
+	}
 
 	const auto adjacent = get_adjacent_tiles(loc);
 	for(unsigned i = 0; i < adjacent.size(); ++i) {
@@ -1017,6 +1024,7 @@ attack_type::specials_context_t::specials_context_t(
 	weapon.is_attacker_ = attacking;
 	weapon.other_attack_ = other_attack;
 	weapon.is_for_listing_ = false;
+	weapon.specials_cache_.reset();
 }
 
 /**
@@ -1037,6 +1045,7 @@ attack_type::specials_context_t::specials_context_t(const attack_type& weapon, u
 	weapon.is_attacker_ = attacking;
 	weapon.other_attack_ = nullptr;
 	weapon.is_for_listing_ = false;
+	weapon.specials_cache_.reset();
 }
 
 /**
@@ -1058,6 +1067,7 @@ attack_type::specials_context_t::specials_context_t(const attack_type& weapon, c
 	weapon.is_attacker_ = attacking;
 	weapon.other_attack_ = nullptr;
 	weapon.is_for_listing_ = false;
+	weapon.specials_cache_.reset();
 }
 
 attack_type::specials_context_t::specials_context_t(const attack_type& weapon, bool attacking)
@@ -1065,6 +1075,7 @@ attack_type::specials_context_t::specials_context_t(const attack_type& weapon, b
 {
 	weapon.is_for_listing_ = true;
 	weapon.is_attacker_ = attacking;
+	weapon.specials_cache_.reset();
 }
 
 attack_type::specials_context_t::~specials_context_t()
@@ -1077,6 +1088,7 @@ attack_type::specials_context_t::~specials_context_t()
 	parent->is_attacker_ = false;
 	parent->other_attack_ = nullptr;
 	parent->is_for_listing_ = false;
+	parent->specials_cache_.reset();
 }
 
 attack_type::specials_context_t::specials_context_t(attack_type::specials_context_t&& other)
@@ -1085,6 +1097,18 @@ attack_type::specials_context_t::specials_context_t(attack_type::specials_contex
 	other.was_moved = true;
 }
 
+struct attack_type::specials_cache
+{
+	std::map<std::string, unit_ability_list> lists;
+};
+
+void attack_type::specials_context_t::cache_specials_and_abilities()
+{
+	if(!parent->specials_cache_) {
+		parent->specials_cache_ = std::make_shared<specials_cache>();
+	}
+}
+
 /**
  * Calculates the number of attacks this weapon has, considering specials.
  * This returns two numbers because of the swarm special. The actual number of
@@ -1259,6 +1283,20 @@ unit_ability_list attack_type::get_weapon_ability(const std::string& ability) co
 }
 
 unit_ability_list attack_type::get_specials_and_abilities(const std::string& special) const
+{
+	if(!specials_cache_) {
+		return get_specials_and_abilities_impl(special);
+	}
+
+	auto i = specials_cache_->lists.find(special);
+	if(i == specials_cache_->lists.end()) {
+		i = specials_cache_->lists.emplace(special, get_specials_and_abilities_impl(special)).first;
+	}
+
+	return i->second;
+}
+
+unit_ability_list attack_type::get_specials_and_abilities_impl(const std::string& special) const
 {
 	unit_ability_list abil_list = get_weapon_ability(special);
 	if(!abil_list.empty()){
@@ -1148,6 +1148,16 @@ bool unit_animation::invalidate(frame_parameters& value)
 	}
 }
 
+bool unit_animation::may_propagate() const
+{
+	if(invalidated_) {
+		return false;
+	}
+
+	const display* disp = display::get_singleton();
+	return disp->tile_nearly_on_screen(src_) || disp->tile_nearly_on_screen(dst_);
+}
+
 std::string unit_animation::debug() const
 {
 	std::ostringstream outstream;
@@ -1292,6 +1302,13 @@ void unit_animation::particle::start_animation(int start_time)
 	parameters_.override(get_animation_duration());
 	animated<unit_frame>::start_animation(start_time,cycles_);
 	last_frame_begin_time_ = get_begin_time() -1;
+
+	// Let the images of the later frames decode in the background.
+	for(std::size_t n = 0; n < get_frames_count(); ++n) {
+		const frame_parameters frame = get_frame(n).parameters(0);
+		image::prefetch(frame.image);
+		image::prefetch(frame.image_diagonal);
+	}
 }
 
 void unit_animator::add_animation(unit_const_ptr animated_unit
@@ -101,6 +101,20 @@ public:
 	void redraw(frame_parameters& value, halo::manager& halo_man);
 	void clear_haloes();
 	bool invalidate(frame_parameters& value );
+
+	/** Whether invalidate() has already invalidated this animation's hexes since it was last drawn. */
+	bool invalidated() const
+	{
+		return invalidated_;
+	}
+
+	/**
+	 * Whether a later invalidate() call this frame could still return true because
+	 * other animations invalidated hexes this one overlaps. Only on-screen
+	 * animations propagate invalidation.
+	 */
+	bool may_propagate() const;
+
 	std::string debug() const;
 	friend std::ostream& operator << (std::ostream& outstream, const unit_animation& u_animation);
 
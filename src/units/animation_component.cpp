@@ -155,8 +155,10 @@ bool unit_animation_component::invalidate (const display & disp)
 {
 	bool result = false;
 
-	// Very early calls, anim not initialized yet
-	if(get_animation()) {
+	// Very early calls, anim not initialized yet.
+	// Animations already invalidated this frame have nothing left to do,
+	// so don't bother building their parameters.
+	if(get_animation() && !get_animation()->invalidated()) {
 		frame_parameters params;
 		const gamemap & map = disp.get_map();
 		const t_translation::terrain_code terrain = map.get_terrain(u_.loc_);
@@ -187,6 +189,7 @@ void unit_animation_component::reset_after_advance(const unit_type * newtype)
 
 	refreshing_ = false;
 	anim_.reset();
+	bar_layout_.reset();
 }
 
 void unit_animation_component::apply_new_animation_effect(const config & effect) {
@@ -20,6 +20,8 @@
 #include "halo.hpp"
 #include "units/animation.hpp" //Note: only needed for enum
 
+#include <optional>
+
 class config;
 class unit;
 class unit_drawer;
@@ -44,7 +46,8 @@ public:
 		frame_begin_time_(0),
 		draw_bars_(false),
 		refreshing_(false),
-		unit_halo_() {}
+		unit_halo_(),
+		bar_layout_() {}
 
 	/** Copy construct a unit animation component, for use when copy constructing a unit. */
 	unit_animation_component(unit & my_unit, const unit_animation_component & o) :
@@ -56,7 +59,8 @@ public:
 		frame_begin_time_(o.frame_begin_time_),
 		draw_bars_(o.draw_bars_),
 		refreshing_(o.refreshing_),
-		unit_halo_() {}
+		unit_halo_(),
+		bar_layout_() {}
 
 	/** Chooses an appropriate animation from the list of known animations. */
 	const unit_animation* choose_animation(
@@ -90,6 +94,12 @@ public:
 	/** Invalidates an animation with respect to a display object, preparing it for redraw. */
 	bool invalidate(const display & disp);
 
+	/** Whether invalidate() needs calling again after other animations invalidated hexes, see unit_animation::may_propagate. */
+	bool may_propagate() const
+	{
+		return get_animation() && get_animation()->may_propagate();
+	}
+
 	/** Intermittently activates the idling animations in place of the standing animations. Used by display object. */
 	void refresh();
 
@@ -134,4 +144,31 @@ private:
 
 	/** handle to the halo of this unit */
 	halo::handle unit_halo_;
+
+	/**
+	 * What unit_drawer worked out for the unit's bars and overlays, along with
+	 * the values it was worked out from. Reused until one of those changes.
+	 */
+	struct bar_layout
+	{
+		const unit_type* type = nullptr;
+		int hitpoints = 0;
+		int max_hitpoints = 0;
+		int experience = 0;
+		int max_experience = 0;
+		std::size_t advancements = 0;
+		int hex_size = 0;
+		std::vector<std::string> overlays;
+
+		/** Bar colors, before their alpha is set for the frame. */
+		color_t hp_color;
+		color_t xp_color;
+		/** Offset of the bars from the hex. */
+		int xoff = 0;
+		int yoff = 0;
+		std::vector<image::locator> overlay_images;
+	};
+
+	/** Kept by unit_drawer, see bar_layout. */
+	std::optional<bar_layout> bar_layout_;
 };
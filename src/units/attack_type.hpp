@@ -257,6 +257,12 @@ private:
 	mutable bool is_attacker_;
 	mutable const_attack_ptr other_attack_;
 	mutable bool is_for_listing_ = false;
+
+	/** Cached get_specials_and_abilities results, see specials_context_t::cache_specials_and_abilities. */
+	struct specials_cache;
+	mutable std::shared_ptr<specials_cache> specials_cache_;
+
+	unit_ability_list get_specials_and_abilities_impl(const std::string& special) const;
 public:
 	class specials_context_t {
 		std::shared_ptr<const attack_type> parent;
@@ -278,6 +284,13 @@ public:
 		// Destructor at least needs to be public for all this to work.
 		~specials_context_t();
 		specials_context_t(specials_context_t&&);
+
+		/**
+		 * Remembers the results of get_specials_and_abilities until the context
+		 * ends. Only for short lived contexts during which neither the units nor
+		 * the board change, such as the computation of the battle stats.
+		 */
+		void cache_specials_and_abilities();
 	};
 	// Set up a specials context.
 	// Usage: auto ctx = weapon.specials_context(...);
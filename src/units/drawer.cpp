@@ -35,6 +35,11 @@
 #include "units/types.hpp"
 #include "units/unit.hpp"
 
+#include <map>
+#include <optional>
+#include <tuple>
+#include <utility>
+
 static lg::log_domain log_display("display");
 #define LOG_DP LOG_STREAM(info, log_display)
 
@@ -43,15 +48,27 @@ namespace
 /**
  * Wrapper which will assemble the image path (including IPF for the color from get_orb_color) for a given orb.
  * Returns nullptr if the preferences have been configured to hide this orb.
+ *
+ * The locators are kept by color, since orbs are drawn for every unit on every frame.
  */
-std::unique_ptr<image::locator> get_orb_image(orb_status os)
+const image::locator* get_orb_image(orb_status os)
 {
+	using orb_key = std::tuple<bool, std::string, std::string>;
+	static std::map<orb_key, image::locator> orb_images;
+
 	if(os == orb_status::disengaged) {
 		if(orb_status_helper::prefs_show_orb(os)) {
 			auto partial_color = orb_status_helper::get_orb_color(orb_status::partial);
 			auto moved_color = orb_status_helper::get_orb_color(orb_status::moved);
-			return std::make_unique<image::locator>(game_config::images::orb_two_color + "~RC(ellipse_red>"
-				+ moved_color + ")~RC(magenta>" + partial_color + ")");
+
+			orb_key key{true, moved_color, partial_color};
+			auto it = orb_images.find(key);
+			if(it == orb_images.end()) {
+				it = orb_images.emplace(std::move(key), image::locator(game_config::images::orb_two_color + "~RC(ellipse_red>"
+					+ moved_color + ")~RC(magenta>" + partial_color + ")")).first;
+			}
+
+			return &it->second;
 		}
 		os = orb_status::partial;
 	}
@@ -59,7 +76,39 @@ std::unique_ptr<image::locator> get_orb_image(orb_status os)
 	if(!orb_status_helper::prefs_show_orb(os))
 		return nullptr;
 	auto color = orb_status_helper::get_orb_color(os);
-	return std::make_unique<image::locator>(game_config::images::orb + "~RC(magenta>" + color + ")");
+
+	orb_key key{false, color, ""};
+	auto it = orb_images.find(key);
+	if(it == orb_images.end()) {
+		it = orb_images.emplace(std::move(key), image::locator(game_config::images::orb + "~RC(magenta>" + color + ")")).first;
+	}
+
+	return &it->second;
+}
+
+/**
+ * Returns the recolored back and front parts of a unit's ellipse.
+ *
+ * These are kept for every combination seen, so the paths aren't assembled
+ * again for every unit on every frame.
+ */
+const std::pair<image::locator, image::locator>& get_ellipse_images(
+	const std::string& ellipse, bool leader, bool nozoc, bool selected, const std::string& tc)
+{
+	using ellipse_key = std::tuple<std::string, bool, bool, bool, std::string>;
+	static std::map<ellipse_key, std::pair<image::locator, image::locator>> ellipse_images;
+
+	ellipse_key key{ellipse, leader, nozoc, selected, tc};
+	auto it = ellipse_images.find(key);
+	if(it != ellipse_images.end()) {
+		return it->second;
+	}
+
+	const std::string prefix = formatter() << ellipse << "-" << (leader ? "leader-" : "") << (nozoc ? "nozoc-" : "") << (selected ? "selected-" : "");
+	const std::string ellipse_top = prefix + "top.png~RC(ellipse_red>" + tc + ")";
+	const std::string ellipse_bot = prefix + "bottom.png~RC(ellipse_red>" + tc + ")";
+
+	return ellipse_images.emplace(std::move(key), std::pair(image::locator(ellipse_top), image::locator(ellipse_bot))).first->second;
 }
 
 void draw_bar(int xpos, int ypos, int bar_height, double filled, const color_t& col)
@@ -154,18 +203,11 @@ void unit_drawer::redraw_unit(const unit& u) const
 
 	bool emit_zoc = u.emits_zoc();
 
-	color_t hp_color=u.hp_color();
-	color_t xp_color=u.xp_color();
-
 	std::string ellipse=u.image_ellipse();
 
 	const bool is_highlighted_enemy = units_that_can_reach_goal.count(loc) > 0;
 	const bool is_selected_hex = (loc == sel_hex || is_highlighted_enemy);
 
-	// Override the filled area's color's alpha.
-	hp_color.a = (loc == mouse_hex || is_selected_hex) ? 255u : float_to_color(0.8);
-	xp_color.a = hp_color.a;
-
 	if(hidden || is_blindfolded || !u.is_visible_to_team(viewing_team_ref, show_everything)) {
 		ac.clear_haloes();
 		if(ac.anim_) {
@@ -270,17 +312,12 @@ void unit_drawer::redraw_unit(const unit& u) const
 
 		if(ellipse != "none") {
 			// check if the unit has a ZoC or can recruit
-			const std::string nozoc    = !emit_zoc      ? "nozoc-"    : "";
-			const std::string leader   = can_recruit    ? "leader-"   : "";
-			const std::string selected = is_selected_hex? "selected-" : "";
-			const std::string tc       = team::get_side_color_id(side);
-
-			const std::string ellipse_top = formatter() << ellipse << "-" << leader << nozoc << selected << "top.png~RC(ellipse_red>" << tc << ")";
-			const std::string ellipse_bot = formatter() << ellipse << "-" << leader << nozoc << selected << "bottom.png~RC(ellipse_red>" << tc << ")";
+			const auto& [ellipse_top, ellipse_bot] = get_ellipse_images(
+				ellipse, can_recruit, !emit_zoc, is_selected_hex, team::get_side_color_id(side));
 
 			// Load the ellipse parts recolored to match team color
-			ellipse_back = image::get_texture(image::locator(ellipse_top));
-			ellipse_front = image::get_texture(image::locator(ellipse_bot));
+			ellipse_back = image::get_texture(ellipse_top);
+			ellipse_front = image::get_texture(ellipse_bot);
 		}
 	}
 
@@ -298,25 +335,61 @@ void unit_drawer::redraw_unit(const unit& u) const
 	});
 
 	if(draw_bars) {
-		const auto& type_cfg = u.type().get_cfg();
-		const auto& cfg_offset_x = type_cfg["bar_offset_x"];
-		const auto& cfg_offset_y = type_cfg["bar_offset_y"];
-		int xoff;
-		int yoff;
-		if(cfg_offset_x.empty() && cfg_offset_y.empty()) {
-			const point s = display::scaled_to_zoom(
-				image::get_size(u.default_anim_image())
-			);
-			xoff = !s.x ? 0 : (hex_size - s.x)/2;
-			yoff = !s.y ? 0 : (hex_size - s.x)/2;
-		}
-		else {
-			xoff = cfg_offset_x.to_int();
-			yoff = cfg_offset_y.to_int();
+		// The bar colors, offsets and overlay images are kept with the unit,
+		// and only worked out again when something they depend on changes.
+		std::optional<unit_animation_component::bar_layout>& layout = ac.bar_layout_;
+		const std::size_t advancements = u.modification_advancements().size();
+
+		if(!layout || layout->type != &u.type() || layout->hitpoints != hitpoints
+			|| layout->max_hitpoints != max_hitpoints || layout->experience != experience
+			|| layout->max_experience != max_experience || layout->advancements != advancements
+			|| layout->hex_size != hex_size || layout->overlays != u.overlays())
+		{
+			unit_animation_component::bar_layout& l = layout.emplace();
+			l.type = &u.type();
+			l.hitpoints = hitpoints;
+			l.max_hitpoints = max_hitpoints;
+			l.experience = experience;
+			l.max_experience = max_experience;
+			l.advancements = advancements;
+			l.hex_size = hex_size;
+			l.overlays = u.overlays();
+
+			l.hp_color = u.hp_color();
+			l.xp_color = u.xp_color();
+
+			const auto& type_cfg = u.type().get_cfg();
+			const auto& cfg_offset_x = type_cfg["bar_offset_x"];
+			const auto& cfg_offset_y = type_cfg["bar_offset_y"];
+			if(cfg_offset_x.empty() && cfg_offset_y.empty()) {
+				const point s = display::scaled_to_zoom(
+					image::get_size(u.default_anim_image())
+				);
+				l.xoff = !s.x ? 0 : (hex_size - s.x)/2;
+				l.yoff = !s.y ? 0 : (hex_size - s.x)/2;
+			}
+			else {
+				l.xoff = cfg_offset_x.to_int();
+				l.yoff = cfg_offset_y.to_int();
+			}
+
+			for(const std::string& ov : l.overlays) {
+				l.overlay_images.emplace_back(ov);
+			}
 		}
 
+		const int xoff = layout->xoff;
+		const int yoff = layout->yoff;
+
+		color_t hp_color = layout->hp_color;
+		color_t xp_color = layout->xp_color;
+
+		// Override the filled area's color's alpha.
+		hp_color.a = (loc == mouse_hex || is_selected_hex) ? 255u : float_to_color(0.8);
+		xp_color.a = hp_color.a;
+
 		using namespace orb_status_helper;
-		std::unique_ptr<image::locator> orb_img = nullptr;
+		const image::locator* orb_img = nullptr;
 
 		if(viewing_team_ref.is_enemy(side)) {
 			if(!u.incapacitated())
@@ -344,12 +417,13 @@ void unit_drawer::redraw_unit(const unit& u) const
 		}
 
 		if(can_recruit) {
-			if(texture tex = image::get_texture(u.leader_crown())) {
+			static const image::locator leader_crown(u.leader_crown());
+			if(texture tex = image::get_texture(leader_crown)) {
 				textures.push_back(std::move(tex));
 			}
 		}
 
-		for(const std::string& ov : u.overlays()) {
+		for(const image::locator& ov : layout->overlay_images) {
 			if(texture tex = image::get_texture(ov)) {
 				textures.push_back(std::move(tex));
 			}
@@ -38,6 +38,8 @@
 #include "formula/string_utils.hpp"
 #include "resources.hpp"
 
+#include <algorithm>
+
 static lg::log_domain log_config("config");
 #define ERR_CF LOG_STREAM(err, log_config)
 #define WRN_CF LOG_STREAM(warn, log_config)
@@ -69,8 +71,20 @@ std::vector<const unit *> unit_filter::all_matches_on_map(const map_location* lo
 {
 	std::vector<const unit *> ret;
 	int max_matches = max_matches_;
+	const unit_map& units = fc_->get_disp_context().units();
+
+	// A filter for a single location can only match the unit there,
+	// unless it's being matched as if all units were somewhere else.
+	if(const std::optional<map_location> only_loc = impl_.only_location(); only_loc && !loc) {
+		const unit_map::const_iterator u = units.find(*only_loc);
+		if(u != units.end() && max_matches != 0 && impl_.matches(unit_filter_impl::unit_filter_args{*u, u->get_location(), other_unit, fc_, use_flat_tod_})) {
+			ret.push_back(&*u);
+		}
+
+		return ret;
+	}
 
-	for (const unit & u : fc_->get_disp_context().units()) {
+	for (const unit & u : units) {
 		if (impl_.matches(unit_filter_impl::unit_filter_args{u, loc ? *loc : u.get_location(), other_unit, fc_, use_flat_tod_})) {
 			if(max_matches == 0) {
 				return ret;
@@ -226,12 +240,26 @@ public:
 unit_filter_compound::unit_filter_compound(vconfig cfg)
 	: children_()
 	, cond_children_()
+	, unit_children_()
+	, has_or_(false)
+	, only_location_()
 {
 	fill(cfg);
 }
 
 bool unit_filter_compound::matches(const unit_filter_args& args) const
 {
+	// Without an [or] nothing can make up for a failed attribute, so units
+	// with the wrong side, type or id are rejected before storing this_unit,
+	// which means serializing the whole unit.
+	if(!has_or_) {
+		for(const auto& filter : unit_children_) {
+			if(!filter->matches(args)) {
+				return false;
+			}
+		}
+	}
+
 	bool res;
 
 	if(args.loc.valid()) {
@@ -267,6 +295,14 @@ bool unit_filter_compound::matches(const unit_filter_args& args) const
 
 bool unit_filter_compound::filter_impl(const unit_filter_args& args) const
 {
+	if(has_or_) {
+		for(const auto& filter : unit_children_) {
+			if(!filter->matches(args)) {
+				return false;
+			}
+		}
+	}
+
 	for(const auto & filter : children_) {
 		if (!filter->matches(args)) {
 			return false;
@@ -276,15 +312,17 @@ bool unit_filter_compound::filter_impl(const unit_filter_args& args) const
 }
 
 template<typename F>
-void unit_filter_compound::create_child(const vconfig& c, F func)
+void unit_filter_compound::create_child(const vconfig& c, F func, filter_cost cost)
 {
 	children_.emplace_back(new unit_filter_child_literal<F>(c, func));
+	children_.back()->cost = cost;
 }
 
 template<typename C, typename F>
-void unit_filter_compound::create_attribute(const config::attribute_value v, C conv, F func)
+void unit_filter_compound::create_attribute(const config::attribute_value v, C conv, F func, filter_cost cost)
 {
 	if(v.blank()) {
+		return;
 	}
 	else if(v.apply_visitor(contains_dollar_visitor())) {
 		children_.emplace_back(new unit_filter_attribute_literal<C, F>(std::move(v.str()), std::move(conv), std::move(func)));
@@ -292,6 +330,18 @@ void unit_filter_compound::create_attribute(const config::attribute_value v, C c
 	else {
 		children_.emplace_back(new unit_filter_attribute_parsed<decltype(conv(v)), F>(std::move(conv(v)), std::move(func)));
 	}
+	children_.back()->cost = cost;
+}
+
+template<typename C, typename F>
+void unit_filter_compound::create_unit_attribute(const config::attribute_value v, C conv, F func)
+{
+	if(v.blank() || v.apply_visitor(contains_dollar_visitor())) {
+		create_attribute(v, std::move(conv), std::move(func));
+	}
+	else {
+		unit_children_.emplace_back(new unit_filter_attribute_parsed<decltype(conv(v)), F>(std::move(conv(v)), std::move(func)));
+	}
 }
 
 namespace {
@@ -326,7 +376,7 @@ void unit_filter_compound::fill(vconfig cfg)
 			[](const t_string& str, const unit_filter_args& args) { return str == args.u.name(); }
 		);
 
-		create_attribute(literal["id"],
+		create_unit_attribute(literal["id"],
 			[](const config::attribute_value& c) { return utils::split(c.str()); },
 			[](const std::vector<std::string>& id_list, const unit_filter_args& args)
 			{
@@ -334,7 +384,7 @@ void unit_filter_compound::fill(vconfig cfg)
 			}
 		);
 
-		create_attribute(literal["type"],
+		create_unit_attribute(literal["type"],
 			[](const config::attribute_value& c) { return utils::split(c.str()); },
 			[](const std::vector<std::string>& types, const unit_filter_args& args)
 			{
@@ -358,7 +408,8 @@ void unit_filter_compound::fill(vconfig cfg)
 					}
 				}
 				return types_expanded.find(args.u.type_id()) != types_expanded.end();
-			}
+			},
+			filter_cost::unit_data
 		);
 
 		create_attribute(literal["variation"],
@@ -383,7 +434,8 @@ void unit_filter_compound::fill(vconfig cfg)
 					}
 				}
 				return false;
-			}
+			},
+			filter_cost::unit_data
 		);
 
 		create_attribute(literal["ability"],
@@ -396,7 +448,8 @@ void unit_filter_compound::fill(vconfig cfg)
 					}
 				}
 				return false;
-			}
+			},
+			filter_cost::unit_data
 		);
 
 		create_attribute(literal["ability_type"],
@@ -409,7 +462,8 @@ void unit_filter_compound::fill(vconfig cfg)
 					}
 				}
 				return false;
-			}
+			},
+			filter_cost::unit_data
 		);
 
 		create_attribute(literal["ability_id_active"],
@@ -445,7 +499,8 @@ void unit_filter_compound::fill(vconfig cfg)
 					}
 				}
 				return false;
-			}
+			},
+			filter_cost::nested
 		);
 
 		create_attribute(literal["ability_type_active"],
@@ -458,7 +513,8 @@ void unit_filter_compound::fill(vconfig cfg)
 					}
 				}
 				return false;
-			}
+			},
+			filter_cost::nested
 		);
 
 		create_attribute(literal["trait"],
@@ -477,7 +533,8 @@ void unit_filter_compound::fill(vconfig cfg)
 				std::sort(have_traits.begin(), have_traits.end());
 				std::set_intersection(check_traits.begin(), check_traits.end(), have_traits.begin(), have_traits.end(), std::back_inserter(isect));
 				return !isect.empty();
-			}
+			},
+			filter_cost::unit_data
 		);
 
 		create_attribute(literal["race"],
@@ -511,7 +568,7 @@ void unit_filter_compound::fill(vconfig cfg)
 			}
 		);
 
-		create_attribute(literal["side"],
+		create_unit_attribute(literal["side"],
 			[](const config::attribute_value& c)
 			{
 				std::vector<int> res;
@@ -639,7 +696,8 @@ void unit_filter_compound::fill(vconfig cfg)
 					}
 				}
 				return false;
-			}
+			},
+			filter_cost::location
 		);
 
 		create_attribute(literal["movement_cost"],
@@ -653,7 +711,8 @@ void unit_filter_compound::fill(vconfig cfg)
 					}
 				}
 				return false;
-			}
+			},
+			filter_cost::location
 		);
 
 		create_attribute(literal["vision_cost"],
@@ -667,7 +726,8 @@ void unit_filter_compound::fill(vconfig cfg)
 					}
 				}
 				return false;
-			}
+			},
+			filter_cost::location
 		);
 
 		create_attribute(literal["jamming_cost"],
@@ -681,7 +741,8 @@ void unit_filter_compound::fill(vconfig cfg)
 					}
 				}
 				return false;
-			}
+			},
+			filter_cost::location
 		);
 
 		create_attribute(literal["lua_function"],
@@ -692,7 +753,8 @@ void unit_filter_compound::fill(vconfig cfg)
 					return lk->run_filter(lua_function.c_str(), args.u);
 				}
 				return true;
-			}
+			},
+			filter_cost::script
 		);
 
 		create_attribute(literal["formula"],
@@ -721,7 +783,8 @@ void unit_filter_compound::fill(vconfig cfg)
 					// Formulae with syntax errors match nothing
 					return false;
 				}
-			}
+			},
+			filter_cost::script
 		);
 
 		create_attribute(literal["find_in"],
@@ -746,17 +809,30 @@ void unit_filter_compound::fill(vconfig cfg)
 					}
 				}
 				return true;
-			}
+			},
+			filter_cost::script
 		);
 
 		if (!literal["x"].blank() || !literal["y"].blank()) {
 			children_.emplace_back(new unit_filter_xy(literal["x"], literal["y"]));
+			children_.back()->cost = filter_cost::location;
+
+			const std::string x = literal["x"].str();
+			const std::string y = literal["y"].str();
+			const auto is_number = [](const std::string& s) {
+				return !s.empty() && s.size() < 6 && std::all_of(s.begin(), s.end(), [](char c) { return c >= '0' && c <= '9'; });
+			};
+
+			if(is_number(x) && is_number(y)) {
+				only_location_ = map_location(std::stoi(x), std::stoi(y), wml_loc());
+			}
 		}
 
 		for(auto child : cfg.all_ordered()) {
 			auto cond = conditional_type::get_enum(child.first);
 			if(cond) {
 				cond_children_.emplace_back(std::piecewise_construct_t(), std::tuple(*cond), std::tuple(child.second));
+				has_or_ = has_or_ || *cond == conditional_type::type::filter_or;
 			}
 			else if (child.first == "filter_wml") {
 				create_child(child.second, [](const vconfig& c, const unit_filter_args& args) {
@@ -772,7 +848,7 @@ void unit_filter_compound::fill(vconfig cfg)
 						args.u.write(ucfg);
 						return ucfg.matches(fwml);
 					}
-				});
+				}, filter_cost::script);
 			}
 			else if (child.first == "filter_vision") {
 				create_child(child.second, [](const vconfig& c, const unit_filter_args& args) {
@@ -795,6 +871,7 @@ void unit_filter_compound::fill(vconfig cfg)
 			}
 			else if (child.first == "filter_adjacent") {
 				children_.emplace_back(new unit_filter_adjacent(child.second));
+				children_.back()->cost = filter_cost::nested;
 			}
 			else if (child.first == "filter_location") {
 				create_child(child.second, [](const vconfig& c, const unit_filter_args& args) {
@@ -823,4 +900,11 @@ void unit_filter_compound::fill(vconfig cfg)
 			}
 
 		}
+
+		// All of children_ must match, so their order only matters for how soon
+		// a failing one is found. This also puts [filter_location] and friends,
+		// which come in WML order, after the attributes.
+		std::stable_sort(children_.begin(), children_.end(), [](const auto& a, const auto& b) {
+			return a->cost < b->cost;
+		});
 	}
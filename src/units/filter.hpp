@@ -35,6 +35,7 @@
 #include "variable.hpp"
 
 #include <memory>
+#include <optional>
 #include <vector>
 
 class filter_context;
@@ -77,10 +78,27 @@ namespace unit_filter_impl
 		{}
 	};
 
+	/** Rough cost of checking a filter, cheaper ones are checked first. */
+	enum class filter_cost
+	{
+		/** Compares a value of the unit. */
+		cheap,
+		/** Looks through the unit's traits, abilities or type data. */
+		unit_data,
+		/** Looks at the terrain under the unit. */
+		location,
+		/** Runs another filter or looks at other units. */
+		nested,
+		/** Runs a formula or Lua, or serializes the unit. */
+		script,
+	};
+
 	struct unit_filter_base
 	{
 		virtual bool matches(const unit_filter_args&) const = 0;
 		virtual ~unit_filter_base() {}
+
+		filter_cost cost = filter_cost::cheap;
 	};
 
 	struct unit_filter_compound : public unit_filter_base
@@ -88,17 +106,44 @@ namespace unit_filter_impl
 		unit_filter_compound(vconfig cfg);
 
 		template<typename C, typename F>
-		void create_attribute(const config::attribute_value c, C conv, F func);
+		void create_attribute(const config::attribute_value c, C conv, F func, filter_cost cost = filter_cost::cheap);
+
+		/**
+		 * Like create_attribute(), but for attributes which only look at the
+		 * unit itself. Those without variables are checked before this_unit
+		 * is stored, see matches().
+		 */
+		template<typename C, typename F>
+		void create_unit_attribute(const config::attribute_value c, C conv, F func);
 		template<typename F>
-		void create_child(const vconfig& c, F func);
+		void create_child(const vconfig& c, F func, filter_cost cost = filter_cost::nested);
 
 		void fill(vconfig cfg);
 
 		virtual bool matches(const unit_filter_args& u) const override;
 		bool filter_impl(const unit_filter_args& u) const;
 
+		/**
+		 * The location the filter's x= and y= select, if they are a single
+		 * literal location. Only units there can match, unless the filter
+		 * has an [or] or is matched against another location.
+		 */
+		std::optional<map_location> only_location() const
+		{
+			return has_or_ ? std::nullopt : only_location_;
+		}
+
+		/** Sorted by cost once filled, since all of them must match anyway. */
 		std::vector<std::shared_ptr<unit_filter_base>> children_;
 		std::vector<std::pair<conditional_type::type, unit_filter_compound>> cond_children_;
+
+		/** Attributes not depending on variables, also part of filter_impl(). */
+		std::vector<std::shared_ptr<unit_filter_base>> unit_children_;
+
+		/** Whether any of cond_children_ is an [or], which can match units the rest rejects. */
+		bool has_or_;
+
+		std::optional<map_location> only_location_;
 	};
 
 }
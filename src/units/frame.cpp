@@ -566,6 +566,20 @@ void render_unit_image(
 }
 } // namespace
 
+unit_frame::frame_data::frame_data(const frame_builder& builder)
+	: builder(builder)
+	, constant()
+{
+	if(this->builder.does_not_change()) {
+		constant = this->builder.parameters(0);
+	}
+}
+
+unit_frame::unit_frame(const frame_builder& builder)
+	: data_(std::make_shared<const frame_data>(builder))
+{
+}
+
 void unit_frame::redraw(const int frame_time, bool on_start_time, bool in_scope_of_frame,
 		const map_location& src, const map_location& dst,
 		halo::handle& halo_id, halo::manager& halo_man,
@@ -862,7 +876,7 @@ const frame_parameters unit_frame::merge_parameters(int current_time, const fram
 		const frame_parameters& engine_val) const
 {
 	frame_parameters result;
-	const frame_parameters& current_val = builder_.parameters(current_time);
+	const frame_parameters& current_val = parameters(current_time);
 
 	result.primary_frame = engine_val.primary_frame;
 	if(!boost::logic::indeterminate(animation_val.primary_frame)) {
@@ -25,6 +25,7 @@
 #include "color.hpp"
 #include "halo.hpp"
 #include "picture.hpp"
+#include <memory>
 #include <optional>
 
 #include <boost/logic/tribool.hpp>
@@ -202,7 +203,7 @@ class unit_frame
 {
 public:
 	// Constructors
-	unit_frame(const frame_builder& builder = frame_builder()) : builder_(builder) {}
+	unit_frame(const frame_builder& builder = frame_builder());
 
 	void redraw(const int frame_time, bool on_start_time, bool in_scope_of_frame, const map_location& src, const map_location& dst,
 		halo::handle& halo_id, halo::manager& halo_man, const frame_parameters& animation_val, const frame_parameters& engine_val) const;
@@ -212,38 +213,53 @@ public:
 
 	const frame_parameters parameters(int current_time) const
 	{
-		return builder_.parameters(current_time);
+		return data_->constant ? *data_->constant : data_->builder.parameters(current_time);
 	}
 
 	const frame_parameters end_parameters() const
 	{
-		return builder_.parameters(duration());
+		return parameters(duration());
 	}
 
 	int duration() const
 	{
-		return builder_.duration();
+		return data_->builder.duration();
 	}
 
 	bool does_not_change() const
 	{
-		return builder_.does_not_change();
+		return data_->constant.has_value();
 	}
 
 	bool need_update() const
 	{
-		return builder_.need_update();
+		return !does_not_change();
 	}
 
 	std::vector<std::string> debug_strings() const
 	{
 		// Contents of frame in strings
-		return builder_.debug_strings();
+		return data_->builder.debug_strings();
 	}
 
 	std::set<map_location> get_overlaped_hex(const int frame_time, const map_location& src, const map_location& dst,
 		const frame_parameters& animation_val, const frame_parameters& engine_val) const;
 
 private:
-	frame_parsed_parameters builder_;
+	/** The parsed frame, which never changes once built. */
+	struct frame_data
+	{
+		explicit frame_data(const frame_builder& builder);
+
+		frame_parsed_parameters builder;
+
+		/** The parameters at any time, for frames that do not change over time. */
+		std::optional<frame_parameters> constant;
+	};
+
+	/**
+	 * Shared by all the copies of the frame, so that the units of a type (which
+	 * each get a copy of its animations) do not duplicate it.
+	 */
+	std::shared_ptr<const frame_data> data_;
 };
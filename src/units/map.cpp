@@ -19,6 +19,7 @@
 #include "units/unit.hpp"
 
 #include "units/map.hpp"
+#include <algorithm>
 #include <functional>
 
 static lg::log_domain log_engine("engine");
@@ -29,14 +30,31 @@ static lg::log_domain log_engine("engine");
 
 unit_map::unit_map()
 	: umap_()
-	, lmap_()
+	, lgrid_()
+	, lgrid_width_(0)
+	, lgrid_height_(0)
+	, num_units_(0)
+	, generation_()
+	, adjacent_abilities_()
+	, adjacent_abilities_generation_(0)
+	, adjacent_abilities_units_generation_(0)
 {
+	touch();
 }
 
 unit_map::unit_map(const unit_map& that)
 	: umap_()
-	, lmap_()
+	, lgrid_()
+	, lgrid_width_(0)
+	, lgrid_height_(0)
+	, num_units_(0)
+	, generation_()
+	, adjacent_abilities_()
+	, adjacent_abilities_generation_(0)
+	, adjacent_abilities_units_generation_(0)
 {
+	touch();
+
 	for(const auto& u : that) {
 		add(u.get_location(), u);
 	}
@@ -54,7 +72,75 @@ void unit_map::swap(unit_map& o)
 	assert(num_iters() == 0 && o.num_iters() == 0);
 
 	std::swap(umap_, o.umap_);
-	std::swap(lmap_, o.lmap_);
+	std::swap(lgrid_, o.lgrid_);
+	std::swap(lgrid_width_, o.lgrid_width_);
+	std::swap(lgrid_height_, o.lgrid_height_);
+	std::swap(num_units_, o.num_units_);
+	touch();
+	o.touch();
+}
+
+void unit_map::touch()
+{
+	static std::size_t last_generation = 0;
+	generation_ = ++last_generation;
+}
+
+unit_map::lslot& unit_map::slot(const map_location& loc)
+{
+	assert(loc.valid());
+
+	if(loc.x >= lgrid_width_ || loc.y >= lgrid_height_) {
+		// Grow geometrically so that filling a map unit by unit does not relayout it every time.
+		const int width = loc.x < lgrid_width_ ? lgrid_width_ : std::max(loc.x + 1, lgrid_width_ * 2);
+		const int height = loc.y < lgrid_height_ ? lgrid_height_ : std::max(loc.y + 1, lgrid_height_ * 2);
+
+		std::vector<lslot> grid(static_cast<std::size_t>(width) * height);
+		for(int y = 0; y < lgrid_height_; ++y) {
+			std::move(lgrid_.begin() + y * lgrid_width_, lgrid_.begin() + (y + 1) * lgrid_width_, grid.begin() + y * width);
+		}
+
+		lgrid_.swap(grid);
+		lgrid_width_ = width;
+		lgrid_height_ = height;
+	}
+
+	return lgrid_[loc.y * lgrid_width_ + loc.x];
+}
+
+bool unit_map::has_adjacent_ability(const std::string& tag_name, const map_location& loc) const
+{
+	if(adjacent_abilities_generation_ != generation_ || adjacent_abilities_units_generation_ != unit::abilities_generation()) {
+		adjacent_abilities_.clear();
+		for(const auto& [uid, pod] : umap_) {
+			if(!pod.unit) {
+				continue;
+			}
+
+			const map_location& u_loc = pod.unit->get_location();
+			for(const config::any_child ab : pod.unit->abilities().all_children_range()) {
+				if(!ab.cfg.has_child("affect_adjacent")) {
+					continue;
+				}
+
+				std::vector<map_location>& locs = adjacent_abilities_[ab.key];
+				if(locs.empty() || locs.back() != u_loc) {
+					locs.push_back(u_loc);
+				}
+			}
+		}
+
+		adjacent_abilities_generation_ = generation_;
+		adjacent_abilities_units_generation_ = unit::abilities_generation();
+	}
+
+	const auto i = adjacent_abilities_.find(tag_name);
+	if(i == adjacent_abilities_.end()) {
+		return false;
+	}
+
+	return std::any_of(i->second.begin(), i->second.end(),
+		[&loc](const map_location& u_loc) { return tiles_adjacent(u_loc, loc); });
 }
 
 unit_map::~unit_map()
@@ -94,14 +180,15 @@ unit_map::umap_retval_pair_t unit_map::move(const map_location& src, const map_l
 {
 	self_check();
 	DBG_NG << "Unit map: Moving unit from " << src << " to " << dst;
+	touch();
 
 	// Find the unit at the src location
-	lmap::iterator i = lmap_.find(src);
-	if(i == lmap_.end()) {
-		return std::pair(make_unit_iterator(i), false);
+	const lslot* from = find_slot(src);
+	if(!from || !*from) {
+		return std::pair(make_unit_iterator(umap_.end()), false);
 	}
 
-	umap::iterator uit(i->second);
+	umap::iterator uit(**from);
 
 	if(src == dst) {
 		return std::pair(make_unit_iterator(uit), true);
@@ -113,19 +200,22 @@ unit_map::umap_retval_pair_t unit_map::move(const map_location& src, const map_l
 		return std::pair(make_unit_iterator(uit), false);
 	}
 
-	p->set_location(dst);
-
-	lmap_.erase(i);
-
-	std::pair<lmap::iterator, bool> res = lmap_.emplace(dst, uit);
+	// Fail and don't move if the destination is off the grid or already occupied.
+	if(!dst.valid()) {
+		return std::pair(make_unit_iterator(uit), false);
+	}
 
-	// Fail and don't move if the destination is already occupied.
-	if(res.second == false) {
-		p->set_location(src);
-		lmap_.emplace(src, uit);
+	// Growing the grid moves the slots, so the source one is looked up again afterwards.
+	lslot& to = slot(dst);
+	if(to) {
 		return std::pair(make_unit_iterator(uit), false);
 	}
 
+	p->set_location(dst);
+
+	to = uit;
+	find_slot(src)->reset();
+
 	self_check();
 
 	return std::pair(make_unit_iterator(uit), true);
@@ -135,10 +225,11 @@ unit_map::umap_retval_pair_t unit_map::insert(unit_ptr p)
 {
 	// 1. Construct a unit_pod.
 	// 2. Try insertion into the umap.
-	// 3. Try insertion in the lmap and remove the umap entry on failure.
+	// 3. Try insertion in the location grid and remove the umap entry on failure.
 
 	self_check();
 	assert(p);
+	touch();
 
 	std::size_t unit_id = p->underlying_id();
 	const map_location& loc = p->get_location();
@@ -189,10 +280,10 @@ unit_map::umap_retval_pair_t unit_map::insert(unit_ptr p)
 		}
 	}
 
-	std::pair<lmap::iterator, bool> linsert = lmap_.emplace(loc, uinsert.first);
+	lslot& lplace = slot(loc);
 
 	// Fail if the location is occupied
-	if(!linsert.second) {
+	if(lplace) {
 		if(upod.ref_count == 0) {
 			// Undo a virgin insertion
 			umap_.erase(uinsert.first);
@@ -202,12 +293,15 @@ unit_map::umap_retval_pair_t unit_map::insert(unit_ptr p)
 		}
 
 		DBG_NG << "Trying to add " << p->name() << " - " << p->id() << " at location (" << loc << "); Occupied  by "
-			   << (linsert.first->second->second).unit->name() << " - " << linsert.first->second->second.unit->id()
+			   << (*lplace)->second.unit->name() << " - " << (*lplace)->second.unit->id()
 			   << "\n";
 
 		return std::pair(make_unit_iterator(umap_.end()), false);
 	}
 
+	lplace = uinsert.first;
+	++num_units_;
+
 	self_check();
 	return std::pair(make_unit_iterator(uinsert.first), true);
 }
@@ -243,6 +337,7 @@ std::size_t unit_map::num_iters() const
 void unit_map::clear(bool force)
 {
 	assert(force || (num_iters() == 0));
+	touch();
 
 	for(umap::iterator i = umap_.begin(); i != umap_.end(); ++i) {
 		if(is_valid(i)) {
@@ -251,7 +346,10 @@ void unit_map::clear(bool force)
 		}
 	}
 
-	lmap_.clear();
+	lgrid_.clear();
+	lgrid_width_ = 0;
+	lgrid_height_ = 0;
+	num_units_ = 0;
 	umap_.clear();
 }
 
@@ -259,12 +357,14 @@ unit_ptr unit_map::extract(const map_location& loc)
 {
 	self_check();
 
-	lmap::iterator i = lmap_.find(loc);
-	if(i == lmap_.end()) {
+	lslot* i = find_slot(loc);
+	if(!i || !*i) {
 		return unit_ptr();
 	}
 
-	umap::iterator uit(i->second);
+	touch();
+
+	umap::iterator uit(**i);
 
 	unit_ptr u = uit->second.unit;
 	std::size_t uid(u->underlying_id());
@@ -279,7 +379,8 @@ unit_ptr unit_map::extract(const map_location& loc)
 		uit->second.unit.reset();
 	}
 
-	lmap_.erase(i);
+	i->reset();
+	--num_units_;
 	self_check();
 
 	return u;
@@ -313,7 +414,13 @@ unit_map::unit_iterator unit_map::find(std::size_t id)
 unit_map::unit_iterator unit_map::find(const map_location& loc)
 {
 	self_check();
-	return make_unit_iterator<lmap::iterator>(lmap_.find(loc));
+
+	const lslot* i = find_slot(loc);
+	if(!i || !*i) {
+		return make_unit_iterator(umap_.end());
+	}
+
+	return make_unit_iterator(**i);
 }
 
 unit_map::unit_iterator unit_map::find_leader(int side)
@@ -399,18 +506,30 @@ bool unit_map::self_check() const
 		}
 	}
 
-	lmap::const_iterator locit(lmap_.begin());
-	for(; locit != lmap_.end(); ++locit) {
-		if(locit->second == umap_.end()) {
-			good = false;
-			ERR_NG << "unit_map lmap element == umap_.end() ";
-		}
-		if(locit->first != locit->second->second.unit->get_location()) {
-			good = false;
-			ERR_NG << "unit_map lmap location != unit->get_location() ";
+	std::size_t occupied(0);
+	for(int y = 0; y < lgrid_height_; ++y) {
+		for(int x = 0; x < lgrid_width_; ++x) {
+			const lslot& s = lgrid_[y * lgrid_width_ + x];
+			if(!s) {
+				continue;
+			}
+
+			++occupied;
+			if(*s == umap_.end()) {
+				good = false;
+				ERR_NG << "unit_map lgrid element == umap_.end() ";
+			} else if(map_location(x, y) != (*s)->second.unit->get_location()) {
+				good = false;
+				ERR_NG << "unit_map lgrid location != unit->get_location() ";
+			}
 		}
 	}
 
+	if(occupied != num_units_) {
+		good = false;
+		ERR_NG << "unit_map lgrid holds " << occupied << " units, expected " << num_units_;
+	}
+
 	// assert(good);
 	return good;
 #else
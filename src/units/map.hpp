@@ -23,7 +23,8 @@
 #include <cassert>
 #include <list>
 #include <map>
-#include <unordered_map>
+#include <optional>
+#include <vector>
 
 //#define DEBUG_UNIT_MAP
 
@@ -35,10 +36,10 @@
  * another unit with the same underlying id is inserted in the map. In other words, it is a doubly
  * indexed ordered map with persistent iterators (that never invalidate).
  *
- * @note The unit_map is implemented as 2 maps: an unordered map that stores iterators from the
+ * @note The unit_map is implemented as a dense grid of locations that stores iterators from the
  * ordered map of reference-counted pointers to units.
  *
- * The unordered map provides O(1) find times. The ordered map ensures ordering of units by
+ * The grid provides O(1) find times without hashing. The ordered map ensures ordering of units by
  * underlying_id. The reference counting is what guarantees the persistent iterators. Storing an
  * iterator only prevents that dead unit's id-map entry from being recovered.
  *
@@ -117,8 +118,8 @@ class unit_map
 	 */
 	typedef std::map<std::size_t, unit_pod> umap;
 
-	/** Map of location to umap iterator. */
-	typedef std::unordered_map<map_location, umap::iterator> lmap;
+	/** Slot of the location grid, empty when no unit stands there. */
+	typedef std::optional<umap::iterator> lslot;
 
 public:
 	// ~~~ Begin iterator code ~~~
@@ -193,17 +194,6 @@ public:
 			return iterator_base<const_iter_types>(i_, tank_);
 		}
 
-	private:
-		/** Constructs an iterator from the location map. */
-		iterator_base(lmap::iterator ui, container_type* m)
-			: i_(ui->second)
-			, tank_(m)
-		{
-			inc();
-			valid_exit();
-		}
-
-	public:
 		pointer operator->() const
 		{
 			assert(valid());
@@ -413,7 +403,8 @@ public:
 
 	std::size_t count(const map_location& loc) const
 	{
-		return lmap_.count(loc);
+		const lslot* s = find_slot(loc);
+		return s && *s ? 1 : 0;
 	}
 
 	unit_iterator begin()
@@ -438,14 +429,30 @@ public:
 
 	std::size_t size() const
 	{
-		return lmap_.size();
+		return num_units_;
 	}
 
 	std::size_t num_iters() const;
 
+	/**
+	 * Changes whenever units are added, removed or moved.
+	 * No two maps ever share a value, even after a swap.
+	 */
+	std::size_t generation() const
+	{
+		return generation_;
+	}
+
+	/**
+	 * Whether a unit adjacent to @a loc has a @a tag_name ability with
+	 * [affect_adjacent]. This may give false positives, it only saves the
+	 * callers from looking at the neighbours when no such unit is near.
+	 */
+	bool has_adjacent_ability(const std::string& tag_name, const map_location& loc) const;
+
 	bool empty() const
 	{
-		return lmap_.empty();
+		return num_units_ == 0;
 	}
 
 	void clear(bool force = false);
@@ -548,21 +555,11 @@ private:
 		return is_found(i) && (i->second.unit != nullptr);
 	}
 
-	bool is_valid(const lmap::const_iterator& i) const
-	{
-		return is_found(i) && (i->second->second.unit != nullptr);
-	}
-
 	bool is_found(const umap::const_iterator& i) const
 	{
 		return i != umap_.end();
 	}
 
-	bool is_found(const lmap::const_iterator& i) const
-	{
-		return i != lmap_.end();
-	}
-
 	template<typename X>
 	unit_map::unit_iterator make_unit_iterator(const X& i)
 	{
@@ -590,9 +587,49 @@ private:
 	mutable umap umap_;
 
 	/**
-	 * location -> umap::iterator.
+	 * location -> umap::iterator, as a dense row-major grid.
+	 * It is grown on demand to cover the location of every unit, so it ends up matching the game
+	 * map and a lookup is a bounds check and an index computation.
+	 */
+	std::vector<lslot> lgrid_;
+	int lgrid_width_;
+	int lgrid_height_;
+
+	/** Number of non-empty slots in lgrid_. */
+	std::size_t num_units_;
+
+	/** The slot of @a loc, or nullptr if the grid does not cover it. */
+	const lslot* find_slot(const map_location& loc) const
+	{
+		if(loc.x < 0 || loc.y < 0 || loc.x >= lgrid_width_ || loc.y >= lgrid_height_) {
+			return nullptr;
+		}
+
+		return &lgrid_[loc.y * lgrid_width_ + loc.x];
+	}
+
+	lslot* find_slot(const map_location& loc)
+	{
+		return const_cast<lslot*>(static_cast<const unit_map*>(this)->find_slot(loc));
+	}
+
+	/**
+	 * The slot of @a loc, growing the grid if needed.
+	 * @pre @a loc is valid. This invalidates pointers to other slots.
 	 */
-	lmap lmap_;
+	lslot& slot(const map_location& loc);
+
+	/** Called by every function that adds, removes or moves units. */
+	void touch();
+
+	std::size_t generation_;
+
+	/** Locations of the units having abilities with [affect_adjacent], by tag name. */
+	mutable std::map<std::string, std::vector<map_location>> adjacent_abilities_;
+
+	/** The generation and unit::abilities_generation() adjacent_abilities_ was built for. */
+	mutable std::size_t adjacent_abilities_generation_;
+	mutable std::size_t adjacent_abilities_units_generation_;
 };
 
 /** Implement non-member swap function for std::swap (calls @ref unit_map::swap). */
@@ -592,6 +592,7 @@ void unit::init(const config& cfg, bool use_traits, const vconfig* vcfg)
 	if(config::const_child_itors cfg_range = cfg.child_range("abilities")) {
 		set_attr_changed(UA_ABILITIES);
 		abilities_.clear();
+		++abilities_generation_;
 		for(const config& abilities : cfg_range) {
 			abilities_.append(abilities);
 		}
@@ -912,6 +913,7 @@ void unit::advance_to(const unit_type& u_type, bool use_traits)
 
 	generate_name_ &= new_type.generate_name();
 	abilities_ = new_type.abilities_cfg();
+	++abilities_generation_;
 	advancements_.clear();
 
 	for(const config& advancement : new_type.advancements()) {
@@ -1036,6 +1038,8 @@ std::string unit::small_profile() const
 	return absolute_image();
 }
 
+std::size_t unit::abilities_generation_ = 0;
+
 const std::string& unit::leader_crown()
 {
 	return leader_crown_path;
@@ -1398,6 +1402,7 @@ bool unit::has_ability_by_id(const std::string& ability) const
 void unit::remove_ability_by_id(const std::string& ability)
 {
 	set_attr_changed(UA_ABILITIES);
+	++abilities_generation_;
 	config::all_children_iterator i = abilities_.ordered_begin();
 	while (i != abilities_.ordered_end()) {
 		if(i->cfg["id"] == ability) {
@@ -1580,7 +1585,7 @@ void unit::write(config& cfg, bool write_all) const
 			}
 		}
 	}
-	cfg.append(back);
+	cfg.append(std::move(back));
 }
 
 void unit::set_facing(map_location::DIRECTION dir) const
@@ -2112,6 +2117,7 @@ void unit::apply_builtin_effect(std::string apply_to, const config& effect)
 				}
 			}
 			abilities_.append(to_append);
+			++abilities_generation_;
 		}
 	} else if(apply_to == "remove_ability") {
 		if(const config& ab_effect = effect.child("abilities")) {
@@ -142,6 +142,15 @@ public:
 	/** The path to the leader crown overlay. */
 	static const std::string& leader_crown();
 
+	/**
+	 * Changes whenever the abilities of any unit change, for caches of the
+	 * abilities present on the map, see unit_map::has_adjacent_ability.
+	 */
+	static std::size_t abilities_generation()
+	{
+		return abilities_generation_;
+	}
+
 private:
 	void init(const config& cfg, bool use_traits = false, const vconfig* vcfg = nullptr);
 
@@ -1950,6 +1959,8 @@ private:
 	config modifications_;
 	config abilities_;
 
+	static std::size_t abilities_generation_;
+
 	std::vector<config> advancements_;
 
 	t_string description_;
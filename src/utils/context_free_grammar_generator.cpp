@@ -132,24 +132,24 @@ context_free_grammar_generator::context_free_grammar_generator(const std::map<st
 	}
 }
 
-std::string context_free_grammar_generator::print_nonterminal(const std::string& name, uint32_t* seed, short seed_pos) const {
+void context_free_grammar_generator::print_nonterminal(std::string& result, std::string_view name, uint32_t* seed, short seed_pos) const {
 	if (name == "!") {
-		return "|";
+		result += '|';
 	}
 	else if (name == "(" ) {
-		return "{";
+		result += '{';
 	}
 	else if (name == ")" ) {
-		return "}";
+		result += '}';
 	}
 	else {
-		std::string result = "";
-
-		std::map<std::string,nonterminal>::const_iterator found = nonterminals_.find(name);
+		const auto found = nonterminals_.find(name);
 		if (found == nonterminals_.end()) {
 			lg::log_to_chat() << "[context_free_grammar_generator] Warning: needed nonterminal " << name << " not defined\n";
 			ERR_WML << "[context_free_grammar_generator] Warning: needed nonterminal " << name << " not defined";
-			return "!" + name;
+			result += '!';
+			result += name;
+			return;
 		}
 		const context_free_grammar_generator::nonterminal& got = found->second;
 		unsigned int picked = seed[seed_pos++] % got.possibilities_.size();
@@ -161,17 +161,18 @@ std::string context_free_grammar_generator::print_nonterminal(const std::string&
 		got.last_ = picked;
 		const std::vector<std::string>& used = got.possibilities_[picked];
 		for (unsigned int i = 0; i < used.size(); i++) {
-			if (used[i][0] == '{') result += print_nonterminal(used[i].substr(1), seed, seed_pos);
+			if (used[i][0] == '{') print_nonterminal(result, std::string_view(used[i]).substr(1), seed, seed_pos);
 			else result += used[i];
 		}
-		return result;
 	}
 }
 
 std::string context_free_grammar_generator::generate() const {
 	uint32_t seed[seed_size];
 	init_seed(seed);
-	return print_nonterminal("main", seed, 0);
+	std::string result;
+	print_nonterminal(result, "main", seed, 0);
+	return result;
 }
 
 void context_free_grammar_generator::init_seed(uint32_t seed[]) const {
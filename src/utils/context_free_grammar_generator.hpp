@@ -18,6 +18,8 @@
 #include "utils/name_generator.hpp"
 
 #include <list>
+#include <map>
+#include <string_view>
 #include <vector>
 #include <cstdint>
 
@@ -32,8 +34,9 @@ private:
 	};
 
 	void init_seed(uint32_t seed[]) const;
-	std::map<std::string, nonterminal> nonterminals_;
-	std::string print_nonterminal(const std::string& name, uint32_t seed[], short int seed_pos) const;
+	/** Transparently ordered, so references in possibilities can be looked up without copying them. */
+	std::map<std::string, nonterminal, std::less<>> nonterminals_;
+	void print_nonterminal(std::string& result, std::string_view name, uint32_t seed[], short int seed_pos) const;
 	static const short unsigned int seed_size = 20;
 
 public:
@@ -0,0 +1,218 @@
+/*
+	Copyright (C) 2022
+	Part of the Battle for Wesnoth Project https://www.wesnoth.org/
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY.
+
+	See the COPYING file for more details.
+*/
+
+#pragma once
+
+#include <boost/circular_buffer.hpp>
+#include <boost/preprocessor/cat.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace util {
+
+/**
+ * Records the duration of named scopes and of each frame of the client render
+ * loop, for finding out where frame time goes.
+ *
+ * Disabled unless --frame-trace was given on the command line, in which case
+ * a frame time graph is drawn over the game display and the recorded scopes
+ * are written as a Chrome trace (chrome://tracing, Perfetto) on exit.
+ */
+class frame_profiler
+{
+public:
+	using clock = std::chrono::steady_clock;
+
+	/** Number of frame durations kept for the overlay graph. */
+	static const std::size_t history_size = 240;
+
+	/** Maximum number of scopes recorded for the trace, about 32 MiB. */
+	static const std::size_t max_events = 1 << 20;
+
+	static frame_profiler& get()
+	{
+		static frame_profiler instance;
+		return instance;
+	}
+
+	/** Starts recording. The trace is written to @a trace_file on exit. */
+	void enable(const std::string& trace_file)
+	{
+		std::lock_guard lock(mutex_);
+		trace_file_ = trace_file;
+		enabled_ = true;
+		events_.reserve(4096);
+	}
+
+	bool enabled() const
+	{
+		return enabled_;
+	}
+
+	/** Records a finished scope. */
+	void record(const char* name, clock::time_point start, clock::time_point end)
+	{
+		std::lock_guard lock(mutex_);
+		if(events_.size() >= max_events) {
+			if(!dropped_events_++) {
+				std::cerr << "frame profiler: event limit reached, no longer recording scopes" << std::endl;
+			}
+
+			return;
+		}
+
+		events_.push_back({name, thread_index(), start, end});
+	}
+
+	/** Marks the end of a frame of the render loop. */
+	void end_frame()
+	{
+		const clock::time_point now = clock::now();
+		if(last_frame_ != clock::time_point()) {
+			record("frame", last_frame_, now);
+			frame_times_.push_back(std::chrono::duration_cast<std::chrono::microseconds>(now - last_frame_).count());
+		}
+
+		last_frame_ = now;
+	}
+
+	/** Durations of the most recent frames in microseconds, oldest first. */
+	const boost::circular_buffer<int64_t>& frame_times() const
+	{
+		return frame_times_;
+	}
+
+	/** Writes the recorded scopes in the Chrome trace event format. */
+	void write_trace(std::ostream& out) const
+	{
+		std::lock_guard lock(mutex_);
+		out << "{\"traceEvents\":[";
+
+		bool first = true;
+		for(const event& e : events_) {
+			out << (first ? "\n" : ",\n")
+				<< "{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.thread
+				<< ",\"ts\":" << std::chrono::duration_cast<std::chrono::microseconds>(e.start - origin_).count()
+				<< ",\"dur\":" << std::chrono::duration_cast<std::chrono::microseconds>(e.end - e.start).count() << "}";
+			first = false;
+		}
+
+		out << "\n]}\n";
+	}
+
+	/**
+	 * RAII helper recording the duration of its scope, see PROFILE_SCOPE.
+	 *
+	 * @param name                Must outlive the profiler, a string literal.
+	 */
+	class scope
+	{
+	public:
+		explicit scope(const char* name)
+			: name_(name)
+			, start_(get().enabled() ? clock::now() : clock::time_point())
+		{
+		}
+
+		~scope()
+		{
+			if(start_ != clock::time_point()) {
+				get().record(name_, start_, clock::now());
+			}
+		}
+
+		scope(const scope&) = delete;
+		scope& operator=(const scope&) = delete;
+
+	private:
+		const char* name_;
+		clock::time_point start_;
+	};
+
+private:
+	frame_profiler()
+		: enabled_(false)
+		, trace_file_()
+		, origin_(clock::now())
+		, last_frame_()
+		, events_()
+		, dropped_events_(0)
+		, frame_times_(history_size)
+		, threads_()
+		, mutex_()
+	{
+	}
+
+	~frame_profiler()
+	{
+		if(!enabled_ || trace_file_.empty()) {
+			return;
+		}
+
+		std::ofstream out(trace_file_);
+		write_trace(out);
+
+		if(!out) {
+			std::cerr << "frame profiler: could not write trace to '" << trace_file_ << "'" << std::endl;
+		}
+	}
+
+	struct event
+	{
+		const char* name;
+		std::size_t thread;
+		clock::time_point start;
+		clock::time_point end;
+	};
+
+	/** Small, stable per-thread number for the trace. Called with the mutex held. */
+	std::size_t thread_index()
+	{
+		const std::thread::id id = std::this_thread::get_id();
+		for(std::size_t i = 0; i < threads_.size(); ++i) {
+			if(threads_[i] == id) {
+				return i + 1;
+			}
+		}
+
+		threads_.push_back(id);
+		return threads_.size();
+	}
+
+	bool enabled_;
+	std::string trace_file_;
+	clock::time_point origin_;
+	clock::time_point last_frame_;
+	std::vector<event> events_;
+	std::size_t dropped_events_;
+	boost::circular_buffer<int64_t> frame_times_;
+	std::vector<std::thread::id> threads_;
+	mutable std::mutex mutex_;
+};
+
+} // namespace util
+
+/**
+ * Records the time spent in the current scope under @a name when frame
+ * profiling is enabled. Costs a single branch otherwise.
+ */
+#define PROFILE_SCOPE(name) const util::frame_profiler::scope BOOST_PP_CAT(profile_scope_, __LINE__){name}
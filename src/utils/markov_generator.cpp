@@ -23,6 +23,8 @@
 #include "serialization/unicode_cast.hpp"
 #include "random.hpp"
 
+#include <algorithm>
+
 static void add_prefixes(const std::u32string& str, std::size_t length, markov_prefix_map& res)
 {
 	for(std::size_t i = 0; i <= str.size(); ++i) {
@@ -125,7 +127,9 @@ static std::u32string markov_generate_name(const markov_prefix_map& prefixes,
 }
 
 markov_generator::markov_generator(const std::vector<std::string>& items, std::size_t chain_size, std::size_t max_len)
-	: prefixes_(markov_prefixes(items, chain_size))
+	: items_(items)
+	, prefixes_()
+	, prefixes_built_()
 	, chain_size_(chain_size)
 	, max_len_(max_len)
 {
@@ -133,6 +137,13 @@ markov_generator::markov_generator(const std::vector<std::string>& items, std::s
 
 std::string markov_generator::generate() const
 {
+	// Every race has a generator, but names are only generated for a few of
+	// them in a given game, so the prefixes are built when first needed.
+	std::call_once(prefixes_built_, [this]() {
+		prefixes_ = markov_prefixes(items_, chain_size_);
+		items_ = std::vector<std::string>();
+	});
+
 	std::u32string name = markov_generate_name(prefixes_, chain_size_, max_len_);
 	return unicode_cast<std::string>(name);
 }
@@ -16,13 +16,19 @@
 #pragma once
 
 #include "utils/name_generator.hpp"
-#include <map>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
-typedef std::map<std::u32string, std::u32string> markov_prefix_map;
+typedef std::unordered_map<std::u32string, std::u32string> markov_prefix_map;
 
 class markov_generator : public name_generator {
-	markov_prefix_map prefixes_;
+	/** The names to learn from, until the prefixes are built on first use. */
+	mutable std::vector<std::string> items_;
+	mutable markov_prefix_map prefixes_;
+	mutable std::once_flag prefixes_built_;
 	std::size_t chain_size_, max_len_;
 public:
 	markov_generator(const std::vector<std::string>& items, std::size_t chain_size, std::size_t max_len);
@@ -0,0 +1,210 @@
+/*
+	Copyright (C) 2022
+	Part of the Battle for Wesnoth Project https://www.wesnoth.org/
+
+	This program is free software; you can redistribute it and/or modify
+	it under the terms of the GNU General Public License as published by
+	the Free Software Foundation; either version 2 of the License, or
+	(at your option) any later version.
+	This program is distributed in the hope that it will be useful,
+	but WITHOUT ANY WARRANTY.
+
+	See the COPYING file for more details.
+*/
+
+#pragma once
+
+#include <boost/preprocessor/cat.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace util {
+
+/**
+ * Named, process-wide count of calls and time spent, for the main hot paths.
+ *
+ * Counters are function-local statics created by the PERF_TIMER and
+ * PERF_COUNT macros, and are always on: a timed scope costs two clock reads
+ * and two relaxed atomic additions. The totals are shown by the :perf
+ * console command, returned by wesnoth.perf_counters() in Lua and logged
+ * on exit.
+ *
+ * Unlike PROFILE_SCOPE, which records every scope for a timeline when
+ * --frame-trace is given, counters only keep totals.
+ */
+class perf_counter
+{
+public:
+	using clock = std::chrono::steady_clock;
+
+	/** @param name           Must outlive the counter, a string literal. */
+	explicit perf_counter(const char* name)
+		: name_(name)
+		, calls_(0)
+		, time_(0)
+	{
+		registry& r = get_registry();
+		std::lock_guard lock(r.mutex);
+		r.counters.push_back(this);
+	}
+
+	~perf_counter()
+	{
+		registry& r = get_registry();
+		std::lock_guard lock(r.mutex);
+		r.counters.erase(std::remove(r.counters.begin(), r.counters.end(), this), r.counters.end());
+	}
+
+	perf_counter(const perf_counter&) = delete;
+	perf_counter& operator=(const perf_counter&) = delete;
+
+	/** Counts a call that took @a time. */
+	void add(clock::duration time)
+	{
+		calls_.fetch_add(1, std::memory_order_relaxed);
+		time_.fetch_add(time.count(), std::memory_order_relaxed);
+	}
+
+	/** Counts a call without timing it. */
+	void add_call()
+	{
+		calls_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	const char* name() const
+	{
+		return name_;
+	}
+
+	std::uint64_t calls() const
+	{
+		return calls_.load(std::memory_order_relaxed);
+	}
+
+	clock::duration time() const
+	{
+		return clock::duration(time_.load(std::memory_order_relaxed));
+	}
+
+	struct totals
+	{
+		std::uint64_t calls = 0;
+		clock::duration time{0};
+	};
+
+	/**
+	 * Totals of all counters that were hit, by name.
+	 *
+	 * Counters sharing a name, such as the same macro expanded in several
+	 * functions, are added up.
+	 */
+	static std::map<std::string, totals> all_totals()
+	{
+		std::map<std::string, totals> res;
+
+		registry& r = get_registry();
+		std::lock_guard lock(r.mutex);
+		for(const perf_counter* c : r.counters) {
+			if(c->calls() != 0) {
+				totals& t = res[c->name()];
+				t.calls += c->calls();
+				t.time += c->time();
+			}
+		}
+
+		return res;
+	}
+
+	/** Sets every counter back to zero. */
+	static void reset_all()
+	{
+		registry& r = get_registry();
+		std::lock_guard lock(r.mutex);
+		for(perf_counter* c : r.counters) {
+			c->calls_ = 0;
+			c->time_ = 0;
+		}
+	}
+
+	/** One line per counter that was hit: its name, calls, and total and average time. */
+	static std::string report()
+	{
+		std::ostringstream out;
+		out << std::fixed << std::setprecision(3);
+
+		for(const auto& [name, t] : all_totals()) {
+			const double total_ms = std::chrono::duration<double, std::milli>(t.time).count();
+			out << name << ": " << t.calls << " calls";
+			if(t.time.count() != 0) {
+				out << ", " << total_ms << " ms, " << total_ms / t.calls << " ms/call";
+			}
+			out << "\n";
+		}
+
+		return out.str();
+	}
+
+	/** RAII helper adding the duration of its scope to a counter, see PERF_TIMER. */
+	class scope
+	{
+	public:
+		explicit scope(perf_counter& counter)
+			: counter_(counter)
+			, start_(clock::now())
+		{
+		}
+
+		~scope()
+		{
+			counter_.add(clock::now() - start_);
+		}
+
+		scope(const scope&) = delete;
+		scope& operator=(const scope&) = delete;
+
+	private:
+		perf_counter& counter_;
+		clock::time_point start_;
+	};
+
+private:
+	struct registry
+	{
+		std::mutex mutex;
+		std::vector<perf_counter*> counters;
+	};
+
+	/** Created by the first counter, so it outlives all of them. */
+	static registry& get_registry()
+	{
+		static registry instance;
+		return instance;
+	}
+
+	const char* name_;
+	std::atomic<std::uint64_t> calls_;
+	std::atomic<clock::rep> time_;
+};
+
+} // namespace util
+
+/** Adds the time spent in the current scope to the counter @a name. */
+#define PERF_TIMER(name) \
+	static util::perf_counter BOOST_PP_CAT(perf_counter_, __LINE__){name}; \
+	const util::perf_counter::scope BOOST_PP_CAT(perf_timer_, __LINE__){BOOST_PP_CAT(perf_counter_, __LINE__)}
+
+/** Counts a call under @a name, without timing it. */
+#define PERF_COUNT(name) \
+	do { \
+		static util::perf_counter perf_counter_{name}; \
+		perf_counter_.add_call(); \
+	} while(false)
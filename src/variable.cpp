@@ -340,6 +340,12 @@ namespace {
 		template<typename T> void operator()(const T&) const {}
 		void operator()(const std::string &s) const
 		{
+			// Plain strings are kept as they are, rather than being copied
+			// and parsed again when assigned back.
+			if(s.find('$') == std::string::npos) {
+				return;
+			}
+
 			result = utils::interpolate_variables_into_string(s, vars);
 		}
 		void operator()(const t_string &s) const
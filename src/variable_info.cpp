@@ -78,46 +78,15 @@ variable_info<V>::variable_info(const std::string& varname, maybe_const_t<config
 template<typename V>
 void variable_info<V>::calculate_value()
 {
-	std::size_t previous_index = 0, name_size = name_.size();
-
-	for(std::size_t loop_index = 0; loop_index < name_size; loop_index++) {
-		switch(name_[loop_index]) {
-		case '.':
-		case '[':
-			/* '.' and '[' mark the end of a string key.
-			 * The result is obviously that '.' and '[' are
-			 * treated equally so 'aaa.9].bbbb[zzz.uu.7]'
-			 * is interpreted as  'aaa[9].bbbb.zzz.uu[7]'
-			 * Use is_valid_variable function for stricter variable name checking.
-			 */
-			apply_visitor<get_variable_key_visitor<V>>(
-				state_, name_.substr(previous_index, loop_index - previous_index));
-
-			previous_index = loop_index + 1;
-			break;
-		case ']':
-			// ']' marks the end of an integer key.
-			apply_visitor<get_variable_index_visitor<V>>(state_, parse_index(&name_[previous_index]));
-
-			// After ']' we always expect a '.' or the end of the string
-			// Ignore the next char which is a '.'
-			loop_index++;
-			if(loop_index < name_.length() && name_[loop_index] != '.') {
-				throw invalid_variablename_exception();
-			}
-
-			previous_index = loop_index + 1;
-			break;
-		default:
-			break;
+	for(const variable_name_segment& segment : parsed_variable_name(name_)) {
+		if(!segment.key.empty()) {
+			apply_visitor<get_variable_key_visitor<V>>(state_, segment.key);
+		} else if(segment.index > static_cast<long>(game_config::max_loop)) {
+			throw invalid_variablename_exception();
+		} else {
+			apply_visitor<get_variable_index_visitor<V>>(state_, static_cast<int>(segment.index));
 		}
 	}
-
-	if(previous_index != name_.length() + 1) {
-		// The string didn't end with ']'
-		// In this case we still didn't add the key behind the last '.'
-		apply_visitor<get_variable_key_visitor<V>>(state_, name_.substr(previous_index));
-	}
 }
 
 template<typename V>
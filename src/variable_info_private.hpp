@@ -19,6 +19,8 @@
 #include "game_config.hpp"
 
 #include <stdexcept>
+#include <unordered_map>
+#include <vector>
 
 namespace variable_info_implementation
 {
@@ -49,23 +51,105 @@ void resolve_negative_value(int size, int& val)
 
 const config non_empty_const_cfg("_");
 
+/** One step of a variable name: a .key or an [index]. */
+struct variable_name_segment
+{
+	std::string key;
+	/** Only meaningful if key is empty. Checked against max_loop when used, as that can change. */
+	long index;
+};
+
 /**
- * Parses a ']' terminated string.
- * This is a important optimization of lexical_cast_default
+ * Splits a variable name into its keys and indices.
+ * '.' and '[' mark the end of a string key, ']' the end of an integer key.
+ * The result is obviously that '.' and '[' are treated equally so
+ * 'aaa.9].bbbb[zzz.uu.7]' is interpreted as 'aaa[9].bbbb.zzz.uu[7]'.
+ * Use is_valid_variable function for stricter variable name checking.
+ *
+ * @throws invalid_variablename_exception If a key is not a valid attribute
+ *                                        name or an index is not a number.
  */
-int parse_index(const char* index_str);
-int parse_index(const char* index_str)
+std::vector<variable_name_segment> split_variable_name(const std::string& name);
+std::vector<variable_name_segment> split_variable_name(const std::string& name)
 {
-	char* endptr;
-	int res = strtol(index_str, &endptr, 10);
+	std::vector<variable_name_segment> res;
+	const auto add_key = [&res](std::string key) {
+		if(!config::valid_attribute(key)) {
+			throw invalid_variablename_exception();
+		}
 
-	if(*endptr != ']' || res > static_cast<int>(game_config::max_loop) || endptr == index_str) {
-		throw invalid_variablename_exception();
+		res.push_back({std::move(key), 0});
+	};
+
+	std::size_t previous_index = 0, name_size = name.size();
+
+	for(std::size_t loop_index = 0; loop_index < name_size; loop_index++) {
+		switch(name[loop_index]) {
+		case '.':
+		case '[':
+			add_key(name.substr(previous_index, loop_index - previous_index));
+			previous_index = loop_index + 1;
+			break;
+		case ']': {
+			const char* index_str = &name[previous_index];
+			char* endptr;
+			long index = strtol(index_str, &endptr, 10);
+			if(*endptr != ']' || endptr == index_str) {
+				throw invalid_variablename_exception();
+			}
+
+			res.push_back({std::string(), index});
+
+			// After ']' we always expect a '.' or the end of the string
+			// Ignore the next char which is a '.'
+			loop_index++;
+			if(loop_index < name.length() && name[loop_index] != '.') {
+				throw invalid_variablename_exception();
+			}
+
+			previous_index = loop_index + 1;
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	if(previous_index != name.length() + 1) {
+		// The string didn't end with ']'
+		// In this case we still didn't add the key behind the last '.'
+		add_key(name.substr(previous_index));
 	}
 
 	return res;
 }
 
+/**
+ * Returns the split form of a variable name, see split_variable_name.
+ * The same names are used over and over by WML and Lua, so they are only
+ * split the first time. The reference is valid until the next call.
+ */
+const std::vector<variable_name_segment>& parsed_variable_name(const std::string& name);
+const std::vector<variable_name_segment>& parsed_variable_name(const std::string& name)
+{
+	static std::unordered_map<std::string, std::vector<variable_name_segment>> cache;
+
+	auto iter = cache.find(name);
+	if(iter != cache.end()) {
+		return iter->second;
+	}
+
+	// Invalid names throw here, so they are never stored.
+	std::vector<variable_name_segment> segments = split_variable_name(name);
+
+	// Names built from changing values, such as indices, would grow the cache forever.
+	if(cache.size() >= 4096) {
+		cache.clear();
+	}
+
+	return cache.emplace(name, std::move(segments)).first->second;
+}
+
 // ==================================================================
 // Visitor interface
 // ==================================================================
@@ -125,12 +209,10 @@ public:
 	// Import typedefs from base class.
 	using param_t = typename get_variable_key_visitor::param_t;
 
+	/** @param key          Must be a valid attribute name, as checked by split_variable_name. */
 	get_variable_key_visitor(const std::string& key)
 		: key_(key)
 	{
-		if(!config::valid_attribute(key_)) {
-			throw invalid_variablename_exception();
-		}
 	}
 
 	void from_named(param_t state) const
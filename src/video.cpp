@@ -390,9 +390,7 @@ void init_window()
 
 	window->set_minimum_size(preferences::min_window_width, preferences::min_window_height);
 
-	SDL_DisplayMode currentDisplayMode;
-	SDL_GetCurrentDisplayMode(window->get_display_index(), &currentDisplayMode);
-	refresh_rate_ = currentDisplayMode.refresh_rate != 0 ? currentDisplayMode.refresh_rate : 60;
+	update_refresh_rate();
 
 	update_framebuffer();
 }
@@ -479,6 +477,24 @@ int current_refresh_rate()
 	return refresh_rate_;
 }
 
+void update_refresh_rate()
+{
+	if(!window || headless_ || testing_) {
+		return;
+	}
+
+	SDL_DisplayMode currentDisplayMode;
+	if(SDL_GetCurrentDisplayMode(window->get_display_index(), &currentDisplayMode) != 0) {
+		return;
+	}
+
+	const int rate = currentDisplayMode.refresh_rate != 0 ? currentDisplayMode.refresh_rate : 60;
+	if(rate != refresh_rate_) {
+		LOG_DP << "refresh rate is now " << rate << "Hz";
+		refresh_rate_ = rate;
+	}
+}
+
 void force_render_target(const texture& t)
 {
 	if (SDL_SetRenderTarget(get_renderer(), t)) {
@@ -684,6 +700,11 @@ bool window_has_mouse_focus()
 	return window_has_flags(SDL_WINDOW_MOUSE_FOCUS);
 }
 
+bool window_is_minimized()
+{
+	return window_has_flags(SDL_WINDOW_MINIMIZED);
+}
+
 std::vector<point> get_available_resolutions(const bool include_current)
 {
 	std::vector<point> result;
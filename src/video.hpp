@@ -137,12 +137,21 @@ std::vector<std::string> enumerate_drivers();
  */
 int current_refresh_rate();
 
+/**
+ * Queries the refresh rate of the display the window is on again.
+ *
+ * Called when the window moves, as it may have moved to another monitor.
+ */
+void update_refresh_rate();
+
 /** True iff the window is not hidden. */
 bool window_is_visible();
 /** True iff the window has mouse or input focus */
 bool window_has_focus();
 /** True iff the window has mouse focus */
 bool window_has_mouse_focus();
+/** True iff the window is minimized */
+bool window_is_minimized();
 
 /** Sets the title of the main window. */
 void set_window_title(const std::string& title);
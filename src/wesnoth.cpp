@@ -333,6 +333,9 @@ static void handle_preprocess_command(const commandline_options& cmdline_opts)
 		}
 	}
 
+	const preproc_expansion_stats expansions = macro_expansion_stats();
+	PLAIN_LOG << "macro expansions in macro arguments: " << expansions.hits << " reused, " << expansions.misses << " expanded";
+
 	PLAIN_LOG << "preprocessing finished. Took " << SDL_GetTicks() - startTime << " ticks.";
 }
 
@@ -450,6 +453,10 @@ static int process_command_args(const commandline_options& cmdline_opts)
 		game_config::strict_lua = true;
 	}
 
+	if(cmdline_opts.lua_profile) {
+		game_config::lua_profile = *cmdline_opts.lua_profile;
+	}
+
 	if(cmdline_opts.gunzip) {
 		const std::string input_file(*cmdline_opts.gunzip);
 		if(!filesystem::is_gzip_file(input_file)) {
@@ -621,6 +628,29 @@ static void init_locale()
 	translation::set_default_textdomain(PACKAGE);
 }
 
+/**
+ * Runs one stage of the startup and logs how long it took.
+ *
+ * The times show up with --log-info=config, making it easy to see which
+ * stage dominates the startup on a given system.
+ */
+template<typename F>
+static auto run_startup_stage(const char* name, F&& stage)
+{
+	struct stage_timer
+	{
+		const char* name;
+		const uint32_t start = SDL_GetTicks();
+
+		~stage_timer()
+		{
+			LOG_CONFIG << "startup stage '" << name << "' took " << (SDL_GetTicks() - start) << " ms";
+		}
+	} timer{name};
+
+	return stage();
+}
+
 /**
  * Print an alert and instructions to stderr about early initialization errors.
  *
@@ -764,7 +794,7 @@ static int do_gameloop(const std::vector<std::string>& args)
 	// Do initialize fonts before reading the game config, to have game
 	// config error messages displayed. fonts will be re-initialized later
 	// when the language is read from the game config.
-	res = font::load_font_config();
+	res = run_startup_stage("fonts", &font::load_font_config);
 	if(res == false) {
 		PLAIN_LOG << "could not initialize fonts";
 		// The most common symptom of a bogus data dir path -- warn the user.
@@ -772,13 +802,13 @@ static int do_gameloop(const std::vector<std::string>& args)
 		return 1;
 	}
 
-	res = game->init_language();
+	res = run_startup_stage("language", [&game]() { return game->init_language(); });
 	if(res == false) {
 		PLAIN_LOG << "could not initialize the language";
 		return 1;
 	}
 
-	res = game->init_video();
+	res = run_startup_stage("video", [&game]() { return game->init_video(); });
 	if(res == false) {
 		PLAIN_LOG << "could not initialize display";
 		return 1;
@@ -792,7 +822,7 @@ static int do_gameloop(const std::vector<std::string>& args)
 	SDL_EventState(SDL_SYSWMEVENT, SDL_ENABLE);
 #endif
 
-	gui2::init();
+	run_startup_stage("gui", &gui2::init);
 	const gui2::event::manager gui_event_manager;
 
 	game_config_manager config_manager(cmdline_opts);
@@ -804,7 +834,9 @@ static int do_gameloop(const std::vector<std::string>& args)
 
 	gui2::dialogs::loading_screen::display([&res, &config_manager, &cmdline_opts]() {
 		gui2::dialogs::loading_screen::progress(loading_stage::load_config);
-		res = config_manager.init_game_config(game_config_manager::NO_FORCE_RELOAD);
+		res = run_startup_stage("game config", [&config_manager]() {
+			return config_manager.init_game_config(game_config_manager::NO_FORCE_RELOAD);
+		});
 
 		if(res == false) {
 			PLAIN_LOG << "could not initialize game config";
@@ -813,7 +845,7 @@ static int do_gameloop(const std::vector<std::string>& args)
 
 		gui2::dialogs::loading_screen::progress(loading_stage::init_fonts);
 
-		res = font::load_font_config();
+		res = run_startup_stage("fonts for the language", &font::load_font_config);
 		if(res == false) {
 			PLAIN_LOG << "could not re-initialize fonts for the current language";
 			return;
@@ -822,7 +854,7 @@ static int do_gameloop(const std::vector<std::string>& args)
 		if(!game_config::no_addons && !cmdline_opts.noaddons)  {
 			gui2::dialogs::loading_screen::progress(loading_stage::refresh_addons);
 
-			refresh_addon_version_info_cache();
+			run_startup_stage("add-on versions", &refresh_addon_version_info_cache);
 		}
 	});
 
@@ -876,6 +908,10 @@ static int do_gameloop(const std::vector<std::string>& args)
 			return static_cast<int>(game->unit_test());
 		}
 
+		if(!cmdline_opts.verify_replay.empty()) {
+			return game->verify_replays() ? 0 : 1;
+		}
+
 		if(game->play_test() == false) {
 			return 0;
 		}
@@ -27,10 +27,13 @@
 #include <boost/asio/connect.hpp>
 #include <boost/asio/read.hpp>
 #include <boost/asio/write.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
 
 #include <cstdint>
 #include <deque>
 #include <functional>
+#include <sstream>
 
 static lg::log_domain log_network("network");
 #define DBG_NW LOG_STREAM(debug, log_network)
@@ -243,12 +246,18 @@ void wesnothd_connection::handle_handshake(const error_code& ec)
 			socket.set_verify_callback(verbose_verify(boost::asio::ssl::rfc2818_verification(host_)));
 #endif
 
+			network_asio::use_tls_session_cache(tls_context_, socket.native_handle(), host_, service_);
+
 			socket.async_handshake(boost::asio::ssl::stream_base::client, [this](const error_code& ec) {
 				if(ec) {
 					LOG_NW << __func__ << " Throwing: " << ec;
 					throw system_error(ec);
 				}
 
+				if(SSL_session_reused(utils::get<tls_socket>(socket_)->native_handle())) {
+					DBG_NW << "Resumed the TLS session with " << host_;
+				}
+
 				handshake_finished_.set_value();
 				recv();
 			});
@@ -324,14 +333,26 @@ void wesnothd_connection::send_data(const configr_of& request)
 {
 	MPTEST_LOG;
 
-	auto buf_ptr = std::make_unique<boost::asio::streambuf>();
-
-	std::ostream os(buf_ptr.get());
-	write_gz(os, request);
+	// Only the serialization happens here. The compression, which is most of
+	// the cost for big documents such as uploaded saves, is done by the worker
+	// thread along with the receiving side's decompression.
+	std::ostringstream text;
+	write(text, request);
 
-	boost::asio::post(io_context_, [this, buf_ptr = std::move(buf_ptr)]() mutable {
+	boost::asio::post(io_context_, [this, text = text.str()]() {
 
 		DBG_NW << "In wesnothd_connection::send_data::lambda";
+
+		auto buf_ptr = std::make_unique<boost::asio::streambuf>();
+		{
+			// Same output as write_gz().
+			std::ostream os(buf_ptr.get());
+			boost::iostreams::filtering_stream<boost::iostreams::output> filter;
+			filter.push(boost::iostreams::gzip_compressor());
+			filter.push(os);
+			filter << text << "\n";
+		}
+
 		send_queue_.push(std::move(buf_ptr));
 
 		if(send_queue_.size() == 1) {
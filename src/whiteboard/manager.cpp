@@ -593,22 +593,26 @@ void manager::draw_hex(const map_location& hex)
 
 void manager::on_mouseover_change(const map_location& hex)
 {
+	if (has_temp_move() || wait_for_side_init_ || executing_actions_) {
+		return;
+	}
 
+	// Only build the planned unit map when there is a selected hex to look at,
+	// this runs on every mouseover.
 	map_location selected_hex = resources::controller->get_mouse_handler_base().get_selected_hex();
-	bool hex_has_unit;
-	{ wb::future_map future; // start planned unit map scope
-		hex_has_unit = resources::gameboard->units().find(selected_hex) != resources::gameboard->units().end();
+	if (selected_hex.valid()) {
+		wb::future_map future; // start planned unit map scope
+		if (resources::gameboard->units().find(selected_hex) != resources::gameboard->units().end()) {
+			return;
+		}
 	} // end planned unit map scope
-	if (!((selected_hex.valid() && hex_has_unit)
-			|| has_temp_move() || wait_for_side_init_ || executing_actions_))
+
+	if (!highlighter_)
 	{
-		if (!highlighter_)
-		{
-			highlighter_.reset(new highlighter(viewer_actions()));
-		}
-		highlighter_->set_mouseover_hex(hex);
-		highlighter_->highlight();
+		highlighter_.reset(new highlighter(viewer_actions()));
 	}
+	highlighter_->set_mouseover_hex(hex);
+	highlighter_->highlight();
 }
 
 void manager::on_gamestate_change()
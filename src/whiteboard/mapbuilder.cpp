@@ -61,6 +61,8 @@ void mapbuilder::pre_build()
 		t.get_side_actions()->reset_gold_spent();
 	}
 
+	resetters_.reserve(resources::gameboard->units().size());
+
 	int current_side = resources::controller->current_side();
 	for (unit& u : resources::gameboard->units()) {
 		bool on_current_side = (u.side() == current_side);